@@ -83,18 +83,19 @@ public:
     const Vector3<Real>& getRight() const;
 
 protected:
-    void compile();
+    /* Updates the view matrix and the eye basis, const getters call it too. */
+    void compile() const;
 
 protected:
-    Matrix4<Real> view;
+    mutable Matrix4<Real> view;
     Matrix4<Real> projection;
 
-    Vector3<Real> eye;
+    mutable Vector3<Real> eye;
     Vector3<Real> lookAt;
 
-    Vector3<Real> up;
-    Vector3<Real> right;
-    Vector3<Real> dir;
+    mutable Vector3<Real> up;
+    mutable Vector3<Real> right;
+    mutable Vector3<Real> dir;
 
     Real r, theta, phi;
     Real fov;
@@ -338,7 +339,7 @@ const Vector3<Real>& Camera<Real>::getRight() const {
 }
 
 template <typename Real>
-void Camera<Real>::compile() {
+void Camera<Real>::compile() const {
     this->eye = SphereicalToCartesian<Real>(this->r, this->theta, this->phi);
     this->up = -SphereicalToCartesian_dPhi<Real>(this->r, this->theta, this->phi);
     this->right = SphereicalToCartesian_dTheta<Real>(this->r, this->theta, this->phi);
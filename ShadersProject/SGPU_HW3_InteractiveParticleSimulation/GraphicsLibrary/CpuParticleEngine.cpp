@@ -0,0 +1,269 @@
+#include "CpuParticleEngine.h"
+#include "Parallel.h"
+#include "GLState.h"
+#include <gl/glew.h>
+
+const static std::size_t MIN_PARALLEL_RANGE = 2048;
+
+/* Distance a particle is kept in front of a mesh triangle it collided with. */
+const static float MESH_CONTACT_OFFSET = 1e-3f;
+
+CpuParticleEngine::CpuParticleEngine() {
+    this->vboId = 0;
+}
+
+CpuParticleEngine::~CpuParticleEngine() {
+    GLState::DeleteBuffer(this->vboId);
+}
+
+bool CpuParticleEngine::construct(const std::vector<Particle>& particles) {
+    if ( particles.size() == 0 ) return false;
+
+    //--------------------------------------------------------------------------
+    // Bind the array buffer with a dynamic draw flag because we will be
+    // constantly replacing the particle definitions.
+    //--------------------------------------------------------------------------
+    if ( this->vboId == 0 ) glGenBuffers(1, &this->vboId);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboId);
+    glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(Particle), &particles[0], GL_DYNAMIC_DRAW);
+    return true;
+}
+
+void HandleCollision(Particle& p, float extent, float bounceEnergy) {
+    if ( p.position.x() < -extent ) {
+        p.position.x() = -extent;
+        p.velocity.x() *= -1.0f;
+        p.velocity.x() *= bounceEnergy;
+    }
+
+    if ( p.position.x() > extent ) {
+        p.position.x() = extent;
+        p.velocity.x() *= -1.0f;
+        p.velocity.x() *= bounceEnergy;
+    }
+
+    if ( p.position.z() < -extent ) {
+        p.position.z() = -extent;
+        p.velocity.z() *= -1.0f;
+        p.velocity.z() *= bounceEnergy;
+    }
+
+    if ( p.position.z() > extent ) {
+        p.position.z() = extent;
+        p.velocity.z() *= -1.0f;
+        p.velocity.z() *= bounceEnergy;
+    }
+
+    if ( p.position.y() < 0.0f ) {
+        p.position.y() = 0.0f;
+        p.velocity.y() *= -1.0f;
+        p.velocity.y() *= bounceEnergy;
+    }
+
+    if ( p.position.y() > extent ) {
+        p.position.y() = extent;
+        p.velocity.y() *= -1.0f;
+        p.velocity.y() *= bounceEnergy;
+    }
+}
+
+void CpuParticleEngine::Integrate(std::vector<Particle>& particles, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt, const TriangleBVH* collisionMesh) {
+    std::vector<Vector3f> startPositions;
+    bool meshCollisions = (collisionMesh != nullptr && !collisionMesh->isEmpty());
+    if ( meshCollisions ) startPositions.resize(particles.size());
+
+    //--------------------------------------------------------------------------
+    // Using explicit Euler integration, update the the velocity and position
+    // of every particle.
+    //--------------------------------------------------------------------------
+    for ( std::size_t i = 0; i < particles.size(); i++ ) {
+        if ( meshCollisions ) startPositions[i] = particles[i].position;
+
+        particles[i].velocity = particles[i].velocity + (dt * particles[i].force * 1.0f / particles[i].mass);
+        particles[i].position = particles[i].position + (dt * particles[i].velocity);
+        particles[i].lifetime -= dt;
+    }
+
+    //--------------------------------------------------------------------------
+    // Mesh collision: the path of every particle during this step is tested
+    // against the triangles in one batch. A particle that crossed a triangle
+    // is moved back to the contact point (slightly in front of the surface)
+    // and the normal component of its velocity is reflected and scaled by the
+    // bounce energy.
+    //--------------------------------------------------------------------------
+    if ( meshCollisions ) {
+        std::vector<Vector3f> endPositions(particles.size());
+        std::vector<SegmentHit> hits(particles.size());
+        for ( std::size_t i = 0; i < particles.size(); i++ ) endPositions[i] = particles[i].position;
+
+        collisionMesh->intersectSegments(&startPositions[0], &endPositions[0], particles.size(), &hits[0]);
+
+        for ( std::size_t i = 0; i < particles.size(); i++ ) {
+            const SegmentHit& hit = hits[i];
+            if ( hit.triangle == BVH_NO_HIT ) continue;
+
+            Vector3f motion = endPositions[i] - startPositions[i];
+            particles[i].position = startPositions[i] + motion * hit.t + hit.normal * MESH_CONTACT_OFFSET;
+
+            float approach = static_cast<float>(Vector3f::Dot(particles[i].velocity, hit.normal));
+            if ( approach < 0.0f )
+                particles[i].velocity = particles[i].velocity - hit.normal * ((1.0f + parameters.bounceEnergy) * approach);
+        }
+    }
+
+    for ( std::size_t i = 0; i < particles.size(); i++ ) {
+        float lifetime = particles[i].lifetime;
+
+        //--------------------------------------------------------------------------
+        // For the ground collision event, the particle loses kinectic energy
+        // than an impulse is applied to make the particle bounce.
+        //--------------------------------------------------------------------------
+        HandleCollision(particles[i], parameters.extent, parameters.bounceEnergy);
+
+        //--------------------------------------------------------------------------
+        // If the system should be currently spawning particles, move them to the
+        // provided spawn position if the particles lifetime is less than 0 (dead).
+        //--------------------------------------------------------------------------
+        if ( spawnParticles && lifetime < 0.0f ) {
+            particles[i].position = spawnPosition;
+            particles[i].velocity = spawnDirection * parameters.initVelocity;
+            particles[i].force = parameters.gravity;
+            particles[i].color = RandomColor(parameters.color);
+            particles[i].lifetime = Random(parameters.minLifetime, parameters.maxLifetime);
+        }
+        //--------------------------------------------------------------------------
+        // If the particle is dead (but resizing the particle array on the GPU is
+        // expensive), then move it to a 'hidden position' where it will wait as
+        // as reserve particle ready to be spawned when spawnParticles is true.
+        //--------------------------------------------------------------------------
+        else {
+            if ( lifetime < 0.0f ) {
+                particles[i].position = hiddenPosition;
+                particles[i].velocity = Vector3f::Zero();
+                particles[i].force = Vector3f::Zero();
+                particles[i].color = RandomColor(parameters.color);
+                particles[i].lifetime = 0.0f;
+            }
+        }
+    }
+}
+
+/* Deterministic unit direction for the pair of coincident particles (i, j). */
+static Vector3f CoincidentNormal(unsigned int i, unsigned int j) {
+    unsigned int hash = i * 73856093u ^ j * 19349663u;
+    float components[3];
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        hash = hash * 1664525u + 1013904223u;
+        components[k] = static_cast<float>(hash >> 8) / static_cast<float>(0xFFFFFF) * 2.0f - 1.0f;
+    }
+
+    Vector3f normal(components[0], components[1], components[2] + 1e-3f);
+    return normal * (1.0f / static_cast<float>(normal.length()));
+}
+
+void CpuParticleEngine::Collide(std::vector<Particle>& particles, const ParticleParameters& parameters, SpatialHashGrid& grid) {
+    if ( parameters.particleRadius <= 0.0f || particles.size() == 0 ) return;
+
+    float diameter = 2.0f * parameters.particleRadius;
+    if ( grid.getCellSize() != diameter ) grid.setCellSize(diameter);
+    grid.build(particles);
+
+    //--------------------------------------------------------------------------
+    // Every particle computes its own response from the state at the start of
+    // the pass (Jacobi style), so the particles can be processed in parallel
+    // without synchronization. They are visited in grid order so consecutive
+    // particles read the same neighbors.
+    //--------------------------------------------------------------------------
+    const std::vector<unsigned int>& order = grid.getSortedIndices();
+    std::vector<Vector3f> positions(particles.size());
+    std::vector<Vector3f> velocities(particles.size());
+    float restitution = 1.0f + parameters.bounceEnergy;
+
+    ParallelFor(0, order.size(), MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for ( std::size_t k = begin; k < end; k++ ) {
+            unsigned int i = order[k];
+            const Particle& a = particles[i];
+            Vector3f position = a.position;
+            Vector3f velocity = a.velocity;
+
+            grid.forEachNeighbor(a.position, diameter, [&](unsigned int j, const Vector3f& neighbor) {
+                if ( j == i ) return;
+
+                Vector3f delta = a.position - neighbor;
+                float distance = static_cast<float>(delta.length());
+
+                //------------------------------------------------------------------
+                // Particles respawned at the same position coincide exactly. They
+                // are pushed apart along a direction derived from the pair, with
+                // opposite signs for the two particles.
+                //------------------------------------------------------------------
+                Vector3f normal;
+                if ( distance > 0.0f ) normal = delta * (1.0f / distance);
+                else {
+                    normal = CoincidentNormal(std::min(i, j), std::max(i, j));
+                    if ( i > j ) normal = normal * -1.0f;
+                }
+
+                const Particle& b = particles[j];
+                float share = b.mass / (a.mass + b.mass);
+
+                //------------------------------------------------------------------
+                // Separate the overlap proportionally to the masses and remove
+                // the approaching part of the relative velocity.
+                //------------------------------------------------------------------
+                position = position + normal * ((diameter - distance) * share);
+
+                float approach = static_cast<float>(Vector3f::Dot(a.velocity - b.velocity, normal));
+                if ( approach < 0.0f )
+                    velocity = velocity - normal * (restitution * approach * share);
+            });
+
+            positions[i] = position;
+            velocities[i] = velocity;
+        }
+    });
+
+    ParallelFor(0, order.size(), MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for ( std::size_t k = begin; k < end; k++ ) {
+            unsigned int i = order[k];
+            particles[i].position = positions[i];
+            particles[i].velocity = velocities[i];
+            HandleCollision(particles[i], parameters.extent, parameters.bounceEnergy);
+        }
+    });
+}
+
+void CpuParticleEngine::simulate(std::vector<Particle>& particles, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt) {
+    CpuParticleEngine::Integrate(particles, parameters, spawnParticles, spawnPosition, spawnDirection, dt, this->collisionMesh.get());
+    CpuParticleEngine::Collide(particles, parameters, this->grid);
+}
+
+void CpuParticleEngine::update(std::vector<Particle>& particles, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt) {
+    if ( this->vboId == 0 || particles.size() == 0 ) return;
+
+    this->simulate(particles, parameters, spawnParticles, spawnPosition, spawnDirection, dt);
+
+    //--------------------------------------------------------------------------
+    // Upload the new data to the GPU. NOTE: This is not the most efficient way of implementing a
+    // particle system, but it greatly reduces the additional code within the shader implementation.
+    // The TransformFeedbackParticleEngine keeps the particles on the GPU instead.
+    //--------------------------------------------------------------------------
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboId);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, particles.size() * sizeof(Particle), &particles[0]);
+}
+
+bool CpuParticleEngine::readBack(std::vector<Particle>& /* particles */) const {
+    //--------------------------------------------------------------------------
+    // The CPU array is always the authoritative copy of the particle state.
+    //--------------------------------------------------------------------------
+    return true;
+}
+
+unsigned int CpuParticleEngine::getVertexBuffer() const {
+    return this->vboId;
+}
+
+bool CpuParticleEngine::setCollisionMesh(const std::shared_ptr<TriangleBVH>& mesh) {
+    this->collisionMesh = mesh;
+    return true;
+}
@@ -0,0 +1,65 @@
+#ifndef CPU_PARTICLE_ENGINE_H
+#define CPU_PARTICLE_ENGINE_H
+
+#include "ParticleEngine.h"
+#include "SpatialHashGrid.h"
+#include "TriangleBVH.h"
+
+/*
+ * Reference particle engine. The particles are integrated on the CPU and the
+ * complete particle array is re-uploaded to the vertex buffer every update.
+ */
+class CpuParticleEngine : public ParticleEngine {
+public:
+    CpuParticleEngine();
+    virtual ~CpuParticleEngine();
+
+    virtual bool construct(const std::vector<Particle>& particles);
+    virtual void update(std::vector<Particle>& particles, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt);
+    virtual bool readBack(std::vector<Particle>& particles) const;
+    virtual unsigned int getVertexBuffer() const;
+    virtual bool setCollisionMesh(const std::shared_ptr<TriangleBVH>& mesh);
+
+    /*
+     * Performs the simulation step of update (integration, mesh collision and
+     * particle collision) without uploading the particles. The engine does
+     * not need an OpenGL context if only this function is used.
+     */
+    void simulate(std::vector<Particle>& particles, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt);
+
+    /*
+     * Advances the particles by one time-step without touching OpenGL. This is
+     * the simulation performed by update and is used to validate other engines.
+     * If a collision mesh is provided, the motion of every particle during the
+     * step is tested against its triangles and the particles bounce off them.
+     */
+    static void Integrate(std::vector<Particle>& particles, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt, const TriangleBVH* collisionMesh = nullptr);
+
+    /*
+     * Resolves the collisions between live particles of the given radius. The
+     * particles are sorted into the grid (with a cell size of one particle
+     * diameter) so every particle only tests the particles of the surrounding
+     * cells. Overlapping particles are separated and an impulse scaled by the
+     * bounce energy is exchanged along the contact normal.
+     */
+    static void Collide(std::vector<Particle>& particles, const ParticleParameters& parameters, SpatialHashGrid& grid);
+
+protected:
+    /* Vertex buffer object that stores the particles. */
+    unsigned int vboId;
+
+    /* Spatial hash rebuilt every update when particle collisions are enabled. */
+    SpatialHashGrid grid;
+
+    /* Static triangles the particles collide with (may be nullptr). */
+    std::shared_ptr<TriangleBVH> collisionMesh;
+};
+
+/*
+ * Very simple collision based on a cube around the origin. This collision
+ * is the simplest form of collilsion that can be implemented for a
+ * particle simulation.
+ */
+void HandleCollision(Particle& p, float extent, float bounceEnergy);
+
+#endif
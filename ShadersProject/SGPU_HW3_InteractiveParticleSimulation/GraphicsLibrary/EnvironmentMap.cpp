@@ -2,6 +2,7 @@
 #include <sstream>
 #include <iostream>
 #include "PNG.h"
+#include "GLState.h"
 
 #ifndef GL_EXT_texture_cube_map
 #define GL_NORMAL_MAP_EXT                   0x8511
@@ -82,7 +83,7 @@ bool EnvironmentMap::load(GLenum target, unsigned int index, const std::string&
     }
 
     glGenTextures(1, &this->id);
-    glBindTexture(target, this->id);
+    GLState::BindTexture(target, this->id);
     glTexImage2D(target, 0, 4, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &this->images[index][0]);
     return true;
 }
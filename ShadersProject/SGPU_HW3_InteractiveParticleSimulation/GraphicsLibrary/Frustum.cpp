@@ -0,0 +1,29 @@
+#include "Frustum.h"
+#include <cmath>
+
+void ExtractFrustum(const Matrix4f& viewProjection, Frustum& frustum) {
+    //--------------------------------------------------------------------------
+    // With the rows r0..r3 of the matrix, the planes are r3 + r0, r3 - r0,
+    // r3 + r1, r3 - r1, r3 + r2 and r3 - r2. The matrix is stored column
+    // major, so row i is m[i], m[4 + i], m[8 + i], m[12 + i].
+    //--------------------------------------------------------------------------
+    const float* m = viewProjection.constData();
+    for ( unsigned int p = 0; p < FRUSTUM_PLANE_COUNT; p++ ) {
+        float* plane = frustum.planes[p];
+        unsigned int row = p / 2;
+        float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+        for ( unsigned int c = 0; c < 4; c++ ) plane[c] = m[4 * c + 3] + sign * m[4 * c + row];
+
+        float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if ( length > 0.0f ) for ( unsigned int c = 0; c < 4; c++ ) plane[c] /= length;
+    }
+}
+
+bool FrustumIntersectsSphere(const Frustum& frustum, const Vector3f& center, float radius) {
+    for ( unsigned int p = 0; p < FRUSTUM_PLANE_COUNT; p++ ) {
+        const float* plane = frustum.planes[p];
+        if ( plane[0] * center.x() + plane[1] * center.y() + plane[2] * center.z() + plane[3] < -radius ) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <Matrix4.h>
+#include <Vector3.h>
+
+const static unsigned int FRUSTUM_PLANE_COUNT = 6;
+
+/*
+ * View frustum as six planes (left, right, bottom, top, near, far). A point p
+ * is inside a plane if a * p.x + b * p.y + c * p.z + d >= 0. The plane
+ * normals have unit length, so the plane equation gives signed distances.
+ */
+struct Frustum {
+    float planes[FRUSTUM_PLANE_COUNT][4];
+};
+
+/*
+ * Extracts the frustum of a (model-)view-projection matrix (Gribb and
+ * Hartmann). The planes are in the space the matrix maps from: world space
+ * for a view-projection matrix, object space when a model matrix is
+ * included. Matrix4 products apply the left operand first, so the
+ * view-projection matrix of a camera is Multiply(view, projection).
+ */
+void ExtractFrustum(const Matrix4f& viewProjection, Frustum& frustum);
+
+/* True if the sphere lies at least partly inside the frustum. */
+bool FrustumIntersectsSphere(const Frustum& frustum, const Vector3f& center, float radius);
+
+#endif
@@ -0,0 +1,185 @@
+#include "GLState.h"
+#include <gl/glew.h>
+
+/* Binding that is not known, the next bind is always issued. */
+const static unsigned int UNKNOWN_BINDING = 0xFFFFFFFFu;
+
+const static unsigned int MAX_TEXTURE_UNITS = 16;
+const static unsigned int MAX_BINDING_TARGETS = 8;
+
+/* Object bound to one target (of a texture unit or of the buffers). */
+struct Binding {
+    unsigned int target;
+    unsigned int object;
+};
+
+/* Bound objects per target; targets are added as they are first used. */
+struct BindingTable {
+    Binding bindings[MAX_BINDING_TARGETS];
+    unsigned int count;
+};
+
+struct CachedState {
+    unsigned int program;
+    unsigned int activeTexture;
+    unsigned int vertexArray;
+    BindingTable textures[MAX_TEXTURE_UNITS];
+    BindingTable buffers;
+    bool caching;
+    GLState::Statistics statistics;
+};
+
+/* Nothing is known about the context before the first bind. */
+static CachedState CreateState() {
+    CachedState state;
+    state.program = UNKNOWN_BINDING;
+    state.activeTexture = UNKNOWN_BINDING;
+    state.vertexArray = UNKNOWN_BINDING;
+    for ( unsigned int i = 0; i < MAX_TEXTURE_UNITS; i++ ) state.textures[i].count = 0;
+    state.buffers.count = 0;
+    state.caching = true;
+    state.statistics = GLState::Statistics();
+    return state;
+}
+
+static CachedState& State() {
+    static CachedState state = CreateState();
+    return state;
+}
+
+/*
+ * Returns the cached object of target, adding the target as unknown. A full
+ * table returns nullptr and the bind is never cached.
+ */
+static unsigned int* Find(BindingTable& table, unsigned int target) {
+    for ( unsigned int i = 0; i < table.count; i++ )
+        if ( table.bindings[i].target == target ) return &table.bindings[i].object;
+
+    if ( table.count == MAX_BINDING_TARGETS ) return nullptr;
+    table.bindings[table.count].target = target;
+    table.bindings[table.count].object = UNKNOWN_BINDING;
+    return &table.bindings[table.count++].object;
+}
+
+static void Forget(BindingTable& table, unsigned int object) {
+    for ( unsigned int i = 0; i < table.count; i++ )
+        if ( table.bindings[i].object == object ) table.bindings[i].object = UNKNOWN_BINDING;
+}
+
+/*
+ * Updates a cached binding and returns true if the GL call has to be made;
+ * the call is counted as issued or skipped.
+ */
+static bool Update(unsigned int* cached, unsigned int object, GLState::Call call) {
+    CachedState& state = State();
+    if ( state.caching && cached != nullptr && *cached == object ) {
+        state.statistics.skipped[call]++;
+        return false;
+    }
+
+    if ( cached != nullptr ) *cached = object;
+    state.statistics.issued[call]++;
+    return true;
+}
+
+void GLState::UseProgram(unsigned int program) {
+    if ( Update(&State().program, program, USE_PROGRAM) ) glUseProgram(program);
+}
+
+void GLState::ActiveTexture(unsigned int unit) {
+    if ( Update(&State().activeTexture, unit, ACTIVE_TEXTURE) ) glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLState::BindTexture(unsigned int target, unsigned int texture) {
+    CachedState& state = State();
+    unsigned int* cached = nullptr;
+    if ( state.activeTexture < MAX_TEXTURE_UNITS ) cached = Find(state.textures[state.activeTexture], target);
+    if ( Update(cached, texture, BIND_TEXTURE) ) glBindTexture(target, texture);
+}
+
+void GLState::BindBuffer(unsigned int target, unsigned int buffer) {
+    if ( Update(Find(State().buffers, target), buffer, BIND_BUFFER) ) glBindBuffer(target, buffer);
+}
+
+/* The element array buffer binding is part of the vertex array. */
+static void ForgetElementBuffer() {
+    unsigned int* elements = Find(State().buffers, GL_ELEMENT_ARRAY_BUFFER);
+    if ( elements != nullptr ) *elements = UNKNOWN_BINDING;
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray) {
+    if ( !Update(&State().vertexArray, vertexArray, BIND_VERTEX_ARRAY) ) return;
+
+    glBindVertexArray(vertexArray);
+    ForgetElementBuffer();
+}
+
+void GLState::DeleteProgram(unsigned int program) {
+    if ( program == 0 ) return;
+    if ( State().program == program ) State().program = UNKNOWN_BINDING;
+    glDeleteProgram(program);
+}
+
+void GLState::DeleteTexture(unsigned int texture) {
+    if ( texture == 0 ) return;
+    for ( unsigned int i = 0; i < MAX_TEXTURE_UNITS; i++ ) Forget(State().textures[i], texture);
+    glDeleteTextures(1, &texture);
+}
+
+void GLState::DeleteBuffer(unsigned int buffer) {
+    if ( buffer == 0 ) return;
+    Forget(State().buffers, buffer);
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLState::DeleteVertexArray(unsigned int vertexArray) {
+    if ( vertexArray == 0 ) return;
+    if ( State().vertexArray == vertexArray ) {
+        State().vertexArray = UNKNOWN_BINDING;
+        ForgetElementBuffer();
+    }
+
+    glDeleteVertexArrays(1, &vertexArray);
+}
+
+void GLState::Invalidate() {
+    CachedState& state = State();
+    bool caching = state.caching;
+    Statistics statistics = state.statistics;
+
+    state = CreateState();
+    state.caching = caching;
+    state.statistics = statistics;
+}
+
+void GLState::SetCaching(bool enabled) {
+    State().caching = enabled;
+}
+
+bool GLState::IsCaching() {
+    return State().caching;
+}
+
+void GLState::Count(Call call, std::size_t count) {
+    State().statistics.issued[call] += count;
+}
+
+const GLState::Statistics& GLState::GetStatistics() {
+    return State().statistics;
+}
+
+std::size_t GLState::GetIssuedCalls() {
+    std::size_t total = 0;
+    for ( unsigned int i = 0; i < CALL_COUNT; i++ ) total += State().statistics.issued[i];
+    return total;
+}
+
+std::size_t GLState::GetSkippedCalls() {
+    std::size_t total = 0;
+    for ( unsigned int i = 0; i < CALL_COUNT; i++ ) total += State().statistics.skipped[i];
+    return total;
+}
+
+void GLState::ResetStatistics() {
+    State().statistics = Statistics();
+}
@@ -0,0 +1,60 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <cstddef>
+
+/*
+ * GLState: Cache of the GL bindings made by the graphics library.
+ *
+ * The program, the active texture unit, the texture bound to every unit, the
+ * buffer bound to every target and the vertex array are remembered, and a
+ * bind of the object that is already bound is skipped. The element array
+ * buffer belongs to the vertex array, so binding a vertex array forgets it.
+ *
+ * Vertex arrays stay bound after a draw: code that sets vertex attributes or
+ * binds an element buffer binds its own vertex array (or 0) through GLState
+ * first. Code that binds objects directly with GL, or a change of context,
+ * has to call Invalidate.
+ *
+ * Every call made through GLState is counted, issued or skipped. Calls that
+ * are never cached (attribute setup, uniforms, draws) are counted by their
+ * callers with Count, so the statistics hold the GL calls of a frame.
+ */
+class GLState {
+public:
+    enum Call { USE_PROGRAM, ACTIVE_TEXTURE, BIND_TEXTURE, BIND_BUFFER, BIND_VERTEX_ARRAY, VERTEX_ATTRIBUTE, UNIFORM, DRAW, CALL_COUNT };
+
+    struct Statistics {
+        std::size_t issued[CALL_COUNT];
+        std::size_t skipped[CALL_COUNT];
+    };
+
+    static void UseProgram(unsigned int program);
+    static void ActiveTexture(unsigned int unit);
+    static void BindTexture(unsigned int target, unsigned int texture);
+    static void BindBuffer(unsigned int target, unsigned int buffer);
+    static void BindVertexArray(unsigned int vertexArray);
+
+    /* Deletes an object and forgets its bindings, its name may be reused. */
+    static void DeleteProgram(unsigned int program);
+    static void DeleteTexture(unsigned int texture);
+    static void DeleteBuffer(unsigned int buffer);
+    static void DeleteVertexArray(unsigned int vertexArray);
+
+    /* Forgets every binding; the next bind of each kind is issued. */
+    static void Invalidate();
+
+    /* Without caching every bind is issued (and counted), for comparison. */
+    static void SetCaching(bool enabled);
+    static bool IsCaching();
+
+    /* Counts calls made directly with GL. */
+    static void Count(Call call, std::size_t count = 1);
+
+    static const Statistics& GetStatistics();
+    static std::size_t GetIssuedCalls();
+    static std::size_t GetSkippedCalls();
+    static void ResetStatistics();
+};
+
+#endif
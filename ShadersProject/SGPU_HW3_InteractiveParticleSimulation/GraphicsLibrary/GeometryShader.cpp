@@ -40,11 +40,12 @@ bool GeometryShader::compile() {
 
     glCompileShader(this->geometryId);
     if ( !this->compileStatus(this->geometryId, this->geomFilename) ) return false;
+    if ( this->programId == 0 ) this->programId = glCreateProgram();
     return true;
 }
 
 bool GeometryShader::link() {
-    this->programId = glCreateProgram();
+    if ( this->programId == 0 ) this->programId = glCreateProgram();
     glAttachShader(this->programId, this->vertexId);
     glAttachShader(this->programId, this->geometryId);
     glAttachShader(this->programId, this->fragmentId);
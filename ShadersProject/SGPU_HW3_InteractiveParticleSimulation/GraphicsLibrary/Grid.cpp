@@ -1,4 +1,5 @@
 #include "Grid.h"
+#include "GLState.h"
 
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
@@ -7,10 +8,14 @@ const static unsigned int COLOR_LOC = 1;
 
 Grid::Grid() {
     this->vboId = 0;
+    this->vaoId = 0;
     this->shader = nullptr;
 }
 
-Grid::~Grid() {}
+Grid::~Grid() {
+    GLState::DeleteVertexArray(this->vaoId);
+    GLState::DeleteBuffer(this->vboId);
+}
 
 void Grid::loadShader(const std::string& vertexShader, const std::string& fragmentShader) {
     this->shader = std::make_shared<Shader>();
@@ -52,25 +57,32 @@ void Grid::construct(const Color3f& color, const Color3f& majorColor, float min,
 }
 
 void Grid::constructOnGPU() {
-    glGenBuffers(1, &this->vboId);
-    glBindBuffer(GL_ARRAY_BUFFER, this->vboId);
+    if ( this->vboId == 0 ) glGenBuffers(1, &this->vboId);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboId);
     glBufferData(GL_ARRAY_BUFFER, this->vertices.size() * sizeof(GridVertex), &this->vertices[0], GL_STATIC_DRAW);
-}
-
-void Grid::beginRender() {
-    if ( this->shader != nullptr ) this->shader->enable();
 
-    glBindBuffer(GL_ARRAY_BUFFER, this->vboId);
+    //--------------------------------------------------------------------------
+    // The attribute layout is recorded once in the vertex array.
+    //--------------------------------------------------------------------------
+    if ( this->vaoId == 0 ) glGenVertexArrays(1, &this->vaoId);
+    GLState::BindVertexArray(this->vaoId);
 
     glEnableVertexAttribArray(POSITION_LOC);
     glVertexAttribPointer(POSITION_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(GridVertex), BUFFER_OFFSET(0));
 
     glEnableVertexAttribArray(COLOR_LOC);
     glVertexAttribPointer(COLOR_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(GridVertex), BUFFER_OFFSET(3 * sizeof(float)));
+    GLState::Count(GLState::VERTEX_ATTRIBUTE, 4);
+}
+
+void Grid::beginRender() {
+    if ( this->shader != nullptr ) this->shader->enable();
+    GLState::BindVertexArray(this->vaoId);
 }
 
 void Grid::endRender() {
     glDrawArrays(GL_LINES, 0, this->vertices.size());
+    GLState::Count(GLState::DRAW);
 
     if ( this->shader != nullptr ) this->shader->disable();
 }
@@ -31,6 +31,7 @@ protected:
     std::shared_ptr<Shader> shader;
     std::vector<GridVertex> vertices;
     unsigned int vboId;
+    unsigned int vaoId;
 };
 
 #endif
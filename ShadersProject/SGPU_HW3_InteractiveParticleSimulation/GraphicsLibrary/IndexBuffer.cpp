@@ -0,0 +1,148 @@
+#include "IndexBuffer.h"
+#include <cstring>
+
+/* Number of vertices a 16-bit index can address. */
+const static std::size_t SHORT_INDEX_RANGE = 65536;
+const static unsigned int NO_LOCAL_INDEX = 0xFFFFFFFF;
+
+IndexBuffer::IndexBuffer() {
+    this->type = UNSIGNED_INT;
+    this->indexCount = 0;
+    this->duplicatedVertexCount = 0;
+}
+
+void IndexBuffer::addRange(std::size_t offset, std::size_t count, unsigned int baseVertex, unsigned int vertexCount) {
+    IndexRange range;
+    range.offset = offset;
+    range.count = count;
+    range.baseVertex = baseVertex;
+    range.minIndex = 0;
+    range.maxIndex = (vertexCount > 0) ? vertexCount - 1 : 0;
+    this->ranges.push_back(range);
+}
+
+bool IndexBuffer::build(const std::vector<TriangleFace>& faces, std::size_t vertexCount, std::size_t vertexStride, std::vector<unsigned char>& data, std::vector<unsigned int>& vertexRemap) {
+    this->ranges.clear();
+    this->indexCount = faces.size() * TRIANGLE_EDGE_COUNT;
+    this->duplicatedVertexCount = 0;
+    data.clear();
+    vertexRemap.clear();
+
+    if ( faces.size() == 0 ) {
+        std::cerr << "[IndexBuffer:build] Error: Face count = 0." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Small meshes: the face indices fit 16 bits as they are.
+    //--------------------------------------------------------------------------
+    if ( vertexCount <= SHORT_INDEX_RANGE ) {
+        this->type = UNSIGNED_SHORT;
+        data.resize(this->indexCount * sizeof(unsigned short));
+        unsigned short* indices = reinterpret_cast<unsigned short*>(&data[0]);
+        for ( std::size_t i = 0; i < faces.size(); i++ )
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) *indices++ = static_cast<unsigned short>(faces[i].indices[j]);
+
+        this->addRange(0, this->indexCount, 0, static_cast<unsigned int>(vertexCount));
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+    // Large meshes: split into 16-bit ranges unless the vertices duplicated
+    // between ranges cost more than halving the index data saves.
+    //--------------------------------------------------------------------------
+    this->buildSplitRanges(faces, vertexCount, data, vertexRemap);
+    if ( this->duplicatedVertexCount * vertexStride < this->indexCount * (sizeof(unsigned int) - sizeof(unsigned short)) ) return true;
+
+    this->ranges.clear();
+    this->duplicatedVertexCount = 0;
+    vertexRemap.clear();
+
+    this->type = UNSIGNED_INT;
+    data.resize(this->indexCount * sizeof(unsigned int));
+    std::memcpy(&data[0], &faces[0].indices[0], data.size());
+    this->addRange(0, this->indexCount, 0, static_cast<unsigned int>(vertexCount));
+    return true;
+}
+
+bool IndexBuffer::buildSplitRanges(const std::vector<TriangleFace>& faces, std::size_t vertexCount, std::vector<unsigned char>& data, std::vector<unsigned int>& vertexRemap) {
+    //--------------------------------------------------------------------------
+    // Faces are added to the current range as long as the range uses at most
+    // SHORT_INDEX_RANGE distinct vertices. localIndices maps a mesh vertex to
+    // its index in the current range; rangeStamps tells which range that
+    // entry belongs to so the table is never cleared.
+    //--------------------------------------------------------------------------
+    this->type = UNSIGNED_SHORT;
+    data.resize(this->indexCount * sizeof(unsigned short));
+    unsigned short* indices = reinterpret_cast<unsigned short*>(&data[0]);
+
+    std::vector<unsigned int> localIndices(vertexCount, NO_LOCAL_INDEX);
+    std::vector<unsigned int> rangeStamps(vertexCount, 0);
+    unsigned int stamp = 1;
+    unsigned int baseVertex = 0;
+    unsigned int rangeVertexCount = 0;
+    std::size_t rangeStart = 0;
+    vertexRemap.reserve(vertexCount);
+
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        const TriangleFace& face = faces[i];
+
+        unsigned int newVertices = 0;
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int v = face.indices[j];
+            bool repeated = (j > 0 && v == face.indices[0]) || (j > 1 && v == face.indices[1]);
+            if ( rangeStamps[v] != stamp && !repeated ) newVertices++;
+        }
+
+        if ( rangeVertexCount + newVertices > SHORT_INDEX_RANGE ) {
+            this->addRange(rangeStart * sizeof(unsigned short), i * TRIANGLE_EDGE_COUNT - rangeStart, baseVertex, rangeVertexCount);
+            rangeStart = i * TRIANGLE_EDGE_COUNT;
+            baseVertex += rangeVertexCount;
+            rangeVertexCount = 0;
+            stamp++;
+        }
+
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int v = face.indices[j];
+            if ( rangeStamps[v] != stamp ) {
+                rangeStamps[v] = stamp;
+                localIndices[v] = rangeVertexCount++;
+                vertexRemap.push_back(v);
+            }
+
+            *indices++ = static_cast<unsigned short>(localIndices[v]);
+        }
+    }
+
+    this->addRange(rangeStart * sizeof(unsigned short), this->indexCount - rangeStart, baseVertex, rangeVertexCount);
+    this->duplicatedVertexCount = (vertexRemap.size() > vertexCount) ? vertexRemap.size() - vertexCount : 0;
+    return true;
+}
+
+IndexBuffer::IndexType IndexBuffer::getType() const {
+    return this->type;
+}
+
+std::size_t IndexBuffer::getIndexSize() const {
+    return (this->type == UNSIGNED_SHORT) ? sizeof(unsigned short) : sizeof(unsigned int);
+}
+
+std::size_t IndexBuffer::getIndexCount() const {
+    return this->indexCount;
+}
+
+const std::vector<IndexRange>& IndexBuffer::getRanges() const {
+    return this->ranges;
+}
+
+std::size_t IndexBuffer::getByteSize() const {
+    return this->indexCount * this->getIndexSize();
+}
+
+std::size_t IndexBuffer::getUnpackedByteSize() const {
+    return this->indexCount * sizeof(unsigned int);
+}
+
+std::size_t IndexBuffer::getDuplicatedVertexCount() const {
+    return this->duplicatedVertexCount;
+}
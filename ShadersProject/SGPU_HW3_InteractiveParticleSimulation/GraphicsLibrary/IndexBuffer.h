@@ -0,0 +1,68 @@
+#ifndef INDEX_BUFFER_H
+#define INDEX_BUFFER_H
+
+#include <vector>
+#include "Face.h"
+
+/*
+ * Contiguous run of indices drawn with one call. Indices are stored relative
+ * to baseVertex and lie in [minIndex, maxIndex]; offset is in bytes.
+ */
+struct IndexRange {
+    std::size_t offset;
+    std::size_t count;
+    unsigned int baseVertex;
+    unsigned int minIndex;
+    unsigned int maxIndex;
+};
+
+/*
+ * IndexBuffer: Chooses the smallest index type for the faces of a mesh.
+ *
+ * Meshes with at most 65536 vertices get 16-bit indices in a single range.
+ * Larger meshes are split into consecutive ranges of faces that use at most
+ * 65536 distinct vertices each. The vertices of every range are laid out as
+ * one block of the GPU vertex buffer (vertices shared by two ranges are
+ * duplicated) and the range is drawn with glDrawRangeElementsBaseVertex
+ * using 16-bit indices into its block. If the duplicated vertices would
+ * take more memory than the 16-bit indices save, the mesh keeps 32-bit
+ * indices instead.
+ */
+class IndexBuffer {
+public:
+    enum IndexType { UNSIGNED_SHORT, UNSIGNED_INT };
+
+    IndexBuffer();
+
+    /*
+     * Builds the index data for faces; the ranges are kept for drawing. The
+     * vertex stride (in bytes) prices the duplicated vertices. If ranges were
+     * split, vertexRemap receives the mesh vertex of every GPU vertex,
+     * otherwise it is left empty and the vertices are used as is.
+     */
+    bool build(const std::vector<TriangleFace>& faces, std::size_t vertexCount, std::size_t vertexStride, std::vector<unsigned char>& data, std::vector<unsigned int>& vertexRemap);
+
+    IndexType getType() const;
+    std::size_t getIndexSize() const;
+    std::size_t getIndexCount() const;
+    const std::vector<IndexRange>& getRanges() const;
+
+    /* Size of the index data and what 32-bit indices would have needed. */
+    std::size_t getByteSize() const;
+    std::size_t getUnpackedByteSize() const;
+
+    /* Vertices duplicated because they are shared by two ranges. */
+    std::size_t getDuplicatedVertexCount() const;
+
+protected:
+    bool buildSplitRanges(const std::vector<TriangleFace>& faces, std::size_t vertexCount, std::vector<unsigned char>& data, std::vector<unsigned int>& vertexRemap);
+    void addRange(std::size_t offset, std::size_t count, unsigned int baseVertex, unsigned int vertexCount);
+
+protected:
+    IndexType type;
+    std::size_t indexCount;
+    std::size_t duplicatedVertexCount;
+    std::vector<IndexRange> ranges;
+};
+
+#endif
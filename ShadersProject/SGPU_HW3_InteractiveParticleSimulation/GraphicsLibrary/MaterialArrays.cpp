@@ -0,0 +1,122 @@
+#include "MaterialArrays.h"
+#include "PNG.h"
+#include <iostream>
+#include <utility>
+
+const static char* MAP_SUFFIXES[3] = { "_diffuse.png", "_normal.png", "_specular.png" };
+const static unsigned int MAP_COUNT = 3;
+
+/* Decoded maps of one material */
+struct MaterialImages {
+    std::string name;
+    std::vector<unsigned char> maps[MAP_COUNT];
+    unsigned int width;
+    unsigned int height;
+};
+
+MaterialArrays::MaterialArrays() {
+    this->groupCount = 0;
+}
+
+bool MaterialArrays::load(const std::string& directory, const std::vector<std::string>& names) {
+    this->clear();
+
+    //--------------------------------------------------------------------------
+    // Decode every map and group the materials by size; the three maps of a
+    // material have to share one size to share a layer index.
+    //--------------------------------------------------------------------------
+    std::map<std::pair<unsigned int, unsigned int>, std::vector<MaterialImages>> groups;
+    for ( std::size_t i = 0; i < names.size(); i++ ) {
+        MaterialImages images;
+        images.name = names[i];
+        images.width = 0;
+        images.height = 0;
+
+        for ( unsigned int m = 0; m < MAP_COUNT; m++ ) {
+            std::string filename = directory + "/" + names[i] + MAP_SUFFIXES[m];
+            unsigned int width = 0, height = 0;
+            if ( lodepng::decode(images.maps[m], width, height, filename, LCT_RGBA) ) {
+                std::cerr << "[MaterialArrays:load] Error: Could not load PNG image: " << filename << std::endl;
+                return false;
+            }
+
+            if ( m == 0 ) {
+                images.width = width;
+                images.height = height;
+            }
+            else if ( width != images.width || height != images.height ) {
+                std::cerr << "[MaterialArrays:load] Error: Maps of material " << names[i] << " differ in size." << std::endl;
+                return false;
+            }
+        }
+
+        std::vector<MaterialImages>& group = groups[std::make_pair(images.width, images.height)];
+        group.push_back(MaterialImages());
+        std::swap(group.back(), images);
+    }
+
+    //--------------------------------------------------------------------------
+    // One array per map and size; materials take the layers in the order
+    // they were named.
+    //--------------------------------------------------------------------------
+    std::map<std::pair<unsigned int, unsigned int>, std::vector<MaterialImages>>::iterator group;
+    for ( group = groups.begin(); group != groups.end(); group++ ) {
+        std::vector<MaterialImages>& images = group->second;
+        std::shared_ptr<TextureArray> arrays[MAP_COUNT];
+
+        for ( unsigned int m = 0; m < MAP_COUNT; m++ ) {
+            std::vector<std::vector<unsigned char>> layers(images.size());
+            for ( std::size_t i = 0; i < images.size(); i++ ) layers[i].swap(images[i].maps[m]);
+
+            arrays[m] = std::make_shared<TextureArray>();
+            if ( !arrays[m]->create(group->first.first, group->first.second, layers) ) return false;
+        }
+
+        for ( std::size_t i = 0; i < images.size(); i++ ) {
+            MaterialLayer& material = this->materials[images[i].name];
+            material.diffuse = arrays[0];
+            material.normal = arrays[1];
+            material.specular = arrays[2];
+            material.layer = static_cast<unsigned int>(i);
+        }
+
+        this->groupCount++;
+    }
+
+    return true;
+}
+
+void MaterialArrays::clear() {
+    this->materials.clear();
+    this->groupCount = 0;
+}
+
+const MaterialLayer* MaterialArrays::find(const std::string& name) const {
+    std::map<std::string, MaterialLayer>::const_iterator found = this->materials.find(name);
+    if ( found == this->materials.end() ) return nullptr;
+    return &found->second;
+}
+
+std::shared_ptr<Shader> MaterialArrays::createShader(const Shader& program, const std::string& name) const {
+    const MaterialLayer* material = this->find(name);
+    if ( material == nullptr ) {
+        std::cerr << "[MaterialArrays:createShader] Error: Unknown material: " << name << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<Shader> shader = std::make_shared<Shader>(program);
+    shader->diffuseTexture = material->diffuse;
+    shader->normalTexture = material->normal;
+    shader->specularTexture = material->specular;
+    shader->heightmapTexture = nullptr;
+    shader->textureLayer = static_cast<int>(material->layer);
+    return shader;
+}
+
+std::size_t MaterialArrays::getMaterialCount() const {
+    return this->materials.size();
+}
+
+std::size_t MaterialArrays::getGroupCount() const {
+    return this->groupCount;
+}
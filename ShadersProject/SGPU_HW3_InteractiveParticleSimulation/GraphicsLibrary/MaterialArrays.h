@@ -0,0 +1,54 @@
+#ifndef MATERIAL_ARRAYS_H
+#define MATERIAL_ARRAYS_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TextureArray.h"
+#include "Shader.h"
+
+/* Texture arrays holding a material's maps and its layer in them */
+struct MaterialLayer {
+    std::shared_ptr<TextureArray> diffuse;
+    std::shared_ptr<TextureArray> normal;
+    std::shared_ptr<TextureArray> specular;
+    unsigned int layer;
+};
+
+/*
+ * MaterialArrays: Materials of the textures directory packed into texture
+ * arrays. A material is the three maps <name>_diffuse.png, <name>_normal.png
+ * and <name>_specular.png, all of one size. Materials of the same size share
+ * a diffuse, a normal and a specular TextureArray, each material being one
+ * layer of the three.
+ *
+ * createShader returns a copy of a program with the arrays and the layer of
+ * a material. The copies of one size group hold the same textures, so a
+ * RenderQueue draws them as one batch and only the layer changes per draw.
+ * The program samples sampler2DArray diffuseTexture, normalTexture and
+ * specularTexture at the float uniform materialLayer (see
+ * SpecularMappingArray.frag).
+ */
+class MaterialArrays {
+public:
+    MaterialArrays();
+
+    /* Loads and packs the named materials of directory. */
+    bool load(const std::string& directory, const std::vector<std::string>& names);
+    void clear();
+
+    const MaterialLayer* find(const std::string& name) const;
+    std::shared_ptr<Shader> createShader(const Shader& program, const std::string& name) const;
+
+    std::size_t getMaterialCount() const;
+
+    /* Number of size groups, each one diffuse, normal and specular array */
+    std::size_t getGroupCount() const;
+
+protected:
+    std::map<std::string, MaterialLayer> materials;
+    std::size_t groupCount;
+};
+
+#endif
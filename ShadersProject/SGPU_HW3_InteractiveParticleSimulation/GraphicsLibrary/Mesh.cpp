@@ -25,30 +25,257 @@
  */
 #include "Mesh.h"
 #include "ObjMesh.h"
+#include "ObjWriter.h"
+#include "Triangulation.h"
+#include "Parallel.h"
+#include "GLState.h"
+#include <TransformationBatch.h>
 #include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <cstring>
+#include <fstream>
 #include <gl/glew.h>
 #include <gl/freeglut.h>
 
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
+const static std::string MESH_CACHE_EXTENSION = ".mesh";
+const static char MESH_CACHE_MAGIC[4] = { 'M', 'E', 'S', 'H' };
+const static unsigned int MESH_CACHE_VERSION = 1;
+
+static bool IsMeshCache(const std::string& filename) {
+    std::size_t length = MESH_CACHE_EXTENSION.length();
+    return filename.length() > length && filename.compare(filename.length() - length, length, MESH_CACHE_EXTENSION) == 0;
+}
+
+//------------------------------------------------------------------------------
+// Binary serialization helpers of the mesh cache. Every value is a 32-bit
+// unsigned int or float written in little endian byte order, whatever the
+// byte order of the machine, and structures are written field by field so
+// their padding never reaches the file. Vertex and face arrays are encoded
+// into one buffer and written (or read and decoded) at once.
+//------------------------------------------------------------------------------
+const static std::size_t CACHED_VALUE_SIZE = 4;
+const static std::size_t CACHED_VERTEX_SIZE = 16 * CACHED_VALUE_SIZE;
+const static std::size_t CACHED_FACE_SIZE = TRIANGLE_EDGE_COUNT * CACHED_VALUE_SIZE;
+const static std::size_t CACHED_MESHLET_SIZE = 11 * CACHED_VALUE_SIZE;
+const static std::size_t CACHED_LOD_MIN_SIZE = 4 * CACHED_VALUE_SIZE;
+
+static void EncodeUInt(unsigned char* bytes, unsigned int value) {
+    bytes[0] = static_cast<unsigned char>(value);
+    bytes[1] = static_cast<unsigned char>(value >> 8);
+    bytes[2] = static_cast<unsigned char>(value >> 16);
+    bytes[3] = static_cast<unsigned char>(value >> 24);
+}
+
+static unsigned int DecodeUInt(const unsigned char* bytes) {
+    return static_cast<unsigned int>(bytes[0]) | (static_cast<unsigned int>(bytes[1]) << 8) |
+           (static_cast<unsigned int>(bytes[2]) << 16) | (static_cast<unsigned int>(bytes[3]) << 24);
+}
+
+static void EncodeFloat(unsigned char* bytes, float value) {
+    unsigned int bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    EncodeUInt(bytes, bits);
+}
+
+static float DecodeFloat(const unsigned char* bytes) {
+    unsigned int bits = DecodeUInt(bytes);
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/* Vertex: position, normal, tangent, texture coordinate and color. */
+static void EncodeElement(unsigned char* bytes, const Vertex& vertex) {
+    const float* position = vertex.position.constData();
+    const float* normal = vertex.normal.constData();
+    const float* tangent = vertex.tangent.constData();
+    const float* textureCoord = vertex.textureCoord.constData();
+    const float* color = vertex.color;
+
+    for ( unsigned int k = 0; k < 3; k++ ) EncodeFloat(bytes + (k + 0) * CACHED_VALUE_SIZE, position[k]);
+    for ( unsigned int k = 0; k < 3; k++ ) EncodeFloat(bytes + (k + 3) * CACHED_VALUE_SIZE, normal[k]);
+    for ( unsigned int k = 0; k < 4; k++ ) EncodeFloat(bytes + (k + 6) * CACHED_VALUE_SIZE, tangent[k]);
+    for ( unsigned int k = 0; k < 3; k++ ) EncodeFloat(bytes + (k + 10) * CACHED_VALUE_SIZE, textureCoord[k]);
+    for ( unsigned int k = 0; k < 3; k++ ) EncodeFloat(bytes + (k + 13) * CACHED_VALUE_SIZE, color[k]);
+}
+
+static void DecodeElement(const unsigned char* bytes, Vertex& vertex) {
+    float* color = vertex.color;
+    for ( unsigned int k = 0; k < 3; k++ ) vertex.position[k] = DecodeFloat(bytes + (k + 0) * CACHED_VALUE_SIZE);
+    for ( unsigned int k = 0; k < 3; k++ ) vertex.normal[k] = DecodeFloat(bytes + (k + 3) * CACHED_VALUE_SIZE);
+    for ( unsigned int k = 0; k < 4; k++ ) vertex.tangent[k] = DecodeFloat(bytes + (k + 6) * CACHED_VALUE_SIZE);
+    for ( unsigned int k = 0; k < 3; k++ ) vertex.textureCoord[k] = DecodeFloat(bytes + (k + 10) * CACHED_VALUE_SIZE);
+    for ( unsigned int k = 0; k < 3; k++ ) color[k] = DecodeFloat(bytes + (k + 13) * CACHED_VALUE_SIZE);
+}
+
+static void EncodeElement(unsigned char* bytes, const TriangleFace& face) {
+    for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) EncodeUInt(bytes + k * CACHED_VALUE_SIZE, face.indices[k]);
+}
+
+static void DecodeElement(const unsigned char* bytes, TriangleFace& face) {
+    for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ ) face.indices[k] = DecodeUInt(bytes + k * CACHED_VALUE_SIZE);
+}
+
+static void WriteUInt(std::ostream& out, unsigned int value) {
+    unsigned char bytes[CACHED_VALUE_SIZE];
+    EncodeUInt(bytes, value);
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+static void WriteFloat(std::ostream& out, float value) {
+    unsigned char bytes[CACHED_VALUE_SIZE];
+    EncodeFloat(bytes, value);
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+static void WriteVector(std::ostream& out, const Vector3f& value) {
+    WriteFloat(out, value.x());
+    WriteFloat(out, value.y());
+    WriteFloat(out, value.z());
+}
+
+template <typename T>
+static void WriteArray(std::ostream& out, const std::vector<T>& values, std::size_t elementSize) {
+    WriteUInt(out, static_cast<unsigned int>(values.size()));
+    if ( values.size() == 0 ) return;
+
+    std::vector<unsigned char> bytes(values.size() * elementSize);
+    for ( std::size_t i = 0; i < values.size(); i++ ) EncodeElement(&bytes[i * elementSize], values[i]);
+    out.write(reinterpret_cast<const char*>(&bytes[0]), bytes.size());
+}
+
+static void WriteCacheStatistics(std::ostream& out, const VertexCacheStatistics& statistics) {
+    WriteUInt(out, static_cast<unsigned int>(statistics.transformedVertices));
+    WriteFloat(out, statistics.acmr);
+    WriteFloat(out, statistics.atvr);
+}
+
+/* Bytes left between the read position and the end of a file of fileSize bytes. */
+static std::size_t RemainingBytes(std::istream& in, std::size_t fileSize) {
+    std::streamoff position = in.tellg();
+    if ( position < 0 || static_cast<std::size_t>(position) > fileSize ) return 0;
+    return fileSize - static_cast<std::size_t>(position);
+}
+
+static bool ReadUInt(std::istream& in, unsigned int& value) {
+    unsigned char bytes[CACHED_VALUE_SIZE];
+    in.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+    value = DecodeUInt(bytes);
+    return in.good();
+}
+
+static bool ReadFloat(std::istream& in, float& value) {
+    unsigned char bytes[CACHED_VALUE_SIZE];
+    in.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+    value = DecodeFloat(bytes);
+    return in.good();
+}
+
+static bool ReadVector(std::istream& in, Vector3f& value) {
+    float x, y, z;
+    if ( !ReadFloat(in, x) || !ReadFloat(in, y) || !ReadFloat(in, z) ) return false;
+    value = Vector3f(x, y, z);
+    return true;
+}
+
+/* Reads a count and its elements; a count the rest of the file cannot hold is rejected before allocating. */
+template <typename T>
+static bool ReadArray(std::istream& in, std::vector<T>& values, std::size_t elementSize, std::size_t fileSize) {
+    unsigned int count = 0;
+    if ( !ReadUInt(in, count) ) return false;
+    if ( count > RemainingBytes(in, fileSize) / elementSize ) return false;
+
+    values.resize(count);
+    if ( count == 0 ) return true;
+
+    std::vector<unsigned char> bytes(count * elementSize);
+    in.read(reinterpret_cast<char*>(&bytes[0]), bytes.size());
+    if ( !in.good() ) return false;
+
+    for ( std::size_t i = 0; i < values.size(); i++ ) DecodeElement(&bytes[i * elementSize], values[i]);
+    return true;
+}
+
+static bool ReadCacheStatistics(std::istream& in, VertexCacheStatistics& statistics) {
+    unsigned int transformedVertices = 0;
+    if ( !ReadUInt(in, transformedVertices) || !ReadFloat(in, statistics.acmr) || !ReadFloat(in, statistics.atvr) ) return false;
+    statistics.transformedVertices = transformedVertices;
+    return true;
+}
+
+/* True if every index of the faces refers to one of vertexCount vertices. */
+static bool FacesInRange(const std::vector<TriangleFace>& faces, std::size_t vertexCount) {
+    for ( std::size_t i = 0; i < faces.size(); i++ )
+        for ( unsigned int k = 0; k < TRIANGLE_EDGE_COUNT; k++ )
+            if ( faces[i].indices[k] >= vertexCount ) return false;
+    return true;
+}
+
 const static unsigned int POSITION_LOC = 0;
 const static unsigned int NORMAL_LOC = 1;	
 const static unsigned int TANGENT_LOC = 2;
 const static unsigned int TEXTURE_COORD_LOC = 3;
 const static unsigned int COLOR_LOC = 4;
 
+/* The instance matrix takes one location per column (5 to 8). */
+const static unsigned int INSTANCE_MATRIX_LOC = 5;
+const static unsigned int INSTANCE_COLOR_LOC = 9;
+const static unsigned int INSTANCE_MATRIX_FLOATS = 16;
+const static unsigned int INSTANCE_COLOR_FLOATS = 3;
+
+/* Instance counts below this are compiled on the calling thread. */
+const static std::size_t MIN_PARALLEL_INSTANCE_RANGE = 16384;
+
+/* Attribute locations indexed by VertexFormat::Attribute. */
+const static unsigned int ATTRIBUTE_LOCS[VertexFormat::ATTRIBUTE_COUNT] = { POSITION_LOC, NORMAL_LOC, TANGENT_LOC, TEXTURE_COORD_LOC, COLOR_LOC };
+
+static GLenum ToGLType(VertexFormat::ComponentType type) {
+    switch ( type ) {
+        case VertexFormat::HALF_FLOAT: return GL_HALF_FLOAT;
+        case VertexFormat::UNSIGNED_SHORT: return GL_UNSIGNED_SHORT;
+        case VertexFormat::SHORT: return GL_SHORT;
+        default: return GL_FLOAT;
+    }
+}
+
 Mesh::Mesh() {
     this->transform = Transformation<float>::Identity();
     this->shader = nullptr;
+    this->vboVertex = 0;
+    this->vboIndex = 0;
+    this->vboInstance = 0;
+    this->vao = 0;
+    this->instanceCount = 0;
+    this->optimizationReport = MeshOptimizationReport();
+    this->lod = 0;
+    this->boundingRadius = 0.0f;
+    this->meshletCulling = false;
+    this->cullingStatistics = MeshletCullingStatistics();
 }
 
 Mesh::Mesh(const Mesh& mesh) {
     this->transform = mesh.transform;
+    this->format = mesh.format;
+    this->lod = 0;
+    this->boundingRadius = 0.0f;
+    this->meshletCulling = false;
+    this->cullingStatistics = MeshletCullingStatistics();
+    this->vboVertex = 0;
+    this->vboIndex = 0;
+    this->vboInstance = 0;
+    this->vao = 0;
+    this->instanceCount = 0;
 }
 
 Mesh::~Mesh() {
-    glDeleteBuffers(1, &this->vboVertex);
-    glDeleteBuffers(1, &this->vboIndex);
+    GLState::DeleteVertexArray(this->vao);
+    GLState::DeleteBuffer(this->vboVertex);
+    GLState::DeleteBuffer(this->vboIndex);
+    GLState::DeleteBuffer(this->vboInstance);
 }
 
 /* http://www.terathon.com/code/tangent.html */
@@ -240,46 +467,24 @@ bool Decompress(
 }
 
 bool Mesh::load(const std::string& filename) {
+    if ( IsMeshCache(filename) ) return this->loadCache(filename);
     std::shared_ptr<ObjMesh> mesh = nullptr;
 
     if ( !LoadObjMesh(filename, mesh) ) return false;
 
-    if ( mesh->faces.size() > 0 ) {
-        if ( mesh->faces[0].type != TRIANGLE ) {
-            std::cerr << "[Mesh:load] Error: Only triangle-face Obj files supported." << std::endl;
-            return false;
-        }
-    }
-
     this->name = mesh->name;
     std::vector<Vector3f> normals;
     std::vector<Vector4f> tangents;
-    std::vector<unsigned int> indices;
-    std::vector<unsigned int> textureIndices;
-    std::vector<unsigned int> normalIndices;
 
     //--------------------------------------------------------------------------
-    // Copy the face indices from the *.obj file to this mesh.
+    // Triangulate the quads and polygons of the *.obj file while copying the
+    // face indices to this mesh (see TriangulateObjFaces).
     //--------------------------------------------------------------------------
-    indices.resize(mesh->faces.size() * TRIANGLE_EDGE_COUNT);
-    normalIndices.resize(mesh->faces.size() * TRIANGLE_EDGE_COUNT);
-    textureIndices.resize(mesh->faces.size() * TRIANGLE_EDGE_COUNT);
-    unsigned int index = 0;
-    for ( unsigned int i = 0; i < mesh->faces.size(); i++ ) {
-        indices[index] = static_cast<unsigned int>(mesh->faces[i].vertexIndices[A]);
-        indices[index + 1] = static_cast<unsigned int>(mesh->faces[i].vertexIndices[B]);
-        indices[index + 2] = static_cast<unsigned int>(mesh->faces[i].vertexIndices[C]);
-
-        normalIndices[index] = static_cast<unsigned int>(mesh->faces[i].normalIndices[A]);
-        normalIndices[index + 1] = static_cast<unsigned int>(mesh->faces[i].normalIndices[B]);
-        normalIndices[index + 2] = static_cast<unsigned int>(mesh->faces[i].normalIndices[C]);
-
-        textureIndices[index] = static_cast<unsigned int>(mesh->faces[i].textureIndices[A]);
-        textureIndices[index + 1] = static_cast<unsigned int>(mesh->faces[i].textureIndices[B]);
-        textureIndices[index + 2] = static_cast<unsigned int>(mesh->faces[i].textureIndices[C]);
+    std::vector<const Obj_Face*> objFaces(mesh->faces.size());
+    for ( std::size_t i = 0; i < mesh->faces.size(); i++ ) objFaces[i] = &mesh->faces[i];
 
-        index += TRIANGLE_EDGE_COUNT;
-    }
+    ObjTriangles triangles;
+    if ( !TriangulateObjFaces(objFaces, mesh->vertices, triangles) ) return false;
 
     //--------------------------------------------------------------------------
     // Calcualte the vertex normals, tangents, and face normals.
@@ -291,9 +496,31 @@ bool Mesh::load(const std::string& filename) {
     //--------------------------------------------------------------------------
     // Decompress the OBJ file format for rendering.
     //--------------------------------------------------------------------------
-    Decompress(indices, normalIndices, textureIndices, mesh->vertices, normals, mesh->textureCoordinates, tangents, this->vertices, this->faces);
+    Decompress(triangles.vertexIndices, triangles.normalIndices, triangles.textureIndices, mesh->vertices, normals, mesh->textureCoordinates, tangents, this->vertices, this->faces);
     CalculateTangents(this->vertices, this->faces);
-    
+
+    //--------------------------------------------------------------------------
+    // Reorder the faces for the post-transform vertex cache and overdraw, and
+    // the vertices into the order the faces use them.
+    //--------------------------------------------------------------------------
+    OptimizeMesh(this->vertices, this->faces, &this->optimizationReport);
+
+    //--------------------------------------------------------------------------
+    // Partition the faces into meshlets for culling. This regroups the faces
+    // (each meshlet keeps a vertex cache order), so the vertices are put
+    // back into the order the new faces use them.
+    //--------------------------------------------------------------------------
+    BuildMeshlets(this->vertices, this->faces, this->meshlets);
+    OptimizeVertexFetch(this->vertices, this->faces);
+    this->optimizationReport.after = SimulateVertexCache(this->faces, this->vertices.size());
+
+    //--------------------------------------------------------------------------
+    // Cache the bounds and build the levels of detail over the optimized
+    // vertices.
+    //--------------------------------------------------------------------------
+    this->computeBounds();
+    this->generateLods();
+
     //--------------------------------------------------------------------------
     // Set all colors to black since they are not provided by an OBJ file.
     //--------------------------------------------------------------------------
@@ -322,6 +549,8 @@ bool Mesh::loadShader(const std::string& vertexFilename, const std::string& frag
     glBindAttribLocation(this->shader->getProgramID(), TANGENT_LOC, "tangent");
     glBindAttribLocation(this->shader->getProgramID(), TEXTURE_COORD_LOC, "textureCoordinate");
     glBindAttribLocation(this->shader->getProgramID(), COLOR_LOC, "color");
+    glBindAttribLocation(this->shader->getProgramID(), INSTANCE_MATRIX_LOC, "instanceMatrix");
+    glBindAttribLocation(this->shader->getProgramID(), INSTANCE_COLOR_LOC, "instanceColor");
 
     if ( !shader->link() ) {
         std::cerr << "[Mesh:loadShader] Error: Could not link shader program." << std::endl;
@@ -332,64 +561,342 @@ bool Mesh::loadShader(const std::string& vertexFilename, const std::string& frag
 }
 
 bool Mesh::save(const std::string& filename) {
-    return true;
+    if ( filename.length() == 0 ) {
+        std::cerr << "[Mesh:save] Error: Cannot save to filename of length 0." << std::endl;
+        return false;
+    }
+
+    if ( IsMeshCache(filename) ) return this->saveCache(filename);
+    return SaveObjTriangles(filename, this->name, this->vertices, this->faces);
 }
 
 void Mesh::beginRender() const {
     if ( this->shader != nullptr ) this->shader->enable();
+    this->bind();
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, this->vboVertex);
+void Mesh::endRender() const {
+    this->draw();
+    if ( this->shader != nullptr ) this->shader->disable();
+}
 
+void Mesh::bind() const {
     //--------------------------------------------------------------------------
-    // Vertex position data is the first component in the vertex structure so
-    // it is loaded first (with a byte offset of 0).
+    // The vertex array holds the attribute layout and the element buffer (see
+    // constructOnGPU). Quantized positions are relative to the bounding box
+    // of the mesh. The uniforms are ignored by shaders that do not declare
+    // them.
     //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(POSITION_LOC);
-    glVertexAttribPointer(POSITION_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(0));
+    GLState::BindVertexArray(this->vao);
 
+    if ( this->shader != nullptr ) {
+        this->shader->uniformVector("positionScale", this->format.getPositionScale());
+        this->shader->uniformVector("positionOffset", this->format.getPositionOffset());
+    }
+}
+
+void Mesh::draw() const {
     //--------------------------------------------------------------------------
-    // Vertex normals occupy the second element of the vertex and must be
-    // offset by 3 * sizeof(float) bytes due to the position taking the first
-    // 3 * 4 = 12 bytes of the structure.
+    // Render this mesh. Based on the vertex and element indices uploaded to the
+    // GPU (see constructOnGPU), this function will call the GPU to render all
+    // of the elements based on the face indices. Meshes too large for 16-bit
+    // indices are drawn as several ranges, each relative to a base vertex.
+    // Only the part of each range that belongs to the current level of detail
+    // is drawn.
     //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(NORMAL_LOC);
-    glVertexAttribPointer(NORMAL_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(3 * sizeof(float)));
-    
+    if ( this->lodIndexOffsets.size() < this->lod + 2 ) return;
+
+    std::size_t first = this->lodIndexOffsets[this->lod];
+    std::size_t last = this->lodIndexOffsets[this->lod + 1];
+
+    GLenum type = (this->indexBuffer.getType() == IndexBuffer::UNSIGNED_SHORT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    std::size_t indexSize = this->indexBuffer.getIndexSize();
+    const std::vector<IndexRange>& ranges = this->indexBuffer.getRanges();
+
     //--------------------------------------------------------------------------
-    // Vertex tangents are offset by 6 * sizeof(float) due to the position
-    // and normal values.
+    // Meshlet culling: the draws that passed are clipped to every index range
+    // and drawn with one glMultiDrawElements call per range.
     //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(TANGENT_LOC);
-    glVertexAttribPointer(TANGENT_LOC, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(6 * sizeof(float)));
+    if ( this->meshletCulling && this->lod == 0 && this->meshlets.size() > 0 ) {
+        std::vector<GLsizei> counts;
+        std::vector<const GLvoid*> offsets;
+        std::vector<GLint> baseVertices;
+        for ( std::size_t i = 0; i < ranges.size(); i++ ) {
+            const IndexRange& range = ranges[i];
+            std::size_t rangeFirst = range.offset / indexSize;
+            counts.clear();
+            offsets.clear();
+
+            for ( std::size_t j = 0; j < this->meshletDraws.size(); j++ ) {
+                const MeshletDraw& draw = this->meshletDraws[j];
+                std::size_t begin = std::max(draw.firstIndex, rangeFirst);
+                std::size_t end = std::min(draw.firstIndex + draw.indexCount, rangeFirst + range.count);
+                if ( begin >= end ) continue;
+
+                counts.push_back(static_cast<GLsizei>(end - begin));
+                offsets.push_back(BUFFER_OFFSET(begin * indexSize));
+            }
+
+            if ( counts.size() == 0 ) continue;
+            if ( range.baseVertex == 0 ) glMultiDrawElements(GL_TRIANGLES, &counts[0], type, &offsets[0], static_cast<GLsizei>(counts.size()));
+            else {
+                baseVertices.assign(counts.size(), static_cast<GLint>(range.baseVertex));
+                glMultiDrawElementsBaseVertex(GL_TRIANGLES, &counts[0], type, &offsets[0], static_cast<GLsizei>(counts.size()), &baseVertices[0]);
+            }
+
+            GLState::Count(GLState::DRAW);
+        }
+
+        return;
+    }
+
+    for ( std::size_t i = 0; i < ranges.size(); i++ ) {
+        const IndexRange& range = ranges[i];
+        std::size_t rangeFirst = range.offset / indexSize;
+        std::size_t begin = std::max(first, rangeFirst);
+        std::size_t end = std::min(last, rangeFirst + range.count);
+        if ( begin >= end ) continue;
+
+        GLsizei count = static_cast<GLsizei>(end - begin);
+        if ( range.baseVertex == 0 ) glDrawRangeElements(GL_TRIANGLES, range.minIndex, range.maxIndex, count, type, BUFFER_OFFSET(begin * indexSize));
+        else glDrawRangeElementsBaseVertex(GL_TRIANGLES, range.minIndex, range.maxIndex, count, type, BUFFER_OFFSET(begin * indexSize), static_cast<GLint>(range.baseVertex));
+        GLState::Count(GLState::DRAW);
+    }
+}
+
+bool Mesh::setInstances(const std::vector<Transformationf>& transforms, const std::vector<Color3f>& colors) {
+    if ( colors.size() != 0 && colors.size() != transforms.size() ) {
+        std::cerr << "[Mesh:setInstances] Error: Color count does not match the instance count." << std::endl;
+        return false;
+    }
+
+    if ( this->vao == 0 ) {
+        std::cerr << "[Mesh:setInstances] Error: Mesh is not loaded." << std::endl;
+        return false;
+    }
 
     //--------------------------------------------------------------------------
-    // Vertex texture coordinate is offset by 10 * sizeof(float) due to the
-    // position, normal, and tangent.
+    // The matrices are compiled straight into the upload buffer, split over
+    // threads for large instance counts. The colors follow the matrices.
     //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(TEXTURE_COORD_LOC);
-    glVertexAttribPointer(TEXTURE_COORD_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(10 * sizeof(float)));
+    std::size_t count = transforms.size();
+    this->instanceData.resize(count * (INSTANCE_MATRIX_FLOATS + INSTANCE_COLOR_FLOATS));
+    if ( count == 0 ) {
+        this->clearInstances();
+        return true;
+    }
+
+    float* matrices = &this->instanceData[0];
+    ParallelFor(0, count, MIN_PARALLEL_INSTANCE_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        CompileTransformations(&transforms[begin], matrices + begin * INSTANCE_MATRIX_FLOATS, end - begin);
+    });
+
+    float* instanceColors = matrices + count * INSTANCE_MATRIX_FLOATS;
+    for ( std::size_t i = 0; i < count; i++ ) {
+        instanceColors[INSTANCE_COLOR_FLOATS * i + 0] = (colors.size() != 0) ? colors[i].r() : 1.0f;
+        instanceColors[INSTANCE_COLOR_FLOATS * i + 1] = (colors.size() != 0) ? colors[i].g() : 1.0f;
+        instanceColors[INSTANCE_COLOR_FLOATS * i + 2] = (colors.size() != 0) ? colors[i].b() : 1.0f;
+    }
+
+    if ( this->vboInstance == 0 ) glGenBuffers(1, &this->vboInstance);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboInstance);
+    glBufferData(GL_ARRAY_BUFFER, this->instanceData.size() * sizeof(float), &this->instanceData[0], GL_STREAM_DRAW);
 
     //--------------------------------------------------------------------------
-    // Vertex color is offset by 13 * sizeof(float) due to the position,
-    // normal, tangent, and texture coordinate.
+    // Per-instance attributes advance once per instance (divisor 1): the four
+    // columns of the model matrix and the color stored after all matrices.
+    // They are part of the vertex array; only the color offset depends on the
+    // instance count, so they are only described again when it changes.
     //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(COLOR_LOC);
-    glVertexAttribPointer(COLOR_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(13 * sizeof(float)));
+    if ( count != this->instanceCount ) {
+        GLState::BindVertexArray(this->vao);
+        for ( unsigned int column = 0; column < 4; column++ ) {
+            glEnableVertexAttribArray(INSTANCE_MATRIX_LOC + column);
+            glVertexAttribPointer(INSTANCE_MATRIX_LOC + column, 4, GL_FLOAT, GL_FALSE, INSTANCE_MATRIX_FLOATS * sizeof(float), BUFFER_OFFSET(4 * column * sizeof(float)));
+            glVertexAttribDivisor(INSTANCE_MATRIX_LOC + column, 1);
+        }
+
+        glEnableVertexAttribArray(INSTANCE_COLOR_LOC);
+        glVertexAttribPointer(INSTANCE_COLOR_LOC, INSTANCE_COLOR_FLOATS, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(count * INSTANCE_MATRIX_FLOATS * sizeof(float)));
+        glVertexAttribDivisor(INSTANCE_COLOR_LOC, 1);
+        GLState::Count(GLState::VERTEX_ATTRIBUTE, 15);
+    }
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboIndex);
+    this->instanceCount = count;
+    return true;
 }
 
-void Mesh::endRender() const {
+void Mesh::clearInstances() {
     //--------------------------------------------------------------------------
-    // Render this mesh. Based on the vertex and element indices uploaded to the
-    // GPU (see constructOnGPU), this function will call the GPU to render all
-    // of the elements based on the face indices.
+    // Reset the per-instance attributes of the vertex array so the locations
+    // read their default value when the mesh is drawn without instancing.
     //--------------------------------------------------------------------------
-    glDrawRangeElements(GL_TRIANGLES, 0, static_cast<GLsizei>((this->faces.size() * TRIANGLE_EDGE_COUNT) - 1), static_cast<GLsizei>(this->faces.size() * TRIANGLE_EDGE_COUNT), GL_UNSIGNED_INT, 0);
+    if ( this->instanceCount != 0 ) {
+        GLState::BindVertexArray(this->vao);
+        for ( unsigned int location = INSTANCE_MATRIX_LOC; location <= INSTANCE_COLOR_LOC; location++ ) {
+            glVertexAttribDivisor(location, 0);
+            glDisableVertexAttribArray(location);
+        }
+
+        GLState::Count(GLState::VERTEX_ATTRIBUTE, 2 * (INSTANCE_COLOR_LOC - INSTANCE_MATRIX_LOC + 1));
+    }
+
+    this->instanceData.clear();
+    this->instanceCount = 0;
+}
+
+void Mesh::endRenderInstanced() const {
+    if ( this->instanceCount == 0 || this->lodIndexOffsets.size() < this->lod + 2 ) {
+        if ( this->shader != nullptr ) this->shader->disable();
+        return;
+    }
+
+    std::size_t first = this->lodIndexOffsets[this->lod];
+    std::size_t last = this->lodIndexOffsets[this->lod + 1];
+
+    GLenum type = (this->indexBuffer.getType() == IndexBuffer::UNSIGNED_SHORT) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    std::size_t indexSize = this->indexBuffer.getIndexSize();
+    const std::vector<IndexRange>& ranges = this->indexBuffer.getRanges();
+    GLsizei instances = static_cast<GLsizei>(this->instanceCount);
+
+    for ( std::size_t i = 0; i < ranges.size(); i++ ) {
+        const IndexRange& range = ranges[i];
+        std::size_t rangeFirst = range.offset / indexSize;
+        std::size_t begin = std::max(first, rangeFirst);
+        std::size_t end = std::min(last, rangeFirst + range.count);
+        if ( begin >= end ) continue;
+
+        GLsizei count = static_cast<GLsizei>(end - begin);
+        if ( range.baseVertex == 0 ) glDrawElementsInstanced(GL_TRIANGLES, count, type, BUFFER_OFFSET(begin * indexSize), instances);
+        else glDrawElementsInstancedBaseVertex(GL_TRIANGLES, count, type, BUFFER_OFFSET(begin * indexSize), instances, static_cast<GLint>(range.baseVertex));
+        GLState::Count(GLState::DRAW);
+    }
 
     if ( this->shader != nullptr ) this->shader->disable();
 }
 
+std::size_t Mesh::getInstanceCount() const {
+    return this->instanceCount;
+}
+
+bool Mesh::setVertexFormat(unsigned int options) {
+    this->format = VertexFormat(options);
+    if ( this->vertices.size() == 0 ) return true;
+    return this->constructOnGPU();
+}
+
+bool Mesh::generateLods(unsigned int maxLevels, float reduction) {
+    this->lod = 0;
+    if ( !GenerateLodChain(this->vertices, this->faces, this->lods, maxLevels, reduction) ) return false;
+
+    if ( this->vboIndex == 0 ) return true;
+    return this->constructOnGPU();
+}
+
+void Mesh::setLod(std::size_t level) {
+    this->lod = std::min(level, this->lods.size());
+}
+
+std::size_t Mesh::getLod() const {
+    return this->lod;
+}
+
+std::size_t Mesh::getLodCount() const {
+    return this->lods.size() + 1;
+}
+
+const std::vector<MeshLod>& Mesh::getLods() const {
+    return this->lods;
+}
+
+std::size_t Mesh::selectLod(const Vector3f& eye, float fov, float viewportHeight, float pixelError) const {
+    //--------------------------------------------------------------------------
+    // An object space error e at distance d covers e * h / (2 d tan(fov / 2))
+    // pixels of a viewport h pixels high. The distance is taken to the
+    // bounding sphere of the mesh and the error is scaled by the largest
+    // scale of the mesh transformation.
+    //--------------------------------------------------------------------------
+    const Vector3f& scale = this->transform.getScale();
+    float maxScale = std::max(std::max(std::fabs(scale.x()), std::fabs(scale.y())), std::fabs(scale.z()));
+
+    Vector3f center;
+    float radius = 0.0f;
+    this->getWorldBoundingSphere(center, radius);
+    float distance = static_cast<float>((eye - center).length()) - radius;
+    if ( distance <= 0.0f ) return 0;
+
+    float pixelsPerUnit = viewportHeight / (2.0f * distance * std::tan(fov * static_cast<float>(PI) / 360.0f));
+    std::size_t level = 0;
+    while ( level < this->lods.size() && this->lods[level].error.geometric * maxScale * pixelsPerUnit <= pixelError ) level++;
+    return level;
+}
+
+void Mesh::setMeshletCulling(bool enabled) {
+    this->meshletCulling = enabled;
+}
+
+bool Mesh::getMeshletCulling() const {
+    return this->meshletCulling;
+}
+
+void Mesh::cullMeshlets(const Matrix4f& modelView, const Matrix4f& projection) {
+    //--------------------------------------------------------------------------
+    // The meshlets are culled in object space: the frustum planes come from
+    // the model-view-projection matrix (Matrix4 products apply the left
+    // operand first) and the eye is the origin of the view moved back into
+    // object space, the last row of the inverse model-view matrix. This keeps
+    // the back facing test exact under any affine transformation.
+    //--------------------------------------------------------------------------
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    Matrix4f modelViewProjection = Matrix4f::Multiply(modelView, projection);
+    Matrix4f inverse = Matrix4f::Inverse(modelView);
+    Vector3f eye(inverse(3, 0), inverse(3, 1), inverse(3, 2));
+    CullMeshlets(this->meshlets, modelViewProjection, eye, this->meshletDraws, &this->cullingStatistics);
+
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    this->cullingStatistics.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+const std::vector<Meshlet>& Mesh::getMeshlets() const {
+    return this->meshlets;
+}
+
+const MeshletCullingStatistics& Mesh::getMeshletCullingStatistics() const {
+    return this->cullingStatistics;
+}
+
+const Vector3f& Mesh::getBoundingBoxMin() const {
+    return this->boundingBoxMin;
+}
+
+const Vector3f& Mesh::getBoundingBoxMax() const {
+    return this->boundingBoxMax;
+}
+
+const Vector3f& Mesh::getBoundingSphereCenter() const {
+    return this->boundingCenter;
+}
+
+float Mesh::getBoundingSphereRadius() const {
+    return this->boundingRadius;
+}
+
+void Mesh::getWorldBoundingSphere(Vector3f& center, float& radius) const {
+    this->getWorldBoundingSphere(this->transform, center, radius);
+}
+
+void Mesh::getWorldBoundingSphere(const Transformationf& transform, Vector3f& center, float& radius) const {
+    const float* m = transform.toMatrix().constData();
+    const Vector3f& c = this->boundingCenter;
+    center = Vector3f(m[0] * c.x() + m[4] * c.y() + m[8] * c.z() + m[12],
+                      m[1] * c.x() + m[5] * c.y() + m[9] * c.z() + m[13],
+                      m[2] * c.x() + m[6] * c.y() + m[10] * c.z() + m[14]);
+
+    const Vector3f& scale = transform.getScale();
+    radius = this->boundingRadius * std::max(std::max(std::fabs(scale.x()), std::fabs(scale.y())), std::fabs(scale.z()));
+}
+
 void Mesh::setName(const std::string& name) {
     this->name = name;
 }
@@ -462,7 +969,216 @@ const std::shared_ptr<Shader>& Mesh::getShader() const {
     return this->shader;
 }
 
+const std::vector<Vertex>& Mesh::getVertices() const {
+    return this->vertices;
+}
+
+const std::vector<TriangleFace>& Mesh::getFaces() const {
+    return this->faces;
+}
+
+const VertexFormat& Mesh::getVertexFormat() const {
+    return this->format;
+}
+
+const MeshOptimizationReport& Mesh::getOptimizationReport() const {
+    return this->optimizationReport;
+}
+
+const IndexBuffer& Mesh::getIndexBuffer() const {
+    return this->indexBuffer;
+}
+
+void Mesh::computeBounds() {
+    this->boundingBoxMin = Vector3f(0.0f, 0.0f, 0.0f);
+    this->boundingBoxMax = Vector3f(0.0f, 0.0f, 0.0f);
+    this->boundingCenter = Vector3f(0.0f, 0.0f, 0.0f);
+    this->boundingRadius = 0.0f;
+    if ( this->vertices.size() == 0 ) return;
+
+    this->boundingBoxMin = this->vertices[0].position;
+    this->boundingBoxMax = this->vertices[0].position;
+    for ( std::size_t i = 1; i < this->vertices.size(); i++ ) {
+        const Vector3f& p = this->vertices[i].position;
+        for ( unsigned int axis = 0; axis < 3; axis++ ) {
+            this->boundingBoxMin[axis] = std::min(this->boundingBoxMin[axis], p[axis]);
+            this->boundingBoxMax[axis] = std::max(this->boundingBoxMax[axis], p[axis]);
+        }
+    }
+
+    this->boundingCenter = (this->boundingBoxMin + this->boundingBoxMax) * 0.5f;
+    for ( std::size_t i = 0; i < this->vertices.size(); i++ )
+        this->boundingRadius = std::max(this->boundingRadius, static_cast<float>((this->vertices[i].position - this->boundingCenter).length()));
+}
+
+bool Mesh::loadCache(const std::string& filename) {
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if ( !in.is_open() ) {
+        std::cerr << "[Mesh:loadCache] Error: Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    in.seekg(0, std::ios_base::end);
+    std::streamoff end = in.tellg();
+    in.seekg(0, std::ios_base::beg);
+    std::size_t fileSize = (end > 0) ? static_cast<std::size_t>(end) : 0;
+
+    char magic[4];
+    unsigned int version = 0;
+    in.read(magic, sizeof(magic));
+    if ( !in.good() || std::memcmp(magic, MESH_CACHE_MAGIC, sizeof(magic)) != 0 ) {
+        std::cerr << "[Mesh:loadCache] Error: Not a mesh cache: " << filename << std::endl;
+        return false;
+    }
+
+    if ( !ReadUInt(in, version) || version != MESH_CACHE_VERSION ) {
+        std::cerr << "[Mesh:loadCache] Error: Unsupported mesh cache version: " << version << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Read everything load computed: the welded and optimized geometry, the
+    // meshlets, the levels of detail and the optimization report. Every count
+    // is checked against the bytes left in the file before anything is
+    // allocated, so a damaged cache fails instead of allocating its count.
+    //--------------------------------------------------------------------------
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<TriangleFace> faces;
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshLod> lods;
+    MeshOptimizationReport report;
+    unsigned int nameLength = 0, meshletCount = 0, lodCount = 0, clusterCount = 0;
+
+    bool valid = ReadUInt(in, nameLength) && nameLength <= RemainingBytes(in, fileSize);
+    if ( valid ) {
+        name.resize(nameLength);
+        if ( nameLength > 0 ) in.read(&name[0], nameLength);
+        valid = in.good() && ReadArray(in, vertices, CACHED_VERTEX_SIZE, fileSize) && ReadArray(in, faces, CACHED_FACE_SIZE, fileSize) && ReadUInt(in, meshletCount);
+    }
+
+    valid = valid && meshletCount <= RemainingBytes(in, fileSize) / CACHED_MESHLET_SIZE;
+    if ( valid ) meshlets.resize(meshletCount);
+    for ( unsigned int i = 0; i < meshletCount && valid; i++ ) {
+        Meshlet& meshlet = meshlets[i];
+        valid = ReadUInt(in, meshlet.faceOffset) && ReadUInt(in, meshlet.faceCount) && ReadUInt(in, meshlet.vertexCount) &&
+                ReadVector(in, meshlet.center) && ReadFloat(in, meshlet.radius) && ReadVector(in, meshlet.coneAxis) && ReadFloat(in, meshlet.coneCutoff);
+    }
+
+    valid = valid && ReadUInt(in, lodCount) && lodCount <= RemainingBytes(in, fileSize) / CACHED_LOD_MIN_SIZE;
+    if ( valid ) lods.resize(lodCount);
+    for ( unsigned int i = 0; i < lodCount && valid; i++ ) {
+        MeshLod& level = lods[i];
+        valid = ReadArray(in, level.faces, CACHED_FACE_SIZE, fileSize) && ReadFloat(in, level.error.geometric) && ReadFloat(in, level.error.normal) && ReadFloat(in, level.error.textureCoord);
+    }
+
+    valid = valid && ReadCacheStatistics(in, report.before) && ReadCacheStatistics(in, report.after) && ReadUInt(in, clusterCount);
+    if ( !valid ) {
+        std::cerr << "[Mesh:loadCache] Error: Mesh cache is truncated: " << filename << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // The index buffer and the meshlet draws are built from these without
+    // further checks, so every face of every level has to index the vertices
+    // and every meshlet has to lie within the faces.
+    //--------------------------------------------------------------------------
+    valid = FacesInRange(faces, vertices.size());
+    for ( std::size_t i = 0; i < lods.size() && valid; i++ )
+        valid = FacesInRange(lods[i].faces, vertices.size());
+    for ( std::size_t i = 0; i < meshlets.size() && valid; i++ )
+        valid = static_cast<std::size_t>(meshlets[i].faceOffset) + meshlets[i].faceCount <= faces.size();
+
+    if ( !valid ) {
+        std::cerr << "[Mesh:loadCache] Error: Mesh cache has indices out of range: " << filename << std::endl;
+        return false;
+    }
+
+    report.clusterCount = clusterCount;
+    this->name = name;
+    this->vertices.swap(vertices);
+    this->faces.swap(faces);
+    this->meshlets.swap(meshlets);
+    this->lods.swap(lods);
+    this->optimizationReport = report;
+    this->lod = 0;
+
+    this->computeBounds();
+    this->constructOnGPU();
+    return true;
+}
+
+bool Mesh::saveCache(const std::string& filename) const {
+    std::vector<char> buffer(OBJ_WRITER_BUFFER_SIZE);
+    std::ofstream out;
+    out.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+    out.open(filename.c_str(), std::ios::out | std::ios::binary);
+
+    if ( !out.is_open() ) {
+        std::cerr << "[Mesh:saveCache] Error: Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    out.write(MESH_CACHE_MAGIC, sizeof(MESH_CACHE_MAGIC));
+    WriteUInt(out, MESH_CACHE_VERSION);
+    WriteUInt(out, static_cast<unsigned int>(this->name.length()));
+    out.write(this->name.data(), this->name.length());
+    WriteArray(out, this->vertices, CACHED_VERTEX_SIZE);
+    WriteArray(out, this->faces, CACHED_FACE_SIZE);
+
+    WriteUInt(out, static_cast<unsigned int>(this->meshlets.size()));
+    for ( std::size_t i = 0; i < this->meshlets.size(); i++ ) {
+        const Meshlet& meshlet = this->meshlets[i];
+        WriteUInt(out, meshlet.faceOffset);
+        WriteUInt(out, meshlet.faceCount);
+        WriteUInt(out, meshlet.vertexCount);
+        WriteVector(out, meshlet.center);
+        WriteFloat(out, meshlet.radius);
+        WriteVector(out, meshlet.coneAxis);
+        WriteFloat(out, meshlet.coneCutoff);
+    }
+
+    WriteUInt(out, static_cast<unsigned int>(this->lods.size()));
+    for ( std::size_t i = 0; i < this->lods.size(); i++ ) {
+        WriteArray(out, this->lods[i].faces, CACHED_FACE_SIZE);
+        WriteFloat(out, this->lods[i].error.geometric);
+        WriteFloat(out, this->lods[i].error.normal);
+        WriteFloat(out, this->lods[i].error.textureCoord);
+    }
+
+    WriteCacheStatistics(out, this->optimizationReport.before);
+    WriteCacheStatistics(out, this->optimizationReport.after);
+    WriteUInt(out, static_cast<unsigned int>(this->optimizationReport.clusterCount));
+
+    out.close();
+    if ( out.fail() ) {
+        std::cerr << "[Mesh:saveCache] Error: Could not write file: " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
 bool Mesh::constructOnGPU() {
+    //--------------------------------------------------------------------------
+    // The index data is built first: the faces of all levels of detail follow
+    // each other in one element buffer. Meshes too large for 16-bit indices
+    // are split into ranges whose vertices are laid out one range after the
+    // other (see IndexBuffer), in which case vertexRemap lists the mesh
+    // vertex of every GPU vertex.
+    //--------------------------------------------------------------------------
+    std::vector<TriangleFace> lodFaces(this->faces);
+    this->lodIndexOffsets.assign(1, 0);
+    this->lodIndexOffsets.push_back(this->faces.size() * TRIANGLE_EDGE_COUNT);
+    for ( std::size_t i = 0; i < this->lods.size(); i++ ) {
+        lodFaces.insert(lodFaces.end(), this->lods[i].faces.begin(), this->lods[i].faces.end());
+        this->lodIndexOffsets.push_back(lodFaces.size() * TRIANGLE_EDGE_COUNT);
+    }
+
+    std::vector<unsigned char> indices;
+    std::vector<unsigned int> vertexRemap;
+    if ( !this->indexBuffer.build(lodFaces, this->vertices.size(), this->format.getStride(), indices, vertexRemap) ) return false;
+
     //--------------------------------------------------------------------------
     // Vertex Buffer Object (VBO): Responsible for storing the vertex data of
     // this mesh. This segment first creates a new buffer on the GPU and then
@@ -472,22 +1188,57 @@ bool Mesh::constructOnGPU() {
     // is used because this class represents a simple model that does not 
     // change over time. The following vertex attribute pointers define
     // how and where to define each unique vertex attribute based on this
-    // original set of data (position, normal, tangent, texCoord).
+    // original set of data (position, normal, tangent, texCoord). The vertices
+    // are first packed into the layout of the selected vertex format.
     //--------------------------------------------------------------------------
-    glGenBuffers(1, &this->vboVertex);
-    glBindBuffer(GL_ARRAY_BUFFER, this->vboVertex);
-    glBufferData(GL_ARRAY_BUFFER, this->vertices.size() * sizeof(Vertex), &this->vertices[0], GL_STATIC_DRAW);
+    std::vector<unsigned char> buffer;
+    if ( vertexRemap.size() == 0 ) {
+        if ( !this->format.pack(this->vertices, buffer) ) return false;
+    }
+    else {
+        std::vector<Vertex> rangeVertices(vertexRemap.size());
+        for ( std::size_t i = 0; i < vertexRemap.size(); i++ ) rangeVertices[i] = this->vertices[vertexRemap[i]];
+        if ( !this->format.pack(rangeVertices, buffer) ) return false;
+    }
+
+    if ( this->vboVertex == 0 ) glGenBuffers(1, &this->vboVertex);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboVertex);
+    glBufferData(GL_ARRAY_BUFFER, buffer.size(), &buffer[0], GL_STATIC_DRAW);
+
+    //--------------------------------------------------------------------------
+    // Vertex Array Object (VAO): records the attribute pointers and the
+    // element buffer once, so beginRender binds the whole layout with a
+    // single call. The attribute pointers follow the layout of the vertex
+    // format (see VertexFormat). With FULL_PRECISION this is the Vertex
+    // structure itself: position, normal, tangent, texture coordinate and
+    // color at float offsets 0, 3, 6, 10 and 13. Attributes dropped by the
+    // format are disabled so the shader reads their constant default value
+    // instead.
+    //--------------------------------------------------------------------------
+    if ( this->vao == 0 ) glGenVertexArrays(1, &this->vao);
+    GLState::BindVertexArray(this->vao);
+
+    for ( unsigned int i = 0; i < VertexFormat::ATTRIBUTE_COUNT; i++ ) {
+        const VertexFormat::AttributeLayout& attribute = this->format.getAttribute(static_cast<VertexFormat::Attribute>(i));
+        if ( !attribute.enabled ) {
+            glDisableVertexAttribArray(ATTRIBUTE_LOCS[i]);
+            GLState::Count(GLState::VERTEX_ATTRIBUTE);
+            continue;
+        }
+
+        glEnableVertexAttribArray(ATTRIBUTE_LOCS[i]);
+        glVertexAttribPointer(ATTRIBUTE_LOCS[i], attribute.componentCount, ToGLType(attribute.type), attribute.normalized ? GL_TRUE : GL_FALSE, this->format.getStride(), BUFFER_OFFSET(attribute.offset));
+        GLState::Count(GLState::VERTEX_ATTRIBUTE, 2);
+    }
 
     //--------------------------------------------------------------------------
     // This segment creates a new element buffer (for indexed geometry) for
-    // defining the adjacencies or faces of the loaded set of vertices. This
-    // section uses a trick that requires a face to be defined as a simple
-    // structure containing the three indices of a face. These structures must
-    // be contiguous in memory to work correctly.
-    //--------------------------------------------------------------------------
-    glGenBuffers(1, &this->vboIndex);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboIndex);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->faces.size() * TRIANGLE_EDGE_COUNT * sizeof(unsigned int), &this->faces[0].indices[0], GL_STATIC_DRAW);
-    
+    // defining the adjacencies or faces of the loaded set of vertices. The
+    // indices are narrowed to 16 bits (see IndexBuffer).
+    //--------------------------------------------------------------------------
+    if ( this->vboIndex == 0 ) glGenBuffers(1, &this->vboIndex);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboIndex);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size(), &indices[0], GL_STATIC_DRAW);
+
     return true;
 }
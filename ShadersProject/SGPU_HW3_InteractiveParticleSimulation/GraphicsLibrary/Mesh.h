@@ -32,6 +32,15 @@
 #include "Color3.h"
 #include "Vertex.h"
 #include "Face.h"
+#include "VertexFormat.h"
+#include "MeshOptimizer.h"
+#include "IndexBuffer.h"
+#include "MeshSimplifier.h"
+#include "Meshlet.h"
+
+/* Vertex attribute helpers of the Obj import (see Mesh::load and Model). */
+bool CalculateNormals(const std::vector<unsigned int>& indices, const std::vector<Vector3f>& vertices, std::vector<Vector3f>& normals);
+bool CalculateTangents(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces);
 
 class Mesh {
 public:
@@ -39,6 +48,21 @@ public:
     Mesh(const Mesh& mesh);
     virtual ~Mesh();
 
+    /*
+     * load reads a *.obj file and welds, optimizes and partitions it, or reads
+     * a *.mesh cache that save wrote of an already processed mesh. save writes
+     * the welded triangles as a *.obj file (one v, vt and vn line per vertex,
+     * see SaveObjTriangles) or, for a *.mesh filename, the cache.
+     *
+     * Mesh cache format (binary, 32-bit little endian values written field
+     * by field, so it does not depend on the machine or the compiler):
+     *   "MESH", version, name length and characters, vertex count and per
+     *   vertex its position, normal, tangent, texture coordinate and color,
+     *   face count and the three indices of every face, meshlet count and
+     *   the meshlets, level of detail count and per level its face count,
+     *   faces and error, then the optimization report. load rejects a cache
+     *   whose counts exceed the file or whose indices are out of range.
+     */
     bool load(const std::string& filename);
     bool loadShader(const std::string& vertexFilename, const std::string& fragmentFilename);
     bool save(const std::string& filename);
@@ -46,6 +70,82 @@ public:
     void beginRender() const;
     void endRender() const;
 
+    /*
+     * The geometry half of beginRender and endRender: bind binds the vertex
+     * array and sets the position uniforms on the shader of this mesh, draw
+     * draws the current level of detail. Neither touches the program, so
+     * meshes that share a shader can be drawn with one enable (see
+     * RenderQueue).
+     */
+    void bind() const;
+    void draw() const;
+
+    /*
+     * Instancing: setInstances compiles the transformations in batches (see
+     * CompileTransformations) and uploads one model matrix and one color per
+     * instance; without colors every instance is white. endRenderInstanced
+     * then replaces endRender and draws all instances of the current level of
+     * detail with one instanced draw per index range. The shader reads the
+     * attributes instanceMatrix and instanceColor and takes the view matrix
+     * instead of a model-view matrix (see PhongShadingInstanced.vert).
+     */
+    bool setInstances(const std::vector<Transformationf>& transforms, const std::vector<Color3f>& colors = std::vector<Color3f>());
+    void clearInstances();
+    void endRenderInstanced() const;
+    std::size_t getInstanceCount() const;
+
+    /*
+     * Selects the vertex buffer layout (VertexFormat::Option flags). The
+     * buffer of an already loaded mesh is rebuilt.
+     */
+    bool setVertexFormat(unsigned int options);
+
+    /*
+     * Levels of detail: level 0 is the full mesh and levels 1 and up are the
+     * chain built by generateLods (load builds the default chain). All levels
+     * share the vertex buffer; endRender draws the current level.
+     */
+    bool generateLods(unsigned int maxLevels = LOD_MAX_LEVELS, float reduction = LOD_REDUCTION);
+    void setLod(std::size_t level);
+    std::size_t getLod() const;
+    std::size_t getLodCount() const;
+    const std::vector<MeshLod>& getLods() const;
+
+    /*
+     * Coarsest level whose geometric error, projected at the distance of the
+     * mesh from eye, stays below pixelError pixels. The projection uses the
+     * vertical field of view (degrees) and the viewport height in pixels.
+     */
+    std::size_t selectLod(const Vector3f& eye, float fov, float viewportHeight, float pixelError = LOD_PIXEL_ERROR) const;
+
+    /*
+     * Meshlet culling: load partitions the faces into meshlets (see
+     * BuildMeshlets). While enabled, cullMeshlets has to be called every
+     * frame before endRender, with the model-view matrix the mesh is drawn
+     * with (transformation first, then view) and the projection matrix;
+     * endRender then draws the meshlets that passed with one multi-draw per
+     * index range. Only the full level of detail is culled, coarser levels
+     * are drawn whole.
+     */
+    void setMeshletCulling(bool enabled);
+    bool getMeshletCulling() const;
+    void cullMeshlets(const Matrix4f& modelView, const Matrix4f& projection);
+    const std::vector<Meshlet>& getMeshlets() const;
+    const MeshletCullingStatistics& getMeshletCullingStatistics() const;
+
+    /*
+     * Object space bounds of the vertices, computed by load: the axis aligned
+     * box and the sphere around its centre that encloses every vertex. The
+     * world sphere applies a transformation (the mesh's own by default); its
+     * radius is scaled by the largest scale factor.
+     */
+    const Vector3f& getBoundingBoxMin() const;
+    const Vector3f& getBoundingBoxMax() const;
+    const Vector3f& getBoundingSphereCenter() const;
+    float getBoundingSphereRadius() const;
+    void getWorldBoundingSphere(Vector3f& center, float& radius) const;
+    void getWorldBoundingSphere(const Transformationf& transform, Vector3f& center, float& radius) const;
+
     void setName(const std::string& name);
     void setShader(const std::shared_ptr<Shader>& shader);
     bool setDiffuseTexture(const std::string& filename);
@@ -65,9 +165,17 @@ public:
     const Transformationf& getTransform() const;
     std::shared_ptr<Shader>& getShader();
     const std::shared_ptr<Shader>& getShader() const;
+    const std::vector<Vertex>& getVertices() const;
+    const std::vector<TriangleFace>& getFaces() const;
+    const VertexFormat& getVertexFormat() const;
+    const MeshOptimizationReport& getOptimizationReport() const;
+    const IndexBuffer& getIndexBuffer() const;
 
 protected:
     bool constructOnGPU();
+    void computeBounds();
+    bool loadCache(const std::string& filename);
+    bool saveCache(const std::string& filename) const;
 
 protected:
     /* 
@@ -81,9 +189,45 @@ protected:
     std::vector<TriangleFace> faces;
     std::shared_ptr<Shader> shader;
 
+    /* GPU vertex layout, the vertices above are always kept at full precision */
+    VertexFormat format;
+
+    /* Vertex cache statistics of the faces before and after load optimized them */
+    MeshOptimizationReport optimizationReport;
+
+    /* Index type and draw ranges of the uploaded element buffer */
+    IndexBuffer indexBuffer;
+
+    /* Coarser levels of detail and the level endRender draws */
+    std::vector<MeshLod> lods;
+    std::size_t lod;
+
+    /* First index of every level in the element buffer, plus its end */
+    std::vector<std::size_t> lodIndexOffsets;
+
+    /* Meshlets of the full level of detail and the draws that passed culling */
+    std::vector<Meshlet> meshlets;
+    std::vector<MeshletDraw> meshletDraws;
+    MeshletCullingStatistics cullingStatistics;
+    bool meshletCulling;
+
+    /* Object space bounding box and bounding sphere */
+    Vector3f boundingBoxMin;
+    Vector3f boundingBoxMax;
+    Vector3f boundingCenter;
+    float boundingRadius;
+
+    /* Per-instance model matrices followed by the instance colors */
+    std::vector<float> instanceData;
+    std::size_t instanceCount;
+
     /* Mesh VBO ID */
     unsigned int vboVertex;
     unsigned int vboIndex;
+    unsigned int vboInstance;
+
+    /* Vertex array holding the attribute layout and the element buffer */
+    unsigned int vao;
 };
 
 #endif
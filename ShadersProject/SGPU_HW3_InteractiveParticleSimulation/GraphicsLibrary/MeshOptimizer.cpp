@@ -0,0 +1,371 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+
+/*
+ * Forsyth scoring parameters (see "Linear-Speed Vertex Cache Optimisation").
+ * The three vertices of the last emitted triangle get a fixed score so that
+ * the algorithm does not simply repeat them.
+ */
+const static unsigned int FORSYTH_CACHE_SIZE = 32;
+const static float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+const static float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+const static float FORSYTH_VALENCE_BOOST_SCALE = 2.0f;
+const static float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+const static int NOT_IN_CACHE = -1;
+const static unsigned int UNUSED_VERTEX = 0xFFFFFFFF;
+
+VertexCacheStatistics SimulateVertexCache(const std::vector<TriangleFace>& faces, std::size_t vertexCount, unsigned int cacheSize) {
+    VertexCacheStatistics statistics;
+    statistics.transformedVertices = 0;
+    statistics.acmr = 0.0f;
+    statistics.atvr = 0.0f;
+    if ( faces.size() == 0 || vertexCount == 0 || cacheSize == 0 ) return statistics;
+
+    //--------------------------------------------------------------------------
+    // A FIFO cache is simulated with a timestamp per vertex: a vertex is in
+    // the cache if fewer than cacheSize vertices were transformed after it.
+    //--------------------------------------------------------------------------
+    std::vector<std::size_t> timestamps(vertexCount, 0);
+    std::vector<bool> referenced(vertexCount, false);
+    std::size_t time = cacheSize + 1;
+    std::size_t referencedCount = 0;
+
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int index = faces[i].indices[j];
+            if ( !referenced[index] ) {
+                referenced[index] = true;
+                referencedCount++;
+            }
+
+            if ( time - timestamps[index] > cacheSize ) {
+                timestamps[index] = time++;
+                statistics.transformedVertices++;
+            }
+        }
+    }
+
+    statistics.acmr = static_cast<float>(statistics.transformedVertices) / static_cast<float>(faces.size());
+    statistics.atvr = static_cast<float>(statistics.transformedVertices) / static_cast<float>(referencedCount);
+    return statistics;
+}
+
+static float ForsythVertexScore(int cachePosition, unsigned int remainingTriangles) {
+    if ( remainingTriangles == 0 ) return -1.0f;
+
+    float score = 0.0f;
+    if ( cachePosition != NOT_IN_CACHE ) {
+        if ( cachePosition < 3 ) score = FORSYTH_LAST_TRIANGLE_SCORE;
+        else {
+            float scale = 1.0f / static_cast<float>(FORSYTH_CACHE_SIZE - 3);
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scale, FORSYTH_CACHE_DECAY_POWER);
+        }
+    }
+
+    return score + FORSYTH_VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -FORSYTH_VALENCE_BOOST_POWER);
+}
+
+bool OptimizeVertexCache(std::vector<TriangleFace>& faces, std::size_t vertexCount) {
+    if ( faces.size() == 0 ) return true;
+
+    //--------------------------------------------------------------------------
+    // Vertex to triangle adjacency in compressed rows: the triangles of vertex
+    // v are triangles[offsets[v]] .. triangles[offsets[v] + remaining[v]].
+    // Emitted triangles are swapped out of the active part of the row.
+    //--------------------------------------------------------------------------
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for ( std::size_t i = 0; i < faces.size(); i++ )
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) remaining[faces[i].indices[j]]++;
+
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for ( std::size_t v = 0; v < vertexCount; v++ ) offsets[v + 1] = offsets[v] + remaining[v];
+
+    std::vector<unsigned int> triangles(offsets[vertexCount]);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for ( std::size_t i = 0; i < faces.size(); i++ )
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) triangles[fill[faces[i].indices[j]]++] = static_cast<unsigned int>(i);
+
+    std::vector<float> vertexScores(vertexCount);
+    for ( std::size_t v = 0; v < vertexCount; v++ ) vertexScores[v] = ForsythVertexScore(NOT_IN_CACHE, remaining[v]);
+
+    std::vector<float> triangleScores(faces.size());
+    std::vector<bool> emitted(faces.size(), false);
+    for ( std::size_t i = 0; i < faces.size(); i++ )
+        triangleScores[i] = vertexScores[faces[i].indices[A]] + vertexScores[faces[i].indices[B]] + vertexScores[faces[i].indices[C]];
+
+    std::vector<TriangleFace> result;
+    result.reserve(faces.size());
+
+    //--------------------------------------------------------------------------
+    // The cache holds FORSYTH_CACHE_SIZE vertices plus room for the three
+    // vertices of the triangle being added.
+    //--------------------------------------------------------------------------
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> nextCache;
+    cache.reserve(FORSYTH_CACHE_SIZE + 3);
+    nextCache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+    std::size_t cursor = 0;
+    std::size_t best = 0;
+    float bestScore = triangleScores[0];
+    for ( std::size_t i = 1; i < faces.size(); i++ ) {
+        if ( triangleScores[i] > bestScore ) {
+            bestScore = triangleScores[i];
+            best = i;
+        }
+    }
+
+    while ( result.size() < faces.size() ) {
+        //----------------------------------------------------------------------
+        // Dead end: no triangle touches the cache, continue with the next
+        // triangle in input order that was not emitted yet.
+        //----------------------------------------------------------------------
+        if ( bestScore < 0.0f ) {
+            while ( emitted[cursor] ) cursor++;
+            best = cursor;
+        }
+
+        const TriangleFace& face = faces[best];
+        result.push_back(face);
+        emitted[best] = true;
+
+        //----------------------------------------------------------------------
+        // Remove the triangle from the adjacency of its vertices and push the
+        // vertices to the front of the LRU cache.
+        //----------------------------------------------------------------------
+        nextCache.clear();
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int v = face.indices[j];
+            unsigned int* row = &triangles[offsets[v]];
+            unsigned int* last = row + remaining[v] - 1;
+            for ( unsigned int* t = row; t <= last; t++ ) {
+                if ( *t == best ) {
+                    std::swap(*t, *last);
+                    break;
+                }
+            }
+
+            remaining[v]--;
+            nextCache.push_back(v);
+        }
+
+        for ( std::size_t k = 0; k < cache.size(); k++ ) {
+            unsigned int v = cache[k];
+            if ( v != face.indices[A] && v != face.indices[B] && v != face.indices[C] ) nextCache.push_back(v);
+        }
+
+        //----------------------------------------------------------------------
+        // Rescore the vertices in the cache (and those that just fell out of
+        // it) together with their remaining triangles, and pick the best
+        // triangle among them for the next step.
+        //----------------------------------------------------------------------
+        bestScore = -1.0f;
+        for ( std::size_t k = 0; k < nextCache.size(); k++ ) {
+            unsigned int v = nextCache[k];
+            int position = (k < FORSYTH_CACHE_SIZE) ? static_cast<int>(k) : NOT_IN_CACHE;
+
+            float score = ForsythVertexScore(position, remaining[v]);
+            float delta = score - vertexScores[v];
+            vertexScores[v] = score;
+
+            for ( unsigned int r = 0; r < remaining[v]; r++ ) {
+                unsigned int t = triangles[offsets[v] + r];
+                triangleScores[t] += delta;
+                if ( triangleScores[t] > bestScore ) {
+                    bestScore = triangleScores[t];
+                    best = t;
+                }
+            }
+        }
+
+        if ( nextCache.size() > FORSYTH_CACHE_SIZE ) nextCache.resize(FORSYTH_CACHE_SIZE);
+        cache.swap(nextCache);
+    }
+
+    faces.swap(result);
+    return true;
+}
+
+static Vector3f FaceNormalArea(const std::vector<Vertex>& vertices, const TriangleFace& face) {
+    const Vector3f& p0 = vertices[face.indices[A]].position;
+    const Vector3f& p1 = vertices[face.indices[B]].position;
+    const Vector3f& p2 = vertices[face.indices[C]].position;
+    return Vector3f::Cross(p1 - p0, p2 - p0);
+}
+
+std::size_t OptimizeOverdraw(std::vector<TriangleFace>& faces, const std::vector<Vertex>& vertices, float threshold) {
+    if ( faces.size() == 0 ) return 0;
+
+    //--------------------------------------------------------------------------
+    // Hard boundaries: triangles where the simulated cache misses all three
+    // vertices start a new strip of locality and can be moved freely.
+    //--------------------------------------------------------------------------
+    std::vector<unsigned int> misses(faces.size(), 0);
+    std::vector<std::size_t> timestamps(vertices.size(), 0);
+    std::size_t time = VERTEX_CACHE_SIZE + 1;
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int index = faces[i].indices[j];
+            if ( time - timestamps[index] > VERTEX_CACHE_SIZE ) {
+                timestamps[index] = time++;
+                misses[i]++;
+            }
+        }
+    }
+
+    std::vector<std::size_t> hardBoundaries;
+    for ( std::size_t i = 0; i < faces.size(); i++ )
+        if ( i == 0 || misses[i] == TRIANGLE_EDGE_COUNT ) hardBoundaries.push_back(i);
+    hardBoundaries.push_back(faces.size());
+
+    //--------------------------------------------------------------------------
+    // Soft boundaries: a hard cluster is split again as soon as the ACMR of the
+    // part since the last split, simulated from a cold cache because the part
+    // may be moved anywhere, is within threshold of the ACMR of the cluster.
+    //--------------------------------------------------------------------------
+    std::vector<std::size_t> clusters;
+    for ( std::size_t c = 0; c + 1 < hardBoundaries.size(); c++ ) {
+        std::size_t begin = hardBoundaries[c];
+        std::size_t end = hardBoundaries[c + 1];
+
+        std::size_t clusterMisses = 0;
+        for ( std::size_t i = begin; i < end; i++ ) clusterMisses += misses[i];
+        float clusterAcmr = static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        clusters.push_back(begin);
+        std::size_t runningMisses = 0;
+        std::size_t start = begin;
+        time += VERTEX_CACHE_SIZE + 1;
+
+        for ( std::size_t i = begin; i < end; i++ ) {
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+                unsigned int index = faces[i].indices[j];
+                if ( time - timestamps[index] > VERTEX_CACHE_SIZE ) {
+                    timestamps[index] = time++;
+                    runningMisses++;
+                }
+            }
+
+            float runningAcmr = static_cast<float>(runningMisses) / static_cast<float>(i - start + 1);
+            if ( i + 1 < end && runningAcmr <= clusterAcmr * threshold ) {
+                clusters.push_back(i + 1);
+                start = i + 1;
+                runningMisses = 0;
+                time += VERTEX_CACHE_SIZE + 1;
+            }
+        }
+    }
+    clusters.push_back(faces.size());
+    std::size_t clusterCount = clusters.size() - 1;
+
+    //--------------------------------------------------------------------------
+    // Sort key of a cluster: how far its area weighted centroid lies in front
+    // of the mesh centroid along the cluster normal. Clusters on the outside
+    // of the mesh are drawn first and occlude the rest.
+    //--------------------------------------------------------------------------
+    Vector3f meshCentroid;
+    float meshArea = 0.0f;
+    std::vector<Vector3f> centroids(clusterCount);
+    std::vector<Vector3f> normals(clusterCount);
+
+    for ( std::size_t c = 0; c < clusterCount; c++ ) {
+        Vector3f centroid;
+        Vector3f normal;
+        float area = 0.0f;
+
+        for ( std::size_t i = clusters[c]; i < clusters[c + 1]; i++ ) {
+            const TriangleFace& face = faces[i];
+            Vector3f normalArea = FaceNormalArea(vertices, face);
+            float triangleArea = static_cast<float>(normalArea.length());
+            Vector3f center = (vertices[face.indices[A]].position + vertices[face.indices[B]].position + vertices[face.indices[C]].position) / 3.0f;
+
+            centroid += center * triangleArea;
+            normal += normalArea;
+            area += triangleArea;
+        }
+
+        meshCentroid += centroid;
+        meshArea += area;
+        centroids[c] = (area > 0.0f) ? centroid / area : vertices[faces[clusters[c]].indices[A]].position;
+        normals[c] = normal;
+    }
+
+    if ( meshArea > 0.0f ) meshCentroid = meshCentroid / meshArea;
+
+    std::vector<std::pair<float, std::size_t> > order(clusterCount);
+    for ( std::size_t c = 0; c < clusterCount; c++ ) {
+        float length = static_cast<float>(normals[c].length());
+        float key = (length > 0.0f) ? static_cast<float>(Vector3f::Dot(centroids[c] - meshCentroid, normals[c])) / length : 0.0f;
+        order[c] = std::make_pair(-key, c);
+    }
+
+    std::stable_sort(order.begin(), order.end());
+
+    std::vector<TriangleFace> result;
+    result.reserve(faces.size());
+    for ( std::size_t k = 0; k < clusterCount; k++ ) {
+        std::size_t c = order[k].second;
+        result.insert(result.end(), faces.begin() + clusters[c], faces.begin() + clusters[c + 1]);
+    }
+
+    faces.swap(result);
+    return clusterCount;
+}
+
+bool OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
+    std::vector<unsigned int> remap(vertices.size(), UNUSED_VERTEX);
+    std::vector<Vertex> result;
+    result.reserve(vertices.size());
+
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int& index = faces[i].indices[j];
+            if ( remap[index] == UNUSED_VERTEX ) {
+                remap[index] = static_cast<unsigned int>(result.size());
+                result.push_back(vertices[index]);
+            }
+
+            index = remap[index];
+        }
+    }
+
+    vertices.swap(result);
+    return true;
+}
+
+bool OptimizeMesh(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, MeshOptimizationReport* report) {
+    if ( vertices.size() == 0 || faces.size() == 0 ) {
+        std::cerr << "[MeshOptimizer:OptimizeMesh] Error: Empty mesh." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Some exporters already write faces in a cache friendly (strip or patch)
+    // order, which is kept if the greedy reordering does not beat it.
+    //--------------------------------------------------------------------------
+    VertexCacheStatistics before = SimulateVertexCache(faces, vertices.size());
+    std::vector<TriangleFace> reordered = faces;
+    OptimizeVertexCache(reordered, vertices.size());
+    if ( SimulateVertexCache(reordered, vertices.size()).acmr < before.acmr ) faces.swap(reordered);
+
+    //--------------------------------------------------------------------------
+    // Moving clusters starts each of them from a cold cache, which can cost
+    // more than the threshold on meshes made of many short strips.
+    //--------------------------------------------------------------------------
+    float cacheAcmr = SimulateVertexCache(faces, vertices.size()).acmr;
+    std::vector<TriangleFace> sorted = faces;
+    std::size_t clusterCount = OptimizeOverdraw(sorted, vertices);
+    if ( SimulateVertexCache(sorted, vertices.size()).acmr <= cacheAcmr * OVERDRAW_THRESHOLD ) faces.swap(sorted);
+    else clusterCount = 0;
+    OptimizeVertexFetch(vertices, faces);
+
+    if ( report != nullptr ) {
+        report->before = before;
+        report->after = SimulateVertexCache(faces, vertices.size());
+        report->clusterCount = clusterCount;
+    }
+
+    return true;
+}
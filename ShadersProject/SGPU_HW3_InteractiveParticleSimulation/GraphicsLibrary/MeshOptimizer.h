@@ -0,0 +1,74 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <vector>
+#include "Vertex.h"
+#include "Face.h"
+
+/* Default size of the simulated FIFO post-transform vertex cache. */
+const static unsigned int VERTEX_CACHE_SIZE = 16;
+
+/* ACMR the overdraw reordering may give up, relative to the cache order. */
+const static float OVERDRAW_THRESHOLD = 1.05f;
+
+/*
+ * Post-transform vertex cache efficiency of an index buffer. ACMR (average
+ * cache miss ratio) is the number of transformed vertices per triangle, 0.5
+ * is the ideal for a closed regular mesh and 3 the worst case. ATVR (average
+ * transformed vertex ratio) is the number of transformed vertices per
+ * referenced vertex, 1 is ideal.
+ */
+struct VertexCacheStatistics {
+    std::size_t transformedVertices;
+    float acmr;
+    float atvr;
+};
+
+/*
+ * Index buffer statistics before and after OptimizeMesh. The cluster count
+ * is 0 if the overdraw order was not applied.
+ */
+struct MeshOptimizationReport {
+    VertexCacheStatistics before;
+    VertexCacheStatistics after;
+    std::size_t clusterCount;
+};
+
+/* Runs the index buffer through a FIFO cache of cacheSize vertices. */
+VertexCacheStatistics SimulateVertexCache(const std::vector<TriangleFace>& faces, std::size_t vertexCount, unsigned int cacheSize = VERTEX_CACHE_SIZE);
+
+/*
+ * Reorders the triangles for the post-transform vertex cache with Tom
+ * Forsyth's linear-speed algorithm: triangles are emitted greedily by the
+ * score of their vertices, which favours vertices near the front of a
+ * simulated LRU cache and vertices with few remaining triangles.
+ */
+bool OptimizeVertexCache(std::vector<TriangleFace>& faces, std::size_t vertexCount);
+
+/*
+ * Reorders clusters of a cache optimized index buffer to reduce overdraw
+ * (Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw"). The buffer is split where the cache restarts and wherever the
+ * running ACMR of a cluster drops below threshold times the ACMR of the
+ * whole buffer, so the cache efficiency lost is bounded by threshold. The
+ * clusters are then sorted to draw the ones facing away from the mesh centre
+ * first. Returns the number of clusters.
+ */
+std::size_t OptimizeOverdraw(std::vector<TriangleFace>& faces, const std::vector<Vertex>& vertices, float threshold = OVERDRAW_THRESHOLD);
+
+/*
+ * Reorders the vertices into the order the index buffer first uses them so
+ * vertex fetch streams through memory, and remaps the faces. Vertices that
+ * no face uses are removed.
+ */
+bool OptimizeVertexFetch(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces);
+
+/*
+ * Runs the three stages above in order. The input face order is kept when
+ * the vertex cache reordering does not improve on it, and the overdraw
+ * order is dropped if it costs more than OVERDRAW_THRESHOLD in ACMR. The
+ * report is optional.
+ */
+bool OptimizeMesh(std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, MeshOptimizationReport* report = nullptr);
+
+#endif
@@ -0,0 +1,610 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+const static unsigned int NO_VERTEX = 0xFFFFFFFF;
+
+/*
+ * Topology of a vertex position. Manifold vertices can collapse onto any
+ * neighbour, border and seam vertices only along their border or seam and
+ * locked vertices not at all.
+ */
+enum VertexKind { MANIFOLD_VERTEX, BORDER_VERTEX, SEAM_VERTEX, LOCKED_VERTEX };
+
+/*
+ * Symmetric 4x4 quadric of the squared distance to a set of planes,
+ * error(p) = p^T A p + 2 b.p + c, with the total weight of the planes.
+ */
+struct Quadric {
+    double a00, a11, a22, a01, a02, a12;
+    double b0, b1, b2;
+    double c;
+    double weight;
+};
+
+struct EdgeCollapse {
+    unsigned int from;
+    unsigned int to;
+    double cost;
+    double geometric;
+};
+
+struct PositionHash {
+    std::size_t operator () (const Vector3f& p) const {
+        unsigned int bits[3];
+        float values[3] = { p.x() + 0.0f, p.y() + 0.0f, p.z() + 0.0f };
+        std::memcpy(bits, values, sizeof(bits));
+        return (bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u);
+    }
+};
+
+static void QuadricFromPlane(Quadric& q, const Vector3d& n, double d, double weight) {
+    q.a00 = weight * n.x() * n.x();
+    q.a11 = weight * n.y() * n.y();
+    q.a22 = weight * n.z() * n.z();
+    q.a01 = weight * n.x() * n.y();
+    q.a02 = weight * n.x() * n.z();
+    q.a12 = weight * n.y() * n.z();
+    q.b0 = weight * n.x() * d;
+    q.b1 = weight * n.y() * d;
+    q.b2 = weight * n.z() * d;
+    q.c = weight * d * d;
+    q.weight = weight;
+}
+
+static void QuadricAdd(Quadric& q, const Quadric& r) {
+    q.a00 += r.a00; q.a11 += r.a11; q.a22 += r.a22;
+    q.a01 += r.a01; q.a02 += r.a02; q.a12 += r.a12;
+    q.b0 += r.b0; q.b1 += r.b1; q.b2 += r.b2;
+    q.c += r.c;
+    q.weight += r.weight;
+}
+
+/* Weighted mean squared distance from p to the planes of the quadric. */
+static double QuadricError(const Quadric& q, const Vector3d& p) {
+    double x = p.x(), y = p.y(), z = p.z();
+    double rx = q.a00 * x + q.a01 * y + q.a02 * z + 2.0 * q.b0;
+    double ry = q.a01 * x + q.a11 * y + q.a12 * z + 2.0 * q.b1;
+    double rz = q.a02 * x + q.a12 * y + q.a22 * z + 2.0 * q.b2;
+    double error = rx * x + ry * y + rz * z + q.c;
+    return (q.weight > 0.0) ? std::fabs(error) / q.weight : 0.0;
+}
+
+/*
+ * Vertex adjacency in compressed rows: the neighbours of v (the second
+ * vertex of every face edge starting at v) are targets[offsets[v]] ..
+ * targets[offsets[v + 1]].
+ */
+static void BuildEdgeAdjacency(const std::vector<TriangleFace>& faces, std::size_t vertexCount, std::vector<unsigned int>& offsets, std::vector<unsigned int>& targets) {
+    offsets.assign(vertexCount + 1, 0);
+    for ( std::size_t i = 0; i < faces.size(); i++ )
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) offsets[faces[i].indices[j] + 1]++;
+    for ( std::size_t v = 0; v < vertexCount; v++ ) offsets[v + 1] += offsets[v];
+
+    targets.resize(offsets[vertexCount]);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int a = faces[i].indices[j];
+            unsigned int b = faces[i].indices[(j + 1) % TRIANGLE_EDGE_COUNT];
+            targets[fill[a]++] = b;
+        }
+    }
+}
+
+static bool HasEdge(const std::vector<unsigned int>& offsets, const std::vector<unsigned int>& targets, unsigned int a, unsigned int b) {
+    for ( unsigned int i = offsets[a]; i < offsets[a + 1]; i++ )
+        if ( targets[i] == b ) return true;
+    return false;
+}
+
+/* Edge between the positions of a and b, from any of their wedges. */
+static bool HasPositionEdge(const std::vector<unsigned int>& offsets, const std::vector<unsigned int>& targets, const std::vector<unsigned int>& remap, const std::vector<unsigned int>& wedge, unsigned int a, unsigned int b) {
+    unsigned int w = a;
+    do {
+        for ( unsigned int i = offsets[w]; i < offsets[w + 1]; i++ )
+            if ( remap[targets[i]] == remap[b] ) return true;
+        w = wedge[w];
+    } while ( w != a );
+    return false;
+}
+
+/*
+ * Records the single open edge leaving (out) and entering (in) each vertex.
+ * A vertex with several open edges in one direction points to itself.
+ */
+static void SetOpenEdge(std::vector<unsigned int>& open, unsigned int v, unsigned int target) {
+    open[v] = (open[v] == NO_VERTEX) ? target : v;
+}
+
+static bool IsOpenEdge(const std::vector<unsigned int>& open, unsigned int v) {
+    return open[v] != NO_VERTEX && open[v] != v;
+}
+
+/*
+ * Follows the collapses of a pass: an open edge that pointed to a collapsed
+ * vertex now points to where it collapsed, or past it if the edge itself was
+ * collapsed towards this vertex.
+ */
+static void RemapOpenEdges(std::vector<unsigned int>& open, const std::vector<unsigned int>& collapseRemap) {
+    for ( std::size_t i = 0; i < open.size(); i++ ) {
+        if ( open[i] == NO_VERTEX ) continue;
+        unsigned int target = open[i];
+        unsigned int remapped = collapseRemap[target];
+        open[i] = (remapped == i) ? open[target] : remapped;
+    }
+}
+
+static Vector3d FaceNormal(const Vector3d& a, const Vector3d& b, const Vector3d& c) {
+    return Vector3d::Cross(b - a, c - a);
+}
+
+/* Closest point on a triangle (Ericson, "Real-Time Collision Detection"). */
+static double PointTriangleDistanceSquared(const Vector3d& p, const Vector3d& a, const Vector3d& b, const Vector3d& c) {
+    Vector3d ab = b - a, ac = c - a, ap = p - a;
+    double d1 = Vector3d::Dot(ab, ap), d2 = Vector3d::Dot(ac, ap);
+    if ( d1 <= 0.0 && d2 <= 0.0 ) return ap.lengthSquared();
+
+    Vector3d bp = p - b;
+    double d3 = Vector3d::Dot(ab, bp), d4 = Vector3d::Dot(ac, bp);
+    if ( d3 >= 0.0 && d4 <= d3 ) return bp.lengthSquared();
+
+    double vc = d1 * d4 - d3 * d2;
+    if ( vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0 ) return (p - (a + ab * (d1 / (d1 - d3)))).lengthSquared();
+
+    Vector3d cp = p - c;
+    double d5 = Vector3d::Dot(ab, cp), d6 = Vector3d::Dot(ac, cp);
+    if ( d6 >= 0.0 && d5 <= d6 ) return cp.lengthSquared();
+
+    double vb = d5 * d2 - d1 * d6;
+    if ( vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0 ) return (p - (a + ac * (d2 / (d2 - d6)))).lengthSquared();
+
+    double va = d3 * d6 - d5 * d4;
+    if ( va <= 0.0 && (d4 - d3) >= 0.0 && (d5 - d6) >= 0.0 ) return (p - (b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))))).lengthSquared();
+
+    double denominator = 1.0 / (va + vb + vc);
+    return (p - (a + ab * (vb * denominator) + ac * (vc * denominator))).lengthSquared();
+}
+
+/*
+ * Links the vertices that share a position (the wedges of an attribute
+ * seam): remap is the first vertex of the position and wedge the next vertex
+ * in a cycle over all vertices of the position.
+ */
+static void BuildPositionRemap(const std::vector<Vertex>& vertices, std::vector<unsigned int>& remap, std::vector<unsigned int>& wedge) {
+    std::size_t vertexCount = vertices.size();
+    remap.resize(vertexCount);
+    wedge.resize(vertexCount);
+
+    std::unordered_map<Vector3f, unsigned int, PositionHash> firstVertex;
+    firstVertex.reserve(vertexCount);
+    for ( unsigned int i = 0; i < vertexCount; i++ ) {
+        std::pair<std::unordered_map<Vector3f, unsigned int, PositionHash>::iterator, bool> inserted = firstVertex.insert(std::make_pair(vertices[i].position, i));
+        unsigned int r = inserted.first->second;
+        remap[i] = r;
+        wedge[i] = i;
+        if ( r != i ) {
+            wedge[i] = wedge[r];
+            wedge[r] = i;
+        }
+    }
+}
+
+/*
+ * Measures how far the faces moved from the vertices they no longer use:
+ * every removed vertex is followed to the vertex it finally collapsed onto
+ * (collapseTargets) and its distance to the faces within two rings of that
+ * position is taken. Returns the largest distance in object space.
+ */
+static float MeasureCollapseError(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<unsigned int>& remap, const std::vector<unsigned int>& collapseTargets) {
+    std::size_t vertexCount = vertices.size();
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for ( std::size_t i = 0; i < faces.size(); i++ )
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) offsets[remap[faces[i].indices[j]] + 1]++;
+    for ( std::size_t v = 0; v < vertexCount; v++ ) offsets[v + 1] += offsets[v];
+
+    std::vector<unsigned int> triangles(offsets[vertexCount]);
+    std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+    for ( std::size_t i = 0; i < faces.size(); i++ )
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) triangles[fill[remap[faces[i].indices[j]]]++] = static_cast<unsigned int>(i);
+
+    std::vector<Vector3d> positions(vertexCount);
+    for ( std::size_t i = 0; i < vertexCount; i++ ) positions[i] = Vector3d(vertices[i].position.x(), vertices[i].position.y(), vertices[i].position.z());
+
+    double maxDistance = 0.0;
+    for ( unsigned int v = 0; v < vertexCount; v++ ) {
+        unsigned int target = collapseTargets[v];
+        if ( target == v || remap[v] != v ) continue;
+
+        //----------------------------------------------------------------------
+        // The second ring can only lower the distance, so it is only searched
+        // when the first ring leaves the vertex above the current maximum.
+        //----------------------------------------------------------------------
+        const Vector3d& p = positions[v];
+        double distance = (p - positions[target]).lengthSquared();
+        unsigned int rt = remap[target];
+        for ( unsigned int t = offsets[rt]; t < offsets[rt + 1]; t++ ) {
+            const TriangleFace& face = faces[triangles[t]];
+            distance = std::min(distance, PointTriangleDistanceSquared(p, positions[face.indices[A]], positions[face.indices[B]], positions[face.indices[C]]));
+        }
+
+        for ( unsigned int t = offsets[rt]; t < offsets[rt + 1] && distance > maxDistance; t++ ) {
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+                unsigned int ring = remap[faces[triangles[t]].indices[j]];
+                if ( ring == rt ) continue;
+
+                for ( unsigned int n = offsets[ring]; n < offsets[ring + 1]; n++ ) {
+                    const TriangleFace& face = faces[triangles[n]];
+                    distance = std::min(distance, PointTriangleDistanceSquared(p, positions[face.indices[A]], positions[face.indices[B]], positions[face.indices[C]]));
+                }
+            }
+        }
+
+        maxDistance = std::max(maxDistance, distance);
+    }
+
+    return static_cast<float>(std::sqrt(maxDistance));
+}
+
+/*
+ * Edge collapse simplification (see SimplifyMesh). collapseTargets receives
+ * for every vertex the vertex it finally collapsed onto (itself if it was
+ * not removed); the attribute errors are written to error.
+ */
+static bool Simplify(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, std::size_t targetFaceCount, float targetError, std::vector<TriangleFace>& result, std::vector<unsigned int>& collapseTargets, SimplificationError& error) {
+    std::memset(&error, 0, sizeof(SimplificationError));
+    result.clear();
+
+    if ( vertices.size() == 0 ) {
+        std::cerr << "[MeshSimplifier:SimplifyMesh] Error: Vertex array of length 0." << std::endl;
+        return false;
+    }
+
+    std::size_t vertexCount = vertices.size();
+
+    //--------------------------------------------------------------------------
+    // Positions are scaled to the unit cube so the cost terms and weights do
+    // not depend on the size of the mesh.
+    //--------------------------------------------------------------------------
+    Vector3f minimum = vertices[0].position;
+    Vector3f maximum = vertices[0].position;
+    for ( std::size_t i = 1; i < vertexCount; i++ ) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            minimum[k] = std::min(minimum[k], vertices[i].position[k]);
+            maximum[k] = std::max(maximum[k], vertices[i].position[k]);
+        }
+    }
+
+    double extent = std::max(std::max(maximum.x() - minimum.x(), maximum.y() - minimum.y()), maximum.z() - minimum.z());
+    if ( extent <= 0.0 ) extent = 1.0;
+
+    std::vector<Vector3d> positions(vertexCount);
+    for ( std::size_t i = 0; i < vertexCount; i++ ) {
+        const Vector3f& p = vertices[i].position;
+        positions[i] = Vector3d((p.x() - minimum.x()) / extent, (p.y() - minimum.y()) / extent, (p.z() - minimum.z()) / extent);
+    }
+
+    std::vector<unsigned int> remap, wedge;
+    BuildPositionRemap(vertices, remap, wedge);
+
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        unsigned int a = faces[i].indices[A], b = faces[i].indices[B], c = faces[i].indices[C];
+        if ( remap[a] != remap[b] && remap[b] != remap[c] && remap[a] != remap[c] ) result.push_back(faces[i]);
+    }
+
+    //--------------------------------------------------------------------------
+    // Classify the vertices. An edge is open by index when no face has the
+    // reverse edge between the same vertices (attribute seams and borders)
+    // and open by position when no face has it between the same positions
+    // (borders only).
+    //--------------------------------------------------------------------------
+    std::vector<unsigned int> offsets, targets;
+    BuildEdgeAdjacency(result, vertexCount, offsets, targets);
+
+    std::vector<unsigned int> openOut(vertexCount, NO_VERTEX), openIn(vertexCount, NO_VERTEX);
+    std::vector<unsigned int> borderOut(vertexCount, NO_VERTEX), borderIn(vertexCount, NO_VERTEX);
+    for ( unsigned int v = 0; v < vertexCount; v++ ) {
+        for ( unsigned int i = offsets[v]; i < offsets[v + 1]; i++ ) {
+            unsigned int target = targets[i];
+            if ( !HasEdge(offsets, targets, target, v) ) {
+                SetOpenEdge(openOut, v, target);
+                SetOpenEdge(openIn, target, v);
+            }
+
+            if ( !HasPositionEdge(offsets, targets, remap, wedge, target, v) ) {
+                SetOpenEdge(borderOut, v, target);
+                SetOpenEdge(borderIn, target, v);
+            }
+        }
+    }
+
+    std::vector<unsigned char> kinds(vertexCount, LOCKED_VERTEX);
+    for ( unsigned int v = 0; v < vertexCount; v++ ) {
+        if ( remap[v] != v ) continue;
+
+        VertexKind kind = LOCKED_VERTEX;
+        if ( wedge[v] == v ) {
+            if ( borderOut[v] == NO_VERTEX && borderIn[v] == NO_VERTEX ) kind = MANIFOLD_VERTEX;
+            else if ( IsOpenEdge(borderOut, v) && IsOpenEdge(borderIn, v) ) kind = BORDER_VERTEX;
+        }
+        else if ( wedge[wedge[v]] == v ) {
+            unsigned int w = wedge[v];
+            bool closed = borderOut[v] == NO_VERTEX && borderIn[v] == NO_VERTEX && borderOut[w] == NO_VERTEX && borderIn[w] == NO_VERTEX;
+            bool open = IsOpenEdge(openOut, v) && IsOpenEdge(openIn, v) && IsOpenEdge(openOut, w) && IsOpenEdge(openIn, w);
+            if ( closed && open && remap[openOut[v]] == remap[openIn[w]] && remap[openIn[v]] == remap[openOut[w]] ) kind = SEAM_VERTEX;
+        }
+
+        unsigned int w = v;
+        do {
+            kinds[w] = static_cast<unsigned char>(kind);
+            w = wedge[w];
+        } while ( w != v );
+    }
+
+    //--------------------------------------------------------------------------
+    // Quadrics per position: the plane of every face weighted by its area,
+    // and for border edges a plane through the edge perpendicular to the
+    // face so the outline of the border is kept.
+    //--------------------------------------------------------------------------
+    std::vector<Quadric> quadrics(vertexCount);
+    std::memset(&quadrics[0], 0, quadrics.size() * sizeof(Quadric));
+    for ( std::size_t i = 0; i < result.size(); i++ ) {
+        const TriangleFace& face = result[i];
+        Vector3d normal = FaceNormal(positions[face.indices[A]], positions[face.indices[B]], positions[face.indices[C]]);
+        double length = normal.length();
+        if ( length == 0.0 ) continue;
+        normal = normal / length;
+
+        Quadric q;
+        QuadricFromPlane(q, normal, -Vector3d::Dot(normal, positions[face.indices[A]]), 0.5 * length);
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) QuadricAdd(quadrics[remap[face.indices[j]]], q);
+
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int a = face.indices[j];
+            unsigned int b = face.indices[(j + 1) % TRIANGLE_EDGE_COUNT];
+            if ( HasPositionEdge(offsets, targets, remap, wedge, b, a) ) continue;
+
+            Vector3d edge = positions[b] - positions[a];
+            Vector3d borderNormal = Vector3d::Cross(edge, normal);
+            double borderLength = borderNormal.length();
+            if ( borderLength == 0.0 ) continue;
+            borderNormal = borderNormal / borderLength;
+
+            Quadric border;
+            QuadricFromPlane(border, borderNormal, -Vector3d::Dot(borderNormal, positions[a]), edge.lengthSquared() * SIMPLIFY_BORDER_WEIGHT);
+            QuadricAdd(quadrics[remap[a]], border);
+            QuadricAdd(quadrics[remap[b]], border);
+        }
+    }
+
+    double errorLimit = (targetError > 0.0f) ? (targetError / extent) * (targetError / extent) : 1.0e30;
+    double maxNormal = 0.0;
+    double maxTextureCoord = 0.0;
+
+    std::vector<unsigned int> triangleOffsets, triangleIndices;
+    std::vector<unsigned int> collapseRemap(vertexCount);
+    std::vector<bool> collapseLocked(vertexCount);
+    std::vector<EdgeCollapse> collapses;
+    collapseTargets.resize(vertexCount);
+    for ( unsigned int v = 0; v < vertexCount; v++ ) collapseTargets[v] = v;
+
+    while ( result.size() > targetFaceCount ) {
+        //----------------------------------------------------------------------
+        // Faces around each position, for the flip test.
+        //----------------------------------------------------------------------
+        triangleOffsets.assign(vertexCount + 1, 0);
+        for ( std::size_t i = 0; i < result.size(); i++ )
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) triangleOffsets[remap[result[i].indices[j]] + 1]++;
+        for ( std::size_t v = 0; v < vertexCount; v++ ) triangleOffsets[v + 1] += triangleOffsets[v];
+
+        triangleIndices.resize(triangleOffsets[vertexCount]);
+        std::vector<unsigned int> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+        for ( std::size_t i = 0; i < result.size(); i++ )
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) triangleIndices[fill[remap[result[i].indices[j]]]++] = static_cast<unsigned int>(i);
+
+        //----------------------------------------------------------------------
+        // Cost of every allowed collapse, the cheaper direction per edge.
+        //----------------------------------------------------------------------
+        collapses.clear();
+        for ( std::size_t i = 0; i < result.size(); i++ ) {
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+                unsigned int a = result[i].indices[j];
+                unsigned int b = result[i].indices[(j + 1) % TRIANGLE_EDGE_COUNT];
+
+                EdgeCollapse best;
+                best.from = NO_VERTEX;
+                best.cost = 0.0;
+                for ( unsigned int direction = 0; direction < 2; direction++ ) {
+                    unsigned int u = (direction == 0) ? a : b;
+                    unsigned int v = (direction == 0) ? b : a;
+
+                    unsigned char kind = kinds[u];
+                    if ( kind == LOCKED_VERTEX ) continue;
+                    if ( kind == BORDER_VERTEX ) {
+                        if ( kinds[v] != BORDER_VERTEX && kinds[v] != LOCKED_VERTEX ) continue;
+                        if ( remap[borderOut[u]] != remap[v] && remap[borderIn[u]] != remap[v] ) continue;
+                    }
+                    if ( kind == SEAM_VERTEX ) {
+                        if ( kinds[v] != SEAM_VERTEX && kinds[v] != LOCKED_VERTEX ) continue;
+                        if ( openOut[u] != v && openIn[u] != v ) continue;
+                        unsigned int w = wedge[u];
+                        unsigned int sibling = (openOut[u] == v) ? openIn[w] : openOut[w];
+                        if ( sibling == NO_VERTEX || remap[sibling] != remap[v] ) continue;
+                    }
+
+                    double geometric = QuadricError(quadrics[remap[u]], positions[v]);
+                    double normal = (vertices[u].normal - vertices[v].normal).lengthSquared();
+                    double textureCoord = (vertices[u].textureCoord - vertices[v].textureCoord).lengthSquared();
+                    double cost = geometric + SIMPLIFY_NORMAL_WEIGHT * normal + SIMPLIFY_TEXTURE_WEIGHT * textureCoord;
+                    if ( best.from == NO_VERTEX || cost < best.cost ) {
+                        best.from = u;
+                        best.to = v;
+                        best.cost = cost;
+                        best.geometric = geometric;
+                    }
+                }
+
+                if ( best.from != NO_VERTEX ) collapses.push_back(best);
+            }
+        }
+
+        if ( collapses.size() == 0 ) break;
+        std::sort(collapses.begin(), collapses.end(), [](const EdgeCollapse& l, const EdgeCollapse& r) { return l.cost < r.cost; });
+
+        //----------------------------------------------------------------------
+        // Apply the cheapest collapses. A position takes part in at most one
+        // collapse per pass; faces around it are evaluated with the vertices
+        // of the collapses already applied in this pass.
+        //----------------------------------------------------------------------
+        for ( unsigned int v = 0; v < vertexCount; v++ ) collapseRemap[v] = v;
+        std::fill(collapseLocked.begin(), collapseLocked.end(), false);
+
+        std::size_t faceGoal = result.size() - targetFaceCount;
+        std::size_t facesRemoved = 0;
+        std::size_t collapseCount = 0;
+        for ( std::size_t c = 0; c < collapses.size() && facesRemoved < faceGoal; c++ ) {
+            const EdgeCollapse& collapse = collapses[c];
+            if ( collapse.geometric > errorLimit ) continue;
+
+            unsigned int u = collapse.from;
+            unsigned int v = collapse.to;
+            unsigned int ru = remap[u];
+            unsigned int rv = remap[v];
+            if ( collapseLocked[ru] || collapseLocked[rv] ) continue;
+
+            bool flipped = false;
+            for ( unsigned int t = triangleOffsets[ru]; t < triangleOffsets[ru + 1] && !flipped; t++ ) {
+                const TriangleFace& face = result[triangleIndices[t]];
+                unsigned int corners[3];
+                bool touchesTarget = false;
+                for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+                    corners[j] = collapseRemap[face.indices[j]];
+                    if ( remap[corners[j]] == rv ) touchesTarget = true;
+                }
+                if ( touchesTarget ) continue;
+
+                Vector3d before = FaceNormal(positions[corners[A]], positions[corners[B]], positions[corners[C]]);
+                Vector3d moved[3];
+                for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) moved[j] = (remap[corners[j]] == ru) ? positions[v] : positions[corners[j]];
+                Vector3d after = FaceNormal(moved[A], moved[B], moved[C]);
+                if ( Vector3d::Dot(before, after) <= 0.0 ) flipped = true;
+            }
+            if ( flipped ) continue;
+
+            collapseRemap[u] = v;
+            if ( kinds[u] == SEAM_VERTEX ) {
+                unsigned int w = wedge[u];
+                collapseRemap[w] = (openOut[u] == v) ? openIn[w] : openOut[w];
+            }
+
+            QuadricAdd(quadrics[rv], quadrics[ru]);
+            collapseLocked[ru] = true;
+            collapseLocked[rv] = true;
+            facesRemoved += (kinds[u] == BORDER_VERTEX) ? 1 : 2;
+            collapseCount++;
+
+            maxNormal = std::max(maxNormal, static_cast<double>((vertices[u].normal - vertices[v].normal).length()));
+            maxTextureCoord = std::max(maxTextureCoord, static_cast<double>((vertices[u].textureCoord - vertices[v].textureCoord).length()));
+        }
+
+        if ( collapseCount == 0 ) break;
+
+        //----------------------------------------------------------------------
+        // Remap the faces and drop the ones that collapsed.
+        //----------------------------------------------------------------------
+        std::size_t kept = 0;
+        for ( std::size_t i = 0; i < result.size(); i++ ) {
+            TriangleFace face = result[i];
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) face.indices[j] = collapseRemap[face.indices[j]];
+
+            unsigned int a = remap[face.indices[A]], b = remap[face.indices[B]], c = remap[face.indices[C]];
+            if ( a != b && b != c && a != c ) result[kept++] = face;
+        }
+        result.resize(kept);
+
+        for ( unsigned int v = 0; v < vertexCount; v++ )
+            if ( collapseRemap[v] != v ) collapseTargets[v] = collapseRemap[v];
+
+        RemapOpenEdges(openOut, collapseRemap);
+        RemapOpenEdges(openIn, collapseRemap);
+        RemapOpenEdges(borderOut, collapseRemap);
+        RemapOpenEdges(borderIn, collapseRemap);
+    }
+
+    //--------------------------------------------------------------------------
+    // Resolve the collapse chains of all passes.
+    //--------------------------------------------------------------------------
+    for ( unsigned int v = 0; v < vertexCount; v++ ) {
+        unsigned int target = collapseTargets[v];
+        while ( collapseTargets[target] != target ) target = collapseTargets[target];
+        collapseTargets[v] = target;
+    }
+
+    error.normal = static_cast<float>(maxNormal);
+    error.textureCoord = static_cast<float>(maxTextureCoord);
+    return true;
+}
+
+bool SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, std::size_t targetFaceCount, float targetError, std::vector<TriangleFace>& result, SimplificationError* error) {
+    std::vector<unsigned int> collapseTargets;
+    SimplificationError simplificationError;
+    if ( !Simplify(vertices, faces, targetFaceCount, targetError, result, collapseTargets, simplificationError) ) return false;
+
+    if ( error != nullptr ) {
+        *error = simplificationError;
+        std::vector<unsigned int> remap, wedge;
+        BuildPositionRemap(vertices, remap, wedge);
+        error->geometric = MeasureCollapseError(vertices, result, remap, collapseTargets);
+    }
+
+    return true;
+}
+
+bool GenerateLodChain(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, std::vector<MeshLod>& lods, unsigned int maxLevels, float reduction) {
+    lods.clear();
+
+    //--------------------------------------------------------------------------
+    // Every level is simplified from the previous one. The collapse targets of
+    // the levels are composed so the error of a level is measured against the
+    // vertices of the full mesh.
+    //--------------------------------------------------------------------------
+    std::vector<unsigned int> targets(vertices.size());
+    for ( unsigned int v = 0; v < vertices.size(); v++ ) targets[v] = v;
+    std::vector<unsigned int> levelTargets;
+    std::vector<unsigned int> remap, wedge;
+    BuildPositionRemap(vertices, remap, wedge);
+
+    const std::vector<TriangleFace>* source = &faces;
+    SimplificationError sourceError;
+    std::memset(&sourceError, 0, sizeof(SimplificationError));
+
+    for ( unsigned int level = 0; level < maxLevels; level++ ) {
+        std::size_t targetFaceCount = static_cast<std::size_t>(source->size() * reduction);
+        if ( targetFaceCount < LOD_MIN_FACE_COUNT ) break;
+
+        MeshLod lod;
+        if ( !Simplify(vertices, *source, targetFaceCount, 0.0f, lod.faces, levelTargets, lod.error) ) return false;
+
+        //----------------------------------------------------------------------
+        // A level that removed less than half of what was asked for is not
+        // worth its memory; the mesh is as coarse as its locks allow.
+        //----------------------------------------------------------------------
+        if ( source->size() - lod.faces.size() < (source->size() - targetFaceCount) / 2 ) break;
+
+        for ( unsigned int v = 0; v < vertices.size(); v++ ) targets[v] = levelTargets[targets[v]];
+
+        lod.error.geometric = MeasureCollapseError(vertices, lod.faces, remap, targets);
+        lod.error.normal = std::max(lod.error.normal, sourceError.normal);
+        lod.error.textureCoord = std::max(lod.error.textureCoord, sourceError.textureCoord);
+        OptimizeVertexCache(lod.faces, vertices.size());
+
+        lods.push_back(lod);
+        source = &lods.back().faces;
+        sourceError = lods.back().error;
+    }
+
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include <vector>
+#include "Vertex.h"
+#include "Face.h"
+
+/*
+ * Weights of the collapse cost terms. Attribute differences are compared
+ * with squared distances in a mesh scaled to unit size, border planes are
+ * weighted against the area-weighted face planes.
+ */
+const static float SIMPLIFY_NORMAL_WEIGHT = 0.01f;
+const static float SIMPLIFY_TEXTURE_WEIGHT = 0.01f;
+const static float SIMPLIFY_BORDER_WEIGHT = 10.0f;
+
+/* Default LOD chain: every level keeps half the faces of the previous one. */
+const static unsigned int LOD_MAX_LEVELS = 5;
+const static float LOD_REDUCTION = 0.5f;
+const static std::size_t LOD_MIN_FACE_COUNT = 32;
+
+/* Screen space error (pixels) a level of detail may have when selected. */
+const static float LOD_PIXEL_ERROR = 1.0f;
+
+/*
+ * Error of a simplified mesh. The geometric error is the largest object
+ * space distance from a removed vertex to the faces around the vertex it
+ * collapsed onto. The normal and texture coordinate errors are the largest
+ * attribute difference of a collapse.
+ */
+struct SimplificationError {
+    float geometric;
+    float normal;
+    float textureCoord;
+};
+
+/* A level of detail: the faces index the vertices of the full mesh. */
+struct MeshLod {
+    std::vector<TriangleFace> faces;
+    SimplificationError error;
+};
+
+/*
+ * Simplifies the faces with Garland-Heckbert quadric error metrics. Edges
+ * are collapsed onto one of their vertices, so the result indexes the same
+ * vertices as the input and all levels of detail can share one vertex
+ * buffer. The collapse cost adds the attribute difference of the two
+ * vertices to the quadric error. Vertices on open borders only slide along
+ * the border and vertices on attribute seams only along the seam (both
+ * sides together); any other vertex with several attribute sets is locked.
+ *
+ * Simplification stops at targetFaceCount. Collapses whose quadric error
+ * (RMS distance to the merged planes) exceeds targetError (object space, 0
+ * for no limit) are skipped. The error is optional.
+ */
+bool SimplifyMesh(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, std::size_t targetFaceCount, float targetError, std::vector<TriangleFace>& result, SimplificationError* error = nullptr);
+
+/*
+ * Builds a chain of coarser levels of detail, each simplified from the one
+ * before to reduction times its face count. The error of a level includes
+ * the error of the levels it was simplified from. The chain ends early once
+ * a level stops shrinking or falls below LOD_MIN_FACE_COUNT faces. The faces
+ * of every level are reordered for the vertex cache.
+ */
+bool GenerateLodChain(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, std::vector<MeshLod>& lods, unsigned int maxLevels = LOD_MAX_LEVELS, float reduction = LOD_REDUCTION);
+
+#endif
@@ -0,0 +1,305 @@
+#include "Meshlet.h"
+#include "MeshOptimizer.h"
+#include "Frustum.h"
+#include <algorithm>
+#include <cmath>
+
+const static unsigned int NOT_IN_MESHLET = 0xFFFFFFFF;
+const static std::size_t NO_FACE = static_cast<std::size_t>(-1);
+
+/*
+ * Ritter's bounding sphere: the sphere through the most distant pair of axis
+ * extremes, grown to take in every point outside it.
+ */
+static void BoundingSphere(const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, Vector3f& center, float& radius) {
+    std::size_t minIndex[3] = { 0, 0, 0 };
+    std::size_t maxIndex[3] = { 0, 0, 0 };
+    for ( std::size_t i = 1; i < indices.size(); i++ ) {
+        const Vector3f& p = vertices[indices[i]].position;
+        for ( unsigned int axis = 0; axis < 3; axis++ ) {
+            if ( p[axis] < vertices[indices[minIndex[axis]]].position[axis] ) minIndex[axis] = i;
+            if ( p[axis] > vertices[indices[maxIndex[axis]]].position[axis] ) maxIndex[axis] = i;
+        }
+    }
+
+    float widest = -1.0f;
+    for ( unsigned int axis = 0; axis < 3; axis++ ) {
+        const Vector3f& a = vertices[indices[minIndex[axis]]].position;
+        const Vector3f& b = vertices[indices[maxIndex[axis]]].position;
+        float distance = static_cast<float>((b - a).lengthSquared());
+        if ( distance <= widest ) continue;
+
+        widest = distance;
+        center = (a + b) * 0.5f;
+        radius = std::sqrt(distance) * 0.5f;
+    }
+
+    for ( std::size_t i = 0; i < indices.size(); i++ ) {
+        Vector3f offset = vertices[indices[i]].position - center;
+        float distance = static_cast<float>(offset.length());
+        if ( distance <= radius ) continue;
+
+        float grown = (radius + distance) * 0.5f;
+        center = center + offset * ((grown - radius) / distance);
+        radius = grown;
+    }
+}
+
+/*
+ * Score of a candidate face for a growing meshlet (lower is better): the
+ * distance to the meshlet centre relative to the expected meshlet radius,
+ * scaled down by how well the normal agrees with the meshlet normals.
+ */
+static float CandidateScore(float distance, float agreement, float expectedRadius) {
+    float cone = std::max(1.0f - agreement * MESHLET_CONE_WEIGHT, 1.0e-3f);
+    return (1.0f + distance / expectedRadius * (1.0f - MESHLET_CONE_WEIGHT)) * cone;
+}
+
+/*
+ * Appends the meshlet being grown: computes its bounds and normal cone and
+ * appends its faces, reordered for the vertex cache on their local indices.
+ */
+static void AppendMeshlet(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const std::vector<Vector3f>& normals, const std::vector<unsigned int>& meshletVertices, const std::vector<unsigned int>& meshletFaces, const std::vector<unsigned int>& localIndices, const Vector3f& normalSum, std::vector<TriangleFace>& ordered, std::vector<Meshlet>& meshlets) {
+    Meshlet meshlet;
+    meshlet.faceOffset = static_cast<unsigned int>(ordered.size());
+    meshlet.faceCount = static_cast<unsigned int>(meshletFaces.size());
+    meshlet.vertexCount = static_cast<unsigned int>(meshletVertices.size());
+    BoundingSphere(vertices, meshletVertices, meshlet.center, meshlet.radius);
+
+    //--------------------------------------------------------------------------
+    // The cone axis is the average face normal; the cone is as wide as the
+    // face normal furthest from it. Degenerate faces have no normal.
+    //--------------------------------------------------------------------------
+    float axisLength = static_cast<float>(normalSum.length());
+    meshlet.coneAxis = (axisLength > 0.0f) ? normalSum * (1.0f / axisLength) : Vector3f(0.0f, 0.0f, 1.0f);
+    float minimumDot = (axisLength > 0.0f) ? 1.0f : -1.0f;
+    for ( std::size_t i = 0; i < meshletFaces.size(); i++ ) {
+        if ( normals[meshletFaces[i]].lengthSquared() == 0.0f ) continue;
+        minimumDot = std::min(minimumDot, static_cast<float>(Vector3f::Dot(normals[meshletFaces[i]], meshlet.coneAxis)));
+    }
+    meshlet.coneCutoff = (minimumDot <= 0.0f) ? 1.0f : std::sqrt(1.0f - minimumDot * minimumDot);
+
+    std::vector<TriangleFace> localFaces(meshletFaces.size());
+    for ( std::size_t i = 0; i < meshletFaces.size(); i++ )
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) localFaces[i].indices[j] = localIndices[faces[meshletFaces[i]].indices[j]];
+    OptimizeVertexCache(localFaces, meshletVertices.size());
+
+    for ( std::size_t i = 0; i < localFaces.size(); i++ ) {
+        TriangleFace face;
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) face.indices[j] = meshletVertices[localFaces[i].indices[j]];
+        ordered.push_back(face);
+    }
+
+    meshlets.push_back(meshlet);
+}
+
+bool BuildMeshlets(const std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, std::vector<Meshlet>& meshlets, unsigned int maxVertices, unsigned int maxTriangles) {
+    meshlets.clear();
+
+    if ( faces.size() == 0 ) {
+        std::cerr << "[Meshlet:BuildMeshlets] Error: Face count = 0." << std::endl;
+        return false;
+    }
+
+    if ( maxVertices < TRIANGLE_EDGE_COUNT || maxTriangles == 0 ) {
+        std::cerr << "[Meshlet:BuildMeshlets] Error: Meshlet limits too small." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Vertex to face adjacency in compressed rows, the faces not yet placed
+    // per vertex, and the centroid and unit normal of every face. The
+    // expected meshlet radius follows from the average face area.
+    //--------------------------------------------------------------------------
+    std::size_t faceCount = faces.size();
+    std::vector<unsigned int> offsets(vertices.size() + 1, 0);
+    for ( std::size_t i = 0; i < faceCount; i++ )
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) offsets[faces[i].indices[j] + 1]++;
+    for ( std::size_t i = 0; i < vertices.size(); i++ ) offsets[i + 1] += offsets[i];
+
+    std::vector<unsigned int> adjacency(offsets.back());
+    std::vector<unsigned int> remaining(vertices.size(), 0);
+    for ( std::size_t i = 0; i < faceCount; i++ ) {
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int v = faces[i].indices[j];
+            adjacency[offsets[v] + remaining[v]++] = static_cast<unsigned int>(i);
+        }
+    }
+
+    std::vector<Vector3f> centroids(faceCount);
+    std::vector<Vector3f> normals(faceCount);
+    float areaSum = 0.0f;
+    for ( std::size_t i = 0; i < faceCount; i++ ) {
+        const Vector3f& p0 = vertices[faces[i].indices[A]].position;
+        const Vector3f& p1 = vertices[faces[i].indices[B]].position;
+        const Vector3f& p2 = vertices[faces[i].indices[C]].position;
+        centroids[i] = (p0 + p1 + p2) * (1.0f / 3.0f);
+
+        Vector3f normal = Vector3f::Cross(p1 - p0, p2 - p0);
+        float length = static_cast<float>(normal.length());
+        areaSum += length * 0.5f;
+        normals[i] = (length > 0.0f) ? normal * (1.0f / length) : Vector3f(0.0f, 0.0f, 0.0f);
+    }
+
+    float expectedRadius = std::sqrt(areaSum / static_cast<float>(faceCount) * static_cast<float>(maxTriangles)) * 0.5f;
+    if ( expectedRadius <= 0.0f ) expectedRadius = 1.0f;
+
+    //--------------------------------------------------------------------------
+    // Grow one meshlet at a time. localIndices maps a vertex to its index in
+    // the current meshlet; meshletStamps tells which meshlet that entry
+    // belongs to so the table is never cleared. The next face is searched
+    // among the faces around the meshlet vertices; a meshlet without
+    // neighbours left takes the next free face of the input order.
+    //--------------------------------------------------------------------------
+    std::vector<TriangleFace> ordered;
+    ordered.reserve(faceCount);
+    std::vector<bool> placed(faceCount, false);
+    std::vector<unsigned int> localIndices(vertices.size(), NOT_IN_MESHLET);
+    std::vector<unsigned int> meshletStamps(vertices.size(), 0);
+    unsigned int stamp = 1;
+
+    std::vector<unsigned int> meshletVertices;
+    std::vector<unsigned int> meshletFaces;
+    Vector3f centroidSum(0.0f, 0.0f, 0.0f);
+    Vector3f normalSum(0.0f, 0.0f, 0.0f);
+    std::size_t cursor = 0;
+    std::size_t placedCount = 0;
+    std::size_t next = NO_FACE;
+
+    while ( placedCount < faceCount ) {
+        if ( next == NO_FACE ) {
+            while ( placed[cursor] ) cursor++;
+            next = cursor;
+        }
+
+        //----------------------------------------------------------------------
+        // Close the meshlet when the next face does not fit.
+        //----------------------------------------------------------------------
+        unsigned int newVertices = 0;
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int v = faces[next].indices[j];
+            bool repeated = (j > 0 && v == faces[next].indices[0]) || (j > 1 && v == faces[next].indices[1]);
+            if ( meshletStamps[v] != stamp && !repeated ) newVertices++;
+        }
+
+        if ( meshletVertices.size() + newVertices > maxVertices || meshletFaces.size() == maxTriangles ) {
+            AppendMeshlet(vertices, faces, normals, meshletVertices, meshletFaces, localIndices, normalSum, ordered, meshlets);
+            meshletVertices.clear();
+            meshletFaces.clear();
+            centroidSum = Vector3f(0.0f, 0.0f, 0.0f);
+            normalSum = Vector3f(0.0f, 0.0f, 0.0f);
+            stamp++;
+            continue;
+        }
+
+        //----------------------------------------------------------------------
+        // Add the face and its vertices to the meshlet.
+        //----------------------------------------------------------------------
+        for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+            unsigned int v = faces[next].indices[j];
+            if ( meshletStamps[v] != stamp ) {
+                meshletStamps[v] = stamp;
+                localIndices[v] = static_cast<unsigned int>(meshletVertices.size());
+                meshletVertices.push_back(v);
+            }
+            remaining[v]--;
+        }
+
+        placed[next] = true;
+        placedCount++;
+        meshletFaces.push_back(static_cast<unsigned int>(next));
+        centroidSum += centroids[next];
+        normalSum += normals[next];
+
+        //----------------------------------------------------------------------
+        // Pick the neighbouring face that adds the fewest vertices, then the
+        // one with the best score.
+        //----------------------------------------------------------------------
+        Vector3f center = centroidSum * (1.0f / static_cast<float>(meshletFaces.size()));
+        float axisLength = static_cast<float>(normalSum.length());
+        Vector3f axis = (axisLength > 0.0f) ? normalSum * (1.0f / axisLength) : Vector3f(0.0f, 0.0f, 0.0f);
+
+        next = NO_FACE;
+        unsigned int bestNewVertices = TRIANGLE_EDGE_COUNT + 1;
+        float bestScore = 0.0f;
+        for ( std::size_t k = 0; k < meshletVertices.size(); k++ ) {
+            unsigned int v = meshletVertices[k];
+            if ( remaining[v] == 0 ) continue;
+
+            for ( unsigned int a = offsets[v]; a < offsets[v + 1]; a++ ) {
+                unsigned int f = adjacency[a];
+                if ( placed[f] ) continue;
+
+                unsigned int candidateNewVertices = 0;
+                for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ )
+                    if ( meshletStamps[faces[f].indices[j]] != stamp ) candidateNewVertices++;
+                if ( candidateNewVertices > bestNewVertices ) continue;
+
+                float distance = static_cast<float>((centroids[f] - center).length());
+                float score = CandidateScore(distance, static_cast<float>(Vector3f::Dot(normals[f], axis)), expectedRadius);
+                if ( candidateNewVertices < bestNewVertices || score < bestScore ) {
+                    next = f;
+                    bestNewVertices = candidateNewVertices;
+                    bestScore = score;
+                }
+            }
+        }
+    }
+
+    if ( meshletFaces.size() > 0 ) AppendMeshlet(vertices, faces, normals, meshletVertices, meshletFaces, localIndices, normalSum, ordered, meshlets);
+    faces.swap(ordered);
+    return true;
+}
+
+void CullMeshlets(const std::vector<Meshlet>& meshlets, const Matrix4f& modelViewProjection, const Vector3f& eye, std::vector<MeshletDraw>& draws, MeshletCullingStatistics* statistics) {
+    draws.clear();
+
+    Frustum frustum;
+    ExtractFrustum(modelViewProjection, frustum);
+
+    //--------------------------------------------------------------------------
+    // A meshlet is culled if its sphere lies outside a plane, or if the eye
+    // sees every point of the sphere from behind the normal cone: the angle
+    // between the view direction and the cone axis has to stay below 90
+    // degrees minus the cone angle.
+    //--------------------------------------------------------------------------
+    std::size_t frustumCulled = 0;
+    std::size_t coneCulled = 0;
+    std::size_t faceCount = 0;
+    std::size_t visibleFaces = 0;
+    for ( std::size_t i = 0; i < meshlets.size(); i++ ) {
+        const Meshlet& meshlet = meshlets[i];
+        faceCount += meshlet.faceCount;
+
+        if ( !FrustumIntersectsSphere(frustum, meshlet.center, meshlet.radius) ) {
+            frustumCulled++;
+            continue;
+        }
+
+        Vector3f view = meshlet.center - eye;
+        if ( Vector3f::Dot(view, meshlet.coneAxis) >= meshlet.coneCutoff * view.length() + meshlet.radius ) {
+            coneCulled++;
+            continue;
+        }
+
+        std::size_t firstIndex = static_cast<std::size_t>(meshlet.faceOffset) * TRIANGLE_EDGE_COUNT;
+        std::size_t indexCount = static_cast<std::size_t>(meshlet.faceCount) * TRIANGLE_EDGE_COUNT;
+        if ( draws.size() > 0 && draws.back().firstIndex + draws.back().indexCount == firstIndex ) draws.back().indexCount += indexCount;
+        else {
+            MeshletDraw draw;
+            draw.firstIndex = firstIndex;
+            draw.indexCount = indexCount;
+            draws.push_back(draw);
+        }
+
+        visibleFaces += meshlet.faceCount;
+    }
+
+    if ( statistics == nullptr ) return;
+    statistics->meshletCount = meshlets.size();
+    statistics->frustumCulled = frustumCulled;
+    statistics->coneCulled = coneCulled;
+    statistics->visibleFaces = visibleFaces;
+    statistics->drawCount = draws.size();
+    statistics->culledFraction = (faceCount > 0) ? 1.0f - static_cast<float>(visibleFaces) / static_cast<float>(faceCount) : 0.0f;
+}
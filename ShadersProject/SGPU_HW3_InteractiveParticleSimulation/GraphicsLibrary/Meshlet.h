@@ -0,0 +1,77 @@
+#ifndef MESHLET_H
+#define MESHLET_H
+
+#include <vector>
+#include <Matrix4.h>
+#include <Vector4.h>
+#include "Vertex.h"
+#include "Face.h"
+
+/* Default meshlet size limits. */
+const static unsigned int MESHLET_MAX_VERTICES = 64;
+const static unsigned int MESHLET_MAX_TRIANGLES = 124;
+
+/*
+ * Weight of the normal agreement against the spatial compactness when a
+ * meshlet picks its next triangle: 0 builds the tightest spheres, 1 the
+ * narrowest normal cones.
+ */
+const static float MESHLET_CONE_WEIGHT = 0.5f;
+
+/*
+ * A cluster of neighbouring faces: faces[faceOffset] .. faces[faceOffset +
+ * faceCount - 1] of the mesh, using vertexCount distinct vertices. The
+ * bounding sphere encloses the faces and every face normal lies within the
+ * normal cone around coneAxis. coneCutoff is the sine of the cone angle, or
+ * 1 if the cone is too wide to ever face away from the camera.
+ */
+struct Meshlet {
+    unsigned int faceOffset;
+    unsigned int faceCount;
+    unsigned int vertexCount;
+    Vector3f center;
+    float radius;
+    Vector3f coneAxis;
+    float coneCutoff;
+};
+
+/* A run of consecutive visible meshlets, in indices of the face array. */
+struct MeshletDraw {
+    std::size_t firstIndex;
+    std::size_t indexCount;
+};
+
+/*
+ * Result of one culling pass. The culled fraction counts faces, the time is
+ * filled in by the caller that timed the pass.
+ */
+struct MeshletCullingStatistics {
+    std::size_t meshletCount;
+    std::size_t frustumCulled;
+    std::size_t coneCulled;
+    std::size_t visibleFaces;
+    std::size_t drawCount;
+    float culledFraction;
+    double milliseconds;
+};
+
+/*
+ * Partitions the faces into meshlets of at most maxVertices vertices and
+ * maxTriangles faces and reorders the faces so every meshlet is contiguous.
+ * A meshlet grows by the adjacent face that adds the fewest new vertices;
+ * ties go to the face closest to the meshlet centre whose normal agrees best
+ * with the meshlet (see MESHLET_CONE_WEIGHT). A face that no longer fits
+ * seeds the next meshlet. The faces of every meshlet are reordered for the
+ * vertex cache.
+ */
+bool BuildMeshlets(const std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces, std::vector<Meshlet>& meshlets, unsigned int maxVertices = MESHLET_MAX_VERTICES, unsigned int maxTriangles = MESHLET_MAX_TRIANGLES);
+
+/*
+ * Culls the meshlets against the frustum of a model-view-projection matrix
+ * and against the eye position in object space (normal cones facing away
+ * from the eye), and merges the visible meshlets that follow each other into
+ * one draw. The statistics are optional.
+ */
+void CullMeshlets(const std::vector<Meshlet>& meshlets, const Matrix4f& modelViewProjection, const Vector3f& eye, std::vector<MeshletDraw>& draws, MeshletCullingStatistics* statistics = nullptr);
+
+#endif
@@ -0,0 +1,634 @@
+#include "Model.h"
+#include "GLState.h"
+#include "VertexFormat.h"
+#include "MeshOptimizer.h"
+#include "Triangulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+#define BUFFER_OFFSET(i) ((char *)NULL + (i))
+
+/* Attribute locations shared with Mesh (see Mesh::loadShader). */
+const static unsigned int POSITION_LOC = 0;
+const static unsigned int NORMAL_LOC = 1;
+const static unsigned int TANGENT_LOC = 2;
+const static unsigned int TEXTURE_COORD_LOC = 3;
+const static unsigned int COLOR_LOC = 4;
+const static unsigned int ATTRIBUTE_LOCS[VertexFormat::ATTRIBUTE_COUNT] = { POSITION_LOC, NORMAL_LOC, TANGENT_LOC, TEXTURE_COORD_LOC, COLOR_LOC };
+
+const static std::size_t MAX_SHORT_INDEX_VERTICES = 65536;
+
+/* Material, object and group of a face; the submeshes sort by it. */
+typedef std::tuple<std::size_t, std::size_t, std::size_t> SubmeshKey;
+
+/* Position, texture coordinate and normal index of a face corner. */
+struct ObjCorner {
+    bool operator == (const ObjCorner& corner) const {
+        return this->position == corner.position && this->textureCoord == corner.textureCoord && this->normal == corner.normal;
+    }
+
+    std::size_t position;
+    std::size_t textureCoord;
+    std::size_t normal;
+};
+
+struct ObjCornerHash {
+    std::size_t operator () (const ObjCorner& corner) const {
+        return (corner.position * 73856093u) ^ (corner.textureCoord * 19349663u) ^ (corner.normal * 83492791u);
+    }
+};
+
+/* The texture of a map file, created once however many materials use it. */
+static std::shared_ptr<Texture> LoadMaterialTexture(TextureDecodeQueue& queue, const std::string& filename, std::map<std::string, std::shared_ptr<Texture>>& textures) {
+    if ( filename.length() == 0 ) return nullptr;
+
+    std::map<std::string, std::shared_ptr<Texture>>::const_iterator found = textures.find(filename);
+    if ( found != textures.end() ) return found->second;
+
+    std::shared_ptr<Texture> texture = queue.createTexture(filename);
+    textures.insert(std::make_pair(filename, texture));
+    return texture;
+}
+
+Model::Model() {
+    this->transform = Transformation<float>::Identity();
+    this->shader = nullptr;
+    this->drawsChanged = true;
+    this->boundingRadius = 0.0f;
+    this->statistics = ModelImportStatistics();
+    this->vboVertex = 0;
+    this->vboIndex = 0;
+    this->vao = 0;
+    this->indexType = GL_UNSIGNED_INT;
+    this->indexSize = sizeof(unsigned int);
+}
+
+Model::~Model() {
+    GLState::DeleteVertexArray(this->vao);
+    GLState::DeleteBuffer(this->vboVertex);
+    GLState::DeleteBuffer(this->vboIndex);
+}
+
+bool Model::load(const std::string& filename) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    ObjFile file;
+    TextureDecodeQueue textures;
+    if ( !file.load(filename, &textures) ) {
+        std::cerr << "[Model:load] Error: Could not load Obj file: " << filename << std::endl;
+        return false;
+    }
+
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    if ( !this->build(file, &textures) ) return false;
+
+    this->name = filename;
+    this->statistics.parseMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    return true;
+}
+
+bool Model::build(const ObjFile& file, TextureDecodeQueue* textures) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    this->statistics = ModelImportStatistics();
+    this->statistics.objectCount = file.getMeshCount();
+
+    //--------------------------------------------------------------------------
+    // Face indices are global to the file while every object keeps its own
+    // vertices, so the attributes of all objects are joined first.
+    //--------------------------------------------------------------------------
+    std::vector<Vector3f> positions;
+    std::vector<Vector3f> normals;
+    std::vector<Vector3f> textureCoords;
+    for ( std::size_t m = 0; m < file.getMeshCount(); m++ ) {
+        const std::shared_ptr<ObjMesh>& mesh = file.getMesh(m);
+        positions.insert(positions.end(), mesh->vertices.begin(), mesh->vertices.end());
+        normals.insert(normals.end(), mesh->normals.begin(), mesh->normals.end());
+        textureCoords.insert(textureCoords.end(), mesh->textureCoordinates.begin(), mesh->textureCoordinates.end());
+    }
+
+    //--------------------------------------------------------------------------
+    // First pass: the submesh of every face and the number of triangles of
+    // every submesh. Consecutive faces nearly always share their key, so the
+    // map is only searched when it changes.
+    //--------------------------------------------------------------------------
+    std::map<SubmeshKey, std::size_t> keys;
+    std::vector<std::size_t> sizes;
+    std::vector<std::size_t> faceSubmeshes;
+    std::vector<const Obj_Face*> objFaces;
+    SubmeshKey lastKey;
+    std::size_t lastSubmesh = 0;
+
+    for ( std::size_t m = 0; m < file.getMeshCount(); m++ ) {
+        const std::vector<Obj_Face>& meshFaces = file.getMesh(m)->faces;
+        this->statistics.faceCount += meshFaces.size();
+
+        for ( std::size_t i = 0; i < meshFaces.size(); i++ ) {
+            const Obj_Face& face = meshFaces[i];
+            if ( face.type != TRIANGLE ) this->statistics.polygonCount++;
+
+            for ( std::size_t j = 0; j < face.vertexIndices.size(); j++ ) {
+                if ( (normals.size() > 0 && face.normalIndices[j] >= normals.size()) ||
+                    (textureCoords.size() > 0 && face.textureIndices[j] >= textureCoords.size()) ) {
+                    std::cerr << "[Model:build] Error: Face index out of range in object: " << file.getMesh(m)->name << std::endl;
+                    return false;
+                }
+            }
+
+            SubmeshKey key(face.materialIndex, m, face.groupIndex);
+            if ( objFaces.size() == 0 || key != lastKey ) {
+                std::map<SubmeshKey, std::size_t>::iterator found = keys.find(key);
+                if ( found == keys.end() ) {
+                    found = keys.insert(std::make_pair(key, sizes.size())).first;
+                    sizes.push_back(0);
+                }
+
+                lastKey = key;
+                lastSubmesh = found->second;
+            }
+
+            objFaces.push_back(&face);
+            faceSubmeshes.push_back(lastSubmesh);
+            sizes[lastSubmesh] += face.vertexIndices.size() - 2;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Quads and polygons are split into triangles in file order, in parallel
+    // for large files (see TriangulateObjFaces).
+    //--------------------------------------------------------------------------
+    ObjTriangles triangles;
+    if ( !TriangulateObjFaces(objFaces, positions, triangles) ) return false;
+
+    if ( triangles.statistics.triangleCount == 0 ) {
+        std::cerr << "[Model:build] Error: Obj file contains no faces." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // The submeshes in key order (material, object, group) and their first
+    // face; a material is the run of submeshes with its file index.
+    //--------------------------------------------------------------------------
+    this->submeshes.clear();
+    this->materials.clear();
+    std::vector<std::size_t> cursors(sizes.size(), 0);
+    std::size_t faceOffset = 0;
+    std::size_t lastMaterial = 0;
+    for ( std::map<SubmeshKey, std::size_t>::const_iterator i = keys.begin(); i != keys.end(); i++ ) {
+        std::size_t material = std::get<0>(i->first);
+        std::size_t group = std::get<2>(i->first);
+
+        if ( this->materials.size() == 0 || material != lastMaterial ) {
+            ModelMaterial modelMaterial;
+            modelMaterial.name = file.getFaceMaterial(material);
+            modelMaterial.shader = nullptr;
+            modelMaterial.firstSubmesh = this->submeshes.size();
+            modelMaterial.submeshCount = 0;
+
+            const ObjMaterial* definition = file.findMaterialDefinition(modelMaterial.name);
+            modelMaterial.defined = (definition != nullptr);
+            if ( definition != nullptr ) modelMaterial.definition = *definition;
+            this->materials.push_back(modelMaterial);
+            lastMaterial = material;
+        }
+
+        ModelSubmesh submesh;
+        submesh.name = (group != 0) ? file.getFaceGroup(group) : file.getMesh(std::get<1>(i->first))->name;
+        submesh.material = this->materials.size() - 1;
+        submesh.firstIndex = faceOffset * TRIANGLE_EDGE_COUNT;
+        submesh.indexCount = sizes[i->second] * TRIANGLE_EDGE_COUNT;
+        submesh.visible = true;
+        this->submeshes.push_back(submesh);
+        this->materials.back().submeshCount++;
+
+        cursors[i->second] = faceOffset;
+        faceOffset += sizes[i->second];
+    }
+
+    //--------------------------------------------------------------------------
+    // Files without normals get the average normal of the faces around each
+    // position, indexed like the positions.
+    //--------------------------------------------------------------------------
+    bool positionNormals = (normals.size() == 0);
+    if ( positionNormals && !CalculateNormals(triangles.vertexIndices, positions, normals) ) return false;
+
+    //--------------------------------------------------------------------------
+    // Second pass: the triangles of every face are written to the next faces
+    // of its submesh while their corners are welded into vertices.
+    //--------------------------------------------------------------------------
+    std::unordered_map<ObjCorner, unsigned int, ObjCornerHash> corners;
+    corners.reserve(positions.size() * 2);
+    this->vertices.clear();
+    this->faces.resize(triangles.statistics.triangleCount);
+
+    Vertex vertex;
+    vertex.color = Color3f(0.0f, 0.0f, 0.0f);
+    for ( std::size_t i = 0; i < objFaces.size(); i++ ) {
+        for ( std::size_t t = triangles.faceOffsets[i]; t < triangles.faceOffsets[i + 1]; t++ ) {
+            TriangleFace& triangle = this->faces[cursors[faceSubmeshes[i]]++];
+
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+                std::size_t index = t * TRIANGLE_EDGE_COUNT + j;
+                ObjCorner corner;
+                corner.position = triangles.vertexIndices[index];
+                corner.textureCoord = (textureCoords.size() > 0) ? triangles.textureIndices[index] : 0;
+                corner.normal = positionNormals ? corner.position : triangles.normalIndices[index];
+
+                std::pair<std::unordered_map<ObjCorner, unsigned int, ObjCornerHash>::iterator, bool> inserted =
+                    corners.insert(std::make_pair(corner, static_cast<unsigned int>(this->vertices.size())));
+
+                if ( inserted.second ) {
+                    vertex.position = positions[corner.position];
+                    vertex.normal = normals[corner.normal];
+                    vertex.textureCoord = (textureCoords.size() > 0) ? textureCoords[corner.textureCoord] : Vector3f(0.0f, 0.0f, 0.0f);
+                    this->vertices.push_back(vertex);
+                }
+
+                triangle.indices[j] = inserted.first->second;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // The face order is fixed by the submeshes, only the vertices follow it.
+    //--------------------------------------------------------------------------
+    CalculateTangents(this->vertices, this->faces);
+    OptimizeVertexFetch(this->vertices, this->faces);
+    this->computeBounds();
+
+    if ( !this->constructOnGPU() ) return false;
+
+    //--------------------------------------------------------------------------
+    // The maps have been decoding since the libraries were read. Without a
+    // queue from load they are all queued here first, so they still decode
+    // in parallel while the earlier ones are uploaded.
+    //--------------------------------------------------------------------------
+    std::chrono::high_resolution_clock::time_point textureStart = std::chrono::high_resolution_clock::now();
+    TextureDecodeQueue buildTextures;
+    TextureDecodeQueue& queue = (textures != nullptr) ? *textures : buildTextures;
+    for ( std::size_t i = 0; i < this->materials.size(); i++ ) {
+        queue.queue(this->materials[i].definition.diffuseMap);
+        queue.queue(this->materials[i].definition.bumpMap);
+        queue.queue(this->materials[i].definition.specularMap);
+    }
+
+    std::map<std::string, std::shared_ptr<Texture>> materialTextures;
+    for ( std::size_t i = 0; i < this->materials.size(); i++ ) {
+        ModelMaterial& material = this->materials[i];
+        material.diffuseTexture = LoadMaterialTexture(queue, material.definition.diffuseMap, materialTextures);
+        material.normalTexture = LoadMaterialTexture(queue, material.definition.bumpMap, materialTextures);
+        material.specularTexture = LoadMaterialTexture(queue, material.definition.specularMap, materialTextures);
+    }
+
+    this->createLibraryShaders();
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+    for ( std::map<std::string, std::shared_ptr<Texture>>::const_iterator i = materialTextures.begin(); i != materialTextures.end(); i++ )
+        if ( i->second != nullptr ) this->statistics.textureCount++;
+    this->statistics.textureMilliseconds = std::chrono::duration<double, std::milli>(end - textureStart).count();
+    this->statistics.submeshCount = this->submeshes.size();
+    this->statistics.materialCount = this->materials.size();
+    this->statistics.triangleCount = this->faces.size();
+    this->statistics.triangulationMilliseconds = triangles.statistics.milliseconds;
+    this->statistics.vertexCount = this->vertices.size();
+    this->statistics.buildMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    return true;
+}
+
+bool Model::loadShader(const std::string& vertexFilename, const std::string& fragmentFilename) {
+    this->shader = std::make_shared<Shader>();
+
+    if ( !this->shader->load(vertexFilename, fragmentFilename) ) {
+        std::cerr << "[Model:loadShader] Error: Could not load shader." << std::endl;
+        return false;
+    }
+
+    if ( !this->shader->compile() ) {
+        std::cerr << "[Model:loadShader] Error: Could not compile shader." << std::endl;
+        return false;
+    }
+
+    glBindAttribLocation(this->shader->getProgramID(), POSITION_LOC, "position");
+    glBindAttribLocation(this->shader->getProgramID(), NORMAL_LOC, "normal");
+    glBindAttribLocation(this->shader->getProgramID(), TANGENT_LOC, "tangent");
+    glBindAttribLocation(this->shader->getProgramID(), TEXTURE_COORD_LOC, "textureCoordinate");
+    glBindAttribLocation(this->shader->getProgramID(), COLOR_LOC, "color");
+
+    if ( !this->shader->link() ) {
+        std::cerr << "[Model:loadShader] Error: Could not link shader program." << std::endl;
+        return false;
+    }
+
+    this->createLibraryShaders();
+    return true;
+}
+
+void Model::setShader(const std::shared_ptr<Shader>& shader) {
+    this->shader = shader;
+    this->createLibraryShaders();
+}
+
+bool Model::setMaterialShader(const std::string& material, const std::shared_ptr<Shader>& shader) {
+    for ( std::size_t i = 0; i < this->materials.size(); i++ ) {
+        if ( this->materials[i].name != material ) continue;
+
+        this->materials[i].shader = shader;
+        this->drawsChanged = true;
+        return true;
+    }
+
+    std::cerr << "[Model:setMaterialShader] Error: Unknown material: " << material << std::endl;
+    return false;
+}
+
+void Model::setSubmeshVisible(std::size_t index, bool visible) {
+    if ( index >= this->submeshes.size() ) {
+        std::cerr << "[Model:setSubmeshVisible] Error: Submesh index out of range." << std::endl;
+        return;
+    }
+
+    if ( this->submeshes[index].visible == visible ) return;
+    this->submeshes[index].visible = visible;
+    this->drawsChanged = true;
+}
+
+bool Model::isSubmeshVisible(std::size_t index) const {
+    if ( index >= this->submeshes.size() ) return false;
+    return this->submeshes[index].visible;
+}
+
+void Model::buildDraws() {
+    this->drawCounts.clear();
+    this->drawOffsets.clear();
+    this->drawFirst.assign(1, 0);
+
+    //--------------------------------------------------------------------------
+    // The submeshes of a material are contiguous, so a run of visible ones is
+    // one range; all of them visible is a single range per material.
+    //--------------------------------------------------------------------------
+    for ( std::size_t i = 0; i < this->materials.size(); i++ ) {
+        const ModelMaterial& material = this->materials[i];
+        std::size_t last = material.firstSubmesh + material.submeshCount;
+        bool extend = false;
+
+        for ( std::size_t s = material.firstSubmesh; s < last; s++ ) {
+            const ModelSubmesh& submesh = this->submeshes[s];
+            if ( !submesh.visible ) {
+                extend = false;
+                continue;
+            }
+
+            if ( extend ) this->drawCounts.back() += static_cast<GLsizei>(submesh.indexCount);
+            else {
+                this->drawCounts.push_back(static_cast<GLsizei>(submesh.indexCount));
+                this->drawOffsets.push_back(BUFFER_OFFSET(submesh.firstIndex * this->indexSize));
+            }
+
+            extend = true;
+        }
+
+        this->drawFirst.push_back(this->drawCounts.size());
+    }
+
+    //--------------------------------------------------------------------------
+    // Materials sharing a program (and a shader) are drawn one after another.
+    //--------------------------------------------------------------------------
+    this->drawOrder.resize(this->materials.size());
+    for ( std::size_t i = 0; i < this->drawOrder.size(); i++ ) this->drawOrder[i] = i;
+
+    std::vector<const Shader*> shaders(this->materials.size());
+    for ( std::size_t i = 0; i < this->materials.size(); i++ )
+        shaders[i] = this->getMaterialShader(i);
+
+    std::stable_sort(this->drawOrder.begin(), this->drawOrder.end(), [&shaders](std::size_t a, std::size_t b) {
+        unsigned int programA = (shaders[a] != nullptr) ? shaders[a]->programId : 0;
+        unsigned int programB = (shaders[b] != nullptr) ? shaders[b]->programId : 0;
+        if ( programA != programB ) return programA < programB;
+        return shaders[a] < shaders[b];
+    });
+
+    this->drawsChanged = false;
+}
+
+void Model::render(const Cameraf& camera, const Vector3f& lightPosition) {
+    if ( this->vao == 0 ) return;
+    if ( this->drawsChanged ) this->buildDraws();
+
+    Matrix4f modelView = Matrix4f::Multiply(this->transform.toMatrix(), camera.getViewMatrix());
+    GLState::BindVertexArray(this->vao);
+
+    const Shader* current = nullptr;
+    for ( std::size_t i = 0; i < this->drawOrder.size(); i++ ) {
+        std::size_t index = this->drawOrder[i];
+        std::size_t first = this->drawFirst[index];
+        std::size_t count = this->drawFirst[index + 1] - first;
+        if ( count == 0 ) continue;
+
+        const Shader* materialShader = this->getMaterialShader(index);
+        if ( materialShader == nullptr ) continue;
+
+        if ( current == nullptr || current->programId != materialShader->programId ) {
+            GLState::UseProgram(materialShader->programId);
+            materialShader->uniformMatrix("projectionMatrix", camera.getProjectionMatrix());
+            materialShader->uniformMatrix("modelViewMatrix", modelView);
+            materialShader->uniformNormalMatrix(modelView);
+            materialShader->uniformVector("lightPosition", lightPosition);
+        }
+
+        if ( current != materialShader ) {
+            materialShader->bindTextures();
+            materialShader->bindLayer();
+        }
+
+        current = materialShader;
+        glMultiDrawElements(GL_TRIANGLES, &this->drawCounts[first], this->indexType, &this->drawOffsets[first], static_cast<GLsizei>(count));
+        GLState::Count(GLState::DRAW);
+    }
+
+    if ( current != nullptr ) GLState::UseProgram(0);
+}
+
+//------------------------------------------------------------------------------
+// A material with textures from its library is drawn with a copy of the model
+// shader holding them; the copies share the program, so a RenderQueue or the
+// draw order of render still groups them with the model shader.
+//------------------------------------------------------------------------------
+void Model::createLibraryShaders() {
+    for ( std::size_t i = 0; i < this->materials.size(); i++ ) {
+        ModelMaterial& material = this->materials[i];
+        material.libraryShader = nullptr;
+        if ( this->shader == nullptr ) continue;
+        if ( material.diffuseTexture == nullptr && material.normalTexture == nullptr && material.specularTexture == nullptr ) continue;
+
+        material.libraryShader = std::make_shared<Shader>(*this->shader);
+        if ( material.diffuseTexture != nullptr ) material.libraryShader->diffuseTexture = material.diffuseTexture;
+        if ( material.normalTexture != nullptr ) material.libraryShader->normalTexture = material.normalTexture;
+        if ( material.specularTexture != nullptr ) material.libraryShader->specularTexture = material.specularTexture;
+    }
+
+    this->drawsChanged = true;
+}
+
+const Shader* Model::getMaterialShader(std::size_t index) const {
+    const ModelMaterial& material = this->materials[index];
+    if ( material.shader != nullptr ) return material.shader.get();
+    if ( material.libraryShader != nullptr ) return material.libraryShader.get();
+    return this->shader.get();
+}
+
+std::size_t Model::getDrawCount() const {
+    std::size_t count = 0;
+    for ( std::size_t i = 0; i + 1 < this->drawFirst.size(); i++ )
+        if ( this->drawFirst[i + 1] > this->drawFirst[i] ) count++;
+    return count;
+}
+
+std::size_t Model::getDrawRangeCount() const {
+    return this->drawCounts.size();
+}
+
+void Model::computeBounds() {
+    this->boundingBoxMin = Vector3f(0.0f, 0.0f, 0.0f);
+    this->boundingBoxMax = Vector3f(0.0f, 0.0f, 0.0f);
+    this->boundingCenter = Vector3f(0.0f, 0.0f, 0.0f);
+    this->boundingRadius = 0.0f;
+    if ( this->vertices.size() == 0 ) return;
+
+    this->boundingBoxMin = this->vertices[0].position;
+    this->boundingBoxMax = this->vertices[0].position;
+    for ( std::size_t i = 1; i < this->vertices.size(); i++ ) {
+        const Vector3f& p = this->vertices[i].position;
+        for ( unsigned int axis = 0; axis < 3; axis++ ) {
+            this->boundingBoxMin[axis] = std::min(this->boundingBoxMin[axis], p[axis]);
+            this->boundingBoxMax[axis] = std::max(this->boundingBoxMax[axis], p[axis]);
+        }
+    }
+
+    this->boundingCenter = (this->boundingBoxMin + this->boundingBoxMax) * 0.5f;
+    for ( std::size_t i = 0; i < this->vertices.size(); i++ )
+        this->boundingRadius = std::max(this->boundingRadius, static_cast<float>((this->vertices[i].position - this->boundingCenter).length()));
+}
+
+bool Model::constructOnGPU() {
+    //--------------------------------------------------------------------------
+    // One full precision vertex buffer (see VertexFormat) and one element
+    // buffer for all submeshes, recorded in a single vertex array.
+    //--------------------------------------------------------------------------
+    VertexFormat format;
+    std::vector<unsigned char> buffer;
+    if ( !format.pack(this->vertices, buffer) ) return false;
+
+    if ( this->vboVertex == 0 ) glGenBuffers(1, &this->vboVertex);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboVertex);
+    glBufferData(GL_ARRAY_BUFFER, buffer.size(), &buffer[0], GL_STATIC_DRAW);
+
+    if ( this->vao == 0 ) glGenVertexArrays(1, &this->vao);
+    GLState::BindVertexArray(this->vao);
+
+    for ( unsigned int i = 0; i < VertexFormat::ATTRIBUTE_COUNT; i++ ) {
+        const VertexFormat::AttributeLayout& attribute = format.getAttribute(static_cast<VertexFormat::Attribute>(i));
+        glEnableVertexAttribArray(ATTRIBUTE_LOCS[i]);
+        glVertexAttribPointer(ATTRIBUTE_LOCS[i], attribute.componentCount, GL_FLOAT, GL_FALSE, format.getStride(), BUFFER_OFFSET(attribute.offset));
+        GLState::Count(GLState::VERTEX_ATTRIBUTE, 2);
+    }
+
+    //--------------------------------------------------------------------------
+    // Submesh ranges are offsets into one index array, so the indices are
+    // only narrowed when every vertex fits in 16 bits.
+    //--------------------------------------------------------------------------
+    std::size_t indexCount = this->faces.size() * TRIANGLE_EDGE_COUNT;
+    const unsigned int* indices = this->faces[0];
+    std::vector<unsigned short> shortIndices;
+    if ( this->vertices.size() <= MAX_SHORT_INDEX_VERTICES ) {
+        shortIndices.resize(indexCount);
+        for ( std::size_t i = 0; i < indexCount; i++ ) shortIndices[i] = static_cast<unsigned short>(indices[i]);
+        this->indexType = GL_UNSIGNED_SHORT;
+        this->indexSize = sizeof(unsigned short);
+    }
+    else {
+        this->indexType = GL_UNSIGNED_INT;
+        this->indexSize = sizeof(unsigned int);
+    }
+
+    const void* data = (shortIndices.size() > 0) ? static_cast<const void*>(&shortIndices[0]) : static_cast<const void*>(indices);
+    if ( this->vboIndex == 0 ) glGenBuffers(1, &this->vboIndex);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboIndex);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * this->indexSize, data, GL_STATIC_DRAW);
+
+    return true;
+}
+
+void Model::getWorldBoundingSphere(Vector3f& center, float& radius) const {
+    const float* m = this->transform.toMatrix().constData();
+    const Vector3f& c = this->boundingCenter;
+    center = Vector3f(m[0] * c.x() + m[4] * c.y() + m[8] * c.z() + m[12],
+                      m[1] * c.x() + m[5] * c.y() + m[9] * c.z() + m[13],
+                      m[2] * c.x() + m[6] * c.y() + m[10] * c.z() + m[14]);
+
+    const Vector3f& scale = this->transform.getScale();
+    radius = this->boundingRadius * std::max(std::max(std::fabs(scale.x()), std::fabs(scale.y())), std::fabs(scale.z()));
+}
+
+std::string& Model::getName() {
+    return this->name;
+}
+
+const std::string& Model::getName() const {
+    return this->name;
+}
+
+Transformationf& Model::getTransform() {
+    return this->transform;
+}
+
+const Transformationf& Model::getTransform() const {
+    return this->transform;
+}
+
+std::shared_ptr<Shader>& Model::getShader() {
+    return this->shader;
+}
+
+const std::shared_ptr<Shader>& Model::getShader() const {
+    return this->shader;
+}
+
+const std::vector<Vertex>& Model::getVertices() const {
+    return this->vertices;
+}
+
+const std::vector<TriangleFace>& Model::getFaces() const {
+    return this->faces;
+}
+
+const std::vector<ModelSubmesh>& Model::getSubmeshes() const {
+    return this->submeshes;
+}
+
+const std::vector<ModelMaterial>& Model::getMaterials() const {
+    return this->materials;
+}
+
+const Vector3f& Model::getBoundingBoxMin() const {
+    return this->boundingBoxMin;
+}
+
+const Vector3f& Model::getBoundingBoxMax() const {
+    return this->boundingBoxMax;
+}
+
+const Vector3f& Model::getBoundingSphereCenter() const {
+    return this->boundingCenter;
+}
+
+float Model::getBoundingSphereRadius() const {
+    return this->boundingRadius;
+}
+
+const ModelImportStatistics& Model::getImportStatistics() const {
+    return this->statistics;
+}
@@ -0,0 +1,189 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <Transformation.h>
+#include "Mesh.h"
+#include "ObjMesh.h"
+#include "TextureDecodeQueue.h"
+#include "Camera.h"
+
+/*
+ * Faces of one Obj group (or of an object outside any group) that use one
+ * material, as a range of the element buffer of the model.
+ */
+struct ModelSubmesh {
+    std::string name;
+    std::size_t material;
+    std::size_t firstIndex;
+    std::size_t indexCount;
+    bool visible;
+};
+
+/*
+ * Material of a model and the consecutive submeshes that use it, with its
+ * definition from the material library (defined is false if no library
+ * defines it) and the textures of the maps it names. Without a shader of its
+ * own the material is drawn with libraryShader, a copy of the model shader
+ * holding its textures, or with the model shader if it has no textures.
+ */
+struct ModelMaterial {
+    std::string name;
+    std::shared_ptr<Shader> shader;
+    std::size_t firstSubmesh;
+    std::size_t submeshCount;
+
+    ObjMaterial definition;
+    bool defined;
+    std::shared_ptr<Texture> diffuseTexture;
+    std::shared_ptr<Texture> normalTexture;
+    std::shared_ptr<Texture> specularTexture;
+    std::shared_ptr<Shader> libraryShader;
+};
+
+/*
+ * Sizes of the last import and the CPU time of its stages; polygons are the
+ * faces with more than three corners, the triangulation is part of the build.
+ * Textures are the maps of the material libraries; their time is what the
+ * build spent waiting for images and uploading them, the decoding that did
+ * not overlap the parse and the build.
+ */
+struct ModelImportStatistics {
+    std::size_t objectCount;
+    std::size_t submeshCount;
+    std::size_t materialCount;
+    std::size_t faceCount;
+    std::size_t polygonCount;
+    std::size_t triangleCount;
+    std::size_t vertexCount;
+    double parseMilliseconds;
+    double buildMilliseconds;
+    double triangulationMilliseconds;
+    std::size_t textureCount;
+    double textureMilliseconds;
+};
+
+/*
+ * Model: Every object, group and material of an Obj file as one batch.
+ *
+ * build merges the meshes of an ObjFile into one vertex buffer and one
+ * element buffer. The faces are sorted by material, then by object and
+ * group, so every (material, object, group) is a contiguous index range (a
+ * submesh) and the submeshes of a material follow each other. Quads and
+ * polygons are triangulated on the way (see TriangulateObjFaces). Corners are
+ * welded on their position, texture coordinate and normal indices in a hash
+ * table, and the vertices are reordered into the order the sorted faces use
+ * them. Files without normals get smoothed vertex normals. Indices are
+ * 16-bit when the model has at most 65536 vertices.
+ *
+ * Materials are linked to their definitions in the material libraries of
+ * the file. load decodes the maps (map_Kd, map_Bump as the normal map and
+ * map_Ks) on background threads from the moment a library is read, and
+ * build creates the textures after the geometry is on the GPU.
+ *
+ * render binds the vertex array once and draws every material with one
+ * glMultiDrawElements call over its visible submeshes (adjacent visible
+ * submeshes merge into one range), so a file with thousands of groups costs
+ * one draw per material rather than one mesh per group. Materials are drawn
+ * grouped by program and the per-frame uniforms are set on every program
+ * change.
+ */
+class Model {
+public:
+    Model();
+    virtual ~Model();
+
+    /*
+     * Parses the Obj file and builds the model from it. build takes the
+     * textures of the materials from the queue the file was loaded with, or
+     * queues them itself without one.
+     */
+    bool load(const std::string& filename);
+    bool build(const ObjFile& file, TextureDecodeQueue* textures = nullptr);
+
+    bool loadShader(const std::string& vertexFilename, const std::string& fragmentFilename);
+    void setShader(const std::shared_ptr<Shader>& shader);
+
+    /* Draws the named material with its own shader (nullptr for the default). */
+    bool setMaterialShader(const std::string& material, const std::shared_ptr<Shader>& shader);
+
+    /* Hidden submeshes are left out of the multi-draws of their material. */
+    void setSubmeshVisible(std::size_t index, bool visible);
+    bool isSubmeshVisible(std::size_t index) const;
+
+    /*
+     * Draws the visible submeshes with the transformation of the model. The
+     * shaders get the uniforms projectionMatrix, modelViewMatrix,
+     * lightPosition and normalMatrix (see Shader::uniformNormalMatrix).
+     */
+    void render(const Cameraf& camera, const Vector3f& lightPosition);
+
+    /* Number of glMultiDrawElements calls and index ranges render makes. */
+    std::size_t getDrawCount() const;
+    std::size_t getDrawRangeCount() const;
+
+    void getWorldBoundingSphere(Vector3f& center, float& radius) const;
+
+    std::string& getName();
+    const std::string& getName() const;
+    Transformationf& getTransform();
+    const Transformationf& getTransform() const;
+    std::shared_ptr<Shader>& getShader();
+    const std::shared_ptr<Shader>& getShader() const;
+    const std::vector<Vertex>& getVertices() const;
+    const std::vector<TriangleFace>& getFaces() const;
+    const std::vector<ModelSubmesh>& getSubmeshes() const;
+    const std::vector<ModelMaterial>& getMaterials() const;
+    const Vector3f& getBoundingBoxMin() const;
+    const Vector3f& getBoundingBoxMax() const;
+    const Vector3f& getBoundingSphereCenter() const;
+    float getBoundingSphereRadius() const;
+    const ModelImportStatistics& getImportStatistics() const;
+
+protected:
+    bool constructOnGPU();
+    void computeBounds();
+    void buildDraws();
+    void createLibraryShaders();
+    const Shader* getMaterialShader(std::size_t index) const;
+
+protected:
+    Transformationf transform;
+
+    std::string name;
+    std::vector<Vertex> vertices;
+    std::vector<TriangleFace> faces;
+    std::shared_ptr<Shader> shader;
+
+    /* Submeshes sorted by material, and the materials in the order of first use */
+    std::vector<ModelSubmesh> submeshes;
+    std::vector<ModelMaterial> materials;
+
+    /*
+     * Index ranges of the visible submeshes, material after material; the
+     * ranges of material i are [drawFirst[i], drawFirst[i + 1]). The
+     * materials are drawn in drawOrder, sorted by program.
+     */
+    std::vector<GLsizei> drawCounts;
+    std::vector<const GLvoid*> drawOffsets;
+    std::vector<std::size_t> drawFirst;
+    std::vector<std::size_t> drawOrder;
+    bool drawsChanged;
+
+    Vector3f boundingBoxMin;
+    Vector3f boundingBoxMax;
+    Vector3f boundingCenter;
+    float boundingRadius;
+
+    ModelImportStatistics statistics;
+
+    unsigned int vboVertex;
+    unsigned int vboIndex;
+    unsigned int vao;
+    GLenum indexType;
+    std::size_t indexSize;
+};
+
+#endif
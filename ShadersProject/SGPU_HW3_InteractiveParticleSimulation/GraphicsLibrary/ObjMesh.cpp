@@ -24,12 +24,13 @@
  * THE SOFTWARE.
  */
 #include "ObjMesh.h"
+#include "TextureDecodeQueue.h"
+#include "ObjWriter.h"
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
-#include <iomanip>
 
 
 /* Constants specified by the Wavefront Obj file format. */
@@ -45,6 +46,17 @@ static const std::string OBJ_VERTEX = "v";
 static const std::string OBJ_MATERIAL_LIBRARY = "mtllib";
 static const std::string OBJ_USE_MATERIAL = "usemtl";
 
+/* Constants specified by the Wavefront Mtl file format. */
+static const std::string MTL_NEW_MATERIAL = "newmtl";
+static const std::string MTL_DIFFUSE_COLOR = "Kd";
+static const std::string MTL_SPECULAR_COLOR = "Ks";
+static const std::string MTL_SHININESS = "Ns";
+static const std::string MTL_DIFFUSE_MAP = "map_Kd";
+static const std::string MTL_SPECULAR_MAP = "map_Ks";
+static const std::string MTL_BUMP_MAP = "map_Bump";
+static const std::string MTL_BUMP_MAP_LOWER = "map_bump";
+static const std::string MTL_BUMP = "bump";
+
 /* Default names for groups and materials if they are not specified. */
 static const std::string OBJ_NO_MESH_NAME = "DefaultName";
 static const std::string OBJ_NO_MATERIAL = "DefaultMaterial";
@@ -54,10 +66,15 @@ static const char OBJ_DELIMITER_CHAR = ' ';
 static const char OBJ_NODE_DELIMITER = '/';
 static const char OBJ_COMMENT = '#';
 
-static const unsigned int OBJ_PRECISION = 6u;
 static const int OBJ_INDEX_OFFSET = 1;
 static const int OBJ_INVALID_FACE_INDEX = -1;
 
+ObjMaterial::ObjMaterial() {
+    this->diffuseColor = Vector3f(0.8f, 0.8f, 0.8f);
+    this->specularColor = Vector3f(0.0f, 0.0f, 0.0f);
+    this->shininess = 0.0f;
+}
+
 ObjFile::ObjFile() {}
 ObjFile::~ObjFile() {}
 
@@ -88,8 +105,9 @@ std::size_t ObjFile::addGroup(const std::string& groupName) {
         return 0u;
     }
 
-    this->groups.insert(std::make_pair(this->groups.size() - 1, groupName));
-    return this->groups.size() - 1;
+    std::size_t index = this->groups.size();
+    if ( !this->addGroup(index, groupName) ) return 0u;
+    return index;
 }
 
 std::size_t ObjFile::addMaterial(const std::string& materialName) {
@@ -98,8 +116,9 @@ std::size_t ObjFile::addMaterial(const std::string& materialName) {
         return 0u;
     }
 
-    this->materials.insert(std::make_pair(this->materials.size() - 1, materialName));
-    return this->materials.size() - 1;
+    std::size_t index = this->materials.size();
+    if ( !this->addMaterial(index, materialName) ) return 0u;
+    return index;
 }
 
 bool ObjFile::addGroup(std::size_t index, const std::string& groupName) {
@@ -116,6 +135,7 @@ bool ObjFile::addGroup(std::size_t index, const std::string& groupName) {
     }
 
     this->groups.insert(std::make_pair(index, groupName));
+    this->groupIndices.insert(std::make_pair(groupName, index));
     return true;
 }
 
@@ -130,11 +150,60 @@ bool ObjFile::addMaterial(std::size_t index, const std::string& name) {
         return false;
     }
 
-
     this->materials.insert(std::make_pair(index, name));
+    this->materialIndices.insert(std::make_pair(name, index));
     return true;
 }
 
+bool ObjFile::loadMaterialLibrary(const std::string& libraryName, TextureDecodeQueue* textures) {
+    std::string filename = libraryName;
+    bool relative = libraryName.length() > 0 && libraryName[0] != '/' && libraryName[0] != '\\' && libraryName.find(':') == std::string::npos;
+    if ( relative ) filename = this->directory + libraryName;
+
+    std::vector<ObjMaterial> definitions;
+    if ( !LoadObjMaterialLibrary(filename, definitions) ) {
+        std::cerr << "[ObjFile:loadMaterialLibrary] Error: Could not read material library: " << filename << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // The maps are queued right away; the queue decodes them while the
+    // caller goes on parsing.
+    //--------------------------------------------------------------------------
+    for ( std::size_t i = 0; i < definitions.size(); i++ ) {
+        if ( !this->materialDefinitions.insert(std::make_pair(definitions[i].name, definitions[i])).second ) continue;
+        if ( textures == nullptr ) continue;
+
+        textures->queue(definitions[i].diffuseMap);
+        textures->queue(definitions[i].bumpMap);
+        textures->queue(definitions[i].specularMap);
+    }
+
+    return true;
+}
+
+bool ObjFile::findGroup(const std::string& name, std::size_t& index) const {
+    std::map<std::string, std::size_t>::const_iterator found = this->groupIndices.find(name);
+    if ( found == this->groupIndices.end() ) return false;
+
+    index = found->second;
+    return true;
+}
+
+bool ObjFile::findMaterial(const std::string& name, std::size_t& index) const {
+    std::map<std::string, std::size_t>::const_iterator found = this->materialIndices.find(name);
+    if ( found == this->materialIndices.end() ) return false;
+
+    index = found->second;
+    return true;
+}
+
+const ObjMaterial* ObjFile::findMaterialDefinition(const std::string& name) const {
+    std::map<std::string, ObjMaterial>::const_iterator found = this->materialDefinitions.find(name);
+    if ( found == this->materialDefinitions.end() ) return nullptr;
+    return &found->second;
+}
+
 /* Parse a 3-component vector from the provided stream: 1.0 2.0 3.0 */
 inline bool Parse_Obj_Vector(std::istringstream& argumentStream, Vector3f& vector) {
     argumentStream >> vector.x();
@@ -212,25 +281,34 @@ bool Parse_Obj_Group(ObjFile* const objFile, std::istringstream& argumentStream,
     std::string groupName;
     std::getline(argumentStream, groupName, OBJ_DELIMITER_CHAR);
     
+    //--------------------------------------------------------------------------
+    // The faces that follow belong to the named group. Files switch back and
+    // forth between groups, a name seen before keeps its index.
+    //--------------------------------------------------------------------------
     if ( groupName.length() != 0 ) {
-        objFile->addGroup(curGroupIndex, groupName);
+        if ( !objFile->findGroup(groupName, curGroupIndex) ) curGroupIndex = objFile->addGroup(groupName);
         objFile->getMesh(objFile->size() - 1)->name = groupName;
-        curGroupIndex++;
     }
 
     return true;
 }
 
-bool Parse_Obj_MaterialLibrary(ObjFile* const objFile, std::istringstream& argumentStream) {
+bool Parse_Obj_MaterialLibrary(ObjFile* const objFile, std::istringstream& argumentStream, TextureDecodeQueue* textures) {
     if ( objFile == nullptr ) return false;
 
+    //--------------------------------------------------------------------------
+    // A line can name several libraries. A library that cannot be read only
+    // leaves its materials undefined, the geometry is still loaded.
+    //--------------------------------------------------------------------------
     std::string libraryName;
-    std::getline(argumentStream, libraryName, OBJ_DELIMITER_CHAR);
-
-    if ( libraryName.length() != 0 ) objFile->addMaterialLibrary(libraryName);
-    else return false;
+    std::size_t libraryCount = 0;
+    while ( argumentStream >> libraryName ) {
+        objFile->addMaterialLibrary(libraryName);
+        objFile->loadMaterialLibrary(libraryName, textures);
+        libraryCount++;
+    }
 
-    return true;
+    return libraryCount > 0;
 }
 
 bool Parse_Obj_Material(ObjFile* const objFile, std::istringstream& argumentStream, std::size_t& curMaterialIndex) {
@@ -240,8 +318,7 @@ bool Parse_Obj_Material(ObjFile* const objFile, std::istringstream& argumentStre
     std::getline(argumentStream, materialName, OBJ_DELIMITER_CHAR);
     
     if ( materialName.length() != 0 ) {
-        curMaterialIndex++;
-        objFile->addGroup(curMaterialIndex, materialName);
+        if ( !objFile->findMaterial(materialName, curMaterialIndex) ) curMaterialIndex = objFile->addMaterial(materialName);
     }
     else return false;
     
@@ -379,7 +456,7 @@ bool Parse_Obj_Face(ObjFile* const objFile, std::istringstream& argumentStream,
  * on the identifier of the line, the corresponding function will be called to
  * parse the required components and store them into the provided Obj file.
  */
-bool Parse_ObjFileLine(ObjFile* const objFile, const std::string& line, std::size_t& curGroupIndex, std::size_t& curSmoothingGroupIndex, std::size_t& curMaterialIndex) {
+bool Parse_ObjFileLine(ObjFile* const objFile, const std::string& line, std::size_t& curGroupIndex, std::size_t& curSmoothingGroupIndex, std::size_t& curMaterialIndex, TextureDecodeQueue* textures) {
     if ( line.length() == 0 ) return true;
 
     std::string id, arguments;
@@ -400,14 +477,14 @@ bool Parse_ObjFileLine(ObjFile* const objFile, const std::string& line, std::siz
     else if ( id.compare(OBJ_SMOOTHING_GROUP) == 0 ) return Parse_Obj_SmoothingGroup(objFile, argumentStream, curSmoothingGroupIndex);
     else if ( id.compare(OBJ_GROUP) == 0 ) return Parse_Obj_Group(objFile, argumentStream, curGroupIndex);
     else if ( id.compare(OBJ_OBJECT) == 0 ) return Parse_Obj_Object(objFile, argumentStream, curSmoothingGroupIndex);
-    else if ( id.compare(OBJ_MATERIAL_LIBRARY) == 0 ) return Parse_Obj_MaterialLibrary(objFile, argumentStream);
+    else if ( id.compare(OBJ_MATERIAL_LIBRARY) == 0 ) return Parse_Obj_MaterialLibrary(objFile, argumentStream, textures);
     else if ( id.compare(OBJ_USE_MATERIAL) == 0 ) return Parse_Obj_Material(objFile, argumentStream, curMaterialIndex);
     else std::cerr << "[ObjFile:Parse_ObjFileLine] Warning: Encountered an unrecognized OBJ file line. Ignoring Command." << std::endl;
 
     return true;
 }
 
-bool ObjFile::load(const std::string& filename) {
+bool ObjFile::load(const std::string& filename, TextureDecodeQueue* textures) {
     if ( filename.length() == 0 ) {
         std::cerr << "[ObjFile:load] Error: Invalid filename of length 0." << std::endl;
         return false;
@@ -424,14 +501,17 @@ bool ObjFile::load(const std::string& filename) {
     std::size_t curSmoothingGroupIndex = 0u;
     std::size_t curMaterialIndex = 0u;
 
-    this->materials.insert(std::make_pair(curMaterialIndex, OBJ_NO_MATERIAL));
-    this->groups.insert(std::make_pair(curGroupIndex, OBJ_NO_GROUP));
+    this->addMaterial(curMaterialIndex, OBJ_NO_MATERIAL);
+    this->addGroup(curGroupIndex, OBJ_NO_GROUP);
+
+    std::size_t separator = filename.find_last_of("/\\");
+    this->directory = (separator == std::string::npos) ? std::string() : filename.substr(0, separator + 1);
 
     //--------------------------------------------------------------------------
     // Parses the Obj file line-by-line.
     //--------------------------------------------------------------------------
     while ( std::getline(file, line) ) {
-        if ( !Parse_ObjFileLine(this, line, curGroupIndex, curSmoothingGroupIndex, curMaterialIndex) ) {
+        if ( !Parse_ObjFileLine(this, line, curGroupIndex, curSmoothingGroupIndex, curMaterialIndex, textures) ) {
             std::cout << "[ObjFile:load] Error: Failed to parse an OBJ file line and cannot recover." << std::endl;
 			std::cout << "  Aborting OBJ file parsing process at line: " << line << std::endl;
 			return false;
@@ -447,9 +527,8 @@ bool ObjFile::load(const std::string& filename) {
  * included in a comment.
  */
 bool Save_Obj_Header(std::ostream& out) {
-    out << "# CG Library Wavefront Obj Version 1.0 April 2015" << std::endl;
-	out << std::endl;
-	return true;
+    out << "# CG Library Wavefront Obj Version 1.0 April 2015\n\n";
+    return true;
 }
 
 /* 
@@ -459,144 +538,147 @@ bool Save_Obj_Header(std::ostream& out) {
 bool Save_Obj_MaterialLibraries(std::ostream& out, const StringArray& materialLibraries) {
     if ( materialLibraries.size() == 0 ) return true;
 
-    out << "# Obj Material Libraries" << std::endl;
+    out << "# Obj Material Libraries\n";
     for ( unsigned int i = 0; i < materialLibraries.size(); i++ )
-        out << OBJ_MATERIAL_LIBRARY << OBJ_DELIMITER << materialLibraries[i] << std::endl;
-    out << std::endl;
+        out << OBJ_MATERIAL_LIBRARY << OBJ_DELIMITER << materialLibraries[i] << "\n";
+    out << "\n";
     return true;
 }
 
 /*
- * Save all of the provided meshes texture coordinates to the provided stream.
- * Ex: for each texture coordinate
- *         vt 1.0 1.0 0.0
- *     # n texture coordinates
+ * Save the provided vectors as lines of the given type to the provided stream.
+ * The lines are formatted in parallel ranges (see WriteFormattedLines).
+ * Ex: for each vector
+ *         v 1.5 2 0.25
+ *     # n vertices
  */
-bool Save_ObjMesh_TextureCoords(std::ostream& out, const std::shared_ptr<ObjMesh>& mesh) {
-    for ( unsigned int i = 0; i < mesh->textureCoordinates.size(); i++ ) {
-        out << OBJ_VERTEX_TEXTURE 
-            << OBJ_DELIMITER 
-            << mesh->textureCoordinates[i].x() 
-            << OBJ_DELIMITER 
-            << mesh->textureCoordinates[i].y() 
-            << OBJ_DELIMITER 
-            << mesh->textureCoordinates[i].z() 
-            << std::endl;      
-    }
-
-    if ( mesh->textureCoordinates.size() > 0 ) {
-        out << "# " << mesh->textureCoordinates.size() << " texture coordinates" << std::endl;
-        out << std::endl;
-    }
+bool Save_ObjMesh_Vectors(std::ostream& out, const std::string& id, const std::vector<Vector3f>& vectors, const std::string& description) {
+    bool written = WriteFormattedLines(out, vectors.size(), [&id, &vectors](std::size_t begin, std::size_t end, std::string& text) {
+        for ( std::size_t i = begin; i < end; i++ ) {
+            text.append(id);
+            text.push_back(OBJ_DELIMITER_CHAR);
+            AppendFloat(text, vectors[i].x());
+            text.push_back(OBJ_DELIMITER_CHAR);
+            AppendFloat(text, vectors[i].y());
+            text.push_back(OBJ_DELIMITER_CHAR);
+            AppendFloat(text, vectors[i].z());
+            text.push_back('\n');
+        }
+    });
 
-    return true;
+    if ( vectors.size() > 0 ) out << "# " << vectors.size() << " " << description << "\n\n";
+    return written;
 }
 
-/* 
- * Save all of the provided meshes normals to the provided out stream.
- * Ex: for each normal:
- *         vn 1.0 2.0 3.0
- *     # n vertex normals
- */
-bool Save_ObjMesh_Normals(std::ostream& out, const std::shared_ptr<ObjMesh>& mesh) {
-    for ( unsigned int i = 0; i < mesh->normals.size(); i++ ) {
-        out << OBJ_VERTEX_NORMAL 
-            << OBJ_DELIMITER 
-            << mesh->normals[i].x() 
-            << OBJ_DELIMITER 
-            << mesh->normals[i].y() 
-            << OBJ_DELIMITER 
-            << mesh->normals[i].z() 
-            << std::endl;
-    }
-
-    if ( mesh->normals.size() > 0 ) {
-        out << "# " << mesh->normals.size() << " vertex normals" << std::endl;
-        out << std::endl;
-    }
+/* Flags of the group, material and smoothing group lines written before a face. */
+static const unsigned char OBJ_WRITE_GROUP = 1;
+static const unsigned char OBJ_WRITE_MATERIAL = 2;
+static const unsigned char OBJ_WRITE_SMOOTHING_GROUP = 4;
 
-    return true;
-}
-
-bool Save_ObjMesh_Faces(std::ostream& out, const ObjFile* const objFile, std::shared_ptr<ObjMesh>& mesh, bool saveTextureCoords, bool saveNormals) {
+//------------------------------------------------------------------------------
+// A face redefines its group, material or smoothing group when the index is
+// non-zero and differs from the last one defined. The faces are formatted in
+// independent ranges, so this is decided up front in one pass.
+//------------------------------------------------------------------------------
+void Find_Obj_FaceStateChanges(const std::vector<Obj_Face>& faces, std::vector<unsigned char>& changes) {
+    std::size_t lastGroupIndex = 0;
     std::size_t lastMaterialIndex = 0;
-	std::size_t lastGroupIndex = 0;
-	std::size_t lastSmoothingGroupIndex = 0;
-    std::size_t numFaces = mesh->faces.size();
-	Obj_Face face;
-
-    for ( unsigned int i = 0; i < numFaces; i++ ) {
-		face = mesh->faces[i];
-
-		//----------------------------------------------------------------------
-		// If the face belongs to a group, define the group. If the faces group
-		// index is 0 that means it belongs to no group.
-		//----------------------------------------------------------------------
-		if ( face.groupIndex != 0 && face.groupIndex != lastGroupIndex ) {
-            if ( objFile->getFaceGroup(face.groupIndex).compare(OBJ_NO_GROUP) == 0 )
-                out << OBJ_GROUP << OBJ_DELIMITER << mesh->name << std::endl;
-			else out << OBJ_GROUP << OBJ_DELIMITER << objFile->getFaceGroup(face.groupIndex) << std::endl;
-			lastGroupIndex = face.groupIndex;
-		}
-
-		//----------------------------------------------------------------------
-		// If the face has a material, define the material. If the faces 
-		// material index is 0 that means it has no material.
-		//----------------------------------------------------------------------
-		if ( face.materialIndex != 0 && face.materialIndex != lastMaterialIndex ) {
-			out << OBJ_USE_MATERIAL << OBJ_DELIMITER << objFile->getFaceMaterial(face.groupIndex) << std::endl;
-			lastMaterialIndex = face.materialIndex;
-		}
-
-		//----------------------------------------------------------------------
-		// If a face does not belong to a smoothing group then it is simply not
-		// included.
-		//----------------------------------------------------------------------
-		if ( face.smoothingGroupIndex != 0 && face.smoothingGroupIndex != lastSmoothingGroupIndex ) {
-			out << OBJ_SMOOTHING_GROUP << OBJ_DELIMITER << face.smoothingGroupIndex << std::endl;
-			lastSmoothingGroupIndex = face.smoothingGroupIndex;
-		}
+    std::size_t lastSmoothingGroupIndex = 0;
+    changes.assign(faces.size(), 0);
+
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        const Obj_Face& face = faces[i];
+        if ( face.groupIndex != 0 && face.groupIndex != lastGroupIndex ) {
+            changes[i] |= OBJ_WRITE_GROUP;
+            lastGroupIndex = face.groupIndex;
+        }
 
-		//----------------------------------------------------------------------
-		// Write the face indices of the face. Vertices are required, therefore
-		// the size of that index array is used for indexing through all of the
-		// indice arrays.
-		//----------------------------------------------------------------------
-		out << OBJ_FACE << OBJ_DELIMITER;
-		for ( unsigned int i = 0; i < face.vertexIndices.size(); i++ ) {
-			//------------------------------------------------------------------
-			// Depending on which vertex components are included (normal, 
-			// texture coordinate), write the proper definition of each face 
-			// node.
-			//------------------------------------------------------------------
-			out << face.vertexIndices[i] + OBJ_INDEX_OFFSET;
-			if ( saveTextureCoords == true && saveNormals == true ) {
-				if ( face.textureIndices.size() > 0 && face.normalIndices.size() > 0 )
-					out << OBJ_NODE_DELIMITER << face.textureIndices[i] + OBJ_INDEX_OFFSET << OBJ_NODE_DELIMITER << face.normalIndices[i] + OBJ_INDEX_OFFSET;
-				else if ( face.textureIndices.size() > 0 && face.normalIndices.size() == 0 )
-					out << OBJ_NODE_DELIMITER << face.textureIndices[i] + OBJ_INDEX_OFFSET;
-			}
-			else if ( saveTextureCoords == true && saveNormals == false ) {
-				if ( face.textureIndices.size() > 0 )
-					out << OBJ_NODE_DELIMITER << face.textureIndices[i] + OBJ_INDEX_OFFSET;
-			}
-			else {
-				if ( face.normalIndices.size() > 0 )
-					out << OBJ_NODE_DELIMITER << OBJ_NODE_DELIMITER << face.normalIndices[i] + OBJ_INDEX_OFFSET;
-			}
-			
-			out << OBJ_DELIMITER;
-		}
+        if ( face.materialIndex != 0 && face.materialIndex != lastMaterialIndex ) {
+            changes[i] |= OBJ_WRITE_MATERIAL;
+            lastMaterialIndex = face.materialIndex;
+        }
 
-        out << std::endl;
+        if ( face.smoothingGroupIndex != 0 && face.smoothingGroupIndex != lastSmoothingGroupIndex ) {
+            changes[i] |= OBJ_WRITE_SMOOTHING_GROUP;
+            lastSmoothingGroupIndex = face.smoothingGroupIndex;
+        }
     }
+}
 
-    if ( mesh->faces.size() > 0 ) {
-        out << "# " << mesh->faces.size() << " faces" << std::endl;
-        out << std::endl;
-    }
+/* Appends a face node: vtx, vtx/tex, vtx//n or vtx/tex/n (1-based). */
+inline void Append_Obj_Node(std::string& text, const Obj_Face& face, std::size_t i, bool textureCoords, bool normals) {
+    AppendUInt(text, face.vertexIndices[i] + OBJ_INDEX_OFFSET);
+    if ( !textureCoords && !normals ) return;
+
+    text.push_back(OBJ_NODE_DELIMITER);
+    if ( textureCoords ) AppendUInt(text, face.textureIndices[i] + OBJ_INDEX_OFFSET);
+
+    if ( normals ) {
+        text.push_back(OBJ_NODE_DELIMITER);
+        AppendUInt(text, face.normalIndices[i] + OBJ_INDEX_OFFSET);
+    }
+}
+
+bool Save_ObjMesh_Faces(std::ostream& out, const ObjFile* const objFile, const std::shared_ptr<ObjMesh>& mesh, bool saveTextureCoords, bool saveNormals) {
+    const std::vector<Obj_Face>& faces = mesh->faces;
+    std::vector<unsigned char> changes;
+    Find_Obj_FaceStateChanges(faces, changes);
+
+    bool written = WriteFormattedLines(out, faces.size(), [&](std::size_t begin, std::size_t end, std::string& text) {
+        for ( std::size_t f = begin; f < end; f++ ) {
+            const Obj_Face& face = faces[f];
+
+            //------------------------------------------------------------------
+            // If the face belongs to a group, define the group. If the faces
+            // group index is 0 that means it belongs to no group.
+            //------------------------------------------------------------------
+            if ( changes[f] & OBJ_WRITE_GROUP ) {
+                std::string group = objFile->getFaceGroup(face.groupIndex);
+                text.append(OBJ_GROUP);
+                text.push_back(OBJ_DELIMITER_CHAR);
+                text.append(group.compare(OBJ_NO_GROUP) == 0 ? mesh->name : group);
+                text.push_back('\n');
+            }
+
+            //------------------------------------------------------------------
+            // If the face has a material, define the material. If the faces 
+            // material index is 0 that means it has no material.
+            //------------------------------------------------------------------
+            if ( changes[f] & OBJ_WRITE_MATERIAL ) {
+                text.append(OBJ_USE_MATERIAL);
+                text.push_back(OBJ_DELIMITER_CHAR);
+                text.append(objFile->getFaceMaterial(face.materialIndex));
+                text.push_back('\n');
+            }
+
+            //------------------------------------------------------------------
+            // If a face does not belong to a smoothing group then it is simply
+            // not included.
+            //------------------------------------------------------------------
+            if ( changes[f] & OBJ_WRITE_SMOOTHING_GROUP ) {
+                text.append(OBJ_SMOOTHING_GROUP);
+                text.push_back(OBJ_DELIMITER_CHAR);
+                AppendUInt(text, face.smoothingGroupIndex);
+                text.push_back('\n');
+            }
+
+            //------------------------------------------------------------------
+            // Write the face indices of the face. Vertices are required,
+            // therefore the size of that index array is used for indexing
+            // through all of the indice arrays.
+            //------------------------------------------------------------------
+            text.append(OBJ_FACE);
+            for ( std::size_t i = 0; i < face.vertexIndices.size(); i++ ) {
+                text.push_back(OBJ_DELIMITER_CHAR);
+                Append_Obj_Node(text, face, i, saveTextureCoords && face.textureIndices.size() > 0, saveNormals && face.normalIndices.size() > 0);
+            }
+
+            text.push_back('\n');
+        }
+    });
 
-    return true;
+    if ( faces.size() > 0 ) out << "# " << faces.size() << " faces\n\n";
+    return written;
 }
 
 /*
@@ -621,34 +703,20 @@ bool Save_ObjMeshes(std::ostream& out, const ObjFile* const objFile, bool saveTe
     //--------------------------------------------------------------------------
     // For each mesh within the Obj file, save it to the provided out stream.
     //--------------------------------------------------------------------------
-    for ( unsigned int i = 0; i < objFile->size(); i++ ) {
-        std::shared_ptr<ObjMesh>& mesh = objFile->getMesh(i);
-        bool saveMeshTextureCoords = saveTextureCoords;
-        bool saveMeshNormals = saveNormals;
-
-        for ( unsigned int i = 0; i < mesh->vertices.size(); i++ ) {
-		    out << OBJ_VERTEX 
-                << OBJ_DELIMITER 
-                << mesh->vertices[i].x() 
-                << OBJ_DELIMITER 
-                << mesh->vertices[i].y() 
-                << OBJ_DELIMITER 
-                << mesh->vertices[i].z() 
-                << std::endl;
-        }
+    bool written = true;
+    for ( unsigned int i = 0; i < objFile->size() && written; i++ ) {
+        std::shared_ptr<ObjMesh> mesh = objFile->getMesh(i);
+        bool saveMeshTextureCoords = saveTextureCoords && mesh->textureCoordinates.size() > 0;
+        bool saveMeshNormals = saveNormals && mesh->normals.size() > 0;
 
-	    out << "# " << mesh->vertices.size() << " vertices" << std::endl;
-	    out << std::endl;
-
-        if ( mesh->textureCoordinates.size() == 0 ) saveMeshTextureCoords = false;
-        if ( mesh->normals.size() == 0 ) saveMeshNormals = false;
-
-        if ( saveMeshTextureCoords == true ) Save_ObjMesh_TextureCoords(out, mesh);
-        if ( saveMeshNormals == true ) Save_ObjMesh_Normals(out, mesh);
-        Save_ObjMesh_Faces(out, objFile, mesh, saveMeshTextureCoords, saveMeshNormals);
+        written = Save_ObjMesh_Vectors(out, OBJ_VERTEX, mesh->vertices, "vertices");
+        if ( mesh->vertices.size() == 0 ) out << "# 0 vertices\n\n";
+        if ( saveMeshTextureCoords ) written = written && Save_ObjMesh_Vectors(out, OBJ_VERTEX_TEXTURE, mesh->textureCoordinates, "texture coordinates");
+        if ( saveMeshNormals ) written = written && Save_ObjMesh_Vectors(out, OBJ_VERTEX_NORMAL, mesh->normals, "vertex normals");
+        written = written && Save_ObjMesh_Faces(out, objFile, mesh, saveMeshTextureCoords, saveMeshNormals);
     }
 
-    return true;
+    return written;
 }
 
 bool ObjFile::save(const std::string& filename, bool saveTextureCoords, bool saveNormals) {
@@ -657,9 +725,14 @@ bool ObjFile::save(const std::string& filename, bool saveTextureCoords, bool sav
         return false;
     }
 
+    //--------------------------------------------------------------------------
+    // The lines are formatted in blocks and written through a large buffer;
+    // nothing is flushed before the file is closed.
+    //--------------------------------------------------------------------------
+    std::vector<char> buffer(OBJ_WRITER_BUFFER_SIZE);
     std::ofstream out;
+    out.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
     out.open(filename.c_str());
-    out << std::fixed << std::setprecision(OBJ_PRECISION);
 
     if ( out.is_open() == false ) {
         std::cerr << "[ObjFile:save] Error: Could not open file: " << filename << std::endl;
@@ -671,9 +744,14 @@ bool ObjFile::save(const std::string& filename, bool saveTextureCoords, bool sav
     //--------------------------------------------------------------------------
     Save_Obj_Header(out);
     Save_Obj_MaterialLibraries(out, this->materialLibraries);
-    Save_ObjMeshes(out, this, saveTextureCoords, saveNormals);
+    bool written = Save_ObjMeshes(out, this, saveTextureCoords, saveNormals);
 
     out.close();
+    if ( !written || out.fail() ) {
+        std::cerr << "[ObjFile:save] Error: Could not write file: " << filename << std::endl;
+        return false;
+    }
+
     return true;
 }
 
@@ -813,6 +891,10 @@ const StringArray& ObjFile::getMaterialLibraries() const {
     return this->materialLibraries;
 }
 
+const std::map<std::string, ObjMaterial>& ObjFile::getMaterialDefinitions() const {
+    return this->materialDefinitions;
+}
+
 bool LoadObjMesh(const std::string& filename, std::shared_ptr<ObjMesh>& mesh) {
     ObjFile file;
 
@@ -828,4 +910,57 @@ bool LoadObjMesh(const std::string& filename, std::shared_ptr<ObjMesh>& mesh) {
 
     mesh = file.getMesh(0);
     return true;
-}
\ No newline at end of file
+}
+
+/*
+ * The file of a map statement is its last argument; the options before it
+ * (-bm 1.0, -clamp on, ...) are skipped.
+ */
+std::string Parse_Mtl_Map(std::istringstream& argumentStream, const std::string& directory) {
+    std::string token, filename;
+    while ( argumentStream >> token ) filename = token;
+
+    if ( filename.length() == 0 ) return filename;
+    if ( filename[0] == '/' || filename[0] == '\\' || filename.find(':') != std::string::npos ) return filename;
+    return directory + filename;
+}
+
+bool LoadObjMaterialLibrary(const std::string& filename, std::vector<ObjMaterial>& materials) {
+    std::ifstream file(filename.c_str());
+    if ( file.is_open() == false ) return false;
+
+    std::size_t separator = filename.find_last_of("/\\");
+    std::string directory = (separator == std::string::npos) ? std::string() : filename.substr(0, separator + 1);
+
+    //--------------------------------------------------------------------------
+    // Statements before the first newmtl have no material and are ignored,
+    // as are the statements this loader does not use (Ka, d, illum, ...).
+    //--------------------------------------------------------------------------
+    std::string line, id;
+    while ( std::getline(file, line) ) {
+        if ( line.length() > 0 && line[line.length() - 1] == '\r' ) line.erase(line.length() - 1);
+
+        std::istringstream argumentStream(line);
+        if ( !(argumentStream >> id) || id[0] == OBJ_COMMENT ) continue;
+
+        if ( id.compare(MTL_NEW_MATERIAL) == 0 ) {
+            materials.push_back(ObjMaterial());
+            argumentStream >> materials.back().name;
+            continue;
+        }
+
+        if ( materials.size() == 0 ) continue;
+        ObjMaterial& material = materials.back();
+
+        if ( id.compare(MTL_DIFFUSE_COLOR) == 0 ) Parse_Obj_Vector(argumentStream, material.diffuseColor);
+        else if ( id.compare(MTL_SPECULAR_COLOR) == 0 ) Parse_Obj_Vector(argumentStream, material.specularColor);
+        else if ( id.compare(MTL_SHININESS) == 0 ) argumentStream >> material.shininess;
+        else if ( id.compare(MTL_DIFFUSE_MAP) == 0 ) material.diffuseMap = Parse_Mtl_Map(argumentStream, directory);
+        else if ( id.compare(MTL_SPECULAR_MAP) == 0 ) material.specularMap = Parse_Mtl_Map(argumentStream, directory);
+        else if ( id.compare(MTL_BUMP_MAP) == 0 || id.compare(MTL_BUMP_MAP_LOWER) == 0 || id.compare(MTL_BUMP) == 0 )
+            material.bumpMap = Parse_Mtl_Map(argumentStream, directory);
+    }
+
+    file.close();
+    return true;
+}
@@ -33,6 +33,8 @@
 #include <Mathematics.h>
 
 struct ObjMesh;
+struct ObjMaterial;
+class TextureDecodeQueue;
 
 /* *.obj Supported geometry face types */
 enum ObjFaceType { TRIANGLE, QUAD, POLYGON };
@@ -43,6 +45,12 @@ enum ObjFaceType { TRIANGLE, QUAD, POLYGON };
  */
 bool LoadObjMesh(const std::string& filename, std::shared_ptr<ObjMesh>& mesh);
 
+/*
+ * Reads the materials of an Obj material library (*.mtl). The map file
+ * names are resolved against the directory of the library.
+ */
+bool LoadObjMaterialLibrary(const std::string& filename, std::vector<ObjMaterial>& materials);
+
 struct Obj_Face {
     ObjFaceType type;
 
@@ -69,6 +77,25 @@ struct ObjMesh {
     std::vector<Obj_Face> faces;
 };
 
+/*
+ * Surface material defined by a material library (newmtl). The colors and
+ * the shininess keep the Mtl defaults (Kd 0.8, Ks 0, Ns 0) if the library
+ * leaves them out; a map without a file is an empty string.
+ */
+struct ObjMaterial {
+    ObjMaterial();
+
+    std::string name;
+
+    Vector3f diffuseColor;
+    Vector3f specularColor;
+    float shininess;
+
+    std::string diffuseMap;
+    std::string bumpMap;
+    std::string specularMap;
+};
+
 typedef std::map<std::size_t, std::string> NameMap;
 typedef std::vector<std::shared_ptr<ObjMesh> > MeshArray;
 typedef std::vector<std::string> StringArray;
@@ -103,6 +130,11 @@ typedef std::vector<std::string> StringArray;
  *
  * # Smoothing Groups
  * s GroupIndex
+ *
+ * # Material Library and Material (newmtl name, Kd, Ks, Ns, map_Kd, map_Bump
+ * # and map_Ks are read from the library)
+ * mtllib Library.mtl
+ * usemtl MaterialName
  */
 class ObjFile {
 public:
@@ -113,14 +145,20 @@ public:
      * Loads a set of Obj mesh definitions from an Obj file.
      * 
      * @param filename - The name of the Obj file to be read (include .obj).
+     * @param textures - If provided, the maps of every material library are
+     * queued for decoding as soon as the library is read, so the images are
+     * decoded while the rest of the file is parsed.
      *
      * @return If the file is successfully loaded from the provided file then
      * this function will return true; otherwise it will return false.
      */
-    bool load(const std::string& filename);
+    bool load(const std::string& filename, TextureDecodeQueue* textures = nullptr);
 
     /*
-     * Saves this definition of set of ObjMeshes as an Obj file.
+     * Saves this definition of set of ObjMeshes as an Obj file. Coordinates
+     * are written as the shortest text that reads back as the same float
+     * (see FormatFloat), and the lines are formatted in parallel blocks (see
+     * WriteFormattedLines).
      *
      * @param filename - The name of the Obj file to be written (include .obj).
      * @param saveTextureCoords - Flag for saving the texture coordinates of
@@ -168,6 +206,19 @@ public:
      */
     std::size_t addMaterialLibrary(const std::string& libraryName);
 
+    /*
+     * Reads the definitions of a material library. A relative name is found
+     * next to the Obj file being loaded. Definitions of a name that is
+     * already defined are ignored.
+     *
+     * @param libraryName - The name of the library (*.mtl).
+     * @param textures - Queue receiving the maps of the new definitions.
+     *
+     * @return If the library can be read, then this function will return
+     * true; otherwise it will return false.
+     */
+    bool loadMaterialLibrary(const std::string& libraryName, TextureDecodeQueue* textures = nullptr);
+
     /* 
      * Add a group to this Obj file definition. The index of the newly added
      * group will be returned.
@@ -211,6 +262,21 @@ public:
      */
     bool addMaterial(std::size_t index, const std::string& name);
 
+    /*
+     * Finds the index of a group or material by name. Obj files repeat the
+     * same g and usemtl names, the loader uses these to reuse the index.
+     *
+     * @param name - The name of the group or material.
+     * @param index - Receives the index if the name is found.
+     *
+     * @return Returns true if the name is known; otherwise returns false.
+     */
+    bool findGroup(const std::string& name, std::size_t& index) const;
+    bool findMaterial(const std::string& name, std::size_t& index) const;
+
+    /* Returns the library definition of a material, nullptr if none was read. */
+    const ObjMaterial* findMaterialDefinition(const std::string& name) const;
+
     /* Returns the number of meshes in this OBJ file. */
     std::size_t size() const;
 
@@ -258,6 +324,9 @@ public:
     /* Returns the list of external material libraries */
     const StringArray& getMaterialLibraries() const;
 
+    /* Returns the definitions read from the material libraries by name. */
+    const std::map<std::string, ObjMaterial>& getMaterialDefinitions() const;
+
 protected:
     /* Stores the individual meshes within this Obj file. */
     MeshArray meshes;
@@ -277,6 +346,16 @@ protected:
      * surface materials applied to the meshes within this Obj file.
      */
     StringArray materialLibraries;
+
+    /* Materials defined by the libraries, by name. */
+    std::map<std::string, ObjMaterial> materialDefinitions;
+
+    /* Directory of the Obj file being loaded, relative libraries are found in it. */
+    std::string directory;
+
+    /* Reverse lookup of the group and material indices by name. */
+    std::map<std::string, std::size_t> groupIndices;
+    std::map<std::string, std::size_t> materialIndices;
 };
 
 #endif
@@ -0,0 +1,219 @@
+#include "ObjWriter.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+/* Significant digits that always identify a float. */
+const static int FLOAT_MAX_DIGITS = 9;
+
+/* Decimal exponents formatted with the digit search; others use printf. */
+const static int FORMAT_MAX_EXPONENT = 12;
+
+/* Bits a double has below the last bit of a float mantissa. */
+const static int FLOAT_DOUBLE_EXTRA_BITS = 52 - 23;
+
+/* Powers of ten that are exact in double precision. */
+const static double POWERS_OF_TEN[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+//------------------------------------------------------------------------------
+// Rounding a double to float gives the float nearest to the decimal unless
+// the double itself lies exactly halfway between two floats and is not the
+// decimal (the rounding of the decimal to double may have moved it there).
+//------------------------------------------------------------------------------
+static bool IsFloatMidpoint(double value) {
+    unsigned long long bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    unsigned long long extra = bits & ((1ull << FLOAT_DOUBLE_EXTRA_BITS) - 1);
+    return extra == (1ull << (FLOAT_DOUBLE_EXTRA_BITS - 1));
+}
+
+/* Shortest %g text that reads back as value, for the values the digit search does not cover. */
+static std::size_t FormatFloatPrintf(float value, char* buffer) {
+    for ( int digits = 1; digits < FLOAT_MAX_DIGITS; digits++ ) {
+        int length = std::sprintf(buffer, "%.*g", digits, value);
+        if ( std::strtof(buffer, nullptr) == value ) return static_cast<std::size_t>(length);
+    }
+
+    return static_cast<std::size_t>(std::sprintf(buffer, "%.*g", FLOAT_MAX_DIGITS, value));
+}
+
+std::size_t FormatUInt(std::size_t value, char* buffer) {
+    char digits[FORMAT_BUFFER_SIZE];
+    std::size_t count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while ( value != 0 );
+
+    for ( std::size_t i = 0; i < count; i++ ) buffer[i] = digits[count - 1 - i];
+    buffer[count] = '\0';
+    return count;
+}
+
+std::size_t FormatFloat(float value, char* buffer) {
+    char* out = buffer;
+    if ( !std::isfinite(value) ) return FormatFloatPrintf(value, buffer);
+
+    if ( std::signbit(value) ) {
+        *out++ = '-';
+        value = -value;
+    }
+
+    if ( value == 0.0f ) {
+        *out++ = '0';
+        *out = '\0';
+        return static_cast<std::size_t>(out - buffer);
+    }
+
+    int exponent = static_cast<int>(std::floor(std::log10(static_cast<double>(value))));
+    if ( exponent < -FORMAT_MAX_EXPONENT || exponent > FORMAT_MAX_EXPONENT )
+        return static_cast<std::size_t>(out - buffer) + FormatFloatPrintf(value, out);
+
+    //--------------------------------------------------------------------------
+    // The value is digits x 10^-shift. Both the scaling and the check divide
+    // or multiply by an exact power of ten, so the check rounds correctly.
+    //--------------------------------------------------------------------------
+    unsigned long long digits = 0;
+    int shift = 0;
+    bool found = false;
+    for ( int count = 1; count <= FLOAT_MAX_DIGITS && !found; count++ ) {
+        shift = count - 1 - exponent;
+        double scaled = (shift >= 0) ? value * POWERS_OF_TEN[shift] : value / POWERS_OF_TEN[-shift];
+        digits = static_cast<unsigned long long>(scaled + 0.5);
+        if ( digits == 0 ) continue;
+
+        double candidate = (shift >= 0) ? digits / POWERS_OF_TEN[shift] : digits * POWERS_OF_TEN[-shift];
+        found = static_cast<float>(candidate) == value;
+        if ( found && IsFloatMidpoint(candidate) ) {
+            bool exact = (shift >= 0) ? std::fma(candidate, POWERS_OF_TEN[shift], -static_cast<double>(digits)) == 0.0
+                                      : std::fma(static_cast<double>(digits), POWERS_OF_TEN[-shift], -candidate) == 0.0;
+            found = exact;
+        }
+    }
+
+    if ( !found ) return static_cast<std::size_t>(out - buffer) + FormatFloatPrintf(value, out);
+
+    //--------------------------------------------------------------------------
+    // Place the decimal point; rounding up may have added a trailing zero
+    // (9.99 -> 10), which is dropped from the fraction.
+    //--------------------------------------------------------------------------
+    char text[FORMAT_BUFFER_SIZE];
+    int length = static_cast<int>(FormatUInt(static_cast<std::size_t>(digits), text));
+
+    if ( shift <= 0 ) {
+        std::memcpy(out, text, length);
+        out += length;
+        for ( int i = 0; i < -shift; i++ ) *out++ = '0';
+    }
+    else {
+        while ( shift > 0 && text[length - 1] == '0' ) {
+            length--;
+            shift--;
+        }
+
+        if ( shift == 0 ) {
+            std::memcpy(out, text, length);
+            out += length;
+        }
+        else if ( length > shift ) {
+            std::memcpy(out, text, length - shift);
+            out += length - shift;
+            *out++ = '.';
+            std::memcpy(out, text + length - shift, shift);
+            out += shift;
+        }
+        else {
+            *out++ = '0';
+            *out++ = '.';
+            for ( int i = 0; i < shift - length; i++ ) *out++ = '0';
+            std::memcpy(out, text, length);
+            out += length;
+        }
+    }
+
+    *out = '\0';
+    return static_cast<std::size_t>(out - buffer);
+}
+
+/* Appends "<id> x y z\n" (or "<id> x y\n" for two components). */
+static void AppendVectorLine(std::string& text, const char* id, const float* values, unsigned int count) {
+    text.append(id);
+    for ( unsigned int i = 0; i < count; i++ ) {
+        text.push_back(' ');
+        AppendFloat(text, values[i]);
+    }
+
+    text.push_back('\n');
+}
+
+bool SaveObjTriangles(const std::string& filename, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces) {
+    std::vector<char> buffer(OBJ_WRITER_BUFFER_SIZE);
+    std::ofstream out;
+    out.rdbuf()->pubsetbuf(&buffer[0], buffer.size());
+    out.open(filename.c_str());
+
+    if ( out.is_open() == false ) {
+        std::cerr << "[ObjWriter:SaveObjTriangles] Error: Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    out << "# CG Library Wavefront Obj Version 1.0 April 2015\n\n";
+    if ( name.length() != 0 ) out << "o " << name << "\n";
+
+    //--------------------------------------------------------------------------
+    // The attribute lines of every vertex are written in three passes so the
+    // v, vt and vn lines each stay together, as in ObjFile::save.
+    //--------------------------------------------------------------------------
+    bool written = WriteFormattedLines(out, vertices.size(), [&vertices](std::size_t begin, std::size_t end, std::string& text) {
+        for ( std::size_t i = begin; i < end; i++ ) {
+            float position[3] = { vertices[i].position.x(), vertices[i].position.y(), vertices[i].position.z() };
+            AppendVectorLine(text, "v", position, 3);
+        }
+    });
+
+    written = written && WriteFormattedLines(out, vertices.size(), [&vertices](std::size_t begin, std::size_t end, std::string& text) {
+        for ( std::size_t i = begin; i < end; i++ ) {
+            float textureCoord[2] = { vertices[i].textureCoord.x(), vertices[i].textureCoord.y() };
+            AppendVectorLine(text, "vt", textureCoord, 2);
+        }
+    });
+
+    written = written && WriteFormattedLines(out, vertices.size(), [&vertices](std::size_t begin, std::size_t end, std::string& text) {
+        for ( std::size_t i = begin; i < end; i++ ) {
+            float normal[3] = { vertices[i].normal.x(), vertices[i].normal.y(), vertices[i].normal.z() };
+            AppendVectorLine(text, "vn", normal, 3);
+        }
+    });
+
+    written = written && WriteFormattedLines(out, faces.size(), [&faces](std::size_t begin, std::size_t end, std::string& text) {
+        for ( std::size_t i = begin; i < end; i++ ) {
+            text.push_back('f');
+            for ( unsigned int j = 0; j < TRIANGLE_EDGE_COUNT; j++ ) {
+                char index[FORMAT_BUFFER_SIZE];
+                std::size_t length = FormatUInt(faces[i].indices[j] + 1, index);
+                text.push_back(' ');
+                text.append(index, length);
+                text.push_back('/');
+                text.append(index, length);
+                text.push_back('/');
+                text.append(index, length);
+            }
+
+            text.push_back('\n');
+        }
+    });
+
+    out.close();
+    if ( !written || out.fail() ) {
+        std::cerr << "[ObjWriter:SaveObjTriangles] Error: Could not write file: " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
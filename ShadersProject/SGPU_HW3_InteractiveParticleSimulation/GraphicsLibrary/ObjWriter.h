@@ -0,0 +1,78 @@
+#ifndef OBJ_WRITER_H
+#define OBJ_WRITER_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Parallel.h"
+#include "Vertex.h"
+#include "Face.h"
+
+/* Lines per range below which WriteFormattedLines stays on one thread. */
+const static std::size_t OBJ_WRITER_MIN_PARALLEL_LINES = 16384;
+
+/* Size of the stream buffer of the Obj writers. */
+const static std::size_t OBJ_WRITER_BUFFER_SIZE = 1 << 20;
+
+/* Room FormatFloat and FormatUInt need, including the terminating zero. */
+const static std::size_t FORMAT_BUFFER_SIZE = 32;
+
+/*
+ * Writes the shortest decimal that reads back as the same float ("0.1",
+ * "12", "-3.5e-20"); returns the number of characters written. Candidates
+ * of 1 to 9 significant digits are tried in order and checked in double
+ * precision; a candidate whose double lies exactly between two floats is
+ * skipped unless the double is the decimal itself, so a result always reads
+ * back exactly.
+ */
+std::size_t FormatFloat(float value, char* buffer);
+std::size_t FormatUInt(std::size_t value, char* buffer);
+
+inline void AppendFloat(std::string& text, float value) {
+    char buffer[FORMAT_BUFFER_SIZE];
+    text.append(buffer, FormatFloat(value, buffer));
+}
+
+inline void AppendUInt(std::string& text, std::size_t value) {
+    char buffer[FORMAT_BUFFER_SIZE];
+    text.append(buffer, FormatUInt(value, buffer));
+}
+
+/*
+ * Writes count lines formatted by format(begin, end, text), which appends
+ * the lines [begin, end) to text. Blocks of lines are split into ranges of
+ * at least minimumRange lines that are formatted in parallel, then written
+ * in order, so the output does not depend on the number of threads and only
+ * one block is held in memory.
+ */
+template <typename Format>
+bool WriteFormattedLines(std::ostream& out, std::size_t count, Format format, std::size_t minimumRange = OBJ_WRITER_MIN_PARALLEL_LINES) {
+    if ( minimumRange == 0 ) minimumRange = 1;
+
+    std::size_t blockSize = minimumRange * ParallelThreadCount();
+    std::vector<std::string> texts(ParallelRangeCount(blockSize, minimumRange));
+
+    for ( std::size_t begin = 0; begin < count; begin += blockSize ) {
+        std::size_t end = std::min(count, begin + blockSize);
+        std::size_t ranges = ParallelRangeCount(end - begin, minimumRange);
+
+        ParallelFor(begin, end, minimumRange, [&](std::size_t rangeBegin, std::size_t rangeEnd, std::size_t range) {
+            texts[range].clear();
+            format(rangeBegin, rangeEnd, texts[range]);
+        });
+
+        for ( std::size_t r = 0; r < ranges; r++ )
+            out.write(texts[r].data(), texts[r].size());
+    }
+
+    return out.good();
+}
+
+/*
+ * Saves an indexed triangle mesh as an Obj file: one v, vt and vn line per
+ * vertex and one f line per face, all three indices of a corner being its
+ * vertex index.
+ */
+bool SaveObjTriangles(const std::string& filename, const std::string& name, const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces);
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+/* Number of hardware threads available to the parallel algorithms. */
+inline unsigned int ParallelThreadCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return (count == 0) ? 1 : count;
+}
+
+/*
+ * Number of ranges ParallelFor splits [0, count) into. Every range holds at
+ * least minimumRange elements so small inputs are not spread over threads.
+ * Callers that keep per-range scratch data size it with this function.
+ */
+inline std::size_t ParallelRangeCount(std::size_t count, std::size_t minimumRange) {
+    if ( minimumRange == 0 ) minimumRange = 1;
+    std::size_t ranges = (count + minimumRange - 1) / minimumRange;
+    return std::max<std::size_t>(1, std::min<std::size_t>(ranges, ParallelThreadCount()));
+}
+
+/*
+ * Splits [begin, end) into ParallelRangeCount contiguous ranges and calls
+ * function(rangeBegin, rangeEnd, rangeIndex) for each of them. The first
+ * range is executed on the calling thread. The split depends on the element
+ * count and on ParallelThreadCount, so the same input produces the same
+ * ranges only on machines with the same thread count; callers whose result
+ * depends on the ranges are deterministic only for a fixed thread count.
+ */
+template <typename Function>
+void ParallelFor(std::size_t begin, std::size_t end, std::size_t minimumRange, Function function) {
+    if ( end <= begin ) return;
+
+    std::size_t count = end - begin;
+    std::size_t ranges = ParallelRangeCount(count, minimumRange);
+    std::size_t rangeSize = (count + ranges - 1) / ranges;
+
+    if ( ranges == 1 ) {
+        function(begin, end, std::size_t(0));
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(ranges - 1);
+
+    for ( std::size_t r = 1; r < ranges; r++ ) {
+        std::size_t rangeBegin = std::min(end, begin + r * rangeSize);
+        std::size_t rangeEnd = std::min(end, rangeBegin + rangeSize);
+        threads.push_back(std::thread(function, rangeBegin, rangeEnd, r));
+    }
+
+    function(begin, std::min(end, begin + rangeSize), std::size_t(0));
+
+    for ( std::size_t t = 0; t < threads.size(); t++ )
+        threads[t].join();
+}
+
+#endif
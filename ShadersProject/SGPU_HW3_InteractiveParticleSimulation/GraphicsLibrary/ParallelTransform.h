@@ -0,0 +1,38 @@
+#ifndef PARALLEL_TRANSFORM_H
+#define PARALLEL_TRANSFORM_H
+
+#include <BatchTransform.h>
+#include "Parallel.h"
+
+/*
+ * Multi-threaded versions of the strided batch transform kernels. The input
+ * is split into contiguous ranges (see ParallelFor) that are transformed
+ * concurrently; small inputs stay on the calling thread.
+ */
+const static std::size_t MIN_PARALLEL_TRANSFORM_RANGE = 65536;
+
+inline void ParallelTransformPoints(const Matrix4f& m, const float* in, std::size_t inStride, float* out, std::size_t outStride, std::size_t count) {
+    ParallelFor(0, count, MIN_PARALLEL_TRANSFORM_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        TransformPoints(m, in + begin * inStride, inStride, out + begin * outStride, outStride, end - begin);
+    });
+}
+
+inline void ParallelTransformNormals(const Matrix4f& m, const float* in, std::size_t inStride, float* out, std::size_t outStride, std::size_t count, bool normalize = true) {
+    ParallelFor(0, count, MIN_PARALLEL_TRANSFORM_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        TransformNormals(m, in + begin * inStride, inStride, out + begin * outStride, outStride, end - begin, normalize);
+    });
+}
+
+inline void ParallelTransformAABBs(const Matrix4f& m, const float* in, std::size_t inStride, float* out, std::size_t outStride, std::size_t count) {
+    ParallelFor(0, count, MIN_PARALLEL_TRANSFORM_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        TransformAABBs(m, in + begin * inStride, inStride, out + begin * outStride, outStride, end - begin);
+    });
+}
+
+inline void ParallelProjectPoints(const Matrix4f& m, const float* in, std::size_t inStride, float* out, std::size_t outStride, std::size_t count) {
+    ParallelFor(0, count, MIN_PARALLEL_TRANSFORM_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        ProjectPoints(m, in + begin * inStride, inStride, out + begin * outStride, outStride, end - begin);
+    });
+}
+
+#endif
@@ -0,0 +1,109 @@
+#include "ParticleEngine.h"
+#include "GLState.h"
+#include <gl/glew.h>
+
+#define BUFFER_OFFSET(i) ((char *)NULL + (i))
+
+const static unsigned int POSITION_LOC = 0;
+const static unsigned int VELOCITY_LOC = 1;
+const static unsigned int FORCE_LOC = 2;
+const static unsigned int COLOR_LOC = 3;
+const static unsigned int MASS_LOC = 4;
+const static unsigned int LIFETIME_LOC = 5;
+
+Vector3f hiddenPosition(1000.0f, 1000.0f, 1000.0f);
+
+/* State of the linear congruential generator behind Random. */
+static unsigned int randomState = 1;
+
+void SeedRandom(unsigned int seed) {
+    randomState = seed;
+}
+
+float Random(float lower, float upper) {
+    randomState = randomState * 1664525u + 1013904223u;
+    float fraction = (static_cast<float>(randomState >> 8) / static_cast<float>(0xFFFFFF)) * (upper - lower);
+    float x = lower + fraction;
+    return x;
+}
+
+Color3f RandomColor(const Color3f& baseColor) {
+    float r = baseColor.r() + Random(0.5f, 1.0f);
+    float g = baseColor.g() + Random(0.5f, 1.0f);
+    float b = baseColor.b() + Random(0.5f, 1.0f);
+    return Color3f(r, g, b);
+}
+
+void InitializeParticles(std::vector<Particle>& particles, std::size_t count, const ParticleParameters& parameters) {
+    particles.resize(count);
+
+    for ( std::size_t i = 0; i < particles.size(); i++ ) {
+        particles[i].position = hiddenPosition;
+        particles[i].velocity = Vector3f::Zero();
+        particles[i].force = Vector3f::Zero();
+        particles[i].color = RandomColor(parameters.color);
+        particles[i].mass = 1.0f;
+        particles[i].lifetime = Random(parameters.minLifetime, parameters.maxLifetime);
+    }
+}
+
+void BindParticleAttributeLocations(unsigned int programId) {
+    glBindAttribLocation(programId, POSITION_LOC, "position");
+    glBindAttribLocation(programId, VELOCITY_LOC, "velocity");
+    glBindAttribLocation(programId, FORCE_LOC, "force");
+    glBindAttribLocation(programId, COLOR_LOC, "color");
+    glBindAttribLocation(programId, MASS_LOC, "mass");
+    glBindAttribLocation(programId, LIFETIME_LOC, "lifetime");
+}
+
+void EnableParticleAttributes() {
+    //--------------------------------------------------------------------------
+    // Particle position data is the first component in the vertex structure so
+    // it is loaded first (with a byte offset of 0).
+    //--------------------------------------------------------------------------
+    glEnableVertexAttribArray(POSITION_LOC);
+    glVertexAttribPointer(POSITION_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), BUFFER_OFFSET(0));
+
+    //--------------------------------------------------------------------------
+    // Particle velocity.
+    //--------------------------------------------------------------------------
+    glEnableVertexAttribArray(VELOCITY_LOC);
+    glVertexAttribPointer(VELOCITY_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), BUFFER_OFFSET(3 * sizeof(float)));
+
+    //--------------------------------------------------------------------------
+    // Particle external force.
+    //--------------------------------------------------------------------------
+    glEnableVertexAttribArray(FORCE_LOC);
+    glVertexAttribPointer(FORCE_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), BUFFER_OFFSET(6 * sizeof(float)));
+
+    //--------------------------------------------------------------------------
+    // Particle color. Normalizing the color (GL_TRUE) is critical for making
+    // transparency (alpha) work properly.
+    //--------------------------------------------------------------------------
+    glEnableVertexAttribArray(COLOR_LOC);
+    glVertexAttribPointer(COLOR_LOC, 3, GL_FLOAT, GL_TRUE, sizeof(Particle), BUFFER_OFFSET(9 * sizeof(float)));
+
+    //--------------------------------------------------------------------------
+    // Particle mass. The color occupies three floats, so the mass follows at
+    // an offset of 12 floats.
+    //--------------------------------------------------------------------------
+    glEnableVertexAttribArray(MASS_LOC);
+    glVertexAttribPointer(MASS_LOC, 1, GL_FLOAT, GL_FALSE, sizeof(Particle), BUFFER_OFFSET(12 * sizeof(float)));
+
+    //--------------------------------------------------------------------------
+    // Particle Lifetime;
+    //--------------------------------------------------------------------------
+    glEnableVertexAttribArray(LIFETIME_LOC);
+    glVertexAttribPointer(LIFETIME_LOC, 1, GL_FLOAT, GL_TRUE, sizeof(Particle), BUFFER_OFFSET(13 * sizeof(float)));
+    GLState::Count(GLState::VERTEX_ATTRIBUTE, 12);
+}
+
+void DisableParticleAttributes() {
+    glDisableVertexAttribArray(POSITION_LOC);
+    glDisableVertexAttribArray(VELOCITY_LOC);
+    glDisableVertexAttribArray(FORCE_LOC);
+    glDisableVertexAttribArray(COLOR_LOC);
+    glDisableVertexAttribArray(MASS_LOC);
+    glDisableVertexAttribArray(LIFETIME_LOC);
+    GLState::Count(GLState::VERTEX_ATTRIBUTE, 6);
+}
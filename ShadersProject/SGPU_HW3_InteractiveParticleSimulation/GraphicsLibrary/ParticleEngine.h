@@ -0,0 +1,117 @@
+#ifndef PARTICLE_ENGINE_H
+#define PARTICLE_ENGINE_H
+
+#include <vector>
+#include <memory>
+#include <Vector3.h>
+#include "Particle.h"
+#include "Color3.h"
+
+class TriangleBVH;
+
+/*
+ * Simulation parameters shared by every particle engine. These are the values
+ * modified from QViewport through the ParticleSystem setters.
+ */
+struct ParticleParameters {
+    /*
+     * Define the minimum and maximum lifetime of a particle. The range is defined so
+     * that the randomly generated lifetimes will be within this interval.
+     */
+    float minLifetime, maxLifetime;
+
+    /*
+     * Magnitude of the initial velocity for the particles when they are
+     * spawned. The initial velocity direction is given by spawnDirection.
+     */
+    float initVelocity;
+
+    /*
+     * Bounce coefficient. Represents how much kinectic energy the particle
+     * keeps after it has collided with a surface.
+     */
+    float bounceEnergy;
+
+    /* Half-size of the collision box the particles are contained within. */
+    float extent;
+
+    /*
+     * Radius of a particle for particle-particle collisions. A radius of zero
+     * disables the collisions between particles.
+     */
+    float particleRadius;
+
+    Vector3f gravity;
+
+    /*
+     * Current color of the particles. This color value is assigned to the
+     * particles when they are spawned.
+     */
+    Color3f color;
+};
+
+/*
+ * Simulation backend of the ParticleSystem. An engine owns the vertex buffer
+ * the particles are rendered from and is responsible for advancing the
+ * particles by one time-step (integration, collision and respawn).
+ */
+class ParticleEngine {
+public:
+    virtual ~ParticleEngine() {}
+
+    /* Create the GPU resources of the engine from the initial particle state. */
+    virtual bool construct(const std::vector<Particle>& particles) = 0;
+
+    /*
+     * Advance the simulation by dt. Engines that keep the particle data on the
+     * GPU do not modify the particles array; use readBack to retrieve it.
+     */
+    virtual void update(std::vector<Particle>& particles, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt) = 0;
+
+    /* Copy the current particle state of the engine into particles. */
+    virtual bool readBack(std::vector<Particle>& particles) const = 0;
+
+    /*
+     * True if the particle state lives on the GPU, so readBack downloads the
+     * whole vertex buffer and waits for the GPU to finish the update.
+     */
+    virtual bool isGpuResident() const { return false; }
+
+    /* Vertex buffer object that currently stores the particles. */
+    virtual unsigned int getVertexBuffer() const = 0;
+
+    /*
+     * Sets the triangles the particles collide with (nullptr removes them).
+     * Returns false if the engine does not support mesh collisions.
+     */
+    virtual bool setCollisionMesh(const std::shared_ptr<TriangleBVH>& /* mesh */) { return false; }
+};
+
+/* Position dead particles are parked at until they are respawned. */
+extern Vector3f hiddenPosition;
+
+/*
+ * Uniform random value within [lower, upper]. The values come from a
+ * generator owned by the particle code (not rand()), so a simulation is
+ * reproducible after SeedRandom.
+ */
+float Random(float lower, float upper);
+void SeedRandom(unsigned int seed);
+
+/* Generate a random color based on baseColor. */
+Color3f RandomColor(const Color3f& baseColor);
+
+/*
+ * Resizes particles to count and places every particle at the hidden
+ * position with a random color and lifetime.
+ */
+void InitializeParticles(std::vector<Particle>& particles, std::size_t count, const ParticleParameters& parameters);
+
+/* Binds the particle attribute names to the locations used by every engine. */
+void BindParticleAttributeLocations(unsigned int programId);
+
+/* Enables and describes the particle attributes of the currently bound buffer. */
+void EnableParticleAttributes();
+void DisableParticleAttributes();
+
+#endif
@@ -0,0 +1,250 @@
+#include "ParticleRecording.h"
+#include "CpuParticleEngine.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+const static char RECORDING_MAGIC[4] = { 'P', 'R', 'E', 'C' };
+const static unsigned int RECORDING_VERSION = 1;
+
+static bool EqualParameters(const ParticleParameters& a, const ParticleParameters& b) {
+    return a.minLifetime == b.minLifetime && a.maxLifetime == b.maxLifetime &&
+           a.initVelocity == b.initVelocity && a.bounceEnergy == b.bounceEnergy &&
+           a.extent == b.extent && a.particleRadius == b.particleRadius &&
+           a.gravity.x() == b.gravity.x() && a.gravity.y() == b.gravity.y() && a.gravity.z() == b.gravity.z() &&
+           a.color.r() == b.color.r() && a.color.g() == b.color.g() && a.color.b() == b.color.b();
+}
+
+//------------------------------------------------------------------------------
+// Binary serialization helpers. Values are written with the byte order of the
+// machine, which is little endian on every platform this project targets.
+//------------------------------------------------------------------------------
+static void WriteUInt(std::ostream& out, unsigned int value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteFloat(std::ostream& out, float value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void WriteVector(std::ostream& out, const Vector3f& value) {
+    WriteFloat(out, value.x());
+    WriteFloat(out, value.y());
+    WriteFloat(out, value.z());
+}
+
+static void WriteParameters(std::ostream& out, const ParticleParameters& parameters) {
+    WriteFloat(out, parameters.minLifetime);
+    WriteFloat(out, parameters.maxLifetime);
+    WriteFloat(out, parameters.initVelocity);
+    WriteFloat(out, parameters.bounceEnergy);
+    WriteFloat(out, parameters.extent);
+    WriteFloat(out, parameters.particleRadius);
+    WriteVector(out, parameters.gravity);
+    WriteFloat(out, parameters.color.r());
+    WriteFloat(out, parameters.color.g());
+    WriteFloat(out, parameters.color.b());
+}
+
+static bool ReadUInt(std::istream& in, unsigned int& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return in.good();
+}
+
+static bool ReadFloat(std::istream& in, float& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(value));
+    return in.good();
+}
+
+static bool ReadVector(std::istream& in, Vector3f& value) {
+    float x, y, z;
+    if ( !ReadFloat(in, x) || !ReadFloat(in, y) || !ReadFloat(in, z) ) return false;
+    value = Vector3f(x, y, z);
+    return true;
+}
+
+static bool ReadParameters(std::istream& in, ParticleParameters& parameters) {
+    float r, g, b;
+    if ( !ReadFloat(in, parameters.minLifetime) || !ReadFloat(in, parameters.maxLifetime) ) return false;
+    if ( !ReadFloat(in, parameters.initVelocity) || !ReadFloat(in, parameters.bounceEnergy) ) return false;
+    if ( !ReadFloat(in, parameters.extent) || !ReadFloat(in, parameters.particleRadius) ) return false;
+    if ( !ReadVector(in, parameters.gravity) ) return false;
+    if ( !ReadFloat(in, r) || !ReadFloat(in, g) || !ReadFloat(in, b) ) return false;
+    parameters.color = Color3f(r, g, b);
+    return true;
+}
+
+ParticleRecording::ParticleRecording() {
+    this->particleCount = 0;
+    this->seed = 0;
+    this->initialParameters = ParticleParameters();
+    this->currentParameters = ParticleParameters();
+}
+
+ParticleRecording::~ParticleRecording() {}
+
+void ParticleRecording::begin(std::size_t particleCount, unsigned int seed, const ParticleParameters& parameters) {
+    this->particleCount = particleCount;
+    this->seed = seed;
+    this->initialParameters = parameters;
+    this->currentParameters = parameters;
+    this->ticks.clear();
+}
+
+void ParticleRecording::record(bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt, const ParticleParameters& parameters) {
+    ParticleTick tick;
+    tick.flags = spawnParticles ? PARTICLE_TICK_SPAWN : 0;
+    tick.spawnPosition = spawnPosition;
+    tick.spawnDirection = spawnDirection;
+    tick.dt = dt;
+    tick.parameters = parameters;
+
+    if ( !EqualParameters(parameters, this->currentParameters) ) {
+        tick.flags |= PARTICLE_TICK_PARAMETERS;
+        this->currentParameters = parameters;
+    }
+
+    this->ticks.push_back(tick);
+}
+
+bool ParticleRecording::save(const std::string& filename) const {
+    std::ofstream out(filename.c_str(), std::ios::out | std::ios::binary);
+    if ( !out.is_open() ) {
+        std::cerr << "[ParticleRecording:save] Error: Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    out.write(RECORDING_MAGIC, sizeof(RECORDING_MAGIC));
+    WriteUInt(out, RECORDING_VERSION);
+    WriteUInt(out, static_cast<unsigned int>(this->particleCount));
+    WriteUInt(out, this->seed);
+    WriteParameters(out, this->initialParameters);
+    WriteUInt(out, static_cast<unsigned int>(this->ticks.size()));
+
+    for ( std::size_t i = 0; i < this->ticks.size(); i++ ) {
+        const ParticleTick& tick = this->ticks[i];
+        WriteUInt(out, tick.flags);
+        WriteVector(out, tick.spawnPosition);
+        WriteVector(out, tick.spawnDirection);
+        WriteFloat(out, tick.dt);
+        if ( tick.flags & PARTICLE_TICK_PARAMETERS ) WriteParameters(out, tick.parameters);
+    }
+
+    if ( !out.good() ) {
+        std::cerr << "[ParticleRecording:save] Error: Could not write file: " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ParticleRecording::load(const std::string& filename) {
+    std::ifstream in(filename.c_str(), std::ios::in | std::ios::binary);
+    if ( !in.is_open() ) {
+        std::cerr << "[ParticleRecording:load] Error: Could not open file: " << filename << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    unsigned int version = 0, particleCount = 0, tickCount = 0;
+    in.read(magic, sizeof(magic));
+    if ( !in.good() || std::memcmp(magic, RECORDING_MAGIC, sizeof(magic)) != 0 ) {
+        std::cerr << "[ParticleRecording:load] Error: Not a particle recording: " << filename << std::endl;
+        return false;
+    }
+
+    if ( !ReadUInt(in, version) || version != RECORDING_VERSION ) {
+        std::cerr << "[ParticleRecording:load] Error: Unsupported recording version: " << version << std::endl;
+        return false;
+    }
+
+    ParticleParameters parameters;
+    if ( !ReadUInt(in, particleCount) || !ReadUInt(in, this->seed) || !ReadParameters(in, parameters) || !ReadUInt(in, tickCount) ) {
+        std::cerr << "[ParticleRecording:load] Error: Invalid recording header: " << filename << std::endl;
+        return false;
+    }
+
+    this->begin(particleCount, this->seed, parameters);
+    this->ticks.resize(tickCount);
+
+    //--------------------------------------------------------------------------
+    // Ticks without a parameter change carry the parameters of the previous
+    // tick so every tick holds the parameters it was simulated with.
+    //--------------------------------------------------------------------------
+    for ( unsigned int i = 0; i < tickCount; i++ ) {
+        ParticleTick& tick = this->ticks[i];
+        tick.parameters = this->currentParameters;
+
+        bool valid = ReadUInt(in, tick.flags) && ReadVector(in, tick.spawnPosition) && ReadVector(in, tick.spawnDirection) && ReadFloat(in, tick.dt);
+        if ( valid && (tick.flags & PARTICLE_TICK_PARAMETERS) ) {
+            valid = ReadParameters(in, tick.parameters);
+            this->currentParameters = tick.parameters;
+        }
+
+        if ( !valid ) {
+            std::cerr << "[ParticleRecording:load] Error: Recording is truncated at tick " << i << std::endl;
+            this->ticks.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::size_t ParticleRecording::getParticleCount() const {
+    return this->particleCount;
+}
+
+unsigned int ParticleRecording::getSeed() const {
+    return this->seed;
+}
+
+const ParticleParameters& ParticleRecording::getInitialParameters() const {
+    return this->initialParameters;
+}
+
+std::size_t ParticleRecording::getTickCount() const {
+    return this->ticks.size();
+}
+
+const ParticleTick& ParticleRecording::getTick(std::size_t index) const {
+    return this->ticks[index];
+}
+
+bool ReplayRecording(const ParticleRecording& recording, std::vector<Particle>& particles) {
+    if ( recording.getParticleCount() == 0 ) {
+        std::cerr << "[ReplayRecording] Error: Recording has no particles." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Reproduce the initial state exactly as ParticleSystem::startRecording
+    // created it, then feed the recorded input to the CPU simulation.
+    //--------------------------------------------------------------------------
+    SeedRandom(recording.getSeed());
+    ParticleParameters parameters = recording.getInitialParameters();
+    InitializeParticles(particles, recording.getParticleCount(), parameters);
+
+    CpuParticleEngine engine;
+    for ( std::size_t i = 0; i < recording.getTickCount(); i++ ) {
+        const ParticleTick& tick = recording.getTick(i);
+        if ( tick.flags & PARTICLE_TICK_PARAMETERS ) parameters = tick.parameters;
+        engine.simulate(particles, parameters, (tick.flags & PARTICLE_TICK_SPAWN) != 0, tick.spawnPosition, tick.spawnDirection, tick.dt);
+    }
+
+    return true;
+}
+
+unsigned long long ParticleChecksum(const std::vector<Particle>& particles) {
+    unsigned long long hash = 14695981039346656037ull;
+    if ( particles.size() == 0 ) return hash;
+
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&particles[0]);
+    std::size_t size = particles.size() * sizeof(Particle);
+    for ( std::size_t i = 0; i < size; i++ ) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
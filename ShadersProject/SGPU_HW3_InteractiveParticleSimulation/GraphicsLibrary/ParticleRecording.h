@@ -0,0 +1,76 @@
+#ifndef PARTICLE_RECORDING_H
+#define PARTICLE_RECORDING_H
+
+#include <string>
+#include <vector>
+#include "ParticleEngine.h"
+
+/* Flags of a recorded tick. */
+const static unsigned int PARTICLE_TICK_SPAWN = 0x1;
+const static unsigned int PARTICLE_TICK_PARAMETERS = 0x2;
+
+/*
+ * Input of a single ParticleSystem::update call. The parameters are only
+ * meaningful if the PARTICLE_TICK_PARAMETERS flag is set, which is the case
+ * for the ticks where a setter (setGravity, setBounceEnergy, ...) changed
+ * them since the previous tick.
+ */
+struct ParticleTick {
+    unsigned int flags;
+    Vector3f spawnPosition;
+    Vector3f spawnDirection;
+    float dt;
+    ParticleParameters parameters;
+};
+
+/*
+ * Recording of the input of a particle simulation. Together with the random
+ * seed and the particle count this is everything the CPU simulation depends
+ * on, so replaying a recording reproduces the exact particle state.
+ *
+ * File format (binary, little endian):
+ *   "PREC", version, particle count, seed, initial parameters, tick count,
+ *   then per tick: flags, spawn position, spawn direction, dt and the
+ *   parameters if PARTICLE_TICK_PARAMETERS is set.
+ */
+class ParticleRecording {
+public:
+    ParticleRecording();
+    ~ParticleRecording();
+
+    /* Starts a new recording, discarding the current ticks. */
+    void begin(std::size_t particleCount, unsigned int seed, const ParticleParameters& parameters);
+
+    /* Appends the input of one update. */
+    void record(bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt, const ParticleParameters& parameters);
+
+    bool save(const std::string& filename) const;
+    bool load(const std::string& filename);
+
+    std::size_t getParticleCount() const;
+    unsigned int getSeed() const;
+    const ParticleParameters& getInitialParameters() const;
+    std::size_t getTickCount() const;
+    const ParticleTick& getTick(std::size_t index) const;
+
+protected:
+    std::size_t particleCount;
+    unsigned int seed;
+    ParticleParameters initialParameters;
+
+    /* Parameters in effect after the last recorded tick. */
+    ParticleParameters currentParameters;
+
+    std::vector<ParticleTick> ticks;
+};
+
+/*
+ * Replays the recording with the CPU simulation (without OpenGL) and stores
+ * the final particle state in particles.
+ */
+bool ReplayRecording(const ParticleRecording& recording, std::vector<Particle>& particles);
+
+/* 64-bit FNV-1a hash of the particle state, used to compare simulations. */
+unsigned long long ParticleChecksum(const std::vector<Particle>& particles);
+
+#endif
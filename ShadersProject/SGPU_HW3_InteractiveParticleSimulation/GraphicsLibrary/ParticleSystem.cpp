@@ -1,32 +1,41 @@
 #include "ParticleSystem.h"
 #include "GeometryShader.h"
-
-#define BUFFER_OFFSET(i) ((char *)NULL + (i))
-
-const static unsigned int POSITION_LOC = 0;
-const static unsigned int VELOCITY_LOC = 1;
-const static unsigned int FORCE_LOC = 2;
-const static unsigned int COLOR_LOC = 3;
-const static unsigned int MASS_LOC = 4;
-const static unsigned int LIFETIME_LOC = 5;
+#include "CpuParticleEngine.h"
+#include "TriangleBVH.h"
+#include "Mesh.h"
+#include "Parallel.h"
+#include "GLState.h"
+#include <algorithm>
+#include <cmath>
 
 const static float DEFUALT_LIFETIME = 10.0f;
-Vector3f hiddenPosition(1000.0f, 1000.0f, 1000.0f);
+const static float DEFAULT_EXTENT = 16.0f;
+const static std::size_t MIN_PARALLEL_RANGE = 16384;
 
 ParticleSystem::ParticleSystem() {
-    this->vboId = 0;
     this->shader = nullptr;
-    std::srand(0);
-
-    this->bounceEnergy = 0.8f;
-    this->gravity.set(0.0f, -9.8f, 0.0f);
-    this->initVelocity = 1.0f;
-    this->minLifetime = 1.0f;
-    this->maxLifetime = 10.0f;
-    this->color = Color3f(0.3f, 0.2f, 1.0f);
+    this->engine = std::make_shared<CpuParticleEngine>();
+    SeedRandom(0);
+
+    this->parameters.bounceEnergy = 0.8f;
+    this->parameters.gravity.set(0.0f, -9.8f, 0.0f);
+    this->parameters.initVelocity = 1.0f;
+    this->parameters.minLifetime = 1.0f;
+    this->parameters.maxLifetime = 10.0f;
+    this->parameters.extent = DEFAULT_EXTENT;
+    this->parameters.particleRadius = 0.0f;
+    this->parameters.color = Color3f(0.3f, 0.2f, 1.0f);
+
+    this->depthSorting = false;
+    this->depthSortReadBack = false;
+    this->iboId = 0;
+    this->iboSize = 0;
 }
 
-ParticleSystem::~ParticleSystem() {}
+ParticleSystem::~ParticleSystem() {
+    this->releaseVertexArrays();
+    GLState::DeleteBuffer(this->iboId);
+}
 
 bool ParticleSystem::loadShader(const std::string& vertexFilename, const std::string& geometryFilename, const std::string& fragmentFilename) {
     this->shader = std::make_shared<GeometryShader>();
@@ -40,11 +49,7 @@ bool ParticleSystem::loadShader(const std::string& vertexFilename, const std::st
         std::cerr << "[ParticleSystem:loadShader] Error: Could not compile shader." << std::endl;
         return false;
     }
-    glBindAttribLocation(this->shader->getProgramID(), POSITION_LOC, "position");
-    glBindAttribLocation(this->shader->getProgramID(), VELOCITY_LOC, "velocity");
-    glBindAttribLocation(this->shader->getProgramID(), FORCE_LOC, "force");
-    glBindAttribLocation(this->shader->getProgramID(), COLOR_LOC, "color");
-    glBindAttribLocation(this->shader->getProgramID(), MASS_LOC, "mass");
+    BindParticleAttributeLocations(this->shader->getProgramID());
 
     if ( !shader->link() ) {
         std::cerr << "[ParticleSystem:loadShader] Error: Could not link shader program." << std::endl;
@@ -54,184 +59,206 @@ bool ParticleSystem::loadShader(const std::string& vertexFilename, const std::st
     return true;
 }
 
-float Random(float lower, float upper) {
-    int r = rand(); 
-    float fraction = ((float) r / RAND_MAX) * (upper - lower); 
-    float x = lower + fraction; 
-    return x;
+void ParticleSystem::setMaxParticleCount(std::size_t particleCount) {
+    InitializeParticles(this->particles, particleCount, this->parameters);
+    this->constructOnGPU();
 }
 
-/* Generate a random color based on baseColor. */
-Color3f RandomColor(const Color3f& baseColor) {
-    float r = baseColor.r() + Random(0.5f, 1.0f);
-    float g = baseColor.g() + Random(0.5f, 1.0f);
-    float b = baseColor.b() + Random(0.5f, 1.0f);
-    return Color3f(r, g, b);
+void ParticleSystem::update(bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt) {
+    if ( this->engine == nullptr || this->engine->getVertexBuffer() == 0 ) return;
+
+    this->spawnPosition = spawnPosition;
+    this->spawnDirection = spawnDirection;
+
+    if ( this->recording != nullptr )
+        this->recording->record(spawnParticles, spawnPosition, spawnDirection, dt, this->parameters);
+
+    this->engine->update(this->particles, this->parameters, spawnParticles, spawnPosition, spawnDirection, dt);
 }
 
-void ParticleSystem::setMaxParticleCount(std::size_t particleCount) {
-    this->particles.resize(particleCount);
-
-    for ( std::size_t i = 0; i < this->particles.size(); i++ ) {
-        particles[i].position = hiddenPosition;
-        particles[i].velocity = Vector3f::Zero();
-        particles[i].force = Vector3f::Zero();
-        particles[i].color = RandomColor(this->color);
-        particles[i].mass = 1.0f;
-        particles[i].lifetime = Random(this->minLifetime, this->maxLifetime);
+bool ParticleSystem::setEngine(const std::shared_ptr<ParticleEngine>& engine) {
+    if ( engine == nullptr ) {
+        std::cerr << "[ParticleSystem:setEngine] Error: Invalid particle engine." << std::endl;
+        return false;
     }
 
-    this->constructOnGPU();
+    if ( this->engine != nullptr ) this->engine->readBack(this->particles);
+    this->releaseVertexArrays();
+    this->engine = engine;
+
+    if ( this->collisionMesh != nullptr && !this->engine->setCollisionMesh(this->collisionMesh) )
+        std::cerr << "[ParticleSystem:setEngine] Error: Engine does not support mesh collisions." << std::endl;
+
+    if ( this->particles.size() == 0 ) return true;
+    return this->constructOnGPU();
 }
 
-/*
- * Very simple collision based on a cube around the origin. This collision
- * is the simplest form of collilsion that can be implemented for a
- * particle simulation.
- */
-void HandleCollision(Particle& p, float extent, float bounceEnergy) {
-    if ( p.position.x() < -extent ) {
-        p.position.x() = -extent;
-        p.velocity.x() *= -1.0f;
-        p.velocity.x() *= bounceEnergy;
-    }
+const std::shared_ptr<ParticleEngine>& ParticleSystem::getEngine() const {
+    return this->engine;
+}
 
-    if ( p.position.x() > extent ) {
-        p.position.x() = extent;
-        p.velocity.x() *= -1.0f;
-        p.velocity.x() *= bounceEnergy;
-    }
+bool ParticleSystem::crossCheck(std::size_t steps, float dt, float tolerance) {
+    if ( this->engine == nullptr || this->particles.size() == 0 ) return false;
 
-    if ( p.position.z() < -extent ) {
-        p.position.z() = -extent;
-        p.velocity.z() *= -1.0f;
-        p.velocity.z() *= bounceEnergy;
-    }
+    std::vector<Particle> reference;
+    std::vector<Particle> result;
+    if ( !this->engine->readBack(this->particles) ) return false;
+    reference = this->particles;
+
+    //--------------------------------------------------------------------------
+    // The reference runs the complete CPU step, with the collision mesh of
+    // this system and particle collisions, without uploading anything.
+    // Respawning draws random colors and lifetimes, which are generated
+    // differently by every engine, so only deterministic steps are compared.
+    //--------------------------------------------------------------------------
+    CpuParticleEngine referenceEngine;
+    referenceEngine.setCollisionMesh(this->collisionMesh);
 
-    if ( p.position.z() > extent ) {
-        p.position.z() = extent;
-        p.velocity.z() *= -1.0f;
-        p.velocity.z() *= bounceEnergy;
+    for ( std::size_t step = 0; step < steps; step++ ) {
+        referenceEngine.simulate(reference, this->parameters, false, this->spawnPosition, this->spawnDirection, dt);
+        this->engine->update(this->particles, this->parameters, false, this->spawnPosition, this->spawnDirection, dt);
     }
 
-    if ( p.position.y() < 0.0f ) {
-        p.position.y() = 0.0f;
-        p.velocity.y() *= -1.0f;
-        p.velocity.y() *= bounceEnergy;
+    if ( !this->engine->readBack(this->particles) ) return false;
+    result = this->particles;
+
+    float maxError = 0.0f;
+    for ( std::size_t i = 0; i < reference.size(); i++ ) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            maxError = std::max(maxError, std::abs(reference[i].position[k] - result[i].position[k]));
+            maxError = std::max(maxError, std::abs(reference[i].velocity[k] - result[i].velocity[k]));
+        }
+        maxError = std::max(maxError, std::abs(reference[i].lifetime - result[i].lifetime));
     }
 
-    if ( p.position.y() > extent ) {
-        p.position.y() = extent;
-        p.velocity.y() *= -1.0f;
-        p.velocity.y() *= bounceEnergy;
+    if ( maxError > tolerance ) {
+        std::cerr << "[ParticleSystem:crossCheck] Error: Engine differs from the CPU reference by " << maxError << std::endl;
+        return false;
     }
+
+    return true;
 }
 
-void ParticleSystem::update(bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt) {
-    if ( this->vboId == 0 ) return;
+bool ParticleSystem::setCollisionMesh(const Mesh& mesh) {
+    std::shared_ptr<TriangleBVH> bvh = std::make_shared<TriangleBVH>();
+    if ( !bvh->build(mesh.getVertices(), mesh.getFaces(), mesh.getTransform().toMatrix()) ) {
+        std::cerr << "[ParticleSystem:setCollisionMesh] Error: Could not build the collision hierarchy." << std::endl;
+        return false;
+    }
 
-    //--------------------------------------------------------------------------
-    // Using explicit Euler integration, update the the velocity and position
-    // of every particle.
-    //--------------------------------------------------------------------------
-    for ( std::size_t i = 0; i < this->particles.size(); i++ ) {
-        this->particles[i].velocity = this->particles[i].velocity + (dt * this->particles[i].force * 1.0f / this->particles[i].mass);
-        this->particles[i].position = this->particles[i].position + (dt * this->particles[i].velocity);
-        this->particles[i].lifetime -= dt;
-
-        float y = this->particles[i].position.y();
-        float lifetime = this->particles[i].lifetime;
-
-        //--------------------------------------------------------------------------
-        // For the ground collision event, the particle loses kinectic energy
-        // than an impulse is applied to make the particle bounce.
-        //--------------------------------------------------------------------------
-        HandleCollision(this->particles[i], 16.0f, this->bounceEnergy);
-
-        //--------------------------------------------------------------------------
-        // If the system should be currently spawning particles, move them to the
-        // provided spawn position if the particles lifetime is less than 0 (dead).
-        //--------------------------------------------------------------------------
-        if ( spawnParticles && lifetime < 0.0f ) {
-            this->particles[i].position = spawnPosition;
-            this->particles[i].velocity = spawnDirection * this->initVelocity;
-            this->particles[i].force = this->gravity;
-            this->particles[i].color = RandomColor(this->color);
-            this->particles[i].lifetime = Random(this->minLifetime, this->maxLifetime);
-        }
-        //--------------------------------------------------------------------------
-        // If the particle is dead (but resizing the particle array on the GPU is
-        // expensive), then move it to a 'hidden position' where it will wait as
-        // as reserve particle ready to be spawned when spawnParticles is true.
-        //--------------------------------------------------------------------------
-        else {
-            if ( lifetime < 0.0f ) {
-                this->particles[i].position = hiddenPosition;
-                this->particles[i].velocity = Vector3f::Zero();
-                this->particles[i].force = Vector3f::Zero();
-                this->particles[i].color = RandomColor(this->color);
-                this->particles[i].lifetime = 0.0f;
-            }
-        }
+    this->collisionMesh = bvh;
+    if ( this->engine == nullptr ) return true;
 
-        
+    if ( !this->engine->setCollisionMesh(this->collisionMesh) ) {
+        std::cerr << "[ParticleSystem:setCollisionMesh] Error: Engine does not support mesh collisions." << std::endl;
+        return false;
     }
 
-    //--------------------------------------------------------------------------
-    // Upload the new data to the GPU. NOTE: This is not the most efficient way of implementing a
-    // particle system, but it greatly reduces the additional code within the shader implementation.
-    //--------------------------------------------------------------------------
-    glBufferSubData(GL_ARRAY_BUFFER, 0, this->particles.size() * sizeof(Particle), &this->particles[0]);
+    return true;
 }
 
-void ParticleSystem::beginRender() const {
-    if ( this->shader != nullptr ) this->shader->enable();
+void ParticleSystem::clearCollisionMesh() {
+    this->collisionMesh = nullptr;
+    if ( this->engine != nullptr ) this->engine->setCollisionMesh(nullptr);
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, this->vboId);
+void ParticleSystem::setDepthSorting(bool enabled, bool readBack) {
+    this->depthSorting = enabled;
+    this->depthSortReadBack = readBack;
+    if ( !enabled ) this->drawOrder.clear();
+}
 
-    //--------------------------------------------------------------------------
-    // Particle position data is the first component in the vertex structure so
-    // it is loaded first (with a byte offset of 0).
-    //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(POSITION_LOC);
-    glVertexAttribPointer(POSITION_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), BUFFER_OFFSET(0));
+bool ParticleSystem::isDepthSorting() const {
+    return this->depthSorting;
+}
 
-    //--------------------------------------------------------------------------
-    // Particle velocity.
-    //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(VELOCITY_LOC);
-    glVertexAttribPointer(VELOCITY_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), BUFFER_OFFSET(3 * sizeof(float)));
-    
-    //--------------------------------------------------------------------------
-    // Particle external force.
-    //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(FORCE_LOC);
-    glVertexAttribPointer(FORCE_LOC, 3, GL_FLOAT, GL_FALSE, sizeof(Particle), BUFFER_OFFSET(6 * sizeof(float)));
+void ParticleSystem::sortByDepth(const Matrix4f& viewMatrix) {
+    if ( !this->depthSorting || this->engine == nullptr || this->particles.size() == 0 ) return;
 
     //--------------------------------------------------------------------------
-    // Particle color. Normalizing the color (GL_TRUE) is critical for making
-    // transparency (alpha) work properly.
+    // The CPU array is current for CPU engines. GPU engines are only read back
+    // (a full buffer download every frame) when the caller asked for it.
     //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(COLOR_LOC);
-    glVertexAttribPointer(COLOR_LOC, 3, GL_FLOAT, GL_TRUE, sizeof(Particle), BUFFER_OFFSET(9 * sizeof(float)));
+    if ( this->engine->isGpuResident() ) {
+        if ( !this->depthSortReadBack || !this->engine->readBack(this->particles) ) {
+            this->drawOrder.clear();
+            return;
+        }
+    }
 
     //--------------------------------------------------------------------------
-    // Particle mass.
+    // View-space depth is the third column of the (row-vector) view matrix
+    // applied to the particle position. Points farther from the camera have a
+    // more negative depth, so ascending keys give a back-to-front order.
     //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(MASS_LOC);
-    glVertexAttribPointer(MASS_LOC, 1, GL_FLOAT, GL_FALSE, sizeof(Particle), BUFFER_OFFSET(10 * sizeof(float)));
+    float zx = viewMatrix(0, 2);
+    float zy = viewMatrix(1, 2);
+    float zz = viewMatrix(2, 2);
+    float zw = viewMatrix(3, 2);
+
+    std::size_t count = this->particles.size();
+    this->depthKeys.resize(count);
+
+    ParallelFor(0, count, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for ( std::size_t i = begin; i < end; i++ ) {
+            const Vector3f& p = this->particles[i].position;
+            float depth = p.x() * zx + p.y() * zy + p.z() * zz + zw;
+            this->depthKeys[i] = FloatToSortableKey(depth);
+        }
+    });
+
+    this->depthSorter.sort(this->depthKeys, this->drawOrder);
 
     //--------------------------------------------------------------------------
-    // Particle Lifetime;
+    // Upload the order into the element buffer, which is only reallocated
+    // when the number of particles changes. It is uploaded through the array
+    // buffer target, the element binding belongs to the bound vertex array.
     //--------------------------------------------------------------------------
-    glEnableVertexAttribArray(LIFETIME_LOC);
-    glVertexAttribPointer(LIFETIME_LOC, 1, GL_FLOAT, GL_TRUE, sizeof(Particle), BUFFER_OFFSET(11 * sizeof(float)));
+    if ( this->iboId == 0 ) glGenBuffers(1, &this->iboId);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->iboId);
+
+    if ( this->iboSize != count ) {
+        glBufferData(GL_ARRAY_BUFFER, count * sizeof(unsigned int), &this->drawOrder[0], GL_STREAM_DRAW);
+        this->iboSize = count;
+    }
+    else glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(unsigned int), &this->drawOrder[0]);
+}
+
+void ParticleSystem::startRecording(unsigned int seed) {
+    SeedRandom(seed);
+    InitializeParticles(this->particles, this->particles.size(), this->parameters);
+    this->constructOnGPU();
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->vboId);
+    this->recording = std::make_shared<ParticleRecording>();
+    this->recording->begin(this->particles.size(), seed, this->parameters);
+}
+
+std::shared_ptr<ParticleRecording> ParticleSystem::stopRecording() {
+    std::shared_ptr<ParticleRecording> result = this->recording;
+    this->recording = nullptr;
+    return result;
+}
+
+bool ParticleSystem::isRecording() const {
+    return this->recording != nullptr;
+}
+
+void ParticleSystem::beginRender() const {
+    if ( this->shader != nullptr ) this->shader->enable();
+
+    if ( this->engine == nullptr ) return;
+
+    GLState::BindVertexArray(this->getVertexArray(this->engine->getVertexBuffer()));
 }
 
 void ParticleSystem::endRender() const {
-    glDrawArrays(GL_POINTS, 0, this->particles.size());
+    if ( this->depthSorting && this->iboId != 0 && this->iboSize == this->particles.size() && this->drawOrder.size() == this->particles.size() ) {
+        GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->iboId);
+        glDrawElements(GL_POINTS, this->particles.size(), GL_UNSIGNED_INT, 0);
+    }
+    else glDrawArrays(GL_POINTS, 0, this->particles.size());
+    GLState::Count(GLState::DRAW);
+
     if ( this->shader != nullptr ) this->shader->disable();
 }
 
@@ -244,13 +271,34 @@ const std::shared_ptr<GeometryShader>& ParticleSystem::getShader() const {
 }
 
 bool ParticleSystem::constructOnGPU() {
+    if ( this->engine == nullptr ) return false;
+    this->releaseVertexArrays();
+    return this->engine->construct(this->particles);
+}
+
+unsigned int ParticleSystem::getVertexArray(unsigned int vertexBuffer) const {
+    for ( std::size_t i = 0; i < this->vertexArrays.size(); i++ )
+        if ( this->vertexArrays[i].first == vertexBuffer ) return this->vertexArrays[i].second;
+
     //--------------------------------------------------------------------------
-    // Bind the array buffer with a dynamic draw flag because we will be
-    // constantly replacing the particle definitions.
+    // The particle attribute layout is recorded once per vertex buffer.
     //--------------------------------------------------------------------------
-    glGenBuffers(1, &this->vboId);
-    glBindBuffer(GL_ARRAY_BUFFER, this->vboId);
-    glBufferData(GL_ARRAY_BUFFER, this->particles.size() * sizeof(Particle), &this->particles[0], GL_DYNAMIC_DRAW);
-    return true;
+    unsigned int vertexArray = 0;
+    glGenVertexArrays(1, &vertexArray);
+    GLState::BindVertexArray(vertexArray);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    EnableParticleAttributes();
+
+    this->vertexArrays.push_back(std::make_pair(vertexBuffer, vertexArray));
+    return vertexArray;
 }
 
+void ParticleSystem::releaseVertexArrays() {
+    //--------------------------------------------------------------------------
+    // Buffers can be recreated with the same name by a new engine, so the
+    // vertex arrays are released whenever the engine buffers are rebuilt.
+    //--------------------------------------------------------------------------
+    for ( std::size_t i = 0; i < this->vertexArrays.size(); i++ )
+        GLState::DeleteVertexArray(this->vertexArrays[i].second);
+    this->vertexArrays.clear();
+}
@@ -6,9 +6,14 @@
 #include <memory>
 #include <Transformation.h>
 #include "Particle.h"
+#include "ParticleEngine.h"
+#include "RadixSort.h"
+#include "ParticleRecording.h"
 #include "Color3.h"
 
 class GeometryShader;
+class Mesh;
+class TriangleBVH;
 
 class ParticleSystem {
 public:
@@ -28,6 +33,69 @@ public:
      */
     void update(bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt);
 
+    /*
+     * Replaces the simulation backend. The current particle state is read back
+     * from the previous engine and used to construct the new one. By default the
+     * particles are simulated by the CpuParticleEngine.
+     */
+    bool setEngine(const std::shared_ptr<ParticleEngine>& engine);
+    const std::shared_ptr<ParticleEngine>& getEngine() const;
+
+    /*
+     * Validates the current engine against the CPU reference simulation. Both
+     * simulations are advanced from the current particle state for the given
+     * number of steps (without spawning, which depends on random numbers) and
+     * the resulting positions, velocities and lifetimes are compared. The
+     * reference includes the collision mesh and the particle collisions
+     * (particleRadius), so an engine without them fails while they are set.
+     *
+     * Only the deterministic integration path is checked. Respawning is never
+     * exercised, and the state is read back once after the last step, so the
+     * buffer ping-pong of a GPU engine is not checked step by step either.
+     */
+    bool crossCheck(std::size_t steps, float dt, float tolerance);
+
+    /*
+     * Makes the particles collide with the triangles of the mesh, placed by
+     * its current transformation. The hierarchy is built once from the mesh,
+     * so this must be called again after the mesh is moved or replaced.
+     */
+    bool setCollisionMesh(const Mesh& mesh);
+    void clearCollisionMesh();
+
+    /*
+     * Enables back-to-front rendering of the particles for alpha blending.
+     * When enabled, sortByDepth must be called with the view matrix of the
+     * camera (MouseCameraf::getViewMatrix) before rendering.
+     *
+     * The sort runs on the CPU. With an engine that keeps the particles on
+     * the GPU (TransformFeedbackParticleEngine) every sort would read the
+     * whole particle buffer back and stall on the GPU each frame, so such
+     * engines are only sorted if readBack is true; otherwise they are drawn
+     * unsorted.
+     */
+    void setDepthSorting(bool enabled, bool readBack = false);
+    bool isDepthSorting() const;
+
+    /*
+     * Sorts the particles by their view-space depth, farthest first, and
+     * uploads the resulting order as the index buffer used by endRender.
+     * The order of the previous call is used as a warm start for the sort.
+     */
+    void sortByDepth(const Matrix4f& viewMatrix);
+
+    /*
+     * Starts recording the input of every update. The particles are reset
+     * and the random numbers are seeded with seed so the recording can be
+     * replayed exactly (see ReplayRecording). Only the CpuParticleEngine
+     * simulation is reproducible, and a collision mesh is not recorded.
+     */
+    void startRecording(unsigned int seed);
+
+    /* Stops recording and returns the recorded input (nullptr if none). */
+    std::shared_ptr<ParticleRecording> stopRecording();
+    bool isRecording() const;
+
     void beginRender() const;
     void endRender() const;
 
@@ -37,27 +105,32 @@ public:
 	
 	// These functions are called from QViewport to return them to the ParticleSystem
 	void setMinLifetime(float min){
-		this->minLifetime = min;
+		this->parameters.minLifetime = min;
 	}
 
 	void setMaxLifetime(float max){
-		this->maxLifetime = max;
+		this->parameters.maxLifetime = max;
 	}
 
 	void setBounceEnergy(float nrg){
-		this->bounceEnergy = nrg;
+		this->parameters.bounceEnergy = nrg;
 	}
 
 	void setGravity(Vector3f grav){
-		this->gravity.set(grav);
+		this->parameters.gravity.set(grav);
 	}
 
 	void setInitVelocity(float vel){
-		this->initVelocity = vel;
+		this->parameters.initVelocity = vel;
 	}
 
 	void setColor(Color3f col){
-		this->color = col;
+		this->parameters.color = col;
+	}
+
+	/* Radius used for particle-particle collisions (0 disables them). */
+	void setParticleRadius(float radius){
+		this->parameters.particleRadius = radius;
 	}
 
 	void setModel(std::string model){
@@ -73,6 +146,10 @@ public:
 protected:
     bool constructOnGPU();
 
+    /* Vertex array of an engine vertex buffer, created on first use. */
+    unsigned int getVertexArray(unsigned int vertexBuffer) const;
+    void releaseVertexArrays();
+
 protected:
     std::vector<Particle> particles;
     std::shared_ptr<GeometryShader> shader;
@@ -87,34 +164,36 @@ protected:
     Vector3f spawnPosition;
     Vector3f spawnDirection;
 
-    /* 
-     * Define the minimum and maximum lifetime of a particle. The range is defined so
-     * that the randomly generated lifetimes will be within this interval.
-     */
-    float minLifetime, maxLifetime;
+    /* Lifetime, velocity, bounce, gravity and color of the particles. */
+    ParticleParameters parameters;
 
-    /* 
-     * Magnitude of the initial velocity for the particles when they are
-     * spawned. The initial velocity direction is given by spawnDirection.
-     */
-    float initVelocity;
-    
-    /* 
-     * Bounce coefficient. Represents how much kinectic energy the particle
-     * keeps after it has collided with a surface.
-     */
-    float bounceEnergy;
+    /* Simulation backend that owns the particle vertex buffer. */
+    std::shared_ptr<ParticleEngine> engine;
 
-    Vector3f gravity;
+    /* Hierarchy over the triangles the particles collide with (may be nullptr). */
+    std::shared_ptr<TriangleBVH> collisionMesh;
 
-    /* 
-     * Current color of the particles. This color value is assigned to the
-     * particles when they are spawned. 
+    /*
+     * Depth sorting state: the sortable depth key of every particle, the
+     * back-to-front draw order (kept between frames as the warm start of the
+     * sort) and the element buffer the order is uploaded to.
+     */
+    bool depthSorting;
+    bool depthSortReadBack;
+    RadixSorter depthSorter;
+    std::vector<unsigned int> depthKeys;
+    std::vector<unsigned int> drawOrder;
+    unsigned int iboId;
+    std::size_t iboSize;
+
+    /*
+     * Vertex arrays of the engine vertex buffers as (buffer, vertex array)
+     * pairs. The transform feedback engine draws from two buffers in turn.
      */
-    Color3f color;
+    mutable std::vector<std::pair<unsigned int, unsigned int>> vertexArrays;
 
-    /* Vertex buffer object that stores the particles. */
-    unsigned int vboId;
+    /* Recording that receives the input of every update (may be nullptr). */
+    std::shared_ptr<ParticleRecording> recording;
 
 	/* store the model that we will be render */
 	std::string model;
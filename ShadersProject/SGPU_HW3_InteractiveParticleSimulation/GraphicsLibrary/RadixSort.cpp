@@ -0,0 +1,158 @@
+#include "RadixSort.h"
+#include "Parallel.h"
+
+const static unsigned int RADIX_BITS = 11;
+const static unsigned int RADIX_SIZE = 1 << RADIX_BITS;
+const static unsigned int RADIX_MASK = RADIX_SIZE - 1;
+const static std::size_t MIN_PARALLEL_RANGE = 16384;
+
+/*
+ * A warm start is repaired with an insertion sort if at most one in
+ * WARM_START_RATIO neighbouring keys are out of order, and the insertion sort
+ * gives up after INSERTION_BUDGET moves per key.
+ */
+const static std::size_t WARM_START_RATIO = 128;
+const static std::size_t INSERTION_BUDGET = 4;
+
+RadixSorter::RadixSorter() {}
+
+RadixSorter::~RadixSorter() {}
+
+bool RadixSorter::insertionSort(std::size_t count, std::size_t budget) {
+    unsigned int* sortKeys = &this->keys[0][0];
+    unsigned int* sortValues = &this->values[0][0];
+    std::size_t moves = 0;
+
+    for ( std::size_t i = 1; i < count; i++ ) {
+        unsigned int key = sortKeys[i];
+        unsigned int value = sortValues[i];
+        std::size_t j = i;
+
+        while ( j > 0 && sortKeys[j - 1] > key ) {
+            sortKeys[j] = sortKeys[j - 1];
+            sortValues[j] = sortValues[j - 1];
+            j--;
+        }
+
+        sortKeys[j] = key;
+        sortValues[j] = value;
+
+        moves += i - j;
+        if ( moves > budget ) return false;
+    }
+
+    return true;
+}
+
+unsigned int RadixSorter::sort(const std::vector<unsigned int>& keys, std::vector<unsigned int>& order) {
+    std::size_t count = keys.size();
+
+    //--------------------------------------------------------------------------
+    // Start from the previous order when it has the right size, otherwise from
+    // the identity permutation.
+    //--------------------------------------------------------------------------
+    bool warmStart = (order.size() == count);
+    if ( !warmStart ) {
+        order.resize(count);
+        for ( std::size_t i = 0; i < count; i++ ) order[i] = static_cast<unsigned int>(i);
+    }
+
+    if ( count < 2 ) return 0;
+
+    for ( unsigned int b = 0; b < 2; b++ ) {
+        this->keys[b].resize(count);
+        this->values[b].resize(count);
+    }
+
+    //--------------------------------------------------------------------------
+    // Gather the keys in the starting order and count the neighbouring keys
+    // that are out of order.
+    //--------------------------------------------------------------------------
+    std::size_t ranges = ParallelRangeCount(count, MIN_PARALLEL_RANGE);
+    std::vector<std::size_t> rangeDescents(ranges, 0);
+
+    ParallelFor(0, count, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t range) {
+        std::size_t descents = 0;
+        for ( std::size_t i = begin; i < end; i++ ) {
+            unsigned int key = keys[order[i]];
+            this->keys[0][i] = key;
+            this->values[0][i] = order[i];
+            if ( i > 0 && keys[order[i - 1]] > key ) descents++;
+        }
+        rangeDescents[range] = descents;
+    });
+
+    std::size_t descents = 0;
+    for ( std::size_t r = 0; r < ranges; r++ ) descents += rangeDescents[r];
+
+    if ( descents == 0 ) return 0;
+
+    if ( warmStart && descents <= count / WARM_START_RATIO ) {
+        bool sorted = this->insertionSort(count, count * INSERTION_BUDGET);
+
+        //----------------------------------------------------------------------
+        // An insertion sort that gave up leaves a valid permutation behind, so
+        // the radix passes simply continue from it.
+        //----------------------------------------------------------------------
+        if ( sorted ) {
+            order.assign(this->values[0].begin(), this->values[0].end());
+            return 0;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Radix passes. Every range builds a histogram of its digits, the
+    // histograms are scanned digit-major so range r writes after ranges < r
+    // (which keeps the sort stable) and every range scatters its elements.
+    // A pass is skipped if all keys share the same digit.
+    //--------------------------------------------------------------------------
+    this->histograms.resize(ranges * RADIX_SIZE);
+    unsigned int source = 0;
+    unsigned int passes = 0;
+
+    for ( unsigned int shift = 0; shift < 32; shift += RADIX_BITS ) {
+        const unsigned int* sourceKeys = &this->keys[source][0];
+        const unsigned int* sourceValues = &this->values[source][0];
+        unsigned int* destinationKeys = &this->keys[1 - source][0];
+        unsigned int* destinationValues = &this->values[1 - source][0];
+        unsigned int* histogram = &this->histograms[0];
+
+        ParallelFor(0, count, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t range) {
+            unsigned int* rangeHistogram = histogram + range * RADIX_SIZE;
+            for ( unsigned int d = 0; d < RADIX_SIZE; d++ ) rangeHistogram[d] = 0;
+            for ( std::size_t i = begin; i < end; i++ )
+                rangeHistogram[(sourceKeys[i] >> shift) & RADIX_MASK]++;
+        });
+
+        bool trivial = false;
+        unsigned int offset = 0;
+        for ( unsigned int d = 0; d < RADIX_SIZE; d++ ) {
+            unsigned int digitTotal = 0;
+            for ( std::size_t r = 0; r < ranges; r++ ) {
+                unsigned int rangeCount = histogram[r * RADIX_SIZE + d];
+                histogram[r * RADIX_SIZE + d] = offset + digitTotal;
+                digitTotal += rangeCount;
+            }
+
+            if ( digitTotal == count ) trivial = true;
+            offset += digitTotal;
+        }
+
+        if ( trivial ) continue;
+
+        ParallelFor(0, count, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t range) {
+            unsigned int* rangeOffsets = histogram + range * RADIX_SIZE;
+            for ( std::size_t i = begin; i < end; i++ ) {
+                unsigned int slot = rangeOffsets[(sourceKeys[i] >> shift) & RADIX_MASK]++;
+                destinationKeys[slot] = sourceKeys[i];
+                destinationValues[slot] = sourceValues[i];
+            }
+        });
+
+        source = 1 - source;
+        passes++;
+    }
+
+    order.assign(this->values[source].begin(), this->values[source].end());
+    return passes;
+}
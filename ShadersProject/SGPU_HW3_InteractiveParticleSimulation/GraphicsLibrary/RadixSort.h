@@ -0,0 +1,56 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include <vector>
+
+/*
+ * Maps a float to an unsigned integer with the same ordering, so floats can
+ * be sorted as integer keys. Positive values get their sign bit set and
+ * negative values have all bits flipped.
+ */
+inline unsigned int FloatToSortableKey(float value) {
+    union {
+        float f;
+        unsigned int u;
+    } bits;
+
+    bits.f = value;
+    unsigned int mask = (bits.u & 0x80000000u) ? 0xFFFFFFFFu : 0x80000000u;
+    return bits.u ^ mask;
+}
+
+/*
+ * Parallel least significant digit radix sort of 32-bit keys (three 11-bit
+ * passes). The sort produces the permutation that orders the keys instead
+ * of moving the keys themselves. The scratch buffers are kept between calls
+ * so sorting every frame does not allocate.
+ */
+class RadixSorter {
+public:
+    RadixSorter();
+    ~RadixSorter();
+
+    /*
+     * Writes the indices of keys into order so that keys[order[i]] is
+     * ascending. Equal keys keep their relative position in order. If order
+     * already holds a permutation of the keys (typically the order of the
+     * previous frame) it is used as a warm start: an order that is still
+     * sorted is kept, and a nearly sorted one is repaired with an insertion
+     * sort. Returns the number of radix passes that were performed.
+     */
+    unsigned int sort(const std::vector<unsigned int>& keys, std::vector<unsigned int>& order);
+
+protected:
+    /* Insertion sort limited to budget moves. Returns false if it gave up. */
+    bool insertionSort(std::size_t count, std::size_t budget);
+
+protected:
+    /* Ping-pong key and index buffers of the radix passes. */
+    std::vector<unsigned int> keys[2];
+    std::vector<unsigned int> values[2];
+
+    /* Digit histograms of every parallel range (2048 counters per range). */
+    std::vector<unsigned int> histograms;
+};
+
+#endif
@@ -0,0 +1,200 @@
+#include "RenderQueue.h"
+#include "GLState.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+const static unsigned int PROGRAM_BITS = 10;
+const static unsigned int MATERIAL_BITS = 20;
+const static unsigned int DEPTH_BITS = 32;
+const static unsigned int PASS_SHIFT = 62;
+
+const static unsigned int MAX_PROGRAM_INDEX = (1u << PROGRAM_BITS) - 1;
+const static unsigned int MAX_MATERIAL_INDEX = (1u << MATERIAL_BITS) - 1;
+
+const static unsigned int RADIX_BITS = 8;
+const static unsigned int RADIX_SIZE = 1u << RADIX_BITS;
+const static unsigned int RADIX_DIGITS = 64 / RADIX_BITS;
+
+RenderQueue::TextureSet RenderQueue::TexturesOf(const Shader& shader) {
+    TextureSet textures = { { shader.diffuseTexture.get(), shader.normalTexture.get(), shader.specularTexture.get(), shader.heightmapTexture.get() } };
+    return textures;
+}
+
+RenderQueue::RenderQueue() {
+    this->statistics = RenderQueueStatistics();
+}
+
+void RenderQueue::begin(const Cameraf& camera, const Vector3f& lightPosition) {
+    this->draws.clear();
+    this->keys.clear();
+
+    //--------------------------------------------------------------------------
+    // Indices are kept between frames so keys stay stable. Once a field would
+    // overflow the tables start over; a saturated index only costs sorting
+    // quality, render compares the actual program and textures.
+    //--------------------------------------------------------------------------
+    if ( this->programs.size() > MAX_PROGRAM_INDEX ) this->programs.clear();
+    if ( this->materials.size() > MAX_MATERIAL_INDEX ) this->materials.clear();
+
+    this->viewMatrix = camera.getViewMatrix();
+    this->projectionMatrix = camera.getProjectionMatrix();
+    this->eye = camera.getEye();
+    this->lightPosition = lightPosition;
+}
+
+bool RenderQueue::submit(const Mesh& mesh, const Transformationf& transform, RenderPass pass) {
+    const std::shared_ptr<Shader>& shader = mesh.getShader();
+    if ( shader == nullptr ) {
+        std::cerr << "[RenderQueue:submit] Error: Mesh has no shader." << std::endl;
+        return false;
+    }
+
+    Vector3f center;
+    float radius = 0.0f;
+    mesh.getWorldBoundingSphere(transform, center, radius);
+    float depth = std::max(0.0f, static_cast<float>((center - this->eye).length()) - radius);
+
+    Draw draw;
+    draw.mesh = &mesh;
+    draw.modelView = Matrix4f::Multiply(transform.toMatrix(), this->viewMatrix);
+    this->draws.push_back(draw);
+    this->keys.push_back(MakeKey(pass, this->getProgramIndex(shader->programId), this->getMaterialIndex(*shader), depth));
+    return true;
+}
+
+std::uint64_t RenderQueue::MakeKey(RenderPass pass, unsigned int program, unsigned int material, float depth) {
+    std::uint32_t depthBits = 0;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+    std::uint64_t state = (static_cast<std::uint64_t>(std::min(program, MAX_PROGRAM_INDEX)) << MATERIAL_BITS) | std::min(material, MAX_MATERIAL_INDEX);
+    std::uint64_t key = static_cast<std::uint64_t>(pass) << PASS_SHIFT;
+    if ( pass == RENDER_PASS_TRANSPARENT ) return key | (static_cast<std::uint64_t>(~depthBits) << (PROGRAM_BITS + MATERIAL_BITS)) | state;
+    return key | (state << DEPTH_BITS) | depthBits;
+}
+
+unsigned int RenderQueue::getProgramIndex(unsigned int programId) {
+    std::map<unsigned int, unsigned int>::iterator found = this->programs.find(programId);
+    if ( found != this->programs.end() ) return found->second;
+
+    unsigned int index = static_cast<unsigned int>(this->programs.size());
+    this->programs[programId] = index;
+    return index;
+}
+
+unsigned int RenderQueue::getMaterialIndex(const Shader& shader) {
+    TextureSet textures = TexturesOf(shader);
+    std::map<TextureSet, unsigned int>::iterator found = this->materials.find(textures);
+    if ( found != this->materials.end() ) return found->second;
+
+    unsigned int index = static_cast<unsigned int>(this->materials.size());
+    this->materials[textures] = index;
+    return index;
+}
+
+void RenderQueue::sort() {
+    std::size_t count = this->keys.size();
+    this->order.resize(count);
+    for ( std::size_t i = 0; i < count; i++ ) this->order[i] = static_cast<std::uint32_t>(i);
+
+    //--------------------------------------------------------------------------
+    // Histograms of all eight digits in one pass over the keys. A digit whose
+    // keys all fall in one bucket leaves the order as it is and is skipped;
+    // unused program, material or pass bits cost nothing.
+    //--------------------------------------------------------------------------
+    std::vector<std::size_t> histograms(RADIX_DIGITS * RADIX_SIZE, 0);
+    for ( std::size_t i = 0; i < count; i++ )
+        for ( unsigned int d = 0; d < RADIX_DIGITS; d++ ) histograms[d * RADIX_SIZE + ((this->keys[i] >> (d * RADIX_BITS)) & (RADIX_SIZE - 1))]++;
+
+    this->scratchKeys.resize(count);
+    this->scratchOrder.resize(count);
+    this->sortedKeys.assign(this->keys.begin(), this->keys.end());
+
+    for ( unsigned int d = 0; d < RADIX_DIGITS; d++ ) {
+        std::size_t* histogram = &histograms[d * RADIX_SIZE];
+        if ( count == 0 || histogram[(this->sortedKeys[0] >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)] == count ) continue;
+
+        std::size_t offset = 0;
+        for ( unsigned int b = 0; b < RADIX_SIZE; b++ ) {
+            std::size_t bucket = histogram[b];
+            histogram[b] = offset;
+            offset += bucket;
+        }
+
+        for ( std::size_t i = 0; i < count; i++ ) {
+            std::size_t slot = histogram[(this->sortedKeys[i] >> (d * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+            this->scratchKeys[slot] = this->sortedKeys[i];
+            this->scratchOrder[slot] = this->order[i];
+        }
+
+        this->sortedKeys.swap(this->scratchKeys);
+        this->order.swap(this->scratchOrder);
+    }
+}
+
+void RenderQueue::render() {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    this->sort();
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+    this->statistics = RenderQueueStatistics();
+    this->statistics.drawCount = this->draws.size();
+    this->statistics.sortMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+    //--------------------------------------------------------------------------
+    // Submit in key order. The sampler uniforms belong to the program, so a
+    // program change binds the textures again (GLState skips the binds that
+    // are already made); otherwise only a different texture set does.
+    //--------------------------------------------------------------------------
+    const Shader* current = nullptr;
+    TextureSet textures = { { nullptr, nullptr, nullptr, nullptr } };
+    for ( std::size_t i = 0; i < this->order.size(); i++ ) {
+        const Draw& draw = this->draws[this->order[i]];
+        const Shader& shader = *draw.mesh->getShader();
+        TextureSet drawTextures = TexturesOf(shader);
+
+        bool programChange = (current == nullptr || current->programId != shader.programId);
+        bool materialChange = (current == nullptr || textures != drawTextures);
+        if ( programChange ) {
+            GLState::UseProgram(shader.programId);
+            shader.uniformMatrix("projectionMatrix", this->projectionMatrix);
+            shader.uniformVector("lightPosition", this->lightPosition);
+            this->statistics.programChanges++;
+        }
+
+        if ( programChange || materialChange ) {
+            shader.bindTextures();
+            this->statistics.batchCount++;
+        }
+
+        if ( materialChange ) this->statistics.materialChanges++;
+
+        //----------------------------------------------------------------------
+        // Materials packed into texture arrays share the textures of their
+        // batch and differ only by layer (see MaterialArrays).
+        //----------------------------------------------------------------------
+        if ( programChange || materialChange || current->textureLayer != shader.textureLayer ) {
+            shader.bindLayer();
+            if ( shader.textureLayer >= 0 ) this->statistics.layerChanges++;
+        }
+
+        current = &shader;
+        textures = drawTextures;
+
+        draw.mesh->bind();
+        shader.uniformMatrix("modelViewMatrix", draw.modelView);
+        shader.uniformNormalMatrix(draw.modelView);
+        draw.mesh->draw();
+    }
+
+    if ( current != nullptr ) GLState::UseProgram(0);
+}
+
+std::size_t RenderQueue::getDrawCount() const {
+    return this->draws.size();
+}
+
+const RenderQueueStatistics& RenderQueue::getStatistics() const {
+    return this->statistics;
+}
@@ -0,0 +1,111 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <vector>
+#include <Transformation.h>
+#include "Mesh.h"
+#include "Camera.h"
+
+/* Opaque draws are sorted by state then front to back, transparent ones back to front */
+enum RenderPass { RENDER_PASS_OPAQUE, RENDER_PASS_TRANSPARENT, RENDER_PASS_COUNT };
+
+/*
+ * Result of one RenderQueue::render. A batch is a run of draws with the same
+ * pass, program and material; the changes are the program and texture set
+ * switches made between batches, and the texture array layer switches made
+ * within them.
+ */
+struct RenderQueueStatistics {
+    std::size_t drawCount;
+    std::size_t batchCount;
+    std::size_t programChanges;
+    std::size_t materialChanges;
+    std::size_t layerChanges;
+    double sortMilliseconds;
+};
+
+/*
+ * RenderQueue: Draws submitted during a frame, sorted by a 64-bit key so the
+ * state changes between them are as few as possible.
+ *
+ * The program and the texture set (material) of the mesh's shader get small
+ * indices the first time the queue sees them. Key layout, from the most
+ * significant bit:
+ *
+ *   opaque:       pass (2) | program (10) | material (20) | depth (32)
+ *   transparent:  pass (2) | inverted depth (32) | program (10) | material (20)
+ *
+ * The depth is the bit pattern of the (non-negative) distance from the eye
+ * to the world bounding sphere, which sorts like the float. Opaque draws
+ * sharing a state are drawn front to back, transparent draws strictly back
+ * to front. The keys are sorted with an LSD radix sort of 8-bit digits,
+ * skipping digits that are the same in every key.
+ *
+ * render walks the sorted draws: a program change uses the program and sets
+ * the per-frame uniforms (projectionMatrix, lightPosition), a material
+ * change binds the textures (Shader::bindTextures), and every draw sets
+ * modelViewMatrix and normalMatrix (Shader::uniformNormalMatrix) and draws
+ * the mesh (Mesh::bind, draw).
+ * Shaders of materials packed into texture arrays share their textures, so
+ * their draws batch together and set only the layer (Shader::bindLayer).
+ */
+class RenderQueue {
+public:
+    RenderQueue();
+
+    /* Clears the draws and takes the camera and light of the new frame. */
+    void begin(const Cameraf& camera, const Vector3f& lightPosition);
+
+    /*
+     * Queues a draw of mesh with the given transformation. The mesh and its
+     * shader have to stay alive until render.
+     */
+    bool submit(const Mesh& mesh, const Transformationf& transform, RenderPass pass = RENDER_PASS_OPAQUE);
+
+    /* Sorts the queued draws and submits them; the draws stay queued. */
+    void render();
+
+    std::size_t getDrawCount() const;
+    const RenderQueueStatistics& getStatistics() const;
+
+    static std::uint64_t MakeKey(RenderPass pass, unsigned int program, unsigned int material, float depth);
+
+protected:
+    struct Draw {
+        const Mesh* mesh;
+        Matrix4f modelView;
+    };
+
+    typedef std::array<const Texture*, 4> TextureSet;
+    static TextureSet TexturesOf(const Shader& shader);
+
+    unsigned int getProgramIndex(unsigned int programId);
+    unsigned int getMaterialIndex(const Shader& shader);
+    void sort();
+
+protected:
+    std::vector<Draw> draws;
+    std::vector<std::uint64_t> keys;
+
+    /* Keys and draw indices in sorted order, and the radix sort scratch */
+    std::vector<std::uint64_t> sortedKeys;
+    std::vector<std::uint32_t> order;
+    std::vector<std::uint64_t> scratchKeys;
+    std::vector<std::uint32_t> scratchOrder;
+
+    /* Indices of the programs and texture sets seen so far */
+    std::map<unsigned int, unsigned int> programs;
+    std::map<TextureSet, unsigned int> materials;
+
+    Matrix4f viewMatrix;
+    Matrix4f projectionMatrix;
+    Vector3f eye;
+    Vector3f lightPosition;
+
+    RenderQueueStatistics statistics;
+};
+
+#endif
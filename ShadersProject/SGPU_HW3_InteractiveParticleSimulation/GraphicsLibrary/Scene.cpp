@@ -0,0 +1,149 @@
+#include "Scene.h"
+#include <SimdMath.h>
+#include <chrono>
+
+const static std::size_t SIMD_WIDTH = 4;
+const static int ALL_LANES = 0xF;
+
+Scene::Scene() {
+    this->statistics = SceneCullingStatistics();
+}
+
+std::size_t Scene::add(const std::shared_ptr<Mesh>& mesh, const Transformationf& transform) {
+    std::size_t index = this->meshes.size();
+    this->meshes.push_back(mesh);
+    this->transforms.push_back(transform);
+
+    //--------------------------------------------------------------------------
+    // Grow the bounds arrays a block of four at a time. The padding lanes are
+    // never reported as visible (see cull).
+    //--------------------------------------------------------------------------
+    if ( index % SIMD_WIDTH == 0 ) {
+        std::size_t size = index + SIMD_WIDTH;
+        this->centerX.resize(size, 0.0f);
+        this->centerY.resize(size, 0.0f);
+        this->centerZ.resize(size, 0.0f);
+        this->radius.resize(size, 0.0f);
+    }
+
+    this->updateBounds(index);
+    return index;
+}
+
+void Scene::clear() {
+    this->meshes.clear();
+    this->transforms.clear();
+    this->centerX.clear();
+    this->centerY.clear();
+    this->centerZ.clear();
+    this->radius.clear();
+    this->visible.clear();
+    this->statistics = SceneCullingStatistics();
+}
+
+void Scene::setTransform(std::size_t index, const Transformationf& transform) {
+    if ( index >= this->transforms.size() ) {
+        std::cerr << "[Scene:setTransform] Error: Object index out of range." << std::endl;
+        return;
+    }
+
+    this->transforms[index] = transform;
+    this->updateBounds(index);
+}
+
+void Scene::updateBounds(std::size_t index) {
+    Vector3f center;
+    float sphereRadius = 0.0f;
+    this->meshes[index]->getWorldBoundingSphere(this->transforms[index], center, sphereRadius);
+
+    this->centerX[index] = center.x();
+    this->centerY[index] = center.y();
+    this->centerZ[index] = center.z();
+    this->radius[index] = sphereRadius;
+}
+
+std::size_t Scene::cull(const Cameraf& camera) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+    Frustum frustum;
+    ExtractFrustum(Matrix4f::Multiply(camera.getViewMatrix(), camera.getProjectionMatrix()), frustum);
+
+    SimdFloat4 planes[FRUSTUM_PLANE_COUNT][4];
+    for ( unsigned int p = 0; p < FRUSTUM_PLANE_COUNT; p++ )
+        for ( unsigned int c = 0; c < 4; c++ ) planes[p][c] = SimdSplat(frustum.planes[p][c]);
+
+    //--------------------------------------------------------------------------
+    // Four spheres per step: a sphere is outside if its signed distance to
+    // any plane is below minus its radius. The outside lanes of the six
+    // planes are collected as a bit mask.
+    //--------------------------------------------------------------------------
+    std::size_t objectCount = this->meshes.size();
+    this->visible.clear();
+    for ( std::size_t i = 0; i < objectCount; i += SIMD_WIDTH ) {
+        SimdFloat4 x = SimdLoad(&this->centerX[i]);
+        SimdFloat4 y = SimdLoad(&this->centerY[i]);
+        SimdFloat4 z = SimdLoad(&this->centerZ[i]);
+        SimdFloat4 negativeRadius = SimdSub(SimdZero(), SimdLoad(&this->radius[i]));
+
+        int outside = 0;
+        for ( unsigned int p = 0; p < FRUSTUM_PLANE_COUNT; p++ ) {
+            SimdFloat4 distance = SimdMulAdd(planes[p][0], x, SimdMulAdd(planes[p][1], y, SimdMulAdd(planes[p][2], z, planes[p][3])));
+            outside |= SimdMaskGreater(negativeRadius, distance);
+        }
+
+        int inside = ~outside & ALL_LANES;
+        if ( objectCount - i < SIMD_WIDTH ) inside &= (1 << (objectCount - i)) - 1;
+        for ( unsigned int lane = 0; inside != 0; lane++, inside >>= 1 )
+            if ( inside & 1 ) this->visible.push_back(static_cast<unsigned int>(i + lane));
+    }
+
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    this->statistics.objectCount = objectCount;
+    this->statistics.visibleCount = this->visible.size();
+    this->statistics.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    return this->visible.size();
+}
+
+void Scene::render(const Cameraf& camera, const Vector3f& lightPosition) const {
+    for ( std::size_t i = 0; i < this->visible.size(); i++ ) {
+        unsigned int index = this->visible[i];
+        const std::shared_ptr<Mesh>& mesh = this->meshes[index];
+        Matrix4f modelView = Matrix4f::Multiply(this->transforms[index].toMatrix(), camera.getViewMatrix());
+
+        mesh->beginRender();
+        if ( mesh->getShader() != nullptr ) {
+            mesh->getShader()->uniformMatrix("projectionMatrix", camera.getProjectionMatrix());
+            mesh->getShader()->uniformMatrix("modelViewMatrix", modelView);
+            mesh->getShader()->uniformNormalMatrix(modelView);
+            mesh->getShader()->uniformVector("lightPosition", lightPosition);
+        }
+        mesh->endRender();
+    }
+}
+
+void Scene::submit(RenderQueue& queue, RenderPass pass) const {
+    for ( std::size_t i = 0; i < this->visible.size(); i++ ) {
+        unsigned int index = this->visible[i];
+        queue.submit(*this->meshes[index], this->transforms[index], pass);
+    }
+}
+
+std::size_t Scene::getObjectCount() const {
+    return this->meshes.size();
+}
+
+const std::shared_ptr<Mesh>& Scene::getMesh(std::size_t index) const {
+    return this->meshes[index];
+}
+
+const Transformationf& Scene::getTransform(std::size_t index) const {
+    return this->transforms[index];
+}
+
+const std::vector<unsigned int>& Scene::getVisibleObjects() const {
+    return this->visible;
+}
+
+const SceneCullingStatistics& Scene::getCullingStatistics() const {
+    return this->statistics;
+}
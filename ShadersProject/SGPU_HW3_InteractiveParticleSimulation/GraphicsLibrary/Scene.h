@@ -0,0 +1,86 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <memory>
+#include <vector>
+#include <Transformation.h>
+#include "Mesh.h"
+#include "Camera.h"
+#include "Frustum.h"
+#include "RenderQueue.h"
+
+/* Result of one culling pass; the time is the CPU time of Scene::cull. */
+struct SceneCullingStatistics {
+    std::size_t objectCount;
+    std::size_t visibleCount;
+    double milliseconds;
+};
+
+/*
+ * Scene: Instances of meshes, each with its own transformation, that are
+ * frustum culled as a whole before drawing.
+ *
+ * The world bounding spheres of the objects are kept as a structure of
+ * arrays (centre x, y, z and radius in separate arrays padded to a multiple
+ * of four), so cull tests four objects against a plane with one SIMD
+ * multiply-add chain (see SimdMath). render then only submits the objects
+ * that passed, so the draw cost follows the visible objects.
+ */
+class Scene {
+public:
+    Scene();
+
+    /* Adds an instance of mesh and returns its index. */
+    std::size_t add(const std::shared_ptr<Mesh>& mesh, const Transformationf& transform);
+    void clear();
+
+    /* Replaces the transformation of an object and updates its bounds. */
+    void setTransform(std::size_t index, const Transformationf& transform);
+
+    /*
+     * Culls the objects against the view frustum of the camera and returns
+     * the number of visible objects.
+     */
+    std::size_t cull(const Cameraf& camera);
+
+    /*
+     * Draws the visible objects of the last cull with their own model-view
+     * and normal matrices. The mesh shaders get the uniforms
+     * projectionMatrix, modelViewMatrix, lightPosition and normalMatrix, as
+     * a mat3 or a mat4 depending on the shader (see
+     * Shader::uniformNormalMatrix). Meshes drawn by a scene should leave
+     * meshlet culling off, its draw list belongs to one transformation.
+     */
+    void render(const Cameraf& camera, const Vector3f& lightPosition) const;
+
+    /*
+     * Queues the visible objects of the last cull instead of drawing them in
+     * order; the queue sorts them by state (see RenderQueue).
+     */
+    void submit(RenderQueue& queue, RenderPass pass = RENDER_PASS_OPAQUE) const;
+
+    std::size_t getObjectCount() const;
+    const std::shared_ptr<Mesh>& getMesh(std::size_t index) const;
+    const Transformationf& getTransform(std::size_t index) const;
+    const std::vector<unsigned int>& getVisibleObjects() const;
+    const SceneCullingStatistics& getCullingStatistics() const;
+
+protected:
+    void updateBounds(std::size_t index);
+
+protected:
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    std::vector<Transformationf> transforms;
+
+    /* World bounding spheres, structure of arrays padded to a multiple of 4 */
+    std::vector<float> centerX;
+    std::vector<float> centerY;
+    std::vector<float> centerZ;
+    std::vector<float> radius;
+
+    /* Indices of the objects that passed the last cull */
+    std::vector<unsigned int> visible;
+    SceneCullingStatistics statistics;
+};
+
+#endif
@@ -24,6 +24,7 @@
  * THE SOFTWARE.
  */
 #include "Shader.h"
+#include "GLState.h"
 #include <fstream>
 #include <iostream>
 
@@ -31,6 +32,14 @@ const static std::string DIFFUSE_TEXTURE = "diffuseTexture";
 const static std::string NORMAL_TEXTURE = "normalTexture";
 const static std::string SPECULAR_TEXTURE = "specularTexture";
 const static std::string HEIGHTMAP_TEXTURE = "heightmapTexture";
+const static std::string MATERIAL_LAYER = "materialLayer";
+const static std::string NORMAL_MATRIX = "normalMatrix";
+
+/* Looks up a uniform; the lookup and the following glUniform are counted. */
+static int UniformLocation(unsigned int programId, const std::string& name) {
+    GLState::Count(GLState::UNIFORM, 2);
+    return glGetUniformLocation(programId, name.c_str());
+}
 
 Shader::Shader() {
     this->programId = 0;
@@ -41,6 +50,9 @@ Shader::Shader() {
     this->diffuseTexture = nullptr;
     this->normalTexture = nullptr;
     this->specularTexture = nullptr;
+    this->textureLayer = -1;
+    this->ownsProgram = true;
+    this->normalMatrixType = 0;
 }
 
 Shader::Shader(const Shader& shader) {
@@ -52,10 +64,15 @@ Shader::Shader(const Shader& shader) {
     this->diffuseTexture = shader.diffuseTexture;
     this->normalTexture = shader.normalTexture;
     this->specularTexture = shader.specularTexture;
+    this->heightmapTexture = shader.heightmapTexture;
+    this->textureLayer = shader.textureLayer;
+    this->ownsProgram = false;
+    this->normalMatrixType = shader.normalMatrixType;
 }
 
 Shader::~Shader() {
-    glDeleteProgram(this->programId);
+    if ( !this->ownsProgram ) return;
+    GLState::DeleteProgram(this->programId);
     glDeleteShader(this->vertexId);
     glDeleteShader(this->fragmentId);
 }
@@ -86,11 +103,17 @@ bool Shader::compile() {
     glCompileShader(this->fragmentId);
     if ( !this->compileStatus(this->fragmentId, this->fragFilename) ) return false;
 
+    //--------------------------------------------------------------------------
+    // The program object is created here so attribute locations can be bound
+    // between compile() and link().
+    //--------------------------------------------------------------------------
+    if ( this->programId == 0 ) this->programId = glCreateProgram();
+
     return true;
 }
 
 bool Shader::link() {
-    this->programId = glCreateProgram();
+    if ( this->programId == 0 ) this->programId = glCreateProgram();
     glAttachShader(this->programId, this->vertexId);
     glAttachShader(this->programId, this->fragmentId);
     glLinkProgram(this->programId);
@@ -128,37 +151,44 @@ bool Shader::loadHeightmapTexture(const std::string& filename) {
 }
 
 bool Shader::enable() {
-    glUseProgram(this->programId);
-    
+    GLState::UseProgram(this->programId);
+    this->bindTextures();
+    this->bindLayer();
+    return true;
+}
+
+void Shader::bindTextures() const {
     if ( this->diffuseTexture != nullptr ) {
-        glActiveTextureARB(GL_TEXTURE0);
+        GLState::ActiveTexture(0);
         this->diffuseTexture->render();
         this->uniform1i(DIFFUSE_TEXTURE, 0);
     }
 
     if ( this->normalTexture != nullptr ) {
-        glActiveTextureARB(GL_TEXTURE1);
+        GLState::ActiveTexture(1);
         this->normalTexture->render();
         this->uniform1i(NORMAL_TEXTURE, 1);
     }
 
     if ( this->specularTexture != nullptr ) {
-        glActiveTextureARB(GL_TEXTURE2);
+        GLState::ActiveTexture(2);
         this->specularTexture->render();
         this->uniform1i(SPECULAR_TEXTURE, 2);
     }
 
     if ( this->heightmapTexture != nullptr ) {
-        glActiveTextureARB(GL_TEXTURE3);
+        GLState::ActiveTexture(3);
         this->heightmapTexture->render();
         this->uniform1i(HEIGHTMAP_TEXTURE, 3);
     }
+}
 
-    return true;
+void Shader::bindLayer() const {
+    if ( this->textureLayer >= 0 ) this->uniform1f(MATERIAL_LAYER, static_cast<float>(this->textureLayer));
 }
 
 bool Shader::disable() {
-    glUseProgram(0);
+    GLState::UseProgram(0);
     return false;
 }
 
@@ -175,70 +205,90 @@ unsigned int Shader::id() const {
 }
 
 void Shader::uniform1f(const std::string& name, float value) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform1f(paramLocation, value);
 }
 
 void Shader::uniform2f(const std::string& name, float value0, float value1) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform2f(paramLocation, value0, value1);
 }
 
 void Shader::uniform3f(const std::string& name, float value0, float value1, float value2) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform3f(paramLocation, value0, value1, value2);
 }
 
 void Shader::uniform4f(const std::string& name, float value0, float value1, float value2, float value3) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform4f(paramLocation, value0, value1, value2, value3);
 }
 
 void Shader::uniform1i(const std::string& name, int value) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform1i(paramLocation, value);
 }
 
 void Shader::uniform2i(const std::string& name, int value0, int value1) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform2i(paramLocation, value0, value1);
 }
 
 void Shader::uniform3i(const std::string& name, int value0, int value1, int value2) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform3i(paramLocation, value0, value1, value2);
 }
 
 void Shader::uniform4i(const std::string& name, int value0, int value1, int value2, int value3) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform4i(paramLocation, value0, value1, value2, value3);
 }
 
 void Shader::uniform4fv(const std::string& name, unsigned int count, const float* values) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform4fv(paramLocation, count, values);
 }
 
 void Shader::uniformMatrix(const std::string& name, const Matrix4f& matrix) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniformMatrix4fv(paramLocation, 1, false, matrix.constData());
 }
 
 void Shader::uniformMatrix(const std::string& name, const Matrix3f& matrix) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniformMatrix3fv(paramLocation, 1, false, matrix.constData());
 }
 
 void Shader::uniformVector(const std::string& name, const Vector3f& vector) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform3f(paramLocation, vector[0], vector[1], vector[2]);
 }
 
 void Shader::uniformVector(const std::string& name, const Vector4f& vector) const {
-    int paramLocation = glGetUniformLocation(this->programId, name.c_str());
+    int paramLocation = UniformLocation(this->programId, name);
 	glUniform4f(paramLocation, vector[0], vector[1], vector[2], vector[3]);
 }
 
+void Shader::uniformNormalMatrix(const Matrix4f& modelView) const {
+    //--------------------------------------------------------------------------
+    // A mat3 uniform only accepts glUniformMatrix3fv and a mat4 uniform
+    // glUniformMatrix4fv, anything else fails with GL_INVALID_OPERATION. A
+    // program without the uniform gets the mat3 upload, which is ignored.
+    //--------------------------------------------------------------------------
+    if ( this->normalMatrixType == 0 && this->programId != 0 ) {
+        const char* name = NORMAL_MATRIX.c_str();
+        unsigned int index = GL_INVALID_INDEX;
+        int type = GL_FLOAT_MAT3;
+        glGetUniformIndices(this->programId, 1, &name, &index);
+        if ( index != GL_INVALID_INDEX ) glGetActiveUniformsiv(this->programId, 1, &index, GL_UNIFORM_TYPE, &type);
+        this->normalMatrixType = type;
+    }
+
+    if ( this->normalMatrixType == GL_FLOAT_MAT4 )
+        this->uniformMatrix(NORMAL_MATRIX, Matrix4f::Transpose(Matrix4f::Inverse(modelView)));
+    else this->uniformMatrix(NORMAL_MATRIX, Matrix4f::NormalMatrix(modelView));
+}
+
 bool Shader::loadFile(const std::string& filename, std::string& content) {
     if ( filename.length() == 0 ) {
         std::cerr << "[Shader:loadFile] Error: Cannot read filename: \"\"" << std::endl;
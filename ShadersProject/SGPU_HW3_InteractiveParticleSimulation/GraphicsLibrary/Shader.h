@@ -50,6 +50,22 @@ public:
     bool enable();
     bool disable();
 
+    /*
+     * Binds the textures of this shader to units 0-3 without changing the
+     * program; enable uses the program and then binds them. Copies of a
+     * shader share its program (the original deletes it and has to outlive
+     * them), so copies with their own textures act as materials of one
+     * program (see RenderQueue).
+     */
+    void bindTextures() const;
+
+    /*
+     * Sets the uniform materialLayer to textureLayer when the textures are
+     * texture arrays (see MaterialArrays); enable calls it, a RenderQueue
+     * calls it per draw.
+     */
+    void bindLayer() const;
+
     operator unsigned int () const;
     unsigned int getProgramID() const;
     unsigned int id() const;
@@ -68,6 +84,13 @@ public:
     void uniformVector(const std::string& name, const Vector3f& vector) const;
     void uniformVector(const std::string& name, const Vector4f& vector) const;
 
+    /*
+     * Sets the uniform normalMatrix to the inverse transpose of modelView.
+     * Some shaders declare it as a mat3 (the upper 3x3 block) and others as
+     * a mat4; the declared type is queried once from the linked program.
+     */
+    void uniformNormalMatrix(const Matrix4f& modelView) const;
+
 protected:
     bool loadFile(const std::string& filename, std::string& content);
     bool compileStatus(unsigned int shaderId, const std::string& filename) const;
@@ -84,11 +107,20 @@ public:
     std::shared_ptr<Texture> specularTexture;
     std::shared_ptr<Texture> heightmapTexture;
 
+    /* Layer of the texture arrays sampled by this shader, -1 for 2D textures */
+    int textureLayer;
+
     /* Shader File Info */
     std::string vertFilename;
     std::string fragFilename;
     std::string vertSource;
     std::string fragSource;
+
+    /* False for copies, which share the program of the original */
+    bool ownsProgram;
+
+    /* GL type of the normalMatrix uniform, 0 until uniformNormalMatrix queries it */
+    mutable int normalMatrixType;
 };
 
 #endif
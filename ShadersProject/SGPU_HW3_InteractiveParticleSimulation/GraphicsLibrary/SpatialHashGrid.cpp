@@ -0,0 +1,247 @@
+#include "SpatialHashGrid.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+
+const static unsigned int INVALID_BUCKET = 0xFFFFFFFF;
+const static std::size_t MIN_PARALLEL_RANGE = 4096;
+const static unsigned int MIN_AXIS_BITS = 2;
+const static unsigned int MIN_BUCKET_BITS = 6;
+
+SpatialHashGrid::SpatialHashGrid() {
+    this->setCellSize(1.0f);
+    this->bucketCount = 0;
+    this->counterCount = 0;
+    for ( unsigned int axis = 0; axis < 3; axis++ ) {
+        this->origin[axis] = 0;
+        this->bits[axis] = MIN_AXIS_BITS;
+        this->masks[axis] = (1u << MIN_AXIS_BITS) - 1;
+    }
+}
+
+SpatialHashGrid::SpatialHashGrid(float cellSize) {
+    this->setCellSize(cellSize);
+    this->bucketCount = 0;
+    this->counterCount = 0;
+    for ( unsigned int axis = 0; axis < 3; axis++ ) {
+        this->origin[axis] = 0;
+        this->bits[axis] = MIN_AXIS_BITS;
+        this->masks[axis] = (1u << MIN_AXIS_BITS) - 1;
+    }
+}
+
+SpatialHashGrid::~SpatialHashGrid() {}
+
+void SpatialHashGrid::setCellSize(float cellSize) {
+    if ( cellSize <= 0.0f ) {
+        std::cerr << "[SpatialHashGrid:setCellSize] Error: Cell size must be positive." << std::endl;
+        return;
+    }
+
+    this->cellSize = cellSize;
+    this->inverseCellSize = 1.0f / cellSize;
+}
+
+float SpatialHashGrid::getCellSize() const {
+    return this->cellSize;
+}
+
+int SpatialHashGrid::cellCoordinate(float value) const {
+    return static_cast<int>(std::floor(value * this->inverseCellSize));
+}
+
+unsigned int SpatialHashGrid::hashCell(int x, int y, int z) const {
+    unsigned int cx = static_cast<unsigned int>(x - this->origin[0]) & this->masks[0];
+    unsigned int cy = static_cast<unsigned int>(y - this->origin[1]) & this->masks[1];
+    unsigned int cz = static_cast<unsigned int>(z - this->origin[2]) & this->masks[2];
+    return (cz << (this->bits[0] + this->bits[1])) | (cy << this->bits[0]) | cx;
+}
+
+unsigned int SpatialHashGrid::getBucket(const Vector3f& position) const {
+    return this->hashCell(this->cellCoordinate(position.x()), this->cellCoordinate(position.y()), this->cellCoordinate(position.z()));
+}
+
+void SpatialHashGrid::build(const std::vector<Particle>& particles) {
+    std::size_t count = particles.size();
+
+    //--------------------------------------------------------------------------
+    // Bounds of the live particles, reduced per range in parallel.
+    //--------------------------------------------------------------------------
+    std::size_t boundRanges = ParallelRangeCount(count, MIN_PARALLEL_RANGE);
+    std::vector<Vector3f> rangeMinimum(boundRanges, Vector3f(FLT_MAX, FLT_MAX, FLT_MAX));
+    std::vector<Vector3f> rangeMaximum(boundRanges, Vector3f(-FLT_MAX, -FLT_MAX, -FLT_MAX));
+
+    ParallelFor(0, count, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t range) {
+        Vector3f& minimum = rangeMinimum[range];
+        Vector3f& maximum = rangeMaximum[range];
+        for ( std::size_t i = begin; i < end; i++ ) {
+            if ( particles[i].lifetime <= 0.0f ) continue;
+            for ( unsigned int axis = 0; axis < 3; axis++ ) {
+                minimum[axis] = std::min(minimum[axis], particles[i].position[axis]);
+                maximum[axis] = std::max(maximum[axis], particles[i].position[axis]);
+            }
+        }
+    });
+
+    Vector3f minimum = rangeMinimum[0];
+    Vector3f maximum = rangeMaximum[0];
+    for ( std::size_t r = 1; r < boundRanges; r++ ) {
+        for ( unsigned int axis = 0; axis < 3; axis++ ) {
+            minimum[axis] = std::min(minimum[axis], rangeMinimum[r][axis]);
+            maximum[axis] = std::max(maximum[axis], rangeMaximum[r][axis]);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Distribute roughly one bucket per particle over the axes. Every axis
+    // starts with enough bits to cover the extent of the particles and the
+    // largest axis is halved until the bucket budget is met.
+    //--------------------------------------------------------------------------
+    unsigned int budget = MIN_BUCKET_BITS;
+    while ( (std::size_t(1) << budget) < count ) budget++;
+
+    unsigned int totalBits = 0;
+    for ( unsigned int axis = 0; axis < 3; axis++ ) {
+        int cells = 1;
+        this->origin[axis] = 0;
+        if ( minimum[axis] <= maximum[axis] ) {
+            this->origin[axis] = this->cellCoordinate(minimum[axis]);
+            cells = this->cellCoordinate(maximum[axis]) - this->origin[axis] + 1;
+        }
+
+        this->bits[axis] = MIN_AXIS_BITS;
+        while ( this->bits[axis] < 24 && (1 << this->bits[axis]) < cells ) this->bits[axis]++;
+        totalBits += this->bits[axis];
+    }
+
+    while ( totalBits > budget ) {
+        unsigned int largest = 0;
+        for ( unsigned int axis = 1; axis < 3; axis++ )
+            if ( this->bits[axis] > this->bits[largest] ) largest = axis;
+        if ( this->bits[largest] == MIN_AXIS_BITS ) break;
+        this->bits[largest]--;
+        totalBits--;
+    }
+
+    for ( unsigned int axis = 0; axis < 3; axis++ )
+        this->masks[axis] = (1u << this->bits[axis]) - 1;
+
+    std::size_t buckets = std::size_t(1) << totalBits;
+    this->bucketCount = buckets;
+
+    if ( this->counterCount < buckets ) {
+        this->bucketCounters.reset(new std::atomic<unsigned int>[buckets]);
+        this->counterCount = buckets;
+    }
+
+    this->particleBuckets.resize(count);
+    this->bucketStart.resize(buckets + 1);
+
+    std::atomic<unsigned int>* counters = this->bucketCounters.get();
+    ParallelFor(0, buckets, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for ( std::size_t b = begin; b < end; b++ ) counters[b].store(0, std::memory_order_relaxed);
+    });
+
+    //--------------------------------------------------------------------------
+    // Counting pass: find the bucket of every live particle and count the
+    // number of particles per bucket.
+    //--------------------------------------------------------------------------
+    ParallelFor(0, count, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for ( std::size_t i = begin; i < end; i++ ) {
+            if ( particles[i].lifetime <= 0.0f ) {
+                this->particleBuckets[i] = INVALID_BUCKET;
+                continue;
+            }
+
+            unsigned int bucket = this->getBucket(particles[i].position);
+            this->particleBuckets[i] = bucket;
+            counters[bucket].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    //--------------------------------------------------------------------------
+    // Exclusive prefix sum over the bucket counts. Every range sums its own
+    // buckets, the range totals are scanned serially and every range then
+    // writes its offsets starting from the total of the preceding ranges.
+    //--------------------------------------------------------------------------
+    std::size_t ranges = ParallelRangeCount(buckets, MIN_PARALLEL_RANGE);
+    std::vector<unsigned int> rangeTotals(ranges + 1, 0);
+
+    ParallelFor(0, buckets, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t range) {
+        unsigned int total = 0;
+        for ( std::size_t b = begin; b < end; b++ ) total += counters[b].load(std::memory_order_relaxed);
+        rangeTotals[range + 1] = total;
+    });
+
+    for ( std::size_t r = 0; r < ranges; r++ ) rangeTotals[r + 1] += rangeTotals[r];
+
+    ParallelFor(0, buckets, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t range) {
+        unsigned int offset = rangeTotals[range];
+        for ( std::size_t b = begin; b < end; b++ ) {
+            unsigned int bucketSize = counters[b].load(std::memory_order_relaxed);
+            this->bucketStart[b] = offset;
+            counters[b].store(offset, std::memory_order_relaxed);
+            offset += bucketSize;
+        }
+    });
+
+    unsigned int liveCount = rangeTotals[ranges];
+    this->bucketStart[buckets] = liveCount;
+    this->sortedIndices.resize(liveCount);
+    this->sortedPositions.resize(liveCount);
+
+    //--------------------------------------------------------------------------
+    // Scatter pass: every live particle claims a slot within its bucket.
+    //--------------------------------------------------------------------------
+    ParallelFor(0, count, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for ( std::size_t i = begin; i < end; i++ ) {
+            unsigned int bucket = this->particleBuckets[i];
+            if ( bucket == INVALID_BUCKET ) continue;
+            unsigned int slot = counters[bucket].fetch_add(1, std::memory_order_relaxed);
+            this->sortedIndices[slot] = static_cast<unsigned int>(i);
+        }
+    });
+
+    //--------------------------------------------------------------------------
+    // The order within a bucket depends on thread scheduling. Buckets are small
+    // so they are insertion-sorted by particle index, which keeps the result
+    // (and everything that iterates it) deterministic. The positions are then
+    // copied into bucket order.
+    //--------------------------------------------------------------------------
+    ParallelFor(0, buckets, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t) {
+        for ( std::size_t b = begin; b < end; b++ ) {
+            unsigned int first = this->bucketStart[b];
+            unsigned int last = this->bucketStart[b + 1];
+
+            for ( unsigned int i = first + 1; i < last; i++ ) {
+                unsigned int value = this->sortedIndices[i];
+                unsigned int j = i;
+                while ( j > first && this->sortedIndices[j - 1] > value ) {
+                    this->sortedIndices[j] = this->sortedIndices[j - 1];
+                    j--;
+                }
+                this->sortedIndices[j] = value;
+            }
+
+            for ( unsigned int i = first; i < last; i++ )
+                this->sortedPositions[i] = particles[this->sortedIndices[i]].position;
+        }
+    });
+}
+
+std::size_t SpatialHashGrid::queryNeighbors(const Vector3f& position, float radius, std::vector<unsigned int>& neighbors) const {
+    neighbors.clear();
+    this->forEachNeighbor(position, radius, [&](unsigned int index, const Vector3f&) {
+        neighbors.push_back(index);
+    });
+    return neighbors.size();
+}
+
+const std::vector<unsigned int>& SpatialHashGrid::getSortedIndices() const {
+    return this->sortedIndices;
+}
+
+std::size_t SpatialHashGrid::getBucketCount() const {
+    return this->bucketCount;
+}
@@ -0,0 +1,150 @@
+#ifndef SPATIAL_HASH_GRID_H
+#define SPATIAL_HASH_GRID_H
+
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <Vector3.h>
+#include "Particle.h"
+
+/*
+ * Uniform grid over an unbounded domain. Every cell (floor(p / cellSize)) is
+ * hashed into a bucket by wrapping its coordinates into a power-of-two sized
+ * grid placed over the live particles, and the particles are counting-sorted
+ * by bucket every frame. Buckets are laid out in x-major scanline order, so
+ * a row of neighboring cells is one contiguous range of the sorted particles
+ * (indices and positions) and iterating the sorted order walks space
+ * coherently. Cells outside the grid wrap around and share buckets with
+ * distant cells; queries filter those out by distance. Dead particles
+ * (lifetime <= 0) are not inserted.
+ */
+class SpatialHashGrid {
+public:
+    SpatialHashGrid();
+    SpatialHashGrid(float cellSize);
+    ~SpatialHashGrid();
+
+    /*
+     * Edge length of a grid cell. For collision queries this should be the
+     * largest query radius so a query only visits the 27 surrounding cells.
+     */
+    void setCellSize(float cellSize);
+    float getCellSize() const;
+
+    /*
+     * Sorts the particles into the grid. The number of buckets is the power of
+     * two at or above the particle count, distributed over the axes according
+     * to the extent of the live particles. Counting, the prefix sum and the
+     * scatter are performed in parallel.
+     */
+    void build(const std::vector<Particle>& particles);
+
+    /*
+     * Calls visitor(particleIndex, position) for every particle within radius
+     * of position (inclusive of a particle located at position itself).
+     */
+    template <typename Visitor>
+    void forEachNeighbor(const Vector3f& position, float radius, Visitor visitor) const;
+
+    /* Collects the indices of the particles within radius of position. */
+    std::size_t queryNeighbors(const Vector3f& position, float radius, std::vector<unsigned int>& neighbors) const;
+
+    /*
+     * Particle indices in bucket order. Iterating the particles in this order
+     * visits neighbors consecutively, which keeps the accessed memory local.
+     */
+    const std::vector<unsigned int>& getSortedIndices() const;
+    std::size_t getBucketCount() const;
+
+    /* Bucket of a world-space position. */
+    unsigned int getBucket(const Vector3f& position) const;
+
+protected:
+    unsigned int hashCell(int x, int y, int z) const;
+    int cellCoordinate(float value) const;
+
+protected:
+    float cellSize;
+    float inverseCellSize;
+
+    /*
+     * Total number of buckets. The grid spans 2^bits[axis] cells per axis
+     * starting at the cell origin; cell coordinates are wrapped with masks.
+     */
+    std::size_t bucketCount;
+    int origin[3];
+    unsigned int bits[3];
+    unsigned int masks[3];
+
+    /* bucketStart[b] .. bucketStart[b + 1] indexes sortedIndices. */
+    std::vector<unsigned int> bucketStart;
+    std::vector<unsigned int> sortedIndices;
+    std::vector<Vector3f> sortedPositions;
+
+    /* Bucket of every particle (or INVALID_BUCKET for dead particles). */
+    std::vector<unsigned int> particleBuckets;
+
+    /* Per-bucket counters used while counting and scattering. */
+    std::unique_ptr<std::atomic<unsigned int>[]> bucketCounters;
+    std::size_t counterCount;
+};
+
+template <typename Visitor>
+void SpatialHashGrid::forEachNeighbor(const Vector3f& position, float radius, Visitor visitor) const {
+    if ( this->sortedIndices.size() == 0 ) return;
+
+    int minimum[3], maximum[3];
+    for ( unsigned int axis = 0; axis < 3; axis++ ) {
+        minimum[axis] = this->cellCoordinate(position[axis] - radius);
+        maximum[axis] = this->cellCoordinate(position[axis] + radius);
+
+        //----------------------------------------------------------------------
+        // A query wider than the grid would visit wrapped buckets twice, so it
+        // is limited to one full period of the axis.
+        //----------------------------------------------------------------------
+        int period = 1 << this->bits[axis];
+        if ( maximum[axis] - minimum[axis] >= period ) maximum[axis] = minimum[axis] + period - 1;
+    }
+
+    float radiusSquared = radius * radius;
+    for ( int z = minimum[2]; z <= maximum[2]; z++ ) {
+        for ( int y = minimum[1]; y <= maximum[1]; y++ ) {
+            //------------------------------------------------------------------
+            // The cells of a row are consecutive buckets unless the row wraps
+            // around the grid, in which case it is split in two ranges.
+            //------------------------------------------------------------------
+            unsigned int first = this->hashCell(minimum[0], y, z);
+            unsigned int last = this->hashCell(maximum[0], y, z);
+            unsigned int rangeStarts[2], rangeEnds[2];
+            unsigned int rangeCount = 1;
+
+            if ( first <= last ) {
+                rangeStarts[0] = this->bucketStart[first];
+                rangeEnds[0] = this->bucketStart[last + 1];
+            }
+            else {
+                unsigned int rowStart = last - (last & this->masks[0]);
+                unsigned int rowEnd = rowStart + this->masks[0];
+                rangeStarts[0] = this->bucketStart[first];
+                rangeEnds[0] = this->bucketStart[rowEnd + 1];
+                rangeStarts[1] = this->bucketStart[rowStart];
+                rangeEnds[1] = this->bucketStart[last + 1];
+                rangeCount = 2;
+            }
+
+            for ( unsigned int r = 0; r < rangeCount; r++ ) {
+                for ( unsigned int i = rangeStarts[r]; i < rangeEnds[r]; i++ ) {
+                    const Vector3f& p = this->sortedPositions[i];
+                    float dx = p.x() - position.x();
+                    float dy = p.y() - position.y();
+                    float dz = p.z() - position.z();
+                    if ( dx * dx + dy * dy + dz * dz <= radiusSquared )
+                        visitor(this->sortedIndices[i], p);
+                }
+            }
+        }
+    }
+}
+
+#endif
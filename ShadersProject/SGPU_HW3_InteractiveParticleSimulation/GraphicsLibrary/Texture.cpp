@@ -1,5 +1,6 @@
 #include "Texture.h"
 #include "PNG.h"
+#include "GLState.h"
 #include <iostream>
 #include <gl/glew.h>
 #include <gl/freeglut.h>
@@ -8,24 +9,40 @@ Texture::Texture() {
     this->width = 0;
     this->height = 0;
     this->textureId = 0;
+    this->target = GL_TEXTURE_2D;
 }
 
 Texture::~Texture() {
-
+    GLState::DeleteTexture(this->textureId);
 }
 
 bool Texture::load(const std::string& filename) {
     if ( filename.length() == 0 ) return false;
 
-    unsigned int error = lodepng::decode(this->image, this->width, this->height, filename, LCT_RGBA);
+    std::vector<unsigned char> image;
+    unsigned int width = 0, height = 0;
+    unsigned int error = lodepng::decode(image, width, height, filename, LCT_RGBA);
 
     if ( error ) {
         std::cerr << "[Texture:load] Error: Could not load PNG image: " << filename << std::endl;
         return false;
     }
-  
-    glGenTextures(1, &this->textureId);
-    glBindTexture(GL_TEXTURE_2D, this->textureId);
+
+    return this->create(width, height, image);
+}
+
+bool Texture::create(unsigned int width, unsigned int height, const std::vector<unsigned char>& image) {
+    if ( width == 0 || height == 0 || image.size() < static_cast<std::size_t>(width) * height * 4 ) {
+        std::cerr << "[Texture:create] Error: Image data does not match the size." << std::endl;
+        return false;
+    }
+
+    this->image = image;
+    this->width = width;
+    this->height = height;
+
+    if ( this->textureId == 0 ) glGenTextures(1, &this->textureId);
+    GLState::BindTexture(GL_TEXTURE_2D, this->textureId);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->width, this->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &this->image[0]);
@@ -34,6 +51,18 @@ bool Texture::load(const std::string& filename) {
 }
 
 void Texture::render() const {
-    glEnable(GL_TEXTURE_2D);
-    glBindTexture(GL_TEXTURE_2D, this->textureId);
+    if ( this->target == GL_TEXTURE_2D ) glEnable(GL_TEXTURE_2D);
+    GLState::BindTexture(this->target, this->textureId);
+}
+
+unsigned int Texture::getTarget() const {
+    return this->target;
+}
+
+unsigned int Texture::getWidth() const {
+    return this->width;
+}
+
+unsigned int Texture::getHeight() const {
+    return this->height;
 }
@@ -12,14 +12,24 @@ public:
 
     bool load(const std::string& filename);
 
+    /* Creates the texture from a decoded RGBA image of width x height */
+    bool create(unsigned int width, unsigned int height, const std::vector<unsigned char>& image);
+
     void render() const;
 
+    unsigned int getTarget() const;
+    unsigned int getWidth() const;
+    unsigned int getHeight() const;
+
 protected:
     std::vector<unsigned char> image;
     unsigned int width;
     unsigned int height;
 
     unsigned int textureId;
+
+    /* GL_TEXTURE_2D, or GL_TEXTURE_2D_ARRAY for a TextureArray */
+    unsigned int target;
 };
 
 #endif
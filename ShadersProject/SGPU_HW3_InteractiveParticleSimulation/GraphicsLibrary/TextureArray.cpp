@@ -0,0 +1,72 @@
+#include "TextureArray.h"
+#include "PNG.h"
+#include "GLState.h"
+#include <iostream>
+#include <gl/glew.h>
+
+TextureArray::TextureArray() {
+    this->target = GL_TEXTURE_2D_ARRAY;
+    this->layerCount = 0;
+}
+
+bool TextureArray::load(const std::vector<std::string>& filenames) {
+    std::vector<std::vector<unsigned char>> layers(filenames.size());
+    unsigned int width = 0, height = 0;
+
+    for ( std::size_t i = 0; i < filenames.size(); i++ ) {
+        unsigned int layerWidth = 0, layerHeight = 0;
+        unsigned int error = lodepng::decode(layers[i], layerWidth, layerHeight, filenames[i], LCT_RGBA);
+        if ( error ) {
+            std::cerr << "[TextureArray:load] Error: Could not load PNG image: " << filenames[i] << std::endl;
+            return false;
+        }
+
+        if ( i == 0 ) {
+            width = layerWidth;
+            height = layerHeight;
+        }
+        else if ( layerWidth != width || layerHeight != height ) {
+            std::cerr << "[TextureArray:load] Error: Image size differs from the first layer: " << filenames[i] << std::endl;
+            return false;
+        }
+    }
+
+    return this->create(width, height, layers);
+}
+
+bool TextureArray::create(unsigned int width, unsigned int height, const std::vector<std::vector<unsigned char>>& layers) {
+    if ( layers.size() == 0 || width == 0 || height == 0 ) {
+        std::cerr << "[TextureArray:create] Error: Empty texture array." << std::endl;
+        return false;
+    }
+
+    std::size_t layerSize = static_cast<std::size_t>(width) * height * 4;
+    for ( std::size_t i = 0; i < layers.size(); i++ ) {
+        if ( layers[i].size() != layerSize ) {
+            std::cerr << "[TextureArray:create] Error: Layer " << i << " is not a " << width << "x" << height << " RGBA image." << std::endl;
+            return false;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Allocate every layer, then upload them one at a time. The decoded images
+    // are not kept, unlike the single image of a Texture.
+    //--------------------------------------------------------------------------
+    if ( this->textureId == 0 ) glGenTextures(1, &this->textureId);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, this->textureId);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, width, height, static_cast<GLsizei>(layers.size()), 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    for ( std::size_t i = 0; i < layers.size(); i++ )
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, static_cast<GLint>(i), width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, &layers[i][0]);
+
+    this->width = width;
+    this->height = height;
+    this->layerCount = static_cast<unsigned int>(layers.size());
+    return true;
+}
+
+unsigned int TextureArray::getLayerCount() const {
+    return this->layerCount;
+}
@@ -0,0 +1,30 @@
+#ifndef TEXTURE_ARRAY_H
+#define TEXTURE_ARRAY_H
+
+#include <string>
+#include <vector>
+#include "Texture.h"
+
+/*
+ * TextureArray: RGBA images of one size stored as the layers of a single
+ * GL_TEXTURE_2D_ARRAY. It binds like any Texture (Texture::render), so a
+ * shader holding arrays binds every layer at once; the shader selects a
+ * layer with a sampler2DArray and a layer coordinate.
+ */
+class TextureArray : public Texture {
+public:
+    TextureArray();
+
+    /* Loads PNG images of equal size as layers 0, 1, ... */
+    bool load(const std::vector<std::string>& filenames);
+
+    /* Creates the array from decoded RGBA images of width x height */
+    bool create(unsigned int width, unsigned int height, const std::vector<std::vector<unsigned char>>& layers);
+
+    unsigned int getLayerCount() const;
+
+protected:
+    unsigned int layerCount;
+};
+
+#endif
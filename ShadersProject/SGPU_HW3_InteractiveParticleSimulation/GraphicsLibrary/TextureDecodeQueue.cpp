@@ -0,0 +1,134 @@
+#include "TextureDecodeQueue.h"
+#include "Parallel.h"
+#include "PNG.h"
+#include <chrono>
+#include <iostream>
+
+TextureDecodeQueue::TextureDecodeQueue(unsigned int threadCount) {
+    this->threadCount = (threadCount == 0) ? ParallelThreadCount() : threadCount;
+    this->stopping = false;
+    this->waitMilliseconds = 0.0;
+}
+
+TextureDecodeQueue::~TextureDecodeQueue() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+
+        //----------------------------------------------------------------------
+        // Images no worker has started are cancelled, only the running
+        // decodes are waited for.
+        //----------------------------------------------------------------------
+        for ( std::size_t i = 0; i < this->pending.size(); i++ ) {
+            std::shared_ptr<DecodedImage>& image = this->images[this->pending[i]];
+            image->valid = false;
+            image->decoded = true;
+        }
+        this->pending.clear();
+    }
+
+    this->queued.notify_all();
+    this->decoded.notify_all();
+    for ( std::size_t i = 0; i < this->workers.size(); i++ )
+        this->workers[i].join();
+}
+
+void TextureDecodeQueue::queue(const std::string& filename) {
+    if ( filename.length() == 0 ) return;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if ( this->images.find(filename) != this->images.end() ) return;
+
+        std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>();
+        image->width = 0;
+        image->height = 0;
+        image->decoded = false;
+        image->valid = false;
+        this->images.insert(std::make_pair(filename, image));
+        this->pending.push_back(filename);
+
+        //----------------------------------------------------------------------
+        // One worker per queued image, up to the thread count.
+        //----------------------------------------------------------------------
+        if ( this->workers.size() < this->threadCount && this->workers.size() < this->images.size() )
+            this->workers.push_back(std::thread(&TextureDecodeQueue::work, this));
+    }
+
+    this->queued.notify_one();
+}
+
+bool TextureDecodeQueue::wait(const std::string& filename, std::shared_ptr<const DecodedImage>& image) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    this->queue(filename);
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    std::map<std::string, std::shared_ptr<DecodedImage>>::const_iterator found = this->images.find(filename);
+    if ( found == this->images.end() ) return false;
+
+    std::shared_ptr<DecodedImage> entry = found->second;
+    this->decoded.wait(lock, [&entry]() { return entry->decoded; });
+
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    this->waitMilliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+    image = entry;
+    return entry->valid;
+}
+
+std::shared_ptr<Texture> TextureDecodeQueue::createTexture(const std::string& filename) {
+    std::shared_ptr<const DecodedImage> image;
+    bool valid = this->wait(filename, image);
+
+    //--------------------------------------------------------------------------
+    // The texture holds the image from now on, the decoded pixels are freed
+    // with the last reference (image below).
+    //--------------------------------------------------------------------------
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        std::map<std::string, std::shared_ptr<DecodedImage>>::iterator found = this->images.find(filename);
+        if ( found != this->images.end() && found->second == image ) this->images.erase(found);
+    }
+
+    if ( !valid ) {
+        std::cerr << "[TextureDecodeQueue:createTexture] Error: Could not load PNG image: " << filename << std::endl;
+        return nullptr;
+    }
+
+    std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+    if ( !texture->create(image->width, image->height, image->pixels) ) return nullptr;
+    return texture;
+}
+
+std::size_t TextureDecodeQueue::getImageCount() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->images.size();
+}
+
+double TextureDecodeQueue::getWaitMilliseconds() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->waitMilliseconds;
+}
+
+void TextureDecodeQueue::work() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+
+    while ( true ) {
+        this->queued.wait(lock, [this]() { return this->stopping || this->pending.size() > 0; });
+        if ( this->pending.size() == 0 ) return;
+
+        std::string filename = this->pending.front();
+        this->pending.pop_front();
+        std::shared_ptr<DecodedImage> image = this->images[filename];
+
+        //----------------------------------------------------------------------
+        // Decode without the lock; the entry is only read once decoded is set.
+        //----------------------------------------------------------------------
+        lock.unlock();
+        unsigned int error = lodepng::decode(image->pixels, image->width, image->height, filename, LCT_RGBA);
+        lock.lock();
+
+        image->valid = (error == 0);
+        image->decoded = true;
+        this->decoded.notify_all();
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef TEXTURE_DECODE_QUEUE_H
+#define TEXTURE_DECODE_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Texture.h"
+
+/* A PNG image decoded to RGBA by a TextureDecodeQueue. */
+struct DecodedImage {
+    std::vector<unsigned char> pixels;
+    unsigned int width;
+    unsigned int height;
+    bool decoded;
+    bool valid;
+};
+
+/*
+ * TextureDecodeQueue: Decodes PNG images on background threads. queue
+ * returns at once, so images can be queued while the caller is still busy
+ * (ObjFile::load queues the maps of a material library as soon as it is
+ * parsed and goes on with the geometry). createTexture waits for the image
+ * and uploads it; textures are GL objects, so only the thread owning the
+ * context calls it.
+ *
+ * The workers start with the first queued image, at most threadCount of
+ * them (ParallelThreadCount by default). The destructor cancels the images
+ * no worker has started and waits for the ones being decoded. A file is
+ * decoded once however often it is queued until createTexture uploads it;
+ * the pixels are released then, and queueing the file again decodes it
+ * again.
+ */
+class TextureDecodeQueue {
+public:
+    TextureDecodeQueue(unsigned int threadCount = 0);
+    ~TextureDecodeQueue();
+
+    void queue(const std::string& filename);
+
+    /* Waits for the image (queueing it if needed); false if it could not be decoded. */
+    bool wait(const std::string& filename, std::shared_ptr<const DecodedImage>& image);
+
+    /* Waits for the image, creates a texture of it and releases the pixels; nullptr on failure. */
+    std::shared_ptr<Texture> createTexture(const std::string& filename);
+
+    /* Images queued, being decoded or decoded and not yet uploaded. */
+    std::size_t getImageCount() const;
+
+    /* Time the calling thread spent in wait, the decoding it did not overlap. */
+    double getWaitMilliseconds() const;
+
+protected:
+    void work();
+
+protected:
+    mutable std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable decoded;
+
+    std::deque<std::string> pending;
+    std::map<std::string, std::shared_ptr<DecodedImage>> images;
+    std::vector<std::thread> workers;
+    unsigned int threadCount;
+    bool stopping;
+
+    double waitMilliseconds;
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "TransformFeedbackParticleEngine.h"
+#include "TransformFeedbackShader.h"
+#include "GLState.h"
+
+TransformFeedbackParticleEngine::TransformFeedbackParticleEngine() {
+    this->shader = nullptr;
+    this->vboIds[0] = 0;
+    this->vboIds[1] = 0;
+    this->current = 0;
+    this->particleCount = 0;
+    this->frame = 0;
+}
+
+TransformFeedbackParticleEngine::~TransformFeedbackParticleEngine() {
+    GLState::DeleteBuffer(this->vboIds[0]);
+    GLState::DeleteBuffer(this->vboIds[1]);
+}
+
+bool TransformFeedbackParticleEngine::loadShader(const std::string& vertexFilename) {
+    //--------------------------------------------------------------------------
+    // The captured outputs are interleaved in the same order as the members of
+    // the Particle structure so the output buffer can be rendered directly.
+    //--------------------------------------------------------------------------
+    std::vector<std::string> varyings;
+    varyings.push_back("outPosition");
+    varyings.push_back("outVelocity");
+    varyings.push_back("outForce");
+    varyings.push_back("outColor");
+    varyings.push_back("outMass");
+    varyings.push_back("outLifetime");
+
+    this->shader = std::make_shared<TransformFeedbackShader>();
+
+    if ( !this->shader->load(vertexFilename, varyings) ) {
+        std::cerr << "[TransformFeedbackParticleEngine:loadShader] Error: Could not load shader." << std::endl;
+        return false;
+    }
+
+    if ( !this->shader->compile() ) {
+        std::cerr << "[TransformFeedbackParticleEngine:loadShader] Error: Could not compile shader." << std::endl;
+        return false;
+    }
+
+    BindParticleAttributeLocations(this->shader->getProgramID());
+
+    if ( !this->shader->link() ) {
+        std::cerr << "[TransformFeedbackParticleEngine:loadShader] Error: Could not link shader program." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TransformFeedbackParticleEngine::construct(const std::vector<Particle>& particles) {
+    if ( particles.size() == 0 ) return false;
+
+    //--------------------------------------------------------------------------
+    // Both buffers are written by the GPU every other frame, so they are
+    // allocated with a copy hint. Only the first buffer receives the initial
+    // particle state.
+    //--------------------------------------------------------------------------
+    if ( this->vboIds[0] == 0 ) glGenBuffers(2, this->vboIds);
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboIds[0]);
+    glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(Particle), &particles[0], GL_DYNAMIC_COPY);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboIds[1]);
+    glBufferData(GL_ARRAY_BUFFER, particles.size() * sizeof(Particle), NULL, GL_DYNAMIC_COPY);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+
+    this->current = 0;
+    this->particleCount = particles.size();
+    return true;
+}
+
+void TransformFeedbackParticleEngine::update(std::vector<Particle>& /* particles */, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt) {
+    if ( this->shader == nullptr || this->particleCount == 0 ) return;
+
+    unsigned int source = this->vboIds[this->current];
+    unsigned int destination = this->vboIds[1 - this->current];
+
+    this->shader->enable();
+    this->shader->uniform1f("dt", dt);
+    this->shader->uniform1i("spawnParticles", spawnParticles ? 1 : 0);
+    this->shader->uniformVector("spawnPosition", spawnPosition);
+    this->shader->uniformVector("spawnVelocity", spawnDirection * parameters.initVelocity);
+    this->shader->uniformVector("gravity", parameters.gravity);
+    this->shader->uniform3f("baseColor", parameters.color.r(), parameters.color.g(), parameters.color.b());
+    this->shader->uniform1f("minLifetime", parameters.minLifetime);
+    this->shader->uniform1f("maxLifetime", parameters.maxLifetime);
+    this->shader->uniform1f("bounceEnergy", parameters.bounceEnergy);
+    this->shader->uniform1f("extent", parameters.extent);
+    this->shader->uniformVector("hiddenPosition", hiddenPosition);
+    this->shader->uniform1i("seed", static_cast<int>(this->frame));
+
+    //--------------------------------------------------------------------------
+    // The attributes are described on the default vertex array, which leaves
+    // the vertex arrays of the drawables untouched.
+    //--------------------------------------------------------------------------
+    GLState::BindVertexArray(0);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, source);
+    EnableParticleAttributes();
+
+    //--------------------------------------------------------------------------
+    // Every particle is processed as a single point. Rasterization is disabled
+    // because the only result of interest is the captured vertex output.
+    //--------------------------------------------------------------------------
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, destination);
+    glEnable(GL_RASTERIZER_DISCARD);
+    glBeginTransformFeedback(GL_POINTS);
+    glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(this->particleCount));
+    glEndTransformFeedback();
+    glDisable(GL_RASTERIZER_DISCARD);
+    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+
+    DisableParticleAttributes();
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    this->shader->disable();
+
+    this->current = 1 - this->current;
+    this->frame++;
+}
+
+bool TransformFeedbackParticleEngine::readBack(std::vector<Particle>& particles) const {
+    if ( this->particleCount == 0 ) return false;
+
+    particles.resize(this->particleCount);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, this->vboIds[this->current]);
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, this->particleCount * sizeof(Particle), &particles[0]);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, 0);
+    return true;
+}
+
+bool TransformFeedbackParticleEngine::isGpuResident() const {
+    return true;
+}
+
+unsigned int TransformFeedbackParticleEngine::getVertexBuffer() const {
+    return this->vboIds[this->current];
+}
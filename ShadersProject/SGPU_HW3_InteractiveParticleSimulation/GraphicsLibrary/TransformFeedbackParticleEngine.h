@@ -0,0 +1,46 @@
+#ifndef TRANSFORM_FEEDBACK_PARTICLE_ENGINE_H
+#define TRANSFORM_FEEDBACK_PARTICLE_ENGINE_H
+
+#include <memory>
+#include <string>
+#include "ParticleEngine.h"
+
+class TransformFeedbackShader;
+
+/*
+ * Particle engine that performs the integration, box collision and respawn
+ * of the particles in a vertex shader. The results are captured with
+ * transform feedback into a second vertex buffer, and the two buffers are
+ * swapped every update so the particle data never leaves the GPU.
+ * Particle-particle collisions (particleRadius) are not simulated.
+ */
+class TransformFeedbackParticleEngine : public ParticleEngine {
+public:
+    TransformFeedbackParticleEngine();
+    virtual ~TransformFeedbackParticleEngine();
+
+    /* Load the vertex shader that performs the simulation step. */
+    bool loadShader(const std::string& vertexFilename);
+
+    virtual bool construct(const std::vector<Particle>& particles);
+    virtual void update(std::vector<Particle>& particles, const ParticleParameters& parameters, bool spawnParticles, const Vector3f& spawnPosition, const Vector3f& spawnDirection, float dt);
+    virtual bool readBack(std::vector<Particle>& particles) const;
+    virtual bool isGpuResident() const;
+    virtual unsigned int getVertexBuffer() const;
+
+protected:
+    std::shared_ptr<TransformFeedbackShader> shader;
+
+    /*
+     * Ping-pong vertex buffers. The particles are read from vboIds[current]
+     * and written into the other buffer during an update.
+     */
+    unsigned int vboIds[2];
+    unsigned int current;
+    std::size_t particleCount;
+
+    /* Incremented every update to seed the random numbers of the shader. */
+    unsigned int frame;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "TransformFeedbackShader.h"
+
+TransformFeedbackShader::TransformFeedbackShader() {}
+
+TransformFeedbackShader::~TransformFeedbackShader() {}
+
+bool TransformFeedbackShader::load(const std::string& vertexFilename, const std::vector<std::string>& varyings) {
+    if ( varyings.size() == 0 ) {
+        std::cerr << "[TransformFeedbackShader:load] Error: No varyings to capture." << std::endl;
+        return false;
+    }
+
+    if ( !this->loadFile(vertexFilename, this->vertSource) ) return false;
+
+    this->vertFilename = vertexFilename;
+    this->varyings = varyings;
+    this->vertexId = glCreateShader(GL_VERTEX_SHADER);
+
+    const char* vsource_cstr = this->vertSource.c_str();
+    glShaderSource(this->vertexId, 1, &vsource_cstr, 0);
+    return true;
+}
+
+bool TransformFeedbackShader::compile() {
+    glCompileShader(this->vertexId);
+    if ( !this->compileStatus(this->vertexId, this->vertFilename) ) return false;
+
+    if ( this->programId == 0 ) this->programId = glCreateProgram();
+    return true;
+}
+
+bool TransformFeedbackShader::link() {
+    if ( this->programId == 0 ) this->programId = glCreateProgram();
+    glAttachShader(this->programId, this->vertexId);
+
+    //--------------------------------------------------------------------------
+    // The captured outputs are part of the program's link state, so they have
+    // to be declared before the program is linked.
+    //--------------------------------------------------------------------------
+    std::vector<const char*> names(this->varyings.size());
+    for ( std::size_t i = 0; i < this->varyings.size(); i++ )
+        names[i] = this->varyings[i].c_str();
+
+    glTransformFeedbackVaryings(this->programId, static_cast<GLsizei>(names.size()), &names[0], GL_INTERLEAVED_ATTRIBS);
+    glLinkProgram(this->programId);
+
+    if ( !this->linkStatus(this->programId) ) return false;
+    return true;
+}
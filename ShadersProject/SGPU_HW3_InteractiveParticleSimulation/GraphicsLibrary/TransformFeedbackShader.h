@@ -0,0 +1,26 @@
+#ifndef TRANSFORM_FEEDBACK_SHADER_H
+#define TRANSFORM_FEEDBACK_SHADER_H
+
+#include <string>
+#include <vector>
+#include "Shader.h"
+
+/*
+ * Vertex-only shader program whose outputs are captured with transform
+ * feedback. The captured varyings must be provided before linking so they
+ * are interleaved into the output buffer in the order given.
+ */
+class TransformFeedbackShader : public Shader {
+public:
+    TransformFeedbackShader();
+    virtual ~TransformFeedbackShader();
+
+    virtual bool load(const std::string& vertexFilename, const std::vector<std::string>& varyings);
+    virtual bool compile();
+    virtual bool link();
+
+protected:
+    std::vector<std::string> varyings;
+};
+
+#endif
@@ -0,0 +1,410 @@
+#include "TriangleBVH.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+
+const static unsigned int SAH_BIN_COUNT = 12;
+const static unsigned int MAX_LEAF_SIZE = 16;
+const static unsigned int MAX_STACK_DEPTH = 64;
+const static std::size_t MIN_PARALLEL_RANGE = 256;
+
+/* Axis aligned bounds used while building the hierarchy. */
+struct BuildBounds {
+    float minimum[3];
+    float maximum[3];
+
+    BuildBounds() {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            this->minimum[k] = FLT_MAX;
+            this->maximum[k] = -FLT_MAX;
+        }
+    }
+
+    void grow(const float* point) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            this->minimum[k] = std::min(this->minimum[k], point[k]);
+            this->maximum[k] = std::max(this->maximum[k], point[k]);
+        }
+    }
+
+    void grow(const BuildBounds& bounds) {
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            this->minimum[k] = std::min(this->minimum[k], bounds.minimum[k]);
+            this->maximum[k] = std::max(this->maximum[k], bounds.maximum[k]);
+        }
+    }
+
+    float area() const {
+        float ex = this->maximum[0] - this->minimum[0];
+        float ey = this->maximum[1] - this->minimum[1];
+        float ez = this->maximum[2] - this->minimum[2];
+        if ( ex < 0.0f || ey < 0.0f || ez < 0.0f ) return 0.0f;
+        return ex * ey + ey * ez + ez * ex;
+    }
+};
+
+/* Bounds and centroid of a triangle used while building the hierarchy. */
+struct BuildPrimitive {
+    BuildBounds bounds;
+    float centroid[3];
+};
+
+/* Transforms a point by the matrix using the row-vector convention of Matrix4. */
+static Vector3f TransformPoint(const Matrix4f& m, const Vector3f& p) {
+    return Vector3f(p.x() * m(0, 0) + p.y() * m(1, 0) + p.z() * m(2, 0) + m(3, 0),
+                    p.x() * m(0, 1) + p.y() * m(1, 1) + p.z() * m(2, 1) + m(3, 1),
+                    p.x() * m(0, 2) + p.y() * m(1, 2) + p.z() * m(2, 2) + m(3, 2));
+}
+
+static inline float Dot(const Vector3f& u, const Vector3f& v) {
+    return u.x() * v.x() + u.y() * v.y() + u.z() * v.z();
+}
+
+static inline Vector3f Cross(const Vector3f& u, const Vector3f& v) {
+    return Vector3f(u.y() * v.z() - u.z() * v.y(),
+                    u.z() * v.x() - u.x() * v.z(),
+                    u.x() * v.y() - u.y() * v.x());
+}
+
+/*
+ * Slab test of the segment (given by its origin and inverse direction)
+ * against the node bounds. Returns the entry parameter or FLT_MAX on a miss.
+ */
+static inline float IntersectNode(const BVHNode& node, const float* origin, const float* inverseDirection, float tmax) {
+    float tx1 = (node.minimum[0] - origin[0]) * inverseDirection[0];
+    float tx2 = (node.maximum[0] - origin[0]) * inverseDirection[0];
+    float tmin = std::min(tx1, tx2);
+    float tfar = std::max(tx1, tx2);
+
+    float ty1 = (node.minimum[1] - origin[1]) * inverseDirection[1];
+    float ty2 = (node.maximum[1] - origin[1]) * inverseDirection[1];
+    tmin = std::max(tmin, std::min(ty1, ty2));
+    tfar = std::min(tfar, std::max(ty1, ty2));
+
+    float tz1 = (node.minimum[2] - origin[2]) * inverseDirection[2];
+    float tz2 = (node.maximum[2] - origin[2]) * inverseDirection[2];
+    tmin = std::max(tmin, std::min(tz1, tz2));
+    tfar = std::min(tfar, std::max(tz1, tz2));
+
+    if ( tfar >= tmin && tfar >= 0.0f && tmin <= tmax ) return tmin;
+    return FLT_MAX;
+}
+
+TriangleBVH::TriangleBVH() {
+    this->depth = 0;
+}
+
+TriangleBVH::~TriangleBVH() {}
+
+bool TriangleBVH::build(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const Matrix4f& transform) {
+    this->nodes.clear();
+    this->triangles.clear();
+    this->faceIndices.clear();
+    this->depth = 0;
+
+    if ( vertices.size() == 0 || faces.size() == 0 ) {
+        std::cerr << "[TriangleBVH:build] Error: Mesh has no triangles." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Transform the vertices into world space once and compute the bounds and
+    // centroid of every triangle.
+    //--------------------------------------------------------------------------
+    std::vector<Vector3f> positions(vertices.size());
+    for ( std::size_t i = 0; i < vertices.size(); i++ )
+        positions[i] = TransformPoint(transform, vertices[i].position);
+
+    std::size_t faceCount = faces.size();
+    std::vector<BuildPrimitive> primitives(faceCount);
+    std::vector<unsigned int> order(faceCount);
+
+    for ( std::size_t i = 0; i < faceCount; i++ ) {
+        BuildPrimitive& primitive = primitives[i];
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            unsigned int index = faces[i].indices[k];
+            if ( index >= positions.size() ) {
+                std::cerr << "[TriangleBVH:build] Error: Face references an invalid vertex." << std::endl;
+                return false;
+            }
+            primitive.bounds.grow(positions[index].constData());
+        }
+
+        for ( unsigned int k = 0; k < 3; k++ )
+            primitive.centroid[k] = 0.5f * (primitive.bounds.minimum[k] + primitive.bounds.maximum[k]);
+        order[i] = static_cast<unsigned int>(i);
+    }
+
+    //--------------------------------------------------------------------------
+    // Node 0 is the root and node 1 is left unused so every sibling pair
+    // starts at an even index and shares a cache line.
+    //--------------------------------------------------------------------------
+    this->nodes.reserve(2 * faceCount + 1);
+    this->nodes.resize(2);
+
+    struct BuildTask {
+        unsigned int node;
+        unsigned int first;
+        unsigned int count;
+        unsigned int depth;
+    };
+
+    std::vector<BuildTask> tasks;
+    BuildTask root = { 0, 0, static_cast<unsigned int>(faceCount), 0 };
+    tasks.push_back(root);
+
+    while ( tasks.size() > 0 ) {
+        BuildTask task = tasks.back();
+        tasks.pop_back();
+        this->depth = std::max(this->depth, task.depth);
+
+        BuildBounds bounds;
+        BuildBounds centroidBounds;
+        for ( unsigned int i = task.first; i < task.first + task.count; i++ ) {
+            bounds.grow(primitives[order[i]].bounds);
+            centroidBounds.grow(primitives[order[i]].centroid);
+        }
+
+        BVHNode& node = this->nodes[task.node];
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            node.minimum[k] = bounds.minimum[k];
+            node.maximum[k] = bounds.maximum[k];
+        }
+        node.leftFirst = task.first;
+        node.count = task.count;
+
+        if ( task.count <= 2 ) continue;
+
+        //----------------------------------------------------------------------
+        // Binned SAH: the centroids are binned along every axis and the split
+        // plane with the lowest area-weighted primitive count is selected.
+        //----------------------------------------------------------------------
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        unsigned int bestSplit = 0;
+
+        for ( unsigned int axis = 0; axis < 3; axis++ ) {
+            float extent = centroidBounds.maximum[axis] - centroidBounds.minimum[axis];
+            if ( extent <= 0.0f ) continue;
+
+            BuildBounds binBounds[SAH_BIN_COUNT];
+            unsigned int binCounts[SAH_BIN_COUNT] = { 0 };
+            float scale = SAH_BIN_COUNT / extent;
+
+            for ( unsigned int i = task.first; i < task.first + task.count; i++ ) {
+                const BuildPrimitive& primitive = primitives[order[i]];
+                unsigned int bin = std::min(SAH_BIN_COUNT - 1, static_cast<unsigned int>((primitive.centroid[axis] - centroidBounds.minimum[axis]) * scale));
+                binCounts[bin]++;
+                binBounds[bin].grow(primitive.bounds);
+            }
+
+            float leftAreas[SAH_BIN_COUNT - 1], rightAreas[SAH_BIN_COUNT - 1];
+            unsigned int leftCounts[SAH_BIN_COUNT - 1], rightCounts[SAH_BIN_COUNT - 1];
+            BuildBounds leftBox, rightBox;
+            unsigned int leftSum = 0, rightSum = 0;
+
+            for ( unsigned int i = 0; i < SAH_BIN_COUNT - 1; i++ ) {
+                leftSum += binCounts[i];
+                leftCounts[i] = leftSum;
+                leftBox.grow(binBounds[i]);
+                leftAreas[i] = leftBox.area();
+
+                rightSum += binCounts[SAH_BIN_COUNT - 1 - i];
+                rightCounts[SAH_BIN_COUNT - 2 - i] = rightSum;
+                rightBox.grow(binBounds[SAH_BIN_COUNT - 1 - i]);
+                rightAreas[SAH_BIN_COUNT - 2 - i] = rightBox.area();
+            }
+
+            for ( unsigned int i = 0; i < SAH_BIN_COUNT - 1; i++ ) {
+                if ( leftCounts[i] == 0 || rightCounts[i] == 0 ) continue;
+                float cost = leftCounts[i] * leftAreas[i] + rightCounts[i] * rightAreas[i];
+                if ( cost < bestCost ) {
+                    bestCost = cost;
+                    bestAxis = static_cast<int>(axis);
+                    bestSplit = i;
+                }
+            }
+        }
+
+        //----------------------------------------------------------------------
+        // Keep the node as a leaf when no split is cheaper than intersecting
+        // all of its triangles, unless the leaf would become too large.
+        //----------------------------------------------------------------------
+        float leafCost = task.count * bounds.area();
+        if ( bestAxis < 0 ) continue;
+        if ( bestCost >= leafCost && task.count <= MAX_LEAF_SIZE ) continue;
+
+        float splitMinimum = centroidBounds.minimum[bestAxis];
+        float splitScale = SAH_BIN_COUNT / (centroidBounds.maximum[bestAxis] - splitMinimum);
+        unsigned int* begin = &order[0] + task.first;
+        unsigned int* middle = std::partition(begin, begin + task.count, [&](unsigned int index) {
+            unsigned int bin = std::min(SAH_BIN_COUNT - 1, static_cast<unsigned int>((primitives[index].centroid[bestAxis] - splitMinimum) * splitScale));
+            return bin <= bestSplit;
+        });
+
+        unsigned int leftCount = static_cast<unsigned int>(middle - begin);
+        if ( leftCount == 0 || leftCount == task.count ) continue;
+
+        unsigned int leftIndex = static_cast<unsigned int>(this->nodes.size());
+        this->nodes.resize(this->nodes.size() + 2);
+        this->nodes[task.node].leftFirst = leftIndex;
+        this->nodes[task.node].count = 0;
+
+        BuildTask right = { leftIndex + 1, task.first + leftCount, task.count - leftCount, task.depth + 1 };
+        BuildTask left = { leftIndex, task.first, leftCount, task.depth + 1 };
+        tasks.push_back(right);
+        tasks.push_back(left);
+    }
+
+    //--------------------------------------------------------------------------
+    // Store the triangles in leaf order so a leaf reads one contiguous block.
+    //--------------------------------------------------------------------------
+    this->triangles.resize(faceCount);
+    this->faceIndices.resize(faceCount);
+    for ( std::size_t i = 0; i < faceCount; i++ ) {
+        const TriangleFace& face = faces[order[i]];
+        const Vector3f& a = positions[face.indices[0]];
+        const Vector3f& b = positions[face.indices[1]];
+        const Vector3f& c = positions[face.indices[2]];
+        this->triangles[i].vertex = a;
+        this->triangles[i].edge1 = b - a;
+        this->triangles[i].edge2 = c - a;
+        this->faceIndices[i] = order[i];
+    }
+
+    return true;
+}
+
+bool TriangleBVH::intersectSegment(const Vector3f& start, const Vector3f& end, SegmentHit& hit) const {
+    hit.t = FLT_MAX;
+    hit.triangle = BVH_NO_HIT;
+    if ( this->nodes.size() == 0 ) return false;
+
+    Vector3f direction = end - start;
+    float origin[3] = { start.x(), start.y(), start.z() };
+    float inverseDirection[3];
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        float d = direction[k];
+        if ( std::abs(d) < 1e-20f ) d = (d < 0.0f) ? -1e-20f : 1e-20f;
+        inverseDirection[k] = 1.0f / d;
+    }
+
+    float closest = 1.0f;
+    unsigned int closestTriangle = BVH_NO_HIT;
+    //--------------------------------------------------------------------------
+    // Every visited node pushes at most its two children, so the stack holds
+    // at most one entry per level plus one. The SAH build does not bound the
+    // depth; deeper hierarchies (degenerate inputs) use a heap stack.
+    //--------------------------------------------------------------------------
+    unsigned int localStack[MAX_STACK_DEPTH];
+    std::vector<unsigned int> heapStack;
+    unsigned int* stack = localStack;
+    unsigned int stackCapacity = this->depth + 1;
+    if ( stackCapacity > MAX_STACK_DEPTH ) {
+        heapStack.resize(stackCapacity);
+        stack = &heapStack[0];
+    }
+
+    unsigned int stackSize = 0;
+
+    if ( IntersectNode(this->nodes[0], origin, inverseDirection, closest) == FLT_MAX ) return false;
+    stack[stackSize++] = 0;
+
+    while ( stackSize > 0 ) {
+        const BVHNode& node = this->nodes[stack[--stackSize]];
+
+        if ( node.count > 0 ) {
+            //------------------------------------------------------------------
+            // Moller-Trumbore intersection against every triangle of the leaf.
+            //------------------------------------------------------------------
+            for ( unsigned int i = node.leftFirst; i < node.leftFirst + node.count; i++ ) {
+                const BVHTriangle& triangle = this->triangles[i];
+                Vector3f p = Cross(direction, triangle.edge2);
+                float determinant = Dot(triangle.edge1, p);
+                if ( std::abs(determinant) < 1e-12f ) continue;
+
+                float inverseDeterminant = 1.0f / determinant;
+                Vector3f s = start - triangle.vertex;
+                float u = Dot(s, p) * inverseDeterminant;
+                if ( u < 0.0f || u > 1.0f ) continue;
+
+                Vector3f q = Cross(s, triangle.edge1);
+                float v = Dot(direction, q) * inverseDeterminant;
+                if ( v < 0.0f || u + v > 1.0f ) continue;
+
+                float t = Dot(triangle.edge2, q) * inverseDeterminant;
+                if ( t >= 0.0f && t < closest ) {
+                    closest = t;
+                    closestTriangle = i;
+                }
+            }
+            continue;
+        }
+
+        //----------------------------------------------------------------------
+        // Visit the nearer child first so the farther one can be culled by the
+        // shortened segment.
+        //----------------------------------------------------------------------
+        unsigned int left = node.leftFirst;
+        unsigned int right = left + 1;
+        float tLeft = IntersectNode(this->nodes[left], origin, inverseDirection, closest);
+        float tRight = IntersectNode(this->nodes[right], origin, inverseDirection, closest);
+
+        if ( tLeft > tRight ) {
+            std::swap(tLeft, tRight);
+            std::swap(left, right);
+        }
+
+        assert(stackSize + 2 <= stackCapacity);
+        if ( tRight != FLT_MAX ) stack[stackSize++] = right;
+        if ( tLeft != FLT_MAX ) stack[stackSize++] = left;
+    }
+
+    if ( closestTriangle == BVH_NO_HIT ) return false;
+
+    const BVHTriangle& triangle = this->triangles[closestTriangle];
+    Vector3f normal = Cross(triangle.edge1, triangle.edge2);
+    float length = std::sqrt(Dot(normal, normal));
+    if ( length > 0.0f ) normal = normal * (1.0f / length);
+    if ( Dot(normal, direction) > 0.0f ) normal = normal * -1.0f;
+
+    hit.t = closest;
+    hit.triangle = this->faceIndices[closestTriangle];
+    hit.normal = normal;
+    return true;
+}
+
+std::size_t TriangleBVH::intersectSegments(const Vector3f* starts, const Vector3f* ends, std::size_t count, SegmentHit* hits) const {
+    std::size_t ranges = ParallelRangeCount(count, MIN_PARALLEL_RANGE);
+    std::vector<std::size_t> rangeHits(ranges, 0);
+
+    ParallelFor(0, count, MIN_PARALLEL_RANGE, [&](std::size_t begin, std::size_t end, std::size_t range) {
+        std::size_t hitCount = 0;
+        for ( std::size_t i = begin; i < end; i++ )
+            if ( this->intersectSegment(starts[i], ends[i], hits[i]) ) hitCount++;
+        rangeHits[range] = hitCount;
+    });
+
+    std::size_t total = 0;
+    for ( std::size_t r = 0; r < ranges; r++ ) total += rangeHits[r];
+    return total;
+}
+
+std::size_t TriangleBVH::getNodeCount() const {
+    return this->nodes.size();
+}
+
+unsigned int TriangleBVH::getDepth() const {
+    return this->depth;
+}
+
+std::size_t TriangleBVH::getTriangleCount() const {
+    return this->triangles.size();
+}
+
+bool TriangleBVH::isEmpty() const {
+    return this->triangles.size() == 0;
+}
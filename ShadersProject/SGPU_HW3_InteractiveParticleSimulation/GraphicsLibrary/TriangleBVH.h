@@ -0,0 +1,85 @@
+#ifndef TRIANGLE_BVH_H
+#define TRIANGLE_BVH_H
+
+#include <vector>
+#include <Matrix4.h>
+#include <Vector3.h>
+#include "Vertex.h"
+#include "Face.h"
+
+const static unsigned int BVH_NO_HIT = 0xFFFFFFFF;
+
+/*
+ * Flattened BVH node (32 bytes, two nodes per cache line). Interior nodes
+ * store the index of their left child, the right child immediately follows
+ * it. Leaves store the first triangle and the number of triangles.
+ */
+struct BVHNode {
+    float minimum[3];
+    unsigned int leftFirst;
+    float maximum[3];
+    unsigned int count;
+};
+
+/* Triangle stored as one vertex and two edges for the intersection test. */
+struct BVHTriangle {
+    Vector3f vertex;
+    Vector3f edge1;
+    Vector3f edge2;
+};
+
+/*
+ * Result of a segment query. The parameter t is in [0, 1] along the segment,
+ * triangle is BVH_NO_HIT if nothing was hit and the normal is the unit
+ * normal of the hit triangle facing the start of the segment.
+ */
+struct SegmentHit {
+    float t;
+    unsigned int triangle;
+    Vector3f normal;
+};
+
+/*
+ * Static bounding volume hierarchy over the world-space triangles of a mesh.
+ * The hierarchy is built top-down with a binned surface area heuristic and
+ * stored depth-first in a single array with siblings adjacent in memory.
+ */
+class TriangleBVH {
+public:
+    TriangleBVH();
+    ~TriangleBVH();
+
+    /*
+     * Builds the hierarchy over the faces of the mesh after transforming the
+     * vertices by transform (the matrix of the mesh Transformation).
+     */
+    bool build(const std::vector<Vertex>& vertices, const std::vector<TriangleFace>& faces, const Matrix4f& transform);
+
+    /* Finds the closest triangle hit by the segment from start to end. */
+    bool intersectSegment(const Vector3f& start, const Vector3f& end, SegmentHit& hit) const;
+
+    /*
+     * Batched segment queries. The segments are distributed over threads and
+     * hits[i] receives the result of the segment from starts[i] to ends[i].
+     * Returns the number of segments that hit the mesh.
+     */
+    std::size_t intersectSegments(const Vector3f* starts, const Vector3f* ends, std::size_t count, SegmentHit* hits) const;
+
+    std::size_t getNodeCount() const;
+
+    /* Levels below the root of the deepest leaf; sizes the traversal stack. */
+    unsigned int getDepth() const;
+    std::size_t getTriangleCount() const;
+    bool isEmpty() const;
+
+protected:
+    std::vector<BVHNode> nodes;
+    std::vector<BVHTriangle> triangles;
+
+    /* Index of the original face of every (reordered) triangle. */
+    std::vector<unsigned int> faceIndices;
+
+    unsigned int depth;
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include "Triangulation.h"
+#include "Parallel.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+const static std::size_t TRIANGLE_CORNERS = 3;
+const static std::size_t QUAD_CORNERS = 4;
+
+/* Projected corners and the remaining outline of a polygon being clipped. */
+struct PolygonScratch {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<unsigned int> previous;
+    std::vector<unsigned int> next;
+};
+
+/* Twice the signed area of the 2D triangle (a, b, c); positive if counter-clockwise. */
+static float Orient(const PolygonScratch& s, unsigned int a, unsigned int b, unsigned int c) {
+    return (s.x[b] - s.x[a]) * (s.y[c] - s.y[a]) - (s.y[b] - s.y[a]) * (s.x[c] - s.x[a]);
+}
+
+/* Sum of the edge cross products (Newell's method): the area normal of the outline. */
+static Vector3f NewellNormal(const std::vector<Vector3f>& positions, const std::size_t* vertexIndices, std::size_t cornerCount) {
+    float nx = 0.0f, ny = 0.0f, nz = 0.0f;
+    for ( std::size_t i = 0, j = cornerCount - 1; i < cornerCount; j = i++ ) {
+        const Vector3f& a = positions[vertexIndices[j]];
+        const Vector3f& b = positions[vertexIndices[i]];
+        nx += (a.y() - b.y()) * (a.z() + b.z());
+        ny += (a.z() - b.z()) * (a.x() + b.x());
+        nz += (a.x() - b.x()) * (a.y() + b.y());
+    }
+
+    return Vector3f(nx, ny, nz);
+}
+
+static void Fan(std::size_t first, std::size_t cornerCount, unsigned int* triangles) {
+    for ( std::size_t i = 1; i + 1 < cornerCount; i++ ) {
+        triangles[0] = static_cast<unsigned int>(first);
+        triangles[1] = static_cast<unsigned int>((first + i) % cornerCount);
+        triangles[2] = static_cast<unsigned int>((first + i + 1) % cornerCount);
+        triangles += TRIANGLE_CORNERS;
+    }
+}
+
+//------------------------------------------------------------------------------
+// A quad is convex if the turn at every corner agrees with its normal; the
+// area normal of a quad is the cross product of its diagonals. A concave
+// quad has one reflex corner, the only one both of its triangles can share.
+//------------------------------------------------------------------------------
+static void TriangulateQuad(const std::vector<Vector3f>& positions, const std::size_t* vertexIndices, unsigned int* triangles) {
+    const Vector3f& p0 = positions[vertexIndices[0]];
+    const Vector3f& p1 = positions[vertexIndices[1]];
+    const Vector3f& p2 = positions[vertexIndices[2]];
+    const Vector3f& p3 = positions[vertexIndices[3]];
+    Vector3f normal = Vector3f::Cross(p2 - p0, p3 - p1);
+
+    const Vector3f* corners[QUAD_CORNERS] = { &p0, &p1, &p2, &p3 };
+    std::size_t first = 0;
+    for ( std::size_t i = 0; i < QUAD_CORNERS; i++ ) {
+        const Vector3f& previous = *corners[(i + QUAD_CORNERS - 1) % QUAD_CORNERS];
+        const Vector3f& corner = *corners[i];
+        const Vector3f& next = *corners[(i + 1) % QUAD_CORNERS];
+        if ( Vector3f::Dot(Vector3f::Cross(corner - previous, next - corner), normal) < 0.0 ) {
+            first = i;
+            break;
+        }
+    }
+
+    Fan(first, QUAD_CORNERS, triangles);
+}
+
+//------------------------------------------------------------------------------
+// Ear clipping. The outline is projected onto the coordinate plane most
+// parallel to it, mirrored if needed so it runs counter-clockwise. An ear is
+// a convex corner whose triangle holds no other remaining corner; clipping
+// it removes the corner from the outline. Every clip gives one triangle, so
+// the polygon always ends up as cornerCount - 2 triangles.
+//------------------------------------------------------------------------------
+static bool ClipEars(const std::vector<Vector3f>& positions, const std::size_t* vertexIndices, std::size_t cornerCount, unsigned int* triangles, PolygonScratch& s) {
+    Vector3f normal = NewellNormal(positions, vertexIndices, cornerCount);
+    float ax = std::fabs(normal.x()), ay = std::fabs(normal.y()), az = std::fabs(normal.z());
+    if ( ax + ay + az == 0.0f ) {
+        Fan(0, cornerCount, triangles);
+        return false;
+    }
+
+    unsigned int u = 0, v = 1;
+    float sign = normal.z();
+    if ( ax >= ay && ax >= az ) { u = 1; v = 2; sign = normal.x(); }
+    else if ( ay >= az ) { u = 2; v = 0; sign = normal.y(); }
+
+    s.x.resize(cornerCount);
+    s.y.resize(cornerCount);
+    s.previous.resize(cornerCount);
+    s.next.resize(cornerCount);
+    for ( std::size_t i = 0; i < cornerCount; i++ ) {
+        const Vector3f& p = positions[vertexIndices[i]];
+        s.x[i] = (sign < 0.0f) ? -p[u] : p[u];
+        s.y[i] = p[v];
+        s.previous[i] = static_cast<unsigned int>((i + cornerCount - 1) % cornerCount);
+        s.next[i] = static_cast<unsigned int>((i + 1) % cornerCount);
+    }
+
+    bool clean = true;
+    std::size_t remaining = cornerCount;
+    std::size_t stalled = 0;
+    unsigned int corner = 0;
+    while ( remaining > TRIANGLE_CORNERS ) {
+        unsigned int previous = s.previous[corner];
+        unsigned int next = s.next[corner];
+
+        bool ear = Orient(s, previous, corner, next) > 0.0f;
+        for ( unsigned int other = s.next[next]; ear && other != previous; other = s.next[other] ) {
+            if ( Orient(s, previous, corner, other) >= 0.0f && Orient(s, corner, next, other) >= 0.0f && Orient(s, next, previous, other) >= 0.0f )
+                ear = false;
+        }
+
+        //----------------------------------------------------------------------
+        // A full turn around the outline without an ear: clip the corner that
+        // turns furthest counter-clockwise, which is the least wrong choice.
+        //----------------------------------------------------------------------
+        if ( !ear && ++stalled >= remaining ) {
+            float best = -std::numeric_limits<float>::max();
+            for ( std::size_t i = 0, candidate = corner; i < remaining; i++, candidate = s.next[candidate] ) {
+                float turn = Orient(s, s.previous[candidate], static_cast<unsigned int>(candidate), s.next[candidate]);
+                if ( turn > best ) {
+                    best = turn;
+                    corner = static_cast<unsigned int>(candidate);
+                }
+            }
+
+            previous = s.previous[corner];
+            next = s.next[corner];
+            ear = true;
+            clean = false;
+        }
+
+        if ( !ear ) {
+            corner = next;
+            continue;
+        }
+
+        triangles[0] = previous;
+        triangles[1] = corner;
+        triangles[2] = next;
+        triangles += TRIANGLE_CORNERS;
+
+        s.next[previous] = next;
+        s.previous[next] = previous;
+        remaining--;
+        stalled = 0;
+        corner = next;
+    }
+
+    triangles[0] = s.previous[corner];
+    triangles[1] = corner;
+    triangles[2] = s.next[corner];
+    return clean;
+}
+
+bool TriangulatePolygon(const std::vector<Vector3f>& positions, const std::size_t* vertexIndices, std::size_t cornerCount, unsigned int* triangles) {
+    if ( cornerCount < TRIANGLE_CORNERS ) return false;
+    if ( cornerCount == TRIANGLE_CORNERS ) {
+        Fan(0, cornerCount, triangles);
+        return true;
+    }
+
+    if ( cornerCount == QUAD_CORNERS ) {
+        TriangulateQuad(positions, vertexIndices, triangles);
+        return true;
+    }
+
+    PolygonScratch scratch;
+    return ClipEars(positions, vertexIndices, cornerCount, triangles, scratch);
+}
+
+bool TriangulateObjFaces(const std::vector<const Obj_Face*>& faces, const std::vector<Vector3f>& positions, ObjTriangles& triangles, std::size_t minimumRange) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    triangles.statistics = TriangulationStatistics();
+    triangles.statistics.faceCount = faces.size();
+
+    //--------------------------------------------------------------------------
+    // The triangle count of a face only depends on its corner count, so the
+    // offsets are known before any face is triangulated.
+    //--------------------------------------------------------------------------
+    triangles.faceOffsets.resize(faces.size() + 1);
+    std::size_t triangleCount = 0;
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        triangles.faceOffsets[i] = triangleCount;
+        std::size_t cornerCount = faces[i]->vertexIndices.size();
+        if ( cornerCount >= TRIANGLE_CORNERS ) triangleCount += cornerCount - 2;
+    }
+
+    triangles.faceOffsets[faces.size()] = triangleCount;
+    triangles.vertexIndices.resize(triangleCount * TRIANGLE_CORNERS);
+    triangles.textureIndices.resize(triangleCount * TRIANGLE_CORNERS);
+    triangles.normalIndices.resize(triangleCount * TRIANGLE_CORNERS);
+
+    std::size_t rangeCount = ParallelRangeCount(faces.size(), minimumRange);
+    std::vector<TriangulationStatistics> rangeStatistics(rangeCount, TriangulationStatistics());
+    std::vector<char> rangeValid(rangeCount, 1);
+
+    ParallelFor(0, faces.size(), minimumRange, [&](std::size_t begin, std::size_t end, std::size_t range) {
+        PolygonScratch scratch;
+        std::vector<unsigned int> corners;
+        TriangulationStatistics& statistics = rangeStatistics[range];
+
+        for ( std::size_t i = begin; i < end; i++ ) {
+            const Obj_Face& face = *faces[i];
+            std::size_t cornerCount = face.vertexIndices.size();
+            if ( cornerCount < TRIANGLE_CORNERS ) continue;
+
+            for ( std::size_t j = 0; j < cornerCount; j++ ) {
+                if ( face.vertexIndices[j] >= positions.size() ) {
+                    rangeValid[range] = 0;
+                    return;
+                }
+            }
+
+            //------------------------------------------------------------------
+            // Corner numbers of the face's triangles, then the three index
+            // arrays are filled from them.
+            //------------------------------------------------------------------
+            corners.resize((cornerCount - 2) * TRIANGLE_CORNERS);
+            if ( cornerCount == TRIANGLE_CORNERS ) Fan(0, cornerCount, &corners[0]);
+            else if ( cornerCount == QUAD_CORNERS ) {
+                TriangulateQuad(positions, &face.vertexIndices[0], &corners[0]);
+                statistics.quadCount++;
+            }
+            else {
+                if ( !ClipEars(positions, &face.vertexIndices[0], cornerCount, &corners[0], scratch) ) statistics.fallbackCount++;
+                statistics.polygonCount++;
+            }
+
+            std::size_t offset = triangles.faceOffsets[i] * TRIANGLE_CORNERS;
+            for ( std::size_t j = 0; j < corners.size(); j++ ) {
+                unsigned int corner = corners[j];
+                triangles.vertexIndices[offset + j] = static_cast<unsigned int>(face.vertexIndices[corner]);
+                triangles.textureIndices[offset + j] = static_cast<unsigned int>(face.textureIndices[corner]);
+                triangles.normalIndices[offset + j] = static_cast<unsigned int>(face.normalIndices[corner]);
+            }
+        }
+    });
+
+    for ( std::size_t r = 0; r < rangeCount; r++ ) {
+        if ( !rangeValid[r] ) {
+            std::cerr << "[Triangulation:TriangulateObjFaces] Error: Face vertex index out of range." << std::endl;
+            return false;
+        }
+
+        triangles.statistics.quadCount += rangeStatistics[r].quadCount;
+        triangles.statistics.polygonCount += rangeStatistics[r].polygonCount;
+        triangles.statistics.fallbackCount += rangeStatistics[r].fallbackCount;
+    }
+
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    triangles.statistics.triangleCount = triangleCount;
+    triangles.statistics.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    return true;
+}
@@ -0,0 +1,61 @@
+#ifndef TRIANGULATION_H
+#define TRIANGULATION_H
+
+#include <vector>
+#include <Vector3.h>
+#include "ObjMesh.h"
+
+/* Faces per range below which TriangulateObjFaces stays on one thread. */
+const static std::size_t TRIANGULATION_MIN_PARALLEL_FACES = 65536;
+
+/*
+ * Result of one TriangulateObjFaces call. Fallbacks are polygons in which
+ * ear clipping found no ear (self-intersecting or degenerate outlines) and
+ * had to clip a corner anyway; the time is the CPU time of the call.
+ */
+struct TriangulationStatistics {
+    std::size_t faceCount;
+    std::size_t quadCount;
+    std::size_t polygonCount;
+    std::size_t fallbackCount;
+    std::size_t triangleCount;
+    double milliseconds;
+};
+
+/*
+ * Triangles of a set of Obj faces as the three corner index arrays Mesh
+ * and Model decompress, three entries per triangle. The triangles of face i
+ * are faceOffsets[i] to faceOffsets[i + 1] - 1; a face with n corners
+ * always gives n - 2 triangles, in the winding of the face.
+ */
+struct ObjTriangles {
+    std::vector<unsigned int> vertexIndices;
+    std::vector<unsigned int> textureIndices;
+    std::vector<unsigned int> normalIndices;
+    std::vector<std::size_t> faceOffsets;
+    TriangulationStatistics statistics;
+};
+
+/*
+ * Splits a polygon into cornerCount - 2 triangles. vertexIndices are the
+ * positions of its corners; triangles receives corner numbers (0 to
+ * cornerCount - 1), three per triangle.
+ *
+ * Triangles are copied. Convex quads are fanned from their first corner, a
+ * concave quad from its reflex corner. Larger polygons are projected onto
+ * the plane of their Newell normal and ear clipped; if no ear is left the
+ * most convex corner is clipped instead. Returns false if that fallback
+ * was needed.
+ */
+bool TriangulatePolygon(const std::vector<Vector3f>& positions, const std::size_t* vertexIndices, std::size_t cornerCount, unsigned int* triangles);
+
+/*
+ * Triangulates the faces in a single pass that writes the corner index
+ * arrays. The triangle offsets of the faces are summed first, then ranges
+ * of at least minimumRange faces are triangulated in parallel into their
+ * own part of the arrays, so the result does not depend on the number of
+ * threads. Fails if a face uses a position that does not exist.
+ */
+bool TriangulateObjFaces(const std::vector<const Obj_Face*>& faces, const std::vector<Vector3f>& positions, ObjTriangles& triangles, std::size_t minimumRange = TRIANGULATION_MIN_PARALLEL_FACES);
+
+#endif
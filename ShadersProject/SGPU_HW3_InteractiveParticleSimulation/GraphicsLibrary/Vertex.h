@@ -3,6 +3,7 @@
 #define VERTEX_H
 
 #include <Vector3.h>
+#include <Vector4.h>
 #include <unordered_map>
 #include "Color3.h"
 
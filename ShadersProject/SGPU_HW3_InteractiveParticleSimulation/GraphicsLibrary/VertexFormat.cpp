@@ -0,0 +1,437 @@
+#include "VertexFormat.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+const static float SNORM16_MAX = 32767.0f;
+const static float UNORM16_MAX = 65535.0f;
+const static float RADIANS_TO_DEGREES = 57.2957795f;
+
+/* Component sizes in bytes, indexed by VertexFormat::ComponentType. */
+const static unsigned int COMPONENT_SIZES[] = { 4, 2, 2, 2 };
+
+unsigned short FloatToHalf(float value) {
+    unsigned int bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    unsigned short sign = static_cast<unsigned short>((bits >> 16) & 0x8000u);
+    unsigned int magnitude = bits & 0x7FFFFFFFu;
+
+    //--------------------------------------------------------------------------
+    // Infinity and NaN keep their class, everything from 65520 up rounds to
+    // infinity.
+    //--------------------------------------------------------------------------
+    if ( magnitude >= 0x7F800000u ) return sign | 0x7C00u | ((magnitude > 0x7F800000u) ? 0x0200u : 0u);
+    if ( magnitude >= 0x477FF000u ) return sign | 0x7C00u;
+
+    //--------------------------------------------------------------------------
+    // Values below 2^-14 become half subnormals (mantissa * 2^-24).
+    //--------------------------------------------------------------------------
+    if ( magnitude < 0x38800000u ) {
+        if ( magnitude < 0x33000000u ) return sign;
+
+        unsigned int exponent = magnitude >> 23;
+        unsigned int mantissa = (magnitude & 0x007FFFFFu) | 0x00800000u;
+        unsigned int shift = 126 - exponent;
+        unsigned int half = mantissa >> shift;
+        unsigned int remainder = mantissa & ((1u << shift) - 1);
+        unsigned int halfway = 1u << (shift - 1);
+
+        if ( remainder > halfway || (remainder == halfway && (half & 1u)) ) half++;
+        return sign | static_cast<unsigned short>(half);
+    }
+
+    //--------------------------------------------------------------------------
+    // Normal range: rebias the exponent and round the 13 dropped mantissa bits.
+    // A carry out of the mantissa correctly increments the exponent.
+    //--------------------------------------------------------------------------
+    unsigned int half = (magnitude - 0x38000000u) >> 13;
+    unsigned int remainder = magnitude & 0x1FFFu;
+    if ( remainder > 0x1000u || (remainder == 0x1000u && (half & 1u)) ) half++;
+    return sign | static_cast<unsigned short>(half);
+}
+
+float HalfToFloat(unsigned short value) {
+    unsigned int sign = static_cast<unsigned int>(value & 0x8000u) << 16;
+    unsigned int exponent = (value >> 10) & 0x1Fu;
+    unsigned int mantissa = value & 0x03FFu;
+    unsigned int bits;
+
+    if ( exponent == 0 ) {
+        float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return (sign != 0) ? -magnitude : magnitude;
+    }
+
+    if ( exponent == 0x1Fu ) bits = sign | 0x7F800000u | (mantissa << 13);
+    else bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+static float SignNotZero(float value) {
+    return (value >= 0.0f) ? 1.0f : -1.0f;
+}
+
+/* Signed normalized to float conversion (OpenGL 4.2+, RealisticMeshPacked.vert). */
+static float SnormToFloat(short value) {
+    return std::max(static_cast<float>(value) / SNORM16_MAX, -1.0f);
+}
+
+Vector3f OctahedralDecode(short x, short y) {
+    float u = SnormToFloat(x);
+    float v = SnormToFloat(y);
+    Vector3f result(u, v, 1.0f - std::abs(u) - std::abs(v));
+
+    if ( result.z() < 0.0f ) {
+        result.x() = (1.0f - std::abs(v)) * SignNotZero(u);
+        result.y() = (1.0f - std::abs(u)) * SignNotZero(v);
+    }
+
+    result.normalize();
+    return result;
+}
+
+void OctahedralEncode(const Vector3f& v, short& x, short& y) {
+    float l1 = std::abs(v.x()) + std::abs(v.y()) + std::abs(v.z());
+    float u = 0.0f, w = 0.0f;
+
+    if ( l1 > 0.0f ) {
+        u = v.x() / l1;
+        w = v.y() / l1;
+
+        if ( v.z() < 0.0f ) {
+            float fold = u;
+            u = (1.0f - std::abs(w)) * SignNotZero(fold);
+            w = (1.0f - std::abs(fold)) * SignNotZero(w);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Rounding each coordinate independently is not optimal on the folded
+    // octahedron, so the four surrounding grid points are tested and the one
+    // closest in angle is kept.
+    //--------------------------------------------------------------------------
+    float baseX = std::floor(std::min(std::max(u, -1.0f), 1.0f) * SNORM16_MAX);
+    float baseY = std::floor(std::min(std::max(w, -1.0f), 1.0f) * SNORM16_MAX);
+    float bestDot = -FLT_MAX;
+    x = 0;
+    y = 0;
+
+    for ( unsigned int i = 0; i < 4; i++ ) {
+        short cx = static_cast<short>(std::min(baseX + static_cast<float>(i & 1u), SNORM16_MAX));
+        short cy = static_cast<short>(std::min(baseY + static_cast<float>(i >> 1), SNORM16_MAX));
+        float dot = static_cast<float>(Vector3f::Dot(OctahedralDecode(cx, cy), v));
+
+        if ( dot > bestDot ) {
+            bestDot = dot;
+            x = cx;
+            y = cy;
+        }
+    }
+}
+
+static unsigned short QuantizeUnorm16(float value) {
+    value = std::min(std::max(value, 0.0f), 1.0f);
+    return static_cast<unsigned short>(value * UNORM16_MAX + 0.5f);
+}
+
+VertexFormat::VertexFormat(unsigned int options) {
+    this->options = options;
+    this->positionScale = Vector3f(1.0f, 1.0f, 1.0f);
+    this->positionOffset = Vector3f(0.0f, 0.0f, 0.0f);
+    this->buildLayout();
+}
+
+void VertexFormat::addAttribute(Attribute attribute, unsigned int componentCount, ComponentType type, bool normalized) {
+    AttributeLayout& layout = this->attributes[attribute];
+    layout.enabled = true;
+    layout.componentCount = componentCount;
+    layout.type = type;
+    layout.normalized = normalized;
+    layout.offset = this->stride;
+
+    //--------------------------------------------------------------------------
+    // Every attribute starts on a 4 byte boundary.
+    //--------------------------------------------------------------------------
+    this->stride += (componentCount * COMPONENT_SIZES[type] + 3) & ~3u;
+}
+
+void VertexFormat::buildLayout() {
+    this->stride = 0;
+    for ( unsigned int i = 0; i < ATTRIBUTE_COUNT; i++ ) {
+        this->attributes[i].enabled = false;
+        this->attributes[i].componentCount = 0;
+        this->attributes[i].type = FLOAT;
+        this->attributes[i].normalized = false;
+        this->attributes[i].offset = 0;
+    }
+
+    bool octahedral = this->hasOption(OCTAHEDRAL_NORMAL);
+    bool tangents = !this->hasOption(NO_TANGENT);
+
+    //--------------------------------------------------------------------------
+    // Quantized positions always use four components to stay 4 byte aligned.
+    // The fourth component carries the bitangent sign of octahedral tangents.
+    //--------------------------------------------------------------------------
+    if ( this->hasOption(QUANTIZED_POSITION) ) this->addAttribute(POSITION, 4, UNSIGNED_SHORT, true);
+    else this->addAttribute(POSITION, (octahedral && tangents) ? 4 : 3, FLOAT, false);
+
+    //--------------------------------------------------------------------------
+    // Octahedral coordinates are passed as plain integers and normalized in the
+    // shader: OpenGL before 4.2 maps signed normalized values differently.
+    //--------------------------------------------------------------------------
+    if ( octahedral ) this->addAttribute(NORMAL, 2, SHORT, false);
+    else this->addAttribute(NORMAL, 3, FLOAT, false);
+
+    if ( tangents ) {
+        if ( octahedral ) this->addAttribute(TANGENT, 2, SHORT, false);
+        else this->addAttribute(TANGENT, 4, FLOAT, false);
+    }
+
+    if ( !this->hasOption(NO_TEXTURE_COORD) ) {
+        if ( this->hasOption(HALF_TEXTURE_COORD) ) this->addAttribute(TEXTURE_COORD, 2, HALF_FLOAT, false);
+        else this->addAttribute(TEXTURE_COORD, 3, FLOAT, false);
+    }
+
+    if ( !this->hasOption(NO_COLOR) ) this->addAttribute(COLOR, 3, FLOAT, false);
+}
+
+bool VertexFormat::pack(const std::vector<Vertex>& vertices, std::vector<unsigned char>& buffer) {
+    if ( vertices.size() == 0 ) {
+        std::cerr << "[VertexFormat:pack] Error: Vertex array of length 0." << std::endl;
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+    // Quantized positions are stored relative to the bounding box of the mesh.
+    //--------------------------------------------------------------------------
+    this->positionScale = Vector3f(1.0f, 1.0f, 1.0f);
+    this->positionOffset = Vector3f(0.0f, 0.0f, 0.0f);
+    if ( this->hasOption(QUANTIZED_POSITION) ) {
+        Vector3f minimum(FLT_MAX, FLT_MAX, FLT_MAX);
+        Vector3f maximum(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for ( std::size_t i = 0; i < vertices.size(); i++ ) {
+            for ( unsigned int k = 0; k < 3; k++ ) {
+                minimum[k] = std::min(minimum[k], vertices[i].position.constData()[k]);
+                maximum[k] = std::max(maximum[k], vertices[i].position.constData()[k]);
+            }
+        }
+
+        this->positionOffset = minimum;
+        this->positionScale = maximum - minimum;
+    }
+
+    buffer.assign(vertices.size() * this->stride, 0);
+    const AttributeLayout& position = this->attributes[POSITION];
+    const AttributeLayout& normal = this->attributes[NORMAL];
+    const AttributeLayout& tangent = this->attributes[TANGENT];
+    const AttributeLayout& textureCoord = this->attributes[TEXTURE_COORD];
+    const AttributeLayout& color = this->attributes[COLOR];
+    bool octahedral = this->hasOption(OCTAHEDRAL_NORMAL);
+
+    for ( std::size_t i = 0; i < vertices.size(); i++ ) {
+        const Vertex& v = vertices[i];
+        unsigned char* out = &buffer[i * this->stride];
+        float bitangentSign = (v.tangent.w() < 0.0f) ? 0.0f : 1.0f;
+
+        if ( position.type == UNSIGNED_SHORT ) {
+            unsigned short* p = reinterpret_cast<unsigned short*>(out + position.offset);
+            for ( unsigned int k = 0; k < 3; k++ ) {
+                float extent = this->positionScale.constData()[k];
+                float t = (extent > 0.0f) ? (v.position.constData()[k] - this->positionOffset.constData()[k]) / extent : 0.0f;
+                p[k] = QuantizeUnorm16(t);
+            }
+            p[3] = QuantizeUnorm16(bitangentSign);
+        }
+        else {
+            float* p = reinterpret_cast<float*>(out + position.offset);
+            for ( unsigned int k = 0; k < 3; k++ ) p[k] = v.position.constData()[k];
+            if ( position.componentCount == 4 ) p[3] = bitangentSign;
+        }
+
+        if ( octahedral ) {
+            short* n = reinterpret_cast<short*>(out + normal.offset);
+            OctahedralEncode(v.normal, n[0], n[1]);
+        }
+        else std::memcpy(out + normal.offset, v.normal.constData(), 3 * sizeof(float));
+
+        if ( tangent.enabled ) {
+            if ( octahedral ) {
+                short* t = reinterpret_cast<short*>(out + tangent.offset);
+                OctahedralEncode(Vector3f(v.tangent.x(), v.tangent.y(), v.tangent.z()), t[0], t[1]);
+            }
+            else std::memcpy(out + tangent.offset, v.tangent.constData(), 4 * sizeof(float));
+        }
+
+        if ( textureCoord.enabled ) {
+            if ( textureCoord.type == HALF_FLOAT ) {
+                unsigned short* uv = reinterpret_cast<unsigned short*>(out + textureCoord.offset);
+                uv[0] = FloatToHalf(v.textureCoord.x());
+                uv[1] = FloatToHalf(v.textureCoord.y());
+            }
+            else std::memcpy(out + textureCoord.offset, v.textureCoord.constData(), 3 * sizeof(float));
+        }
+
+        if ( color.enabled ) {
+            float* c = reinterpret_cast<float*>(out + color.offset);
+            c[0] = v.color.r();
+            c[1] = v.color.g();
+            c[2] = v.color.b();
+        }
+    }
+
+    return true;
+}
+
+bool VertexFormat::unpack(const std::vector<unsigned char>& buffer, std::vector<Vertex>& vertices) const {
+    if ( this->stride == 0 || buffer.size() % this->stride != 0 ) {
+        std::cerr << "[VertexFormat:unpack] Error: Buffer size is not a multiple of the vertex stride." << std::endl;
+        return false;
+    }
+
+    const AttributeLayout& position = this->attributes[POSITION];
+    const AttributeLayout& normal = this->attributes[NORMAL];
+    const AttributeLayout& tangent = this->attributes[TANGENT];
+    const AttributeLayout& textureCoord = this->attributes[TEXTURE_COORD];
+    const AttributeLayout& color = this->attributes[COLOR];
+    bool octahedral = this->hasOption(OCTAHEDRAL_NORMAL);
+
+    vertices.resize(buffer.size() / this->stride);
+    for ( std::size_t i = 0; i < vertices.size(); i++ ) {
+        Vertex& v = vertices[i];
+        const unsigned char* in = &buffer[i * this->stride];
+        float bitangentSign = 1.0f;
+
+        if ( position.type == UNSIGNED_SHORT ) {
+            const unsigned short* p = reinterpret_cast<const unsigned short*>(in + position.offset);
+            for ( unsigned int k = 0; k < 3; k++ )
+                v.position[k] = (static_cast<float>(p[k]) / UNORM16_MAX) * this->positionScale.constData()[k] + this->positionOffset.constData()[k];
+            bitangentSign = static_cast<float>(p[3]) / UNORM16_MAX;
+        }
+        else {
+            const float* p = reinterpret_cast<const float*>(in + position.offset);
+            v.position = Vector3f(p[0], p[1], p[2]);
+            if ( position.componentCount == 4 ) bitangentSign = p[3];
+        }
+
+        if ( octahedral ) {
+            const short* n = reinterpret_cast<const short*>(in + normal.offset);
+            v.normal = OctahedralDecode(n[0], n[1]);
+        }
+        else std::memcpy(&v.normal[0], in + normal.offset, 3 * sizeof(float));
+
+        v.tangent = Vector4f(Vector3f::Zero(), 1.0f);
+        if ( tangent.enabled ) {
+            if ( octahedral ) {
+                const short* t = reinterpret_cast<const short*>(in + tangent.offset);
+                Vector3f decoded = OctahedralDecode(t[0], t[1]);
+                v.tangent = Vector4f(decoded, bitangentSign * 2.0f - 1.0f);
+            }
+            else std::memcpy(&v.tangent[0], in + tangent.offset, 4 * sizeof(float));
+        }
+
+        v.textureCoord = Vector3f(0.0f, 0.0f, 0.0f);
+        if ( textureCoord.enabled ) {
+            if ( textureCoord.type == HALF_FLOAT ) {
+                const unsigned short* uv = reinterpret_cast<const unsigned short*>(in + textureCoord.offset);
+                v.textureCoord = Vector3f(HalfToFloat(uv[0]), HalfToFloat(uv[1]), 0.0f);
+            }
+            else std::memcpy(&v.textureCoord[0], in + textureCoord.offset, 3 * sizeof(float));
+        }
+
+        v.color = Color3f(0.0f, 0.0f, 0.0f);
+        if ( color.enabled ) {
+            const float* c = reinterpret_cast<const float*>(in + color.offset);
+            v.color = Color3f(c[0], c[1], c[2]);
+        }
+    }
+
+    return true;
+}
+
+unsigned int VertexFormat::getOptions() const {
+    return this->options;
+}
+
+bool VertexFormat::hasOption(Option option) const {
+    return (this->options & option) != 0;
+}
+
+unsigned int VertexFormat::getStride() const {
+    return this->stride;
+}
+
+const VertexFormat::AttributeLayout& VertexFormat::getAttribute(Attribute attribute) const {
+    return this->attributes[attribute];
+}
+
+const Vector3f& VertexFormat::getPositionScale() const {
+    return this->positionScale;
+}
+
+const Vector3f& VertexFormat::getPositionOffset() const {
+    return this->positionOffset;
+}
+
+/* Angle in degrees, atan2 keeps small angles accurate. */
+static float AngleBetween(const Vector3f& u, const Vector3f& v) {
+    double x = static_cast<double>(u.y()) * v.z() - static_cast<double>(u.z()) * v.y();
+    double y = static_cast<double>(u.z()) * v.x() - static_cast<double>(u.x()) * v.z();
+    double z = static_cast<double>(u.x()) * v.y() - static_cast<double>(u.y()) * v.x();
+    double dot = static_cast<double>(u.x()) * v.x() + static_cast<double>(u.y()) * v.y() + static_cast<double>(u.z()) * v.z();
+    return static_cast<float>(std::atan2(std::sqrt(x * x + y * y + z * z), dot)) * RADIANS_TO_DEGREES;
+}
+
+bool MeasurePackingError(const std::vector<Vertex>& vertices, const VertexFormat& format, const std::vector<unsigned char>& buffer, VertexPackingError& error) {
+    std::vector<Vertex> decoded;
+    if ( !format.unpack(buffer, decoded) ) return false;
+
+    if ( decoded.size() != vertices.size() ) {
+        std::cerr << "[VertexFormat:MeasurePackingError] Error: Vertex count mismatch." << std::endl;
+        return false;
+    }
+
+    std::memset(&error, 0, sizeof(VertexPackingError));
+    if ( vertices.size() == 0 ) return true;
+
+    Vector3f minimum(FLT_MAX, FLT_MAX, FLT_MAX);
+    Vector3f maximum(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    double normalAngleSum = 0.0;
+
+    for ( std::size_t i = 0; i < vertices.size(); i++ ) {
+        const Vertex& a = vertices[i];
+        const Vertex& b = decoded[i];
+
+        for ( unsigned int k = 0; k < 3; k++ ) {
+            minimum[k] = std::min(minimum[k], a.position.constData()[k]);
+            maximum[k] = std::max(maximum[k], a.position.constData()[k]);
+        }
+
+        error.maxPositionError = std::max(error.maxPositionError, static_cast<float>(a.position.distance(b.position)));
+
+        float normalAngle = AngleBetween(a.normal, b.normal);
+        error.maxNormalAngle = std::max(error.maxNormalAngle, normalAngle);
+        normalAngleSum += normalAngle;
+
+        if ( format.getAttribute(VertexFormat::TANGENT).enabled ) {
+            Vector3f t0(a.tangent.x(), a.tangent.y(), a.tangent.z());
+            Vector3f t1(b.tangent.x(), b.tangent.y(), b.tangent.z());
+            error.maxTangentAngle = std::max(error.maxTangentAngle, AngleBetween(t0, t1));
+            if ( (a.tangent.w() < 0.0f) != (b.tangent.w() < 0.0f) ) error.tangentSignErrors++;
+        }
+
+        if ( format.getAttribute(VertexFormat::TEXTURE_COORD).enabled ) {
+            float du = std::abs(a.textureCoord.x() - b.textureCoord.x());
+            float dv = std::abs(a.textureCoord.y() - b.textureCoord.y());
+            error.maxTextureCoordError = std::max(error.maxTextureCoordError, std::max(du, dv));
+        }
+    }
+
+    float diagonal = static_cast<float>(minimum.distance(maximum));
+    error.maxRelativePositionError = (diagonal > 0.0f) ? error.maxPositionError / diagonal : 0.0f;
+    error.meanNormalAngle = static_cast<float>(normalAngleSum / static_cast<double>(vertices.size()));
+    return true;
+}
@@ -0,0 +1,109 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <vector>
+#include "Vertex.h"
+
+/* IEEE 754 half precision conversion, rounding to nearest even. */
+unsigned short FloatToHalf(float value);
+float HalfToFloat(unsigned short value);
+
+/*
+ * Octahedral encoding of a unit vector into two signed normalized 16-bit
+ * components (the vector is projected onto the octahedron |x|+|y|+|z| = 1
+ * and the lower half is folded over the upper one). The encoder picks the
+ * quantized point that decodes closest to v, so the angular error stays
+ * below 0.01 degrees. The zero vector encodes to +Z.
+ */
+void OctahedralEncode(const Vector3f& v, short& x, short& y);
+Vector3f OctahedralDecode(short x, short y);
+
+/*
+ * VertexFormat: Layout of the vertex buffer a Mesh uploads to the GPU.
+ *
+ * The CPU side keeps the full precision Vertex array; pack() converts it into
+ * the interleaved buffer described by the format options:
+ *
+ *   QUANTIZED_POSITION  4 x unsigned 16-bit normalized within the mesh AABB,
+ *                       position = value * positionScale + positionOffset.
+ *   OCTAHEDRAL_NORMAL   normal and tangent as 2 x signed 16-bit octahedral
+ *                       coordinates (value / 32767). The bitangent sign
+ *                       (tangent.w) moves to position.w as 0 or 1.
+ *   HALF_TEXTURE_COORD  2 x half float texture coordinates.
+ *   NO_TANGENT, NO_TEXTURE_COORD, NO_COLOR drop the attribute.
+ *
+ * FULL_PRECISION is the 64 byte Vertex structure itself, PACKED is 20 bytes
+ * per vertex (16 without tangents). Packed normals require a shader that
+ * decodes them (see RealisticMeshPacked.vert).
+ */
+class VertexFormat {
+public:
+    enum Attribute { POSITION, NORMAL, TANGENT, TEXTURE_COORD, COLOR, ATTRIBUTE_COUNT };
+    enum ComponentType { FLOAT, HALF_FLOAT, UNSIGNED_SHORT, SHORT };
+
+    enum Option {
+        FULL_PRECISION = 0x00,
+        QUANTIZED_POSITION = 0x01,
+        OCTAHEDRAL_NORMAL = 0x02,
+        HALF_TEXTURE_COORD = 0x04,
+        NO_TANGENT = 0x08,
+        NO_TEXTURE_COORD = 0x10,
+        NO_COLOR = 0x20,
+        PACKED = QUANTIZED_POSITION | OCTAHEDRAL_NORMAL | HALF_TEXTURE_COORD | NO_COLOR
+    };
+
+    struct AttributeLayout {
+        bool enabled;
+        unsigned int componentCount;
+        ComponentType type;
+        bool normalized;
+        unsigned int offset;
+    };
+
+    VertexFormat(unsigned int options = FULL_PRECISION);
+
+    /*
+     * Packs vertices into buffer. With QUANTIZED_POSITION this also computes
+     * the position scale and offset from the bounding box of the vertices.
+     */
+    bool pack(const std::vector<Vertex>& vertices, std::vector<unsigned char>& buffer);
+    bool unpack(const std::vector<unsigned char>& buffer, std::vector<Vertex>& vertices) const;
+
+    unsigned int getOptions() const;
+    bool hasOption(Option option) const;
+    unsigned int getStride() const;
+    const AttributeLayout& getAttribute(Attribute attribute) const;
+    const Vector3f& getPositionScale() const;
+    const Vector3f& getPositionOffset() const;
+
+protected:
+    void buildLayout();
+    void addAttribute(Attribute attribute, unsigned int componentCount, ComponentType type, bool normalized);
+
+protected:
+    unsigned int options;
+    unsigned int stride;
+    AttributeLayout attributes[ATTRIBUTE_COUNT];
+
+    Vector3f positionScale;
+    Vector3f positionOffset;
+};
+
+/*
+ * Difference between the full precision vertices and what the GPU decodes
+ * from a packed buffer. Angles are in degrees, the relative position error
+ * is measured against the bounding box diagonal.
+ */
+struct VertexPackingError {
+    float maxPositionError;
+    float maxRelativePositionError;
+    float maxNormalAngle;
+    float meanNormalAngle;
+    float maxTangentAngle;
+    float maxTextureCoordError;
+    std::size_t tangentSignErrors;
+};
+
+bool MeasurePackingError(const std::vector<Vertex>& vertices, const VertexFormat& format, const std::vector<unsigned char>& buffer, VertexPackingError& error);
+
+#endif
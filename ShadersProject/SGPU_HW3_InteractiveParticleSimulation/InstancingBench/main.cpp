@@ -0,0 +1,171 @@
+#include <gl/glew.h>
+#include <gl/freeglut.h>
+#include <Mesh.h>
+#include <Camera.h>
+#include <Parallel.h>
+#include <TransformationBatch.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/*
+ * Instancing benchmark. Copies of a model are laid out on a square grid and
+ * spin around their own axis every frame. Each frame is drawn twice: once
+ * with the per-object loop of beginRender, uniform uploads and endRender,
+ * and once with Mesh::setInstances and a single endRenderInstanced. For both
+ * the CPU submission time (until the last GL call returns) and the frame
+ * time (after glFinish) are reported, together with the cost of compiling
+ * the matrices one Transformation at a time against CompileTransformations.
+ *
+ *   InstancingBench <model.obj> [instances] [frames]
+ */
+
+const static int WINDOW_SIZE = 512;
+const static float FIELD_OF_VIEW = 45.0f;
+const static float SPIN_STEP = 0.05f;
+
+void PrintUsage() {
+    std::cout << "Usage: InstancingBench <model.obj> [instances] [frames]" << std::endl;
+}
+
+double ElapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/* Rotates every instance to its own phase of the spin for the given frame. */
+void Spin(std::vector<Transformationf>& transforms, int frame) {
+    Vector3f axis(0.0f, 1.0f, 0.0f);
+    for ( std::size_t i = 0; i < transforms.size(); i++ )
+        transforms[i].setRotation(Quaternionf(axis, SPIN_STEP * frame + 0.001f * i));
+}
+
+int main(int argc, char* argv[]) {
+    if ( argc < 2 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    int instanceCount = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 100000;
+    int frames = (argc > 3) ? std::max(1, std::atoi(argv[3])) : 5;
+
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+    glutInitWindowSize(WINDOW_SIZE, WINDOW_SIZE);
+    glutCreateWindow("InstancingBench");
+    glewInit();
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, WINDOW_SIZE, WINDOW_SIZE);
+
+    Mesh mesh;
+    if ( !mesh.load(argv[1]) ) return 1;
+    if ( !mesh.loadShader("shaders/PhongShading.vert", "shaders/PhongShading.frag") ) return 1;
+
+    Mesh instancedMesh;
+    if ( !instancedMesh.load(argv[1]) ) return 1;
+    if ( !instancedMesh.loadShader("shaders/PhongShadingInstanced.vert", "shaders/PhongShadingInstanced.frag") ) return 1;
+
+    //--------------------------------------------------------------------------
+    // Lay the instances out on a square grid in the xz plane, spaced by three
+    // times the bounding radius, with a color gradient across the grid.
+    //--------------------------------------------------------------------------
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(instanceCount))));
+    float spacing = 3.0f * mesh.getBoundingSphereRadius();
+    float half = 0.5f * spacing * (side - 1);
+
+    std::vector<Transformationf> transforms(instanceCount);
+    std::vector<Color3f> colors(instanceCount);
+    for ( int i = 0; i < instanceCount; i++ ) {
+        transforms[i].setPosition(spacing * (i % side) - half, 0.0f, spacing * (i / side) - half);
+        colors[i] = Color3f(static_cast<float>(i % side) / side, 0.5f, static_cast<float>(i / side) / side);
+    }
+
+    Cameraf camera;
+    camera.setPerspective(FIELD_OF_VIEW, 1.0f, 0.1f, 8.0f * half + 10.0f * spacing);
+    camera.setPosition(3.0f * half + 2.0f * spacing, 0.0f, 0.3f);
+    camera.setLookAt(Vector3f(0.0f, 0.0f, 0.0f));
+    Vector3f lightPosition(0.0f, 2.0f * half + spacing, 0.0f);
+
+    std::printf("model:      %s (%u faces)\n", argv[1], static_cast<unsigned int>(mesh.getFaces().size()));
+    std::printf("instances:  %d (%d^2 grid), %d frames\n", instanceCount, side, frames);
+
+    //--------------------------------------------------------------------------
+    // Matrix compilation alone: Transformation::toMatrix per object against
+    // the batch kernel on one thread and split over threads.
+    //--------------------------------------------------------------------------
+    std::vector<float> matrices(16 * instanceCount);
+    double objectMilliseconds = 0.0, batchMilliseconds = 0.0, parallelMilliseconds = 0.0;
+    float checksum = 0.0f;
+    for ( int f = 0; f < frames; f++ ) {
+        Spin(transforms, f);
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for ( int i = 0; i < instanceCount; i++ ) checksum += transforms[i].toMatrix()(3, 0);
+        objectMilliseconds += ElapsedMilliseconds(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        CompileTransformations(&transforms[0], &matrices[0], instanceCount);
+        batchMilliseconds += ElapsedMilliseconds(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        ParallelFor(0, instanceCount, 16384, [&](std::size_t begin, std::size_t end, std::size_t) {
+            CompileTransformations(&transforms[begin], &matrices[16 * begin], end - begin);
+        });
+        parallelMilliseconds += ElapsedMilliseconds(start);
+        checksum += matrices[12];
+    }
+
+    std::printf("compile ms: per object %.2f, batch %.2f, batch on %u threads %.2f (checksum %g)\n",
+        objectMilliseconds / frames, batchMilliseconds / frames, ParallelThreadCount(), parallelMilliseconds / frames, checksum);
+
+    //--------------------------------------------------------------------------
+    // Drawing. The per-object loop compiles each matrix as it goes, the
+    // instanced path compiles and uploads them all in setInstances.
+    //--------------------------------------------------------------------------
+    double loopSubmit = 0.0, loopFrame = 0.0, instancedUpdate = 0.0, instancedSubmit = 0.0, instancedFrame = 0.0;
+    for ( int f = 0; f < frames; f++ ) {
+        Spin(transforms, f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for ( int i = 0; i < instanceCount; i++ ) {
+            Matrix4f modelView = Matrix4f::Multiply(transforms[i].toMatrix(), camera.getViewMatrix());
+            mesh.beginRender();
+            mesh.getShader()->uniformMatrix("projectionMatrix", camera.getProjectionMatrix());
+            mesh.getShader()->uniformMatrix("modelViewMatrix", modelView);
+            mesh.getShader()->uniformMatrix("normalMatrix", Matrix4f::NormalMatrix(modelView));
+            mesh.getShader()->uniformVector("lightPosition", lightPosition);
+            mesh.endRender();
+        }
+        loopSubmit += ElapsedMilliseconds(start);
+        glFinish();
+        loopFrame += ElapsedMilliseconds(start);
+        glutSwapBuffers();
+
+        Spin(transforms, f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        start = std::chrono::high_resolution_clock::now();
+        instancedMesh.setInstances(transforms, colors);
+        instancedUpdate += ElapsedMilliseconds(start);
+        instancedMesh.beginRender();
+        instancedMesh.getShader()->uniformMatrix("projectionMatrix", camera.getProjectionMatrix());
+        instancedMesh.getShader()->uniformMatrix("viewMatrix", camera.getViewMatrix());
+        instancedMesh.getShader()->uniformVector("lightPosition", lightPosition);
+        instancedMesh.endRenderInstanced();
+        instancedSubmit += ElapsedMilliseconds(start);
+        glFinish();
+        instancedFrame += ElapsedMilliseconds(start);
+        glutSwapBuffers();
+    }
+
+    //--------------------------------------------------------------------------
+    // Submission includes the instance upload of setInstances, shown on its
+    // own as well. Software GL shades vertices inside the draw call, so there
+    // the submission time also holds the vertex work.
+    //--------------------------------------------------------------------------
+    std::printf("path        upload ms  submit ms  frame ms  instances/s\n");
+    std::printf("per object  -          %-9.2f  %-8.2f  %.0f\n", loopSubmit / frames, loopFrame / frames, instanceCount * frames * 1000.0 / loopFrame);
+    std::printf("instanced   %-9.2f  %-9.2f  %-8.2f  %.0f\n", instancedUpdate / frames, instancedSubmit / frames, instancedFrame / frames, instanceCount * frames * 1000.0 / instancedFrame);
+    return 0;
+}
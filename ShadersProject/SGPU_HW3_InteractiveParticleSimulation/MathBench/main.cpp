@@ -0,0 +1,311 @@
+#include <Matrix4.h>
+#include <Vector3.h>
+#include <Vector4.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+ * Headless micro-benchmark of the float specializations of Matrix4, Vector4
+ * and Vector3 (see SimdMath.h). Every operation is timed over a batch of
+ * random transformations against the scalar algorithm of the generic
+ * template, and the float results are compared with the generic template
+ * evaluated in double precision. The closed form inverses of rigid, uniform
+ * scale and affine transformations are checked against the general inverse.
+ *
+ *   MathBench [count] [repeat]
+ *
+ * Build with MATH_NO_SIMD defined to time the scalar backend of SimdMath.
+ * The project also compiles the compile-time tests of the MathLibrary
+ * (MathLibrary/MathConstexprTests.cpp).
+ */
+
+const static std::size_t DEFAULT_COUNT = 4096;
+const static std::size_t DEFAULT_REPEAT = 200;
+const static double MAX_RELATIVE_ERROR = 1.0e-4;
+
+void PrintUsage() {
+    std::cout << "Usage: MathBench [count] [repeat]" << std::endl;
+}
+
+double ElapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+//------------------------------------------------------------------------------
+// Scalar algorithms of the generic templates, evaluated in float. These are
+// what the float specializations replace.
+//------------------------------------------------------------------------------
+Matrix4f ScalarMultiply(const Matrix4f& a, const Matrix4f& b) {
+    const float* pa = a.constData();
+    const float* pb = b.constData();
+    float result[16] = {};
+    for ( unsigned int i = 0; i < 4; i++ )
+        for ( unsigned int j = 0; j < 4; j++ )
+            for ( unsigned int k = 0; k < 4; k++ )
+                result[i * 4 + j] += pa[i * 4 + k] * pb[k * 4 + j];
+    return Matrix4f(result);
+}
+
+Matrix4f ScalarInverse(const Matrix4f& m) {
+    float adjoint[16] = {};
+    float det = Matrix4f::Determinant(m, adjoint);
+    if ( det == 0.0f ) return Matrix4f(true);
+    float invDet = 1.0f / det;
+    for ( unsigned int i = 0; i < 16; i++ ) adjoint[i] *= invDet;
+    return Matrix4f(adjoint);
+}
+
+Vector3f ScalarNormalize(const Vector3f& v) {
+    float length = std::sqrt(v.x() * v.x() + v.y() * v.y() + v.z() * v.z());
+    return Vector3f(v.x() / length, v.y() / length, v.z() / length);
+}
+
+Vector4f ScalarNormalize(const Vector4f& v) {
+    float length = std::sqrt(v.x() * v.x() + v.y() * v.y() + v.z() * v.z() + v.w() * v.w());
+    return Vector4f(v.x() / length, v.y() / length, v.z() / length, v.w() / length);
+}
+
+Matrix4d ToDouble(const Matrix4f& m) {
+    double data[16];
+    for ( unsigned int i = 0; i < 16; i++ ) data[i] = m.constData()[i];
+    return Matrix4d(data);
+}
+
+/* Largest component difference relative to the largest component of reference. */
+double RelativeError(const Matrix4f& m, const Matrix4d& reference) {
+    double error = 0.0;
+    double scale = 0.0;
+    for ( unsigned int i = 0; i < 16; i++ ) {
+        error = std::max(error, std::abs(m.constData()[i] - reference.constData()[i]));
+        scale = std::max(scale, std::abs(reference.constData()[i]));
+    }
+    return (scale > 0.0) ? error / scale : error;
+}
+
+/*
+ * Random transformation of the given kind (rigid, uniform scale or affine
+ * with a non-uniform scale in [0.5, 2]), i.e. the model matrices of a scene.
+ * The rotation is an orthonormalized random frame built in double precision,
+ * so the rounded float matrix still classifies as the kind it was built as.
+ */
+Matrix4f RandomTransform(std::mt19937& random, Matrix4f::TransformKind kind = Matrix4f::TRANSFORM_AFFINE) {
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::uniform_real_distribution<double> scale(0.5, 2.0);
+
+    Vector3d x = Vector3d::Normalize(Vector3d(unit(random), unit(random), unit(random)));
+    Vector3d y = Vector3d::Normalize(Vector3d::Cross(x, Vector3d(unit(random), unit(random), unit(random))));
+    Vector3d z = Vector3d::Cross(x, y);
+
+    double sx = 1.0, sy = 1.0, sz = 1.0;
+    if ( kind == Matrix4f::TRANSFORM_UNIFORM_SCALE ) sx = sy = sz = scale(random);
+    else if ( kind == Matrix4f::TRANSFORM_AFFINE ) {
+        sx = scale(random);
+        sy = scale(random);
+        sz = scale(random);
+    }
+
+    double data[16] = { x.x() * sx, x.y() * sx, x.z() * sx, 0.0,
+                        y.x() * sy, y.y() * sy, y.z() * sy, 0.0,
+                        z.x() * sz, z.y() * sz, z.z() * sz, 0.0,
+                        10.0 * unit(random), 10.0 * unit(random), 10.0 * unit(random), 1.0 };
+    float result[16];
+    for ( unsigned int i = 0; i < 16; i++ ) result[i] = static_cast<float>(data[i]);
+    return Matrix4f(result);
+}
+
+/* Random projective matrix: a transformation times a perspective projection. */
+Matrix4f RandomProjective(std::mt19937& random) {
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    float perspective[16] = { 1.5f, 0.0f, 0.0f, 0.0f,
+                              0.0f, 2.0f, 0.0f, 0.0f,
+                              0.1f * unit(random), 0.1f * unit(random), -1.002f, -1.0f,
+                              0.0f, 0.0f, -0.2002f, 0.0f };
+    return ScalarMultiply(RandomTransform(random), Matrix4f(perspective));
+}
+
+/*
+ * Times fn over all elements repeat times and returns nanoseconds per call.
+ * The results are accumulated into checksum so they can not be optimized out.
+ */
+template <typename Function>
+double TimeBatch(std::size_t count, std::size_t repeat, float& checksum, Function fn) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    float sum = 0.0f;
+    for ( std::size_t r = 0; r < repeat; r++ )
+        for ( std::size_t i = 0; i < count; i++ ) sum += fn(i);
+    double ms = ElapsedMilliseconds(start);
+    checksum += sum;
+    return 1.0e6 * ms / static_cast<double>(count * repeat);
+}
+
+void PrintTiming(const char* name, double scalarNs, double simdNs) {
+    std::printf("  %-24s %10.2f %10.2f %8.2fx\n", name, scalarNs, simdNs, scalarNs / simdNs);
+}
+
+/*
+ * Precision of the inverse and normal matrix dispatch (see Matrix4::Classify).
+ * For every kind of transformation, the float general inverse, the closed
+ * form of the kind and the normal matrix are compared with the general
+ * inverse in double precision, and every matrix has to classify as the kind
+ * it was built as. The closed forms may not be less precise than the
+ * general inverse by more than a factor of two.
+ */
+bool CheckInverses(std::mt19937& random, std::size_t count) {
+    const Matrix4f::TransformKind kinds[] = { Matrix4f::TRANSFORM_RIGID, Matrix4f::TRANSFORM_UNIFORM_SCALE, Matrix4f::TRANSFORM_AFFINE };
+    const char* names[] = { "rigid", "uniform scale", "affine" };
+    bool passed = true;
+
+    std::printf("\nInverse precision (max relative error against the double general inverse):\n");
+    std::printf("  %-16s %12s %12s %12s %14s\n", "kind", "general", "closed form", "normal", "misclassified");
+    for ( unsigned int k = 0; k < 3; k++ ) {
+        double generalError = 0.0;
+        double closedError = 0.0;
+        double normalError = 0.0;
+        std::size_t misclassified = 0;
+
+        for ( std::size_t i = 0; i < count; i++ ) {
+            Matrix4f m = RandomTransform(random, kinds[k]);
+            Matrix4d reference = Matrix4d::GeneralInverse(ToDouble(m));
+            if ( Matrix4f::Classify(m) != kinds[k] ) misclassified++;
+
+            Matrix4f closed = (kinds[k] == Matrix4f::TRANSFORM_AFFINE) ? Matrix4f::AffineInverse(m) : Matrix4f::OrthogonalInverse(m);
+            generalError = std::max(generalError, RelativeError(Matrix4f::GeneralInverse(m), reference));
+            closedError = std::max(closedError, RelativeError(closed, reference));
+            closedError = std::max(closedError, RelativeError(Matrix4f::Inverse(m, kinds[k]), reference));
+            closedError = std::max(closedError, RelativeError(Matrix4f::Inverse(m), reference));
+
+            //------------------------------------------------------------------
+            // The normal matrix is the transpose of the 3x3 block of the inverse.
+            //------------------------------------------------------------------
+            Matrix3f normal = Matrix4f::NormalMatrix(m, kinds[k]);
+            double error = 0.0;
+            double scale = 0.0;
+            for ( unsigned int r = 0; r < 3; r++ ) {
+                for ( unsigned int c = 0; c < 3; c++ ) {
+                    double expected = reference.constData()[c * 4 + r];
+                    error = std::max(error, std::abs(normal.constData()[r * 3 + c] - expected));
+                    scale = std::max(scale, std::abs(expected));
+                }
+            }
+            normalError = std::max(normalError, error / scale);
+        }
+
+        std::printf("  %-16s %12.2e %12.2e %12.2e %14u\n", names[k], generalError, closedError, normalError, static_cast<unsigned int>(misclassified));
+        if ( misclassified != 0 || closedError > 2.0 * generalError || normalError > 2.0 * generalError ) passed = false;
+    }
+
+    if ( !passed ) std::cerr << "[MathBench] Error: The closed form inverses are less precise than the general inverse." << std::endl;
+    return passed;
+}
+
+int main(int argc, char** argv) {
+    if ( argc > 3 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::size_t count = (argc > 1) ? static_cast<std::size_t>(std::atol(argv[1])) : DEFAULT_COUNT;
+    std::size_t repeat = (argc > 2) ? static_cast<std::size_t>(std::atol(argv[2])) : DEFAULT_REPEAT;
+    if ( count == 0 || repeat == 0 ) {
+        PrintUsage();
+        return 1;
+    }
+
+#if defined(MATH_SIMD_SSE) && defined(MATH_SIMD_FMA)
+    const char* backend = "SSE + FMA";
+#elif defined(MATH_SIMD_SSE)
+    const char* backend = "SSE";
+#elif defined(MATH_SIMD_NEON)
+    const char* backend = "NEON";
+#else
+    const char* backend = "scalar";
+#endif
+    std::printf("SimdMath backend: %s, %u elements, %u repeats\n", backend, static_cast<unsigned int>(count), static_cast<unsigned int>(repeat));
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<Matrix4f> transforms(count);
+    std::vector<Matrix4f> views(count);
+    std::vector<Matrix4f> projectives(count);
+    std::vector<Vector3f> vectors3(count);
+    std::vector<Vector4f> vectors4(count);
+    for ( std::size_t i = 0; i < count; i++ ) {
+        transforms[i] = RandomTransform(random);
+        views[i] = RandomTransform(random);
+        projectives[i] = RandomProjective(random);
+        vectors3[i] = Vector3f(unit(random), unit(random), unit(random) + 2.0f);
+        vectors4[i] = Vector4f(unit(random), unit(random), unit(random), unit(random) + 2.0f);
+    }
+
+    //--------------------------------------------------------------------------
+    // Accuracy against the generic template in double precision.
+    //--------------------------------------------------------------------------
+    double multiplyError = 0.0;
+    double inverseError = 0.0;
+    double affineError = 0.0;
+    double normalizeError = 0.0;
+    for ( std::size_t i = 0; i < count; i++ ) {
+        Matrix4d transform = ToDouble(transforms[i]);
+        Matrix4d projective = ToDouble(projectives[i]);
+        multiplyError = std::max(multiplyError, RelativeError(Matrix4f::Multiply(transforms[i], views[i]), Matrix4d::Multiply(transform, ToDouble(views[i]))));
+        inverseError = std::max(inverseError, RelativeError(Matrix4f::GeneralInverse(projectives[i]), Matrix4d::GeneralInverse(projective)));
+        affineError = std::max(affineError, RelativeError(Matrix4f::AffineInverse(transforms[i]), Matrix4d::GeneralInverse(transform)));
+
+        Vector4f n4 = Vector4f::Normalize(vectors4[i]);
+        Vector3f n3 = Vector3f::Normalize(vectors3[i]);
+        normalizeError = std::max(normalizeError, std::abs(std::sqrt(Vector4f::Dot(n4, n4)) - 1.0));
+        normalizeError = std::max(normalizeError, std::abs(std::sqrt(static_cast<double>(n3.x() * n3.x() + n3.y() * n3.y() + n3.z() * n3.z())) - 1.0));
+    }
+
+    std::printf("\nRelative error against double precision:\n");
+    std::printf("  %-24s %10.2e\n", "Matrix4f::Multiply", multiplyError);
+    std::printf("  %-24s %10.2e\n", "Matrix4f::GeneralInverse", inverseError);
+    std::printf("  %-24s %10.2e\n", "Matrix4f::AffineInverse", affineError);
+    std::printf("  %-24s %10.2e\n", "normalize (length - 1)", normalizeError);
+
+    bool inversesPassed = CheckInverses(random, count);
+
+    //--------------------------------------------------------------------------
+    // Timing. The affine inverse replaces the general inverse on the model
+    // view matrices, so it is compared against the scalar general inverse.
+    //--------------------------------------------------------------------------
+    float checksum = 0.0f;
+    std::printf("\n  %-24s %10s %10s %9s\n", "ns per call", "scalar", "SIMD", "speedup");
+
+    double scalarNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return ScalarMultiply(transforms[i], views[i]).constData()[5]; });
+    double simdNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return Matrix4f::Multiply(transforms[i], views[i]).constData()[5]; });
+    PrintTiming("Matrix4f::Multiply", scalarNs, simdNs);
+
+    scalarNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return ScalarInverse(projectives[i]).constData()[5]; });
+    simdNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return Matrix4f::GeneralInverse(projectives[i]).constData()[5]; });
+    PrintTiming("Matrix4f::GeneralInverse", scalarNs, simdNs);
+
+    scalarNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return ScalarInverse(transforms[i]).constData()[5]; });
+    simdNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return Matrix4f::AffineInverse(transforms[i]).constData()[5]; });
+    PrintTiming("Matrix4f::AffineInverse", scalarNs, simdNs);
+
+    scalarNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return ScalarNormalize(vectors4[i]).x(); });
+    simdNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return Vector4f::Normalize(vectors4[i]).x(); });
+    PrintTiming("Vector4f::Normalize", scalarNs, simdNs);
+
+    scalarNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return ScalarNormalize(vectors3[i]).x(); });
+    simdNs = TimeBatch(count, repeat, checksum, [&](std::size_t i) { return Vector3f::Normalize(vectors3[i]).x(); });
+    PrintTiming("Vector3f::Normalize", scalarNs, simdNs);
+
+    std::printf("\n(checksum %g)\n", checksum);
+
+    bool accurate = multiplyError <= MAX_RELATIVE_ERROR && inverseError <= MAX_RELATIVE_ERROR &&
+                    affineError <= MAX_RELATIVE_ERROR && normalizeError <= MAX_RELATIVE_ERROR;
+    if ( !accurate ) {
+        std::cerr << "[MathBench] Error: The float specializations exceed the relative error of " << MAX_RELATIVE_ERROR << std::endl;
+        return 1;
+    }
+
+    return inversesPassed ? 0 : 1;
+}
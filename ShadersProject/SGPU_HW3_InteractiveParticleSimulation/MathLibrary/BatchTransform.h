@@ -0,0 +1,272 @@
+#ifndef BATCH_TRANSFORM_H
+#define BATCH_TRANSFORM_H
+
+#include <cstddef>
+#include <limits>
+#include "Matrix4.h"
+#include "SimdMath.h"
+
+/*
+ * Batch transform kernels: apply one Matrix4f to many points, normals or
+ * boxes in a single call instead of going through the Vector3 operators one
+ * element at a time.
+ *
+ * The matrix is applied to row vectors like everywhere else in this library:
+ * p' = (x, y, z, 1) * m, the translation being the last row of m.
+ *
+ * Every kernel comes in three flavors:
+ *   Packed   xyz triples (or min/max boxes) stored back to back.
+ *   Strided  AoS data with a stride in floats between elements, e.g. the
+ *            position inside an interleaved vertex: stride sizeof(Vertex) / 4.
+ *   SoA      separate x, y and z arrays, four elements per SIMD operation.
+ *
+ * Input and output may be the same array (with the same stride). The kernels
+ * are element-wise, so they can be split over threads by calling them on
+ * sub-ranges (see ParallelTransform.h in the GraphicsLibrary).
+ */
+
+//------------------------------------------------------------------------------
+// Points
+//------------------------------------------------------------------------------
+inline void TransformPoints(const Matrix4f& m, const float* in, std::size_t inStride, float* out, std::size_t outStride, std::size_t count) {
+    const float* a = m.constData();
+    SimdFloat4 row0 = SimdLoad(a + 0);
+    SimdFloat4 row1 = SimdLoad(a + 4);
+    SimdFloat4 row2 = SimdLoad(a + 8);
+    SimdFloat4 row3 = SimdLoad(a + 12);
+
+    for ( std::size_t i = 0; i < count; i++ ) {
+        const float* p = in + i * inStride;
+        SimdFloat4 r = SimdMulAdd(SimdSplat(p[0]), row0, row3);
+        r = SimdMulAdd(SimdSplat(p[1]), row1, r);
+        r = SimdMulAdd(SimdSplat(p[2]), row2, r);
+        SimdStore3(out + i * outStride, r);
+    }
+}
+
+inline void TransformPoints(const Matrix4f& m, const float* xyz, float* out, std::size_t count) {
+    TransformPoints(m, xyz, 3, out, 3, count);
+}
+
+/* Transforms four points whose coordinates are in the lanes of x, y and z. */
+inline void TransformPoints4(const float* a, SimdFloat4& x, SimdFloat4& y, SimdFloat4& z) {
+    SimdFloat4 rx = SimdMulAdd(z, SimdSplat(a[8]), SimdMulAdd(y, SimdSplat(a[4]), SimdMulAdd(x, SimdSplat(a[0]), SimdSplat(a[12]))));
+    SimdFloat4 ry = SimdMulAdd(z, SimdSplat(a[9]), SimdMulAdd(y, SimdSplat(a[5]), SimdMulAdd(x, SimdSplat(a[1]), SimdSplat(a[13]))));
+    SimdFloat4 rz = SimdMulAdd(z, SimdSplat(a[10]), SimdMulAdd(y, SimdSplat(a[6]), SimdMulAdd(x, SimdSplat(a[2]), SimdSplat(a[14]))));
+    x = rx;
+    y = ry;
+    z = rz;
+}
+
+inline void TransformPointsSoA(const Matrix4f& m, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ, std::size_t count) {
+    const float* a = m.constData();
+    std::size_t i = 0;
+
+    for ( ; i + 4 <= count; i += 4 ) {
+        SimdFloat4 px = SimdLoad(x + i), py = SimdLoad(y + i), pz = SimdLoad(z + i);
+        TransformPoints4(a, px, py, pz);
+        SimdStore(outX + i, px);
+        SimdStore(outY + i, py);
+        SimdStore(outZ + i, pz);
+    }
+
+    //--------------------------------------------------------------------------
+    // The last (count % 4) points go through padded temporaries so the arrays
+    // are never accessed past their end.
+    //--------------------------------------------------------------------------
+    if ( i < count ) {
+        float tx[4] = { 0.0f }, ty[4] = { 0.0f }, tz[4] = { 0.0f };
+        for ( std::size_t j = i; j < count; j++ ) { tx[j - i] = x[j]; ty[j - i] = y[j]; tz[j - i] = z[j]; }
+        SimdFloat4 px = SimdLoad(tx), py = SimdLoad(ty), pz = SimdLoad(tz);
+        TransformPoints4(a, px, py, pz);
+        SimdStore(tx, px);
+        SimdStore(ty, py);
+        SimdStore(tz, pz);
+        for ( std::size_t j = i; j < count; j++ ) { outX[j] = tx[j - i]; outY[j] = ty[j - i]; outZ[j] = tz[j - i]; }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Normals. They are transformed by the inverse transpose of the upper 3x3
+// block of m, which keeps them perpendicular to transformed surfaces under
+// non-uniform scaling, and are normalized afterwards unless normalize is
+// false. The translation of m has no effect.
+//------------------------------------------------------------------------------
+inline Matrix4f BatchNormalMatrix(const Matrix4f& m) {
+    return Matrix4f::Transpose(Matrix4f::AffineInverse(m));
+}
+
+inline void TransformNormals(const Matrix4f& m, const float* in, std::size_t inStride, float* out, std::size_t outStride, std::size_t count, bool normalize = true) {
+    Matrix4f normalMatrix = BatchNormalMatrix(m);
+    const float* a = normalMatrix.constData();
+    SimdFloat4 row0 = SimdLoad3(a + 0);
+    SimdFloat4 row1 = SimdLoad3(a + 4);
+    SimdFloat4 row2 = SimdLoad3(a + 8);
+
+    for ( std::size_t i = 0; i < count; i++ ) {
+        const float* n = in + i * inStride;
+        SimdFloat4 r = SimdMul(SimdSplat(n[0]), row0);
+        r = SimdMulAdd(SimdSplat(n[1]), row1, r);
+        r = SimdMulAdd(SimdSplat(n[2]), row2, r);
+        if ( normalize ) r = SimdMul(r, SimdRsqrt(SimdDot4(r, r)));
+        SimdStore3(out + i * outStride, r);
+    }
+}
+
+inline void TransformNormals(const Matrix4f& m, const float* xyz, float* out, std::size_t count, bool normalize = true) {
+    TransformNormals(m, xyz, 3, out, 3, count, normalize);
+}
+
+/* Transforms four normals whose coordinates are in the lanes of x, y and z. */
+inline void TransformNormals4(const float* a, SimdFloat4& x, SimdFloat4& y, SimdFloat4& z, bool normalize) {
+    SimdFloat4 rx = SimdMulAdd(z, SimdSplat(a[8]), SimdMulAdd(y, SimdSplat(a[4]), SimdMul(x, SimdSplat(a[0]))));
+    SimdFloat4 ry = SimdMulAdd(z, SimdSplat(a[9]), SimdMulAdd(y, SimdSplat(a[5]), SimdMul(x, SimdSplat(a[1]))));
+    SimdFloat4 rz = SimdMulAdd(z, SimdSplat(a[10]), SimdMulAdd(y, SimdSplat(a[6]), SimdMul(x, SimdSplat(a[2]))));
+
+    if ( normalize ) {
+        SimdFloat4 invLength = SimdRsqrt(SimdMulAdd(rz, rz, SimdMulAdd(ry, ry, SimdMul(rx, rx))));
+        rx = SimdMul(rx, invLength);
+        ry = SimdMul(ry, invLength);
+        rz = SimdMul(rz, invLength);
+    }
+
+    x = rx;
+    y = ry;
+    z = rz;
+}
+
+inline void TransformNormalsSoA(const Matrix4f& m, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ, std::size_t count, bool normalize = true) {
+    Matrix4f normalMatrix = BatchNormalMatrix(m);
+    const float* a = normalMatrix.constData();
+    std::size_t i = 0;
+
+    for ( ; i + 4 <= count; i += 4 ) {
+        SimdFloat4 nx = SimdLoad(x + i), ny = SimdLoad(y + i), nz = SimdLoad(z + i);
+        TransformNormals4(a, nx, ny, nz, normalize);
+        SimdStore(outX + i, nx);
+        SimdStore(outY + i, ny);
+        SimdStore(outZ + i, nz);
+    }
+
+    if ( i < count ) {
+        float tx[4] = { 1.0f, 1.0f, 1.0f, 1.0f }, ty[4] = { 0.0f }, tz[4] = { 0.0f };
+        for ( std::size_t j = i; j < count; j++ ) { tx[j - i] = x[j]; ty[j - i] = y[j]; tz[j - i] = z[j]; }
+        SimdFloat4 nx = SimdLoad(tx), ny = SimdLoad(ty), nz = SimdLoad(tz);
+        TransformNormals4(a, nx, ny, nz, normalize);
+        SimdStore(tx, nx);
+        SimdStore(ty, ny);
+        SimdStore(tz, nz);
+        for ( std::size_t j = i; j < count; j++ ) { outX[j] = tx[j - i]; outY[j] = ty[j - i]; outZ[j] = tz[j - i]; }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Axis aligned boxes, stored as (min x, min y, min z, max x, max y, max z).
+// The result is the tightest box around the transformed box (Arvo): the
+// center is transformed as a point and the half extent by the absolute
+// values of the upper 3x3 block.
+//------------------------------------------------------------------------------
+inline void TransformAABBs(const Matrix4f& m, const float* in, std::size_t inStride, float* out, std::size_t outStride, std::size_t count) {
+    const float* a = m.constData();
+    SimdFloat4 row0 = SimdLoad3(a + 0);
+    SimdFloat4 row1 = SimdLoad3(a + 4);
+    SimdFloat4 row2 = SimdLoad3(a + 8);
+    SimdFloat4 row3 = SimdLoad3(a + 12);
+    SimdFloat4 absRow0 = SimdAbs(row0);
+    SimdFloat4 absRow1 = SimdAbs(row1);
+    SimdFloat4 absRow2 = SimdAbs(row2);
+    SimdFloat4 half = SimdSplat(0.5f);
+
+    for ( std::size_t i = 0; i < count; i++ ) {
+        const float* box = in + i * inStride;
+        SimdFloat4 boxMin = SimdLoad3(box);
+        SimdFloat4 boxMax = SimdLoad3(box + 3);
+        SimdFloat4 center = SimdMul(SimdAdd(boxMin, boxMax), half);
+        SimdFloat4 extent = SimdMul(SimdSub(boxMax, boxMin), half);
+
+        SimdFloat4 c = SimdMulAdd(SimdSplatLane<0>(center), row0, row3);
+        c = SimdMulAdd(SimdSplatLane<1>(center), row1, c);
+        c = SimdMulAdd(SimdSplatLane<2>(center), row2, c);
+
+        SimdFloat4 e = SimdMul(SimdSplatLane<0>(extent), absRow0);
+        e = SimdMulAdd(SimdSplatLane<1>(extent), absRow1, e);
+        e = SimdMulAdd(SimdSplatLane<2>(extent), absRow2, e);
+
+        float* result = out + i * outStride;
+        SimdStore3(result, SimdSub(c, e));
+        SimdStore3(result + 3, SimdAdd(c, e));
+    }
+}
+
+inline void TransformAABBs(const Matrix4f& m, const float* minMax, float* out, std::size_t count) {
+    TransformAABBs(m, minMax, 6, out, 6, count);
+}
+
+//------------------------------------------------------------------------------
+// Projection: transforms points by a (model) view projection matrix and
+// performs the perspective divide, yielding normalized device coordinates.
+// Points at or behind the eye plane (w <= 0) have no projection; they are
+// written as (0, 0, +infinity) so depth and frustum tests reject them.
+//------------------------------------------------------------------------------
+inline void ProjectPoints(const Matrix4f& m, const float* in, std::size_t inStride, float* out, std::size_t outStride, std::size_t count) {
+    const float* a = m.constData();
+    SimdFloat4 row0 = SimdLoad(a + 0);
+    SimdFloat4 row1 = SimdLoad(a + 4);
+    SimdFloat4 row2 = SimdLoad(a + 8);
+    SimdFloat4 row3 = SimdLoad(a + 12);
+    SimdFloat4 behind = SimdSet(0.0f, 0.0f, std::numeric_limits<float>::infinity(), 0.0f);
+
+    for ( std::size_t i = 0; i < count; i++ ) {
+        const float* p = in + i * inStride;
+        SimdFloat4 r = SimdMulAdd(SimdSplat(p[0]), row0, row3);
+        r = SimdMulAdd(SimdSplat(p[1]), row1, r);
+        r = SimdMulAdd(SimdSplat(p[2]), row2, r);
+
+        SimdFloat4 w = SimdSplatLane<3>(r);
+        SimdStore3(out + i * outStride, SimdSelectPositive(w, SimdDiv(r, w), behind));
+    }
+}
+
+inline void ProjectPoints(const Matrix4f& m, const float* xyz, float* out, std::size_t count) {
+    ProjectPoints(m, xyz, 3, out, 3, count);
+}
+
+/* Projects four points whose coordinates are in the lanes of x, y and z. */
+inline void ProjectPoints4(const float* a, SimdFloat4& x, SimdFloat4& y, SimdFloat4& z) {
+    SimdFloat4 rx = SimdMulAdd(z, SimdSplat(a[8]), SimdMulAdd(y, SimdSplat(a[4]), SimdMulAdd(x, SimdSplat(a[0]), SimdSplat(a[12]))));
+    SimdFloat4 ry = SimdMulAdd(z, SimdSplat(a[9]), SimdMulAdd(y, SimdSplat(a[5]), SimdMulAdd(x, SimdSplat(a[1]), SimdSplat(a[13]))));
+    SimdFloat4 rz = SimdMulAdd(z, SimdSplat(a[10]), SimdMulAdd(y, SimdSplat(a[6]), SimdMulAdd(x, SimdSplat(a[2]), SimdSplat(a[14]))));
+    SimdFloat4 rw = SimdMulAdd(z, SimdSplat(a[11]), SimdMulAdd(y, SimdSplat(a[7]), SimdMulAdd(x, SimdSplat(a[3]), SimdSplat(a[15]))));
+
+    SimdFloat4 invW = SimdDiv(SimdSplat(1.0f), rw);
+    SimdFloat4 zero = SimdZero();
+    x = SimdSelectPositive(rw, SimdMul(rx, invW), zero);
+    y = SimdSelectPositive(rw, SimdMul(ry, invW), zero);
+    z = SimdSelectPositive(rw, SimdMul(rz, invW), SimdSplat(std::numeric_limits<float>::infinity()));
+}
+
+inline void ProjectPointsSoA(const Matrix4f& m, const float* x, const float* y, const float* z, float* outX, float* outY, float* outZ, std::size_t count) {
+    const float* a = m.constData();
+    std::size_t i = 0;
+
+    for ( ; i + 4 <= count; i += 4 ) {
+        SimdFloat4 px = SimdLoad(x + i), py = SimdLoad(y + i), pz = SimdLoad(z + i);
+        ProjectPoints4(a, px, py, pz);
+        SimdStore(outX + i, px);
+        SimdStore(outY + i, py);
+        SimdStore(outZ + i, pz);
+    }
+
+    if ( i < count ) {
+        float tx[4] = { 0.0f }, ty[4] = { 0.0f }, tz[4] = { 0.0f };
+        for ( std::size_t j = i; j < count; j++ ) { tx[j - i] = x[j]; ty[j - i] = y[j]; tz[j - i] = z[j]; }
+        SimdFloat4 px = SimdLoad(tx), py = SimdLoad(ty), pz = SimdLoad(tz);
+        ProjectPoints4(a, px, py, pz);
+        SimdStore(tx, px);
+        SimdStore(ty, py);
+        SimdStore(tz, pz);
+        for ( std::size_t j = i; j < count; j++ ) { outX[j] = tx[j - i]; outY[j] = ty[j - i]; outZ[j] = tz[j - i]; }
+    }
+}
+
+#endif
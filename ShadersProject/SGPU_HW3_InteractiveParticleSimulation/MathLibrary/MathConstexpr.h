@@ -0,0 +1,34 @@
+#ifndef MATH_CONSTEXPR_H
+#define MATH_CONSTEXPR_H
+
+/*
+ * MathConstexpr: Compile-time evaluation of the MathLibrary core.
+ *
+ * Functions marked MATH_CONSTEXPR (vector and matrix construction, access,
+ * arithmetic, Dot/Cross, the Zero/Unit/Identity factories and the translation
+ * and scale transformations) can be used in constant expressions:
+ *
+ *   constexpr Matrix4d view = Matrix4d::Translation(0.0, 0.0, -5.0);
+ *   static_assert(Vector3d::Cross(Vector3d::UnitX(), Vector3d::UnitY()) == Vector3d::UnitZ(), "");
+ *
+ * The bodies use loops and assignments, which requires the relaxed constexpr
+ * rules of C++14 (Visual Studio 2017 and later, GCC 5, Clang 3.4). Older
+ * compilers, including the Visual Studio 2013 (v120) toolset of this solution,
+ * get plain inline functions that the optimizer folds the same way.
+ * MATH_HAS_CONSTEXPR is defined when constant evaluation is available.
+ * Defining MATH_NO_CONSTEXPR forces the inline fallback. The static_assert
+ * checks in MathConstexprTests.cpp are compiled as part of the MathBench
+ * project.
+ *
+ * Everything that needs std::sqrt, std::sin or std::cos (normalization,
+ * rotations, projections) and the SIMD float specializations (Matrix4f
+ * products and inverses, Vector4f::Dot) stay runtime only.
+ */
+#if !defined(MATH_NO_CONSTEXPR) && ((defined(__cpp_constexpr) && __cpp_constexpr >= 201304L) || (defined(_MSC_VER) && _MSC_VER >= 1910))
+    #define MATH_HAS_CONSTEXPR
+    #define MATH_CONSTEXPR constexpr
+#else
+    #define MATH_CONSTEXPR inline
+#endif
+
+#endif
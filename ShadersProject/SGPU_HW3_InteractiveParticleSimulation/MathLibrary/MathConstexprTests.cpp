@@ -0,0 +1,151 @@
+#include "MathConstexpr.h"
+#include "Vector2.h"
+#include "Vector3.h"
+#include "Vector4.h"
+#include "Matrix3.h"
+#include "Matrix4.h"
+#include "RotationMatrix.h"
+#include "Quaternion.h"
+#include "Transformation.h"
+
+/*
+ * Compile-time tests of the MathLibrary core (see MathConstexpr.h). Every
+ * check is a static_assert, so this file passes by compiling; it has no code
+ * to run. Without constant evaluation (MATH_HAS_CONSTEXPR undefined, e.g. the
+ * v120 toolset or MATH_NO_CONSTEXPR) the file is empty.
+ *
+ * The double versions are used throughout: the float specializations of
+ * Matrix4 and Vector4 use SIMD and are runtime only.
+ */
+#if defined(MATH_HAS_CONSTEXPR)
+
+namespace {
+
+//------------------------------------------------------------------------------
+// Vectors
+//------------------------------------------------------------------------------
+constexpr Vector3d UNIT_X = Vector3d::UnitX();
+constexpr Vector3d UNIT_Y = Vector3d::UnitY();
+
+static_assert(Vector3d::Cross(UNIT_X, UNIT_Y) == Vector3d::UnitZ(), "[MathConstexprTests] Vector3::Cross");
+static_assert(Vector3d::Dot(UNIT_X + UNIT_Y, UNIT_Y * 2.0) == 2.0, "[MathConstexprTests] Vector3::Dot");
+static_assert((UNIT_X - UNIT_Y).y() == -1.0, "[MathConstexprTests] Vector3 operator -");
+static_assert((-UNIT_X).x() == -1.0 && (2.0 * UNIT_X / 2.0).x() == 1.0, "[MathConstexprTests] Vector3 scalar operators");
+static_assert(UNIT_X != UNIT_Y, "[MathConstexprTests] Vector3 operator !=");
+static_assert(Vector3d::DistanceSquared(UNIT_X, UNIT_Y) == 2.0, "[MathConstexprTests] Vector3::DistanceSquared");
+static_assert(Vector3f(1, 2, 3).isEquivalent(Vector3f(1, 2, 3.0000001f), 1e-5f), "[MathConstexprTests] Vector3::isEquivalent");
+
+/* Vector3::setX/Y/Z used to be empty. */
+constexpr Vector3d ModifiedVector3() {
+    Vector3d v(1, 2, 3);
+    v += Vector3d(1, 1, 1);
+    v *= 2.0;
+    v.setX(0);
+    v.inverse();
+    return v;
+}
+static_assert(ModifiedVector3() == Vector3d(0, -6, -8), "[MathConstexprTests] Vector3 setters");
+
+/* Vector2::setX used to write y. */
+constexpr Vector2d ModifiedVector2() {
+    Vector2d v;
+    v.setX(3);
+    v[1] = 4;
+    return v;
+}
+static_assert(ModifiedVector2().x() == 3 && ModifiedVector2().lengthSquared() == 25, "[MathConstexprTests] Vector2 setters");
+static_assert(Vector2d(1, 2).y() == 2 && Vector2d::UnitNY().y() == -1, "[MathConstexprTests] Vector2 factories");
+
+static_assert(Vector4d(Vector3d(1, 2, 3)).w() == 1.0 && Vector4d::UnitW().w() == 1, "[MathConstexprTests] Vector4 construction");
+static_assert(Vector4d::Dot(Vector4d(1, 2, 3, 4), Vector4d(1, 1, 1, 1)) == 10, "[MathConstexprTests] Vector4::Dot");
+
+//------------------------------------------------------------------------------
+// Matrices
+//------------------------------------------------------------------------------
+constexpr Matrix4d TRANSLATION = Matrix4d::Translation(1.0, 2.0, 3.0);
+constexpr Matrix4d SCALING = Matrix4d::Scaling(2.0, 2.0, 2.0);
+
+constexpr bool Equal(Matrix4d a, Matrix4d b) {
+    return a == b;
+}
+
+static_assert(TRANSLATION(3, 2) == 3.0 && TRANSLATION(0, 0) == 1.0, "[MathConstexprTests] Matrix4::Translation");
+static_assert(Equal(Matrix4d::Multiply(Matrix4d::Identity(), TRANSLATION), TRANSLATION), "[MathConstexprTests] Matrix4::Multiply");
+static_assert(Equal(Matrix4d::Multiply(TRANSLATION, Matrix4d::AffineInverse(TRANSLATION)), Matrix4d::Identity()), "[MathConstexprTests] Matrix4::AffineInverse");
+static_assert(Equal(Matrix4d::Multiply(SCALING, Matrix4d::Inverse(SCALING, Matrix4d::TRANSFORM_UNIFORM_SCALE)), Matrix4d::Identity()), "[MathConstexprTests] Matrix4::OrthogonalInverse");
+static_assert(Equal(Matrix4d::Multiply(SCALING, Matrix4d::GeneralInverse(SCALING)), Matrix4d::Identity()), "[MathConstexprTests] Matrix4::GeneralInverse");
+static_assert(Matrix4d::Determinant(SCALING) == 8, "[MathConstexprTests] Matrix4::Determinant");
+static_assert(Matrix4d::Transpose(TRANSLATION)(0, 3) == 1, "[MathConstexprTests] Matrix4::Transpose");
+static_assert(Matrix4d(Matrix3d(), true).isIdentity(0), "[MathConstexprTests] Matrix4 from Matrix3");
+static_assert(Matrix4d::NormalMatrix(SCALING, Matrix4d::TRANSFORM_UNIFORM_SCALE)(1, 1) == 0.5, "[MathConstexprTests] Matrix4::NormalMatrix");
+static_assert(SCALING.applyTo(Vector4d(1, 1, 0, 0)).x() == 2, "[MathConstexprTests] Matrix4::applyTo");
+
+constexpr Matrix4d ScaledAndTranslated() {
+    Matrix4d m = Matrix4d::Multiply(SCALING, TRANSLATION);
+    return Matrix4d::Multiply(m, Matrix4d::Inverse(m, Matrix4d::TRANSFORM_UNIFORM_SCALE));
+}
+static_assert(ScaledAndTranslated().isIdentity(1e-15), "[MathConstexprTests] Matrix4 composed inverse");
+
+/* Matrix4::clear(true) used to leave A_44 zero. */
+constexpr Matrix4d Cleared() {
+    Matrix4d m(false);
+    m.clear(true);
+    m *= SCALING;
+    m.transpose();
+    return m;
+}
+static_assert(Equal(Cleared(), SCALING), "[MathConstexprTests] Matrix4::clear");
+
+/* Matrix3::Inverse used to return the transpose of the inverse. */
+constexpr Matrix3d Matrix3InverseProduct() {
+    Matrix3d m(1, 2, 3, 0, 1, 4, 5, 6, 0);
+    return Matrix3d::Multiply(m, Matrix3d::Inverse(m));
+}
+static_assert(Matrix3InverseProduct().isIdentity(1e-12), "[MathConstexprTests] Matrix3::Inverse");
+static_assert(Matrix3d::Determinant(Matrix3d(1, 2, 3, 0, 1, 4, 5, 6, 0)) == 1, "[MathConstexprTests] Matrix3::Determinant");
+
+constexpr RotationMatrix<double> InvertedRotation() {
+    RotationMatrix<double> r;
+    r.invert();
+    return r;
+}
+static_assert(InvertedRotation().isIdentity(0), "[MathConstexprTests] RotationMatrix::invert");
+
+//------------------------------------------------------------------------------
+// Quaternions and transformations
+//------------------------------------------------------------------------------
+/* Quaternion::Multiply used to be empty: i * j = k. */
+constexpr Quaterniond QuaternionProduct() {
+    Quaterniond a(false), b(false);
+    a.set(1, 0, 0, 0);
+    b.set(0, 1, 0, 0);
+    return a * b;
+}
+static_assert(QuaternionProduct().z() == 1 && QuaternionProduct().w() == 0, "[MathConstexprTests] Quaternion::Multiply");
+
+/* operator *= used to alias its operand: i * i = -1. */
+constexpr Quaterniond QuaternionSquare() {
+    Quaterniond q(false);
+    q.set(1, 0, 0, 0);
+    q *= q;
+    return q;
+}
+static_assert(QuaternionSquare().w() == -1 && QuaternionSquare().x() == 0, "[MathConstexprTests] Quaternion operator *=");
+
+constexpr Matrix3d HalfTurnRotation() {
+    Quaterniond q(false);
+    q.set(0, 0, 1, 0);
+    return Quaterniond::ToRotationMatrix(q);
+}
+static_assert(HalfTurnRotation()(0, 0) == -1 && HalfTurnRotation()(2, 2) == 1, "[MathConstexprTests] Quaternion::ToRotationMatrix");
+
+constexpr Transformationd TRANSLATE = Transformationd::Translate(1.0, 2.0, 3.0);
+constexpr Transformationd SCALE = Transformationd::Scale(2.0, 3.0, 4.0);
+constexpr Transformationd IDENTITY = Transformationd::Identity();
+static_assert(TRANSLATE.getPosition().z() == 3.0 && TRANSLATE.getScale().x() == 1.0 && TRANSLATE.getRotation().isIdentity(), "[MathConstexprTests] Transformation::Translate");
+static_assert(SCALE.getScale() == Vector3d(2, 3, 4), "[MathConstexprTests] Transformation::Scale");
+static_assert(IDENTITY.getPosition() == Vector3d::Zero() && IDENTITY.getScale() == Vector3d(1, 1, 1), "[MathConstexprTests] Transformation::Identity");
+
+}
+
+#endif
@@ -67,91 +67,88 @@ class Matrix3 {
                    A_13, A_23, A_33,
                    COMPONENT_COUNT };
 public:
-    Matrix3(bool identity = true);
-    Matrix3(const Real* const data);
-    Matrix3(const Matrix3<Real>& m);
-    Matrix3(Real a11, Real a12, Real a13, 
-            Real a21, Real a22, Real a23, 
-            Real a31, Real a32, Real a33, bool colMajor = true);
-    ~Matrix3();
-
-    void set(const Matrix3<Real>& m);
-    void set(const Real* const data);
-    void set(std::size_t i, std::size_t j, Real value);
-    void set(Real a11, Real a12, Real a13, 
-             Real a21, Real a22, Real a23, 
-             Real a31, Real a32, Real a33, bool colMajor = true);
-
-    void setRow(std::size_t i, Real x, Real y, Real z);
-    void setRow(std::size_t i, const Vector3<Real>& row);
-    void setColumn(std::size_t i, Real x, Real y, Real z);
-    void setColumn(std::size_t i, const Vector3<Real>& column);
-
-    bool isZero(Real epsilon);
-    bool isIdentity(Real epsilon);
+    MATH_CONSTEXPR Matrix3(bool identity = true);
+    MATH_CONSTEXPR Matrix3(const Real* const data);
+    MATH_CONSTEXPR Matrix3(Real a11, Real a12, Real a13, 
+                           Real a21, Real a22, Real a23, 
+                           Real a31, Real a32, Real a33, bool colMajor = true);
+
+    MATH_CONSTEXPR void set(const Matrix3<Real>& m);
+    MATH_CONSTEXPR void set(const Real* const data);
+    MATH_CONSTEXPR void set(std::size_t i, std::size_t j, Real value);
+    MATH_CONSTEXPR void set(Real a11, Real a12, Real a13, 
+                            Real a21, Real a22, Real a23, 
+                            Real a31, Real a32, Real a33, bool colMajor = true);
+
+    MATH_CONSTEXPR void setRow(std::size_t i, Real x, Real y, Real z);
+    MATH_CONSTEXPR void setRow(std::size_t i, const Vector3<Real>& row);
+    MATH_CONSTEXPR void setColumn(std::size_t i, Real x, Real y, Real z);
+    MATH_CONSTEXPR void setColumn(std::size_t i, const Vector3<Real>& column);
+
+    MATH_CONSTEXPR bool isZero(Real epsilon);
+    MATH_CONSTEXPR bool isIdentity(Real epsilon);
     bool isEquivalent(const Matrix3<Real>& m, Real epsilon);
 
-    void zero();
-    void transpose();
-    void identity();
+    MATH_CONSTEXPR void zero();
+    MATH_CONSTEXPR void transpose();
+    MATH_CONSTEXPR void identity();
 
-    virtual void invert();
+    MATH_CONSTEXPR void invert();
 
-    void clear(bool identity = true);
+    MATH_CONSTEXPR void clear(bool identity = true);
     void toRawMatrix(Real* const matrix, bool colMajor = true) const;
     void getData(Real* const matrix, bool colMajor = true) const;
     
-    Real determinant() const;
-    Matrix3<Real> inverse() const;
-    Matrix3<Real> inversed() const;
-    Matrix3<Real> transposed() const;
+    MATH_CONSTEXPR Real determinant() const;
+    MATH_CONSTEXPR Matrix3<Real> inverse() const;
+    MATH_CONSTEXPR Matrix3<Real> inversed() const;
+    MATH_CONSTEXPR Matrix3<Real> transposed() const;
 
     template <typename RealCastType>
     Matrix3<RealCastType> cast();
 
-    Real& get(std::size_t i, std::size_t j);
-    const Real& get(std::size_t i, std::size_t j) const;
-    Vector3<Real> getRow(std::size_t i) const;
-    Vector3<Real> getColumn(std::size_t i) const;
+    MATH_CONSTEXPR Real& get(std::size_t i, std::size_t j);
+    MATH_CONSTEXPR const Real& get(std::size_t i, std::size_t j) const;
+    MATH_CONSTEXPR Vector3<Real> getRow(std::size_t i) const;
+    MATH_CONSTEXPR Vector3<Real> getColumn(std::size_t i) const;
 
-    Matrix3<Real> toTranspose() const;
-    Matrix3<Real> toInverse() const;
+    MATH_CONSTEXPR Matrix3<Real> toTranspose() const;
+    MATH_CONSTEXPR Matrix3<Real> toInverse() const;
     Matrix3<Real> apply(const Vector3<Real>& v, bool colMajor = true) const;
-    Vector3<Real> applyTo(const Vector3<Real>& v) const;
-	Vector4<Real> applyTo(const Vector4<Real>& v) const;
+    MATH_CONSTEXPR Vector3<Real> applyTo(const Vector3<Real>& v) const;
+	MATH_CONSTEXPR Vector4<Real> applyTo(const Vector4<Real>& v) const;
 
-    const Real* const constData() const;
+    MATH_CONSTEXPR const Real* const constData() const;
     operator const Real* const () const;
 
-    Real& operator () (std::size_t i, std::size_t j);
-    const Real& operator () (std::size_t i, std::size_t j) const;
+    MATH_CONSTEXPR Real& operator () (std::size_t i, std::size_t j);
+    MATH_CONSTEXPR const Real& operator () (std::size_t i, std::size_t j) const;
 
-    void set(unsigned int index, Real value);
-    Real get(unsigned int index);
+    MATH_CONSTEXPR void set(unsigned int index, Real value);
+    MATH_CONSTEXPR Real get(unsigned int index);
 
     friend std::ostream& operator << <> (std::ostream& out, const Matrix3<Real>& m);
 
-    bool operator == (const Matrix3<Real>& m);
-	bool operator != (const Matrix3<Real>& m);
+    MATH_CONSTEXPR bool operator == (const Matrix3<Real>& m);
+	MATH_CONSTEXPR bool operator != (const Matrix3<Real>& m);
 
-    Matrix3<Real>& operator = (const Matrix3<Real>& m);
-	Matrix3<Real>& operator = (const Real* data);
+	MATH_CONSTEXPR Matrix3<Real>& operator = (const Real* data);
 
-    Vector3<Real> operator * (const Vector3<Real>& v);
-	Matrix3<Real> operator * (const Matrix3<Real>& m);
-    Matrix3<Real>& operator *= (const Matrix3<Real>& m);
+    MATH_CONSTEXPR Vector3<Real> operator * (const Vector3<Real>& v);
+	MATH_CONSTEXPR Matrix3<Real> operator * (const Matrix3<Real>& m);
+    MATH_CONSTEXPR Matrix3<Real>& operator *= (const Matrix3<Real>& m);
 
     static void ToRawMatrix(const Matrix3<Real>& m, Real* const matrix, bool colMajor = true);
     static void Clear(Matrix3<Real>& m);
     static void Identity(Matrix3<Real>& m);
     static void Zero(Matrix3<Real>& m);
-    static Real Determinant(const Matrix3<Real>& m);
-    static Matrix3<Real> Multiply(const Matrix3<Real>& a, const Matrix3<Real>& b);
-    static Matrix3<Real> Transpose(const Matrix3<Real>& m);
-    static Matrix3<Real> Inverse(const Matrix3<Real>& m);
+    static MATH_CONSTEXPR Real Determinant(const Matrix3<Real>& m);
+    static MATH_CONSTEXPR Matrix3<Real> Multiply(const Matrix3<Real>& a, const Matrix3<Real>& b);
+    static MATH_CONSTEXPR Matrix3<Real> Transpose(const Matrix3<Real>& m);
+    static MATH_CONSTEXPR Matrix3<Real> Inverse(const Matrix3<Real>& m);
 
-    static Matrix3<Real> Zero();
-    static Matrix3<Real> Identity();
+    static MATH_CONSTEXPR Matrix3<Real> Zero();
+    static MATH_CONSTEXPR Matrix3<Real> Identity();
 
 protected:
 	const static int ROW_COUNT = 3;
@@ -161,9 +158,7 @@ protected:
 };
 
 template <typename Real>
-Matrix3<Real>::Matrix3(bool identity) {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
-
+MATH_CONSTEXPR Matrix3<Real>::Matrix3(bool identity) : data() {
     if ( identity ) {
         this->data[A_11] = Real(1);
         this->data[A_22] = Real(1);
@@ -172,35 +167,28 @@ Matrix3<Real>::Matrix3(bool identity) {
 }
 
 template <typename Real>
-Matrix3<Real>::Matrix3(const Real* const data) {
-    std::memcpy(this->data, data, COMPONENT_COUNT * sizeof(Real));
-}
-
-template <typename Real>
-Matrix3<Real>::Matrix3(const Matrix3<Real>& m) {
-    std::memcpy(this->data, m.data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR Matrix3<Real>::Matrix3(const Real* const data) : data() {
+    this->set(data);
 }
 
 template <typename Real>
-Matrix3<Real>::Matrix3(Real a11, Real a12, Real a13, Real a21, Real a22, Real a23, Real a31, Real a32, Real a33, bool colMajor) {
+MATH_CONSTEXPR Matrix3<Real>::Matrix3(Real a11, Real a12, Real a13, Real a21, Real a22, Real a23, Real a31, Real a32, Real a33, bool colMajor) : data() {
     this->set(a11, a12, a13, a21, a22, a23, a31, a32, a33, colMajor);
 }
 
 template <typename Real>
-Matrix3<Real>::~Matrix3() {}
-
-template <typename Real>
-void Matrix3<Real>::set(const Matrix3<Real>& m) {
-    std::memcpy(this->data, m.data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix3<Real>::set(const Matrix3<Real>& m) {
+    this->set(m.data);
 }
 
 template <typename Real>
-void Matrix3<Real>::set(const Real* const data) {
-    std::memcpy(this->data, data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix3<Real>::set(const Real* const data) {
+    for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
+        this->data[i] = data[i];
 }
 
 template <typename Real>
-void Matrix3<Real>::set(std::size_t i, std::size_t j, Real value) {
+MATH_CONSTEXPR void Matrix3<Real>::set(std::size_t i, std::size_t j, Real value) {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix3:set] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix3:set] Index j out of bounds.");
 
@@ -208,7 +196,7 @@ void Matrix3<Real>::set(std::size_t i, std::size_t j, Real value) {
 }
 
 template <typename Real>
-void Matrix3<Real>::set(Real a11, Real a12, Real a13, Real a21, Real a22, Real a23, Real a31, Real a32, Real a33, bool colMajor) {
+MATH_CONSTEXPR void Matrix3<Real>::set(Real a11, Real a12, Real a13, Real a21, Real a22, Real a23, Real a31, Real a32, Real a33, bool colMajor) {
     this->data[A_11] = a11;
     this->data[A_22] = a22;
     this->data[A_33] = a33;
@@ -232,7 +220,7 @@ void Matrix3<Real>::set(Real a11, Real a12, Real a13, Real a21, Real a22, Real a
 }
 
 template <typename Real>
-void Matrix3<Real>::setColumn(std::size_t i, Real x, Real y, Real z) {
+MATH_CONSTEXPR void Matrix3<Real>::setColumn(std::size_t i, Real x, Real y, Real z) {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix3:setRow] Error: Row index out of bounds.");
 
     if ( i == 0 ) {
@@ -255,12 +243,12 @@ void Matrix3<Real>::setColumn(std::size_t i, Real x, Real y, Real z) {
 }
 
 template <typename Real>
-void Matrix3<Real>::setRow(std::size_t i, const Vector3<Real>& row) {
+MATH_CONSTEXPR void Matrix3<Real>::setRow(std::size_t i, const Vector3<Real>& row) {
     this->setRow(i, row.x(), row.y(), row.z());
 }
 
 template <typename Real>
-void Matrix3<Real>::setRow(std::size_t i, Real x, Real y, Real z) {
+MATH_CONSTEXPR void Matrix3<Real>::setRow(std::size_t i, Real x, Real y, Real z) {
     if ( i >= COL_COUNT ) throw std::exception("[Matrix3:getColumn] Error: Column index out of bounds.");
 
     if ( i == 0 ) {
@@ -283,12 +271,12 @@ void Matrix3<Real>::setRow(std::size_t i, Real x, Real y, Real z) {
 }
 
 template <typename Real>
-void Matrix3<Real>::setColumn(std::size_t i, const Vector3<Real>& column) {
+MATH_CONSTEXPR void Matrix3<Real>::setColumn(std::size_t i, const Vector3<Real>& column) {
     this->setColumn(i, column.x(), column.y(), column.z());
 }
 
 template <typename Real>
-bool Matrix3<Real>::isZero(Real epsilon) {
+MATH_CONSTEXPR bool Matrix3<Real>::isZero(Real epsilon) {
     for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ ) {
         Real value = this->data[i];
 
@@ -299,7 +287,7 @@ bool Matrix3<Real>::isZero(Real epsilon) {
 }
 
 template <typename Real>
-bool Matrix3<Real>::isIdentity(Real epsilon) {
+MATH_CONSTEXPR bool Matrix3<Real>::isIdentity(Real epsilon) {
     if ( this->data[A_11] < Real(1) - epsilon || this->data[A_11] > Real(1) + epsilon ) return false;
     if ( this->data[A_22] < Real(1) - epsilon || this->data[A_22] > Real(1) + epsilon ) return false;
     if ( this->data[A_33] < Real(1) - epsilon || this->data[A_33] > Real(1) + epsilon ) return false;
@@ -344,34 +332,29 @@ bool Matrix3<Real>::isEquivalent(const Matrix3<Real>& m, Real epsilon) {
 }
 
 template <typename Real>
-void Matrix3<Real>::zero() {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix3<Real>::zero() {
+    for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
+        this->data[i] = Real(0);
 }
 
 template <typename Real>
-void Matrix3<Real>::transpose() {
-    std::swap(this->data[A_12], this->data[A_21]);
-    std::swap(this->data[A_13], this->data[A_31]);
-    std::swap(this->data[A_23], this->data[A_32]);
+MATH_CONSTEXPR void Matrix3<Real>::transpose() {
+    *this = Matrix3<Real>::Transpose(*this);
 }
 
 template <typename Real>
-void Matrix3<Real>::identity() {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
-    this->data[A_11] = Real(1);
-    this->data[A_22] = Real(1);
-    this->data[A_33] = Real(1);
+MATH_CONSTEXPR void Matrix3<Real>::identity() {
+    this->clear(true);
 }
 
 template <typename Real>
-void Matrix3<Real>::invert() {
-    Matrix3<Real> inverse = Matrix3<Real>::Inverse(*this);
-    std::memcpy(this->data, inverse.data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix3<Real>::invert() {
+    *this = Matrix3<Real>::Inverse(*this);
 }
 
 template <typename Real>
-void Matrix3<Real>::clear(bool identity) {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix3<Real>::clear(bool identity) {
+    this->zero();
 
     if ( identity ) {
         this->data[A_11] = Real(1);
@@ -394,22 +377,22 @@ void Matrix3<Real>::getData(Real* const matrix, bool colMajor) const {
 }
 
 template <typename Real>
-Real Matrix3<Real>::determinant() const {
+MATH_CONSTEXPR Real Matrix3<Real>::determinant() const {
     return Matrix3<Real>::Determinant(*this);
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::inverse() const {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::inverse() const {
     return Matrix3<Real>::Inverse(*this);
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::inversed() const {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::inversed() const {
     return Matrix3<Real>::Inverse(*this);
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::transposed() const {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::transposed() const {
     return Matrix3<Real>::Transpose(*this);
 }
 
@@ -423,23 +406,23 @@ Matrix3<RealCastType> Matrix3<Real>::cast() {
 }
 
 template <typename Real>
-Real& Matrix3<Real>::get(std::size_t i, std::size_t j) {
+MATH_CONSTEXPR Real& Matrix3<Real>::get(std::size_t i, std::size_t j) {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix3:get] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix3:get] Index j out of bounds.");
 
-    return this->data[i * ROW_SIZE + j];
+    return this->data[i * ROW_COUNT + j];
 }
 
 template <typename Real>
-const Real& Matrix3<Real>::get(std::size_t i, std::size_t j) const {
+MATH_CONSTEXPR const Real& Matrix3<Real>::get(std::size_t i, std::size_t j) const {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix3:get] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix3:get] Index j out of bounds.");
 
-    return this->data[i * ROW_SIZE + j];
+    return this->data[i * ROW_COUNT + j];
 }
 
 template <typename Real>
-Vector3<Real> Matrix3<Real>::getRow(std::size_t i) const {
+MATH_CONSTEXPR Vector3<Real> Matrix3<Real>::getRow(std::size_t i) const {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix3:getRow] Error: Row index out of bounds.");
     if ( i == 0 ) return Vector3<Real>(this->data[A_11], this->data[A_12], this->data[A_13]);
     if ( i == 1 ) return Vector3<Real>(this->data[A_21], this->data[A_22], this->data[A_23]);
@@ -447,7 +430,7 @@ Vector3<Real> Matrix3<Real>::getRow(std::size_t i) const {
 }
 
 template <typename Real>
-Vector3<Real> Matrix3<Real>::getColumn(std::size_t i) const {
+MATH_CONSTEXPR Vector3<Real> Matrix3<Real>::getColumn(std::size_t i) const {
     if ( i >= COL_COUNT ) throw std::exception("[Matrix3:getColumn] Error: Column index out of bounds.");
     if ( i == 0 ) return Vector3<Real>(this->data[A_11], this->data[A_21], this->data[A_31]);
     if ( i == 1 ) return Vector3<Real>(this->data[A_12], this->data[A_22], this->data[A_32]);
@@ -455,13 +438,13 @@ Vector3<Real> Matrix3<Real>::getColumn(std::size_t i) const {
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::toTranspose() const {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::toTranspose() const {
     Matrix3<Real> result = (*this);
     return Matrix3<Real>::Transpose(result);
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::toInverse() const {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::toInverse() const {
     Matrix3<Real> result = (*this);
     return Matrix3<Real>::Inverse(result);
 }
@@ -478,7 +461,7 @@ Matrix3<Real> Matrix3<Real>::apply(const Vector3<Real>& v, bool colMajor) const
 }
 
 template <typename Real>
-Vector3<Real> Matrix3<Real>::applyTo(const Vector3<Real>& v) const {
+MATH_CONSTEXPR Vector3<Real> Matrix3<Real>::applyTo(const Vector3<Real>& v) const {
     Vector3<Real> result;
     result.x() = this->data[A_11] * v.x() + this->data[A_12] * v.y() + this->data[A_13] * v.z();
     result.y() = this->data[A_21] * v.x() + this->data[A_22] * v.y() + this->data[A_23] * v.z();
@@ -487,7 +470,7 @@ Vector3<Real> Matrix3<Real>::applyTo(const Vector3<Real>& v) const {
 }
 
 template <typename Real>
-Vector4<Real> Matrix3<Real>::applyTo(const Vector4<Real>& v) const {
+MATH_CONSTEXPR Vector4<Real> Matrix3<Real>::applyTo(const Vector4<Real>& v) const {
     Vector4<Real> result;
     result.x() = this->data[A_11] * v.x() + this->data[A_12] * v.y() + this->data[A_13] * v.z();
     result.y() = this->data[A_21] * v.x() + this->data[A_22] * v.y() + this->data[A_23] * v.z();
@@ -497,7 +480,7 @@ Vector4<Real> Matrix3<Real>::applyTo(const Vector4<Real>& v) const {
 }
 
 template <typename Real>
-const Real* const Matrix3<Real>::constData() const {
+MATH_CONSTEXPR const Real* const Matrix3<Real>::constData() const {
     return this->data;
 }
 
@@ -507,7 +490,7 @@ Matrix3<Real>::operator const Real* const () const {
 }
 
 template <typename Real>
-Real& Matrix3<Real>::operator () (std::size_t i, std::size_t j) {
+MATH_CONSTEXPR Real& Matrix3<Real>::operator () (std::size_t i, std::size_t j) {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix3:()] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix3:()] Index j out of bounds.");
 
@@ -515,7 +498,7 @@ Real& Matrix3<Real>::operator () (std::size_t i, std::size_t j) {
 }
 
 template <typename Real>
-const Real& Matrix3<Real>::operator () (std::size_t i, std::size_t j) const {
+MATH_CONSTEXPR const Real& Matrix3<Real>::operator () (std::size_t i, std::size_t j) const {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix3:()] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix3:()] Index j out of bounds.");
 
@@ -523,13 +506,13 @@ const Real& Matrix3<Real>::operator () (std::size_t i, std::size_t j) const {
 }
 
 template <typename Real>
-void Matrix3<Real>::set(unsigned int index, Real value) {
+MATH_CONSTEXPR void Matrix3<Real>::set(unsigned int index, Real value) {
     if ( index >= COMPONENT_COUNT ) throw std::exception("[Matrix3:set] Index out of bounds.");
     this->data[index] = value;
 }
 
 template <typename Real>
-Real Matrix3<Real>::get(unsigned int index) {
+MATH_CONSTEXPR Real Matrix3<Real>::get(unsigned int index) {
     if ( index >= COMPONENT_COUNT ) throw std::exception("[Matrix3:get] Index out of bounds.");
     return this->data[index];
 }
@@ -544,45 +527,37 @@ std::ostream& operator << (std::ostream& out, const Matrix3<Real>& m) {
 }
 
 template <typename Real>
-bool Matrix3<Real>::operator == (const Matrix3<Real>& m) {
+MATH_CONSTEXPR bool Matrix3<Real>::operator == (const Matrix3<Real>& m) {
     for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
         if ( this->data[i] != m.data[i] ) return false;
     return true;
 }
 
 template <typename Real>
-bool Matrix3<Real>::operator != (const Matrix3<Real>& m) {
+MATH_CONSTEXPR bool Matrix3<Real>::operator != (const Matrix3<Real>& m) {
     return !(*this == m);
 }
 
 template <typename Real>
-Matrix3<Real>& Matrix3<Real>::operator = (const Matrix3<Real>& m) {
-    if ( this == &m ) return *this;
-    std::memcpy(this->data, m.data, COMPONENT_COUNT * sizeof(Real));
-    return *this;
-}
-
-template <typename Real>
-Matrix3<Real>& Matrix3<Real>::operator = (const Real* data) {
+MATH_CONSTEXPR Matrix3<Real>& Matrix3<Real>::operator = (const Real* data) {
     if ( nullptr == data ) return *this;
-    std::memcpy(this->data, data, COMPONENT_COUNT * sizeof(Real));
+    this->set(data);
     return *this;
 }
 
 template <typename Real>
-Vector3<Real> Matrix3<Real>::operator * (const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> Matrix3<Real>::operator * (const Vector3<Real>& v) {
     return this->applyTo(v);
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::operator * (const Matrix3<Real>& m) {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::operator * (const Matrix3<Real>& m) {
     return Matrix3<Real>::Multiply(*this, m);
 }
 
 template <typename Real>
-Matrix3<Real>& Matrix3<Real>::operator *= (const Matrix3<Real>& m) {
-    Matrix3<Real> result = Matrix3<Real>::Multiply(*this, m);
-    std::memcpy(this->data, result.data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR Matrix3<Real>& Matrix3<Real>::operator *= (const Matrix3<Real>& m) {
+    *this = Matrix3<Real>::Multiply(*this, m);
     return *this;
 }
 
@@ -614,7 +589,7 @@ void Matrix3<Real>::Zero(Matrix3<Real>& m) {
 }
 
 template <typename Real>
-Real Matrix3<Real>::Determinant(const Matrix3<Real>& m) {
+MATH_CONSTEXPR Real Matrix3<Real>::Determinant(const Matrix3<Real>& m) {
     Real d = 0.0;
     for ( unsigned int i = 0; i < ROW_COUNT; i++ ) {
         d += (m(0, i) * (m(1, (i+1)%3) * m(2, (i+2)%3) - m(1, (i+2)%3) * m(2, (i+1)%3)));
@@ -625,7 +600,7 @@ Real Matrix3<Real>::Determinant(const Matrix3<Real>& m) {
 
 /* Memory friendly matrix multiplication (Gita A., Lan V.) */
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::Multiply(const Matrix3<Real>& a, const Matrix3<Real>& b) {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::Multiply(const Matrix3<Real>& a, const Matrix3<Real>& b) {
     Matrix3<Real> result(false);
 
     for ( unsigned int i = 0; i < ROW_COUNT; i++ )
@@ -636,22 +611,22 @@ Matrix3<Real> Matrix3<Real>::Multiply(const Matrix3<Real>& a, const Matrix3<Real
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::Transpose(const Matrix3<Real>& m) {
-    Matrix3<Real> result = m;
-    std::swap(result.data[A_12], result.data[A_21]);
-    std::swap(result.data[A_13], result.data[A_31]);
-    std::swap(result.data[A_23], result.data[A_32]);
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::Transpose(const Matrix3<Real>& m) {
+    Matrix3<Real> result(false);
+    for ( unsigned int i = 0; i < ROW_COUNT; i++ )
+        for ( unsigned int j = 0; j < COL_COUNT; j++ )
+            result.data[j * ROW_COUNT + i] = m.data[i * ROW_COUNT + j];
     return result;
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::Inverse(const Matrix3<Real>& m) {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::Inverse(const Matrix3<Real>& m) {
     Matrix3<Real> result;
     Real d = Matrix3<Real>::Determinant(m);
 
     for ( unsigned int i = 0; i < ROW_COUNT; i++ ) {
         for ( unsigned int j = 0; j < COL_COUNT; j++ ) {
-            result(i, j) = ((m((i+1) % 3, (j+1) % 3) * m((i+2) % 3, (j+2) % 3)) - 
+            result(j, i) = ((m((i+1) % 3, (j+1) % 3) * m((i+2) % 3, (j+2) % 3)) - 
                             (m((i+1) % 3, (j+2) % 3) * m((i+2) % 3, (j+1) % 3))) / d;
         }
     }
@@ -660,12 +635,12 @@ Matrix3<Real> Matrix3<Real>::Inverse(const Matrix3<Real>& m) {
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::Zero() {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::Zero() {
     return Matrix3<Real>(false);
 }
 
 template <typename Real>
-Matrix3<Real> Matrix3<Real>::Identity() {
+MATH_CONSTEXPR Matrix3<Real> Matrix3<Real>::Identity() {
     return Matrix3<Real>(true);
 }
 
@@ -28,6 +28,7 @@
 
 #include <iostream>
 #include <cmath>
+#include <limits>
 #include <type_traits>
 
 #include "Matrix3.h"
@@ -48,7 +49,8 @@ std::ostream& operator << <> (std::ostream& out, const Matrix4<Real>& m);
  * [a31 a32 a33 a34]
  * [a41 a42 a43 a44]
  * 
- * This implementation also foregoes vectorization (SSE).
+ * This implementation also foregoes vectorization (SSE) except for the float
+ * specializations at the end of this file (see SimdMath.h).
  * This implementation is aimed at a flexibility while preserving 
  * understandability and complete modularity.
  */
@@ -63,105 +65,123 @@ class Matrix4 {
                    A_14, A_24, A_34, A_44,
                    COMPONENT_COUNT };
 public:
-    Matrix4(bool identity = true);
-    Matrix4(const Real* const data);
-    Matrix4(const Matrix3<Real>& m, bool homogeneous = true);
-    Matrix4(const Matrix4<Real>& m);
-    Matrix4(Real a11, Real a12, Real a13, Real a14,
-            Real a21, Real a22, Real a23, Real a24,
-            Real a31, Real a32, Real a33, Real a34,
-            Real a41, Real a42, Real a43, Real a44, bool colMajor = true);
-    ~Matrix4();
-
-    void set(const Matrix3<Real>& m, bool homogeneous = true);
-    void set(const Matrix4<Real>& m);
-    void set(const Real* const data);
-    void set(std::size_t i, std::size_t j, Real value);
-    void set(Real a11, Real a12, Real a13, Real a14,
-             Real a21, Real a22, Real a23, Real a24,
-             Real a31, Real a32, Real a33, Real a34,
-             Real a41, Real a42, Real a43, Real a44, bool colMajor = true);
-
-    void setRow(std::size_t i, Real w, Real x, Real y, Real z);
-    void setRow(std::size_t i, const Vector4<Real>& row);
-    void setColumn(std::size_t i, Real w, Real x, Real y, Real z);
-    void setColumn(std::size_t i, const Vector4<Real>& column);
-
-    bool isZero(Real epsilon);
-    bool isIdentity(Real epsilon);
+    /*
+     * Kind of transformation held by a matrix, from the most to the least
+     * specialized. Every kind except TRANSFORM_GENERAL is affine (last column
+     * (0, 0, 0, 1)); rigid and uniform scale matrices have an orthogonal
+     * 3x3 block up to the factor s (reflections included).
+     */
+    enum TransformKind { TRANSFORM_IDENTITY,
+                         TRANSFORM_RIGID,
+                         TRANSFORM_UNIFORM_SCALE,
+                         TRANSFORM_AFFINE,
+                         TRANSFORM_GENERAL };
+
+    MATH_CONSTEXPR Matrix4(bool identity = true);
+    MATH_CONSTEXPR Matrix4(const Real* const data);
+    MATH_CONSTEXPR Matrix4(const Matrix3<Real>& m, bool homogeneous = true);
+    MATH_CONSTEXPR Matrix4(Real a11, Real a12, Real a13, Real a14,
+                           Real a21, Real a22, Real a23, Real a24,
+                           Real a31, Real a32, Real a33, Real a34,
+                           Real a41, Real a42, Real a43, Real a44, bool colMajor = true);
+
+    MATH_CONSTEXPR void set(const Matrix3<Real>& m, bool homogeneous = true);
+    MATH_CONSTEXPR void set(const Matrix4<Real>& m);
+    MATH_CONSTEXPR void set(const Real* const data);
+    MATH_CONSTEXPR void set(std::size_t i, std::size_t j, Real value);
+    MATH_CONSTEXPR void set(Real a11, Real a12, Real a13, Real a14,
+                            Real a21, Real a22, Real a23, Real a24,
+                            Real a31, Real a32, Real a33, Real a34,
+                            Real a41, Real a42, Real a43, Real a44, bool colMajor = true);
+
+    MATH_CONSTEXPR void setRow(std::size_t i, Real w, Real x, Real y, Real z);
+    MATH_CONSTEXPR void setRow(std::size_t i, const Vector4<Real>& row);
+    MATH_CONSTEXPR void setColumn(std::size_t i, Real w, Real x, Real y, Real z);
+    MATH_CONSTEXPR void setColumn(std::size_t i, const Vector4<Real>& column);
+
+    MATH_CONSTEXPR bool isZero(Real epsilon);
+    MATH_CONSTEXPR bool isIdentity(Real epsilon);
     bool isEquivalent(const Matrix4<Real>& m, Real epsilon);
 
-    void zero();
-    void transpose();
-    void identity();
+    MATH_CONSTEXPR void zero();
+    MATH_CONSTEXPR void transpose();
+    MATH_CONSTEXPR void identity();
 
     void invert();
 
-    void clear(bool identity = true);
+    MATH_CONSTEXPR void clear(bool identity = true);
     void toRawMatrix(Real* const matrix, bool colMajor = true) const;
     void getData(Real* const matrix, bool colMajor = true) const;
 
-    Real determinant() const;
+    MATH_CONSTEXPR Real determinant() const;
+    TransformKind classify() const;
     Matrix4<Real> inverse() const;
     Matrix4<Real> inversed() const;
-    Matrix4<Real> transposed() const;
+    MATH_CONSTEXPR Matrix4<Real> transposed() const;
 
     template <typename RealCastType>
     Matrix4<RealCastType> cast();
 
-    Real& get(std::size_t i, std::size_t j);
-    const Real& get(std::size_t i, std::size_t j) const;
+    MATH_CONSTEXPR Real& get(std::size_t i, std::size_t j);
+    MATH_CONSTEXPR const Real& get(std::size_t i, std::size_t j) const;
     Vector4<Real> getRow(std::size_t i) const;
     Vector4<Real> getColumn(std::size_t i) const;
 
-    Matrix4<Real> toTranspose() const;
+    MATH_CONSTEXPR Matrix4<Real> toTranspose() const;
     Matrix4<Real> toInverse() const;
     Matrix4<Real> apply(const Vector3<Real>& v, bool colMajor = true) const;
     Matrix4<Real> apply(const Vector4<Real>& v, bool colMajor = true) const;
     Vector3<Real> applyTo(const Vector3<Real>& v) const;
-	Vector4<Real> applyTo(const Vector4<Real>& v) const;
+	MATH_CONSTEXPR Vector4<Real> applyTo(const Vector4<Real>& v) const;
 
-    const Real* const constData() const;
+    MATH_CONSTEXPR const Real* const constData() const;
     operator const Real* const () const;
 
-    void set(unsigned int index, Real value) {
+    MATH_CONSTEXPR void set(unsigned int index, Real value) {
         this->data[index] = value;
     }
 
-    Real get(unsigned int index) {
+    MATH_CONSTEXPR Real get(unsigned int index) {
         return this->data[index];
     }
 
-    Real& operator () (std::size_t i, std::size_t j);
-    const Real& operator () (std::size_t i, std::size_t j) const;
+    MATH_CONSTEXPR Real& operator () (std::size_t i, std::size_t j);
+    MATH_CONSTEXPR const Real& operator () (std::size_t i, std::size_t j) const;
 
     friend std::ostream& operator << <> (std::ostream& out, const Matrix4<Real>& m);
 
-    bool operator == (const Matrix4<Real>& m);
-	bool operator != (const Matrix4<Real>& m);
+    MATH_CONSTEXPR bool operator == (const Matrix4<Real>& m);
+	MATH_CONSTEXPR bool operator != (const Matrix4<Real>& m);
 
-    Matrix4<Real>& operator = (const Matrix4<Real>& m);
-	Matrix4<Real>& operator = (const Real* data);
+	MATH_CONSTEXPR Matrix4<Real>& operator = (const Real* data);
 
     Vector3<Real> operator * (const Vector3<Real>& v);
-	Matrix4<Real> operator * (const Matrix4<Real>& m);
-    Matrix4<Real>& operator *= (const Matrix4<Real>& m);
+	MATH_CONSTEXPR Matrix4<Real> operator * (const Matrix4<Real>& m);
+    MATH_CONSTEXPR Matrix4<Real>& operator *= (const Matrix4<Real>& m);
 
     static void ToRawMatrix(const Matrix4<Real>& m, Real* const matrix, bool colMajor = true);
     static void Clear(Matrix4<Real>& m);
     static void Identity(Matrix4<Real>& m);
     static void Zero(Matrix4<Real>& m);
-    static Real Determinant(const Matrix4<Real>& m);
-    static Real Determinant(const Matrix4<Real>& matrix, Real* const adjoint);
-    static Matrix4<Real> Multiply(const Matrix4<Real>& a, const Matrix4<Real>& b);
-    static Matrix4<Real> Transpose(const Matrix4<Real>& m);
+    static MATH_CONSTEXPR Real Determinant(const Matrix4<Real>& m);
+    static MATH_CONSTEXPR Real Determinant(const Matrix4<Real>& matrix, Real* const adjoint);
+    static MATH_CONSTEXPR Matrix4<Real> Multiply(const Matrix4<Real>& a, const Matrix4<Real>& b);
+    static MATH_CONSTEXPR Matrix4<Real> Transpose(const Matrix4<Real>& m);
+    static TransformKind Classify(const Matrix4<Real>& m);
     static Matrix4<Real> Inverse(const Matrix4<Real>& m);
+    static MATH_CONSTEXPR Matrix4<Real> Inverse(const Matrix4<Real>& m, TransformKind kind);
+    static MATH_CONSTEXPR Matrix4<Real> GeneralInverse(const Matrix4<Real>& m);
+    static MATH_CONSTEXPR Matrix4<Real> AffineInverse(const Matrix4<Real>& m);
+    static MATH_CONSTEXPR Matrix4<Real> OrthogonalInverse(const Matrix4<Real>& m);
     static Matrix4<Real> LookAt(const Vector3<Real>& eye, const Vector3<Real>& lookat, const Vector3<Real>& up);
     static Matrix4<Real> LookAt(Real eyex, Real eyey, Real eyez, Real atx, Real aty, Real atz, Real upx, Real upy, Real upz);
     static Matrix3<Real> NormalMatrix(const Matrix4<Real>& modelViewMatrix);
+    static MATH_CONSTEXPR Matrix3<Real> NormalMatrix(const Matrix4<Real>& modelViewMatrix, TransformKind kind);
 
-    static Matrix4<Real> Zero();
-    static Matrix4<Real> Identity();
+    static MATH_CONSTEXPR Matrix4<Real> Translation(Real x, Real y, Real z);
+    static MATH_CONSTEXPR Matrix4<Real> Scaling(Real sx, Real sy, Real sz);
+    static MATH_CONSTEXPR Matrix4<Real> Zero();
+    static MATH_CONSTEXPR Matrix4<Real> Identity();
 
 protected:
 	const static int ROW_COUNT = 4;
@@ -171,9 +191,7 @@ protected:
 };
 
 template <typename Real>
-Matrix4<Real>::Matrix4(bool identity) {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
-
+MATH_CONSTEXPR Matrix4<Real>::Matrix4(bool identity) : data() {
     if ( identity ) {
         this->data[A_11] = Real(1);
         this->data[A_22] = Real(1);
@@ -183,25 +201,20 @@ Matrix4<Real>::Matrix4(bool identity) {
 }
 
 template <typename Real>
-Matrix4<Real>::Matrix4(const Real* const data) {
-    std::memcpy(this->data, data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR Matrix4<Real>::Matrix4(const Real* const data) : data() {
+    this->set(data);
 }
 
 template <typename Real>
-Matrix4<Real>::Matrix4(const Matrix3<Real>& m, bool homogeneous) {
+MATH_CONSTEXPR Matrix4<Real>::Matrix4(const Matrix3<Real>& m, bool homogeneous) : data() {
     this->set(m, homogeneous);
 }
 
 template <typename Real>
-Matrix4<Real>::Matrix4(const Matrix4<Real>& m) {
-    std::memcpy(this->data, m.data, COMPONENT_COUNT * sizeof(Real));
-}
-
-template <typename Real>
-Matrix4<Real>::Matrix4(Real a11, Real a12, Real a13, Real a14,
-                       Real a21, Real a22, Real a23, Real a24,
-                       Real a31, Real a32, Real a33, Real a34,
-                       Real a41, Real a42, Real a43, Real a44, bool colMajor) {
+MATH_CONSTEXPR Matrix4<Real>::Matrix4(Real a11, Real a12, Real a13, Real a14,
+                                      Real a21, Real a22, Real a23, Real a24,
+                                      Real a31, Real a32, Real a33, Real a34,
+                                      Real a41, Real a42, Real a43, Real a44, bool colMajor) : data() {
     this->set(
         a11, a12, a13, a14, 
         a21, a22, a23, a24, 
@@ -212,11 +225,8 @@ Matrix4<Real>::Matrix4(Real a11, Real a12, Real a13, Real a14,
 }
 
 template <typename Real>
-Matrix4<Real>::~Matrix4() {}
-
-template <typename Real>
-void Matrix4<Real>::set(const Matrix3<Real>& m, bool homogeneous) {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix4<Real>::set(const Matrix3<Real>& m, bool homogeneous) {
+    this->zero();
 
     if ( homogeneous ) this->data[A_44] = Real(1);
 
@@ -234,17 +244,18 @@ void Matrix4<Real>::set(const Matrix3<Real>& m, bool homogeneous) {
 }
 
 template <typename Real>
-void Matrix4<Real>::set(const Matrix4<Real>& m) {
-    std::memcpy(this->data, m.data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix4<Real>::set(const Matrix4<Real>& m) {
+    this->set(m.data);
 }
 
 template <typename Real>
-void Matrix4<Real>::set(const Real* const data) {
-    std::memcpy(this->data, data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix4<Real>::set(const Real* const data) {
+    for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
+        this->data[i] = data[i];
 }
 
 template <typename Real>
-void Matrix4<Real>::set(std::size_t i, std::size_t j, Real value) {
+MATH_CONSTEXPR void Matrix4<Real>::set(std::size_t i, std::size_t j, Real value) {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix4:set] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix4:set] Index j out of bounds.");
 
@@ -252,10 +263,10 @@ void Matrix4<Real>::set(std::size_t i, std::size_t j, Real value) {
 }
 
 template <typename Real>
-void Matrix4<Real>::set(Real a11, Real a12, Real a13, Real a14,
-                        Real a21, Real a22, Real a23, Real a24,
-                        Real a31, Real a32, Real a33, Real a34,
-                        Real a41, Real a42, Real a43, Real a44, bool colMajor) {
+MATH_CONSTEXPR void Matrix4<Real>::set(Real a11, Real a12, Real a13, Real a14,
+                                       Real a21, Real a22, Real a23, Real a24,
+                                       Real a31, Real a32, Real a33, Real a34,
+                                       Real a41, Real a42, Real a43, Real a44, bool colMajor) {
     this->data[A_11] = a11;
     this->data[A_22] = a22;
     this->data[A_33] = a33;
@@ -292,7 +303,7 @@ void Matrix4<Real>::set(Real a11, Real a12, Real a13, Real a14,
 }
 
 template <typename Real>
-void Matrix4<Real>::setRow(std::size_t i, Real w, Real x, Real y, Real z) {
+MATH_CONSTEXPR void Matrix4<Real>::setRow(std::size_t i, Real w, Real x, Real y, Real z) {
     if ( i >= COL_COUNT ) throw std::exception("[Matrix4:getColumn] Error: Column index out of bounds.");
 
     if ( i == 0 ) {
@@ -325,12 +336,12 @@ void Matrix4<Real>::setRow(std::size_t i, Real w, Real x, Real y, Real z) {
 }
 
 template <typename Real>
-void Matrix4<Real>::setRow(std::size_t i, const Vector4<Real>& row) {
+MATH_CONSTEXPR void Matrix4<Real>::setRow(std::size_t i, const Vector4<Real>& row) {
     this->setRow(i, row.w(), row.x(), row.y(), row.z());
 }
 
 template <typename Real>
-void Matrix4<Real>::setColumn(std::size_t i, Real w, Real x, Real y, Real z) {
+MATH_CONSTEXPR void Matrix4<Real>::setColumn(std::size_t i, Real w, Real x, Real y, Real z) {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix4:setRow] Error: Row index out of bounds.");
 
     if ( i == 0 ) {
@@ -363,12 +374,12 @@ void Matrix4<Real>::setColumn(std::size_t i, Real w, Real x, Real y, Real z) {
 }
 
 template <typename Real>
-void Matrix4<Real>::setColumn(std::size_t i, const Vector4<Real>& column) {
+MATH_CONSTEXPR void Matrix4<Real>::setColumn(std::size_t i, const Vector4<Real>& column) {
     this->setColumn(i, column.w(), column.x(), column.y(), column.z());
 }
 
 template <typename Real>
-bool Matrix4<Real>::isZero(Real epsilon) {
+MATH_CONSTEXPR bool Matrix4<Real>::isZero(Real epsilon) {
     for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ ) {
         Real value = this->data[i];
 
@@ -379,7 +390,7 @@ bool Matrix4<Real>::isZero(Real epsilon) {
 }
 
 template <typename Real>
-bool Matrix4<Real>::isIdentity(Real epsilon) {
+MATH_CONSTEXPR bool Matrix4<Real>::isIdentity(Real epsilon) {
     if ( this->data[A_11] < Real(1) - epsilon || this->data[A_11] > Real(1) + epsilon ) return false;
     if ( this->data[A_22] < Real(1) - epsilon || this->data[A_22] > Real(1) + epsilon ) return false;
     if ( this->data[A_33] < Real(1) - epsilon || this->data[A_33] > Real(1) + epsilon ) return false;
@@ -425,43 +436,35 @@ bool Matrix4<Real>::isEquivalent(const Matrix4<Real>& m, Real epsilon) {
 }
 
 template <typename Real>
-void Matrix4<Real>::zero() {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix4<Real>::zero() {
+    for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
+        this->data[i] = Real(0);
 }
 
 template <typename Real>
-void Matrix4<Real>::transpose() {
-    std::swap(this->data[A_12], this->data[A_21]);
-    std::swap(this->data[A_13], this->data[A_31]);
-    std::swap(this->data[A_14], this->data[A_41]);
-    std::swap(this->data[A_23], this->data[A_32]);
-    std::swap(this->data[A_24], this->data[A_42]);
-    std::swap(this->data[A_34], this->data[A_43]);
+MATH_CONSTEXPR void Matrix4<Real>::transpose() {
+    *this = Matrix4<Real>::Transpose(*this);
 }
 
 template <typename Real>
-void Matrix4<Real>::identity() {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
-    this->data[A_11] = Real(1);
-    this->data[A_22] = Real(1);
-    this->data[A_33] = Real(1);
-    this->data[A_44] = Real(1);
+MATH_CONSTEXPR void Matrix4<Real>::identity() {
+    this->clear(true);
 }
 
 template <typename Real>
 void Matrix4<Real>::invert() {
-    Matrix4<Real> inverse = Matrix4<Real>::Inverse(*this);
-    std::memcpy(this->data, inverse.data, COMPONENT_COUNT * sizeof(Real));
+    *this = Matrix4<Real>::Inverse(*this);
 }
 
 template <typename Real>
-void Matrix4<Real>::clear(bool identity) {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR void Matrix4<Real>::clear(bool identity) {
+    this->zero();
 
     if ( identity ) {
         this->data[A_11] = Real(1);
         this->data[A_22] = Real(1);
         this->data[A_33] = Real(1);
+        this->data[A_44] = Real(1);
     }
 }
 
@@ -479,10 +482,15 @@ void Matrix4<Real>::getData(Real* const matrix, bool colMajor) const {
 }
 
 template <typename Real>
-Real Matrix4<Real>::determinant() const {
+MATH_CONSTEXPR Real Matrix4<Real>::determinant() const {
     return Matrix4<Real>::Determinant(*this);
 }
 
+template <typename Real>
+typename Matrix4<Real>::TransformKind Matrix4<Real>::classify() const {
+    return Matrix4<Real>::Classify(*this);
+}
+
 template <typename Real>
 Matrix4<Real> Matrix4<Real>::inverse() const {
     return Matrix4<Real>::Inverse(*this);
@@ -494,7 +502,7 @@ Matrix4<Real> Matrix4<Real>::inversed() const {
 }
 
 template <typename Real>
-Matrix4<Real> Matrix4<Real>::transposed() const {
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::transposed() const {
     return Matrix4<Real>::Transpose(*this);
 }
 
@@ -509,19 +517,19 @@ Matrix4<RealCastType> Matrix4<Real>::cast() {
 
 
 template <typename Real>
-Real& Matrix4<Real>::get(std::size_t i, std::size_t j) {
+MATH_CONSTEXPR Real& Matrix4<Real>::get(std::size_t i, std::size_t j) {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix4:get] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix4:get] Index j out of bounds.");
 
-    return this->data[i * ROW_SIZE + j];
+    return this->data[i * ROW_COUNT + j];
 }
 
 template <typename Real>
-const Real& Matrix4<Real>::get(std::size_t i, std::size_t j) const {
+MATH_CONSTEXPR const Real& Matrix4<Real>::get(std::size_t i, std::size_t j) const {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix4:get] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix4:get] Index j out of bounds.");
 
-    return this->data[i * ROW_SIZE + j];
+    return this->data[i * ROW_COUNT + j];
 }
 
 template <typename Real>
@@ -531,7 +539,7 @@ Vector4<Real> Matrix4<Real>::getColumn(std::size_t i) const {
     if ( i == 1 ) return Vector4<Real>(this->data[A_24], this->data[A_21], this->data[A_22], this->data[A_23]);
     if ( i == 2 ) return Vector4<Real>(this->data[A_34], this->data[A_31], this->data[A_32], this->data[A_33]);
     if ( i == 3 ) return Vector4<Real>(this->data[A_44], this->data[A_41], this->data[A_42], this->data[A_43]);
-    return Vector4<Real>::Zero()
+    return Vector4<Real>::Zero();
 }
 
 template <typename Real>
@@ -545,7 +553,7 @@ Vector4<Real> Matrix4<Real>::getRow(std::size_t i) const {
 }
 
 template <typename Real>
-Matrix4<Real> Matrix4<Real>::toTranspose() const {
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::toTranspose() const {
     Matrix4<Real> result = (*this);
     return Matrix4<Real>::Transpose(result);
 }
@@ -589,7 +597,7 @@ Vector3<Real> Matrix4<Real>::applyTo(const Vector3<Real>& v) const {
 }
 
 template <typename Real>
-Vector4<Real> Matrix4<Real>::applyTo(const Vector4<Real>& v) const {
+MATH_CONSTEXPR Vector4<Real> Matrix4<Real>::applyTo(const Vector4<Real>& v) const {
     Vector4<Real> result;
     result.w() = this->data[A_11] * v.w() + this->data[A_12] * v.x() + this->data[A_13] * v.y() + this->data[A_14] * v.z();
     result.x() = this->data[A_21] * v.w() + this->data[A_22] * v.x() + this->data[A_23] * v.y() + this->data[A_24] * v.z();
@@ -599,7 +607,7 @@ Vector4<Real> Matrix4<Real>::applyTo(const Vector4<Real>& v) const {
 }
 
 template <typename Real>
-const Real* const Matrix4<Real>::constData() const {
+MATH_CONSTEXPR const Real* const Matrix4<Real>::constData() const {
     return this->data;
 }
 
@@ -609,7 +617,7 @@ Matrix4<Real>::operator const Real* const () const {
 }
 
 template <typename Real>
-Real& Matrix4<Real>::operator () (std::size_t i, std::size_t j) {
+MATH_CONSTEXPR Real& Matrix4<Real>::operator () (std::size_t i, std::size_t j) {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix4:()] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix4:()] Index j out of bounds.");
 
@@ -617,7 +625,7 @@ Real& Matrix4<Real>::operator () (std::size_t i, std::size_t j) {
 }
 
 template <typename Real>
-const Real& Matrix4<Real>::operator () (std::size_t i, std::size_t j) const {
+MATH_CONSTEXPR const Real& Matrix4<Real>::operator () (std::size_t i, std::size_t j) const {
     if ( i >= ROW_COUNT ) throw std::exception("[Matrix4:()] Index i out of bounds.");
 	if ( j >= COL_COUNT ) throw std::exception("[Matrix4:()] Index j out of bounds.");
 
@@ -635,28 +643,21 @@ std::ostream& operator << (std::ostream& out, const Matrix4<Real>& m) {
 }
 
 template <typename Real>
-bool Matrix4<Real>::operator == (const Matrix4<Real>& m) {
+MATH_CONSTEXPR bool Matrix4<Real>::operator == (const Matrix4<Real>& m) {
     for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
         if ( this->data[i] != m.data[i] ) return false;
     return true;
 }
 
 template <typename Real>
-bool Matrix4<Real>::operator != (const Matrix4<Real>& m) {
+MATH_CONSTEXPR bool Matrix4<Real>::operator != (const Matrix4<Real>& m) {
     return !(*this == m);
 }
 
 template <typename Real>
-Matrix4<Real>& Matrix4<Real>::operator = (const Matrix4<Real>& m) {
-    if ( this == &m ) return *this;
-    std::memcpy(this->data, m.data, COMPONENT_COUNT * sizeof(Real));
-    return *this;
-}
-
-template <typename Real>
-Matrix4<Real>& Matrix4<Real>::operator = (const Real* data) {
+MATH_CONSTEXPR Matrix4<Real>& Matrix4<Real>::operator = (const Real* data) {
     if ( nullptr == data ) return *this;
-    std::memcpy(this->data, data, COMPONENT_COUNT * sizeof(Real));
+    this->set(data);
     return *this;
 }
 
@@ -666,15 +667,14 @@ Vector3<Real> Matrix4<Real>::operator * (const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Matrix4<Real> Matrix4<Real>::operator * (const Matrix4<Real>& m) {
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::operator * (const Matrix4<Real>& m) {
     Matrix4<Real> t = (*this);
     return Matrix4<Real>::Multiply(t, m);
 }
 
 template <typename Real>
-Matrix4<Real>& Matrix4<Real>::operator *= (const Matrix4<Real>& m) {
-    Matrix4<Real> result = Matrix4<Real>::Multiply(*this, m);
-    std::memcpy(this->data, result.data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR Matrix4<Real>& Matrix4<Real>::operator *= (const Matrix4<Real>& m) {
+    *this = Matrix4<Real>::Multiply(*this, m);
     return *this;
 }
 
@@ -710,16 +710,15 @@ void Matrix4<Real>::Zero(Matrix4<Real>& m) {
 }
 
 template <typename Real>
-Real Matrix4<Real>::Determinant(const Matrix4<Real>& matrix) {
-    Real adjoint[COMPONENT_COUNT];
+MATH_CONSTEXPR Real Matrix4<Real>::Determinant(const Matrix4<Real>& matrix) {
+    Real adjoint[COMPONENT_COUNT] = {};
     return Matrix4<Real>::Determinant(matrix, adjoint);
 }
 
 /* Loop-unroll determinant */
 template <typename Real>
-Real Matrix4<Real>::Determinant(const Matrix4<Real>& matrix, Real* const adjoint) {
-    Real m[COMPONENT_COUNT];
-    std::memcpy(m, matrix.data, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR Real Matrix4<Real>::Determinant(const Matrix4<Real>& matrix, Real* const adjoint) {
+    const Real* m = matrix.data;
 
     adjoint[0] = m[5]  * m[10] * m[15] - 
              m[5]  * m[11] * m[14] - 
@@ -838,7 +837,7 @@ Real Matrix4<Real>::Determinant(const Matrix4<Real>& matrix, Real* const adjoint
 
 /* Memory friendly matrix multiplication (Gita A., Lan V.) */
 template <typename Real>
-Matrix4<Real> Matrix4<Real>::Multiply(const Matrix4<Real>& a, const Matrix4<Real>& b) {
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::Multiply(const Matrix4<Real>& a, const Matrix4<Real>& b) {
     Matrix4<Real> result(false);
     for ( unsigned int i = 0; i < ROW_COUNT; i++ )
 		for ( unsigned int j = 0; j < ROW_COUNT; j++ )
@@ -854,25 +853,76 @@ Matrix4<Real> Matrix4<Real>::Multiply(const Matrix4<Real>& a, const Matrix4<Real
 }
 
 template <typename Real>
-Matrix4<Real> Matrix4<Real>::Transpose(const Matrix4<Real>& m) {
-    Matrix4<Real> result = m;
-    std::swap(result.data[A_12], result.data[A_21]);
-    std::swap(result.data[A_13], result.data[A_31]);
-    std::swap(result.data[A_14], result.data[A_41]);
-    std::swap(result.data[A_23], result.data[A_32]);
-    std::swap(result.data[A_24], result.data[A_42]);
-    std::swap(result.data[A_34], result.data[A_43]);
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::Transpose(const Matrix4<Real>& m) {
+    Matrix4<Real> result(false);
+    for ( unsigned int i = 0; i < ROW_COUNT; i++ )
+        for ( unsigned int j = 0; j < COL_COUNT; j++ )
+            result.data[j * ROW_COUNT + i] = m.data[i * ROW_COUNT + j];
     return result;
 }
 
+/*
+ * Classifies the transformation held by m. The 3x3 block of a rigid or
+ * uniform scale transformation has rows of equal length s that are mutually
+ * orthogonal, i.e. its Gram matrix is s^2 I. The tolerance is a few ulps
+ * relative to s^2, so the closed form inverses of the specialized kinds are
+ * as accurate as the general inverse; matrices that only approximate these
+ * kinds are classified as TRANSFORM_AFFINE.
+ */
 template <typename Real>
-Matrix4<Real> Matrix4<Real>::Inverse(const Matrix4<Real>& matrix) {
-    Real m[COMPONENT_COUNT];
-    Real adjoint[COMPONENT_COUNT];
+typename Matrix4<Real>::TransformKind Matrix4<Real>::Classify(const Matrix4<Real>& m) {
+    const Real* a = m.data;
+    if ( a[A_41] != Real(0) || a[A_42] != Real(0) || a[A_43] != Real(0) || a[A_44] != Real(1) ) return TRANSFORM_GENERAL;
+
+    Real g00 = a[0] * a[0] + a[1] * a[1] + a[2] * a[2];
+    Real g11 = a[4] * a[4] + a[5] * a[5] + a[6] * a[6];
+    Real g22 = a[8] * a[8] + a[9] * a[9] + a[10] * a[10];
+    Real g01 = a[0] * a[4] + a[1] * a[5] + a[2] * a[6];
+    Real g02 = a[0] * a[8] + a[1] * a[9] + a[2] * a[10];
+    Real g12 = a[4] * a[8] + a[5] * a[9] + a[6] * a[10];
+
+    Real scale2 = (g00 + g11 + g22) / Real(3);
+    if ( scale2 == Real(0) ) return TRANSFORM_AFFINE;
 
-    std::memcpy(m, matrix.data, COMPONENT_COUNT * sizeof(Real));
-    std::memset(adjoint, 0, COMPONENT_COUNT * sizeof(Real));
-	
+    const Real ulps = Real(16) * std::numeric_limits<Real>::epsilon();
+    Real tolerance = ulps * scale2;
+    if ( std::abs(g00 - scale2) > tolerance || std::abs(g11 - scale2) > tolerance || std::abs(g22 - scale2) > tolerance ) return TRANSFORM_AFFINE;
+    if ( std::abs(g01) > tolerance || std::abs(g02) > tolerance || std::abs(g12) > tolerance ) return TRANSFORM_AFFINE;
+    if ( std::abs(scale2 - Real(1)) > ulps ) return TRANSFORM_UNIFORM_SCALE;
+
+    if ( a[A_11] == Real(1) && a[A_22] == Real(1) && a[A_33] == Real(1) &&
+         a[A_12] == Real(0) && a[A_13] == Real(0) && a[A_21] == Real(0) &&
+         a[A_23] == Real(0) && a[A_31] == Real(0) && a[A_32] == Real(0) &&
+         a[A_14] == Real(0) && a[A_24] == Real(0) && a[A_34] == Real(0) ) return TRANSFORM_IDENTITY;
+    return TRANSFORM_RIGID;
+}
+
+/*
+ * Inverse dispatched on the kind of transformation (see Classify): the
+ * identity is its own inverse, rigid and uniform scale transformations are
+ * inverted by a transpose (OrthogonalInverse), other affine transformations
+ * by AffineInverse and only projective matrices need GeneralInverse.
+ */
+template <typename Real>
+Matrix4<Real> Matrix4<Real>::Inverse(const Matrix4<Real>& m) {
+    return Matrix4<Real>::Inverse(m, Matrix4<Real>::Classify(m));
+}
+
+/* Inverse of m whose kind is already known to the caller. */
+template <typename Real>
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::Inverse(const Matrix4<Real>& m, TransformKind kind) {
+    switch ( kind ) {
+        case TRANSFORM_IDENTITY: return Matrix4<Real>(true);
+        case TRANSFORM_RIGID:
+        case TRANSFORM_UNIFORM_SCALE: return Matrix4<Real>::OrthogonalInverse(m);
+        case TRANSFORM_AFFINE: return Matrix4<Real>::AffineInverse(m);
+        default: return Matrix4<Real>::GeneralInverse(m);
+    }
+}
+
+template <typename Real>
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::GeneralInverse(const Matrix4<Real>& matrix) {
+    Real adjoint[COMPONENT_COUNT] = {};
     Real det = Matrix4<Real>::Determinant(matrix, adjoint);
     if ( det == Real(0) ) return Matrix4<Real>(true);
     Real invDet = Real(1) / det;
@@ -881,6 +931,69 @@ Matrix4<Real> Matrix4<Real>::Inverse(const Matrix4<Real>& matrix) {
     return Matrix4<Real>(adjoint);
 }
 
+/*
+ * Inverse of an affine transformation, i.e. a matrix whose last column is
+ * (0, 0, 0, 1). The rows of the inverse of the upper 3x3 block are built from
+ * the cross products of its rows and the translation row is transformed by
+ * the negated inverse, which is several times cheaper than Inverse. Returns
+ * the identity if the 3x3 block is singular.
+ */
+template <typename Real>
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::AffineInverse(const Matrix4<Real>& m) {
+    const Real* a = m.data;
+
+    //--------------------------------------------------------------------------
+    // The columns of the 3x3 inverse are r1 x r2, r2 x r0 and r0 x r1 divided
+    // by the determinant r0 . (r1 x r2), where ri is row i of the 3x3 block.
+    //--------------------------------------------------------------------------
+    Real c0[3] = { a[5] * a[10] - a[6] * a[9], a[6] * a[8] - a[4] * a[10], a[4] * a[9] - a[5] * a[8] };
+    Real c1[3] = { a[9] * a[2] - a[10] * a[1], a[10] * a[0] - a[8] * a[2], a[8] * a[1] - a[9] * a[0] };
+    Real c2[3] = { a[1] * a[6] - a[2] * a[5], a[2] * a[4] - a[0] * a[6], a[0] * a[5] - a[1] * a[4] };
+
+    Real det = a[0] * c0[0] + a[1] * c0[1] + a[2] * c0[2];
+    if ( det == Real(0) ) return Matrix4<Real>(true);
+    Real invDet = Real(1) / det;
+
+    Matrix4<Real> result(true);
+    for ( unsigned int i = 0; i < 3; i++ ) {
+        result.data[i * ROW_COUNT + 0] = c0[i] * invDet;
+        result.data[i * ROW_COUNT + 1] = c1[i] * invDet;
+        result.data[i * ROW_COUNT + 2] = c2[i] * invDet;
+    }
+
+    for ( unsigned int j = 0; j < 3; j++ )
+        result.data[3 * ROW_COUNT + j] = -(a[12] * result.data[j] + a[13] * result.data[ROW_COUNT + j] + a[14] * result.data[2 * ROW_COUNT + j]);
+
+    return result;
+}
+
+/*
+ * Inverse of a rigid or uniform scale transformation. The 3x3 block R is s
+ * times an orthogonal matrix, so its inverse is transpose(R) / s^2 and the
+ * translation row is transformed by the negated inverse. Returns the identity
+ * if the 3x3 block is zero.
+ */
+template <typename Real>
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::OrthogonalInverse(const Matrix4<Real>& m) {
+    const Real* a = m.data;
+
+    Real scale2 = (a[0] * a[0] + a[1] * a[1] + a[2] * a[2] +
+                   a[4] * a[4] + a[5] * a[5] + a[6] * a[6] +
+                   a[8] * a[8] + a[9] * a[9] + a[10] * a[10]) / Real(3);
+    if ( scale2 == Real(0) ) return Matrix4<Real>(true);
+    Real invScale2 = Real(1) / scale2;
+
+    Matrix4<Real> result(true);
+    for ( unsigned int i = 0; i < 3; i++ )
+        for ( unsigned int j = 0; j < 3; j++ )
+            result.data[i * ROW_COUNT + j] = a[j * ROW_COUNT + i] * invScale2;
+
+    for ( unsigned int j = 0; j < 3; j++ )
+        result.data[3 * ROW_COUNT + j] = -(a[12] * result.data[j] + a[13] * result.data[ROW_COUNT + j] + a[14] * result.data[2 * ROW_COUNT + j]);
+
+    return result;
+}
+
 template <typename Real>
 Matrix4<Real> Matrix4<Real>::LookAt(const Vector3<Real>& eye, const Vector3<Real>& lookAt, const Vector3<Real>& up) {
     return Matrix4<Real>::LookAt(eye.x(), eye.y(), eye.z(), lookAt.x(), lookAt.y(), lookAt.z(), up.x(), up.y(), up.z());
@@ -923,35 +1036,312 @@ Matrix4<Real> Matrix4<Real>::LookAt(Real eyex, Real eyey, Real eyez, Real atx, R
     return matrix;
 }
 
+/*
+ * Inverse transpose of the 3x3 block of the model view matrix, which
+ * transforms normals. For rigid transformations this is the 3x3 block
+ * itself and for uniform scale transformations the block divided by s^2;
+ * everything else uses the cofactor matrix divided by the determinant.
+ */
 template <typename Real>
 Matrix3<Real> Matrix4<Real>::NormalMatrix(const Matrix4<Real>& modelViewMatrix) {
-    Matrix3f normalMatrix;
+    return Matrix4<Real>::NormalMatrix(modelViewMatrix, Matrix4<Real>::Classify(modelViewMatrix));
+}
 
-    Vector4f mvRow1 = modelViewMatrix.getRow(0);
-    Vector4f mvRow2 = modelViewMatrix.getRow(1);
-    Vector4f mvRow3 = modelViewMatrix.getRow(2);
+template <typename Real>
+MATH_CONSTEXPR Matrix3<Real> Matrix4<Real>::NormalMatrix(const Matrix4<Real>& modelViewMatrix, TransformKind kind) {
+    const Real* a = modelViewMatrix.data;
+    Real normal[9] = { a[0], a[1], a[2], a[4], a[5], a[6], a[8], a[9], a[10] };
+    if ( kind == TRANSFORM_IDENTITY || kind == TRANSFORM_RIGID ) return Matrix3<Real>(normal);
 
-    Vector3f normalMatrixRow1(mvRow1.x(), mvRow1.y(), mvRow1.z());
-    Vector3f normalMatrixRow2(mvRow2.x(), mvRow2.y(), mvRow2.z());
-    Vector3f normalMatrixRow3(mvRow3.x(), mvRow3.y(), mvRow3.z());
-    
-    normalMatrix.setRow(0, normalMatrixRow1);
-    normalMatrix.setRow(1, normalMatrixRow2);
-    normalMatrix.setRow(2, normalMatrixRow3);
+    if ( kind == TRANSFORM_UNIFORM_SCALE ) {
+        Real scale2 = (normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2] +
+                       normal[3] * normal[3] + normal[4] * normal[4] + normal[5] * normal[5] +
+                       normal[6] * normal[6] + normal[7] * normal[7] + normal[8] * normal[8]) / Real(3);
+        Real invScale2 = Real(1) / scale2;
+        for ( unsigned int i = 0; i < 9; i++ ) normal[i] *= invScale2;
+        return Matrix3<Real>(normal);
+    }
 
-    return normalMatrix;
+    //--------------------------------------------------------------------------
+    // Row i of the cofactor matrix is the cross product of the other two rows
+    // of the 3x3 block. A singular block is returned as is.
+    //--------------------------------------------------------------------------
+    Real cofactor[9] = {
+        a[5] * a[10] - a[6] * a[9], a[6] * a[8] - a[4] * a[10], a[4] * a[9] - a[5] * a[8],
+        a[9] * a[2] - a[10] * a[1], a[10] * a[0] - a[8] * a[2], a[8] * a[1] - a[9] * a[0],
+        a[1] * a[6] - a[2] * a[5], a[2] * a[4] - a[0] * a[6], a[0] * a[5] - a[1] * a[4] };
+
+    Real det = a[0] * cofactor[0] + a[1] * cofactor[1] + a[2] * cofactor[2];
+    if ( det == Real(0) ) return Matrix3<Real>(normal);
+    Real invDet = Real(1) / det;
+
+    for ( unsigned int i = 0; i < 9; i++ ) cofactor[i] *= invDet;
+    return Matrix3<Real>(cofactor);
 }
 
+/* Translation by (x, y, z), stored in the last row (row vectors). */
 template <typename Real>
-Matrix4<Real> Matrix4<Real>::Zero() {
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::Translation(Real x, Real y, Real z) {
+    Matrix4<Real> result(true);
+    result.data[A_14] = x;
+    result.data[A_24] = y;
+    result.data[A_34] = z;
+    return result;
+}
+
+template <typename Real>
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::Scaling(Real sx, Real sy, Real sz) {
+    Matrix4<Real> result(true);
+    result.data[A_11] = sx;
+    result.data[A_22] = sy;
+    result.data[A_33] = sz;
+    return result;
+}
+
+template <typename Real>
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::Zero() {
     return Matrix4<Real>(false);
 }
 
 template <typename Real>
-Matrix4<Real> Matrix4<Real>::Identity() {
+MATH_CONSTEXPR Matrix4<Real> Matrix4<Real>::Identity() {
     return Matrix4<Real>(true);
 }
 
+//------------------------------------------------------------------------------
+// float specializations. Every row of the matrix is one vector register, so
+// with row vectors a row of a product is a linear combination of the rows of
+// the right hand side: one multiply and three multiply-adds per row.
+//------------------------------------------------------------------------------
+template <>
+inline Matrix4<float> Matrix4<float>::Multiply(const Matrix4<float>& a, const Matrix4<float>& b) {
+    Matrix4<float> result(false);
+    SimdFloat4 b0 = SimdLoad(b.data + 0 * ROW_COUNT);
+    SimdFloat4 b1 = SimdLoad(b.data + 1 * ROW_COUNT);
+    SimdFloat4 b2 = SimdLoad(b.data + 2 * ROW_COUNT);
+    SimdFloat4 b3 = SimdLoad(b.data + 3 * ROW_COUNT);
+
+    for ( unsigned int i = 0; i < ROW_COUNT; i++ ) {
+        const float* row = a.data + i * ROW_COUNT;
+        SimdFloat4 r = SimdMul(SimdSplat(row[0]), b0);
+        r = SimdMulAdd(SimdSplat(row[1]), b1, r);
+        r = SimdMulAdd(SimdSplat(row[2]), b2, r);
+        r = SimdMulAdd(SimdSplat(row[3]), b3, r);
+        SimdStore(result.data + i * ROW_COUNT, r);
+    }
+
+    return result;
+}
+
+/* 2x2 matrix product a * b, where a 2x2 matrix is stored as (m00, m01, m10, m11). */
+inline SimdFloat4 SimdMatrix2Multiply(SimdFloat4 a, SimdFloat4 b) {
+    return SimdAdd(SimdMul(a, SimdShuffle<0, 3, 0, 3>(b, b)), SimdMul(SimdShuffle<1, 0, 3, 2>(a, a), SimdShuffle<2, 1, 2, 1>(b, b)));
+}
+
+/* 2x2 matrix product adj(a) * b */
+inline SimdFloat4 SimdMatrix2AdjointMultiply(SimdFloat4 a, SimdFloat4 b) {
+    return SimdSub(SimdMul(SimdShuffle<3, 3, 0, 0>(a, a), b), SimdMul(SimdShuffle<1, 1, 2, 2>(a, a), SimdShuffle<2, 3, 0, 1>(b, b)));
+}
+
+/* 2x2 matrix product a * adj(b) */
+inline SimdFloat4 SimdMatrix2MultiplyAdjoint(SimdFloat4 a, SimdFloat4 b) {
+    return SimdSub(SimdMul(a, SimdShuffle<3, 0, 3, 0>(b, b)), SimdMul(SimdShuffle<1, 0, 3, 2>(a, a), SimdShuffle<2, 1, 2, 1>(b, b)));
+}
+
+/*
+ * General inverse through the 2x2 block decomposition
+ *
+ *   M = | A B |    inverse(M) = 1/|M| * | X Y |
+ *       | C D |                         | Z W |
+ *
+ * with X = adj(|D|A - B adj(D)C), W = adj(|A|D - C adj(A)B),
+ * Y = adj(|B|C - D adj(adj(A)B)), Z = adj(|C|B - A adj(adj(D)C)) and
+ * |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C), which only needs shuffles and
+ * four-wide arithmetic. Returns the identity if the matrix is singular.
+ */
+template <>
+inline Matrix4<float> Matrix4<float>::GeneralInverse(const Matrix4<float>& matrix) {
+    SimdFloat4 r0 = SimdLoad(matrix.data + 0 * ROW_COUNT);
+    SimdFloat4 r1 = SimdLoad(matrix.data + 1 * ROW_COUNT);
+    SimdFloat4 r2 = SimdLoad(matrix.data + 2 * ROW_COUNT);
+    SimdFloat4 r3 = SimdLoad(matrix.data + 3 * ROW_COUNT);
+
+    SimdFloat4 A = SimdShuffle<0, 1, 0, 1>(r0, r1);
+    SimdFloat4 B = SimdShuffle<2, 3, 2, 3>(r0, r1);
+    SimdFloat4 C = SimdShuffle<0, 1, 0, 1>(r2, r3);
+    SimdFloat4 D = SimdShuffle<2, 3, 2, 3>(r2, r3);
+
+    //--------------------------------------------------------------------------
+    // Determinants of the blocks as (|A|, |B|, |C|, |D|).
+    //--------------------------------------------------------------------------
+    SimdFloat4 detBlocks = SimdSub(
+        SimdMul(SimdShuffle<0, 2, 0, 2>(r0, r2), SimdShuffle<1, 3, 1, 3>(r1, r3)),
+        SimdMul(SimdShuffle<1, 3, 1, 3>(r0, r2), SimdShuffle<0, 2, 0, 2>(r1, r3)));
+    SimdFloat4 detA = SimdSplatLane<0>(detBlocks);
+    SimdFloat4 detB = SimdSplatLane<1>(detBlocks);
+    SimdFloat4 detC = SimdSplatLane<2>(detBlocks);
+    SimdFloat4 detD = SimdSplatLane<3>(detBlocks);
+
+    SimdFloat4 adjDC = SimdMatrix2AdjointMultiply(D, C);
+    SimdFloat4 adjAB = SimdMatrix2AdjointMultiply(A, B);
+    SimdFloat4 X = SimdSub(SimdMul(detD, A), SimdMatrix2Multiply(B, adjDC));
+    SimdFloat4 W = SimdSub(SimdMul(detA, D), SimdMatrix2Multiply(C, adjAB));
+    SimdFloat4 Y = SimdSub(SimdMul(detB, C), SimdMatrix2MultiplyAdjoint(D, adjAB));
+    SimdFloat4 Z = SimdSub(SimdMul(detC, B), SimdMatrix2MultiplyAdjoint(A, adjDC));
+
+    SimdFloat4 trace = SimdMul(adjAB, SimdShuffle<0, 2, 1, 3>(adjDC, adjDC));
+    trace = SimdAdd(trace, SimdShuffle<1, 0, 3, 2>(trace, trace));
+    trace = SimdAdd(trace, SimdShuffle<2, 3, 0, 1>(trace, trace));
+    SimdFloat4 det = SimdSub(SimdAdd(SimdMul(detA, detD), SimdMul(detB, detC)), trace);
+    if ( SimdGetX(det) == 0.0f ) return Matrix4<float>(true);
+
+    //--------------------------------------------------------------------------
+    // The sign pattern applies the adjugate, the final shuffles transpose the
+    // blocks back into rows.
+    //--------------------------------------------------------------------------
+    SimdFloat4 invDet = SimdDiv(SimdSet(1.0f, -1.0f, -1.0f, 1.0f), det);
+    X = SimdMul(X, invDet);
+    Y = SimdMul(Y, invDet);
+    Z = SimdMul(Z, invDet);
+    W = SimdMul(W, invDet);
+
+    Matrix4<float> result(false);
+    SimdStore(result.data + 0 * ROW_COUNT, SimdShuffle<3, 1, 3, 1>(X, Y));
+    SimdStore(result.data + 1 * ROW_COUNT, SimdShuffle<2, 0, 2, 0>(X, Y));
+    SimdStore(result.data + 2 * ROW_COUNT, SimdShuffle<3, 1, 3, 1>(Z, W));
+    SimdStore(result.data + 3 * ROW_COUNT, SimdShuffle<2, 0, 2, 0>(Z, W));
+    return result;
+}
+
+template <>
+inline Matrix4<float> Matrix4<float>::AffineInverse(const Matrix4<float>& m) {
+    SimdFloat4 r0 = SimdLoad(m.data + 0 * ROW_COUNT);
+    SimdFloat4 r1 = SimdLoad(m.data + 1 * ROW_COUNT);
+    SimdFloat4 r2 = SimdLoad(m.data + 2 * ROW_COUNT);
+    SimdFloat4 t = SimdLoad(m.data + 3 * ROW_COUNT);
+
+    SimdFloat4 c0 = SimdCross3(r1, r2);
+    SimdFloat4 c1 = SimdCross3(r2, r0);
+    SimdFloat4 c2 = SimdCross3(r0, r1);
+
+    float det = SimdGetX(SimdDot4(r0, c0));
+    if ( det == 0.0f ) return Matrix4<float>(true);
+    SimdFloat4 invDet = SimdSplat(1.0f / det);
+
+    //--------------------------------------------------------------------------
+    // Transpose (c0, c1, c2, 0) into the rows of the 3x3 inverse. The w lanes
+    // of the cross products are zero, so the last column stays (0, 0, 0).
+    //--------------------------------------------------------------------------
+    SimdFloat4 zero = SimdZero();
+    SimdFloat4 t0 = SimdShuffle<0, 1, 0, 1>(c0, c1);
+    SimdFloat4 t1 = SimdShuffle<2, 3, 2, 3>(c0, c1);
+    SimdFloat4 t2 = SimdShuffle<0, 1, 0, 1>(c2, zero);
+    SimdFloat4 t3 = SimdShuffle<2, 3, 2, 3>(c2, zero);
+    SimdFloat4 i0 = SimdMul(SimdShuffle<0, 2, 0, 2>(t0, t2), invDet);
+    SimdFloat4 i1 = SimdMul(SimdShuffle<1, 3, 1, 3>(t0, t2), invDet);
+    SimdFloat4 i2 = SimdMul(SimdShuffle<0, 2, 0, 2>(t1, t3), invDet);
+
+    SimdFloat4 translation = SimdMul(SimdSplatLane<0>(t), i0);
+    translation = SimdMulAdd(SimdSplatLane<1>(t), i1, translation);
+    translation = SimdMulAdd(SimdSplatLane<2>(t), i2, translation);
+
+    Matrix4<float> result(false);
+    SimdStore(result.data + 0 * ROW_COUNT, i0);
+    SimdStore(result.data + 1 * ROW_COUNT, i1);
+    SimdStore(result.data + 2 * ROW_COUNT, i2);
+    SimdStore(result.data + 3 * ROW_COUNT, SimdSub(SimdSet(0.0f, 0.0f, 0.0f, 1.0f), translation));
+    return result;
+}
+
+//------------------------------------------------------------------------------
+// With SIMD, telling rigid and uniform scale transformations apart costs about
+// as much as the general inverse itself, so the float versions only test for
+// an affine matrix. Callers that know (or cache) the kind of a matrix pass it
+// to Inverse and NormalMatrix to get the closed forms.
+//------------------------------------------------------------------------------
+template <>
+inline Matrix4<float> Matrix4<float>::Inverse(const Matrix4<float>& m) {
+    bool affine = m.data[A_41] == 0.0f && m.data[A_42] == 0.0f && m.data[A_43] == 0.0f && m.data[A_44] == 1.0f;
+    return affine ? Matrix4<float>::AffineInverse(m) : Matrix4<float>::GeneralInverse(m);
+}
+
+template <>
+inline Matrix3<float> Matrix4<float>::NormalMatrix(const Matrix4<float>& modelViewMatrix) {
+    return Matrix4<float>::NormalMatrix(modelViewMatrix, TRANSFORM_AFFINE);
+}
+
+template <>
+inline Matrix4<float>::TransformKind Matrix4<float>::Classify(const Matrix4<float>& m) {
+    SimdFloat4 r0 = SimdLoad(m.data + 0 * ROW_COUNT);
+    SimdFloat4 r1 = SimdLoad(m.data + 1 * ROW_COUNT);
+    SimdFloat4 r2 = SimdLoad(m.data + 2 * ROW_COUNT);
+    SimdFloat4 r3 = SimdLoad(m.data + 3 * ROW_COUNT);
+    SimdFloat4 zero = SimdZero();
+
+    SimdFloat4 column = SimdShuffle<0, 2, 0, 2>(SimdShuffle<3, 3, 3, 3>(r0, r1), SimdShuffle<3, 3, 3, 3>(r2, r3));
+    if ( SimdAnyGreater(SimdAbs(SimdSub(column, SimdSet(0.0f, 0.0f, 0.0f, 1.0f))), zero) ) return TRANSFORM_GENERAL;
+
+    //--------------------------------------------------------------------------
+    // The w lanes of the rows are zero now, so the Gram matrix entries are
+    // plain four-wide dot products: (g00, g11, g22, g01) and (g02, g12, 0, 0).
+    //--------------------------------------------------------------------------
+    SimdFloat4 diagonal = SimdHorizontalAdd4(SimdMul(r0, r0), SimdMul(r1, r1), SimdMul(r2, r2), SimdMul(r0, r1));
+    SimdFloat4 offDiagonal = SimdHorizontalAdd4(SimdMul(r0, r2), SimdMul(r1, r2), zero, zero);
+
+    SimdFloat4 scale2 = SimdAdd(SimdAdd(SimdSplatLane<0>(diagonal), SimdSplatLane<1>(diagonal)), SimdSplatLane<2>(diagonal));
+    scale2 = SimdMul(scale2, SimdSplat(1.0f / 3.0f));
+    if ( SimdGetX(scale2) == 0.0f ) return TRANSFORM_AFFINE;
+
+    const float ulps = 16.0f * std::numeric_limits<float>::epsilon();
+    SimdFloat4 deviation = SimdAbs(SimdSub(diagonal, SimdMul(scale2, SimdSet(1.0f, 1.0f, 1.0f, 0.0f))));
+    deviation = SimdMax(deviation, SimdAbs(offDiagonal));
+    if ( SimdAnyGreater(deviation, SimdMul(scale2, SimdSplat(ulps))) ) return TRANSFORM_AFFINE;
+    if ( std::abs(SimdGetX(scale2) - 1.0f) > ulps ) return TRANSFORM_UNIFORM_SCALE;
+
+    SimdFloat4 identity = SimdAbs(SimdSub(r0, SimdSet(1.0f, 0.0f, 0.0f, 0.0f)));
+    identity = SimdMax(identity, SimdAbs(SimdSub(r1, SimdSet(0.0f, 1.0f, 0.0f, 0.0f))));
+    identity = SimdMax(identity, SimdAbs(SimdSub(r2, SimdSet(0.0f, 0.0f, 1.0f, 0.0f))));
+    identity = SimdMax(identity, SimdAbs(SimdSub(r3, SimdSet(0.0f, 0.0f, 0.0f, 1.0f))));
+    if ( SimdAnyGreater(identity, zero) ) return TRANSFORM_RIGID;
+    return TRANSFORM_IDENTITY;
+}
+
+template <>
+inline Matrix4<float> Matrix4<float>::OrthogonalInverse(const Matrix4<float>& m) {
+    SimdFloat4 r0 = SimdLoad(m.data + 0 * ROW_COUNT);
+    SimdFloat4 r1 = SimdLoad(m.data + 1 * ROW_COUNT);
+    SimdFloat4 r2 = SimdLoad(m.data + 2 * ROW_COUNT);
+    SimdFloat4 t = SimdLoad(m.data + 3 * ROW_COUNT);
+
+    float scale2 = SimdGetX(SimdAdd(SimdAdd(SimdDot4(r0, r0), SimdDot4(r1, r1)), SimdDot4(r2, r2))) / 3.0f;
+    if ( scale2 == 0.0f ) return Matrix4<float>(true);
+    SimdFloat4 invScale2 = SimdSplat(1.0f / scale2);
+
+    //--------------------------------------------------------------------------
+    // Transpose (r0, r1, r2, 0) into the rows of the 3x3 inverse. The w lanes
+    // of the rows are zero for affine matrices.
+    //--------------------------------------------------------------------------
+    SimdFloat4 zero = SimdZero();
+    SimdFloat4 t0 = SimdShuffle<0, 1, 0, 1>(r0, r1);
+    SimdFloat4 t1 = SimdShuffle<2, 3, 2, 3>(r0, r1);
+    SimdFloat4 t2 = SimdShuffle<0, 1, 0, 1>(r2, zero);
+    SimdFloat4 t3 = SimdShuffle<2, 3, 2, 3>(r2, zero);
+    SimdFloat4 i0 = SimdMul(SimdShuffle<0, 2, 0, 2>(t0, t2), invScale2);
+    SimdFloat4 i1 = SimdMul(SimdShuffle<1, 3, 1, 3>(t0, t2), invScale2);
+    SimdFloat4 i2 = SimdMul(SimdShuffle<0, 2, 0, 2>(t1, t3), invScale2);
+
+    SimdFloat4 translation = SimdMul(SimdSplatLane<0>(t), i0);
+    translation = SimdMulAdd(SimdSplatLane<1>(t), i1, translation);
+    translation = SimdMulAdd(SimdSplatLane<2>(t), i2, translation);
+
+    Matrix4<float> result(false);
+    SimdStore(result.data + 0 * ROW_COUNT, i0);
+    SimdStore(result.data + 1 * ROW_COUNT, i1);
+    SimdStore(result.data + 2 * ROW_COUNT, i2);
+    SimdStore(result.data + 3 * ROW_COUNT, SimdSub(SimdSet(0.0f, 0.0f, 0.0f, 1.0f), translation));
+    return result;
+}
+
 typedef Matrix4<float> Matrix4f;
 typedef Matrix4<double> Matrix4d;
 typedef Matrix4<long> Matrix4l;
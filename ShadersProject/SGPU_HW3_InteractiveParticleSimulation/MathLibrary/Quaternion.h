@@ -27,6 +27,7 @@
 #define QUATERNION_H
 
 #include <cstring>
+#include <limits>
 #include "RotationMatrix.h"
 
 template <typename Real>
@@ -56,22 +57,20 @@ class Quaternion {
     enum Element { X, Y, Z, W, COMPONENT_COUNT};
 
 public:
-    Quaternion(bool identity = true);
-    Quaternion(const Quaternion<Real>& q);
+    MATH_CONSTEXPR Quaternion(bool identity = true);
     Quaternion(const Vector3<Real>& axis, Real angle);
     Quaternion(Real x, Real y, Real z, Real angle);
     Quaternion(Real psi, Real phi, Real theta);
     Quaternion(const RotationMatrix<Real>& rotationMatrix);
-    virtual ~Quaternion();
 
     void normalize();
-    void identity();
-    bool isIdentity() const;
-    void multiply(const Quaternion<Real>& q);
-    void multiplyOnLeft(const Quaternion<Real>& q);
-    void multiplyOnRight(const Quaternion<Real>& q);
+    MATH_CONSTEXPR void identity();
+    MATH_CONSTEXPR bool isIdentity() const;
+    MATH_CONSTEXPR void multiply(const Quaternion<Real>& q);
+    MATH_CONSTEXPR void multiplyOnLeft(const Quaternion<Real>& q);
+    MATH_CONSTEXPR void multiplyOnRight(const Quaternion<Real>& q);
     Quaternion<Real> normalized() const;
-    RotationMatrix<Real> toRotationMatrix() const;
+    MATH_CONSTEXPR RotationMatrix<Real> toRotationMatrix() const;
     Vector4<Real> toVector() const;
     Real length() const;
 
@@ -83,36 +82,35 @@ public:
     void fromEulerRotationY(Real phi);
     void fromEulerRotationZ(Real theta);
 
-    void set(Real x, Real y, Real z, Real w);
-    void set(const Vector4<Real>& v);
-    void setX(Real x);
-    void setY(Real y);
-    void setZ(Real z);
-    void setW(Real w);
-
-	const Real& w() const;
-	const Real& x() const;
-	const Real& y() const;
-	const Real& z() const;
-    const Real& getW() const;
-    const Real& getX() const;
-    const Real& getY() const;
-    const Real& getZ() const;
-
-    Real& w();
-	Real& x();
-	Real& y();
-	Real& z();
-    Real& getW();
-    Real& getX();
-    Real& getY();
-    Real& getZ();
-
-    Quaternion<Real>& operator = (const Quaternion<Real>& q);
-	Quaternion<Real>& operator *= (const Quaternion<Real>& q);
-    Quaternion<Real>& operator *= (const Real scalar);
-    Quaternion<Real> operator * (const Quaternion<Real>& q) const;
-    Quaternion<Real> operator * (Real scalar) const;
+    MATH_CONSTEXPR void set(Real x, Real y, Real z, Real w);
+    MATH_CONSTEXPR void set(const Vector4<Real>& v);
+    MATH_CONSTEXPR void setX(Real x);
+    MATH_CONSTEXPR void setY(Real y);
+    MATH_CONSTEXPR void setZ(Real z);
+    MATH_CONSTEXPR void setW(Real w);
+
+	MATH_CONSTEXPR const Real& w() const;
+	MATH_CONSTEXPR const Real& x() const;
+	MATH_CONSTEXPR const Real& y() const;
+	MATH_CONSTEXPR const Real& z() const;
+    MATH_CONSTEXPR const Real& getW() const;
+    MATH_CONSTEXPR const Real& getX() const;
+    MATH_CONSTEXPR const Real& getY() const;
+    MATH_CONSTEXPR const Real& getZ() const;
+
+    MATH_CONSTEXPR Real& w();
+	MATH_CONSTEXPR Real& x();
+	MATH_CONSTEXPR Real& y();
+	MATH_CONSTEXPR Real& z();
+    MATH_CONSTEXPR Real& getW();
+    MATH_CONSTEXPR Real& getX();
+    MATH_CONSTEXPR Real& getY();
+    MATH_CONSTEXPR Real& getZ();
+
+	MATH_CONSTEXPR Quaternion<Real>& operator *= (const Quaternion<Real>& q);
+    MATH_CONSTEXPR Quaternion<Real>& operator *= (const Real scalar);
+    MATH_CONSTEXPR Quaternion<Real> operator * (const Quaternion<Real>& q) const;
+    MATH_CONSTEXPR Quaternion<Real> operator * (Real scalar) const;
 
     friend std::ostream& operator << <> (std::ostream& out, const Quaternion<Real>& v);
 
@@ -120,43 +118,45 @@ public:
     static void FromAxisAngle(const Vector3<Real>& axis, Real angle, Quaternion<Real>& q);
     static void FromEulerAngles(Real psi, Real phi, Real theta, Quaternion<Real>& q);
     static void FromRotationMatrix(const RotationMatrix<Real>& rotationMatrix, Quaternion<Real>& q);
-    static void Identity(Quaternion<Real>& q);
+    static MATH_CONSTEXPR void Identity(Quaternion<Real>& q);
     static void Normalize(Quaternion<Real>& q);
-    static void Conjugate(Quaternion<Real>& q);
+    static MATH_CONSTEXPR void Conjugate(Quaternion<Real>& q);
 
     static Vector4<Real> ToVector(const Quaternion<Real>& q);
     static Quaternion<Real> EulerRotationX(Real psi);
     static Quaternion<Real> EulerRotationY(Real phi);
     static Quaternion<Real> EulerRotationZ(Real theta);
-    static Quaternion<Real> Multiply(const Quaternion<Real>& q, const Quaternion<Real>& p);
-    static Quaternion<Real> Conjugate(const Quaternion<Real>& q);
+    static MATH_CONSTEXPR Quaternion<Real> Multiply(const Quaternion<Real>& q, const Quaternion<Real>& p);
+    static MATH_CONSTEXPR Quaternion<Real> Conjugate(const Quaternion<Real>& q);
     static Quaternion<Real> Normalize(const Quaternion<Real>& q);
-    static Quaternion<Real> Identity();
+    static MATH_CONSTEXPR Quaternion<Real> Identity();
     static Quaternion<Real> FromRotationMatrix(const RotationMatrix<Real>& rotationMatrix);
     static Quaternion<Real> FromEulerAngles(Real psi, Real phi, Real theta);
     static Quaternion<Real> FromAxisAngle(Real x, Real y, Real z, Real angle);
     static Quaternion<Real> FromAxisAngle(const Vector3<Real>& axis, Real angle);
 
-    static RotationMatrix<Real> ToRotationMatrix(const Quaternion<Real>& q);
+    static MATH_CONSTEXPR RotationMatrix<Real> ToRotationMatrix(const Quaternion<Real>& q);
     static Real Length(const Quaternion<Real>& q);
-    static Real InnerProduct(const Quaternion<Real>& q, const Quaternion<Real>& p);
+    static MATH_CONSTEXPR Real InnerProduct(const Quaternion<Real>& q, const Quaternion<Real>& p);
+
+    /*
+     * Interpolation from q (t = 0) to p (t = 1) along the shorter arc. Slerp
+     * moves at constant angular velocity, Nlerp normalizes the linear
+     * interpolation, which is cheaper and follows the same path but not at
+     * constant speed. See QuaternionBatch.h for the array versions.
+     */
+    static Quaternion<Real> Slerp(const Quaternion<Real>& q, const Quaternion<Real>& p, Real t);
+    static Quaternion<Real> Nlerp(const Quaternion<Real>& q, const Quaternion<Real>& p, Real t);
 
 protected:
     Real data[COMPONENT_COUNT];
 };
 
 template <typename Real>
-Quaternion<Real>::Quaternion(bool identity) {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
+MATH_CONSTEXPR Quaternion<Real>::Quaternion(bool identity) : data() {
     if ( identity ) this->data[W] = Real(1);
 }
 
-template <typename Real>
-Quaternion<Real>::Quaternion(const Quaternion<Real>& q) {
-    std::memset(this->data, 0, COMPONENT_COUNT * sizeof(Real));
-    this->data[W] = Real(1);
-}
-
 template <typename Real>
 Quaternion<Real>::Quaternion(const Vector3<Real>& axis, Real angle) {
     Quaternion<Real>::FromAxisAngle(axis, angle, *this);
@@ -177,21 +177,18 @@ Quaternion<Real>::Quaternion(const RotationMatrix<Real>& rotationMatrix) {
     Quaternion<Real>::FromRotationMatrix(rotationMatrix);
 }
 
-template <typename Real>
-Quaternion<Real>::~Quaternion() {}
-
 template <typename Real>
 void Quaternion<Real>::normalize() {
     Quaternion<Real>::Normalize(*this);
 }
 
 template <typename Real>
-void Quaternion<Real>::identity() {
+MATH_CONSTEXPR void Quaternion<Real>::identity() {
     Quaternion<Real>::Identity(*this);
 }
 
 template <typename Real>
-bool Quaternion<Real>::isIdentity() const {
+MATH_CONSTEXPR bool Quaternion<Real>::isIdentity() const {
     if ( this->data[X] == Real(0) &&
          this->data[Y] == Real(0) &&
          this->data[Z] == Real(0) &&
@@ -201,19 +198,19 @@ bool Quaternion<Real>::isIdentity() const {
 }
 
 template <typename Real>
-void Quaternion<Real>::multiply(const Quaternion<Real>& q) {
+MATH_CONSTEXPR void Quaternion<Real>::multiply(const Quaternion<Real>& q) {
     (*this) *= q;
 }
 
 template <typename Real>
-void Quaternion<Real>::multiplyOnLeft(const Quaternion<Real>& q) {
+MATH_CONSTEXPR void Quaternion<Real>::multiplyOnLeft(const Quaternion<Real>& q) {
     Quaternion<Real> result = q;
     result *= (*this);
     (*this) = result;
 }
 
 template <typename Real>
-void Quaternion<Real>::multiplyOnRight(const Quaternion<Real>& q) {
+MATH_CONSTEXPR void Quaternion<Real>::multiplyOnRight(const Quaternion<Real>& q) {
     (*this) *= q;
 }
 
@@ -223,7 +220,7 @@ Quaternion<Real> Quaternion<Real>::normalized() const {
 }
 
 template <typename Real>
-RotationMatrix<Real> Quaternion<Real>::toRotationMatrix() const {
+MATH_CONSTEXPR RotationMatrix<Real> Quaternion<Real>::toRotationMatrix() const {
     return Quaternion<Real>::ToRotationMatrix(*this);
 }
 
@@ -276,7 +273,7 @@ void Quaternion<Real>::fromEulerRotationZ(Real theta) {
 }
 
 template <typename Real>
-void Quaternion<Real>::set(Real x, Real y, Real z, Real w) {
+MATH_CONSTEXPR void Quaternion<Real>::set(Real x, Real y, Real z, Real w) {
     this->data[W] = w;
     this->data[X] = x;
     this->data[Y] = y;
@@ -284,7 +281,7 @@ void Quaternion<Real>::set(Real x, Real y, Real z, Real w) {
 }
 
 template <typename Real>
-void Quaternion<Real>::set(const Vector4<Real>& v) {
+MATH_CONSTEXPR void Quaternion<Real>::set(const Vector4<Real>& v) {
     this->data[W] = v.w();
     this->data[X] = v.x();
     this->data[Y] = v.y();
@@ -292,126 +289,113 @@ void Quaternion<Real>::set(const Vector4<Real>& v) {
 }
 
 template <typename Real>
-void Quaternion<Real>::setX(Real x) {
+MATH_CONSTEXPR void Quaternion<Real>::setX(Real x) {
     this->data[X] = x;
 }
 
 template <typename Real>
-void Quaternion<Real>::setY(Real y) {
+MATH_CONSTEXPR void Quaternion<Real>::setY(Real y) {
     this->data[Y] = y;
 }
 
 template <typename Real>
-void Quaternion<Real>::setZ(Real z) {
+MATH_CONSTEXPR void Quaternion<Real>::setZ(Real z) {
     this->data[Z] = z;
 }
 
 template <typename Real>
-void Quaternion<Real>::setW(Real w) {
+MATH_CONSTEXPR void Quaternion<Real>::setW(Real w) {
     this->data[W] = w;
 }
 
 template <typename Real>
-const Real& Quaternion<Real>::w() const {
+MATH_CONSTEXPR const Real& Quaternion<Real>::w() const {
     return this->data[W];
 }
 
 template <typename Real>
-const Real& Quaternion<Real>::x() const {
+MATH_CONSTEXPR const Real& Quaternion<Real>::x() const {
     return this->data[X];
 }
 
 template <typename Real>
-const Real& Quaternion<Real>::y() const {
+MATH_CONSTEXPR const Real& Quaternion<Real>::y() const {
     return this->data[Y];
 }
 
 template <typename Real>
-const Real& Quaternion<Real>::z() const {
+MATH_CONSTEXPR const Real& Quaternion<Real>::z() const {
     return this->data[Z];
 }
 
 template <typename Real>
-const Real& Quaternion<Real>::getW() const {
+MATH_CONSTEXPR const Real& Quaternion<Real>::getW() const {
     return this->data[W];
 }
 
 template <typename Real>
-const Real& Quaternion<Real>::getX() const {
+MATH_CONSTEXPR const Real& Quaternion<Real>::getX() const {
     return this->data[X];
 }
 
 template <typename Real>
-const Real& Quaternion<Real>::getY() const {
+MATH_CONSTEXPR const Real& Quaternion<Real>::getY() const {
     return this->data[Y];
 }
 
 template <typename Real>
-const Real& Quaternion<Real>::getZ() const {
+MATH_CONSTEXPR const Real& Quaternion<Real>::getZ() const {
     return this->data[Z];
 }
 
 template <typename Real>
-Real& Quaternion<Real>::w() {
+MATH_CONSTEXPR Real& Quaternion<Real>::w() {
     return this->data[W];
 }
 
 template <typename Real>
-Real& Quaternion<Real>::x() {
+MATH_CONSTEXPR Real& Quaternion<Real>::x() {
     return this->data[X];
 }
 
 template <typename Real>
-Real& Quaternion<Real>::y() {
+MATH_CONSTEXPR Real& Quaternion<Real>::y() {
     return this->data[Y];
 }
 
 template <typename Real>
-Real& Quaternion<Real>::z() {
+MATH_CONSTEXPR Real& Quaternion<Real>::z() {
     return this->data[Z];
 }
 
 template <typename Real>
-Real& Quaternion<Real>::getW() {
+MATH_CONSTEXPR Real& Quaternion<Real>::getW() {
     return this->data[W];
 }
 
 template <typename Real>
-Real& Quaternion<Real>::getX() {
+MATH_CONSTEXPR Real& Quaternion<Real>::getX() {
     return this->data[X];
 }
 
 template <typename Real>
-Real& Quaternion<Real>::getY() {
+MATH_CONSTEXPR Real& Quaternion<Real>::getY() {
     return this->data[Y];
 }
 
 template <typename Real>
-Real& Quaternion<Real>::getZ() {
+MATH_CONSTEXPR Real& Quaternion<Real>::getZ() {
     return this->data[Z];
 }
 
 template <typename Real>
-Quaternion<Real>& Quaternion<Real>::operator = (const Quaternion<Real>& q) {
-    if ( this == &q ) return (*this);
-	this->data[X] = q.data[X];
-	this->data[Y] = q.data[Y];
-	this->data[Z] = q.data[Z];
-	this->data[W] = q.data[W];
-	return (*this);
-}
-
-template <typename Real>
-Quaternion<Real>& Quaternion<Real>::operator *= (const Quaternion<Real>& q) {
-    this->data[W] = this->data[W] * q.data[W] - this->data[X] * q.data[X] - this->data[Y] * q.data[Y] - this->data[Z] * q.data[Z];
-    this->data[X] = this->data[W] * q.data[X] + this->data[X] * q.data[W] + this->data[Y] * q.data[Z] - this->data[Z] * q.data[Y];
-    this->data[Y] = this->data[W] * q.data[Y] - this->data[X] * q.data[Z] + this->data[Y] * q.data[W] + this->data[Z] * q.data[X];
-    this->data[Z] = this->data[W] * q.data[Z] + this->data[X] * q.data[Y] - this->data[Y] * q.data[X] + this->data[Z] * q.data[W];
+MATH_CONSTEXPR Quaternion<Real>& Quaternion<Real>::operator *= (const Quaternion<Real>& q) {
+    (*this) = Quaternion<Real>::Multiply(*this, q);
     return (*this);
 }
 
 template <typename Real>
-Quaternion<Real>& Quaternion<Real>::operator *= (const Real scalar) {
+MATH_CONSTEXPR Quaternion<Real>& Quaternion<Real>::operator *= (const Real scalar) {
     this->data[X] *= scalar;
     this->data[Y] *= scalar;
     this->data[Z] *= scalar;
@@ -420,14 +404,14 @@ Quaternion<Real>& Quaternion<Real>::operator *= (const Real scalar) {
 }
 
 template <typename Real>
-Quaternion<Real> Quaternion<Real>::operator * (const Quaternion<Real>& q) const {
+MATH_CONSTEXPR Quaternion<Real> Quaternion<Real>::operator * (const Quaternion<Real>& q) const {
     Quaternion<Real> result = (*this);
     result *= q;
-    return result
+    return result;
 }
 
 template <typename Real>
-Quaternion<Real> Quaternion<Real>::operator * (Real scalar) const {
+MATH_CONSTEXPR Quaternion<Real> Quaternion<Real>::operator * (Real scalar) const {
     Quaternion<Real> result = (*this);
     result *= scalar;
     return result;
@@ -516,7 +500,7 @@ void Quaternion<Real>::FromRotationMatrix(const RotationMatrix<Real>& m, Quatern
 }
 
 template <typename Real>
-void Quaternion<Real>::Identity(Quaternion<Real>& q) {
+MATH_CONSTEXPR void Quaternion<Real>::Identity(Quaternion<Real>& q) {
     q.data[X] = Real(0);
     q.data[Y] = Real(0);
     q.data[Z] = Real(0);
@@ -536,7 +520,7 @@ void Quaternion<Real>::Normalize(Quaternion<Real>& q) {
 }
 
 template <typename Real>
-void Quaternion<Real>::Conjugate(Quaternion<Real>& q) {
+MATH_CONSTEXPR void Quaternion<Real>::Conjugate(Quaternion<Real>& q) {
     q.data[X] = -q.data[X];
     q.data[Y] = -q.data[Y];
     q.data[Z] = -q.data[Z];
@@ -570,14 +554,20 @@ Quaternion<Real> Quaternion<Real>::EulerRotationZ(Real theta) {
 
 /* http://www.cprogramming.com/tutorial/3d/quaternions.html */
 template <typename Real>
-Quaternion<Real> Quaternion<Real>::Multiply(const Quaternion<Real>& q, const Quaternion<Real>& p) {
-    
+MATH_CONSTEXPR Quaternion<Real> Quaternion<Real>::Multiply(const Quaternion<Real>& q, const Quaternion<Real>& p) {
+    Quaternion<Real> result(false);
+    result.data[W] = q.data[W] * p.data[W] - q.data[X] * p.data[X] - q.data[Y] * p.data[Y] - q.data[Z] * p.data[Z];
+    result.data[X] = q.data[W] * p.data[X] + q.data[X] * p.data[W] + q.data[Y] * p.data[Z] - q.data[Z] * p.data[Y];
+    result.data[Y] = q.data[W] * p.data[Y] - q.data[X] * p.data[Z] + q.data[Y] * p.data[W] + q.data[Z] * p.data[X];
+    result.data[Z] = q.data[W] * p.data[Z] + q.data[X] * p.data[Y] - q.data[Y] * p.data[X] + q.data[Z] * p.data[W];
+    return result;
 }
 
 template <typename Real>
-Quaternion<Real> Quaternion<Real>::Conjugate(const Quaternion<Real>& q) {
+MATH_CONSTEXPR Quaternion<Real> Quaternion<Real>::Conjugate(const Quaternion<Real>& q) {
     Quaternion<Real> result = q;
-    return result.conjugate();
+    Quaternion<Real>::Conjugate(result);
+    return result;
 }
 
 template <typename Real>
@@ -587,7 +577,7 @@ Quaternion<Real> Quaternion<Real>::Normalize(const Quaternion<Real>& q) {
 }
 
 template <typename Real>
-Quaternion<Real> Quaternion<Real>::Identity() {
+MATH_CONSTEXPR Quaternion<Real> Quaternion<Real>::Identity() {
     return Quaternion<Real>(true);
 }
 
@@ -660,7 +650,7 @@ Quaternion<Real> Quaternion<Real>::FromAxisAngle(const Vector3<Real>& axis, Real
 /* http://www.cprogramming.com/tutorial/3d/quaternions.html */
 /* Mathematics for 3D Grame Programming and Computer Graphics (Eric Lengyel) p. 92 */
 template <typename Real>
-RotationMatrix<Real> Quaternion<Real>::ToRotationMatrix(const Quaternion<Real>& q) {
+MATH_CONSTEXPR RotationMatrix<Real> Quaternion<Real>::ToRotationMatrix(const Quaternion<Real>& q) {
     RotationMatrix<Real> rot;
     Real x = q.data[X];
     Real y = q.data[Y];
@@ -699,10 +689,52 @@ Real Quaternion<Real>::Length(const Quaternion<Real>& q) {
 }
 
 template <typename Real>
-Real Quaternion<Real>::InnerProduct(const Quaternion<Real>& q, const Quaternion<Real>& p) {
+MATH_CONSTEXPR Real Quaternion<Real>::InnerProduct(const Quaternion<Real>& q, const Quaternion<Real>& p) {
     return q.data[X] * p.data[X] + q.data[Y] * p.data[Y] + q.data[Z] * p.data[Z] + q.data[W] * p.data[W];
 }
 
+template <typename Real>
+Quaternion<Real> Quaternion<Real>::Slerp(const Quaternion<Real>& q, const Quaternion<Real>& p, Real t) {
+    Real cosTheta = Quaternion<Real>::InnerProduct(q, p);
+    Real sign = (cosTheta < Real(0)) ? Real(-1) : Real(1);
+    cosTheta *= sign;
+
+    //--------------------------------------------------------------------------
+    // sin(theta) vanishes for (nearly) identical rotations, where the linear
+    // interpolation weights are just as accurate.
+    //--------------------------------------------------------------------------
+    Real a = Real(1) - t;
+    Real b = t;
+    if ( cosTheta < Real(1) - std::numeric_limits<Real>::epsilon() ) {
+        Real theta = std::acos(cosTheta);
+        Real invSinTheta = Real(1) / std::sin(theta);
+        a = std::sin((Real(1) - t) * theta) * invSinTheta;
+        b = std::sin(t * theta) * invSinTheta;
+    }
+    b *= sign;
+
+    Quaternion<Real> result(false);
+    for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
+        result.data[i] = a * q.data[i] + b * p.data[i];
+    return result;
+}
+
+template <typename Real>
+Quaternion<Real> Quaternion<Real>::Nlerp(const Quaternion<Real>& q, const Quaternion<Real>& p, Real t) {
+    Real b = (Quaternion<Real>::InnerProduct(q, p) < Real(0)) ? -t : t;
+
+    Quaternion<Real> result(false);
+    for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
+        result.data[i] = (Real(1) - t) * q.data[i] + b * p.data[i];
+
+    Real length = std::sqrt(Quaternion<Real>::InnerProduct(result, result));
+    if ( length == Real(0) ) return Quaternion<Real>();
+
+    Real invLength = Real(1) / length;
+    for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ ) result.data[i] *= invLength;
+    return result;
+}
+
 typedef Quaternion<float> Quaternionf;
 typedef Quaternion<double> Quaterniond;
 typedef Quaternion<long double> Quaternionld;
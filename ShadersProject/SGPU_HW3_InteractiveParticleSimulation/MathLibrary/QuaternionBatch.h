@@ -0,0 +1,355 @@
+#ifndef QUATERNION_BATCH_H
+#define QUATERNION_BATCH_H
+
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include "Quaternion.h"
+#include "SimdMath.h"
+
+/*
+ * Batch quaternion kernels for animation playback: interpolate, convert and
+ * decode the rotations of many objects in a single call instead of going
+ * through Quaternion one value at a time.
+ *
+ * Quaternions are packed (x, y, z, w) quadruples, the memory order of
+ * Quaternion. Interpolation factors are either one float per quaternion or
+ * a single value for the whole batch. Four quaternions are processed per SIMD
+ * operation; they are transposed into x, y, z and w registers on load and back
+ * on store. The output may be the same array as an input.
+ *
+ * The kernels are element-wise, so they can be split over threads by calling
+ * them on sub-ranges (see ParallelFor in the GraphicsLibrary).
+ */
+
+/* Loads four packed quaternions and transposes them into x, y, z and w lanes. */
+inline void LoadQuaternions4(const float* q, SimdFloat4& x, SimdFloat4& y, SimdFloat4& z, SimdFloat4& w) {
+    x = SimdLoad(q + 0);
+    y = SimdLoad(q + 4);
+    z = SimdLoad(q + 8);
+    w = SimdLoad(q + 12);
+    SimdTranspose4(x, y, z, w);
+}
+
+/* Transposes x, y, z and w (in place) back into four packed quaternions. */
+inline void StoreQuaternions4(float* q, SimdFloat4& x, SimdFloat4& y, SimdFloat4& z, SimdFloat4& w) {
+    SimdTranspose4(x, y, z, w);
+    SimdStore(q + 0, x);
+    SimdStore(q + 4, y);
+    SimdStore(q + 8, z);
+    SimdStore(q + 12, w);
+}
+
+/* Interpolates four quaternions of a towards b by the factors in t. */
+typedef void (*QuaternionInterpolation4)(const float* a, const float* b, SimdFloat4 t, float* out);
+
+/*
+ * Runs an interpolation kernel over count quaternions. The factors come from t
+ * or, if t is nullptr, all quaternions use tValue. The last (count % 4)
+ * quaternions go through padded temporaries so the arrays are never accessed
+ * past their end.
+ */
+template <QuaternionInterpolation4 Interpolate4>
+inline void InterpolateQuaternions(const float* a, const float* b, const float* t, float tValue, float* out, std::size_t count) {
+    std::size_t i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+        Interpolate4(a + 4 * i, b + 4 * i, (t != nullptr) ? SimdLoad(t + i) : SimdSplat(tValue), out + 4 * i);
+
+    if ( i < count ) {
+        std::size_t remaining = count - i;
+        float ta[16] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+        float tb[16], tt[4], tout[16];
+        std::memcpy(tb, ta, sizeof(ta));
+        std::memcpy(ta, a + 4 * i, remaining * 4 * sizeof(float));
+        std::memcpy(tb, b + 4 * i, remaining * 4 * sizeof(float));
+        for ( std::size_t j = 0; j < 4; j++ ) tt[j] = (t != nullptr && j < remaining) ? t[i + j] : tValue;
+
+        Interpolate4(ta, tb, SimdLoad(tt), tout);
+        std::memcpy(out + 4 * i, tout, remaining * 4 * sizeof(float));
+    }
+}
+
+//------------------------------------------------------------------------------
+// Nlerp: normalized linear interpolation along the shorter arc. Cheapest and
+// accurate enough for the small steps between animation keys, but not at
+// constant angular velocity.
+//------------------------------------------------------------------------------
+inline void NlerpQuaternions4(const float* a, const float* b, SimdFloat4 t, float* out) {
+    SimdFloat4 ax, ay, az, aw, bx, by, bz, bw;
+    LoadQuaternions4(a, ax, ay, az, aw);
+    LoadQuaternions4(b, bx, by, bz, bw);
+
+    SimdFloat4 dot = SimdMulAdd(aw, bw, SimdMulAdd(az, bz, SimdMulAdd(ay, by, SimdMul(ax, bx))));
+    SimdFloat4 ta = SimdSub(SimdSplat(1.0f), t);
+    SimdFloat4 tb = SimdSelectPositive(dot, t, SimdSub(SimdZero(), t));
+
+    SimdFloat4 x = SimdMulAdd(bx, tb, SimdMul(ax, ta));
+    SimdFloat4 y = SimdMulAdd(by, tb, SimdMul(ay, ta));
+    SimdFloat4 z = SimdMulAdd(bz, tb, SimdMul(az, ta));
+    SimdFloat4 w = SimdMulAdd(bw, tb, SimdMul(aw, ta));
+
+    SimdFloat4 invLength = SimdRsqrt(SimdMulAdd(w, w, SimdMulAdd(z, z, SimdMulAdd(y, y, SimdMul(x, x)))));
+    x = SimdMul(x, invLength);
+    y = SimdMul(y, invLength);
+    z = SimdMul(z, invLength);
+    w = SimdMul(w, invLength);
+    StoreQuaternions4(out, x, y, z, w);
+}
+
+inline void NlerpQuaternions(const float* a, const float* b, const float* t, float* out, std::size_t count) {
+    InterpolateQuaternions<NlerpQuaternions4>(a, b, t, 0.0f, out, count);
+}
+
+inline void NlerpQuaternions(const float* a, const float* b, float t, float* out, std::size_t count) {
+    InterpolateQuaternions<NlerpQuaternions4>(a, b, nullptr, t, out, count);
+}
+
+//------------------------------------------------------------------------------
+// Slerp: constant angular velocity along the shorter arc. The weights
+// sin((1 - t) theta) / sin(theta) and sin(t theta) / sin(theta) are evaluated
+// without trigonometric functions by the series of Eberly ("A Fast and
+// Accurate Algorithm for Computing SLERP", 2011):
+//
+//   sin(t theta) / sin(theta) = t * (1 + b1 (1 + b2 (1 + ... (1 + bn))))
+//   bi = (t^2 / (i (2i + 1)) - i / (2i + 1)) (cos(theta) - 1)
+//
+// The series is cut after n = 14 terms and the last term is scaled by a
+// correction factor, fitted so the weights stay within 1.5e-7 of the exact
+// ones for every angle up to 90 degrees (the shorter arc).
+//------------------------------------------------------------------------------
+const static int SLERP_TERM_COUNT = 14;
+const static float SLERP_LAST_TERM_CORRECTION = 1.9066034f;
+
+inline SimdFloat4 SlerpWeight4(SimdFloat4 t, SimdFloat4 cosThetaMinusOne) {
+    const static float u[SLERP_TERM_COUNT] = {
+        1.0f / 3.0f, 1.0f / 10.0f, 1.0f / 21.0f, 1.0f / 36.0f, 1.0f / 55.0f,
+        1.0f / 78.0f, 1.0f / 105.0f, 1.0f / 136.0f, 1.0f / 171.0f, 1.0f / 210.0f,
+        1.0f / 253.0f, 1.0f / 300.0f, 1.0f / 351.0f,
+        SLERP_LAST_TERM_CORRECTION / 406.0f };
+    const static float v[SLERP_TERM_COUNT] = {
+        1.0f / 3.0f, 2.0f / 5.0f, 3.0f / 7.0f, 4.0f / 9.0f, 5.0f / 11.0f,
+        6.0f / 13.0f, 7.0f / 15.0f, 8.0f / 17.0f, 9.0f / 19.0f, 10.0f / 21.0f,
+        11.0f / 23.0f, 12.0f / 25.0f, 13.0f / 27.0f,
+        SLERP_LAST_TERM_CORRECTION * 14.0f / 29.0f };
+
+    SimdFloat4 one = SimdSplat(1.0f);
+    SimdFloat4 t2 = SimdMul(t, t);
+    SimdFloat4 p = one;
+    for ( int i = SLERP_TERM_COUNT - 1; i >= 0; i-- ) {
+        SimdFloat4 b = SimdMul(SimdSub(SimdMul(SimdSplat(u[i]), t2), SimdSplat(v[i])), cosThetaMinusOne);
+        p = SimdMulAdd(b, p, one);
+    }
+
+    return SimdMul(t, p);
+}
+
+inline void SlerpQuaternions4(const float* a, const float* b, SimdFloat4 t, float* out) {
+    SimdFloat4 ax, ay, az, aw, bx, by, bz, bw;
+    LoadQuaternions4(a, ax, ay, az, aw);
+    LoadQuaternions4(b, bx, by, bz, bw);
+
+    SimdFloat4 dot = SimdMulAdd(aw, bw, SimdMulAdd(az, bz, SimdMulAdd(ay, by, SimdMul(ax, bx))));
+    SimdFloat4 cosThetaMinusOne = SimdSub(SimdAbs(dot), SimdSplat(1.0f));
+
+    SimdFloat4 ta = SlerpWeight4(SimdSub(SimdSplat(1.0f), t), cosThetaMinusOne);
+    SimdFloat4 tb = SlerpWeight4(t, cosThetaMinusOne);
+    tb = SimdSelectPositive(dot, tb, SimdSub(SimdZero(), tb));
+
+    SimdFloat4 x = SimdMulAdd(bx, tb, SimdMul(ax, ta));
+    SimdFloat4 y = SimdMulAdd(by, tb, SimdMul(ay, ta));
+    SimdFloat4 z = SimdMulAdd(bz, tb, SimdMul(az, ta));
+    SimdFloat4 w = SimdMulAdd(bw, tb, SimdMul(aw, ta));
+    StoreQuaternions4(out, x, y, z, w);
+}
+
+inline void SlerpQuaternions(const float* a, const float* b, const float* t, float* out, std::size_t count) {
+    InterpolateQuaternions<SlerpQuaternions4>(a, b, t, 0.0f, out, count);
+}
+
+inline void SlerpQuaternions(const float* a, const float* b, float t, float* out, std::size_t count) {
+    InterpolateQuaternions<SlerpQuaternions4>(a, b, nullptr, t, out, count);
+}
+
+//------------------------------------------------------------------------------
+// Matrices. Every quaternion becomes a 16 float Matrix4f holding the same
+// rotation as Quaternion::toRotationMatrix, the last row being the matching
+// translation (packed xyz, may be nullptr for none).
+//------------------------------------------------------------------------------
+/*
+ * Rotation matrix rows of four quaternions held in x, y, z and w lanes: entry
+ * rows[row][column] holds that entry for all four quaternions, the fourth
+ * column is zero.
+ */
+inline void QuaternionsToRotationRows4(SimdFloat4 x, SimdFloat4 y, SimdFloat4 z, SimdFloat4 w, SimdFloat4 rows[3][4]) {
+    SimdFloat4 one = SimdSplat(1.0f);
+    SimdFloat4 two = SimdSplat(2.0f);
+    SimdFloat4 x2 = SimdMul(x, two), y2 = SimdMul(y, two), z2 = SimdMul(z, two);
+    SimdFloat4 xx = SimdMul(x, x2), yy = SimdMul(y, y2), zz = SimdMul(z, z2);
+    SimdFloat4 xy = SimdMul(x, y2), xz = SimdMul(x, z2), yz = SimdMul(y, z2);
+    SimdFloat4 wx = SimdMul(w, x2), wy = SimdMul(w, y2), wz = SimdMul(w, z2);
+
+    rows[0][0] = SimdSub(one, SimdAdd(yy, zz)); rows[0][1] = SimdSub(xy, wz); rows[0][2] = SimdAdd(xz, wy); rows[0][3] = SimdZero();
+    rows[1][0] = SimdAdd(xy, wz); rows[1][1] = SimdSub(one, SimdAdd(xx, zz)); rows[1][2] = SimdSub(yz, wx); rows[1][3] = SimdZero();
+    rows[2][0] = SimdSub(xz, wy); rows[2][1] = SimdAdd(yz, wx); rows[2][2] = SimdSub(one, SimdAdd(xx, yy)); rows[2][3] = SimdZero();
+}
+
+inline void QuaternionsToMatrices4(const float* q, const float* translations, float* out) {
+    SimdFloat4 x, y, z, w;
+    LoadQuaternions4(q, x, y, z, w);
+
+    //--------------------------------------------------------------------------
+    // Each set of three entries holds one row for all four quaternions; the
+    // transpose turns them into that row of each of the four matrices.
+    //--------------------------------------------------------------------------
+    SimdFloat4 rows[3][4];
+    QuaternionsToRotationRows4(x, y, z, w, rows);
+
+    for ( int row = 0; row < 3; row++ ) {
+        SimdTranspose4(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+        for ( int k = 0; k < 4; k++ ) SimdStore(out + 16 * k + 4 * row, rows[row][k]);
+    }
+
+    for ( int k = 0; k < 4; k++ ) {
+        float* last = out + 16 * k + 12;
+        last[0] = (translations != nullptr) ? translations[3 * k + 0] : 0.0f;
+        last[1] = (translations != nullptr) ? translations[3 * k + 1] : 0.0f;
+        last[2] = (translations != nullptr) ? translations[3 * k + 2] : 0.0f;
+        last[3] = 1.0f;
+    }
+}
+
+inline void QuaternionsToMatrices(const float* q, const float* translations, float* matrices, std::size_t count) {
+    std::size_t i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+        QuaternionsToMatrices4(q + 4 * i, (translations != nullptr) ? translations + 3 * i : nullptr, matrices + 16 * i);
+
+    if ( i < count ) {
+        std::size_t remaining = count - i;
+        float tq[16] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+        float tt[12] = { 0.0f };
+        float tm[64];
+        std::memcpy(tq, q + 4 * i, remaining * 4 * sizeof(float));
+        if ( translations != nullptr ) std::memcpy(tt, translations + 3 * i, remaining * 3 * sizeof(float));
+
+        QuaternionsToMatrices4(tq, (translations != nullptr) ? tt : nullptr, tm);
+        std::memcpy(matrices + 16 * i, tm, remaining * 16 * sizeof(float));
+    }
+}
+
+inline void QuaternionsToMatrices(const float* q, float* matrices, std::size_t count) {
+    QuaternionsToMatrices(q, nullptr, matrices, count);
+}
+
+//------------------------------------------------------------------------------
+// Compressed quaternions ("smallest three"), 48 bits instead of 128.
+//
+// The largest component of a unit quaternion is at least 1/2 and can be
+// recomputed from the other three as sqrt(1 - a^2 - b^2 - c^2). Since q and -q
+// are the same rotation, the quaternion is negated to make that component
+// positive. The other three lie in [-1/sqrt(2), 1/sqrt(2)] and are quantized
+// to 15 bits each, in increasing component order, after the 2 bit index of
+// the dropped component:
+//
+//   bit 47: unused, 46-45: index, 44-30: a, 29-15: b, 14-0: c
+//
+// The quantization step is 4.3e-5, the rotation angle error is about
+// 1e-4 radians (0.006 degrees).
+//------------------------------------------------------------------------------
+struct CompressedQuaternion {
+    unsigned short data[3];
+};
+
+const static float COMPRESSED_QUATERNION_RANGE = 0.707106781f;
+const static unsigned int COMPRESSED_QUATERNION_MAX = (1u << 15) - 1u;
+
+/* Positions of the three stored components, given the dropped one. */
+const static unsigned char COMPRESSED_QUATERNION_STORED[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+
+inline CompressedQuaternion EncodeQuaternion(const float* q) {
+    float length2 = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+    float invLength = (length2 > 0.0f) ? 1.0f / std::sqrt(length2) : 0.0f;
+
+    unsigned int largest = 0;
+    for ( unsigned int i = 1; i < 4; i++ )
+        if ( std::abs(q[i]) > std::abs(q[largest]) ) largest = i;
+    if ( q[largest] < 0.0f ) invLength = -invLength;
+
+    unsigned long long bits = static_cast<unsigned long long>(largest) << 45;
+    for ( unsigned int i = 0; i < 3; i++ ) {
+        float c = q[COMPRESSED_QUATERNION_STORED[largest][i]] * invLength;
+        float normalized = (c + COMPRESSED_QUATERNION_RANGE) / (2.0f * COMPRESSED_QUATERNION_RANGE);
+        normalized = (normalized < 0.0f) ? 0.0f : ((normalized > 1.0f) ? 1.0f : normalized);
+        unsigned long long quantized = static_cast<unsigned long long>(normalized * COMPRESSED_QUATERNION_MAX + 0.5f);
+        bits |= quantized << (30 - 15 * i);
+    }
+
+    CompressedQuaternion result;
+    result.data[0] = static_cast<unsigned short>(bits >> 32);
+    result.data[1] = static_cast<unsigned short>(bits >> 16);
+    result.data[2] = static_cast<unsigned short>(bits);
+    return result;
+}
+
+inline void EncodeQuaternions(const float* q, CompressedQuaternion* out, std::size_t count) {
+    for ( std::size_t i = 0; i < count; i++ ) out[i] = EncodeQuaternion(q + 4 * i);
+}
+
+/*
+ * Decodes four compressed quaternions. The bit fields are unpacked one by one,
+ * the dequantization and the square root of the dropped component run four
+ * wide and the components are scattered back into place per quaternion.
+ */
+inline void DecodeQuaternions4(const CompressedQuaternion* in, float* out) {
+    float a[4], b[4], c[4], d[4];
+    unsigned int largest[4];
+    for ( int k = 0; k < 4; k++ ) {
+        unsigned long long bits = (static_cast<unsigned long long>(in[k].data[0]) << 32) |
+                                  (static_cast<unsigned long long>(in[k].data[1]) << 16) |
+                                   static_cast<unsigned long long>(in[k].data[2]);
+        largest[k] = static_cast<unsigned int>(bits >> 45) & 3u;
+        a[k] = static_cast<float>(static_cast<unsigned int>(bits >> 30) & COMPRESSED_QUATERNION_MAX);
+        b[k] = static_cast<float>(static_cast<unsigned int>(bits >> 15) & COMPRESSED_QUATERNION_MAX);
+        c[k] = static_cast<float>(static_cast<unsigned int>(bits) & COMPRESSED_QUATERNION_MAX);
+    }
+
+    SimdFloat4 scale = SimdSplat(2.0f * COMPRESSED_QUATERNION_RANGE / COMPRESSED_QUATERNION_MAX);
+    SimdFloat4 offset = SimdSplat(-COMPRESSED_QUATERNION_RANGE);
+    SimdFloat4 va = SimdMulAdd(SimdLoad(a), scale, offset);
+    SimdFloat4 vb = SimdMulAdd(SimdLoad(b), scale, offset);
+    SimdFloat4 vc = SimdMulAdd(SimdLoad(c), scale, offset);
+    SimdFloat4 vd = SimdSub(SimdSplat(1.0f), SimdMulAdd(vc, vc, SimdMulAdd(vb, vb, SimdMul(va, va))));
+    vd = SimdSqrt(SimdMax(vd, SimdZero()));
+
+    SimdStore(a, va);
+    SimdStore(b, vb);
+    SimdStore(c, vc);
+    SimdStore(d, vd);
+    for ( int k = 0; k < 4; k++ ) {
+        float* q = out + 4 * k;
+        const unsigned char* stored = COMPRESSED_QUATERNION_STORED[largest[k]];
+        q[stored[0]] = a[k];
+        q[stored[1]] = b[k];
+        q[stored[2]] = c[k];
+        q[largest[k]] = d[k];
+    }
+}
+
+inline void DecodeQuaternions(const CompressedQuaternion* in, float* out, std::size_t count) {
+    std::size_t i = 0;
+    for ( ; i + 4 <= count; i += 4 ) DecodeQuaternions4(in + i, out + 4 * i);
+
+    if ( i < count ) {
+        std::size_t remaining = count - i;
+        CompressedQuaternion tin[4] = {};
+        float tout[16];
+        std::memcpy(tin, in + i, remaining * sizeof(CompressedQuaternion));
+        DecodeQuaternions4(tin, tout);
+        std::memcpy(out + 4 * i, tout, remaining * 4 * sizeof(float));
+    }
+}
+
+inline void DecodeQuaternion(const CompressedQuaternion& in, float* q) {
+    DecodeQuaternions(&in, q, 1);
+}
+
+#endif
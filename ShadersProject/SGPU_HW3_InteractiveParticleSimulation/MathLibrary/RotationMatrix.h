@@ -31,27 +31,23 @@
 template <typename Real>
 class RotationMatrix : public Matrix3<Real> {
 public:
-    RotationMatrix();
-    ~RotationMatrix();
+    MATH_CONSTEXPR RotationMatrix();
 
     /*
      * The inverse of a rotation matrix is greatly simplified due to its
      * orthogonal property. Using this property, the inverse of this orthogonal
      * matrix is simply its transpose.
      */
-    void invert();
+    MATH_CONSTEXPR void invert();
 
     static RotationMatrix<Real> Inverse(const RotationMatrix<Real>& m);
 };
 
 template <typename Real>
-RotationMatrix<Real>::RotationMatrix() : Matrix3<Real>(true) {}
+MATH_CONSTEXPR RotationMatrix<Real>::RotationMatrix() : Matrix3<Real>(true) {}
 
 template <typename Real>
-RotationMatrix<Real>::~RotationMatrix() {}
-
-template <typename Real>
-void RotationMatrix<Real>::invert() {
+MATH_CONSTEXPR void RotationMatrix<Real>::invert() {
     this->transpose();
 }
 
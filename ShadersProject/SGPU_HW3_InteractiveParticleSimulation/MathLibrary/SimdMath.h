@@ -0,0 +1,319 @@
+#ifndef SIMD_MATH_H
+#define SIMD_MATH_H
+
+#include <cmath>
+
+/*
+ * SimdMath: Thin abstraction over four-wide float vector registers used by the
+ * float specializations of Vector3, Vector4 and Matrix4.
+ *
+ * The backend is selected at compile time:
+ *   SSE    x86/x64 (always available on x64, /arch:SSE or better on x86).
+ *          Defining __FMA__ or __AVX2__ (/arch:AVX2) enables fused multiply-add.
+ *   NEON   ARMv7 with NEON and ARMv8/AArch64.
+ *   Scalar Fallback for everything else, or if MATH_NO_SIMD is defined.
+ *
+ * Loads and stores are unaligned: Vector4f is embedded at 4-byte offsets in
+ * interleaved vertex formats (see Vertex::tangent), so the math types can not
+ * demand 16-byte alignment. On current hardware an unaligned load of data that
+ * happens to be aligned costs the same as an aligned load.
+ *
+ * All functions operate on (x, y, z, w) lanes, lane 0 being x.
+ */
+#if defined(MATH_NO_SIMD)
+    #define MATH_SIMD_SCALAR
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #define MATH_SIMD_SSE
+    #if defined(__FMA__) || defined(__AVX2__)
+        #define MATH_SIMD_FMA
+        #include <immintrin.h>
+    #else
+        #include <xmmintrin.h>
+    #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM) || defined(_M_ARM64)
+    #define MATH_SIMD_NEON
+    #if defined(__aarch64__) || defined(_M_ARM64)
+        #define MATH_SIMD_NEON_64
+    #endif
+    #include <arm_neon.h>
+#else
+    #define MATH_SIMD_SCALAR
+#endif
+
+#if defined(MATH_SIMD_SSE)
+typedef __m128 SimdFloat4;
+#elif defined(MATH_SIMD_NEON)
+typedef float32x4_t SimdFloat4;
+#else
+struct SimdFloat4 {
+    float v[4];
+};
+#endif
+
+#if defined(MATH_SIMD_SSE)
+
+inline SimdFloat4 SimdLoad(const float* p) { return _mm_loadu_ps(p); }
+inline void SimdStore(float* p, SimdFloat4 a) { _mm_storeu_ps(p, a); }
+inline SimdFloat4 SimdSet(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline SimdFloat4 SimdSplat(float s) { return _mm_set1_ps(s); }
+inline SimdFloat4 SimdZero() { return _mm_setzero_ps(); }
+inline float SimdGetX(SimdFloat4 a) { return _mm_cvtss_f32(a); }
+
+inline SimdFloat4 SimdAdd(SimdFloat4 a, SimdFloat4 b) { return _mm_add_ps(a, b); }
+inline SimdFloat4 SimdSub(SimdFloat4 a, SimdFloat4 b) { return _mm_sub_ps(a, b); }
+inline SimdFloat4 SimdMul(SimdFloat4 a, SimdFloat4 b) { return _mm_mul_ps(a, b); }
+inline SimdFloat4 SimdDiv(SimdFloat4 a, SimdFloat4 b) { return _mm_div_ps(a, b); }
+inline SimdFloat4 SimdMin(SimdFloat4 a, SimdFloat4 b) { return _mm_min_ps(a, b); }
+inline SimdFloat4 SimdMax(SimdFloat4 a, SimdFloat4 b) { return _mm_max_ps(a, b); }
+inline SimdFloat4 SimdSqrt(SimdFloat4 a) { return _mm_sqrt_ps(a); }
+
+/* a * b + c */
+inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c) {
+#if defined(MATH_SIMD_FMA)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+/* (a[X], a[Y], b[Z], b[W]) */
+template <int X, int Y, int Z, int W>
+inline SimdFloat4 SimdShuffle(SimdFloat4 a, SimdFloat4 b) {
+    return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+}
+
+/* Lanes of a where the lane of mask is positive, lanes of b elsewhere */
+inline SimdFloat4 SimdSelectPositive(SimdFloat4 mask, SimdFloat4 a, SimdFloat4 b) {
+    __m128 positive = _mm_cmpgt_ps(mask, _mm_setzero_ps());
+    return _mm_or_ps(_mm_and_ps(positive, a), _mm_andnot_ps(positive, b));
+}
+
+/* True if any lane of a is greater than the same lane of b */
+inline bool SimdAnyGreater(SimdFloat4 a, SimdFloat4 b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)) != 0; }
+
+/* Bit i is set if lane i of a is greater than lane i of b */
+inline int SimdMaskGreater(SimdFloat4 a, SimdFloat4 b) { return _mm_movemask_ps(_mm_cmpgt_ps(a, b)); }
+
+/* Reciprocal square root estimate (12 bits) */
+inline SimdFloat4 SimdRsqrtEstimate(SimdFloat4 a) { return _mm_rsqrt_ps(a); }
+
+#elif defined(MATH_SIMD_NEON)
+
+inline SimdFloat4 SimdLoad(const float* p) { return vld1q_f32(p); }
+inline void SimdStore(float* p, SimdFloat4 a) { vst1q_f32(p, a); }
+inline SimdFloat4 SimdSet(float x, float y, float z, float w) { float v[4] = { x, y, z, w }; return vld1q_f32(v); }
+inline SimdFloat4 SimdSplat(float s) { return vdupq_n_f32(s); }
+inline SimdFloat4 SimdZero() { return vdupq_n_f32(0.0f); }
+inline float SimdGetX(SimdFloat4 a) { return vgetq_lane_f32(a, 0); }
+
+inline SimdFloat4 SimdAdd(SimdFloat4 a, SimdFloat4 b) { return vaddq_f32(a, b); }
+inline SimdFloat4 SimdSub(SimdFloat4 a, SimdFloat4 b) { return vsubq_f32(a, b); }
+inline SimdFloat4 SimdMul(SimdFloat4 a, SimdFloat4 b) { return vmulq_f32(a, b); }
+inline SimdFloat4 SimdMin(SimdFloat4 a, SimdFloat4 b) { return vminq_f32(a, b); }
+inline SimdFloat4 SimdMax(SimdFloat4 a, SimdFloat4 b) { return vmaxq_f32(a, b); }
+
+inline SimdFloat4 SimdSqrt(SimdFloat4 a) {
+#if defined(MATH_SIMD_NEON_64)
+    return vsqrtq_f32(a);
+#else
+    SimdFloat4 y = vrsqrteq_f32(a);
+    y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+    y = vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+    return vbslq_f32(vcgtq_f32(a, vdupq_n_f32(0.0f)), vmulq_f32(a, y), vdupq_n_f32(0.0f));
+#endif
+}
+
+inline SimdFloat4 SimdDiv(SimdFloat4 a, SimdFloat4 b) {
+#if defined(MATH_SIMD_NEON_64)
+    return vdivq_f32(a, b);
+#else
+    SimdFloat4 r = vrecpeq_f32(b);
+    r = vmulq_f32(r, vrecpsq_f32(b, r));
+    r = vmulq_f32(r, vrecpsq_f32(b, r));
+    return vmulq_f32(a, r);
+#endif
+}
+
+/* a * b + c */
+inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c) {
+#if defined(MATH_SIMD_NEON_64)
+    return vfmaq_f32(c, a, b);
+#else
+    return vmlaq_f32(c, a, b);
+#endif
+}
+
+/* (a[X], a[Y], b[Z], b[W]) */
+template <int X, int Y, int Z, int W>
+inline SimdFloat4 SimdShuffle(SimdFloat4 a, SimdFloat4 b) {
+    SimdFloat4 r = vdupq_n_f32(vgetq_lane_f32(a, X));
+    r = vsetq_lane_f32(vgetq_lane_f32(a, Y), r, 1);
+    r = vsetq_lane_f32(vgetq_lane_f32(b, Z), r, 2);
+    return vsetq_lane_f32(vgetq_lane_f32(b, W), r, 3);
+}
+
+/* Lanes of a where the lane of mask is positive, lanes of b elsewhere */
+inline SimdFloat4 SimdSelectPositive(SimdFloat4 mask, SimdFloat4 a, SimdFloat4 b) {
+    return vbslq_f32(vcgtq_f32(mask, vdupq_n_f32(0.0f)), a, b);
+}
+
+/* True if any lane of a is greater than the same lane of b */
+inline bool SimdAnyGreater(SimdFloat4 a, SimdFloat4 b) {
+    uint32x4_t greater = vcgtq_f32(a, b);
+#if defined(MATH_SIMD_NEON_64)
+    return vmaxvq_u32(greater) != 0;
+#else
+    uint32x2_t halves = vorr_u32(vget_low_u32(greater), vget_high_u32(greater));
+    return (vget_lane_u32(halves, 0) | vget_lane_u32(halves, 1)) != 0;
+#endif
+}
+
+/* Bit i is set if lane i of a is greater than lane i of b */
+inline int SimdMaskGreater(SimdFloat4 a, SimdFloat4 b) {
+    uint32x4_t greater = vcgtq_f32(a, b);
+    return static_cast<int>((vgetq_lane_u32(greater, 0) & 1) | (vgetq_lane_u32(greater, 1) & 2) | (vgetq_lane_u32(greater, 2) & 4) | (vgetq_lane_u32(greater, 3) & 8));
+}
+
+/* Reciprocal square root estimate (8 bits, refined once to match SSE) */
+inline SimdFloat4 SimdRsqrtEstimate(SimdFloat4 a) {
+    SimdFloat4 y = vrsqrteq_f32(a);
+    return vmulq_f32(y, vrsqrtsq_f32(vmulq_f32(a, y), y));
+}
+
+#else
+
+inline SimdFloat4 SimdSet(float x, float y, float z, float w) { SimdFloat4 r = { { x, y, z, w } }; return r; }
+inline SimdFloat4 SimdLoad(const float* p) { return SimdSet(p[0], p[1], p[2], p[3]); }
+inline void SimdStore(float* p, SimdFloat4 a) { for ( int i = 0; i < 4; i++ ) p[i] = a.v[i]; }
+inline SimdFloat4 SimdSplat(float s) { return SimdSet(s, s, s, s); }
+inline SimdFloat4 SimdZero() { return SimdSet(0.0f, 0.0f, 0.0f, 0.0f); }
+inline float SimdGetX(SimdFloat4 a) { return a.v[0]; }
+
+inline SimdFloat4 SimdAdd(SimdFloat4 a, SimdFloat4 b) { for ( int i = 0; i < 4; i++ ) a.v[i] += b.v[i]; return a; }
+inline SimdFloat4 SimdSub(SimdFloat4 a, SimdFloat4 b) { for ( int i = 0; i < 4; i++ ) a.v[i] -= b.v[i]; return a; }
+inline SimdFloat4 SimdMul(SimdFloat4 a, SimdFloat4 b) { for ( int i = 0; i < 4; i++ ) a.v[i] *= b.v[i]; return a; }
+inline SimdFloat4 SimdDiv(SimdFloat4 a, SimdFloat4 b) { for ( int i = 0; i < 4; i++ ) a.v[i] /= b.v[i]; return a; }
+inline SimdFloat4 SimdMin(SimdFloat4 a, SimdFloat4 b) { for ( int i = 0; i < 4; i++ ) a.v[i] = (b.v[i] < a.v[i]) ? b.v[i] : a.v[i]; return a; }
+inline SimdFloat4 SimdMax(SimdFloat4 a, SimdFloat4 b) { for ( int i = 0; i < 4; i++ ) a.v[i] = (b.v[i] > a.v[i]) ? b.v[i] : a.v[i]; return a; }
+inline SimdFloat4 SimdSqrt(SimdFloat4 a) { for ( int i = 0; i < 4; i++ ) a.v[i] = std::sqrt(a.v[i]); return a; }
+
+/* a * b + c */
+inline SimdFloat4 SimdMulAdd(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c) { for ( int i = 0; i < 4; i++ ) c.v[i] += a.v[i] * b.v[i]; return c; }
+
+/* (a[X], a[Y], b[Z], b[W]) */
+template <int X, int Y, int Z, int W>
+inline SimdFloat4 SimdShuffle(SimdFloat4 a, SimdFloat4 b) {
+    return SimdSet(a.v[X], a.v[Y], b.v[Z], b.v[W]);
+}
+
+/* Lanes of a where the lane of mask is positive, lanes of b elsewhere */
+inline SimdFloat4 SimdSelectPositive(SimdFloat4 mask, SimdFloat4 a, SimdFloat4 b) { for ( int i = 0; i < 4; i++ ) a.v[i] = (mask.v[i] > 0.0f) ? a.v[i] : b.v[i]; return a; }
+
+/* True if any lane of a is greater than the same lane of b */
+inline bool SimdAnyGreater(SimdFloat4 a, SimdFloat4 b) { return a.v[0] > b.v[0] || a.v[1] > b.v[1] || a.v[2] > b.v[2] || a.v[3] > b.v[3]; }
+
+/* Bit i is set if lane i of a is greater than lane i of b */
+inline int SimdMaskGreater(SimdFloat4 a, SimdFloat4 b) {
+    int mask = 0;
+    for ( int i = 0; i < 4; i++ ) if ( a.v[i] > b.v[i] ) mask |= 1 << i;
+    return mask;
+}
+
+/* Exact in the scalar backend, so SimdRsqrt skips the refinement step. */
+inline SimdFloat4 SimdRsqrtEstimate(SimdFloat4 a) {
+    for ( int i = 0; i < 4; i++ ) a.v[i] = 1.0f / std::sqrt(a.v[i]);
+    return a;
+}
+
+#endif
+
+/* Loads three floats into the xyz lanes without reading past them, w is zero. */
+inline SimdFloat4 SimdLoad3(const float* p) {
+    return SimdSet(p[0], p[1], p[2], 0.0f);
+}
+
+/* Stores the xyz lanes without writing past them. */
+inline void SimdStore3(float* p, SimdFloat4 a) {
+#if defined(MATH_SIMD_SSE)
+    _mm_storel_pi(reinterpret_cast<__m64*>(p), a);
+    _mm_store_ss(p + 2, _mm_movehl_ps(a, a));
+#elif defined(MATH_SIMD_NEON)
+    vst1_f32(p, vget_low_f32(a));
+    vst1q_lane_f32(p + 2, a, 2);
+#else
+    for ( int i = 0; i < 3; i++ ) p[i] = a.v[i];
+#endif
+}
+
+/* Absolute value of every lane. */
+inline SimdFloat4 SimdAbs(SimdFloat4 a) {
+    return SimdMax(a, SimdSub(SimdZero(), a));
+}
+
+/* Broadcasts lane I of a to all lanes. */
+template <int I>
+inline SimdFloat4 SimdSplatLane(SimdFloat4 a) {
+    return SimdShuffle<I, I, I, I>(a, a);
+}
+
+/* Dot product of all four lanes, broadcast to all lanes. */
+inline SimdFloat4 SimdDot4(SimdFloat4 a, SimdFloat4 b) {
+    SimdFloat4 m = SimdMul(a, b);
+    m = SimdAdd(m, SimdShuffle<1, 0, 3, 2>(m, m));
+    return SimdAdd(m, SimdShuffle<2, 3, 0, 1>(m, m));
+}
+
+/* Transposes the 4x4 matrix whose rows are a, b, c and d in place. */
+inline void SimdTranspose4(SimdFloat4& a, SimdFloat4& b, SimdFloat4& c, SimdFloat4& d) {
+    SimdFloat4 t0 = SimdShuffle<0, 1, 0, 1>(a, b);
+    SimdFloat4 t1 = SimdShuffle<2, 3, 2, 3>(a, b);
+    SimdFloat4 t2 = SimdShuffle<0, 1, 0, 1>(c, d);
+    SimdFloat4 t3 = SimdShuffle<2, 3, 2, 3>(c, d);
+    a = SimdShuffle<0, 2, 0, 2>(t0, t2);
+    b = SimdShuffle<1, 3, 1, 3>(t0, t2);
+    c = SimdShuffle<0, 2, 0, 2>(t1, t3);
+    d = SimdShuffle<1, 3, 1, 3>(t1, t3);
+}
+
+/* Sums of the lanes of a, b, c and d as (sum(a), sum(b), sum(c), sum(d)). */
+inline SimdFloat4 SimdHorizontalAdd4(SimdFloat4 a, SimdFloat4 b, SimdFloat4 c, SimdFloat4 d) {
+    SimdFloat4 ab = SimdAdd(SimdShuffle<0, 1, 0, 1>(a, b), SimdShuffle<2, 3, 2, 3>(a, b));
+    SimdFloat4 cd = SimdAdd(SimdShuffle<0, 1, 0, 1>(c, d), SimdShuffle<2, 3, 2, 3>(c, d));
+    return SimdAdd(SimdShuffle<0, 2, 0, 2>(ab, cd), SimdShuffle<1, 3, 1, 3>(ab, cd));
+}
+
+/* Cross product of the xyz lanes. The w lane of the result is zero. */
+inline SimdFloat4 SimdCross3(SimdFloat4 a, SimdFloat4 b) {
+    SimdFloat4 aYZX = SimdShuffle<1, 2, 0, 3>(a, a);
+    SimdFloat4 bYZX = SimdShuffle<1, 2, 0, 3>(b, b);
+    SimdFloat4 c = SimdSub(SimdMul(a, bYZX), SimdMul(aYZX, b));
+    return SimdShuffle<1, 2, 0, 3>(c, c);
+}
+
+/*
+ * Reciprocal square root: hardware estimate plus one Newton-Raphson step
+ * y' = y * (1.5 - 0.5 * a * y * y), accurate to about 2 ulp. Zero yields
+ * infinity times zero (NaN) like 1 / sqrt(0) * 0 does in the scalar code.
+ */
+inline SimdFloat4 SimdRsqrt(SimdFloat4 a) {
+    SimdFloat4 y = SimdRsqrtEstimate(a);
+#if defined(MATH_SIMD_SCALAR)
+    return y;
+#else
+    SimdFloat4 ayy = SimdMul(SimdMul(a, y), y);
+    return SimdMul(SimdMul(SimdSplat(0.5f), y), SimdSub(SimdSplat(3.0f), ayy));
+#endif
+}
+
+inline float SimdRsqrt(float a) {
+#if defined(MATH_SIMD_SSE)
+    __m128 v = _mm_set_ss(a);
+    __m128 y = _mm_rsqrt_ss(v);
+    __m128 ayy = _mm_mul_ss(_mm_mul_ss(v, y), y);
+    return _mm_cvtss_f32(_mm_mul_ss(_mm_mul_ss(_mm_set_ss(0.5f), y), _mm_sub_ss(_mm_set_ss(3.0f), ayy)));
+#else
+    return SimdGetX(SimdRsqrt(SimdSplat(a)));
+#endif
+}
+
+#endif
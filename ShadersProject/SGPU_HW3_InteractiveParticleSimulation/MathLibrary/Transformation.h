@@ -43,17 +43,30 @@ std::ostream& operator << <> (std::ostream& out, const Transformation<Real>& tra
  * [0 0 1 z]
  * [0 0 0 1]
  * 
+ * The matrix (and its inverse and normal matrix) is built lazily: setters only
+ * record what changed and the matrices are rebuilt the first time they are
+ * read afterwards. Setting a value that is already set changes nothing, and a
+ * change of the position only patches the translation row.
+ *
  * This implementation also foregoes vectorization (SSE).
  * This implementation is aimed at a flexibility while preserving 
  * understandability and complete modularity.
  */
 template <typename Real>
 class Transformation {
+    /* Cached results that are out of date. */
+    enum DirtyFlag {
+        DIRTY_TRANSLATION = 0x1,
+        DIRTY_MATRIX = 0x2,
+        DIRTY_INVERSE = 0x4,
+        DIRTY_NORMAL_MATRIX = 0x8,
+        DIRTY_ALL = 0xF
+    };
+
 public:
-    Transformation();
-    Transformation(const Vector3<Real>& position);
-    Transformation(const Transformation<Real>& transform);
-    virtual ~Transformation();
+    MATH_CONSTEXPR Transformation();
+    MATH_CONSTEXPR Transformation(const Vector3<Real>& position);
+    MATH_CONSTEXPR Transformation(const Transformation<Real>& transform);
 
     void setPositionX(Real x);
     void setPositionY(Real y);
@@ -66,7 +79,7 @@ public:
 
     void setScaleX(Real sx);
     void setScaleY(Real sy);
-    void setScaleZ(Real xz);
+    void setScaleZ(Real sz);
     void addScaleX(Real sx);
     void addScaleY(Real sy);
     void addScaleZ(Real sz);
@@ -78,9 +91,14 @@ public:
     
     friend std::ostream& operator << <> (std::ostream& out, const Transformation<Real>& transform);
 
-    const Vector3<Real>& getPosition() const;
-    const Vector3<Real>& getScale() const;
-    const Quaternion<Real>& getRotation() const;
+    MATH_CONSTEXPR const Vector3<Real>& getPosition() const;
+    MATH_CONSTEXPR const Vector3<Real>& getScale() const;
+    MATH_CONSTEXPR const Quaternion<Real>& getRotation() const;
+
+    /* 
+     * The mutable getters can not see what the caller changes, so they mark
+     * the whole transformation as changed.
+     */
     Vector3<Real>& getPosition();
     Vector3<Real>& getScale();
     Quaternion<Real>& getRotation();
@@ -88,163 +106,176 @@ public:
     const Matrix4<Real>& toMatrix() const;
     Matrix4<Real> toTransformationMatrix() const;
 
+    /* Inverse of toMatrix(), cached like the matrix itself. */
+    const Matrix4<Real>& toInverseMatrix() const;
+
+    /* Inverse transpose of the upper 3x3 block of toMatrix(), for normals. */
+    const Matrix3<Real>& toNormalMatrix() const;
+
+    /* 
+     * Incremented on every change, so dependent data (e.g. the world matrix
+     * of a TransformationNode) can tell whether it is out of date.
+     */
+    MATH_CONSTEXPR unsigned int getVersion() const;
+
     Transformation<Real>& operator = (const Transformation<Real>& transform);
 
-    static Transformation<Real> Identity();
-    static Transformation<Real> Scale(Real sx, Real sy, Real sz);
-    static Transformation<Real> Translate(Real x, Real y, Real z);
+    static MATH_CONSTEXPR Transformation<Real> Identity();
+    static MATH_CONSTEXPR Transformation<Real> Scale(Real sx, Real sy, Real sz);
+    static MATH_CONSTEXPR Transformation<Real> Translate(Real x, Real y, Real z);
     static Transformation<Real> RotateX(Real angle);
     static Transformation<Real> RotateY(Real angle);
     static Transformation<Real> RotateZ(Real angle);
 
 protected:
-    void compile(bool colMajor = true);
+    /* Transformation whose matrix is already known; only the inverse and normal matrix are built lazily. */
+    MATH_CONSTEXPR Transformation(const Vector3<Real>& position, const Vector3<Real>& scale, const Quaternion<Real>& rotation, const Matrix4<Real>& transform);
+
+    void compile(bool colMajor = true) const;
+    void invalidate(unsigned int flags);
 
 protected:
     Vector3<Real> position;
     Vector3<Real> scale;
     Quaternion<Real> rotation;
 
-    Matrix4<Real> transform;
+    mutable Matrix4<Real> transform;
+    mutable Matrix4<Real> inverseTransform;
+    mutable Matrix3<Real> normalMatrix;
+    mutable unsigned int dirty;
+    unsigned int version;
 };
 
 template <typename Real>
-Transformation<Real>::Transformation() {
+MATH_CONSTEXPR Transformation<Real>::Transformation() : dirty(DIRTY_ALL), version(0) {
     this->position = Vector3<Real>();
     this->scale = Vector3<Real>(Real(1), Real(1), Real(1));
     this->rotation = Quaternion<Real>::Identity();
-    this->transform = Matrix4<Real>(false);
 }
 
 template <typename Real>
-Transformation<Real>::Transformation(const Vector3<Real>& position) {
+MATH_CONSTEXPR Transformation<Real>::Transformation(const Vector3<Real>& position) : dirty(DIRTY_ALL), version(0) {
     this->position = position;
     this->scale = Vector3<Real>(Real(1), Real(1), Real(1));
     this->rotation = Quaternion<Real>::Identity();
-    this->transform = Matrix4<Real>(false);
 }
 
 template <typename Real>
-Transformation<Real>::Transformation(const Transformation<Real>& transform) {
+MATH_CONSTEXPR Transformation<Real>::Transformation(const Transformation<Real>& transform) : dirty(transform.dirty), version(0) {
     this->position = transform.position;
     this->scale = transform.scale;
     this->rotation = transform.rotation;
     this->transform = transform.transform;
+    this->inverseTransform = transform.inverseTransform;
+    this->normalMatrix = transform.normalMatrix;
 }
 
 template <typename Real>
-Transformation<Real>::~Transformation() {}
+MATH_CONSTEXPR Transformation<Real>::Transformation(const Vector3<Real>& position, const Vector3<Real>& scale, const Quaternion<Real>& rotation, const Matrix4<Real>& transform) :
+    position(position), scale(scale), rotation(rotation), transform(transform), dirty(DIRTY_INVERSE | DIRTY_NORMAL_MATRIX), version(0) {}
+
+template <typename Real>
+void Transformation<Real>::invalidate(unsigned int flags) {
+    this->dirty |= flags;
+    this->version++;
+}
 
 template <typename Real>
 void Transformation<Real>::setPositionX(Real x) {
-    this->position.x() = x;
-    this->transform(3, 0) = x;
+    this->setPosition(x, this->position.y(), this->position.z());
 }
 
 template <typename Real>
 void Transformation<Real>::setPositionY(Real y) {
-    this->position.y() = y;
-    this->transform(3, 1) = y;
+    this->setPosition(this->position.x(), y, this->position.z());
 }
 
 template <typename Real>
 void Transformation<Real>::setPositionZ(Real z) {
-    this->position.z() = z;
-    this->transform(3, 2) = z;
+    this->setPosition(this->position.x(), this->position.y(), z);
 }
 
 template <typename Real>
 void Transformation<Real>::addPositionX(Real x) {
-    this->position.x() += x;
-    this->transform(3, 0) += x;
+    this->setPosition(this->position.x() + x, this->position.y(), this->position.z());
 }
 
 template <typename Real>
 void Transformation<Real>::addPositionY(Real y) {
-    this->position.y() += y;
-    this->transform(3, 1) += y;
+    this->setPosition(this->position.x(), this->position.y() + y, this->position.z());
 }
 
 template <typename Real>
 void Transformation<Real>::addPositionZ(Real z) {
-    this->position.z() += z;
-    this->transform(3, 2) += z;
+    this->setPosition(this->position.x(), this->position.y(), this->position.z() + z);
 }
 
 template <typename Real>
 void Transformation<Real>::setPosition(Real x, Real y, Real z) {
+    if ( this->position.x() == x && this->position.y() == y && this->position.z() == z ) return;
     this->position.set(x, y, z);
-    this->transform(3, 0) = x;
-    this->transform(3, 1) = y;
-    this->transform(3, 2) = z;
+    this->invalidate(DIRTY_TRANSLATION | DIRTY_INVERSE);
 }
 
 template <typename Real>
 void Transformation<Real>::setPosition(const Vector3<Real>& position) {
-    this->position = position;
-    this->transform(3, 0) = position.x();
-    this->transform(3, 1) = position.y();
-    this->transform(3, 2) = position.z();
+    this->setPosition(position.x(), position.y(), position.z());
 }
 
 template <typename Real>
 void Transformation<Real>::setScaleX(Real sx) {
-    this->scale.setX(sx);
-    this->compile();
+    this->setScale(sx, this->scale.y(), this->scale.z());
 }
 
 template <typename Real>
 void Transformation<Real>::setScaleY(Real sy) {
-    this->scale.setY(sy);
-    this->compile();
+    this->setScale(this->scale.x(), sy, this->scale.z());
 }
 
 template <typename Real>
-void Transformation<Real>::setScaleZ(Real xz) {
-    this->scale.setZ(sz);
-    this->compile();
+void Transformation<Real>::setScaleZ(Real sz) {
+    this->setScale(this->scale.x(), this->scale.y(), sz);
 }
 
 template <typename Real>
 void Transformation<Real>::addScaleX(Real sx) {
-    this->scale.x() += sx;
-    this->compile();
+    this->setScale(this->scale.x() + sx, this->scale.y(), this->scale.z());
 }
 
 template <typename Real>
 void Transformation<Real>::addScaleY(Real sy) {
-    this->scale.y() += sy;
-    this->compile();
+    this->setScale(this->scale.x(), this->scale.y() + sy, this->scale.z());
 }
 
 template <typename Real>
 void Transformation<Real>::addScaleZ(Real sz) {
-    this->scale.z() += sz;
-    this->compile();
+    this->setScale(this->scale.x(), this->scale.y(), this->scale.z() + sz);
 }
 
 template <typename Real>
 void Transformation<Real>::setScale(Real sx, Real sy, Real sz) {
+    if ( this->scale.x() == sx && this->scale.y() == sy && this->scale.z() == sz ) return;
     this->scale.set(sx, sy, sz);
-    this->compile();
+    this->invalidate(DIRTY_ALL);
 }
 
 template <typename Real>
 void Transformation<Real>::setScale(const Vector3<Real>& scale) {
-    this->scale = scale;
-    this->compile();
+    this->setScale(scale.x(), scale.y(), scale.z());
 }
 
 template <typename Real>
 void Transformation<Real>::addRotation(const Quaternion<Real>& rotation) {
     this->rotation *= rotation;
-    this->compile();
+    this->invalidate(DIRTY_ALL);
 }
 
 template <typename Real>
 void Transformation<Real>::setRotation(const Quaternion<Real>& rotation) {
+    if ( this->rotation.x() == rotation.x() && this->rotation.y() == rotation.y() &&
+         this->rotation.z() == rotation.z() && this->rotation.w() == rotation.w() ) return;
     this->rotation = rotation;
-    this->compile();
+    this->invalidate(DIRTY_ALL);
 }
     
 template <typename Real>
@@ -254,48 +285,80 @@ std::ostream& operator << (std::ostream& out, const Transformation<Real>& transf
     out << "Scale: " << transform.scale << std::endl;
     out << "Rotation: " << transform.rotation << std::endl;
     out << "Matrix:" << std::endl;
-    out << transform.transform << std::endl;
+    out << transform.toMatrix() << std::endl;
     return out;
 }
 
 template <typename Real>
-const Vector3<Real>& Transformation<Real>::getPosition() const{ 
+MATH_CONSTEXPR const Vector3<Real>& Transformation<Real>::getPosition() const{ 
     return this->position;
 }
 
 template <typename Real>
-const Vector3<Real>& Transformation<Real>::getScale() const {
+MATH_CONSTEXPR const Vector3<Real>& Transformation<Real>::getScale() const {
     return scale;
 }
 
 template <typename Real>
-const Quaternion<Real>& Transformation<Real>::getRotation() const {
+MATH_CONSTEXPR const Quaternion<Real>& Transformation<Real>::getRotation() const {
     return this->rotation;
 }
 
 template <typename Real>
 Vector3<Real>& Transformation<Real>::getPosition() {
+    this->invalidate(DIRTY_TRANSLATION | DIRTY_INVERSE);
     return this->position;
 }
 
 template <typename Real>
 Vector3<Real>& Transformation<Real>::getScale() {
+    this->invalidate(DIRTY_ALL);
     return this->scale;
 }
 
 template <typename Real>
 Quaternion<Real>& Transformation<Real>::getRotation() {
+    this->invalidate(DIRTY_ALL);
     return this->rotation;
 }
 
 template <typename Real>
 const Matrix4<Real>& Transformation<Real>::toMatrix() const {
+    if ( this->dirty & (DIRTY_MATRIX | DIRTY_TRANSLATION) ) this->compile();
     return this->transform;
 }
 
 template <typename Real>
 Matrix4<Real> Transformation<Real>::toTransformationMatrix() const {
-    return this->transform;
+    return this->toMatrix();
+}
+
+template <typename Real>
+const Matrix4<Real>& Transformation<Real>::toInverseMatrix() const {
+    if ( this->dirty & DIRTY_INVERSE ) {
+        this->inverseTransform = Matrix4<Real>::Inverse(this->toMatrix());
+        this->dirty &= ~DIRTY_INVERSE;
+    }
+
+    return this->inverseTransform;
+}
+
+template <typename Real>
+const Matrix3<Real>& Transformation<Real>::toNormalMatrix() const {
+    if ( this->dirty & DIRTY_NORMAL_MATRIX ) {
+        const Matrix4<Real>& inverse = this->toInverseMatrix();
+        for ( unsigned int i = 0; i < 3; i++ )
+            for ( unsigned int j = 0; j < 3; j++ )
+                this->normalMatrix.set(i, j, inverse(j, i));
+        this->dirty &= ~DIRTY_NORMAL_MATRIX;
+    }
+
+    return this->normalMatrix;
+}
+
+template <typename Real>
+MATH_CONSTEXPR unsigned int Transformation<Real>::getVersion() const {
+    return this->version;
 }
 
 template <typename Real>
@@ -305,6 +368,10 @@ Transformation<Real>& Transformation<Real>::operator = (const Transformation<Rea
     this->scale = transform.scale;
     this->rotation = transform.rotation;
     this->transform = transform.transform;
+    this->inverseTransform = transform.inverseTransform;
+    this->normalMatrix = transform.normalMatrix;
+    this->dirty = transform.dirty;
+    this->version++;
     return *this;
 }
 
@@ -317,13 +384,8 @@ Transformation<Real>& Transformation<Real>::operator = (const Transformation<Rea
  * [ 0 0 0 1 ]
  */
 template <typename Real>
-Transformation<Real> Transformation<Real>::Identity() {
-    Transformation<Real> result;
-    result.position = Vector3<Real>();
-    result.scale = Vector3<Real>(Real(1), Real(1), Real(1));
-    result.rotation = Quaternion<Real>::Identity();
-    result.compile();
-    return result;
+MATH_CONSTEXPR Transformation<Real> Transformation<Real>::Identity() {
+    return Transformation<Real>(Vector3<Real>(), Vector3<Real>(Real(1), Real(1), Real(1)), Quaternion<Real>::Identity(), Matrix4<Real>::Identity());
 }
 
 /* Min C. [Computer Graphics]
@@ -335,11 +397,8 @@ Transformation<Real> Transformation<Real>::Identity() {
  * [ 0  0  0  1 ]
  */
 template <typename Real>
-Transformation<Real> Transformation<Real>::Scale(Real sx, Real sy, Real sz) {
-    Transformation<Real> result;
-    result.setScale(sx, sy, sz);
-    result.compile();
-    return result;
+MATH_CONSTEXPR Transformation<Real> Transformation<Real>::Scale(Real sx, Real sy, Real sz) {
+    return Transformation<Real>(Vector3<Real>(), Vector3<Real>(sx, sy, sz), Quaternion<Real>::Identity(), Matrix4<Real>::Scaling(sx, sy, sz));
 }
 
 /* Min C. [Computer Graphics]
@@ -351,11 +410,8 @@ Transformation<Real> Transformation<Real>::Scale(Real sx, Real sy, Real sz) {
  * [ 0 0 0 1 ]
  */
 template <typename Real>
-Transformation<Real> Transformation<Real>::Translate(Real x, Real y, Real z) {
-    Transformation<Real> result;
-    result.setPosition(x, y, z);
-    result.compile();
-    return result;
+MATH_CONSTEXPR Transformation<Real> Transformation<Real>::Translate(Real x, Real y, Real z) {
+    return Transformation<Real>(Vector3<Real>(x, y, z), Vector3<Real>(Real(1), Real(1), Real(1)), Quaternion<Real>::Identity(), Matrix4<Real>::Translation(x, y, z));
 }
 
 /* Min C. [Computer Graphics]
@@ -409,14 +465,27 @@ Transformation<Real> Transformation<Real>::RotateZ(Real angle) {
     return result;
 }
 
+/*
+ * Brings the matrix up to date. A pure position change only rewrites the
+ * translation; the rotation and scale block is rebuilt when they changed.
+ */
 template <typename Real>
-void Transformation<Real>::compile(bool colMajor) {
-    Matrix3<Real> rotationMatrix = this->rotation.toRotationMatrix();
-    Matrix3<Real> t = rotationMatrix.apply(this->scale);
-    this->transform.set(t);
+void Transformation<Real>::compile(bool colMajor) const {
+    if ( this->dirty & DIRTY_MATRIX ) {
+        //----------------------------------------------------------------------
+        // With row vectors the scale is applied first, so row i of the
+        // rotation is scaled by the i-th scale factor.
+        //----------------------------------------------------------------------
+        Real scale[3] = { this->scale.x(), this->scale.y(), this->scale.z() };
+        this->transform.set(this->rotation.toRotationMatrix());
+        for ( unsigned int i = 0; i < 3; i++ )
+            for ( unsigned int j = 0; j < 3; j++ )
+                this->transform(i, j) *= scale[i];
+    }
 
     if ( colMajor ) this->transform.setRow(3, this->position.x(), this->position.y(), this->position.z(), Real(1));
     else this->transform.setColumn(3, this->position.x(), this->position.y(), this->position.z(), Real(1));
+    this->dirty &= ~(DIRTY_MATRIX | DIRTY_TRANSLATION);
 }
 
 typedef Transformation<float> Transformationf;
@@ -0,0 +1,68 @@
+#ifndef TRANSFORMATION_BATCH_H
+#define TRANSFORMATION_BATCH_H
+
+#include <cstddef>
+#include <cstring>
+#include "Transformation.h"
+#include "QuaternionBatch.h"
+
+/*
+ * Batch compilation of transformations: writes the 16 float matrix of every
+ * transformation, equal to Transformation::toMatrix, without going through the
+ * cached matrix of each object.
+ *
+ * Four transformations are compiled at a time. Their rotations, scales and
+ * positions are loaded and transposed into lanes, the rotation rows are built
+ * with QuaternionsToRotationRows4 and row i is scaled by the i-th scale factor
+ * as in Transformation::compile; the translation is the last row. Like the
+ * quaternion kernels this is element-wise, so it can be split over threads by
+ * calling it on sub-ranges.
+ */
+inline void CompileTransformations4(const Transformation<float>* transforms, float* out) {
+    SimdFloat4 x = SimdLoad(&transforms[0].getRotation().x());
+    SimdFloat4 y = SimdLoad(&transforms[1].getRotation().x());
+    SimdFloat4 z = SimdLoad(&transforms[2].getRotation().x());
+    SimdFloat4 w = SimdLoad(&transforms[3].getRotation().x());
+    SimdTranspose4(x, y, z, w);
+
+    SimdFloat4 scale[4];
+    SimdFloat4 position[4];
+    for ( int k = 0; k < 4; k++ ) {
+        scale[k] = SimdLoad3(transforms[k].getScale().constData());
+        position[k] = SimdLoad3(transforms[k].getPosition().constData());
+    }
+
+    SimdTranspose4(scale[0], scale[1], scale[2], scale[3]);
+    SimdTranspose4(position[0], position[1], position[2], position[3]);
+    position[3] = SimdSplat(1.0f);
+
+    SimdFloat4 rows[3][4];
+    QuaternionsToRotationRows4(x, y, z, w, rows);
+
+    for ( int row = 0; row < 3; row++ ) {
+        for ( int column = 0; column < 3; column++ ) rows[row][column] = SimdMul(rows[row][column], scale[row]);
+        SimdTranspose4(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+        for ( int k = 0; k < 4; k++ ) SimdStore(out + 16 * k + 4 * row, rows[row][k]);
+    }
+
+    SimdTranspose4(position[0], position[1], position[2], position[3]);
+    for ( int k = 0; k < 4; k++ ) SimdStore(out + 16 * k + 12, position[k]);
+}
+
+inline void CompileTransformations(const Transformation<float>* transforms, float* matrices, std::size_t count) {
+    std::size_t i = 0;
+    for ( ; i + 4 <= count; i += 4 )
+        CompileTransformations4(transforms + i, matrices + 16 * i);
+
+    if ( i < count ) {
+        std::size_t remaining = count - i;
+        Transformation<float> padded[4];
+        float block[64];
+        for ( std::size_t k = 0; k < remaining; k++ ) padded[k] = transforms[i + k];
+
+        CompileTransformations4(padded, block);
+        std::memcpy(matrices + 16 * i, block, remaining * 16 * sizeof(float));
+    }
+}
+
+#endif
@@ -0,0 +1,192 @@
+#ifndef TRANSFORMATION_NODE_H
+#define TRANSFORMATION_NODE_H
+
+#include <algorithm>
+#include <vector>
+#include "Transformation.h"
+
+/*
+ * TransformationNode: Transformation in a parent/child hierarchy.
+ *
+ * The local transformation is relative to the parent node; the world matrix
+ * is local * parent world (row vectors, see Matrix4). World matrices are
+ * recomputed lazily and only where needed: every node remembers the version
+ * of its local transformation and of its parent's world matrix it was built
+ * from, so a change only propagates to the subtree below the changed node.
+ *
+ * Nodes do not own each other. Destroying a node detaches it from its parent
+ * and turns its children into roots.
+ */
+template <typename Real>
+class TransformationNode {
+public:
+    TransformationNode();
+    virtual ~TransformationNode();
+
+    /* Attaches this node to parent, nullptr makes it a root. Fails on cycles. */
+    bool setParent(TransformationNode<Real>* parent);
+    TransformationNode<Real>* getParent() const;
+    std::size_t getChildCount() const;
+    TransformationNode<Real>* getChild(std::size_t index) const;
+
+    Transformation<Real>& getLocal();
+    const Transformation<Real>& getLocal() const;
+
+    const Matrix4<Real>& toWorldMatrix() const;
+    const Matrix4<Real>& toWorldInverseMatrix() const;
+
+    /* Incremented every time the world matrix is recomputed. */
+    unsigned int getWorldVersion() const;
+
+    /*
+     * Brings the world matrices of this node and all of its descendants up to
+     * date, visiting every node once. Returns the number of recomputed world
+     * matrices.
+     */
+    std::size_t update();
+
+protected:
+    TransformationNode(const TransformationNode<Real>& node);
+    TransformationNode<Real>& operator = (const TransformationNode<Real>& node);
+
+    /* Recomputes the world matrix if it is stale. The parent must be current. */
+    bool refresh() const;
+    std::size_t updateSubtree() const;
+
+protected:
+    TransformationNode<Real>* parent;
+    std::vector<TransformationNode<Real>*> children;
+    Transformation<Real> local;
+
+    mutable Matrix4<Real> world;
+    mutable Matrix4<Real> worldInverse;
+    mutable unsigned int localVersion;
+    mutable unsigned int parentVersion;
+    mutable unsigned int worldVersion;
+    mutable bool worldValid;
+    mutable bool inverseValid;
+};
+
+template <typename Real>
+TransformationNode<Real>::TransformationNode() {
+    this->parent = nullptr;
+    this->localVersion = 0;
+    this->parentVersion = 0;
+    this->worldVersion = 0;
+    this->worldValid = false;
+    this->inverseValid = false;
+}
+
+template <typename Real>
+TransformationNode<Real>::~TransformationNode() {
+    this->setParent(nullptr);
+    for ( std::size_t i = 0; i < this->children.size(); i++ ) {
+        this->children[i]->parent = nullptr;
+        this->children[i]->worldValid = false;
+    }
+}
+
+template <typename Real>
+bool TransformationNode<Real>::setParent(TransformationNode<Real>* parent) {
+    if ( parent == this->parent ) return true;
+
+    for ( TransformationNode<Real>* node = parent; node != nullptr; node = node->parent ) {
+        if ( node == this ) {
+            std::cerr << "[TransformationNode:setParent] Error: Node can not be its own ancestor." << std::endl;
+            return false;
+        }
+    }
+
+    if ( this->parent != nullptr ) {
+        std::vector<TransformationNode<Real>*>& siblings = this->parent->children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
+    }
+
+    this->parent = parent;
+    if ( parent != nullptr ) parent->children.push_back(this);
+    this->worldValid = false;
+    return true;
+}
+
+template <typename Real>
+TransformationNode<Real>* TransformationNode<Real>::getParent() const {
+    return this->parent;
+}
+
+template <typename Real>
+std::size_t TransformationNode<Real>::getChildCount() const {
+    return this->children.size();
+}
+
+template <typename Real>
+TransformationNode<Real>* TransformationNode<Real>::getChild(std::size_t index) const {
+    return this->children[index];
+}
+
+template <typename Real>
+Transformation<Real>& TransformationNode<Real>::getLocal() {
+    return this->local;
+}
+
+template <typename Real>
+const Transformation<Real>& TransformationNode<Real>::getLocal() const {
+    return this->local;
+}
+
+template <typename Real>
+bool TransformationNode<Real>::refresh() const {
+    unsigned int currentParentVersion = (this->parent != nullptr) ? this->parent->worldVersion : 0;
+    if ( this->worldValid && this->localVersion == this->local.getVersion() && this->parentVersion == currentParentVersion ) return false;
+
+    if ( this->parent != nullptr ) this->world = Matrix4<Real>::Multiply(this->local.toMatrix(), this->parent->world);
+    else this->world = this->local.toMatrix();
+
+    this->localVersion = this->local.getVersion();
+    this->parentVersion = currentParentVersion;
+    this->worldVersion++;
+    this->worldValid = true;
+    this->inverseValid = false;
+    return true;
+}
+
+template <typename Real>
+const Matrix4<Real>& TransformationNode<Real>::toWorldMatrix() const {
+    if ( this->parent != nullptr ) this->parent->toWorldMatrix();
+    this->refresh();
+    return this->world;
+}
+
+template <typename Real>
+const Matrix4<Real>& TransformationNode<Real>::toWorldInverseMatrix() const {
+    this->toWorldMatrix();
+    if ( !this->inverseValid ) {
+        this->worldInverse = Matrix4<Real>::Inverse(this->world);
+        this->inverseValid = true;
+    }
+
+    return this->worldInverse;
+}
+
+template <typename Real>
+unsigned int TransformationNode<Real>::getWorldVersion() const {
+    return this->worldVersion;
+}
+
+template <typename Real>
+std::size_t TransformationNode<Real>::updateSubtree() const {
+    std::size_t count = this->refresh() ? 1 : 0;
+    for ( std::size_t i = 0; i < this->children.size(); i++ )
+        count += this->children[i]->updateSubtree();
+    return count;
+}
+
+template <typename Real>
+std::size_t TransformationNode<Real>::update() {
+    if ( this->parent != nullptr ) this->parent->toWorldMatrix();
+    return this->updateSubtree();
+}
+
+typedef TransformationNode<float> TransformationNodef;
+typedef TransformationNode<double> TransformationNoded;
+
+#endif
@@ -30,27 +30,28 @@
 #include <cmath>
 #include <type_traits>
 #include <iomanip>
+#include "MathConstexpr.h"
 
 template <typename Real>
 class Vector2;
 
 template <typename Real>
-Vector2<Real> operator + (const Vector2<Real>& u, const Vector2<Real>& v);
+MATH_CONSTEXPR Vector2<Real> operator + (const Vector2<Real>& u, const Vector2<Real>& v);
 
 template <typename Real>
-Vector2<Real> operator - (const Vector2<Real>& u, const Vector2<Real>& v);
+MATH_CONSTEXPR Vector2<Real> operator - (const Vector2<Real>& u, const Vector2<Real>& v);
 
 template <typename Real>
-Vector2<Real> operator - (const Vector2<Real>& v);
+MATH_CONSTEXPR Vector2<Real> operator - (const Vector2<Real>& v);
 
 template <typename Real>
-Vector2<Real> operator * (const Vector2<Real>& v, Real scalar);
+MATH_CONSTEXPR Vector2<Real> operator * (const Vector2<Real>& v, Real scalar);
 
 template <typename Real>
-Vector2<Real> operator * (Real scalar, const Vector2<Real>& v);
+MATH_CONSTEXPR Vector2<Real> operator * (Real scalar, const Vector2<Real>& v);
 
 template <typename Real>
-Vector2<Real> operator / (const Vector2<Real>& v, Real scalar);
+MATH_CONSTEXPR Vector2<Real> operator / (const Vector2<Real>& v, Real scalar);
 
 template <typename Real>
 std::ostream& operator << (std::ostream& out, const Vector2<Real>& vector);
@@ -80,61 +81,59 @@ class Vector2 {
     enum Axis { X, Y, COMPONENT_COUNT };
 
 public:
-    Vector2(Real x = Real(0), Real y = Real(0));
-    Vector2(const Vector2<Real>& v);
-    Vector2(Real v[2]);
-    Vector2(const Vector2<Real>& from, const Vector2<Real>& to);
-    ~Vector2();
-
-    void add(const Vector2<Real>& v);
-    void subtract(const Vector2<Real>& v);
-    void multiply(Real scalar);
+    MATH_CONSTEXPR Vector2(Real x = Real(0), Real y = Real(0));
+    MATH_CONSTEXPR Vector2(Real v[2]);
+    MATH_CONSTEXPR Vector2(const Vector2<Real>& from, const Vector2<Real>& to);
+
+    MATH_CONSTEXPR void add(const Vector2<Real>& v);
+    MATH_CONSTEXPR void subtract(const Vector2<Real>& v);
+    MATH_CONSTEXPR void multiply(Real scalar);
     void normalize();
-    void inverse();
+    MATH_CONSTEXPR void inverse();
     
-    void zero();
-    bool isZero(Real epsilon);
+    MATH_CONSTEXPR void zero();
+    MATH_CONSTEXPR bool isZero(Real epsilon);
     bool isEqual(const Vector2<Real>& v);
-    bool isEquivalent(const Vector2<Real>& v, Real epsilon) const;
+    MATH_CONSTEXPR bool isEquivalent(const Vector2<Real>& v, Real epsilon) const;
 
     template <typename RealCastType>
     Vector2<RealCastType> cast();
 
     Vector2<Real> normalized() const;
     Vector2<Real> linearInterpolation(const Vector2<Real>& v, Real t);
-    double dot(const Vector2<Real>& v) const;
+    MATH_CONSTEXPR double dot(const Vector2<Real>& v) const;
     
     double angle(const Vector2<Real>& v) const;
     double magnitude() const;
     double length() const;
-    double lengthSquared() const;
+    MATH_CONSTEXPR double lengthSquared() const;
     double norm() const;
-    double normSquared() const;
+    MATH_CONSTEXPR double normSquared() const;
     double distance(const Vector2<Real>& v) const;
-    double distanceSquared(const Vector2<Real>& v) const;
+    MATH_CONSTEXPR double distanceSquared(const Vector2<Real>& v) const;
 
-    void set(Real x, Real y);
-    void set(const Vector2<Real>& v);
-    void setX(Real x);
-    void setY(Real y);
+    MATH_CONSTEXPR void set(Real x, Real y);
+    MATH_CONSTEXPR void set(const Vector2<Real>& v);
+    MATH_CONSTEXPR void setX(Real x);
+    MATH_CONSTEXPR void setY(Real y);
 
-    const Real& getX() const;
-    const Real& getY() const;
-    const Real& x() const;
-	const Real& y() const;
+    MATH_CONSTEXPR const Real& getX() const;
+    MATH_CONSTEXPR const Real& getY() const;
+    MATH_CONSTEXPR const Real& x() const;
+	MATH_CONSTEXPR const Real& y() const;
 	
-    Real& getX();
-    Real& getY();
-	Real& x();
-	Real& y();
+    MATH_CONSTEXPR Real& getX();
+    MATH_CONSTEXPR Real& getY();
+	MATH_CONSTEXPR Real& x();
+	MATH_CONSTEXPR Real& y();
 
-    const Real* const constData() const;
+    MATH_CONSTEXPR const Real* const constData() const;
     operator const Real* const () const;
     Real operator () (const Vector2<Real>& v) const;
     bool operator () (const Vector2<Real>& u, const Vector2<Real>& v) const;
 
-    Real& operator [] (std::size_t index);
-    const Real& operator [] (std::size_t index) const;
+    MATH_CONSTEXPR Real& operator [] (std::size_t index);
+    MATH_CONSTEXPR const Real& operator [] (std::size_t index) const;
 
     friend Vector2<Real> operator + <> (const Vector2<Real>& u, const Vector2<Real>& v);
     friend Vector2<Real> operator - <> (const Vector2<Real>& u, const Vector2<Real>& v);
@@ -146,94 +145,83 @@ public:
     friend std::ostream& operator << <> (std::ostream& out, const Vector2<Real>& v);
     friend std::istream& operator >> <> (std::istream& in, Vector2<Real>& v);
 
-    Vector2<Real> operator - (const Vector2<Real>& v) const;
-	Vector2<Real> operator + (const Vector2<Real>& v) const;
-	Vector2<Real> operator * (const Real& scalar) const;
-	Vector2<Real> operator * (const Vector2<Real>& v) const;
-
-    Vector2<Real>& operator = (const Vector2<Real>& v);
+    MATH_CONSTEXPR Vector2<Real> operator - (const Vector2<Real>& v) const;
+	MATH_CONSTEXPR Vector2<Real> operator + (const Vector2<Real>& v) const;
+	MATH_CONSTEXPR Vector2<Real> operator * (const Real& scalar) const;
+	MATH_CONSTEXPR Vector2<Real> operator * (const Vector2<Real>& v) const;
 
-    Vector2<Real>& operator += (const Vector2<Real>& v);
-    Vector2<Real>& operator -= (const Vector2<Real>& v);
-    Vector2<Real>& operator *= (const Vector2<Real>& v);
-    Vector2<Real>& operator *= (Real scalar);
+    MATH_CONSTEXPR Vector2<Real>& operator += (const Vector2<Real>& v);
+    MATH_CONSTEXPR Vector2<Real>& operator -= (const Vector2<Real>& v);
+    MATH_CONSTEXPR Vector2<Real>& operator *= (const Vector2<Real>& v);
+    MATH_CONSTEXPR Vector2<Real>& operator *= (Real scalar);
 
-    bool operator == (const Vector2<Real>& v) const;
-	bool operator != (const Vector2<Real>& v) const;
+    MATH_CONSTEXPR bool operator == (const Vector2<Real>& v) const;
+	MATH_CONSTEXPR bool operator != (const Vector2<Real>& v) const;
 	
     bool operator < (const Vector2<Real>& v);
     bool operator <= (const Vector2<Real>& v);
     bool operator > (const Vector2<Real>& v);
     bool operator >= (const Vector2<Real>& v);
 
-    static Vector2<Real> Add(const Vector2<Real>& u, const Vector2<Real>& v);
-    static Vector2<Real> Subtract(const Vector2<Real>& u, const Vector2<Real>& v);
-    static Vector2<Real> Multiply(Real scalar, const Vector2<Real>& v);
+    static MATH_CONSTEXPR Vector2<Real> Add(const Vector2<Real>& u, const Vector2<Real>& v);
+    static MATH_CONSTEXPR Vector2<Real> Subtract(const Vector2<Real>& u, const Vector2<Real>& v);
+    static MATH_CONSTEXPR Vector2<Real> Multiply(Real scalar, const Vector2<Real>& v);
     static Vector2<Real> Normalize(const Vector2<Real>& v);
     static Vector2<Real> LinearInterpolation(const Vector2<Real>& u, const Vector2<Real>& v, Real t);
     static Vector2<Real> Project(const Vector2<Real>& u, const Vector2<Real>& v);
 
     static double Angle(const Vector2<Real>& u, const Vector2<Real>& v);
-    static double Dot(const Vector2<Real>& u, const Vector2<Real>& v);
+    static MATH_CONSTEXPR double Dot(const Vector2<Real>& u, const Vector2<Real>& v);
     static double Magnitude(const Vector2<Real>& v);
     static double Norm(const Vector2<Real>& v);
-    static double NormSquared(const Vector2<Real>& v);
+    static MATH_CONSTEXPR double NormSquared(const Vector2<Real>& v);
     static double Length(const Vector2<Real>& v);
-    static double LengthSquared(const Vector2<Real>& v);
+    static MATH_CONSTEXPR double LengthSquared(const Vector2<Real>& v);
     static double Distance(const Vector2<Real>& u, const Vector2<Real>& v);
-    static double DistanceSquared(const Vector2<Real>& u, const Vector2<Real>& v);
+    static MATH_CONSTEXPR double DistanceSquared(const Vector2<Real>& u, const Vector2<Real>& v);
 
-    static Vector2<Real> Zero();
-	static Vector2<Real> UnitX();
-	static Vector2<Real> UnitY();
-    static Vector2<Real> UnitNX();
-    static Vector2<Real> UnitNY();
+    static MATH_CONSTEXPR Vector2<Real> Zero();
+	static MATH_CONSTEXPR Vector2<Real> UnitX();
+	static MATH_CONSTEXPR Vector2<Real> UnitY();
+    static MATH_CONSTEXPR Vector2<Real> UnitNX();
+    static MATH_CONSTEXPR Vector2<Real> UnitNY();
 
 protected:
     Real data[COMPONENT_COUNT];
 };
 
 template <typename Real>
-Vector2<Real>::Vector2(Real x, Real y) {
+MATH_CONSTEXPR Vector2<Real>::Vector2(Real x, Real y) : data() {
     this->data[X] = x;
     this->data[Y] = y;
 }
 
 template <typename Real>
-Vector2<Real>::Vector2(const Vector2<Real>& v) {
-    this->data[X] = v.data[X];
-    this->data[Y] = v.data[Y];
-}
-
-template <typename Real>
-Vector2<Real>::Vector2(Real v[2]) {
+MATH_CONSTEXPR Vector2<Real>::Vector2(Real v[2]) : data() {
     this->data[X] = v[0];
     this->data[Y] = v[1];
 }
 
 template <typename Real>
-Vector2<Real>::Vector2(const Vector2<Real>& from, const Vector2<Real>& to) {
+MATH_CONSTEXPR Vector2<Real>::Vector2(const Vector2<Real>& from, const Vector2<Real>& to) : data() {
     this->data[X] = to.data[X] - from.data[X];
     this->data[Y] = to.data[Y] - from.data[Y];
 }
 
 template <typename Real>
-Vector2<Real>::~Vector2() {}
-
-template <typename Real>
-void Vector2<Real>::add(const Vector2<Real>& v) {
+MATH_CONSTEXPR void Vector2<Real>::add(const Vector2<Real>& v) {
     this->data[X] += v.data[X];
     this->data[Y] += v.data[Y];
 }
 
 template <typename Real>
-void Vector2<Real>::subtract(const Vector2<Real>& v) {
+MATH_CONSTEXPR void Vector2<Real>::subtract(const Vector2<Real>& v) {
     this->data[X] -= v.data[X];
     this->data[Y] -= v.data[Y];
 }
 
 template <typename Real>
-void Vector2<Real>::multiply(Real scalar) {
+MATH_CONSTEXPR void Vector2<Real>::multiply(Real scalar) {
     this->data[X] *= scalar;
     this->data[y] *= scalar;
 }
@@ -246,19 +234,19 @@ void Vector2<Real>::normalize() {
 }
 
 template <typename Real>
-void Vector2<Real>::inverse() {
+MATH_CONSTEXPR void Vector2<Real>::inverse() {
     this->data[X] = -this->data[X];
     this->data[Y] = -this->data[Y];
 }
     
 template <typename Real>
-void Vector2<Real>::zero() {
+MATH_CONSTEXPR void Vector2<Real>::zero() {
     this->data[X] = Real(0);
     this->data[Y] = Real(0);
 }
 
 template <typename Real>
-bool Vector2<Real>::isZero(Real epsilon) {
+MATH_CONSTEXPR bool Vector2<Real>::isZero(Real epsilon) {
     if ( (this->data[X] > -epsilon) && 
          (this->data[X] < epsilon ) &&
          (this->data[Y] > -epsilon) &&
@@ -274,7 +262,7 @@ bool Vector2<Real>::isEqual(const Vector2<Real>& v) {
 }
 
 template <typename Real>
-bool Vector2<Real>::isEquivalent(const Vector2<Real>& v, Real epsilon) const {
+MATH_CONSTEXPR bool Vector2<Real>::isEquivalent(const Vector2<Real>& v, Real epsilon) const {
     for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
         if ( this->data[i] < (v.data[i] - epsilon) || this->data[i] > (v.data[i] + epsilon) ) return false;
     return true;
@@ -297,7 +285,7 @@ Vector2<Real> Vector2<Real>::linearInterpolation(const Vector2<Real>& v, Real t)
 }
 
 template <typename Real>
-double Vector2<Real>::dot(const Vector2<Real>& v) const {
+MATH_CONSTEXPR double Vector2<Real>::dot(const Vector2<Real>& v) const {
     return Vector2<Real>::Dot(*this, v);
 }
     
@@ -317,7 +305,7 @@ double Vector2<Real>::length() const {
 }
 
 template <typename Real>
-double Vector2<Real>::lengthSquared() const {
+MATH_CONSTEXPR double Vector2<Real>::lengthSquared() const {
     return Vector2<Real>::LengthSquared(*this);
 }
 
@@ -327,7 +315,7 @@ double Vector2<Real>::norm() const {
 }
 
 template <typename Real>
-double Vector2<Real>::normSquared() const {
+MATH_CONSTEXPR double Vector2<Real>::normSquared() const {
     return Vector2<Real>::NormSquared(*this);
 }
 
@@ -337,74 +325,74 @@ double Vector2<Real>::distance(const Vector2<Real>& v) const {
 }
 
 template <typename Real>
-double Vector2<Real>::distanceSquared(const Vector2<Real>& v) const {
+MATH_CONSTEXPR double Vector2<Real>::distanceSquared(const Vector2<Real>& v) const {
     return Vector2<Real>::DistanceSquared(*this, v);
 }
 
 template <typename Real>
-void Vector2<Real>::set(Real x, Real y) {
+MATH_CONSTEXPR void Vector2<Real>::set(Real x, Real y) {
     this->data[X] = x;
     this->data[Y] = y;
 }
 
 template <typename Real>
-void Vector2<Real>::set(const Vector2<Real>& v) {
+MATH_CONSTEXPR void Vector2<Real>::set(const Vector2<Real>& v) {
     this->data[X] = v.data[X];
     this->data[Y] = v.data[Y];
 }
 
 template <typename Real>
-void Vector2<Real>::setX(Real x) {
-    this->data[Y] = y;
+MATH_CONSTEXPR void Vector2<Real>::setX(Real x) {
+    this->data[X] = x;
 }
 
 template <typename Real>
-void Vector2<Real>::setY(Real y) {
+MATH_CONSTEXPR void Vector2<Real>::setY(Real y) {
     this->data[Y] = y;
 }
 
 template <typename Real>
-const Real& Vector2<Real>::getX() const {
+MATH_CONSTEXPR const Real& Vector2<Real>::getX() const {
     return this->data[X];
 }
 
 template <typename Real>
-const Real& Vector2<Real>::getY() const {
+MATH_CONSTEXPR const Real& Vector2<Real>::getY() const {
     return this->data[Y];
 }
 
 template <typename Real>
-const Real& Vector2<Real>::x() const {
+MATH_CONSTEXPR const Real& Vector2<Real>::x() const {
     return this->data[X];
 }
 
 template <typename Real>
-const Real& Vector2<Real>::y() const {
+MATH_CONSTEXPR const Real& Vector2<Real>::y() const {
     return this->data[Y];
 }
 	
 template <typename Real>
-Real& Vector2<Real>::getX() {
+MATH_CONSTEXPR Real& Vector2<Real>::getX() {
     return this->data[X];
 }
 
 template <typename Real>
-Real& Vector2<Real>::getY() {
+MATH_CONSTEXPR Real& Vector2<Real>::getY() {
     return this->data[Y];
 }
 
 template <typename Real>
-Real& Vector2<Real>::x() {
+MATH_CONSTEXPR Real& Vector2<Real>::x() {
     return this->data[X];
 }
 
 template <typename Real>
-Real& Vector2<Real>::y() {
+MATH_CONSTEXPR Real& Vector2<Real>::y() {
     return this->data[Y];
 }
 
 template <typename Real>
-const Real* const Vector2<Real>::constData() const {
+MATH_CONSTEXPR const Real* const Vector2<Real>::constData() const {
     return this->data;
 }
 
@@ -425,19 +413,19 @@ bool Vector2<Real>::operator () (const Vector2<Real>& u, const Vector2<Real>& v)
 }
 
 template <typename Real>
-Real& Vector2<Real>::operator [] (std::size_t index) {
+MATH_CONSTEXPR Real& Vector2<Real>::operator [] (std::size_t index) {
     if ( index >= COMPONENT_COUNT ) throw std::exception("[Vector2:[]] Error: Index out of bounds.");
     return this->data[index];
 }
 
 template <typename Real>
-const Real& Vector2<Real>::operator [] (std::size_t index) const {
+MATH_CONSTEXPR const Real& Vector2<Real>::operator [] (std::size_t index) const {
     if ( index >= COMPONENT_COUNT ) throw std::exception("[Vector2:[]] Error: Index out of bounds.");
     return this->data[index];
 }
 
 template <typename Real>
-Vector2<Real> operator + (const Vector2<Real>& u, const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real> operator + (const Vector2<Real>& u, const Vector2<Real>& v) {
     Vector2<Real> result;
     result.data[Vector2<Real>::X] = u.data[Vector2<Real>::X] + v.data[Vector2<Real>::X];
     result.data[Vector2<Real>::Y] = u.data[Vector2<Real>::Y] + v.data[Vector2<Real>::Y];
@@ -445,7 +433,7 @@ Vector2<Real> operator + (const Vector2<Real>& u, const Vector2<Real>& v) {
 }
 
 template <typename Real>
-Vector2<Real> operator - (const Vector2<Real>& u, const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real> operator - (const Vector2<Real>& u, const Vector2<Real>& v) {
     Vector2<Real> result;
     result.data[Vector2<Real>::X] = u.data[Vector2<Real>::X] - v.data[Vector2<Real>::X];
     result.data[Vector2<Real>::Y] = u.data[Vector2<Real>::Y] - v.data[Vector2<Real>::Y];
@@ -453,12 +441,12 @@ Vector2<Real> operator - (const Vector2<Real>& u, const Vector2<Real>& v) {
 }
 
 template <typename Real>
-Vector2<Real> operator - (const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real> operator - (const Vector2<Real>& v) {
     return Vector2<Real>(-v.data[Vector2<Real>::X], -v.data[Vector2<Real>::Y]);
 }
 
 template <typename Real>
-Vector2<Real> operator * (const Vector2<Real>& v, Real scalar) {
+MATH_CONSTEXPR Vector2<Real> operator * (const Vector2<Real>& v, Real scalar) {
     Vector2<Real> result;
     result.data[Vector2<Real>::X] = v.data[Vector2<Real>::X] * scalar;
     result.data[Vector2<Real>::Y] = v.data[Vector2<Real>::Y] * scalar;
@@ -466,7 +454,7 @@ Vector2<Real> operator * (const Vector2<Real>& v, Real scalar) {
 }
 
 template <typename Real>
-Vector2<Real> operator * (Real scalar, const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real> operator * (Real scalar, const Vector2<Real>& v) {
     Vector2<Real> result;
     result.data[Vector2<Real>::X] = scalar * v.data[Vector2<Real>::X];
     result.data[Vector2<Real>::Y] = scalar * v.data[Vector2<Real>::Y];
@@ -474,7 +462,7 @@ Vector2<Real> operator * (Real scalar, const Vector2<Real>& v) {
 }
 
 template <typename Real>
-Vector2<Real> operator / (const Vector2<Real>& v, Real scalar) {
+MATH_CONSTEXPR Vector2<Real> operator / (const Vector2<Real>& v, Real scalar) {
     Vector2<Real> result;
     result.data[Vector2<Real>::X] = v.data[Vector2<Real>::X] / scalar;
     result.data[Vector2<Real>::Y] = v.data[Vector2<Real>::Y] / scalar;
@@ -496,7 +484,7 @@ std::istream& operator >> (std::istream& in, Vector2<Real>& v) {
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::operator - (const Vector2<Real>& v) const {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::operator - (const Vector2<Real>& v) const {
     Vector2<Real> result;
     result.data[X] = this->data[X] - v.data[X];
     result.data[Y] = this->data[Y] - v.data[Y];
@@ -504,7 +492,7 @@ Vector2<Real> Vector2<Real>::operator - (const Vector2<Real>& v) const {
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::operator + (const Vector2<Real>& v) const {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::operator + (const Vector2<Real>& v) const {
     Vector2<Real> result;
     result.data[X] = this->data[X] + v.data[X];
     result.data[Y] = this->data[Y] + v.data[Y];
@@ -512,7 +500,7 @@ Vector2<Real> Vector2<Real>::operator + (const Vector2<Real>& v) const {
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::operator * (const Real& scalar) const {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::operator * (const Real& scalar) const {
     Vector2<Real> result;
     result.data[X] = this->data[X] * scalar;
     result.data[Y] = this->data[Y] * scalar;
@@ -520,7 +508,7 @@ Vector2<Real> Vector2<Real>::operator * (const Real& scalar) const {
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::operator * (const Vector2<Real>& v) const {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::operator * (const Vector2<Real>& v) const {
     Vector2<Real> result;
     result.data[X] = this->data[X] * v.data[X];
     result.data[Y] = this->data[Y] * v.data[Y];
@@ -528,51 +516,43 @@ Vector2<Real> Vector2<Real>::operator * (const Vector2<Real>& v) const {
 }
 
 template <typename Real>
-Vector2<Real>& Vector2<Real>::operator = (const Vector2<Real>& v) {
-    if ( this == &v ) return *this;
-    this->data[X] = v.data[X];
-    this->data[Y] = v.data[Y];
-    return *this;
-}
-
-template <typename Real>
-Vector2<Real>& Vector2<Real>::operator += (const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real>& Vector2<Real>::operator += (const Vector2<Real>& v) {
     this->data[X] += v.data[X];
     this->data[Y] += v.data[Y];
     return *this;
 }
 
 template <typename Real>
-Vector2<Real>& Vector2<Real>::operator -= (const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real>& Vector2<Real>::operator -= (const Vector2<Real>& v) {
     this->data[X] -= v.data[X];
     this->data[Y] -= v.data[Y];
     return *this;
 }
 
 template <typename Real>
-Vector2<Real>& Vector2<Real>::operator *= (const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real>& Vector2<Real>::operator *= (const Vector2<Real>& v) {
     this->data[X] *= v.data[X];
     this->data[Y] *= v.data[Y];
     return *this;
 }
 
 template <typename Real>
-Vector2<Real>& Vector2<Real>::operator *= (Real scalar) {
+MATH_CONSTEXPR Vector2<Real>& Vector2<Real>::operator *= (Real scalar) {
     this->data[X] *= scalar;
     this->data[Y] *= scalar;
     return *this;
 }
 
 template <typename Real>
-bool Vector2<Real>::operator == (const Vector2<Real>& v) const {
+MATH_CONSTEXPR bool Vector2<Real>::operator == (const Vector2<Real>& v) const {
     if ( this->data[X] == v.data[X] && 
          this->data[Y] == v.data[Y] ) return true;
     return false;
 }
 
 template <typename Real>
-bool Vector2<Real>::operator != (const Vector2<Real>& v) const {
-    return !(*this == vector);
+MATH_CONSTEXPR bool Vector2<Real>::operator != (const Vector2<Real>& v) const {
+    return !(*this == v);
 }
 	
 template <typename Real>
@@ -600,7 +580,7 @@ bool Vector2<Real>::operator >= (const Vector2<Real>& v) {
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::Add(const Vector2<Real>& u, const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::Add(const Vector2<Real>& u, const Vector2<Real>& v) {
     Vector2<Real> result;
     result.data[X] = u.data[X] + v.data[X];
     result.data[Y] = u.data[Y] + v.data[Y];
@@ -608,7 +588,7 @@ Vector2<Real> Vector2<Real>::Add(const Vector2<Real>& u, const Vector2<Real>& v)
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::Subtract(const Vector2<Real>& u, const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::Subtract(const Vector2<Real>& u, const Vector2<Real>& v) {
     Vector2<Real> result;
     result.data[X] = u.data[X] - v.data[X];
     result.data[Y] = u.data[Y] - v.data[Y];
@@ -616,7 +596,7 @@ Vector2<Real> Vector2<Real>::Subtract(const Vector2<Real>& u, const Vector2<Real
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::Multiply(Real scalar, const Vector2<Real>& v) {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::Multiply(Real scalar, const Vector2<Real>& v) {
     Vector2<Real> result;
     result.data[X] = scalar * v.data[X];
     result.data[Y] = scalar * v.data[Y];
@@ -652,7 +632,7 @@ double Vector2<Real>::Angle(const Vector2<Real>& u, const Vector2<Real>& v) {
 }
 
 template <typename Real>
-double Vector2<Real>::Dot(const Vector2<Real>& u, const Vector2<Real>& v) {
+MATH_CONSTEXPR double Vector2<Real>::Dot(const Vector2<Real>& u, const Vector2<Real>& v) {
     return u.data[X] * v.data[X] + u.data[Y] * v.data[Y];
 }
 
@@ -667,8 +647,8 @@ double Vector2<Real>::Norm(const Vector2<Real>& v) {
 }
 
 template <typename Real>
-double Vector2<Real>::NormSquared(const Vector2<Real>& v) {
-    return std::pow(v.data[X], Real(2)) + std::pow(v.data[Y], Real(2));
+MATH_CONSTEXPR double Vector2<Real>::NormSquared(const Vector2<Real>& v) {
+    return v.data[X] * v.data[X] + v.data[Y] * v.data[Y];
 }
 
 template <typename Real>
@@ -677,8 +657,8 @@ double Vector2<Real>::Length(const Vector2<Real>& v) {
 }
 
 template <typename Real>
-double Vector2<Real>::LengthSquared(const Vector2<Real>& v) {
-    return std::pow(v.data[X], Real(2)) + std::pow(v.data[Y], Real(2));
+MATH_CONSTEXPR double Vector2<Real>::LengthSquared(const Vector2<Real>& v) {
+    return v.data[X] * v.data[X] + v.data[Y] * v.data[Y];
 }
 
 template <typename Real>
@@ -687,32 +667,32 @@ double Vector2<Real>::Distance(const Vector2<Real>& u, const Vector2<Real>& v) {
 }
 
 template <typename Real>
-double Vector2<Real>::DistanceSquared(const Vector2<Real>& u, const Vector2<Real>& v) {
-    return std::pow(u.data[X] - v.data[X], Real(2)) + std::pow(u.data[Y] - v.data[Y], Real(2));
+MATH_CONSTEXPR double Vector2<Real>::DistanceSquared(const Vector2<Real>& u, const Vector2<Real>& v) {
+    return (u.data[X] - v.data[X]) * (u.data[X] - v.data[X]) + (u.data[Y] - v.data[Y]) * (u.data[Y] - v.data[Y]);
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::Zero() {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::Zero() {
     return Vector2<Real>();
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::UnitX() {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::UnitX() {
     return Vector2<Real>(Real(1), Real(0));
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::UnitY() {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::UnitY() {
     return Vector2<Real>(Real(0), Real(1));
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::UnitNX() {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::UnitNX() {
     return Vector2<Real>(Real(-1), Real(0));
 }
 
 template <typename Real>
-Vector2<Real> Vector2<Real>::UnitNY() {
+MATH_CONSTEXPR Vector2<Real> Vector2<Real>::UnitNY() {
     return Vector2<Real>(Real(0), Real(-1));
 }
 
@@ -30,27 +30,29 @@
 #include <cmath>
 #include <type_traits>
 #include <iomanip>
+#include "MathConstexpr.h"
+#include "SimdMath.h"
 
 template <typename Real>
 class Vector3;
 
 template <typename Real>
-Vector3<Real> operator + (const Vector3<Real>& u, const Vector3<Real>& v);
+MATH_CONSTEXPR Vector3<Real> operator + (const Vector3<Real>& u, const Vector3<Real>& v);
 
 template <typename Real>
-Vector3<Real> operator - (const Vector3<Real>& u, const Vector3<Real>& v);
+MATH_CONSTEXPR Vector3<Real> operator - (const Vector3<Real>& u, const Vector3<Real>& v);
 
 template <typename Real>
-Vector3<Real> operator - (const Vector3<Real>& v);
+MATH_CONSTEXPR Vector3<Real> operator - (const Vector3<Real>& v);
 
 template <typename Real>
-Vector3<Real> operator * (const Vector3<Real>& v, Real scalar);
+MATH_CONSTEXPR Vector3<Real> operator * (const Vector3<Real>& v, Real scalar);
 
 template <typename Real>
-Vector3<Real> operator * (Real scalar, const Vector3<Real>& v);
+MATH_CONSTEXPR Vector3<Real> operator * (Real scalar, const Vector3<Real>& v);
 
 template <typename Real>
-Vector3<Real> operator / (const Vector3<Real>& v, Real scalar);
+MATH_CONSTEXPR Vector3<Real> operator / (const Vector3<Real>& v, Real scalar);
 
 template <typename Real>
 std::ostream& operator << (std::ostream& out, const Vector3<Real>& vector);
@@ -68,7 +70,8 @@ std::istream& operator >> (std::istream& in, Vector3<Real>& vector);
  * template meta programming.
  * See: http://www.flipcode.com/archives/Faster_Vector_Math_Using_Templates.shtml
  *
- * This implementation also foregoes vectorization (SSE).
+ * This implementation also foregoes vectorization (SSE) except for the float
+ * normalization at the end of this file (see SimdMath.h).
  * This implementation is aimed at a flexibility while preserving 
  * understandability and complete modularity.
  */
@@ -80,70 +83,68 @@ class Vector3 {
     enum Axis { X, Y, Z, COMPONENT_COUNT };
 
 public:
-    Vector3(Real x = Real(0), Real y = Real(0), Real z = Real(0));
-    Vector3(const Vector3<Real>& v);
-    Vector3(Real v[3]);
-    Vector3(const Vector3<Real>& from, const Vector3<Real>& to);
-    ~Vector3();
-
-    void add(const Vector3<Real>& v);
-    void subtract(const Vector3<Real>& v);
-    void multiply(Real scalar);
+    MATH_CONSTEXPR Vector3(Real x = Real(0), Real y = Real(0), Real z = Real(0));
+    MATH_CONSTEXPR Vector3(Real v[3]);
+    MATH_CONSTEXPR Vector3(const Vector3<Real>& from, const Vector3<Real>& to);
+
+    MATH_CONSTEXPR void add(const Vector3<Real>& v);
+    MATH_CONSTEXPR void subtract(const Vector3<Real>& v);
+    MATH_CONSTEXPR void multiply(Real scalar);
     void normalize();
-    void inverse();
+    MATH_CONSTEXPR void inverse();
     
-    void zero();
-    bool isZero(Real epsilon);
+    MATH_CONSTEXPR void zero();
+    MATH_CONSTEXPR bool isZero(Real epsilon);
     bool isEqual(const Vector3<Real>& v);
-    bool isEquivalent(const Vector3<Real>& v, Real epsilon) const;
+    MATH_CONSTEXPR bool isEquivalent(const Vector3<Real>& v, Real epsilon) const;
 
     template <typename RealCastType>
     Vector3<RealCastType> cast();
 
     Vector3<Real> normalized() const;
-    Vector3<Real> cross(const Vector3<Real>& v) const;
+    MATH_CONSTEXPR Vector3<Real> cross(const Vector3<Real>& v) const;
     Vector3<Real> linearInterpolation(const Vector3<Real>& v, Real t);
-    double dot(const Vector3<Real>& v) const;
+    MATH_CONSTEXPR double dot(const Vector3<Real>& v) const;
     
     double angle(const Vector3<Real>& v) const;
     double magnitude() const;
     double length() const;
-    double lengthSquared() const;
+    MATH_CONSTEXPR double lengthSquared() const;
     double norm() const;
-    double normSquared() const;
+    MATH_CONSTEXPR double normSquared() const;
     double distance(const Vector3<Real>& v) const;
-    double distanceSquared(const Vector3<Real>& v) const;
+    MATH_CONSTEXPR double distanceSquared(const Vector3<Real>& v) const;
 
     void swapXY();
     void swapXZ();
     void swapYZ();
 
-    void set(Real x, Real y, Real z);
-    void set(const Vector3<Real>& v);
-    void setX(Real x);
-    void setY(Real y);
-    void setZ(Real z);
-
-    const Real& getX() const;
-    const Real& getY() const;
-    const Real& getZ() const;
-    const Real& x() const;
-	const Real& y() const;
-	const Real& z() const;
+    MATH_CONSTEXPR void set(Real x, Real y, Real z);
+    MATH_CONSTEXPR void set(const Vector3<Real>& v);
+    MATH_CONSTEXPR void setX(Real x);
+    MATH_CONSTEXPR void setY(Real y);
+    MATH_CONSTEXPR void setZ(Real z);
+
+    MATH_CONSTEXPR const Real& getX() const;
+    MATH_CONSTEXPR const Real& getY() const;
+    MATH_CONSTEXPR const Real& getZ() const;
+    MATH_CONSTEXPR const Real& x() const;
+	MATH_CONSTEXPR const Real& y() const;
+	MATH_CONSTEXPR const Real& z() const;
 	
-    Real& getX();
-    Real& getY();
-    Real& getZ();
-	Real& x();
-	Real& y();
-	Real& z();
-
-    const Real* const constData() const;
+    MATH_CONSTEXPR Real& getX();
+    MATH_CONSTEXPR Real& getY();
+    MATH_CONSTEXPR Real& getZ();
+	MATH_CONSTEXPR Real& x();
+	MATH_CONSTEXPR Real& y();
+	MATH_CONSTEXPR Real& z();
+
+    MATH_CONSTEXPR const Real* const constData() const;
     operator const Real* const () const;
     Real operator () (const Vector3<Real>& v) const;
     bool operator () (const Vector3<Real>& u, const Vector3<Real>& v) const;
 
-    Real& operator [] (std::size_t index);
+    MATH_CONSTEXPR Real& operator [] (std::size_t index);
 
     friend Vector3<Real> operator + <> (const Vector3<Real>& u, const Vector3<Real>& v);
     friend Vector3<Real> operator - <> (const Vector3<Real>& u, const Vector3<Real>& v);
@@ -155,104 +156,92 @@ public:
     friend std::ostream& operator << <> (std::ostream& out, const Vector3<Real>& v);
     friend std::istream& operator >> <> (std::istream& in, Vector3<Real>& v);
 
-    Vector3<Real> operator - (const Vector3<Real>& v) const;
-	Vector3<Real> operator + (const Vector3<Real>& v) const;
-    Vector3<Real> operator / (const Real& scalar) const;
-	Vector3<Real> operator * (const Real& scalar) const;
-	Vector3<Real> operator * (const Vector3<Real>& v) const;
-
-    Vector3<Real>& operator = (const Vector3<Real>& v);
+    MATH_CONSTEXPR Vector3<Real> operator - (const Vector3<Real>& v) const;
+	MATH_CONSTEXPR Vector3<Real> operator + (const Vector3<Real>& v) const;
+    MATH_CONSTEXPR Vector3<Real> operator / (const Real& scalar) const;
+	MATH_CONSTEXPR Vector3<Real> operator * (const Real& scalar) const;
+	MATH_CONSTEXPR Vector3<Real> operator * (const Vector3<Real>& v) const;
 
-    Vector3<Real>& operator += (const Vector3<Real>& v);
-    Vector3<Real>& operator -= (const Vector3<Real>& v);
-    Vector3<Real>& operator *= (const Vector3<Real>& v);
-    Vector3<Real>& operator *= (Real scalar);
+    MATH_CONSTEXPR Vector3<Real>& operator += (const Vector3<Real>& v);
+    MATH_CONSTEXPR Vector3<Real>& operator -= (const Vector3<Real>& v);
+    MATH_CONSTEXPR Vector3<Real>& operator *= (const Vector3<Real>& v);
+    MATH_CONSTEXPR Vector3<Real>& operator *= (Real scalar);
 
-    bool operator == (const Vector3<Real>& v) const;
-	bool operator != (const Vector3<Real>& v) const;
+    MATH_CONSTEXPR bool operator == (const Vector3<Real>& v) const;
+	MATH_CONSTEXPR bool operator != (const Vector3<Real>& v) const;
 	
     bool operator < (const Vector3<Real>& v);
     bool operator <= (const Vector3<Real>& v);
     bool operator > (const Vector3<Real>& v);
     bool operator >= (const Vector3<Real>& v);
 
-    static Vector3<Real> Add(const Vector3<Real>& u, const Vector3<Real>& v);
-    static Vector3<Real> Subtract(const Vector3<Real>& u, const Vector3<Real>& v);
-    static Vector3<Real> Multiply(Real scalar, const Vector3<Real>& v);
+    static MATH_CONSTEXPR Vector3<Real> Add(const Vector3<Real>& u, const Vector3<Real>& v);
+    static MATH_CONSTEXPR Vector3<Real> Subtract(const Vector3<Real>& u, const Vector3<Real>& v);
+    static MATH_CONSTEXPR Vector3<Real> Multiply(Real scalar, const Vector3<Real>& v);
     static Vector3<Real> Normalize(const Vector3<Real>& v);
-    static Vector3<Real> Cross(const Vector3<Real>& u, const Vector3<Real>& v);
+    static MATH_CONSTEXPR Vector3<Real> Cross(const Vector3<Real>& u, const Vector3<Real>& v);
     static Vector3<Real> LinearInterpolation(const Vector3<Real>& u, const Vector3<Real>& v, Real t);
     static Vector3<Real> Project(const Vector3<Real>& u, const Vector3<Real>& v);
 
     static double Angle(const Vector3<Real>& u, const Vector3<Real>& v);
-    static double Dot(const Vector3<Real>& u, const Vector3<Real>& v);
+    static MATH_CONSTEXPR double Dot(const Vector3<Real>& u, const Vector3<Real>& v);
     static double Magnitude(const Vector3<Real>& v);
     static double Norm(const Vector3<Real>& v);
-    static double NormSquared(const Vector3<Real>& v);
+    static MATH_CONSTEXPR double NormSquared(const Vector3<Real>& v);
     static double Length(const Vector3<Real>& v);
-    static double LengthSquared(const Vector3<Real>& v);
+    static MATH_CONSTEXPR double LengthSquared(const Vector3<Real>& v);
     static double Distance(const Vector3<Real>& u, const Vector3<Real>& v);
-    static double DistanceSquared(const Vector3<Real>& u, const Vector3<Real>& v);
+    static MATH_CONSTEXPR double DistanceSquared(const Vector3<Real>& u, const Vector3<Real>& v);
 
-    static Vector3<Real> Zero();
-	static Vector3<Real> UnitX();
-	static Vector3<Real> UnitY();
-	static Vector3<Real> UnitZ();
-    static Vector3<Real> UnitNX();
-    static Vector3<Real> UnitNY();
-    static Vector3<Real> UnitNZ();
+    static MATH_CONSTEXPR Vector3<Real> Zero();
+	static MATH_CONSTEXPR Vector3<Real> UnitX();
+	static MATH_CONSTEXPR Vector3<Real> UnitY();
+	static MATH_CONSTEXPR Vector3<Real> UnitZ();
+    static MATH_CONSTEXPR Vector3<Real> UnitNX();
+    static MATH_CONSTEXPR Vector3<Real> UnitNY();
+    static MATH_CONSTEXPR Vector3<Real> UnitNZ();
 
 protected:
     Real data[COMPONENT_COUNT];
 };
 
 template <typename Real>
-Vector3<Real>::Vector3(Real x, Real y, Real z) {
+MATH_CONSTEXPR Vector3<Real>::Vector3(Real x, Real y, Real z) : data() {
     this->data[X] = x;
     this->data[Y] = y;
     this->data[Z] = z;
 }
 
 template <typename Real>
-Vector3<Real>::Vector3(const Vector3<Real>& v) {
-    this->data[X] = v.data[X];
-    this->data[Y] = v.data[Y];
-    this->data[Z] = v.data[Z];
-}
-
-template <typename Real>
-Vector3<Real>::Vector3(Real v[3]) {
+MATH_CONSTEXPR Vector3<Real>::Vector3(Real v[3]) : data() {
     this->data[X] = v[0];
     this->data[Y] = v[1];
     this->data[Z] = v[2];
 }
 
 template <typename Real>
-Vector3<Real>::Vector3(const Vector3<Real>& from, const Vector3<Real>& to) {
+MATH_CONSTEXPR Vector3<Real>::Vector3(const Vector3<Real>& from, const Vector3<Real>& to) : data() {
     this->data[X] = to.data[X] - from.data[X];
     this->data[Y] = to.data[Y] - from.data[Y];
     this->data[Z] = to.data[Z] - from.data[Z];
 }
 
 template <typename Real>
-Vector3<Real>::~Vector3() {}
-
-template <typename Real>
-void Vector3<Real>::add(const Vector3<Real>& v) {
+MATH_CONSTEXPR void Vector3<Real>::add(const Vector3<Real>& v) {
     this->data[X] += v.data[X];
     this->data[Y] += v.data[Y];
     this->data[Z] += v.data[Z];
 }
 
 template <typename Real>
-void Vector3<Real>::subtract(const Vector3<Real>& v) {
+MATH_CONSTEXPR void Vector3<Real>::subtract(const Vector3<Real>& v) {
     this->data[X] -= v.data[X];
     this->data[Y] -= v.data[Y];
     this->data[Z] -= v.data[Z];
 }
 
 template <typename Real>
-void Vector3<Real>::multiply(Real scalar) {
+MATH_CONSTEXPR void Vector3<Real>::multiply(Real scalar) {
     this->data[X] *= scalar;
     this->data[Y] *= scalar;
     this->data[Z] *= scalar;
@@ -267,21 +256,21 @@ void Vector3<Real>::normalize() {
 }
 
 template <typename Real>
-void Vector3<Real>::inverse() {
+MATH_CONSTEXPR void Vector3<Real>::inverse() {
     this->data[X] = -this->data[X];
     this->data[Y] = -this->data[Y];
     this->data[Z] = -this->data[Z];
 }
     
 template <typename Real>
-void Vector3<Real>::zero() {
+MATH_CONSTEXPR void Vector3<Real>::zero() {
     this->data[X] = Real(0);
     this->data[Y] = Real(0);
     this->data[Z] = Real(0);
 }
 
 template <typename Real>
-bool Vector3<Real>::isZero(Real epsilon) {
+MATH_CONSTEXPR bool Vector3<Real>::isZero(Real epsilon) {
     if ( (this->data[X] > -epsilon) && 
          (this->data[X] < epsilon ) &&
          (this->data[Y] > -epsilon) &&
@@ -299,7 +288,7 @@ bool Vector3<Real>::isEqual(const Vector3<Real>& v) {
 }
 
 template <typename Real>
-bool Vector3<Real>::isEquivalent(const Vector3<Real>& v, Real epsilon) const {
+MATH_CONSTEXPR bool Vector3<Real>::isEquivalent(const Vector3<Real>& v, Real epsilon) const {
     for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
         if ( this->data[i] < (v.data[i] - epsilon) || this->data[i] > (v.data[i] + epsilon) ) return false;
     return true;
@@ -318,7 +307,7 @@ Vector3<Real> Vector3<Real>::normalized() const {
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::cross(const Vector3<Real>& v) const {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::cross(const Vector3<Real>& v) const {
     return Vector3<Real>::Cross(*this, v);
 }
 
@@ -328,7 +317,7 @@ Vector3<Real> Vector3<Real>::linearInterpolation(const Vector3<Real>& v, Real t)
 }
 
 template <typename Real>
-double Vector3<Real>::dot(const Vector3<Real>& v) const {
+MATH_CONSTEXPR double Vector3<Real>::dot(const Vector3<Real>& v) const {
     return Vector3<Real>::Dot(*this, v);
 }
 
@@ -348,7 +337,7 @@ double Vector3<Real>::length() const {
 }
 
 template <typename Real>
-double Vector3<Real>::lengthSquared() const {
+MATH_CONSTEXPR double Vector3<Real>::lengthSquared() const {
     return Vector3<Real>::LengthSquared(*this);
 }
 
@@ -358,7 +347,7 @@ double Vector3<Real>::norm() const {
 }
 
 template <typename Real>
-double Vector3<Real>::normSquared() const {
+MATH_CONSTEXPR double Vector3<Real>::normSquared() const {
     return Vector3<Real>::NormSquared(*this);
 }
 
@@ -368,7 +357,7 @@ double Vector3<Real>::distance(const Vector3<Real>& v) const {
 }
 
 template <typename Real>
-double Vector3<Real>::distanceSquared(const Vector3<Real>& v) const {
+MATH_CONSTEXPR double Vector3<Real>::distanceSquared(const Vector3<Real>& v) const {
     return Vector3<Real>::DistanceSquared(*this, v);
 }
 
@@ -388,96 +377,96 @@ void Vector3<Real>::swapYZ() {
 }
 
 template <typename Real>
-void Vector3<Real>::set(Real x, Real y, Real z) {
+MATH_CONSTEXPR void Vector3<Real>::set(Real x, Real y, Real z) {
     this->data[X] = x;
     this->data[Y] = y;
     this->data[Z] = z;
 }
 
 template <typename Real>
-void Vector3<Real>::set(const Vector3<Real>& v) {
+MATH_CONSTEXPR void Vector3<Real>::set(const Vector3<Real>& v) {
     this->data[X] = v.data[X];
     this->data[Y] = v.data[Y];
     this->data[Z] = v.data[Z];
 }
 
 template <typename Real>
-void Vector3<Real>::setX(Real x) {
-    this->data[X];
+MATH_CONSTEXPR void Vector3<Real>::setX(Real x) {
+    this->data[X] = x;
 }
 
 template <typename Real>
-void Vector3<Real>::setY(Real y) {
-    this->data[Y];
+MATH_CONSTEXPR void Vector3<Real>::setY(Real y) {
+    this->data[Y] = y;
 }
 
 template <typename Real>
-void Vector3<Real>::setZ(Real z) {
-    this->data[Z];
+MATH_CONSTEXPR void Vector3<Real>::setZ(Real z) {
+    this->data[Z] = z;
 }
 
 template <typename Real>
-const Real& Vector3<Real>::getX() const {
+MATH_CONSTEXPR const Real& Vector3<Real>::getX() const {
     return this->data[X];
 }
 
 template <typename Real>
-const Real& Vector3<Real>::getY() const {
+MATH_CONSTEXPR const Real& Vector3<Real>::getY() const {
     return this->data[Y];
 }
 
 template <typename Real>
-const Real& Vector3<Real>::getZ() const {
+MATH_CONSTEXPR const Real& Vector3<Real>::getZ() const {
     return this->data[Z];
 }
 
 template <typename Real>
-const Real& Vector3<Real>::x() const {
+MATH_CONSTEXPR const Real& Vector3<Real>::x() const {
     return this->data[X];
 }
 
 template <typename Real>
-const Real& Vector3<Real>::y() const {
+MATH_CONSTEXPR const Real& Vector3<Real>::y() const {
     return this->data[Y];
 }
 
 template <typename Real>
-const Real& Vector3<Real>::z() const {
+MATH_CONSTEXPR const Real& Vector3<Real>::z() const {
     return this->data[Z];
 }
 	
 template <typename Real>
-Real& Vector3<Real>::getX() {
+MATH_CONSTEXPR Real& Vector3<Real>::getX() {
     return this->data[X];
 }
 
 template <typename Real>
-Real& Vector3<Real>::getY() {
+MATH_CONSTEXPR Real& Vector3<Real>::getY() {
     return this->data[Y];
 }
 
 template <typename Real>
-Real& Vector3<Real>::getZ() {
+MATH_CONSTEXPR Real& Vector3<Real>::getZ() {
     return this->data[Z];
 }
 
 template <typename Real>
-Real& Vector3<Real>::x() {
+MATH_CONSTEXPR Real& Vector3<Real>::x() {
     return this->data[X];
 }
 
 template <typename Real>
-Real& Vector3<Real>::y() {
+MATH_CONSTEXPR Real& Vector3<Real>::y() {
     return this->data[Y];
 }
 
 template <typename Real>
-Real& Vector3<Real>::z() {
+MATH_CONSTEXPR Real& Vector3<Real>::z() {
     return this->data[Z];
 }
 
 template <typename Real>
-const Real* const Vector3<Real>::constData() const {
+MATH_CONSTEXPR const Real* const Vector3<Real>::constData() const {
     return this->data;
 }
 
@@ -498,13 +487,13 @@ bool Vector3<Real>::operator () (const Vector3<Real>& u, const Vector3<Real>& v)
 }
 
 template <typename Real>
-Real& Vector3<Real>::operator [] (std::size_t index) {
+MATH_CONSTEXPR Real& Vector3<Real>::operator [] (std::size_t index) {
     if ( index >= COMPONENT_COUNT ) throw std::exception("[Vector3:[]] Error: Index out of bounds.");
     return this->data[index];
 }
 
 template <typename Real>
-Vector3<Real> operator + (const Vector3<Real>& u, const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> operator + (const Vector3<Real>& u, const Vector3<Real>& v) {
     Vector3<Real> result;
     result.data[Vector3<Real>::X] = u.data[Vector3<Real>::X] + v.data[Vector3<Real>::X];
     result.data[Vector3<Real>::Y] = u.data[Vector3<Real>::Y] + v.data[Vector3<Real>::Y];
@@ -513,7 +502,7 @@ Vector3<Real> operator + (const Vector3<Real>& u, const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real> operator - (const Vector3<Real>& u, const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> operator - (const Vector3<Real>& u, const Vector3<Real>& v) {
     Vector3<Real> result;
     result.data[Vector3<Real>::X] = u.data[Vector3<Real>::X] - v.data[Vector3<Real>::X];
     result.data[Vector3<Real>::Y] = u.data[Vector3<Real>::Y] - v.data[Vector3<Real>::Y];
@@ -522,12 +511,12 @@ Vector3<Real> operator - (const Vector3<Real>& u, const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real> operator - (const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> operator - (const Vector3<Real>& v) {
     return Vector3<Real>(-v.data[Vector3<Real>::X], -v.data[Vector3<Real>::Y], -v.data[Vector3<Real>::Z]);
 }
 
 template <typename Real>
-Vector3<Real> operator * (const Vector3<Real>& v, Real scalar) {
+MATH_CONSTEXPR Vector3<Real> operator * (const Vector3<Real>& v, Real scalar) {
     Vector3<Real> result;
     result.data[Vector3<Real>::X] = v.data[Vector3<Real>::X] * scalar;
     result.data[Vector3<Real>::Y] = v.data[Vector3<Real>::Y] * scalar;
@@ -536,7 +525,7 @@ Vector3<Real> operator * (const Vector3<Real>& v, Real scalar) {
 }
 
 template <typename Real>
-Vector3<Real> operator * (Real scalar, const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> operator * (Real scalar, const Vector3<Real>& v) {
     Vector3<Real> result;
     result.data[Vector3<Real>::X] = scalar * v.data[Vector3<Real>::X];
     result.data[Vector3<Real>::Y] = scalar * v.data[Vector3<Real>::Y];
@@ -545,7 +534,7 @@ Vector3<Real> operator * (Real scalar, const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real> operator / (const Vector3<Real>& v, Real scalar) {
+MATH_CONSTEXPR Vector3<Real> operator / (const Vector3<Real>& v, Real scalar) {
     Vector3<Real> result;
     result.data[Vector3<Real>::X] = v.data[Vector3<Real>::X] / scalar;
     result.data[Vector3<Real>::Y] = v.data[Vector3<Real>::Y] / scalar;
@@ -569,7 +558,7 @@ std::istream& operator >> (std::istream& in, Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::operator - (const Vector3<Real>& v) const {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::operator - (const Vector3<Real>& v) const {
     Vector3<Real> result;
     result.data[X] = this->data[X] - v.data[X];
     result.data[Y] = this->data[Y] - v.data[Y];
@@ -578,7 +567,7 @@ Vector3<Real> Vector3<Real>::operator - (const Vector3<Real>& v) const {
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::operator + (const Vector3<Real>& v) const {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::operator + (const Vector3<Real>& v) const {
     Vector3<Real> result;
     result.data[X] = this->data[X] + v.data[X];
     result.data[Y] = this->data[Y] + v.data[Y];
@@ -587,7 +576,7 @@ Vector3<Real> Vector3<Real>::operator + (const Vector3<Real>& v) const {
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::operator / (const Real& scalar) const {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::operator / (const Real& scalar) const {
     Vector3<Real> result;
     result.data[X] = this->data[X] / scalar;
     result.data[Y] = this->data[Y] / scalar;
@@ -596,7 +585,7 @@ Vector3<Real> Vector3<Real>::operator / (const Real& scalar) const {
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::operator * (const Real& scalar) const {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::operator * (const Real& scalar) const {
     Vector3<Real> result;
     result.data[X] = this->data[X] * scalar;
     result.data[Y] = this->data[Y] * scalar;
@@ -605,7 +594,7 @@ Vector3<Real> Vector3<Real>::operator * (const Real& scalar) const {
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::operator * (const Vector3<Real>& v) const {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::operator * (const Vector3<Real>& v) const {
     Vector3<Real> result;
     result.data[X] = this->data[X] * v.data[X];
     result.data[Y] = this->data[Y] * v.data[Y];
@@ -614,16 +603,7 @@ Vector3<Real> Vector3<Real>::operator * (const Vector3<Real>& v) const {
 }
 
 template <typename Real>
-Vector3<Real>& Vector3<Real>::operator = (const Vector3<Real>& v) {
-    if ( this == &v ) return *this;
-    this->data[X] = v.data[X];
-    this->data[Y] = v.data[Y];
-    this->data[Z] = v.data[Z];
-    return *this;
-}
-
-template <typename Real>
-Vector3<Real>& Vector3<Real>::operator += (const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real>& Vector3<Real>::operator += (const Vector3<Real>& v) {
     this->data[X] += v.data[X];
     this->data[Y] += v.data[Y];
     this->data[Z] += v.data[Z];
@@ -631,7 +611,7 @@ Vector3<Real>& Vector3<Real>::operator += (const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real>& Vector3<Real>::operator -= (const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real>& Vector3<Real>::operator -= (const Vector3<Real>& v) {
     this->data[X] -= v.data[X];
     this->data[Y] -= v.data[Y];
     this->data[Z] -= v.data[Z];
@@ -639,7 +619,7 @@ Vector3<Real>& Vector3<Real>::operator -= (const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real>& Vector3<Real>::operator *= (const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real>& Vector3<Real>::operator *= (const Vector3<Real>& v) {
     this->data[X] *= v.data[X];
     this->data[Y] *= v.data[Y];
     this->data[Z] *= v.data[Z];
@@ -647,7 +627,7 @@ Vector3<Real>& Vector3<Real>::operator *= (const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real>& Vector3<Real>::operator *= (Real scalar) {
+MATH_CONSTEXPR Vector3<Real>& Vector3<Real>::operator *= (Real scalar) {
     this->data[X] *= scalar;
     this->data[Y] *= scalar;
     this->data[Z] *= scalar;
@@ -655,7 +635,7 @@ Vector3<Real>& Vector3<Real>::operator *= (Real scalar) {
 }
 
 template <typename Real>
-bool Vector3<Real>::operator == (const Vector3<Real>& v) const {
+MATH_CONSTEXPR bool Vector3<Real>::operator == (const Vector3<Real>& v) const {
     if ( this->data[X] == v.data[X] && 
          this->data[Y] == v.data[Y] && 
          this->data[Z] == v.data[Z] ) return true;
@@ -663,8 +643,8 @@ bool Vector3<Real>::operator == (const Vector3<Real>& v) const {
 }
 
 template <typename Real>
-bool Vector3<Real>::operator != (const Vector3<Real>& v) const {
-    return !(*this == vector);
+MATH_CONSTEXPR bool Vector3<Real>::operator != (const Vector3<Real>& v) const {
+    return !(*this == v);
 }
 	
 template <typename Real>
@@ -692,7 +672,7 @@ bool Vector3<Real>::operator >= (const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::Add(const Vector3<Real>& u, const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::Add(const Vector3<Real>& u, const Vector3<Real>& v) {
     Vector3<Real> result;
     result.data[X] = u.data[X] + v.data[X];
     result.data[Y] = u.data[Y] + v.data[Y];
@@ -701,7 +681,7 @@ Vector3<Real> Vector3<Real>::Add(const Vector3<Real>& u, const Vector3<Real>& v)
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::Subtract(const Vector3<Real>& u, const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::Subtract(const Vector3<Real>& u, const Vector3<Real>& v) {
     Vector3<Real> result;
     result.data[X] = u.data[X] - v.data[X];
     result.data[Y] = u.data[Y] - v.data[Y];
@@ -710,7 +690,7 @@ Vector3<Real> Vector3<Real>::Subtract(const Vector3<Real>& u, const Vector3<Real
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::Multiply(Real scalar, const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::Multiply(Real scalar, const Vector3<Real>& v) {
     Vector3<Real> result;
     result.data[X] = scalar * v.data[X];
     result.data[Y] = scalar * v.data[Y];
@@ -729,7 +709,7 @@ Vector3<Real> Vector3<Real>::Normalize(const Vector3<Real>& v) {
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::Cross(const Vector3<Real>& u, const Vector3<Real>& v) {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::Cross(const Vector3<Real>& u, const Vector3<Real>& v) {
     Vector3<Real> result;
     result.data[X] = ((u.data[Y] * v.data[Z]) - (u.data[Z] * v.data[Y]));
     result.data[Y] = ((u.data[Z] * v.data[X]) - (u.data[X] * v.data[Z]));
@@ -757,7 +737,7 @@ double Vector3<Real>::Angle(const Vector3<Real>& u, const Vector3<Real>& v) {
 }
 
 template <typename Real>
-double Vector3<Real>::Dot(const Vector3<Real>& u, const Vector3<Real>& v) {
+MATH_CONSTEXPR double Vector3<Real>::Dot(const Vector3<Real>& u, const Vector3<Real>& v) {
     return u.x() * v.x() + u.y() * v.y() + u.z() * v.z();
 }
 
@@ -772,8 +752,8 @@ double Vector3<Real>::Norm(const Vector3<Real>& v) {
 }
 
 template <typename Real>
-double Vector3<Real>::NormSquared(const Vector3<Real>& v) {
-    return std::pow(v.data[X], Real(2)) + std::pow(v.data[Y], Real(2)) + std::pow(v.data[Z], Real(2));
+MATH_CONSTEXPR double Vector3<Real>::NormSquared(const Vector3<Real>& v) {
+    return v.data[X] * v.data[X] + v.data[Y] * v.data[Y] + v.data[Z] * v.data[Z];
 }
 
 template <typename Real>
@@ -782,8 +762,8 @@ double Vector3<Real>::Length(const Vector3<Real>& v) {
 }
 
 template <typename Real>
-double Vector3<Real>::LengthSquared(const Vector3<Real>& v) {
-    return std::pow(v.data[X], Real(2)) + std::pow(v.data[Y], Real(2)) + std::pow(v.data[Z], Real(2));
+MATH_CONSTEXPR double Vector3<Real>::LengthSquared(const Vector3<Real>& v) {
+    return v.data[X] * v.data[X] + v.data[Y] * v.data[Y] + v.data[Z] * v.data[Z];
 }
 
 template <typename Real>
@@ -792,45 +772,65 @@ double Vector3<Real>::Distance(const Vector3<Real>& u, const Vector3<Real>& v) {
 }
 
 template <typename Real>
-double Vector3<Real>::DistanceSquared(const Vector3<Real>& u, const Vector3<Real>& v) {
-    return std::pow(u.data[X] - v.data[X], Real(2)) + std::pow(u.data[Y] - v.data[Y], Real(2)) + std::pow(u.data[Z] - v.data[Z], Real(2));
+MATH_CONSTEXPR double Vector3<Real>::DistanceSquared(const Vector3<Real>& u, const Vector3<Real>& v) {
+    return (u.data[X] - v.data[X]) * (u.data[X] - v.data[X]) + (u.data[Y] - v.data[Y]) * (u.data[Y] - v.data[Y]) + (u.data[Z] - v.data[Z]) * (u.data[Z] - v.data[Z]);
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::Zero() {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::Zero() {
     return Vector3<Real>();
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::UnitX() {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::UnitX() {
     return Vector3<Real>(Real(1), Real(0), Real(0));
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::UnitY() {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::UnitY() {
     return Vector3<Real>(Real(0), Real(1), Real(0));
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::UnitZ() {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::UnitZ() {
     return Vector3<Real>(Real(0), Real(0), Real(1));
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::UnitNX() {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::UnitNX() {
     return Vector3<Real>(Real(-1), Real(0), Real(0));
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::UnitNY() {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::UnitNY() {
     return Vector3<Real>(Real(0), Real(-1), Real(0));
 }
 
 template <typename Real>
-Vector3<Real> Vector3<Real>::UnitNZ() {
+MATH_CONSTEXPR Vector3<Real> Vector3<Real>::UnitNZ() {
     return Vector3<Real>(Real(0), Real(0), Real(-1));
 }
 
+//------------------------------------------------------------------------------
+// float specializations. Vector3f stays 12 bytes (it is part of the vertex and
+// particle GPU layouts), so only the normalization, which is dominated by the
+// square root and division, uses the reciprocal square root estimate.
+//------------------------------------------------------------------------------
+template <>
+inline void Vector3<float>::normalize() {
+    float invLen = SimdRsqrt(this->data[X] * this->data[X] + this->data[Y] * this->data[Y] + this->data[Z] * this->data[Z]);
+    this->data[X] *= invLen;
+    this->data[Y] *= invLen;
+    this->data[Z] *= invLen;
+}
+
+template <>
+inline Vector3<float> Vector3<float>::Normalize(const Vector3<float>& v) {
+    Vector3<float> result = v;
+    result.normalize();
+    return result;
+}
+
 typedef Vector3<long double> Vector3ld;
 typedef Vector3<double> Vector3d;
 typedef Vector3<float> Vector3f;
@@ -41,22 +41,22 @@ class Vector4;
  * See: http://www.parashift.com/c++-faq-lite/template-friends.html
  */
 template <typename Real>
-Vector4<Real> operator + (const Vector4<Real>& u, const Vector4<Real>& v);
+MATH_CONSTEXPR Vector4<Real> operator + (const Vector4<Real>& u, const Vector4<Real>& v);
 
 template <typename Real>
-Vector4<Real> operator - (const Vector4<Real>& u, const Vector4<Real>& v);
+MATH_CONSTEXPR Vector4<Real> operator - (const Vector4<Real>& u, const Vector4<Real>& v);
 
 template <typename Real>
-Vector4<Real> operator - (const Vector4<Real>& v);
+MATH_CONSTEXPR Vector4<Real> operator - (const Vector4<Real>& v);
 
 template <typename Real>
-Vector4<Real> operator * (const Vector4<Real>& v, Real scalar);
+MATH_CONSTEXPR Vector4<Real> operator * (const Vector4<Real>& v, Real scalar);
 
 template <typename Real>
-Vector4<Real> operator * (Real scalar, const Vector4<Real>& v);
+MATH_CONSTEXPR Vector4<Real> operator * (Real scalar, const Vector4<Real>& v);
 
 template <typename Real>
-Vector4<Real> operator / (const Vector4<Real>& v, Real scalar);
+MATH_CONSTEXPR Vector4<Real> operator / (const Vector4<Real>& v, Real scalar);
 
 template <typename Real>
 std::ostream& operator << (std::ostream& out, const Vector4<Real>& vector);
@@ -74,7 +74,8 @@ std::istream& operator >> (std::istream& in, Vector4<Real>& vector);
  * template meta programming.
  * See: http://www.flipcode.com/archives/Faster_Vector_Math_Using_Templates.shtml
  *
- * This implementation also foregoes vectorization (SSE).
+ * This implementation also foregoes vectorization (SSE) except for the float
+ * specializations at the end of this file (see SimdMath.h).
  * This implementation is aimed at a flexibility while preserving 
  * understandability and complete modularity.
  */
@@ -86,68 +87,66 @@ class Vector4 {
     enum Axis { X, Y, Z, W, COMPONENT_COUNT };
 
 public:
-    Vector4(Real w = Real(0), Real x = Real(0), Real y = Real(0), Real z = Real(0));
-    Vector4(const Vector4<Real>& v);
-    Vector4(const Vector3<Real>& v, Real w = Real(1));
-    Vector4(Real v[4]);
-    ~Vector4();
-
-    void add(const Vector4<Real>& v);
-    void subtract(const Vector4<Real>& v);
-    void multiply(Real scalar);
+    MATH_CONSTEXPR Vector4(Real w = Real(0), Real x = Real(0), Real y = Real(0), Real z = Real(0));
+    MATH_CONSTEXPR Vector4(const Vector3<Real>& v, Real w = Real(1));
+    MATH_CONSTEXPR Vector4(Real v[4]);
+
+    MATH_CONSTEXPR void add(const Vector4<Real>& v);
+    MATH_CONSTEXPR void subtract(const Vector4<Real>& v);
+    MATH_CONSTEXPR void multiply(Real scalar);
     void normalize();
-    void inverse();
+    MATH_CONSTEXPR void inverse();
 
-    void zero();
-    bool isZero(Real epsilon);
+    MATH_CONSTEXPR void zero();
+    MATH_CONSTEXPR bool isZero(Real epsilon);
     bool isEqual(const Vector4<Real>& v);
-    bool isEquivalent(const Vector4<Real>& v, Real epsilon) const;
+    MATH_CONSTEXPR bool isEquivalent(const Vector4<Real>& v, Real epsilon) const;
 
     template <typename RealCastType>
     Vector4<RealCastType> cast();
 
     Vector4<Real> normalized() const;
-    double dot(const Vector4<Real>& v) const;
+    MATH_CONSTEXPR double dot(const Vector4<Real>& v) const;
     
     double magnitude() const;
     double length() const;
-    double lengthSquared() const;
+    MATH_CONSTEXPR double lengthSquared() const;
     double norm() const;
-    double normSquared() const;
+    MATH_CONSTEXPR double normSquared() const;
     double distance(const Vector4<Real>& v) const;
-    double distanceSquared(const Vector4<Real>& v) const;
-
-    void set(Real w, Real x, Real y, Real z);
-    void set(const Vector4<Real>& v);
-    void setW(Real w);
-    void setX(Real x);
-    void setY(Real y);
-    void setZ(Real z);
-
-    const Real& getW() const;
-    const Real& getX() const;
-    const Real& getY() const;
-    const Real& getZ() const;
-    const Real& w() const;
-    const Real& x() const;
-	const Real& y() const;
-	const Real& z() const;
+    MATH_CONSTEXPR double distanceSquared(const Vector4<Real>& v) const;
+
+    MATH_CONSTEXPR void set(Real w, Real x, Real y, Real z);
+    MATH_CONSTEXPR void set(const Vector4<Real>& v);
+    MATH_CONSTEXPR void setW(Real w);
+    MATH_CONSTEXPR void setX(Real x);
+    MATH_CONSTEXPR void setY(Real y);
+    MATH_CONSTEXPR void setZ(Real z);
+
+    MATH_CONSTEXPR const Real& getW() const;
+    MATH_CONSTEXPR const Real& getX() const;
+    MATH_CONSTEXPR const Real& getY() const;
+    MATH_CONSTEXPR const Real& getZ() const;
+    MATH_CONSTEXPR const Real& w() const;
+    MATH_CONSTEXPR const Real& x() const;
+	MATH_CONSTEXPR const Real& y() const;
+	MATH_CONSTEXPR const Real& z() const;
 	
-    Real& getW();
-    Real& getX();
-    Real& getY();
-    Real& getZ();
-    Real& w();
-	Real& x();
-	Real& y();
-	Real& z();
-
-    const Real* const constData() const;
+    MATH_CONSTEXPR Real& getW();
+    MATH_CONSTEXPR Real& getX();
+    MATH_CONSTEXPR Real& getY();
+    MATH_CONSTEXPR Real& getZ();
+    MATH_CONSTEXPR Real& w();
+	MATH_CONSTEXPR Real& x();
+	MATH_CONSTEXPR Real& y();
+	MATH_CONSTEXPR Real& z();
+
+    MATH_CONSTEXPR const Real* const constData() const;
     operator const Real* const () const;
     Real operator () (const Vector4<Real>& v) const;
     bool operator () (const Vector4<Real>& u, const Vector4<Real>& v) const;
 
-    Real& operator [] (std::size_t index);
+    MATH_CONSTEXPR Real& operator [] (std::size_t index);
 
     friend Vector4<Real> operator + <> (const Vector4<Real>& u, const Vector4<Real>& v);
     friend Vector4<Real> operator - <> (const Vector4<Real>& u, const Vector4<Real>& v);
@@ -159,58 +158,56 @@ public:
     friend std::ostream& operator << <> (std::ostream& out, const Vector4<Real>& v);
     friend std::istream& operator >> <> (std::istream& in, Vector4<Real>& v);
 
-    Vector4<Real> operator - (const Vector4<Real>& v) const;
-	Vector4<Real> operator + (const Vector4<Real>& v) const;
-	Vector4<Real> operator * (const Real& scalar) const;
-	Vector4<Real> operator * (const Vector4<Real>& v) const;
-
-    Vector4<Real>& operator = (const Vector4<Real>& v);
+    MATH_CONSTEXPR Vector4<Real> operator - (const Vector4<Real>& v) const;
+	MATH_CONSTEXPR Vector4<Real> operator + (const Vector4<Real>& v) const;
+	MATH_CONSTEXPR Vector4<Real> operator * (const Real& scalar) const;
+	MATH_CONSTEXPR Vector4<Real> operator * (const Vector4<Real>& v) const;
 
-    Vector4<Real>& operator += (const Vector4<Real>& v);
-    Vector4<Real>& operator -= (const Vector4<Real>& v);
-    Vector4<Real>& operator *= (const Vector4<Real>& v);
-    Vector4<Real>& operator *= (Real scalar);
+    MATH_CONSTEXPR Vector4<Real>& operator += (const Vector4<Real>& v);
+    MATH_CONSTEXPR Vector4<Real>& operator -= (const Vector4<Real>& v);
+    MATH_CONSTEXPR Vector4<Real>& operator *= (const Vector4<Real>& v);
+    MATH_CONSTEXPR Vector4<Real>& operator *= (Real scalar);
 
-    bool operator == (const Vector4<Real>& v) const;
-	bool operator != (const Vector4<Real>& v) const;
+    MATH_CONSTEXPR bool operator == (const Vector4<Real>& v) const;
+	MATH_CONSTEXPR bool operator != (const Vector4<Real>& v) const;
 
     bool operator < (const Vector4<Real>& v);
     bool operator <= (const Vector4<Real>& v);
     bool operator > (const Vector4<Real>& v);
     bool operator >= (const Vector4<Real>& v);
 
-    static Vector4<Real> Add(const Vector4<Real>& u, const Vector4<Real>& v);
-    static Vector4<Real> Subtract(const Vector4<Real>& u, const Vector4<Real>& v);
-    static Vector4<Real> Multiply(Real scalar, const Vector4<Real>& v);
+    static MATH_CONSTEXPR Vector4<Real> Add(const Vector4<Real>& u, const Vector4<Real>& v);
+    static MATH_CONSTEXPR Vector4<Real> Subtract(const Vector4<Real>& u, const Vector4<Real>& v);
+    static MATH_CONSTEXPR Vector4<Real> Multiply(Real scalar, const Vector4<Real>& v);
     static Vector4<Real> Normalize(const Vector4<Real>& v);
     static Vector4<Real> LinearInterpolation(const Vector4<Real>& u, const Vector4<Real>& v, Real t);
     static Vector4<Real> Project(const Vector4<Real>& u, const Vector4<Real>& v);
 
-    static double Dot(const Vector4<Real>& u, const Vector4<Real>& v);
+    static MATH_CONSTEXPR double Dot(const Vector4<Real>& u, const Vector4<Real>& v);
     static double Magnitude(const Vector4<Real>& v);
     static double Norm(const Vector4<Real>& v);
-    static double NormSquared(const Vector4<Real>& v);
+    static MATH_CONSTEXPR double NormSquared(const Vector4<Real>& v);
     static double Length(const Vector4<Real>& v);
-    static double LengthSquared(const Vector4<Real>& v);
+    static MATH_CONSTEXPR double LengthSquared(const Vector4<Real>& v);
     static double Distance(const Vector4<Real>& u, const Vector4<Real>& v);
-    static double DistanceSquared(const Vector4<Real>& u, const Vector4<Real>& v);
-
-    static Vector4<Real> Zero();
-    static Vector4<Real> UnitW();
-	static Vector4<Real> UnitX();
-	static Vector4<Real> UnitY();
-	static Vector4<Real> UnitZ();
-    static Vector4<Real> UnitNW();
-    static Vector4<Real> UnitNX();
-    static Vector4<Real> UnitNY();
-    static Vector4<Real> UnitNZ();
+    static MATH_CONSTEXPR double DistanceSquared(const Vector4<Real>& u, const Vector4<Real>& v);
+
+    static MATH_CONSTEXPR Vector4<Real> Zero();
+    static MATH_CONSTEXPR Vector4<Real> UnitW();
+	static MATH_CONSTEXPR Vector4<Real> UnitX();
+	static MATH_CONSTEXPR Vector4<Real> UnitY();
+	static MATH_CONSTEXPR Vector4<Real> UnitZ();
+    static MATH_CONSTEXPR Vector4<Real> UnitNW();
+    static MATH_CONSTEXPR Vector4<Real> UnitNX();
+    static MATH_CONSTEXPR Vector4<Real> UnitNY();
+    static MATH_CONSTEXPR Vector4<Real> UnitNZ();
 
 protected:
     Real data[COMPONENT_COUNT];
 };
 
 template <typename Real>
-Vector4<Real>::Vector4(Real w, Real x, Real y, Real z) {
+MATH_CONSTEXPR Vector4<Real>::Vector4(Real w, Real x, Real y, Real z) : data() {
     this->data[W] = w;
     this->data[X] = x;
     this->data[Y] = y;
@@ -218,15 +215,7 @@ Vector4<Real>::Vector4(Real w, Real x, Real y, Real z) {
 }
 
 template <typename Real>
-Vector4<Real>::Vector4(const Vector4<Real>& v) {
-    this->data[W] = v.data[W];
-    this->data[X] = v.data[X];
-    this->data[Y] = v.data[Y];
-    this->data[Z] = v.data[Z];
-}
-
-template <typename Real>
-Vector4<Real>::Vector4(const Vector3<Real>& v, Real w) {
+MATH_CONSTEXPR Vector4<Real>::Vector4(const Vector3<Real>& v, Real w) : data() {
     this->data[W] = w;
     this->data[X] = v.x();
     this->data[Y] = v.y();
@@ -234,7 +223,7 @@ Vector4<Real>::Vector4(const Vector3<Real>& v, Real w) {
 }
 
 template <typename Real>
-Vector4<Real>::Vector4(Real v[4]) {
+MATH_CONSTEXPR Vector4<Real>::Vector4(Real v[4]) : data() {
     this->data[W] = v[0];
     this->data[X] = v[1];
     this->data[Y] = v[2];
@@ -242,10 +231,7 @@ Vector4<Real>::Vector4(Real v[4]) {
 }
 
 template <typename Real>
-Vector4<Real>::~Vector4() {}
-
-template <typename Real>
-void Vector4<Real>::add(const Vector4<Real>& v) {
+MATH_CONSTEXPR void Vector4<Real>::add(const Vector4<Real>& v) {
     this->data[W] += v.data[W];
     this->data[X] += v.data[X];
     this->data[Y] += v.data[Y];
@@ -253,7 +239,7 @@ void Vector4<Real>::add(const Vector4<Real>& v) {
 }
 
 template <typename Real>
-void Vector4<Real>::subtract(const Vector4<Real>& v) {
+MATH_CONSTEXPR void Vector4<Real>::subtract(const Vector4<Real>& v) {
     this->data[W] -= v.data[W];
     this->data[X] -= v.data[X];
     this->data[Y] -= v.data[Y];
@@ -261,7 +247,7 @@ void Vector4<Real>::subtract(const Vector4<Real>& v) {
 }
 
 template <typename Real>
-void Vector4<Real>::multiply(Real scalar) {
+MATH_CONSTEXPR void Vector4<Real>::multiply(Real scalar) {
     this->data[W] *= scalar;
     this->data[X] *= scalar;
     this->data[y] *= scalar;
@@ -278,7 +264,7 @@ void Vector4<Real>::normalize() {
 }
 
 template <typename Real>
-void Vector4<Real>::inverse() {
+MATH_CONSTEXPR void Vector4<Real>::inverse() {
     this->data[W] = -this->data[W];
     this->data[X] = -this->data[X];
     this->data[Y] = -this->data[Y];
@@ -286,7 +272,7 @@ void Vector4<Real>::inverse() {
 }
 
 template <typename Real>
-void Vector4<Real>::zero() {
+MATH_CONSTEXPR void Vector4<Real>::zero() {
     this->data[W] = Real(0);
     this->data[X] = Real(0);
     this->data[Y] = Real(0);
@@ -294,7 +280,7 @@ void Vector4<Real>::zero() {
 }
 
 template <typename Real>
-bool Vector4<Real>::isZero(Real epsilon) {
+MATH_CONSTEXPR bool Vector4<Real>::isZero(Real epsilon) {
     if ( (this->data[W] > -epsilon) && 
          (this->data[W] < epsilon ) &&
          (this->data[X] > -epsilon) && 
@@ -314,7 +300,7 @@ bool Vector4<Real>::isEqual(const Vector4<Real>& v) {
 }
 
 template <typename Real>
-bool Vector4<Real>::isEquivalent(const Vector4<Real>& v, Real epsilon) const {
+MATH_CONSTEXPR bool Vector4<Real>::isEquivalent(const Vector4<Real>& v, Real epsilon) const {
     for ( unsigned int i = 0; i < COMPONENT_COUNT; i++ )
         if ( this->data[i] < (v.data[i] - epsilon) || this->data[i] > (v.data[i] + epsilon) ) return false;
     return true;
@@ -332,7 +318,7 @@ Vector4<Real> Vector4<Real>::normalized() const {
 }
 
 template <typename Real>
-double Vector4<Real>::dot(const Vector4<Real>& v) const {
+MATH_CONSTEXPR double Vector4<Real>::dot(const Vector4<Real>& v) const {
     return Vector4<Real>::Dot(*this, v);
 }
 
@@ -347,7 +333,7 @@ double Vector4<Real>::length() const {
 }
 
 template <typename Real>
-double Vector4<Real>::lengthSquared() const {
+MATH_CONSTEXPR double Vector4<Real>::lengthSquared() const {
     return Vector4<Real>::LengthSquared(*this);
 }
 
@@ -357,7 +343,7 @@ double Vector4<Real>::norm() const {
 }
 
 template <typename Real>
-double Vector4<Real>::normSquared() const {
+MATH_CONSTEXPR double Vector4<Real>::normSquared() const {
     return Vector4<Real>::NormSquared(*this);
 }
 
@@ -367,12 +353,12 @@ double Vector4<Real>::distance(const Vector4<Real>& v) const {
 }
 
 template <typename Real>
-double Vector4<Real>::distanceSquared(const Vector4<Real>& v) const {
+MATH_CONSTEXPR double Vector4<Real>::distanceSquared(const Vector4<Real>& v) const {
     return Vector4<Real>::DistanceSquared(*this, v);
 }
 
 template <typename Real>
-void Vector4<Real>::set(Real w, Real x, Real y, Real z) {
+MATH_CONSTEXPR void Vector4<Real>::set(Real w, Real x, Real y, Real z) {
     this->data[W] = w;
     this->data[X] = x;
     this->data[Y] = y;
@@ -380,7 +366,7 @@ void Vector4<Real>::set(Real w, Real x, Real y, Real z) {
 }
 
 template <typename Real>
-void Vector4<Real>::set(const Vector4<Real>& v) {
+MATH_CONSTEXPR void Vector4<Real>::set(const Vector4<Real>& v) {
     this->data[W] = v.data[W];
     this->data[X] = v.data[X];
     this->data[Y] = v.data[Y];
@@ -388,107 +374,107 @@ void Vector4<Real>::set(const Vector4<Real>& v) {
 }
 
 template <typename Real>
-void Vector4<Real>::setW(Real w) {
+MATH_CONSTEXPR void Vector4<Real>::setW(Real w) {
     this->data[W] = w;
 }
 
 template <typename Real>
-void Vector4<Real>::setX(Real x) {
+MATH_CONSTEXPR void Vector4<Real>::setX(Real x) {
     this->data[X] = x;
 }
 
 template <typename Real>
-void Vector4<Real>::setY(Real y) {
+MATH_CONSTEXPR void Vector4<Real>::setY(Real y) {
     this->data[Y] = y;
 }
 
 template <typename Real>
-void Vector4<Real>::setZ(Real z) {
+MATH_CONSTEXPR void Vector4<Real>::setZ(Real z) {
     this->data[Z] = z;
 }
 
 template <typename Real>
-const Real& Vector4<Real>::getW() const {
+MATH_CONSTEXPR const Real& Vector4<Real>::getW() const {
     return this->data[W];
 }
 
 template <typename Real>
-const Real& Vector4<Real>::getX() const {
+MATH_CONSTEXPR const Real& Vector4<Real>::getX() const {
     return this->data[X];
 }
 
 template <typename Real>
-const Real& Vector4<Real>::getY() const {
+MATH_CONSTEXPR const Real& Vector4<Real>::getY() const {
     return this->data[Y];
 }
 
 template <typename Real>
-const Real& Vector4<Real>::getZ() const {
+MATH_CONSTEXPR const Real& Vector4<Real>::getZ() const {
     return this->data[Z];
 }
 
 template <typename Real>
-const Real& Vector4<Real>::w() const {
+MATH_CONSTEXPR const Real& Vector4<Real>::w() const {
     return this->data[W];
 }
 
 template <typename Real>
-const Real& Vector4<Real>::x() const {
+MATH_CONSTEXPR const Real& Vector4<Real>::x() const {
     return this->data[X];
 }
 
 template <typename Real>
-const Real& Vector4<Real>::y() const {
+MATH_CONSTEXPR const Real& Vector4<Real>::y() const {
     return this->data[Y];
 }
 
 template <typename Real>
-const Real& Vector4<Real>::z() const {
+MATH_CONSTEXPR const Real& Vector4<Real>::z() const {
     return this->data[Z];
 }
 	
 template <typename Real>
-Real& Vector4<Real>::getW() {
+MATH_CONSTEXPR Real& Vector4<Real>::getW() {
     return this->data[W];
 }
 
 template <typename Real>
-Real& Vector4<Real>::getX() {
+MATH_CONSTEXPR Real& Vector4<Real>::getX() {
     return this->data[X];
 }
 
 template <typename Real>
-Real& Vector4<Real>::getY() {
+MATH_CONSTEXPR Real& Vector4<Real>::getY() {
     return this->data[y];
 }
 
 template <typename Real>
-Real& Vector4<Real>::getZ() {
+MATH_CONSTEXPR Real& Vector4<Real>::getZ() {
     return this->data[Z];
 }
 
 template <typename Real>
-Real& Vector4<Real>::w() {
+MATH_CONSTEXPR Real& Vector4<Real>::w() {
     return this->data[W];
 }
 
 template <typename Real>
-Real& Vector4<Real>::x() {
+MATH_CONSTEXPR Real& Vector4<Real>::x() {
     return this->data[X];
 }
 
 template <typename Real>
-Real& Vector4<Real>::y() {
+MATH_CONSTEXPR Real& Vector4<Real>::y() {
     return this->data[Y];
 }
 
 template <typename Real>
-Real& Vector4<Real>::z() {
+MATH_CONSTEXPR Real& Vector4<Real>::z() {
     return this->data[Z];
 }
 
 template <typename Real>
-const Real* const Vector4<Real>::constData() const {
+MATH_CONSTEXPR const Real* const Vector4<Real>::constData() const {
     return this->data;
 }
 
@@ -509,13 +495,13 @@ bool Vector4<Real>::operator () (const Vector4<Real>& u, const Vector4<Real>& v)
 }
 
 template <typename Real>
-Real& Vector4<Real>::operator [] (std::size_t index) {
+MATH_CONSTEXPR Real& Vector4<Real>::operator [] (std::size_t index) {
     if ( index >= COMPONENT_COUNT ) throw std::exception("[Vector4:[]] Error: Index out of bounds.");
     return this->data[index];
 }
 
 template <typename Real>
-Vector4<Real> operator + (const Vector4<Real>& u, const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real> operator + (const Vector4<Real>& u, const Vector4<Real>& v) {
     Vector4<Real> result;
     result.data[Vector4<Real>::W] = u.data[Vector4<Real>::W] + v.data[Vector4<Real>::W];
     result.data[Vector4<Real>::X] = u.data[Vector4<Real>::X] + v.data[Vector4<Real>::X];
@@ -525,7 +511,7 @@ Vector4<Real> operator + (const Vector4<Real>& u, const Vector4<Real>& v) {
 }
 
 template <typename Real>
-Vector4<Real> operator - (const Vector4<Real>& u, const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real> operator - (const Vector4<Real>& u, const Vector4<Real>& v) {
     Vector4<Real> result;
     result.data[Vector4<Real>::W] = u.data[Vector4<Real>::W] - v.data[Vector4<Real>::W];
     result.data[Vector4<Real>::X] = u.data[Vector4<Real>::X] - v.data[Vector4<Real>::X];
@@ -535,12 +521,12 @@ Vector4<Real> operator - (const Vector4<Real>& u, const Vector4<Real>& v) {
 }
 
 template <typename Real>
-Vector4<Real> operator - (const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real> operator - (const Vector4<Real>& v) {
     return Vector4<Real>(-v.data[Vector4<Real>::W], -v.data[Vector4<Real>::X] -v.data[Vector4<Real>::Y], -v.data[Vector4<Real>::Z]);
 }
 
 template <typename Real>
-Vector4<Real> operator * (const Vector4<Real>& v, Real scalar) {
+MATH_CONSTEXPR Vector4<Real> operator * (const Vector4<Real>& v, Real scalar) {
     Vector4<Real> result;
     result.data[Vector4<Real>::W] = v.data[Vector4<Real>::W] * scalar;
     result.data[Vector4<Real>::X] = v.data[Vector4<Real>::X] * scalar;
@@ -550,7 +536,7 @@ Vector4<Real> operator * (const Vector4<Real>& v, Real scalar) {
 }
 
 template <typename Real>
-Vector4<Real> operator * (Real scalar, const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real> operator * (Real scalar, const Vector4<Real>& v) {
     Vector4<Real> result;
     result.data[Vector4<Real>::W] = scalar * v.data[Vector4<Real>::W];
     result.data[Vector4<Real>::X] = scalar * v.data[Vector4<Real>::X];
@@ -560,7 +546,7 @@ Vector4<Real> operator * (Real scalar, const Vector4<Real>& v) {
 }
 
 template <typename Real>
-Vector4<Real> operator / (const Vector4<Real>& v, Real scalar) {
+MATH_CONSTEXPR Vector4<Real> operator / (const Vector4<Real>& v, Real scalar) {
     Vector4<Real> result;
     result.data[Vector4<Real>::W] = v.data[Vector4<Real>::W] / scalar;
     result.data[Vector4<Real>::X] = v.data[Vector4<Real>::X] / scalar;
@@ -586,7 +572,7 @@ std::istream& operator >> (std::istream& in, Vector4<Real>& v) {
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::operator - (const Vector4<Real>& v) const {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::operator - (const Vector4<Real>& v) const {
     Vector4<Real> result;
     result.data[W] = this->data[W] - v.data[W];
     result.data[X] = this->data[X] - v.data[X];
@@ -596,7 +582,7 @@ Vector4<Real> Vector4<Real>::operator - (const Vector4<Real>& v) const {
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::operator + (const Vector4<Real>& v) const {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::operator + (const Vector4<Real>& v) const {
     Vector4<Real> result;
     result.data[W] = this->data[W] + v.data[W];
     result.data[X] = this->data[X] + v.data[X];
@@ -606,7 +592,7 @@ Vector4<Real> Vector4<Real>::operator + (const Vector4<Real>& v) const {
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::operator * (const Real& scalar) const {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::operator * (const Real& scalar) const {
     Vector4<Real> result;
     result.data[W] = this->data[W] * scalar;
     result.data[X] = this->data[X] * scalar;
@@ -616,7 +602,7 @@ Vector4<Real> Vector4<Real>::operator * (const Real& scalar) const {
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::operator * (const Vector4<Real>& v) const {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::operator * (const Vector4<Real>& v) const {
     Vector4<Real> result;
     result.data[W] = this->data[W] * v.data[W];
     result.data[X] = this->data[X] * v.data[X];
@@ -626,17 +612,7 @@ Vector4<Real> Vector4<Real>::operator * (const Vector4<Real>& v) const {
 }
 
 template <typename Real>
-Vector4<Real>& Vector4<Real>::operator = (const Vector4<Real>& v) {
-    if ( this == &v ) return *this;
-    this->data[W] = v.data[W];
-    this->data[X] = v.data[X];
-    this->data[Y] = v.data[Y];
-    this->data[Z] = v.data[Z];
-    return *this;
-}
-
-template <typename Real>
-Vector4<Real>& Vector4<Real>::operator += (const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real>& Vector4<Real>::operator += (const Vector4<Real>& v) {
     this->data[W] += v.data[W];
     this->data[X] += v.data[X];
     this->data[Y] += v.data[Y];
@@ -645,7 +621,7 @@ Vector4<Real>& Vector4<Real>::operator += (const Vector4<Real>& v) {
 }
 
 template <typename Real>
-Vector4<Real>& Vector4<Real>::operator -= (const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real>& Vector4<Real>::operator -= (const Vector4<Real>& v) {
     this->data[W] -= v.data[W];
     this->data[X] -= v.data[X];
     this->data[Y] -= v.data[Y];
@@ -654,7 +630,7 @@ Vector4<Real>& Vector4<Real>::operator -= (const Vector4<Real>& v) {
 }
 
 template <typename Real>
-Vector4<Real>& Vector4<Real>::operator *= (const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real>& Vector4<Real>::operator *= (const Vector4<Real>& v) {
     this->data[W] *= v.data[W];
     this->data[X] *= v.data[X];
     this->data[Y] *= v.data[Y];
@@ -663,7 +639,7 @@ Vector4<Real>& Vector4<Real>::operator *= (const Vector4<Real>& v) {
 }
 
 template <typename Real>
-Vector4<Real>& Vector4<Real>::operator *= (Real scalar) {
+MATH_CONSTEXPR Vector4<Real>& Vector4<Real>::operator *= (Real scalar) {
     this->data[W] *= scalar;
     this->data[X] *= scalar;
     this->data[Y] *= scalar;
@@ -672,7 +648,7 @@ Vector4<Real>& Vector4<Real>::operator *= (Real scalar) {
 }
 
 template <typename Real>
-bool Vector4<Real>::operator == (const Vector4<Real>& v) const {
+MATH_CONSTEXPR bool Vector4<Real>::operator == (const Vector4<Real>& v) const {
     if ( this->data[W] == v.data[W] &&
          this->data[X] == v.data[X] && 
          this->data[Y] == v.data[Y] && 
@@ -681,8 +657,8 @@ bool Vector4<Real>::operator == (const Vector4<Real>& v) const {
 }
 
 template <typename Real>
-bool Vector4<Real>::operator != (const Vector4<Real>& v) const {
-    return !(*this == vector);
+MATH_CONSTEXPR bool Vector4<Real>::operator != (const Vector4<Real>& v) const {
+    return !(*this == v);
 }
 
 template <typename Real>
@@ -710,7 +686,7 @@ bool Vector4<Real>::operator >= (const Vector4<Real>& v) {
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::Add(const Vector4<Real>& u, const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::Add(const Vector4<Real>& u, const Vector4<Real>& v) {
     Vector4<Real> result;
     result.data[W] = u.data[W] + v.data[W];
     result.data[X] = u.data[X] + v.data[X];
@@ -720,7 +696,7 @@ Vector4<Real> Vector4<Real>::Add(const Vector4<Real>& u, const Vector4<Real>& v)
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::Subtract(const Vector4<Real>& u, const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::Subtract(const Vector4<Real>& u, const Vector4<Real>& v) {
     Vector4<Real> result;
     result.data[W] = u.data[W] - v.data[W];
     result.data[X] = u.data[X] - v.data[X];
@@ -730,7 +706,7 @@ Vector4<Real> Vector4<Real>::Subtract(const Vector4<Real>& u, const Vector4<Real
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::Multiply(Real scalar, const Vector4<Real>& v) {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::Multiply(Real scalar, const Vector4<Real>& v) {
     Vector4<Real> result = v;
     result.data[W] *= scalar;
     result.data[X] *= scalar;
@@ -741,7 +717,7 @@ Vector4<Real> Vector4<Real>::Multiply(Real scalar, const Vector4<Real>& v) {
 
 template <typename Real>
 Vector4<Real> Vector4<Real>::Normalize(const Vector4<Real>& v) {
-    Vector4<Real> result;
+    Vector4<Real> result = v;
     double invlen = 1.0 / static_cast<double>(v.length());
     result.data[W] *= Real(invlen);
     result.data[X] *= Real(invlen);
@@ -765,8 +741,8 @@ Vector4<Real> Vector4<Real>::Project(const Vector4<Real>& u, const Vector4<Real>
 }
 
 template <typename Real>
-double Vector4<Real>::Dot(const Vector4<Real>& u, const Vector4<Real>& v) {
-    return u.w() * v.w() + u.x() * v.x() + u.y() * v.y() + u.z() * v.y();
+MATH_CONSTEXPR double Vector4<Real>::Dot(const Vector4<Real>& u, const Vector4<Real>& v) {
+    return u.w() * v.w() + u.x() * v.x() + u.y() * v.y() + u.z() * v.z();
 }
 
 template <typename Real>
@@ -780,8 +756,8 @@ double Vector4<Real>::Norm(const Vector4<Real>& v) {
 }
 
 template <typename Real>
-double Vector4<Real>::NormSquared(const Vector4<Real>& v) {
-    return std::pow(v.data[W], Real(2)) + std::pow(v.data[X], Real(2)) + std::pow(v.data[Y], Real(2)) + std::pow(v.data[Z], Real(2));
+MATH_CONSTEXPR double Vector4<Real>::NormSquared(const Vector4<Real>& v) {
+    return v.data[W] * v.data[W] + v.data[X] * v.data[X] + v.data[Y] * v.data[Y] + v.data[Z] * v.data[Z];
 }
 
 template <typename Real>
@@ -790,8 +766,8 @@ double Vector4<Real>::Length(const Vector4<Real>& v) {
 }
 
 template <typename Real>
-double Vector4<Real>::LengthSquared(const Vector4<Real>& v) {
-    return std::pow(v.data[W], Real(2)) + std::pow(v.data[X], Real(2)) + std::pow(v.data[Y], Real(2)) + std::pow(v.data[Z], Real(2));
+MATH_CONSTEXPR double Vector4<Real>::LengthSquared(const Vector4<Real>& v) {
+    return v.data[W] * v.data[W] + v.data[X] * v.data[X] + v.data[Y] * v.data[Y] + v.data[Z] * v.data[Z];
 }
 
 template <typename Real>
@@ -800,55 +776,78 @@ double Vector4<Real>::Distance(const Vector4<Real>& u, const Vector4<Real>& v) {
 }
 
 template <typename Real>
-double Vector4<Real>::DistanceSquared(const Vector4<Real>& u, const Vector4<Real>& v) {
-    return std::pow(u.data[W] - v.data[W], Real(2)) + std::pow(u.data[X] - v.data[X], Real(2)) + std::pow(u.data[Y] - v.data[Y], Real(2)) + std::pow(u.data[Z] - v.data[Z], Real(2));
+MATH_CONSTEXPR double Vector4<Real>::DistanceSquared(const Vector4<Real>& u, const Vector4<Real>& v) {
+    return (u.data[W] - v.data[W]) * (u.data[W] - v.data[W]) + (u.data[X] - v.data[X]) * (u.data[X] - v.data[X]) + (u.data[Y] - v.data[Y]) * (u.data[Y] - v.data[Y]) + (u.data[Z] - v.data[Z]) * (u.data[Z] - v.data[Z]);
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::Zero() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::Zero() {
     return Vector4<Real>();
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::UnitW() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::UnitW() {
     return Vector4<Real>(Real(1), Real(0), Real(0), Real(0));
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::UnitX() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::UnitX() {
     return Vector4<Real>(Real(0), Real(1), Real(0), Real(0));
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::UnitY() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::UnitY() {
     return Vector4<Real>(Real(0), Real(0), Real(1), Real(0));
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::UnitZ() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::UnitZ() {
     return Vector4<Real>(Real(0), Real(0), Real(0), Real(1));
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::UnitNW() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::UnitNW() {
     return Vector4<Real>(Real(-1), Real(0), Real(0), Real(0));
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::UnitNX() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::UnitNX() {
     return Vector4<Real>(Real(0), Real(-1), Real(0), Real(0));
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::UnitNY() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::UnitNY() {
     return Vector4<Real>(Real(0), Real(0), Real(-1), Real(0));
 }
 
 template <typename Real>
-Vector4<Real> Vector4<Real>::UnitNZ() {
+MATH_CONSTEXPR Vector4<Real> Vector4<Real>::UnitNZ() {
     return Vector4<Real>(Real(0), Real(0), Real(0), Real(-1));
 }
 
+//------------------------------------------------------------------------------
+// float specializations. The four components map directly onto a vector
+// register; the loads are unaligned because Vector4f is not 16-byte aligned
+// inside interleaved vertex data (see SimdMath.h).
+//------------------------------------------------------------------------------
+template <>
+inline double Vector4<float>::Dot(const Vector4<float>& u, const Vector4<float>& v) {
+    return SimdGetX(SimdDot4(SimdLoad(u.data), SimdLoad(v.data)));
+}
+
+template <>
+inline void Vector4<float>::normalize() {
+    SimdFloat4 v = SimdLoad(this->data);
+    SimdStore(this->data, SimdMul(v, SimdRsqrt(SimdDot4(v, v))));
+}
+
+template <>
+inline Vector4<float> Vector4<float>::Normalize(const Vector4<float>& v) {
+    Vector4<float> result = v;
+    result.normalize();
+    return result;
+}
+
 typedef Vector4<long double> Vector4ld;
 typedef Vector4<double> Vector4d;
 typedef Vector4<float> Vector4f;
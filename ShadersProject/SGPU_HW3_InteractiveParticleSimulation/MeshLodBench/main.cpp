@@ -0,0 +1,140 @@
+#include <gl/glew.h>
+#include <gl/freeglut.h>
+#include <Mesh.h>
+#include <Camera.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/*
+ * Level of detail report and triangle throughput benchmark. Loading the model
+ * builds its LOD chain; the error of every level is printed together with
+ * the camera distance from which Mesh::selectLod picks it, and every level
+ * is drawn repeatedly to measure the triangle throughput. The camera then
+ * circles the model and the full level is drawn with and without meshlet
+ * culling, reporting the faces culled and the CPU time of the culling pass.
+ *
+ *   MeshLodBench <model.obj> [frames] [vertex shader] [fragment shader]
+ */
+
+const static int WINDOW_SIZE = 512;
+const static float FIELD_OF_VIEW = 45.0f;
+const static unsigned int ORBIT_VIEWS = 8;
+
+void PrintUsage() {
+    std::cout << "Usage: MeshLodBench <model.obj> [frames] [vertex shader] [fragment shader]" << std::endl;
+}
+
+/* Draws the mesh frames + 1 times and returns the seconds per frame, without the first. */
+double DrawFrames(Mesh& mesh, const Cameraf& camera, int frames) {
+    Matrix4f modelView = Matrix4f::Multiply(mesh.getTransform().toMatrix(), camera.getViewMatrix());
+    double seconds = 0.0;
+    for ( int f = 0; f <= frames; f++ ) {
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        mesh.beginRender();
+        mesh.getShader()->uniformMatrix("projectionMatrix", camera.getProjectionMatrix());
+        mesh.getShader()->uniformMatrix("modelViewMatrix", modelView);
+        mesh.getShader()->uniformNormalMatrix(modelView);
+        mesh.getShader()->uniformVector("lightPosition", Vector3f(0.0f, 1.0f, 20.0f));
+        mesh.endRender();
+        glFinish();
+        std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+        if ( f > 0 ) seconds += std::chrono::duration<double>(end - start).count();
+    }
+
+    glutSwapBuffers();
+    return seconds / frames;
+}
+
+int main(int argc, char* argv[]) {
+    if ( argc < 2 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    int frames = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 100;
+    std::string vertexShader = (argc > 3) ? argv[3] : "shaders/PhongShading.vert";
+    std::string fragmentShader = (argc > 4) ? argv[4] : "shaders/PhongShading.frag";
+
+    //--------------------------------------------------------------------------
+    // A hidden-size window provides the OpenGL context.
+    //--------------------------------------------------------------------------
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+    glutInitWindowSize(WINDOW_SIZE, WINDOW_SIZE);
+    glutCreateWindow("MeshLodBench");
+    glewInit();
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, WINDOW_SIZE, WINDOW_SIZE);
+
+    Mesh mesh;
+    if ( !mesh.load(argv[1]) ) return 1;
+    if ( !mesh.loadShader(vertexShader, fragmentShader) ) return 1;
+
+    std::vector<MeshLod> lods;
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    GenerateLodChain(mesh.getVertices(), mesh.getFaces(), lods);
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+    double generateSeconds = std::chrono::duration<double>(end - start).count();
+
+    float radius = 0.0f;
+    for ( std::size_t i = 0; i < mesh.getVertices().size(); i++ )
+        radius = std::max(radius, static_cast<float>(mesh.getVertices()[i].position.length()));
+
+    Cameraf camera;
+    camera.setPerspective(FIELD_OF_VIEW, 1.0f, 0.1f, 1000.0f);
+    camera.setPosition(3.0f * radius, 0.0f, static_cast<float>(HALF_PI));
+    camera.setLookAt(Vector3f(0.0f, 0.0f, 0.0f));
+
+    float pixelsPerUnit = WINDOW_SIZE / (2.0f * std::tan(FIELD_OF_VIEW * static_cast<float>(PI) / 360.0f));
+
+    std::printf("model:      %s\n", argv[1]);
+    std::printf("vertices:   %u\n", static_cast<unsigned int>(mesh.getVertices().size()));
+    std::printf("chain:      %.1f ms (%.2f Mtri/s)\n", generateSeconds * 1000.0, mesh.getFaces().size() / generateSeconds * 1.0e-6);
+    std::printf("level  faces     ratio   error      normal  uv      from distance  ms/frame  Mtri/s\n");
+
+    for ( std::size_t level = 0; level < mesh.getLodCount(); level++ ) {
+        const std::vector<TriangleFace>& faces = (level == 0) ? mesh.getFaces() : mesh.getLods()[level - 1].faces;
+        SimplificationError error = { 0.0f, 0.0f, 0.0f };
+        if ( level > 0 ) error = mesh.getLods()[level - 1].error;
+
+        mesh.setLod(level);
+        double frameSeconds = DrawFrames(mesh, camera, frames);
+        float distance = radius + error.geometric * pixelsPerUnit / LOD_PIXEL_ERROR;
+        std::printf("%5u  %-8u  %5.3f   %-9.5f  %-6.3f  %-6.4f  %-13.2f  %-8.3f  %.1f\n",
+            static_cast<unsigned int>(level), static_cast<unsigned int>(faces.size()),
+            static_cast<float>(faces.size()) / mesh.getFaces().size(), error.geometric, error.normal, error.textureCoord,
+            distance, frameSeconds * 1000.0, faces.size() / frameSeconds * 1.0e-6);
+    }
+
+    //--------------------------------------------------------------------------
+    // Circle the model close up, where part of it leaves the view, and draw
+    // the full level with and without meshlet culling.
+    //--------------------------------------------------------------------------
+    std::printf("\nmeshlets:   %u\n", static_cast<unsigned int>(mesh.getMeshlets().size()));
+    std::printf("view  culled  frustum  cone  draws  cull ms  ms/frame  culled ms/frame\n");
+
+    mesh.setLod(0);
+    for ( unsigned int view = 0; view < ORBIT_VIEWS; view++ ) {
+        camera.setPosition(1.5f * radius, static_cast<float>(2.0 * PI * view / ORBIT_VIEWS), static_cast<float>(HALF_PI));
+
+        mesh.setMeshletCulling(false);
+        double frameSeconds = DrawFrames(mesh, camera, frames);
+
+        mesh.setMeshletCulling(true);
+        mesh.cullMeshlets(Matrix4f::Multiply(mesh.getTransform().toMatrix(), camera.getViewMatrix()), camera.getProjectionMatrix());
+        double culledSeconds = DrawFrames(mesh, camera, frames);
+
+        const MeshletCullingStatistics& statistics = mesh.getMeshletCullingStatistics();
+        std::printf("%4u  %5.1f%%  %-7u  %-4u  %-5u  %-7.3f  %-8.3f  %.3f\n",
+            view, statistics.culledFraction * 100.0f, static_cast<unsigned int>(statistics.frustumCulled), static_cast<unsigned int>(statistics.coneCulled),
+            static_cast<unsigned int>(statistics.drawCount), statistics.milliseconds, frameSeconds * 1000.0, culledSeconds * 1000.0);
+    }
+
+    return 0;
+}
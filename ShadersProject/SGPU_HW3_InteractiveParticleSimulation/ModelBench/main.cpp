@@ -0,0 +1,252 @@
+#include <gl/glew.h>
+#include <gl/freeglut.h>
+#include <Model.h>
+#include <Scene.h>
+#include <GLState.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*
+ * Batched model benchmark. An Obj file made of many small groups (a cube
+ * each, laid out on a square grid) is written with one material per group,
+ * cycling through the texture sets in textures/, and a material library
+ * naming their maps. It is then drawn two ways:
+ * as a Scene holding one Mesh per group (every group loaded from its own
+ * file, the way separate meshes are imported today) and as one Model built
+ * from the whole file, which takes its textures from the library. Load
+ * time, frame time and the GL calls of one frame are compared; finally every
+ * other group is hidden to show the multi-draw ranges of a partially
+ * visible model.
+ *
+ *   ModelBench [groups] [frames] [vertex shader] [fragment shader]
+ */
+
+const static int WINDOW_SIZE = 512;
+const static float FIELD_OF_VIEW = 45.0f;
+const static float SPACING = 3.0f;
+
+const static char* MATERIALS[] = { "bark", "brick", "brushed", "cleanwood", "pavers", "plate" };
+const static unsigned int MATERIAL_COUNT = sizeof(MATERIALS) / sizeof(MATERIALS[0]);
+
+const static char* GROUPS_FILENAME = "ModelBench_groups.obj";
+const static char* LIBRARY_FILENAME = "ModelBench_groups.mtl";
+const static char* GROUP_FILENAME = "ModelBench_group.obj";
+
+const static char* CALL_NAMES[GLState::CALL_COUNT] = { "program", "active texture", "texture", "buffer", "vertex array", "attribute", "uniform", "draw" };
+
+void PrintUsage() {
+    std::cout << "Usage: ModelBench [groups] [frames] [vertex shader] [fragment shader]" << std::endl;
+}
+
+double ElapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/* The shared texture coordinates and face normals of the cubes. */
+void WriteCubeAttributes(std::ostream& out) {
+    out << "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n";
+    out << "vn 1 0 0\nvn -1 0 0\nvn 0 1 0\nvn 0 -1 0\nvn 0 0 1\nvn 0 0 -1\n";
+}
+
+/* A unit cube centred on (x, y, z) as 12 triangles; base is the index of its first vertex. */
+void WriteCube(std::ostream& out, float x, float y, float z, std::size_t base) {
+    for ( unsigned int i = 0; i < 8; i++ )
+        out << "v " << x + ((i & 1) ? 0.5f : -0.5f) << " " << y + ((i & 2) ? 0.5f : -0.5f) << " " << z + ((i & 4) ? 0.5f : -0.5f) << "\n";
+
+    const static unsigned int QUADS[6][4] = { { 1, 3, 7, 5 }, { 0, 4, 6, 2 }, { 2, 6, 7, 3 }, { 0, 1, 5, 4 }, { 4, 5, 7, 6 }, { 0, 2, 3, 1 } };
+    for ( unsigned int f = 0; f < 6; f++ ) {
+        std::size_t v[4];
+        for ( unsigned int c = 0; c < 4; c++ ) v[c] = base + QUADS[f][c] + 1;
+        out << "f " << v[0] << "/1/" << f + 1 << " " << v[1] << "/2/" << f + 1 << " " << v[2] << "/3/" << f + 1 << "\n";
+        out << "f " << v[0] << "/1/" << f + 1 << " " << v[2] << "/3/" << f + 1 << " " << v[3] << "/4/" << f + 1 << "\n";
+    }
+}
+
+Vector3f GroupPosition(int group, int side) {
+    float half = 0.5f * SPACING * (side - 1);
+    return Vector3f(SPACING * (group % side) - half, 0.0f, SPACING * (group / side) - half);
+}
+
+bool WriteFiles(int groupCount, int side) {
+    std::ofstream groups(GROUPS_FILENAME);
+    std::ofstream group(GROUP_FILENAME);
+    std::ofstream library(LIBRARY_FILENAME);
+    if ( !groups.is_open() || !group.is_open() || !library.is_open() ) {
+        std::cerr << "[ModelBench] Error: Could not write the Obj files." << std::endl;
+        return false;
+    }
+
+    for ( unsigned int m = 0; m < MATERIAL_COUNT; m++ ) {
+        library << "newmtl " << MATERIALS[m] << "\nKd 0.8 0.8 0.8\nKs 1 1 1\nNs 16\n";
+        library << "map_Kd textures/" << MATERIALS[m] << "_diffuse.png\n";
+        library << "map_Bump textures/" << MATERIALS[m] << "_normal.png\n";
+        library << "map_Ks textures/" << MATERIALS[m] << "_specular.png\n\n";
+    }
+
+    groups << "mtllib " << LIBRARY_FILENAME << "\n";
+    WriteCubeAttributes(groups);
+    for ( int g = 0; g < groupCount; g++ ) {
+        Vector3f position = GroupPosition(g, side);
+        groups << "g part" << g << "\nusemtl " << MATERIALS[g % MATERIAL_COUNT] << "\n";
+        WriteCube(groups, position.x(), position.y(), position.z(), 8 * static_cast<std::size_t>(g));
+    }
+
+    WriteCubeAttributes(group);
+    WriteCube(group, 0.0f, 0.0f, 0.0f, 0);
+    return true;
+}
+
+/* Issued GL calls of one frame, drawn once before counting. */
+template <typename Render>
+GLState::Statistics CountCalls(Render render) {
+    render();
+    GLState::ResetStatistics();
+    render();
+    glFinish();
+    return GLState::GetStatistics();
+}
+
+int main(int argc, char* argv[]) {
+    if ( argc > 1 && std::atoi(argv[1]) <= 0 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    int groupCount = (argc > 1) ? std::atoi(argv[1]) : 2000;
+    int frames = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 10;
+    std::string vertexShader = (argc > 3) ? argv[3] : "shaders/SpecularMapping.vert";
+    std::string fragmentShader = (argc > 4) ? argv[4] : "shaders/SpecularMapping.frag";
+
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+    glutInitWindowSize(WINDOW_SIZE, WINDOW_SIZE);
+    glutCreateWindow("ModelBench");
+    glewInit();
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, WINDOW_SIZE, WINDOW_SIZE);
+
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(groupCount))));
+    if ( !WriteFiles(groupCount, side) ) return 1;
+
+    //--------------------------------------------------------------------------
+    // One program; every material is a copy of it with its own texture set.
+    //--------------------------------------------------------------------------
+    Model model;
+    if ( !model.loadShader(vertexShader, fragmentShader) ) return 1;
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    const char* suffixes[3] = { "_diffuse.png", "_normal.png", "_specular.png" };
+    std::vector<std::shared_ptr<Shader>> materials;
+    for ( unsigned int m = 0; m < MATERIAL_COUNT; m++ ) {
+        std::shared_ptr<Shader> shader = std::make_shared<Shader>(*model.getShader());
+        std::shared_ptr<Texture> textures[3];
+        for ( unsigned int t = 0; t < 3; t++ ) {
+            textures[t] = std::make_shared<Texture>();
+            if ( !textures[t]->load(std::string("textures/") + MATERIALS[m] + suffixes[t]) ) return 1;
+        }
+
+        shader->diffuseTexture = textures[0];
+        shader->normalTexture = textures[1];
+        shader->specularTexture = textures[2];
+        materials.push_back(shader);
+    }
+    double texturesMilliseconds = ElapsedMilliseconds(start);
+
+    //--------------------------------------------------------------------------
+    // Separate meshes: one load per group, placed by the scene.
+    //--------------------------------------------------------------------------
+    start = std::chrono::high_resolution_clock::now();
+    Scene scene;
+    for ( int g = 0; g < groupCount; g++ ) {
+        std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+        if ( !mesh->load(GROUP_FILENAME) ) return 1;
+        mesh->setShader(materials[g % MATERIAL_COUNT]);
+
+        Transformationf transform;
+        transform.setPosition(GroupPosition(g, side));
+        scene.add(mesh, transform);
+    }
+    double meshesMilliseconds = ElapsedMilliseconds(start);
+
+    //--------------------------------------------------------------------------
+    // One model: the whole file, a submesh per group. Its textures decode in
+    // the background from the moment the library is read.
+    //--------------------------------------------------------------------------
+    start = std::chrono::high_resolution_clock::now();
+    if ( !model.load(GROUPS_FILENAME) ) return 1;
+    double modelMilliseconds = ElapsedMilliseconds(start);
+
+    const ModelImportStatistics& imported = model.getImportStatistics();
+    std::printf("groups:     %d (%u materials), %u triangles, %u vertices\n", groupCount, MATERIAL_COUNT,
+        static_cast<unsigned int>(imported.triangleCount), static_cast<unsigned int>(imported.vertexCount));
+    std::printf("submeshes:  %u in %u materials\n", static_cast<unsigned int>(imported.submeshCount), static_cast<unsigned int>(imported.materialCount));
+    std::printf("load ms:    meshes %.1f + textures %.1f, model %.1f with %u textures (parse %.1f, build %.1f, texture wait and upload %.1f)\n",
+        meshesMilliseconds, texturesMilliseconds, modelMilliseconds, static_cast<unsigned int>(imported.textureCount),
+        imported.parseMilliseconds, imported.buildMilliseconds, imported.textureMilliseconds);
+
+    //--------------------------------------------------------------------------
+    // The camera looks down on the whole grid at an angle.
+    //--------------------------------------------------------------------------
+    float extent = SPACING * side;
+    Cameraf camera;
+    camera.setPerspective(FIELD_OF_VIEW, 1.0f, 0.1f, 4.0f * extent);
+    camera.setPosition(1.2f * extent, 0.3f, 0.8f);
+    camera.setLookAt(Vector3f(0.0f, 0.0f, 0.0f));
+    Vector3f lightPosition(0.0f, extent, extent);
+    scene.cull(camera);
+
+    double meshesFrame = 0.0;
+    double modelFrame = 0.0;
+    for ( int f = 0; f < frames; f++ ) {
+        start = std::chrono::high_resolution_clock::now();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        scene.render(camera, lightPosition);
+        glFinish();
+        meshesFrame += ElapsedMilliseconds(start);
+
+        start = std::chrono::high_resolution_clock::now();
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        model.render(camera, lightPosition);
+        glFinish();
+        modelFrame += ElapsedMilliseconds(start);
+        glutSwapBuffers();
+    }
+
+    std::printf("ms/frame:   meshes %.2f, model %.2f (%u visible meshes, %u model draws)\n", meshesFrame / frames, modelFrame / frames,
+        static_cast<unsigned int>(scene.getVisibleObjects().size()), static_cast<unsigned int>(model.getDrawCount()));
+
+    //--------------------------------------------------------------------------
+    // GL calls of one frame.
+    //--------------------------------------------------------------------------
+    GLState::Statistics statistics[2];
+    statistics[0] = CountCalls([&]() { scene.render(camera, lightPosition); });
+    statistics[1] = CountCalls([&]() { model.render(camera, lightPosition); });
+
+    std::printf("%-15s  %-8s  %s\n", "call", "meshes", "model");
+    std::size_t totals[2] = { 0, 0 };
+    for ( unsigned int call = 0; call < GLState::CALL_COUNT; call++ ) {
+        std::printf("%-15s  %-8u  %u\n", CALL_NAMES[call], static_cast<unsigned int>(statistics[0].issued[call]), static_cast<unsigned int>(statistics[1].issued[call]));
+        totals[0] += statistics[0].issued[call];
+        totals[1] += statistics[1].issued[call];
+    }
+    std::printf("%-15s  %-8u  %u\n", "total", static_cast<unsigned int>(totals[0]), static_cast<unsigned int>(totals[1]));
+
+    //--------------------------------------------------------------------------
+    // Every other group hidden: the draws stay one per material, each with
+    // one range per visible run of submeshes.
+    //--------------------------------------------------------------------------
+    for ( std::size_t i = 0; i < model.getSubmeshes().size(); i += 2 ) model.setSubmeshVisible(i, false);
+    start = std::chrono::high_resolution_clock::now();
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    model.render(camera, lightPosition);
+    glFinish();
+    std::printf("half hidden: %u draws, %u ranges, %.2f ms\n", static_cast<unsigned int>(model.getDrawCount()),
+        static_cast<unsigned int>(model.getDrawRangeCount()), ElapsedMilliseconds(start));
+    return 0;
+}
@@ -0,0 +1,275 @@
+#include <ObjMesh.h>
+#include <ObjWriter.h>
+#include <Parallel.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/*
+ * Headless benchmark of the Obj export. A grid of triangles with texture
+ * coordinates, normals, groups and materials is saved three ways: through
+ * std::ostream with std::fixed, a precision of 6 and std::endl after every
+ * line (the exporter ObjFile::save replaced), with ObjFile::save, and as
+ * welded triangles with SaveObjTriangles (the Mesh::save path). The file of
+ * ObjFile::save is loaded back and has to match the grid bit for bit.
+ * Finally random float bit patterns are formatted with FormatFloat: every
+ * text has to read back as the same float and no shorter %g text may.
+ *
+ *   ObjExportBench [quads per side] [repeat]
+ */
+
+const static std::size_t DEFAULT_SIDE = 708;
+const static std::size_t GROUP_ROWS = 64;
+const static unsigned int FLOAT_CHECK_COUNT = 1000000;
+const static unsigned int SHORTEST_CHECK_COUNT = 100000;
+
+double ElapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+double FileMegabytes(const std::string& filename) {
+    std::ifstream size(filename.c_str(), std::ios::binary | std::ios::ate);
+    return static_cast<double>(size.tellg()) / (1024.0 * 1024.0);
+}
+
+/* A side x side grid on a curved surface, two triangles per quad. */
+void GenerateGrid(std::size_t side, ObjFile& file, std::vector<Vertex>& vertices, std::vector<TriangleFace>& faces) {
+    std::shared_ptr<ObjMesh> mesh = file.getMesh(file.addMesh("grid"));
+    file.addGroup(0, "DefaultGroup");
+    file.addMaterial(0, "DefaultMaterial");
+    std::size_t materials[2] = { file.addMaterial("stone"), file.addMaterial("moss") };
+
+    std::size_t stride = side + 1;
+    for ( std::size_t z = 0; z <= side; z++ ) {
+        for ( std::size_t x = 0; x <= side; x++ ) {
+            float u = static_cast<float>(x) / side;
+            float v = static_cast<float>(z) / side;
+            float height = 0.25f * std::sin(7.0f * u) * std::cos(5.0f * v);
+            Vector3f normal = Vector3f(-1.75f * std::cos(7.0f * u) * std::cos(5.0f * v), 1.0f, 1.25f * std::sin(7.0f * u) * std::sin(5.0f * v));
+            normal.normalize();
+
+            Vertex vertex;
+            vertex.position = Vector3f(u * 10.0f - 5.0f, height, v * 10.0f - 5.0f);
+            vertex.normal = normal;
+            vertex.tangent = Vector4f(1.0f, 0.0f, 0.0f, 1.0f);
+            vertex.textureCoord = Vector3f(u, v, 0.0f);
+            vertex.color = Color3f(0.0f, 0.0f, 0.0f);
+            vertices.push_back(vertex);
+
+            mesh->vertices.push_back(vertex.position);
+            mesh->normals.push_back(vertex.normal);
+            mesh->textureCoordinates.push_back(vertex.textureCoord);
+        }
+    }
+
+    Obj_Face face;
+    face.type = TRIANGLE;
+    face.smoothingGroupIndex = 1;
+    for ( std::size_t z = 0; z < side; z++ ) {
+        if ( z % GROUP_ROWS == 0 ) face.groupIndex = file.addGroup("rows" + std::to_string(z));
+
+        for ( std::size_t x = 0; x < side; x++ ) {
+            std::size_t corner = z * stride + x;
+            std::size_t triangles[2][3] = { { corner, corner + stride, corner + stride + 1 }, { corner, corner + stride + 1, corner + 1 } };
+            face.materialIndex = materials[(x / 16 + z / 16) % 2];
+
+            for ( unsigned int t = 0; t < 2; t++ ) {
+                face.vertexIndices.assign(triangles[t], triangles[t] + 3);
+                face.textureIndices = face.vertexIndices;
+                face.normalIndices = face.vertexIndices;
+                mesh->faces.push_back(face);
+
+                TriangleFace triangle;
+                for ( unsigned int i = 0; i < 3; i++ ) triangle.indices[i] = static_cast<unsigned int>(triangles[t][i]);
+                faces.push_back(triangle);
+            }
+        }
+    }
+}
+
+/* The exporter ObjFile::save replaced: fixed precision 6 and a flush per line. */
+bool SaveReference(const std::string& filename, const ObjFile& file) {
+    std::ofstream out(filename.c_str());
+    if ( !out.is_open() ) return false;
+    out << std::fixed << std::setprecision(6);
+
+    const std::shared_ptr<ObjMesh> mesh = file.getMesh(0);
+    for ( std::size_t i = 0; i < mesh->vertices.size(); i++ )
+        out << "v " << mesh->vertices[i].x() << " " << mesh->vertices[i].y() << " " << mesh->vertices[i].z() << std::endl;
+    for ( std::size_t i = 0; i < mesh->textureCoordinates.size(); i++ )
+        out << "vt " << mesh->textureCoordinates[i].x() << " " << mesh->textureCoordinates[i].y() << " " << mesh->textureCoordinates[i].z() << std::endl;
+    for ( std::size_t i = 0; i < mesh->normals.size(); i++ )
+        out << "vn " << mesh->normals[i].x() << " " << mesh->normals[i].y() << " " << mesh->normals[i].z() << std::endl;
+
+    for ( std::size_t f = 0; f < mesh->faces.size(); f++ ) {
+        const Obj_Face& face = mesh->faces[f];
+        out << "f ";
+        for ( std::size_t i = 0; i < face.vertexIndices.size(); i++ )
+            out << face.vertexIndices[i] + 1 << "/" << face.textureIndices[i] + 1 << "/" << face.normalIndices[i] + 1 << " ";
+        out << std::endl;
+    }
+
+    return out.good();
+}
+
+bool SameBits(const std::vector<Vector3f>& a, const std::vector<Vector3f>& b) {
+    if ( a.size() != b.size() ) return false;
+    for ( std::size_t i = 0; i < a.size(); i++ ) {
+        for ( unsigned int axis = 0; axis < 3; axis++ )
+            if ( std::memcmp(&a[i][axis], &b[i][axis], sizeof(float)) != 0 ) return false;
+    }
+
+    return true;
+}
+
+/* Compares the reloaded file with the grid: attributes bit for bit, faces and their group and material names. */
+bool CheckReload(const ObjFile& saved, const ObjFile& loaded) {
+    if ( loaded.getMeshCount() != 1 ) return false;
+    const std::shared_ptr<ObjMesh> a = saved.getMesh(0);
+    const std::shared_ptr<ObjMesh> b = loaded.getMesh(0);
+    if ( !SameBits(a->vertices, b->vertices) || !SameBits(a->normals, b->normals) || !SameBits(a->textureCoordinates, b->textureCoordinates) ) return false;
+    if ( a->faces.size() != b->faces.size() ) return false;
+
+    for ( std::size_t i = 0; i < a->faces.size(); i++ ) {
+        const Obj_Face& x = a->faces[i];
+        const Obj_Face& y = b->faces[i];
+        if ( x.vertexIndices != y.vertexIndices || x.textureIndices != y.textureIndices || x.normalIndices != y.normalIndices ) return false;
+        if ( x.smoothingGroupIndex != y.smoothingGroupIndex ) return false;
+        if ( saved.getFaceGroup(x.groupIndex) != loaded.getFaceGroup(y.groupIndex) ) return false;
+        if ( saved.getFaceMaterial(x.materialIndex) != loaded.getFaceMaterial(y.materialIndex) ) return false;
+    }
+
+    return true;
+}
+
+/* Random finite float of any magnitude (xorshift over the bit pattern). */
+float RandomFloat(unsigned int& state) {
+    float value = 0.0f;
+    do {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        std::memcpy(&value, &state, sizeof(value));
+    } while ( !std::isfinite(value) );
+
+    return value;
+}
+
+int main(int argc, char* argv[]) {
+    std::size_t side = (argc > 1) ? static_cast<std::size_t>(std::max(1, std::atoi(argv[1]))) : DEFAULT_SIDE;
+    int repeat = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 3;
+
+    ObjFile file;
+    std::vector<Vertex> vertices;
+    std::vector<TriangleFace> faces;
+    GenerateGrid(side, file, vertices, faces);
+    std::printf("grid:      %u vertices, %u faces, %u threads\n", static_cast<unsigned int>(vertices.size()), static_cast<unsigned int>(faces.size()), ParallelThreadCount());
+
+    //--------------------------------------------------------------------------
+    // Best of repeat runs of every exporter.
+    //--------------------------------------------------------------------------
+    const char* names[3] = { "reference", "ObjFile", "triangles" };
+    const char* filenames[3] = { "ObjExportBench_reference.obj", "ObjExportBench_file.obj", "ObjExportBench_triangles.obj" };
+    double best[3] = { 1.0e30, 1.0e30, 1.0e30 };
+
+    for ( int r = 0; r < repeat; r++ ) {
+        for ( unsigned int e = 0; e < 3; e++ ) {
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+            bool saved = false;
+            if ( e == 0 ) saved = SaveReference(filenames[e], file);
+            else if ( e == 1 ) saved = file.save(filenames[e]);
+            else saved = SaveObjTriangles(filenames[e], "grid", vertices, faces);
+
+            if ( !saved ) {
+                std::cerr << "[ObjExportBench] Error: Could not save: " << filenames[e] << std::endl;
+                return 1;
+            }
+
+            best[e] = std::min(best[e], ElapsedMilliseconds(start));
+        }
+    }
+
+    std::printf("exporter   ms        MB        MB/s\n");
+    for ( unsigned int e = 0; e < 3; e++ ) {
+        double megabytes = FileMegabytes(filenames[e]);
+        std::printf("%-9s  %-8.1f  %-8.1f  %.1f\n", names[e], best[e], megabytes, megabytes * 1000.0 / best[e]);
+    }
+
+    //--------------------------------------------------------------------------
+    // Round trip of ObjFile::save.
+    //--------------------------------------------------------------------------
+    ObjFile loaded;
+    if ( !loaded.load(filenames[1]) ) return 1;
+    bool identical = CheckReload(file, loaded);
+    std::printf("reload:    %s\n", identical ? "identical" : "DIFFERENT");
+
+    //--------------------------------------------------------------------------
+    // FormatFloat over random bit patterns: exact round trip, and for a subset
+    // no shorter %g text that reads back.
+    //--------------------------------------------------------------------------
+    unsigned int state = 2463534242u;
+    std::size_t mismatches = 0, longer = 0, characters = 0;
+    char text[FORMAT_BUFFER_SIZE];
+    char shorter[FORMAT_BUFFER_SIZE];
+
+    //--------------------------------------------------------------------------
+    // Random bit patterns are mostly beyond the digit search (exponents past
+    // +-12); the coordinates of models are timed separately, as the attributes
+    // of the grid.
+    //--------------------------------------------------------------------------
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for ( unsigned int i = 0; i < FLOAT_CHECK_COUNT; i++ ) characters += FormatFloat(RandomFloat(state), text);
+    double formatMilliseconds = ElapsedMilliseconds(start);
+
+    const std::vector<Vector3f>& positions = file.getMesh(0)->vertices;
+    std::size_t attributeCount = 3 * positions.size();
+    start = std::chrono::high_resolution_clock::now();
+    for ( std::size_t i = 0; i < positions.size(); i++ )
+        for ( unsigned int axis = 0; axis < 3; axis++ ) characters += FormatFloat(positions[i][axis], text);
+    double attributeMilliseconds = ElapsedMilliseconds(start);
+
+    state = 2463534242u;
+    for ( unsigned int i = 0; i < FLOAT_CHECK_COUNT; i++ ) {
+        float value = RandomFloat(state);
+        FormatFloat(value, text);
+        if ( std::strtof(text, nullptr) != value ) mismatches++;
+
+        if ( i < SHORTEST_CHECK_COUNT ) {
+            //------------------------------------------------------------------
+            // Significant digits of the text: from the first to the last
+            // non-zero digit before the exponent.
+            //------------------------------------------------------------------
+            int digits = 0, counted = 0;
+            bool leading = true;
+            for ( const char* c = text; *c != '\0' && *c != 'e'; c++ ) {
+                if ( *c < '0' || *c > '9' ) continue;
+                if ( leading && *c == '0' ) continue;
+                leading = false;
+                counted++;
+                if ( *c != '0' ) digits = counted;
+            }
+
+            for ( int d = 1; d < digits; d++ ) {
+                std::sprintf(shorter, "%.*g", d, value);
+                if ( std::strtof(shorter, nullptr) == value ) {
+                    longer++;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::printf("format:    %.1f ns per random bit pattern, %.1f ns per grid coordinate (%u characters)\n",
+        formatMilliseconds * 1.0e6 / FLOAT_CHECK_COUNT, attributeMilliseconds * 1.0e6 / attributeCount, static_cast<unsigned int>(characters));
+    std::printf("floats:    %u random bit patterns, %u mismatches, %u of %u not shortest\n",
+        FLOAT_CHECK_COUNT, static_cast<unsigned int>(mismatches), static_cast<unsigned int>(longer), SHORTEST_CHECK_COUNT);
+
+    return (identical && mismatches == 0 && longer == 0) ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+#include <gl/glew.h>
+#include <gl/freeglut.h>
+#include <ParticleRecording.h>
+#include <ParticleSystem.h>
+#include <TransformFeedbackParticleEngine.h>
+#include <Mesh.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/*
+ * Headless replay of particle recordings. The recording is simulated on the
+ * CPU at full speed without OpenGL, the throughput is reported and the final
+ * particle state is checksummed so runs can be compared across changes.
+ *
+ * --cross-check opens an OpenGL context (Mesa's software renderer is
+ * enough) and validates the particle engines with ParticleSystem::crossCheck:
+ * the CPU engine with particle collisions and, if a model is given, mesh
+ * collisions, then the TransformFeedbackParticleEngine, which simulates
+ * neither. It exits with 1 if an engine differs from the CPU reference.
+ *
+ *   ParticleReplay <recording> [repeat]
+ *   ParticleReplay --generate <recording> <particles> <ticks> [seed]
+ *   ParticleReplay --cross-check [particles] [steps] [model.obj]
+ */
+
+const static float CROSS_CHECK_DT = 0.016f;
+const static float CROSS_CHECK_TOLERANCE = 1e-3f;
+const static float CROSS_CHECK_RADIUS = 0.05f;
+const static std::size_t CROSS_CHECK_WARMUP = 120;
+const static std::string PARTICLE_UPDATE_SHADER = "shaders/particleUpdate.vert";
+
+void PrintUsage() {
+    std::cout << "Usage: ParticleReplay <recording> [repeat]" << std::endl;
+    std::cout << "       ParticleReplay --generate <recording> <particles> <ticks> [seed]" << std::endl;
+    std::cout << "       ParticleReplay --cross-check [particles] [steps] [model.obj]" << std::endl;
+}
+
+/*
+ * Creates a synthetic recording: the spawn point circles around the origin
+ * spraying particles upwards, spawning pauses for a second every four seconds
+ * and the gravity and bounce energy change halfway through.
+ */
+bool GenerateRecording(const std::string& filename, std::size_t particleCount, std::size_t tickCount, unsigned int seed) {
+    ParticleParameters parameters = { 1.0f, 10.0f, 4.0f, 0.8f, 16.0f, 0.0f, Vector3f(0.0f, -9.8f, 0.0f), Color3f(0.3f, 0.2f, 1.0f) };
+    const float dt = 0.016f;
+
+    ParticleRecording recording;
+    recording.begin(particleCount, seed, parameters);
+
+    for ( std::size_t i = 0; i < tickCount; i++ ) {
+        float time = i * dt;
+        float angle = 0.5f * time;
+        Vector3f spawnPosition(4.0f * std::cos(angle), 6.0f, 4.0f * std::sin(angle));
+        Vector3f spawnDirection(-std::sin(angle), 1.0f, std::cos(angle));
+        spawnDirection.normalize();
+
+        if ( i == tickCount / 2 ) {
+            parameters.gravity = Vector3f(0.0f, -4.9f, 0.0f);
+            parameters.bounceEnergy = 0.5f;
+        }
+
+        bool spawnParticles = std::fmod(time, 4.0f) < 3.0f;
+        recording.record(spawnParticles, spawnPosition, spawnDirection, dt, parameters);
+    }
+
+    return recording.save(filename);
+}
+
+bool CrossCheck(ParticleSystem& system, const std::string& name, std::size_t steps) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    bool passed = system.crossCheck(steps, CROSS_CHECK_DT, CROSS_CHECK_TOLERANCE);
+    std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+    std::printf("%-48s %s (%.1f ms)\n", name.c_str(), passed ? "passed" : "FAILED", std::chrono::duration<double, std::milli>(end - start).count());
+    return passed;
+}
+
+int CrossCheckEngines(int argc, char* argv[]) {
+    std::size_t particleCount = (argc > 2) ? static_cast<std::size_t>(std::max(1, std::atoi(argv[2]))) : 20000;
+    std::size_t steps = (argc > 3) ? static_cast<std::size_t>(std::max(1, std::atoi(argv[3]))) : 200;
+
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_RGBA);
+    glutCreateWindow("ParticleReplay");
+    glewInit();
+
+    //--------------------------------------------------------------------------
+    // Spawn on the CPU engine first, so the engines are compared on moving,
+    // bouncing particles of different ages rather than on the hidden reserve.
+    //--------------------------------------------------------------------------
+    ParticleSystem system;
+    system.setMaxParticleCount(particleCount);
+    for ( std::size_t i = 0; i < CROSS_CHECK_WARMUP; i++ ) {
+        float angle = 0.05f * i;
+        system.update(true, Vector3f(4.0f * std::cos(angle), 6.0f, 4.0f * std::sin(angle)), Vector3f(0.0f, 1.0f, 0.0f), CROSS_CHECK_DT);
+    }
+
+    bool passed = true;
+    Mesh mesh;
+    if ( argc > 4 ) {
+        if ( !mesh.load(argv[4]) || !system.setCollisionMesh(mesh) ) return 1;
+    }
+
+    system.setParticleRadius(CROSS_CHECK_RADIUS);
+    passed = CrossCheck(system, (argc > 4) ? "CpuParticleEngine, particle and mesh collisions" : "CpuParticleEngine, particle collisions", steps) && passed;
+    system.setParticleRadius(0.0f);
+    system.clearCollisionMesh();
+
+    std::shared_ptr<TransformFeedbackParticleEngine> engine = std::make_shared<TransformFeedbackParticleEngine>();
+    if ( !engine->loadShader(PARTICLE_UPDATE_SHADER) || !system.setEngine(engine) ) return 1;
+    passed = CrossCheck(system, "TransformFeedbackParticleEngine", steps) && passed;
+
+    if ( !passed ) {
+        std::cerr << "[ParticleReplay] Error: A particle engine differs from the CPU reference." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if ( argc < 2 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    if ( command == "--cross-check" ) return CrossCheckEngines(argc, argv);
+
+    if ( command == "--generate" ) {
+        if ( argc < 5 ) {
+            PrintUsage();
+            return 1;
+        }
+
+        unsigned int seed = (argc > 5) ? static_cast<unsigned int>(std::atoi(argv[5])) : 0;
+        if ( !GenerateRecording(argv[2], std::atoi(argv[3]), std::atoi(argv[4]), seed) ) return 1;
+        std::cout << "Generated " << argv[2] << std::endl;
+        return 0;
+    }
+
+    ParticleRecording recording;
+    if ( !recording.load(command) ) return 1;
+
+    int repeat = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 1;
+    std::vector<Particle> particles;
+    unsigned long long checksum = 0;
+    double bestSeconds = 0.0;
+
+    //--------------------------------------------------------------------------
+    // Every repetition replays the recording from its initial state, so all
+    // of them must produce the same checksum. The fastest run is reported.
+    //--------------------------------------------------------------------------
+    for ( int r = 0; r < repeat; r++ ) {
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        if ( !ReplayRecording(recording, particles) ) return 1;
+        std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        if ( r == 0 || seconds < bestSeconds ) bestSeconds = seconds;
+
+        unsigned long long runChecksum = ParticleChecksum(particles);
+        if ( r > 0 && runChecksum != checksum ) {
+            std::cerr << "[ParticleReplay] Error: Replay is not deterministic." << std::endl;
+            return 1;
+        }
+        checksum = runChecksum;
+    }
+
+    double ticks = static_cast<double>(recording.getTickCount());
+    double particleCount = static_cast<double>(recording.getParticleCount());
+    std::printf("particles:   %u\n", static_cast<unsigned int>(recording.getParticleCount()));
+    std::printf("ticks:       %u\n", static_cast<unsigned int>(recording.getTickCount()));
+    std::printf("time:        %.3f s\n", bestSeconds);
+    std::printf("ticks/s:     %.1f\n", ticks / bestSeconds);
+    std::printf("particles/s: %.3e\n", ticks * particleCount / bestSeconds);
+    std::printf("checksum:    %016llx\n", checksum);
+    return 0;
+}
@@ -0,0 +1,206 @@
+#include <QuaternionBatch.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+ * Headless benchmark and accuracy test of the batch quaternion kernels
+ * (QuaternionBatch.h). Random pairs of unit quaternions, a third of them
+ * nearly identical, are interpolated, converted to matrices and compressed:
+ *
+ *   - batch slerp is compared with a slerp evaluated in double precision,
+ *   - batch nlerp with Quaternion::Nlerp,
+ *   - QuaternionsToMatrices with Quaternion::toRotationMatrix,
+ *   - decoded quaternions with the encoded ones (component and angle error).
+ *
+ * The throughput of every kernel is then measured in rotations per second,
+ * with the scalar Quaternion::Slerp for comparison.
+ *
+ *   QuaternionBench [count] [repeat]
+ */
+
+const static std::size_t DEFAULT_COUNT = 1024;
+const static std::size_t DEFAULT_REPEAT = 2000;
+const static double MAX_INTERPOLATION_ERROR = 1.0e-6;
+const static double MAX_MATRIX_ERROR = 1.0e-6;
+const static double MAX_DECODE_ERROR = 1.0e-4;
+const static double MAX_DECODE_ANGLE = 2.5e-4;
+
+void PrintUsage() {
+    std::cout << "Usage: QuaternionBench [count] [repeat]" << std::endl;
+}
+
+double ElapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/* Random unit quaternion, normalized in double precision. */
+void RandomQuaternion(std::mt19937& random, float* q) {
+    std::normal_distribution<double> normal(0.0, 1.0);
+    double v[4] = { normal(random), normal(random), normal(random), normal(random) };
+    double length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3]);
+    for ( unsigned int k = 0; k < 4; k++ ) q[k] = static_cast<float>(v[k] / length);
+}
+
+Quaternionf ToQuaternion(const float* q) {
+    Quaternionf result(false);
+    result.set(q[0], q[1], q[2], q[3]);
+    return result;
+}
+
+/* Slerp along the shorter arc, evaluated in double precision. */
+void ReferenceSlerp(const float* a, const float* b, float t, double* out) {
+    double cosTheta = 0.0;
+    for ( unsigned int k = 0; k < 4; k++ ) cosTheta += static_cast<double>(a[k]) * b[k];
+    double sign = (cosTheta < 0.0) ? -1.0 : 1.0;
+    cosTheta = std::min(1.0, cosTheta * sign);
+
+    double wa = 1.0 - t;
+    double wb = t;
+    double theta = std::acos(cosTheta);
+    if ( theta > 1.0e-12 ) {
+        wa = std::sin((1.0 - t) * theta) / std::sin(theta);
+        wb = std::sin(t * theta) / std::sin(theta);
+    }
+
+    for ( unsigned int k = 0; k < 4; k++ ) out[k] = wa * a[k] + sign * wb * b[k];
+}
+
+/* Times fn repeat times and returns millions of rotations per second. */
+template <typename Function>
+double Throughput(std::size_t count, std::size_t repeat, Function fn) {
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    for ( std::size_t r = 0; r < repeat; r++ ) fn();
+    double ms = ElapsedMilliseconds(start);
+    return static_cast<double>(count * repeat) / (ms * 1.0e3);
+}
+
+int main(int argc, char** argv) {
+    if ( argc > 3 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    std::size_t count = (argc > 1) ? static_cast<std::size_t>(std::atol(argv[1])) : DEFAULT_COUNT;
+    std::size_t repeat = (argc > 2) ? static_cast<std::size_t>(std::atol(argv[2])) : DEFAULT_REPEAT;
+    if ( count == 0 || repeat == 0 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    //--------------------------------------------------------------------------
+    // Every third pair is nearly identical (the rotation between two frames
+    // of a dense animation track), the others are far apart.
+    //--------------------------------------------------------------------------
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<float> a(4 * count), b(4 * count), t(count);
+    for ( std::size_t i = 0; i < count; i++ ) {
+        RandomQuaternion(random, &a[4 * i]);
+        RandomQuaternion(random, &b[4 * i]);
+        if ( i % 3 == 0 ) {
+            for ( unsigned int k = 0; k < 4; k++ ) b[4 * i + k] = a[4 * i + k] + 1.0e-4f * (b[4 * i + k] - 0.5f);
+            float length = std::sqrt(b[4 * i] * b[4 * i] + b[4 * i + 1] * b[4 * i + 1] + b[4 * i + 2] * b[4 * i + 2] + b[4 * i + 3] * b[4 * i + 3]);
+            for ( unsigned int k = 0; k < 4; k++ ) b[4 * i + k] /= length;
+        }
+        t[i] = unit(random);
+    }
+
+    std::vector<float> slerped(4 * count), nlerped(4 * count), decoded(4 * count), matrices(16 * count);
+    std::vector<CompressedQuaternion> compressed(count);
+
+    SlerpQuaternions(&a[0], &b[0], &t[0], &slerped[0], count);
+    NlerpQuaternions(&a[0], &b[0], &t[0], &nlerped[0], count);
+    QuaternionsToMatrices(&a[0], &matrices[0], count);
+    EncodeQuaternions(&a[0], &compressed[0], count);
+    DecodeQuaternions(&compressed[0], &decoded[0], count);
+
+    //--------------------------------------------------------------------------
+    // Accuracy. q and -q are the same rotation, so the decoded quaternion is
+    // compared with the sign that matches the encoded one. The rotation angle
+    // between them is measured through the chord |q - d| = 2 sin(angle / 4)
+    // of the normalized quaternions, acos of their dot product is too
+    // ill-conditioned near 1.
+    //--------------------------------------------------------------------------
+    double slerpError = 0.0, nlerpError = 0.0, matrixError = 0.0, decodeError = 0.0, decodeAngle = 0.0;
+    for ( std::size_t i = 0; i < count; i++ ) {
+        double reference[4];
+        ReferenceSlerp(&a[4 * i], &b[4 * i], t[i], reference);
+        Quaternionf nlerp = Quaternionf::Nlerp(ToQuaternion(&a[4 * i]), ToQuaternion(&b[4 * i]), t[i]);
+        const float expected[4] = { nlerp.x(), nlerp.y(), nlerp.z(), nlerp.w() };
+
+        double dot = 0.0;
+        for ( unsigned int k = 0; k < 4; k++ ) dot += static_cast<double>(a[4 * i + k]) * decoded[4 * i + k];
+        double sign = (dot < 0.0) ? -1.0 : 1.0;
+
+        for ( unsigned int k = 0; k < 4; k++ ) {
+            slerpError = std::max(slerpError, std::abs(slerped[4 * i + k] - reference[k]));
+            nlerpError = std::max(nlerpError, static_cast<double>(std::abs(nlerped[4 * i + k] - expected[k])));
+            decodeError = std::max(decodeError, std::abs(sign * decoded[4 * i + k] - a[4 * i + k]));
+        }
+
+        double decodedLength = 0.0;
+        for ( unsigned int k = 0; k < 4; k++ ) decodedLength += static_cast<double>(decoded[4 * i + k]) * decoded[4 * i + k];
+        decodedLength = std::sqrt(decodedLength);
+
+        double chord = 0.0;
+        for ( unsigned int k = 0; k < 4; k++ ) {
+            double difference = sign * decoded[4 * i + k] / decodedLength - a[4 * i + k];
+            chord += difference * difference;
+        }
+        decodeAngle = std::max(decodeAngle, 4.0 * std::asin(std::min(1.0, 0.5 * std::sqrt(chord))));
+
+        RotationMatrix<float> rotation = ToQuaternion(&a[4 * i]).toRotationMatrix();
+        for ( unsigned int r = 0; r < 3; r++ )
+            for ( unsigned int c = 0; c < 3; c++ )
+                matrixError = std::max(matrixError, static_cast<double>(std::abs(matrices[16 * i + 4 * r + c] - rotation(r, c))));
+    }
+
+    std::printf("%u quaternions, %u repeats\n\n", static_cast<unsigned int>(count), static_cast<unsigned int>(repeat));
+    std::printf("Max error:\n");
+    std::printf("  %-40s %10.2e\n", "slerp vs double precision slerp", slerpError);
+    std::printf("  %-40s %10.2e\n", "nlerp vs Quaternion::Nlerp", nlerpError);
+    std::printf("  %-40s %10.2e\n", "matrices vs Quaternion::toRotationMatrix", matrixError);
+    std::printf("  %-40s %10.2e\n", "decoded component", decodeError);
+    std::printf("  %-40s %10.2e rad\n", "decoded rotation angle", decodeAngle);
+    std::printf("  %-40s %10u vs %u bytes\n", "compressed size", static_cast<unsigned int>(sizeof(CompressedQuaternion)), static_cast<unsigned int>(4 * sizeof(float)));
+
+    //--------------------------------------------------------------------------
+    // Throughput.
+    //--------------------------------------------------------------------------
+    std::vector<float> output(16 * count);
+    double nlerpRate = Throughput(count, repeat, [&]() { NlerpQuaternions(&a[0], &b[0], &t[0], &output[0], count); });
+    double slerpRate = Throughput(count, repeat, [&]() { SlerpQuaternions(&a[0], &b[0], &t[0], &output[0], count); });
+    double scalarRate = Throughput(count, repeat, [&]() {
+        for ( std::size_t i = 0; i < count; i++ ) {
+            Quaternionf q = Quaternionf::Slerp(ToQuaternion(&a[4 * i]), ToQuaternion(&b[4 * i]), t[i]);
+            output[4 * i] = q.x();
+        }
+    });
+    double matrixRate = Throughput(count, repeat, [&]() { QuaternionsToMatrices(&a[0], &output[0], count); });
+    double encodeRate = Throughput(count, repeat, [&]() { EncodeQuaternions(&a[0], &compressed[0], count); });
+    double decodeRate = Throughput(count, repeat, [&]() { DecodeQuaternions(&compressed[0], &output[0], count); });
+
+    std::printf("\nMillion rotations per second:\n");
+    std::printf("  %-40s %10.1f\n", "NlerpQuaternions", nlerpRate);
+    std::printf("  %-40s %10.1f\n", "SlerpQuaternions", slerpRate);
+    std::printf("  %-40s %10.1f\n", "Quaternion::Slerp (scalar)", scalarRate);
+    std::printf("  %-40s %10.1f\n", "QuaternionsToMatrices", matrixRate);
+    std::printf("  %-40s %10.1f\n", "EncodeQuaternions", encodeRate);
+    std::printf("  %-40s %10.1f\n", "DecodeQuaternions", decodeRate);
+    std::printf("\n(checksum %g)\n", output[0]);
+
+    bool accurate = slerpError <= MAX_INTERPOLATION_ERROR && nlerpError <= MAX_INTERPOLATION_ERROR &&
+                    matrixError <= MAX_MATRIX_ERROR && decodeError <= MAX_DECODE_ERROR && decodeAngle <= MAX_DECODE_ANGLE;
+    if ( !accurate ) {
+        std::cerr << "[QuaternionBench] Error: The batch kernels exceed their error bounds." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
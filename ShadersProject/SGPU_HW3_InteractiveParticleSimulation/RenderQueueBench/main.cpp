@@ -0,0 +1,274 @@
+#include <gl/glew.h>
+#include <gl/freeglut.h>
+#include <Scene.h>
+#include <RenderQueue.h>
+#include <MaterialArrays.h>
+#include <GLState.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+
+/*
+ * Render queue benchmark. A synthetic scene of several models, programs and
+ * texture sets is laid out on a cubic grid in random order, so drawing it
+ * in submission order changes program and textures almost every draw. The
+ * same frame is drawn in submission order (Scene::render) and through a
+ * RenderQueue, and the state changes and GL calls of both are counted (see
+ * GLState). Then the grid is drawn with one program and a random material
+ * per object, through the queue with a 2D texture set per material and with
+ * the materials packed into texture arrays (see MaterialArrays).
+ *
+ *   RenderQueueBench [objects] [frames]
+ */
+
+const static int WINDOW_SIZE = 512;
+const static float FIELD_OF_VIEW = 45.0f;
+const static unsigned int RANDOM_SEED = 7;
+
+const static char* MODELS[] = { "modellib/cube.obj", "modellib/sphere.obj", "modellib/torus.obj", "modellib/teapot.obj" };
+const static char* PROGRAMS[][2] = {
+    { "shaders/PhongShading.vert", "shaders/PhongShading.frag" },
+    { "shaders/vertexShader.vert", "shaders/fragmentShader.frag" },
+    { "shaders/SpecularMapping.vert", "shaders/SpecularMapping.frag" },
+    { "shaders/SpotLights.vert", "shaders/SpotLights.frag" }
+};
+const static char* MATERIALS[] = { "bark", "brick", "brushed", "cleanwood", "pavers", "plate" };
+
+const static unsigned int MODEL_COUNT = sizeof(MODELS) / sizeof(MODELS[0]);
+const static unsigned int PROGRAM_COUNT = sizeof(PROGRAMS) / sizeof(PROGRAMS[0]);
+const static unsigned int MATERIAL_COUNT = sizeof(MATERIALS) / sizeof(MATERIALS[0]);
+
+/* Program of the material comparison and its texture array version */
+const static unsigned int MATERIAL_PROGRAM = 2;
+const static char* ARRAY_FRAGMENT_SHADER = "shaders/SpecularMappingArray.frag";
+
+const static char* CALL_NAMES[GLState::CALL_COUNT] = { "program", "active texture", "texture", "buffer", "vertex array", "attribute", "uniform", "draw" };
+
+/* Program, texture and vertex array binds actually issued. */
+std::size_t StateChanges(const GLState::Statistics& statistics) {
+    return statistics.issued[GLState::USE_PROGRAM] + statistics.issued[GLState::ACTIVE_TEXTURE] +
+        statistics.issued[GLState::BIND_TEXTURE] + statistics.issued[GLState::BIND_VERTEX_ARRAY];
+}
+
+double ElapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int objectCount = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 5000;
+    int frames = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 5;
+
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+    glutInitWindowSize(WINDOW_SIZE, WINDOW_SIZE);
+    glutCreateWindow("RenderQueueBench");
+    glewInit();
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, WINDOW_SIZE, WINDOW_SIZE);
+
+    //--------------------------------------------------------------------------
+    // One shader per program and a copy of it per texture set; the copies
+    // share the program (see Shader::bindTextures). Every model is loaded
+    // once per shader, since a mesh draws with a single shader.
+    //--------------------------------------------------------------------------
+    std::vector<std::shared_ptr<Texture>> textures;
+    for ( unsigned int m = 0; m < MATERIAL_COUNT; m++ ) {
+        const char* suffixes[] = { "_diffuse.png", "_normal.png", "_specular.png" };
+        for ( unsigned int t = 0; t < 3; t++ ) {
+            std::shared_ptr<Texture> texture = std::make_shared<Texture>();
+            if ( !texture->load(std::string("textures/") + MATERIALS[m] + suffixes[t]) ) return 1;
+            textures.push_back(texture);
+        }
+    }
+
+    std::vector<std::shared_ptr<Shader>> programs;
+    std::vector<std::shared_ptr<Shader>> shaders;
+    for ( unsigned int p = 0; p < PROGRAM_COUNT; p++ ) {
+        std::shared_ptr<Shader> program = std::make_shared<Shader>();
+        if ( !program->load(PROGRAMS[p][0], PROGRAMS[p][1]) || !program->compile() || !program->link() ) return 1;
+        programs.push_back(program);
+
+        for ( unsigned int m = 0; m < MATERIAL_COUNT; m++ ) {
+            std::shared_ptr<Shader> shader = std::make_shared<Shader>(*program);
+            shader->diffuseTexture = textures[3 * m];
+            shader->normalTexture = textures[3 * m + 1];
+            shader->specularTexture = textures[3 * m + 2];
+            shaders.push_back(shader);
+        }
+    }
+
+    std::vector<std::shared_ptr<Mesh>> meshes;
+    float spacing = 0.0f;
+    for ( unsigned int model = 0; model < MODEL_COUNT; model++ ) {
+        for ( std::size_t s = 0; s < shaders.size(); s++ ) {
+            std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+            if ( !mesh->load(MODELS[model]) ) return 1;
+            mesh->setShader(shaders[s]);
+            spacing = std::max(spacing, 2.5f * mesh->getBoundingSphereRadius());
+            meshes.push_back(mesh);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // Random mesh and shader per grid cell, so consecutive objects rarely
+    // share any state.
+    //--------------------------------------------------------------------------
+    int side = static_cast<int>(std::ceil(std::pow(static_cast<double>(objectCount), 1.0 / 3.0)));
+    float half = 0.5f * spacing * (side - 1);
+
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_int_distribution<std::size_t> pick(0, meshes.size() - 1);
+    Scene scene;
+    for ( int i = 0; i < objectCount; i++ ) {
+        Transformationf transform;
+        transform.setPosition(spacing * (i % side) - half, spacing * ((i / side) % side) - half, spacing * (i / (side * side)) - half);
+        scene.add(meshes[pick(random)], transform);
+    }
+
+    Cameraf camera;
+    camera.setPerspective(FIELD_OF_VIEW, 1.0f, 0.1f, 8.0f * half + 10.0f * spacing);
+    camera.setPosition(3.5f * half + 2.0f * spacing, 0.6f, 1.1f);
+    camera.setLookAt(Vector3f(0.0f, 0.0f, 0.0f));
+    Vector3f lightPosition(0.0f, 4.0f * half, 4.0f * half);
+    scene.cull(camera);
+
+    std::printf("objects:    %d (%d^3 grid), %u visible\n", objectCount, side, static_cast<unsigned int>(scene.getVisibleObjects().size()));
+    std::printf("state:      %u models x %u programs x %u texture sets, %d frames\n", MODEL_COUNT, PROGRAM_COUNT, MATERIAL_COUNT, frames);
+
+    //--------------------------------------------------------------------------
+    // Both paths draw the same frame with the GLState cache on; the counts
+    // are those of the last frame.
+    //--------------------------------------------------------------------------
+    RenderQueue queue;
+    GLState::Statistics statistics[2];
+    double submitMilliseconds[2] = { 0.0, 0.0 };
+    double frameMilliseconds[2] = { 0.0, 0.0 };
+    double queueMilliseconds = 0.0;
+    for ( int f = 0; f < frames; f++ ) {
+        for ( int path = 0; path < 2; path++ ) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            GLState::ResetStatistics();
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+            if ( path == 0 ) scene.render(camera, lightPosition);
+            else {
+                queue.begin(camera, lightPosition);
+                scene.submit(queue);
+                queueMilliseconds += ElapsedMilliseconds(start);
+                queue.render();
+            }
+
+            submitMilliseconds[path] += ElapsedMilliseconds(start);
+            glFinish();
+            frameMilliseconds[path] += ElapsedMilliseconds(start);
+            statistics[path] = GLState::GetStatistics();
+            glutSwapBuffers();
+        }
+    }
+
+    const RenderQueueStatistics& queueStatistics = queue.getStatistics();
+    std::printf("queue:      %u draws in %u batches, %u program and %u texture set changes\n",
+        static_cast<unsigned int>(queueStatistics.drawCount), static_cast<unsigned int>(queueStatistics.batchCount),
+        static_cast<unsigned int>(queueStatistics.programChanges), static_cast<unsigned int>(queueStatistics.materialChanges));
+    std::printf("            submit %.3f ms, sort %.3f ms\n", queueMilliseconds / frames, queueStatistics.sortMilliseconds);
+
+    std::printf("%-15s  %-12s  %s\n", "call", "code order", "render queue");
+    for ( unsigned int call = 0; call < GLState::CALL_COUNT; call++ )
+        std::printf("%-15s  %-12u  %u\n", CALL_NAMES[call], static_cast<unsigned int>(statistics[0].issued[call]), static_cast<unsigned int>(statistics[1].issued[call]));
+
+    std::printf("%-15s  %-12u  %u\n", "state changes", static_cast<unsigned int>(StateChanges(statistics[0])), static_cast<unsigned int>(StateChanges(statistics[1])));
+    std::printf("%-15s  %-12.2f  %.2f\n", "submit ms", submitMilliseconds[0] / frames, submitMilliseconds[1] / frames);
+    std::printf("%-15s  %-12.2f  %.2f\n", "frame ms", frameMilliseconds[0] / frames, frameMilliseconds[1] / frames);
+
+    //--------------------------------------------------------------------------
+    // Materials. The 2D scene reuses the meshes of MATERIAL_PROGRAM, the array
+    // scene gets meshes whose shaders share the packed arrays and differ only
+    // by layer.
+    //--------------------------------------------------------------------------
+    MaterialArrays materialArrays;
+    std::vector<std::string> materialNames(MATERIALS, MATERIALS + MATERIAL_COUNT);
+    if ( !materialArrays.load("textures", materialNames) ) return 1;
+
+    std::shared_ptr<Shader> arrayProgram = std::make_shared<Shader>();
+    if ( !arrayProgram->load(PROGRAMS[MATERIAL_PROGRAM][0], ARRAY_FRAGMENT_SHADER) || !arrayProgram->compile() || !arrayProgram->link() ) return 1;
+
+    std::vector<std::shared_ptr<Mesh>> textureMeshes;
+    std::vector<std::shared_ptr<Mesh>> arrayMeshes;
+    for ( unsigned int model = 0; model < MODEL_COUNT; model++ ) {
+        for ( unsigned int m = 0; m < MATERIAL_COUNT; m++ ) {
+            textureMeshes.push_back(meshes[model * shaders.size() + MATERIAL_PROGRAM * MATERIAL_COUNT + m]);
+
+            std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+            if ( !mesh->load(MODELS[model]) ) return 1;
+            mesh->setShader(materialArrays.createShader(*arrayProgram, MATERIALS[m]));
+            arrayMeshes.push_back(mesh);
+        }
+    }
+
+    Scene textureScene;
+    Scene arrayScene;
+    std::uniform_int_distribution<std::size_t> pickMaterial(0, textureMeshes.size() - 1);
+    for ( int i = 0; i < objectCount; i++ ) {
+        std::size_t index = pickMaterial(random);
+        textureScene.add(textureMeshes[index], scene.getTransform(i));
+        arrayScene.add(arrayMeshes[index], scene.getTransform(i));
+    }
+
+    textureScene.cull(camera);
+    arrayScene.cull(camera);
+
+    //--------------------------------------------------------------------------
+    // Paths: 2D textures and texture arrays, each in submission order and
+    // through the queue.
+    //--------------------------------------------------------------------------
+    const Scene* materialScenes[4] = { &textureScene, &arrayScene, &textureScene, &arrayScene };
+    GLState::Statistics materialCalls[4];
+    RenderQueueStatistics materialStatistics[4];
+    double materialMilliseconds[4] = { 0.0, 0.0, 0.0, 0.0 };
+    for ( int f = 0; f < frames; f++ ) {
+        for ( int path = 0; path < 4; path++ ) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            GLState::ResetStatistics();
+            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+            materialStatistics[path] = RenderQueueStatistics();
+            if ( path < 2 ) materialScenes[path]->render(camera, lightPosition);
+            else {
+                queue.begin(camera, lightPosition);
+                materialScenes[path]->submit(queue);
+                queue.render();
+                materialStatistics[path] = queue.getStatistics();
+            }
+
+            glFinish();
+            materialMilliseconds[path] += ElapsedMilliseconds(start);
+            materialCalls[path] = GLState::GetStatistics();
+            glutSwapBuffers();
+        }
+    }
+
+    std::printf("materials:  %u in %u texture array groups, one program\n",
+        static_cast<unsigned int>(materialArrays.getMaterialCount()), static_cast<unsigned int>(materialArrays.getGroupCount()));
+    std::printf("%-15s  %-12s  %-12s  %-12s  %s\n", "", "2D, order", "arrays, order", "2D, queue", "arrays, queue");
+    std::printf("%-15s  %-12s  %-12s  %-12u  %u\n", "batches", "-", "-", static_cast<unsigned int>(materialStatistics[2].batchCount), static_cast<unsigned int>(materialStatistics[3].batchCount));
+
+    const char* rows[] = { "texture", "vertex array", "uniform" };
+    GLState::Call calls[] = { GLState::BIND_TEXTURE, GLState::BIND_VERTEX_ARRAY, GLState::UNIFORM };
+    for ( unsigned int r = 0; r < 3; r++ ) {
+        std::printf("%-15s", rows[r]);
+        for ( int path = 0; path < 4; path++ ) std::printf("  %-12u", static_cast<unsigned int>(materialCalls[path].issued[calls[r]]));
+        std::printf("\n");
+    }
+
+    std::printf("%-15s", "state changes");
+    for ( int path = 0; path < 4; path++ ) std::printf("  %-12u", static_cast<unsigned int>(StateChanges(materialCalls[path])));
+    std::printf("\n%-15s", "frame ms");
+    for ( int path = 0; path < 4; path++ ) std::printf("  %-12.2f", materialMilliseconds[path] / frames);
+    std::printf("\n");
+    return 0;
+}
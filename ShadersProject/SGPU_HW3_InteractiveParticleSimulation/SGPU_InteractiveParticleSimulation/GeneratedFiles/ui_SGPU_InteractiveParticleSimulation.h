@@ -73,6 +73,7 @@ public:
     QRadioButton *fixedLightingRadio;
     QDoubleSpinBox *rotatingSpeed;
     QCheckBox *phongCheckBox;
+    QCheckBox *meshletCullingCheckBox;
     QPushButton *updateButton;
     QSpacerItem *verticalSpacer;
     QLabel *label_5;
@@ -266,6 +267,12 @@ public:
 
         gridLayout_2->addWidget(phongCheckBox, 11, 6, 1, 3);
 
+        meshletCullingCheckBox = new QCheckBox(groupBox_2);
+        meshletCullingCheckBox->setObjectName(QStringLiteral("meshletCullingCheckBox"));
+        meshletCullingCheckBox->setChecked(true);
+
+        gridLayout_2->addWidget(meshletCullingCheckBox, 12, 6, 1, 3);
+
 
         gridLayout_4->addWidget(groupBox_2, 0, 0, 1, 1);
 
@@ -355,6 +362,7 @@ public:
         label_4->setText(QApplication::translate("SGPU_InteractiveParticleSimulationClass", "Rotate Speed", 0));
         fixedLightingRadio->setText(QApplication::translate("SGPU_InteractiveParticleSimulationClass", "Fixed", 0));
         phongCheckBox->setText(QApplication::translate("SGPU_InteractiveParticleSimulationClass", "Phong Shading", 0));
+        meshletCullingCheckBox->setText(QApplication::translate("SGPU_InteractiveParticleSimulationClass", "Meshlet Culling", 0));
         updateButton->setText(QApplication::translate("SGPU_InteractiveParticleSimulationClass", "Update", 0));
         label_5->setText(QString());
         menuFile->setTitle(QApplication::translate("SGPU_InteractiveParticleSimulationClass", "File", 0));
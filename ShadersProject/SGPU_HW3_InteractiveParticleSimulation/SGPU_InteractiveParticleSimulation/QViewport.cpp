@@ -8,6 +8,7 @@
 #include <Mesh.h>
 #include <Shader.h>
 #include <Texture.h>
+#include <GLState.h>
 
 const static float RAY_EXT = 20.0f;
 const static float POINT_EXT = 6.0f;
@@ -106,6 +107,7 @@ void QViewport::onTimeout() {
 
 
 void QViewport::paintGL() {
+	GLState::Invalidate(); // Qt may have changed bindings since the last frame
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	if (this->colorChange == true){ // will be true if the background color is flagged to be changed.
@@ -187,15 +189,25 @@ void QViewport::paintGL() {
 	x = r * std::cos(rotationLightPhi);
 	y = r * std::sin(rotationLightPhi);
 
-	Matrix4f modelView = camera->getViewMatrix()*mesh->getTransform().toMatrix();
+	this->mesh->setPosition(this->posX, this->posY, this->posZ);
+
+	/* Draw the coarsest level of detail that stays within a pixel of the full mesh. */
+	this->mesh->setLod(this->mesh->selectLod(this->camera->getEye(), this->camera->getFOV(), static_cast<float>(this->height())));
+
+	/* The transformation is applied first, then the view; culling and drawing use the same matrix. */
+	Matrix4f modelView = this->mesh->getTransform().toMatrix() * this->camera->getViewMatrix();
+
+	/* Skip the meshlets outside the view or facing away from the camera. */
+	this->mesh->setMeshletCulling(this->meshletCulling);
+	if (this->meshletCulling)
+		this->mesh->cullMeshlets(modelView, this->camera->getProjectionMatrix());
+
 	this->mesh->beginRender();
 	this->mesh->getShader()->uniformMatrix("projectionMatrix", camera->getProjectionMatrix());
 	this->mesh->getShader()->uniformMatrix("modelViewMatrix", modelView);
 	this->mesh->getShader()->uniformMatrix("normalMatrix", Matrix4f::Transpose(modelView.toInverse()));
 	this->mesh->getShader()->uniformVector("lightPosition", Vector3f(x, 5.0f, y));
 
-	this->mesh->setPosition(this->posX, this->posY, this->posZ);
-
 	if (!surfaceNorm && !colorMapping)
 	this->mesh->endRender();
 
@@ -260,8 +272,8 @@ void QViewport::paintGL() {
 
 		this->mesh->beginRender();
 		this->mesh->getShader()->uniformMatrix("projectionMatrix", camera->getProjectionMatrix());
-		this->mesh->getShader()->uniformMatrix("modelViewMatrix", camera->getViewMatrix());
-		this->mesh->getShader()->uniformMatrix("normalMatrix", Matrix4f::Transpose(camera->getViewMatrix().toInverse()));
+		this->mesh->getShader()->uniformMatrix("modelViewMatrix", modelView); // the culled meshlets belong to this matrix
+		this->mesh->getShader()->uniformNormalMatrix(modelView);
 		this->mesh->endRender();
 
 		this->passedC = true;
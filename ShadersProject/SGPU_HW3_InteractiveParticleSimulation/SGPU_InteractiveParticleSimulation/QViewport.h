@@ -64,6 +64,10 @@ public:
 		this->phongShading = phongShading;
 	}
 
+	void setMeshletCulling(bool meshletCulling){
+		this->meshletCulling = meshletCulling;
+	}
+
     void mouseMoveEvent(QMouseEvent* e);
     void mousePressEvent(QMouseEvent* e);
     void mouseReleaseEvent(QMouseEvent* e);
@@ -107,6 +111,9 @@ protected:
 
 	bool phongShading = false;
 	bool passedP = false;
+
+	/* skips the meshlets outside the view or facing away from the camera. */
+	bool meshletCulling = true;
     /* Timer used to update the viewport for 60[fps] */
     QTimer* timer;
     float timeStep;
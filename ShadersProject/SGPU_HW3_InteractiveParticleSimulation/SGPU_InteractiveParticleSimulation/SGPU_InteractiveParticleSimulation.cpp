@@ -64,6 +64,8 @@ void SGPU_InteractiveParticleSimulation::onUpdate() {
 	}
 	else phongShading = false;
 
+	bool meshletCulling = this->ui.meshletCullingCheckBox->isChecked();
+
 //	qDebug() << QString::fromStdString(model);
 //	qDebug() << surfaceNorm;
 
@@ -80,6 +82,7 @@ void SGPU_InteractiveParticleSimulation::onUpdate() {
 	this->ui.viewport->setSurfaceNorm(surfaceNorm, normalScale);
 	this->ui.viewport->setColorMapping(colorMapping);
 	this->ui.viewport->setPhongShading(phongShading);
+	this->ui.viewport->setMeshletCulling(meshletCulling);
 
 }
 
@@ -0,0 +1,50 @@
+#version 330 
+#extension GL_ARB_explicit_attrib_location : require 
+#extension GL_ARB_explicit_uniform_location : require 
+
+/* Strict Binding for Cross-hardware Compatability */
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+layout(location = 2) in vec4 tangent;
+layout(location = 3) in vec3 textureCoordinate;
+layout(location = 4) in vec3 color;
+
+/* Per-instance model matrix (locations 5 to 8) and color */
+layout(location = 5) in mat4 instanceMatrix;
+layout(location = 9) in vec3 instanceColor;
+
+/* Uniform variables for Camera and Light Position (world space) */ 
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+uniform vec3 lightPosition;
+
+/* 
+ * Light model information interpolated between each vertex. This information is 
+ * used to compute the light model within the fragment shader based on the 
+ * interpolated vector values. 
+ */ 
+out vec3 interpSurfaceNormal;
+out vec3 interpVertexPosition;
+out vec3 interpLightPosition;
+out vec3 interpColor;
+
+/* Instanced Phong Shading */
+void main(void) {
+	vec4 vPosition = vec4(position, 1.0f);
+	vec4 lPosition = vec4(lightPosition, 1.0f);
+	mat4 modelViewMatrix = viewMatrix * instanceMatrix;
+
+	//---------------------------------------------------------------------------- 
+	// ADS Interpolated Light Model Vectors. The normal uses the upper 3x3 of the
+	// model-view matrix, exact for rotations and uniform scales.
+	//---------------------------------------------------------------------------- 
+	interpLightPosition = vec3(viewMatrix * lPosition);
+	interpVertexPosition = vec3(modelViewMatrix * vPosition);
+	interpSurfaceNormal = normalize(mat3(modelViewMatrix) * normal);
+	interpColor = instanceColor;
+
+	//-------------------------------------------------------------------------- 
+	// Transform the vertex for the fragment shader. 
+	//-------------------------------------------------------------------------- 
+	gl_Position = projectionMatrix * modelViewMatrix * vPosition;
+}
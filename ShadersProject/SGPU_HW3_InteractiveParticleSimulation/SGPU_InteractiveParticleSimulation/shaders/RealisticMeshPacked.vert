@@ -0,0 +1,69 @@
+#version 330
+
+// RealisticMesh.vert for meshes packed with VertexFormat::OCTAHEDRAL_NORMAL
+// (for example VertexFormat::PACKED), used with RealisticMesh.frag.
+
+uniform mat4 modelViewMatrix;
+uniform mat4 projectionMatrix;
+uniform mat4 normalMatrix;
+uniform vec3 lightPosition;
+
+// Dequantization of the position (see VertexFormat::QUANTIZED_POSITION)
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
+
+attribute vec4 position;
+attribute vec2 normal;
+attribute vec2 tangent;
+attribute vec2 textureCoordinate;
+
+varying vec2 textureCoord;
+varying vec3 p;
+varying vec3 surfaceNormal;
+varying vec3 lightDir;
+
+varying vec3 lightVec;
+varying vec3 eyeVec;
+varying vec3 halfVec;
+
+vec3 octahedralDecode(vec2 e) {
+	e = max(e / 32767.0, vec2(-1.0));
+	vec3 v = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+	if ( v.z < 0.0 ) {
+		vec2 s = vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+		v.xy = (1.0 - abs(e.yx)) * s;
+	}
+	return normalize(v);
+}
+
+void main(void) {
+	vec3 objectPosition = position.xyz * positionScale + positionOffset;
+	vec4 vertexPos = vec4(objectPosition, 1.0);
+	p = (modelViewMatrix * vertexPos).xyz;
+	lightDir = normalize(lightPosition - objectPosition);
+
+	vec3 n = octahedralDecode(normal);
+	vec3 t = octahedralDecode(tangent);
+	vec3 b = cross(n, t) * (position.w * 2.0 - 1.0);
+
+	vec3 v;
+	v.x = dot(lightDir, t);
+	v.y = dot(lightDir, b);
+	v.z = dot(lightDir, n);
+	lightVec = normalize(v);
+
+	v.x = dot(p, t);
+	v.y = dot(p, b);
+	v.z = dot(p, n);
+	eyeVec = normalize(v);
+
+	vec3 halfVector = normalize(p + lightDir);
+	v.x = dot(halfVector, t);
+	v.y = dot(halfVector, b);
+	v.z = dot(halfVector, n);
+	halfVec = v;
+
+	textureCoord = textureCoordinate;
+	surfaceNormal = n;
+	gl_Position = projectionMatrix * modelViewMatrix * vertexPos;
+}
@@ -0,0 +1,107 @@
+#version 330
+
+/*
+ * Particle simulation step executed with transform feedback. Every vertex is
+ * one particle read from the current particle buffer; the outputs are
+ * captured (interleaved, in Particle member order) into the other buffer.
+ * This mirrors CpuParticleEngine::Integrate.
+ */
+in vec3 position;
+in vec3 velocity;
+in vec3 force;
+in vec3 color;
+in float mass;
+in float lifetime;
+
+uniform float dt;
+uniform bool spawnParticles;
+uniform vec3 spawnPosition;
+uniform vec3 spawnVelocity;
+uniform vec3 gravity;
+uniform vec3 baseColor;
+uniform float minLifetime;
+uniform float maxLifetime;
+uniform float bounceEnergy;
+uniform float extent;
+uniform vec3 hiddenPosition;
+uniform int seed;
+
+out vec3 outPosition;
+out vec3 outVelocity;
+out vec3 outForce;
+out vec3 outColor;
+out float outMass;
+out float outLifetime;
+
+/*
+ * Integer hash used in place of rand(). The particle index, the frame seed
+ * and a per-value channel are combined so every random value is independent.
+ */
+uint Hash(uint x) {
+	x ^= x >> 16u;
+	x *= 0x7feb352du;
+	x ^= x >> 15u;
+	x *= 0x846ca68bu;
+	x ^= x >> 16u;
+	return x;
+}
+
+float Random(uint channel, float lower, float upper) {
+	uint h = Hash(uint(gl_VertexID) ^ Hash(uint(seed) * 4u + channel));
+	float fraction = float(h) / 4294967295.0;
+	return lower + fraction * (upper - lower);
+}
+
+vec3 RandomColor() {
+	return baseColor + vec3(Random(0u, 0.5, 1.0), Random(1u, 0.5, 1.0), Random(2u, 0.5, 1.0));
+}
+
+void main(void) {
+	//--------------------------------------------------------------------------
+	// Explicit Euler integration of the velocity and position.
+	//--------------------------------------------------------------------------
+	vec3 v = velocity + (dt * force * 1.0 / mass);
+	vec3 p = position + (dt * v);
+	float life = lifetime - dt;
+
+	//--------------------------------------------------------------------------
+	// Box collision (HandleCollision): the particle is clamped to the box and
+	// the velocity component of every violated face is reflected and scaled
+	// by the bounce energy.
+	//--------------------------------------------------------------------------
+	vec3 lower = vec3(-extent, 0.0, -extent);
+	vec3 upper = vec3(extent, extent, extent);
+	bvec3 hit = bvec3(ivec3(lessThan(p, lower)) | ivec3(greaterThan(p, upper)));
+	p = clamp(p, lower, upper);
+	v = mix(v, (v * -1.0) * bounceEnergy, hit);
+
+	outPosition = p;
+	outVelocity = v;
+	outForce = force;
+	outColor = color;
+	outMass = mass;
+	outLifetime = life;
+
+	//--------------------------------------------------------------------------
+	// Respawn dead particles at the spawn position, or park them at the
+	// hidden position until particles are spawned again.
+	//--------------------------------------------------------------------------
+	if ( life < 0.0 ) {
+		if ( spawnParticles ) {
+			outPosition = spawnPosition;
+			outVelocity = spawnVelocity;
+			outForce = gravity;
+			outColor = RandomColor();
+			outLifetime = Random(3u, minLifetime, maxLifetime);
+		}
+		else {
+			outPosition = hiddenPosition;
+			outVelocity = vec3(0.0);
+			outForce = vec3(0.0);
+			outColor = RandomColor();
+			outLifetime = 0.0;
+		}
+	}
+
+	gl_Position = vec4(outPosition, 1.0);
+}
@@ -0,0 +1,192 @@
+#include <gl/glew.h>
+#include <gl/freeglut.h>
+#include <Scene.h>
+#include <GLState.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+/*
+ * Scene culling benchmark. A model is instanced on a cubic grid and the
+ * camera looks outwards from the centre of the grid in several directions.
+ * For every view the SIMD culling of Scene is timed against a scalar loop
+ * over the same spheres stored as an array of structures, and the frame
+ * time of drawing the visible objects is compared with drawing all of them.
+ * Finally the GL calls of one frame are counted (see GLState) with and
+ * without the state cache.
+ *
+ *   SceneCullBench <model.obj> [instances] [frames] [vertex shader] [fragment shader]
+ */
+
+const static int WINDOW_SIZE = 512;
+const static float FIELD_OF_VIEW = 45.0f;
+const static unsigned int VIEW_COUNT = 8;
+const static int CULL_REPEAT = 200;
+
+const static char* CALL_NAMES[GLState::CALL_COUNT] = { "program", "active texture", "texture", "buffer", "vertex array", "attribute", "uniform", "draw" };
+
+struct BoundingSphere {
+    Vector3f center;
+    float radius;
+};
+
+void PrintUsage() {
+    std::cout << "Usage: SceneCullBench <model.obj> [instances] [frames] [vertex shader] [fragment shader]" << std::endl;
+}
+
+/* Scalar reference: one sphere at a time against the six planes. */
+std::size_t CullScalar(const std::vector<BoundingSphere>& spheres, const Cameraf& camera) {
+    Frustum frustum;
+    ExtractFrustum(Matrix4f::Multiply(camera.getViewMatrix(), camera.getProjectionMatrix()), frustum);
+
+    std::size_t visibleCount = 0;
+    for ( std::size_t i = 0; i < spheres.size(); i++ )
+        if ( FrustumIntersectsSphere(frustum, spheres[i].center, spheres[i].radius) ) visibleCount++;
+    return visibleCount;
+}
+
+/* Draws every object of the scene, like Scene::render without culling. */
+void RenderAll(const Scene& scene, const Cameraf& camera) {
+    for ( std::size_t i = 0; i < scene.getObjectCount(); i++ ) {
+        const std::shared_ptr<Mesh>& mesh = scene.getMesh(i);
+        Matrix4f modelView = Matrix4f::Multiply(scene.getTransform(i).toMatrix(), camera.getViewMatrix());
+
+        mesh->beginRender();
+        mesh->getShader()->uniformMatrix("projectionMatrix", camera.getProjectionMatrix());
+        mesh->getShader()->uniformMatrix("modelViewMatrix", modelView);
+        mesh->getShader()->uniformNormalMatrix(modelView);
+        mesh->getShader()->uniformVector("lightPosition", Vector3f(0.0f, 1.0f, 20.0f));
+        mesh->endRender();
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if ( argc < 2 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    int instanceCount = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 10000;
+    int frames = (argc > 3) ? std::max(1, std::atoi(argv[3])) : 10;
+    std::string vertexShader = (argc > 4) ? argv[4] : "shaders/PhongShading.vert";
+    std::string fragmentShader = (argc > 5) ? argv[5] : "shaders/PhongShading.frag";
+
+    glutInit(&argc, argv);
+    glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA | GLUT_DEPTH);
+    glutInitWindowSize(WINDOW_SIZE, WINDOW_SIZE);
+    glutCreateWindow("SceneCullBench");
+    glewInit();
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, WINDOW_SIZE, WINDOW_SIZE);
+
+    std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+    if ( !mesh->load(argv[1]) ) return 1;
+    if ( !mesh->loadShader(vertexShader, fragmentShader) ) return 1;
+
+    //--------------------------------------------------------------------------
+    // Instance the model on a cubic grid centred on the origin, spaced by
+    // three times its bounding radius.
+    //--------------------------------------------------------------------------
+    int side = static_cast<int>(std::ceil(std::pow(static_cast<double>(instanceCount), 1.0 / 3.0)));
+    float spacing = 3.0f * mesh->getBoundingSphereRadius();
+    float half = 0.5f * spacing * (side - 1);
+
+    Scene scene;
+    std::vector<BoundingSphere> spheres;
+    for ( int i = 0; i < instanceCount; i++ ) {
+        Transformationf transform;
+        transform.setPosition(spacing * (i % side) - half, spacing * ((i / side) % side) - half, spacing * (i / (side * side)) - half);
+        scene.add(mesh, transform);
+
+        BoundingSphere sphere;
+        mesh->getWorldBoundingSphere(transform, sphere.center, sphere.radius);
+        spheres.push_back(sphere);
+    }
+
+    std::printf("model:      %s (%u faces)\n", argv[1], static_cast<unsigned int>(mesh->getFaces().size()));
+    std::printf("instances:  %d (%d^3 grid)\n", instanceCount, side);
+    std::printf("view  visible  cull ms (SIMD)  cull ms (scalar)  ms/frame all  ms/frame culled\n");
+
+    //--------------------------------------------------------------------------
+    // The camera sits near the centre and looks outwards; Camera places the
+    // eye on a sphere around the origin.
+    //--------------------------------------------------------------------------
+    Cameraf camera;
+    camera.setPerspective(FIELD_OF_VIEW, 1.0f, 0.1f, 4.0f * half + 10.0f * spacing);
+    for ( unsigned int view = 0; view < VIEW_COUNT; view++ ) {
+        float theta = static_cast<float>(2.0 * PI * view / VIEW_COUNT);
+        camera.setPosition(0.5f * spacing, theta, static_cast<float>(HALF_PI) - 0.3f);
+        camera.setLookAt(camera.getEye() * 2.0f);
+
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        for ( int r = 0; r < CULL_REPEAT; r++ ) scene.cull(camera);
+        std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+        double simdMilliseconds = std::chrono::duration<double, std::milli>(end - start).count() / CULL_REPEAT;
+
+        std::size_t scalarVisible = 0;
+        start = std::chrono::high_resolution_clock::now();
+        for ( int r = 0; r < CULL_REPEAT; r++ ) scalarVisible = CullScalar(spheres, camera);
+        end = std::chrono::high_resolution_clock::now();
+        double scalarMilliseconds = std::chrono::duration<double, std::milli>(end - start).count() / CULL_REPEAT;
+
+        if ( scalarVisible != scene.getVisibleObjects().size() ) {
+            std::cerr << "[SceneCullBench] Error: SIMD and scalar culling disagree." << std::endl;
+            return 1;
+        }
+
+        double allSeconds = 0.0;
+        double culledSeconds = 0.0;
+        for ( int f = 0; f < frames; f++ ) {
+            start = std::chrono::high_resolution_clock::now();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            RenderAll(scene, camera);
+            glFinish();
+            end = std::chrono::high_resolution_clock::now();
+            allSeconds += std::chrono::duration<double>(end - start).count();
+
+            start = std::chrono::high_resolution_clock::now();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            scene.cull(camera);
+            scene.render(camera, Vector3f(0.0f, 1.0f, 20.0f));
+            glFinish();
+            end = std::chrono::high_resolution_clock::now();
+            culledSeconds += std::chrono::duration<double>(end - start).count();
+            glutSwapBuffers();
+        }
+
+        std::printf("%4u  %-7u  %-14.4f  %-16.4f  %-12.2f  %.2f\n", view, static_cast<unsigned int>(scene.getVisibleObjects().size()),
+            simdMilliseconds, scalarMilliseconds, allSeconds * 1000.0 / frames, culledSeconds * 1000.0 / frames);
+    }
+
+    //--------------------------------------------------------------------------
+    // GL calls of one culled frame of the last view. The frame is drawn once
+    // before counting so both runs start from the same bindings.
+    //--------------------------------------------------------------------------
+    std::printf("GL calls per frame (%u objects drawn)\n", static_cast<unsigned int>(scene.getVisibleObjects().size()));
+    std::printf("%-15s  %-12s  %s\n", "call", "cache off", "cache on (skipped)");
+
+    GLState::Statistics statistics[2];
+    for ( int caching = 0; caching < 2; caching++ ) {
+        GLState::SetCaching(caching != 0);
+        scene.render(camera, Vector3f(0.0f, 1.0f, 20.0f));
+        GLState::ResetStatistics();
+        scene.render(camera, Vector3f(0.0f, 1.0f, 20.0f));
+        glFinish();
+        statistics[caching] = GLState::GetStatistics();
+    }
+
+    std::size_t totals[2] = { 0, 0 };
+    for ( unsigned int call = 0; call < GLState::CALL_COUNT; call++ ) {
+        std::printf("%-15s  %-12u  %u (%u)\n", CALL_NAMES[call], static_cast<unsigned int>(statistics[0].issued[call]),
+            static_cast<unsigned int>(statistics[1].issued[call]), static_cast<unsigned int>(statistics[1].skipped[call]));
+        totals[0] += statistics[0].issued[call];
+        totals[1] += statistics[1].issued[call];
+    }
+
+    std::printf("%-15s  %-12u  %u\n", "total", static_cast<unsigned int>(totals[0]), static_cast<unsigned int>(totals[1]));
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <Triangulation.h>
+#include <Parallel.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+/*
+ * Headless benchmark of the Obj triangulation. The file is parsed, then its
+ * faces are triangulated on one thread and on all threads (the results have
+ * to match), and the triangles are checked against the faces: the summed
+ * triangle area of every face has to equal the area of the face, and no
+ * triangle may face away from it. A plain fan of every face is checked the
+ * same way for comparison.
+ *
+ *   TriangulationBench <model.obj> [repeat]
+ *   TriangulationBench --generate <model.obj> <quads per side> [polygons]
+ *
+ * The generated file is a grid of quads on a gently curved surface, with
+ * every hundredth quad concave (a dart), followed by concave star shaped
+ * polygons of 12 corners.
+ */
+
+const static unsigned int STAR_POINTS = 6;
+const static float STAR_INNER_RADIUS = 0.4f;
+
+void PrintUsage() {
+    std::cout << "Usage: TriangulationBench <model.obj> [repeat]" << std::endl;
+    std::cout << "       TriangulationBench --generate <model.obj> <quads per side> [polygons]" << std::endl;
+}
+
+double ElapsedMilliseconds(const std::chrono::high_resolution_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+bool GenerateModel(const std::string& filename, std::size_t side, std::size_t polygonCount) {
+    std::ofstream file(filename.c_str());
+    if ( !file.is_open() ) {
+        std::cerr << "[TriangulationBench] Error: Could not write: " << filename << std::endl;
+        return false;
+    }
+
+    std::size_t stride = side + 1;
+    for ( std::size_t z = 0; z <= side; z++ ) {
+        for ( std::size_t x = 0; x <= side; x++ ) {
+            //------------------------------------------------------------------
+            // A dart: the far corner of every hundredth quad is pulled inside
+            // the quad, past its diagonal.
+            //------------------------------------------------------------------
+            float px = static_cast<float>(x);
+            float pz = static_cast<float>(z);
+            if ( x > 0 && z > 0 && ((z - 1) * side + (x - 1)) % 100 == 0 ) {
+                px -= 0.75f;
+                pz -= 0.75f;
+            }
+
+            file << "v " << px << " " << 0.1f * std::sin(0.05f * px) * std::cos(0.05f * pz) << " " << pz << "\n";
+        }
+    }
+
+    for ( std::size_t z = 0; z < side; z++ ) {
+        for ( std::size_t x = 0; x < side; x++ ) {
+            std::size_t v = z * stride + x + 1;
+            file << "f " << v << " " << v + stride << " " << v + stride + 1 << " " << v + 1 << "\n";
+        }
+    }
+
+    std::size_t base = stride * stride;
+    for ( std::size_t p = 0; p < polygonCount; p++ ) {
+        float cx = static_cast<float>(p % side);
+        float cz = static_cast<float>(p / side);
+        for ( unsigned int i = 0; i < 2 * STAR_POINTS; i++ ) {
+            float angle = static_cast<float>(PI * i / STAR_POINTS);
+            float radius = (i % 2 == 0) ? 0.5f : 0.5f * STAR_INNER_RADIUS;
+            file << "v " << cx + radius * std::cos(angle) << " 1 " << cz - radius * std::sin(angle) << "\n";
+        }
+
+        file << "f";
+        for ( unsigned int i = 0; i < 2 * STAR_POINTS; i++ ) file << " " << base + i + 1;
+        file << "\n";
+        base += 2 * STAR_POINTS;
+    }
+
+    return true;
+}
+
+/* Summed area error (relative to the face areas) and flipped triangles of a triangulation. */
+void CheckTriangles(const std::vector<const Obj_Face*>& faces, const std::vector<Vector3f>& positions, const ObjTriangles& triangles, double& areaError, std::size_t& flipped) {
+    double faceArea = 0.0;
+    double difference = 0.0;
+    flipped = 0;
+
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        const std::vector<std::size_t>& corners = faces[i]->vertexIndices;
+        Vector3f normal(0.0f, 0.0f, 0.0f);
+        for ( std::size_t c = 0, p = corners.size() - 1; c < corners.size(); p = c++ )
+            normal += Vector3f::Cross(positions[corners[p]], positions[corners[c]]);
+
+        double area = 0.0;
+        for ( std::size_t t = triangles.faceOffsets[i]; t < triangles.faceOffsets[i + 1]; t++ ) {
+            const Vector3f& a = positions[triangles.vertexIndices[3 * t]];
+            const Vector3f& b = positions[triangles.vertexIndices[3 * t + 1]];
+            const Vector3f& c = positions[triangles.vertexIndices[3 * t + 2]];
+            Vector3f cross = Vector3f::Cross(b - a, c - a);
+            if ( Vector3f::Dot(cross, normal) < 0.0 ) flipped++;
+            area += 0.5 * cross.length();
+        }
+
+        faceArea += 0.5 * normal.length();
+        difference += std::fabs(area - 0.5 * normal.length());
+    }
+
+    areaError = (faceArea > 0.0) ? difference / faceArea : 0.0;
+}
+
+/* Every face as a fan from its first corner, the reference the triangulation replaces. */
+void FanFaces(const std::vector<const Obj_Face*>& faces, ObjTriangles& triangles) {
+    triangles.vertexIndices.clear();
+    triangles.faceOffsets.assign(1, 0);
+    for ( std::size_t i = 0; i < faces.size(); i++ ) {
+        const std::vector<std::size_t>& corners = faces[i]->vertexIndices;
+        for ( std::size_t c = 1; c + 1 < corners.size(); c++ ) {
+            triangles.vertexIndices.push_back(static_cast<unsigned int>(corners[0]));
+            triangles.vertexIndices.push_back(static_cast<unsigned int>(corners[c]));
+            triangles.vertexIndices.push_back(static_cast<unsigned int>(corners[c + 1]));
+        }
+
+        triangles.faceOffsets.push_back(triangles.vertexIndices.size() / 3);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if ( argc < 2 ) {
+        PrintUsage();
+        return 1;
+    }
+
+    if ( std::string(argv[1]) == "--generate" ) {
+        if ( argc < 4 ) {
+            PrintUsage();
+            return 1;
+        }
+
+        std::size_t side = static_cast<std::size_t>(std::max(1, std::atoi(argv[3])));
+        std::size_t polygons = (argc > 4) ? static_cast<std::size_t>(std::max(0, std::atoi(argv[4]))) : 0;
+        return GenerateModel(argv[2], side, polygons) ? 0 : 1;
+    }
+
+    int repeat = (argc > 2) ? std::max(1, std::atoi(argv[2])) : 3;
+
+    std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+    ObjFile file;
+    if ( !file.load(argv[1]) ) return 1;
+    double parseMilliseconds = ElapsedMilliseconds(start);
+
+    std::ifstream size(argv[1], std::ios::binary | std::ios::ate);
+    double megabytes = static_cast<double>(size.tellg()) / (1024.0 * 1024.0);
+
+    std::vector<Vector3f> positions;
+    std::vector<const Obj_Face*> faces;
+    for ( std::size_t m = 0; m < file.getMeshCount(); m++ ) {
+        const std::shared_ptr<ObjMesh>& mesh = file.getMesh(m);
+        positions.insert(positions.end(), mesh->vertices.begin(), mesh->vertices.end());
+        for ( std::size_t i = 0; i < mesh->faces.size(); i++ ) faces.push_back(&mesh->faces[i]);
+    }
+
+    std::printf("model:     %s (%.1f MB, %u positions, %u faces)\n", argv[1], megabytes, static_cast<unsigned int>(positions.size()), static_cast<unsigned int>(faces.size()));
+    std::printf("parse:     %.1f ms (%.1f MB/s)\n", parseMilliseconds, megabytes * 1000.0 / parseMilliseconds);
+
+    //--------------------------------------------------------------------------
+    // Best of repeat runs on one thread and on all of them.
+    //--------------------------------------------------------------------------
+    ObjTriangles serial;
+    ObjTriangles parallel;
+    double best[2] = { 1.0e30, 1.0e30 };
+    for ( int r = 0; r < repeat; r++ ) {
+        if ( !TriangulateObjFaces(faces, positions, serial, std::max<std::size_t>(1, faces.size())) ) return 1;
+        best[0] = std::min(best[0], serial.statistics.milliseconds);
+        if ( !TriangulateObjFaces(faces, positions, parallel) ) return 1;
+        best[1] = std::min(best[1], parallel.statistics.milliseconds);
+    }
+
+    if ( serial.vertexIndices != parallel.vertexIndices || serial.textureIndices != parallel.textureIndices || serial.normalIndices != parallel.normalIndices ) {
+        std::cerr << "[TriangulationBench] Error: Serial and parallel triangulations differ." << std::endl;
+        return 1;
+    }
+
+    const TriangulationStatistics& statistics = serial.statistics;
+    std::printf("faces:     %u quads, %u polygons, %u triangles out, %u fallbacks\n", static_cast<unsigned int>(statistics.quadCount),
+        static_cast<unsigned int>(statistics.polygonCount), static_cast<unsigned int>(statistics.triangleCount), static_cast<unsigned int>(statistics.fallbackCount));
+    std::printf("threads    ms        Mfaces/s  Mtriangles/s\n");
+    unsigned int threads[2] = { 1, static_cast<unsigned int>(ParallelRangeCount(faces.size(), TRIANGULATION_MIN_PARALLEL_FACES)) };
+    for ( unsigned int i = 0; i < 2; i++ )
+        std::printf("%-9u  %-8.2f  %-8.2f  %.2f\n", threads[i], best[i], faces.size() / (1000.0 * best[i]), statistics.triangleCount / (1000.0 * best[i]));
+
+    //--------------------------------------------------------------------------
+    // Geometric check against a plain fan of every face.
+    //--------------------------------------------------------------------------
+    ObjTriangles fan;
+    FanFaces(faces, fan);
+
+    double areaError[2] = { 0.0, 0.0 };
+    std::size_t flipped[2] = { 0, 0 };
+    CheckTriangles(faces, positions, serial, areaError[0], flipped[0]);
+    CheckTriangles(faces, positions, fan, areaError[1], flipped[1]);
+    std::printf("check      area error  flipped triangles\n");
+    std::printf("%-9s  %-10.6f  %u\n", "triangles", areaError[0], static_cast<unsigned int>(flipped[0]));
+    std::printf("%-9s  %-10.6f  %u\n", "fan", areaError[1], static_cast<unsigned int>(flipped[1]));
+    return 0;
+}